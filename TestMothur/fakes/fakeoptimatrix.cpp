@@ -9,29 +9,32 @@
 #include "fakeoptimatrix.hpp"
 
 /***********************************************************************/
-FakeOptiMatrix::FakeOptiMatrix() : OptiData(0.03) {
+FakeOptiMatrix::FakeOptiMatrix(int numSets) : OptiData(0.03) {
     try {
         m = MothurOut::getInstance();
         
+        int numClose = numSets * 10;
+        
         //create 10 singletons
-        for (int i = 90; i < 100; i++) { singletons.push_back(toString(i));  }
+        for (int i = numClose; i < numClose+10; i++) { singletons.push_back(toString(i));  }
         
-        //create 90 non singletons
-        for (int i = 0; i < 90; i++) { nameMap.push_back(toString(i));  }
+        //create numSets * 10 non singletons
+        for (int i = 0; i < numClose; i++) { nameMap.push_back(toString(i));  }
         
-        closeness.resize(90);
+        closeness.resize(numClose);
         int count = 0;
-        for (int i = 0; i < 9; i++) {
+        for (int i = 0; i < numSets; i++) {
             set<int> close;
             //create list of all sequences in this set
             for (int j = 0; j < 10; j++) { close.insert((j+count)); }
             
             for (set<int>::iterator it = close.begin(); it != close.end(); it++) {
                 //add close sequences to each sequence in this set, do not include self
-                for (int j = 0; j < 10; j++) { if ((j+count) != *it) {   closeness[j+count].insert(*it);  } }
+                for (int j = 0; j < 10; j++) { if ((j+count) != *it) {   closeness.insert(j+count, *it);  } }
             }
             count += 10;
         }
+        closeness.pack();
     }
     catch(exception& e) {
         m->errorOut(e, "FakeOptiMatrix", "FakeOptiMatrix");
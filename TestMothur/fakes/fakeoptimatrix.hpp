@@ -14,7 +14,7 @@
 class FakeOptiMatrix : public OptiData {
     
 public:
-    FakeOptiMatrix(); 
+    FakeOptiMatrix(int numSets = 9); //sets of 10 close seqs, plus 10 singletons
     ~FakeOptiMatrix(){ }
 };
 
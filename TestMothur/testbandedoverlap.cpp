@@ -0,0 +1,60 @@
+//
+//  testbandedoverlap.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "gtest/gtest.h"
+#include "bandedoverlap.hpp"
+#include "needlemanoverlap.hpp"
+#include "gotohoverlap.hpp"
+#include "testhelpers.hpp"
+
+/**************************************************************************************************/
+//a copy of seq with numEdits substitutions, insertions and deletions
+static string edit(string seq, int numEdits, unsigned int& seed) {
+    for (int i = 0; i < numEdits; i++) {
+        int position = 10 + nextRandom(seed, seq.length() - 20);
+        if ((i % 3) == 0)       { seq.erase(position, 1);                            }
+        else if ((i % 3) == 1)  { seq.insert(position, randomBases(1, seed));        }
+        else                    { seq[position] = (seq[position] == 'A') ? 'C' : 'A'; }
+    }
+    return seq;
+}
+/**************************************************************************************************/
+TEST(Test_BandedOverlap, WholeMatrixBandMatchesNeedlemanAndGotoh) {
+    unsigned int seed = 7;
+
+    NeedlemanOverlap needleman(-2.0, 1.0, -1.0, 700);       NeedlemanBandedOverlap bandedNeedleman(-2.0, 1.0, -1.0);
+    GotohOverlap gotoh(-2.0, -1.0, 1.0, -1.0, 700);         GotohBandedOverlap bandedGotoh(-2.0, -1.0, 1.0, -1.0);
+
+    for (int i = 0; i < 20; i++) {
+        string A = randomBases(1 + (i * 41) % 600, seed);
+        string B = randomBases(1 + (i * 29) % 600, seed); //unrelated, the paths go anywhere
+
+        bandedNeedleman.setBand(0, 700);    expectSameAlignment(needleman, bandedNeedleman, A, B);
+        bandedGotoh.setBand(0, 700);        expectSameAlignment(gotoh, bandedGotoh, A, B);
+    }
+}
+/**************************************************************************************************/
+TEST(Test_BandedOverlap, DiffsWideBandMatchesCloseSeqs) {
+    unsigned int seed = 23;
+    int diffs = 4;
+
+    NeedlemanOverlap needleman(-2.0, 1.0, -1.0, 700);       NeedlemanBandedOverlap bandedNeedleman(-2.0, 1.0, -1.0);
+    GotohOverlap gotoh(-2.0, -1.0, 1.0, -1.0, 700);         GotohBandedOverlap bandedGotoh(-2.0, -1.0, 1.0, -1.0);
+
+    for (int i = 0; i < 20; i++) {
+        string B = randomBases(200 + (i * 13) % 300, seed);
+        string A = edit(B, diffs, seed);
+
+        int offset = 0; //column - row of the first base of A
+        if ((i % 3) == 1)       { A = A.substr(30);  offset = -30; }   //A starts inside B
+        else if ((i % 3) == 2)  { B = B.substr(25);  offset = 25;  }   //B starts inside A
+
+        bandedNeedleman.setBand(offset, diffs);     expectSameAlignment(needleman, bandedNeedleman, A, B);
+        bandedGotoh.setBand(offset, diffs);         expectSameAlignment(gotoh, bandedGotoh, A, B);
+    }
+}
+/**************************************************************************************************/
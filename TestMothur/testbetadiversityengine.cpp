@@ -0,0 +1,124 @@
+//
+//  testbetadiversityengine.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "gtest/gtest.h"
+#include "betadiversityengine.hpp"
+#include "sparsesharedtable.hpp"
+#include "sharedsobscollectsummary.h"
+#include "sharednseqs.h"
+#include "sharedjclass.h"
+#include "sharedsorclass.h"
+#include "sharedochiai.h"
+#include "sharedanderbergs.h"
+#include "sharedkulczynski.h"
+#include "sharedkulczynskicody.h"
+#include "sharedlennon.h"
+#include "sharedbraycurtis.h"
+#include "manhattan.h"
+#include "sharedthetayc.h"
+#include "sharedthetan.h"
+#include "sharedmorisitahorn.h"
+#include "sharedjsd.h"
+#include "testhelpers.hpp"
+
+/**************************************************************************************************/
+//sparse samples of different sizes, one of them empty
+static vector<SharedRAbundVector*> getSamples() {
+    unsigned int seed = 7;
+    vector<SharedRAbundVector*> samples;
+    for (int i = 0; i < 12; i++) {
+        vector<int> abunds(40, 0);
+        for (int j = 0; j < abunds.size(); j++) {
+            if (nextRandom(seed, 3) == 0) { abunds[j] = 1 + nextRandom(seed, 1 + i * 50); }
+        }
+        if (i == 5) { abunds.assign(40, 0); }
+        samples.push_back(new SharedRAbundVector(abunds));
+    }
+    return samples;
+}
+/**************************************************************************************************/
+TEST(Test_Calc_BetaDiversityEngine, MatchesTheCalculators) {
+    vector<Calculator*> calcs;
+    calcs.push_back(new SharedSobsCS());    calcs.push_back(new SharedNSeqs());     calcs.push_back(new Jclass());
+    calcs.push_back(new SorClass());        calcs.push_back(new Ochiai());          calcs.push_back(new Anderberg());
+    calcs.push_back(new Kulczynski());      calcs.push_back(new KulczynskiCody());  calcs.push_back(new Lennon());
+    calcs.push_back(new BrayCurtis());      calcs.push_back(new Manhattan());       calcs.push_back(new ThetaYC());
+    calcs.push_back(new ThetaN());          calcs.push_back(new MorHorn());         calcs.push_back(new JSD());
+
+    vector<SharedRAbundVector*> samples = getSamples();
+
+    vector<string> names;
+    for (int i = 0; i < calcs.size(); i++) { names.push_back(calcs[i]->getName()); }
+    names.push_back("braycurtis"); names.push_back("hellinger");
+
+    BetaDiversityEngine engine(samples, names);
+    EXPECT_EQ(engine.find("hellinger"), -1);
+    EXPECT_EQ(engine.getCols(engine.find("thetayc")), 3);
+
+    vector< vector<double> > values, rows;
+    engine.getValues(3, values);
+    engine.getValues(4, 9, rows);
+    ASSERT_EQ(values.size(), calcs.size());
+
+    long long pair = 0;
+    for (int k = 0; k < samples.size(); k++) {
+        for (int l = 0; l < k; l++) {
+            vector<SharedRAbundVector*> subset; subset.push_back(samples[k]); subset.push_back(samples[l]);
+
+            for (int i = 0; i < calcs.size(); i++) {
+                int c = engine.find(calcs[i]->getName());
+                ASSERT_NE(c, -1);
+
+                EstOutput expected = calcs[i]->getValues(subset);
+                for (int j = 0; j < expected.size(); j++) {
+                    EXPECT_EQ(values[c][pair * expected.size() + j], expected[j]) << calcs[i]->getName() << " " << k << " " << l;
+                    if ((k >= 4) && (k < 9)) { EXPECT_EQ(rows[c][(pair - 6) * expected.size() + j], expected[j]); }
+                }
+            }
+            pair++;
+        }
+    }
+
+    for (int i = 0; i < samples.size(); i++) { delete samples[i]; }
+    for (int i = 0; i < calcs.size(); i++) { delete calcs[i]; }
+}
+/**************************************************************************************************/
+TEST(Test_Calc_BetaDiversityEngine, ReadsTheSparseTable) {
+    vector<SharedRAbundVector*> samples = getSamples();
+
+    vector<string> groups; vector<uint64_t> rowStarts; vector<uint32_t> otus; vector<int> counts;
+    rowStarts.push_back(0);
+    for (int i = 0; i < samples.size(); i++) {
+        vector<int> abunds = samples[i]->get();
+        for (int j = 0; j < abunds.size(); j++) { if (abunds[j] != 0) { otus.push_back(j); counts.push_back(abunds[j]); } }
+        rowStarts.push_back(otus.size());
+        groups.push_back("G" + toString(i / 10) + toString(i % 10)); //the table keeps its rows in group order
+    }
+    SparseSharedTable table("0.03", groups, 40, rowStarts, otus, counts);
+
+    vector<string> names;
+    names.push_back("sharedsobs"); names.push_back("sharednseqs"); names.push_back("jclass"); names.push_back("sorclass");
+    names.push_back("ochiai"); names.push_back("anderberg"); names.push_back("kulczynski"); names.push_back("kulczynskicody");
+    names.push_back("lennon"); names.push_back("braycurtis"); names.push_back("manhattan"); names.push_back("thetayc");
+    names.push_back("thetan"); names.push_back("morisitahorn"); names.push_back("jsd");
+
+    BetaDiversityEngine dense(samples, names);
+    BetaDiversityEngine sparse(table, names);
+
+    vector< vector<double> > denseValues, sparseValues;
+    dense.getValues(2, denseValues);
+    sparse.getValues(3, sparseValues);
+
+    ASSERT_EQ(sparseValues.size(), names.size());
+    for (int c = 0; c < names.size(); c++) {
+        ASSERT_EQ(sparseValues[c].size(), denseValues[c].size()) << names[c];
+        for (int j = 0; j < denseValues[c].size(); j++) { EXPECT_EQ(sparseValues[c][j], denseValues[c][j]) << names[c] << " " << j; }
+    }
+
+    for (int i = 0; i < samples.size(); i++) { delete samples[i]; }
+}
+/**************************************************************************************************/
@@ -0,0 +1,90 @@
+//
+//  testkmerdb.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "gtest/gtest.h"
+#include "kmerdb.hpp"
+#include "kmer.hpp"
+#include "testhelpers.hpp"
+
+/**************************************************************************************************/
+//number of distinct kmers the two sequences share, the way KmerDB counts them
+static int sharedKmers(string query, string templateSeq, int kmerSize) {
+    Kmer kmer(kmerSize);
+    set<int> queryKmers, templateKmers;
+    for (int i = 0; i < (int)query.length() - kmerSize + 1; i++)        { queryKmers.insert(kmer.getKmerNumber(query, i));          }
+    for (int i = 0; i < (int)templateSeq.length() - kmerSize + 1; i++)  { templateKmers.insert(kmer.getKmerNumber(templateSeq, i));  }
+
+    int shared = 0;
+    for (set<int>::iterator it = queryKmers.begin(); it != queryKmers.end(); it++) { if (templateKmers.count(*it) != 0) { shared++; } }
+    return shared;
+}
+/**************************************************************************************************/
+TEST(Test_Container_KmerDB, findClosestSequences) {
+    unsigned int seed = 7;
+    int kmerSize = 6;
+
+    //templates share pieces of the query so the counts vary, with some exact duplicates to make ties
+    string query = randomBases(300, seed);
+    vector<string> templates;
+    for (int i = 0; i < 100; i++) {
+        if ((i % 10) == 3)  { templates.push_back(templates[i-1]); continue; }
+        int shared = (i * 7) % 250;
+        templates.push_back(query.substr(0, shared) + randomBases(300 - shared, seed));
+    }
+
+    KmerDB database("kmerdbtest.fasta", kmerSize);
+    for (int i = 0; i < templates.size(); i++) { database.addSequence(Sequence("seq" + toString(i), templates[i])); }
+    database.setNumSeqs(templates.size());
+
+    vector<seqMatch> expected;
+    for (int i = 0; i < templates.size(); i++) { expected.push_back(seqMatch(i, sharedKmers(query, templates[i], kmerSize))); }
+    stable_sort(expected.begin(), expected.end(), compareSeqMatches);
+
+    Sequence querySeq("query", query);
+    vector<float> scores;
+    int numKmers = query.length() - kmerSize + 1;
+
+    vector<int> closest = database.findClosestSequences(&querySeq, 12, scores);
+    ASSERT_EQ(closest.size(), 12);
+    ASSERT_EQ(scores.size(), 13);
+    for (int i = 0; i < closest.size(); i++) {
+        EXPECT_EQ(closest[i], expected[i].seq);
+        EXPECT_FLOAT_EQ(scores[i+1], 100 * expected[i].match / (float) numKmers);
+    }
+
+    //the scratch counts are reset between searches, so the same search gives the same answer
+    closest = database.findClosestSequences(&querySeq, 1, scores);
+    ASSERT_EQ(closest.size(), 1);
+    EXPECT_EQ(closest[0], expected[0].seq);
+    EXPECT_FLOAT_EQ(scores[0], 100 * expected[0].match / (float) numKmers);
+
+    //the packed postings hold what was added
+    Kmer kmer(kmerSize);
+    int firstKmer = kmer.getKmerNumber(templates[5], 0);
+    vector<int> withKmer = database.getSequencesWithKmer(firstKmer);
+    EXPECT_EQ(withKmer.size(), database.getCount(firstKmer));
+    EXPECT_TRUE(find(withKmer.begin(), withKmer.end(), 5) != withKmer.end());
+
+    //the shortcut file is mapped back in and gives the same answers
+    database.generateDB();
+    ASSERT_TRUE(ReferenceIndex::isIndex("kmerdbtest.6mer"));
+
+    KmerDB mapped("kmerdbtest.fasta", kmerSize);
+    ifstream shortcut("kmerdbtest.6mer");
+    mapped.readDB(shortcut);
+    mapped.setNumSeqs(templates.size());
+
+    vector<float> mappedScores;
+    vector<int> mappedClosest = mapped.findClosestSequences(&querySeq, 12, mappedScores);
+    closest = database.findClosestSequences(&querySeq, 12, scores);
+    EXPECT_EQ(mappedClosest, closest);
+    EXPECT_EQ(mappedScores, scores);
+    EXPECT_EQ(mapped.getSequencesWithKmer(firstKmer), withKmer);
+
+    Utils util; util.mothurRemove("kmerdbtest.6mer");
+}
+/**************************************************************************************************/
@@ -0,0 +1,100 @@
+//
+//  testlabelindex.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "gtest/gtest.h"
+#include "labelindex.hpp"
+#include "inputdata.h"
+
+/**************************************************************************************************/
+TEST(Test_Container_LabelIndex, SeeksToTheLabelsOfASharedFile) {
+    Utils util;
+    string sharedFile = "labelindextest.shared";
+    util.mothurRemove(sharedFile + ".labels");
+
+    ofstream out; util.openOutputFile(sharedFile, out);
+    out << "label\tGroup\tnumOtus\tOtu1\tOtu2\tOtu3\n";
+    out << "unique\tA\t3\t1\t2\t3\nunique\tB\t3\t4\t5\t6\n";
+    out << "0.02\tA\t2\t3\t3\n0.02\tB\t2\t9\t6\n";
+    out << "0.03\tA\t2\t6\t0\n0.03\tB\t2\t10\t5\n";
+    out.close();
+
+    LabelIndex index(sharedFile, "sharedfile");
+    ASSERT_EQ(index.getNumLabels(), 3);
+    EXPECT_EQ(index.getLabel(2), "0.03");
+    EXPECT_EQ(index.getNumLines(0), 2);
+    EXPECT_EQ(index.getNumOtus(0), 3);
+    EXPECT_EQ(index.find("0.02"), 1);
+    EXPECT_EQ(index.find("0.05"), -1);
+
+    //the saved index gives the same labels
+    LabelIndex saved(sharedFile, "sharedfile");
+    ASSERT_EQ(saved.getNumLabels(), 3);
+    EXPECT_EQ(saved.getOffset(2), index.getOffset(2));
+
+    vector<string> groups;
+    InputData input(sharedFile, "sharedfile", groups);
+    SharedRAbundVectors* lookup = input.getSharedRAbundVectors("0.03");
+    ASSERT_TRUE(lookup != NULL);
+    EXPECT_EQ(lookup->getLabel(), "0.03");
+    EXPECT_EQ(lookup->size(), 2);
+    EXPECT_EQ(lookup->getOTUTotal(0), 16);
+    EXPECT_EQ(lookup->getOTUName(1), "Otu2");
+    delete lookup;
+
+    //the labels after the first are read on 2 threads
+    vector<string> labels; labels.push_back("unique"); labels.push_back("0.03"); labels.push_back("0.02");
+    vector<SharedRAbundVectors*> lookups = input.getSharedRAbundVectors(labels, 2);
+    ASSERT_EQ(lookups.size(), 3);
+    EXPECT_EQ(lookups[0]->getOTUTotal(2), 9);
+    EXPECT_EQ(lookups[1]->getLabel(), "0.03");
+    EXPECT_EQ(lookups[1]->getOTUTotal(1), 5);
+    EXPECT_EQ(lookups[2]->getOTUTotal(0), 12);
+    for (int i = 0; i < lookups.size(); i++) { delete lookups[i]; }
+
+    util.mothurRemove(sharedFile); util.mothurRemove(sharedFile + ".labels");
+}
+/**************************************************************************************************/
+TEST(Test_Container_LabelIndex, RebuildsAStaleIndex) {
+    Utils util;
+    string sharedFile = "labelindexstale.shared";
+    util.mothurRemove(sharedFile + ".labels");
+
+    ofstream out; util.openOutputFile(sharedFile, out);
+    out << "label\tGroup\tnumOtus\tOtu1\tOtu2\n";
+    out << "0.02\tA\t2\t3\t3\n0.02\tB\t2\t9\t6\n";
+    out << "0.03\tA\t2\t6\t0\n0.03\tB\t2\t10\t5\n";
+    out.close();
+    LabelIndex::write(sharedFile, "sharedfile");
+
+    string oldIndex = "";
+    ifstream in; util.openInputFile(sharedFile + ".labels", in);
+    while (!in.eof()) { oldIndex += in.get(); }
+    in.close();
+    oldIndex.erase(oldIndex.length()-1); //eof
+
+    //the same size with the labels swapped, and the old index saved after it so its timestamp doesn't give it away
+    util.openOutputFile(sharedFile, out);
+    out << "label\tGroup\tnumOtus\tOtu1\tOtu2\n";
+    out << "0.03\tA\t2\t6\t0\n0.03\tB\t2\t10\t5\n";
+    out << "0.02\tA\t2\t3\t3\n0.02\tB\t2\t9\t6\n";
+    out.close();
+    util.openOutputFile(sharedFile + ".labels", out); out << oldIndex; out.close();
+
+    vector<string> groups;
+    InputData input(sharedFile, "sharedfile", groups);
+    SharedRAbundVectors* lookup = input.getSharedRAbundVectors("0.03"); //the old index sends it to the 0.02 lines
+    ASSERT_TRUE(lookup != NULL);
+    EXPECT_EQ(lookup->getLabel(), "0.03");
+    EXPECT_EQ(lookup->getOTUTotal(0), 16);
+    delete lookup;
+
+    LabelIndex rebuilt(sharedFile, "sharedfile");
+    EXPECT_EQ(rebuilt.find("0.03"), 0);
+
+    util.mothurRemove(sharedFile); util.mothurRemove(sharedFile + ".labels");
+}
+/**************************************************************************************************/
@@ -0,0 +1,54 @@
+//
+//  testlistvector.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "gtest/gtest.h"
+#include "listvector.hpp"
+#include "rabundvector.hpp"
+
+/**************************************************************************************************/
+TEST(Test_Container_ListVector, BinsGiveBackTheirNames) {
+    string tag = "Otu";
+    vector<string> bins; bins.push_back("seqA,seqB,seqC"); bins.push_back(""); bins.push_back("seqD"); bins.push_back("seqE,,seqF,");
+    ListVector list("0.03", bins, tag);
+
+    for (int i = 0; i < bins.size(); i++) { EXPECT_EQ(list.get(i), bins[i]); }
+    EXPECT_EQ(list.getNumSeqs(), 8);
+    EXPECT_EQ(list.getMaxRank(), 4);
+
+    vector<string> names; list.getNames(0, names);
+    ASSERT_EQ(names.size(), 3);
+    EXPECT_EQ(names[1], "seqB");
+
+    RAbundVector rabund = list.getRAbundVector();
+    EXPECT_EQ(rabund.get(0), 3); EXPECT_EQ(rabund.get(1), 0); EXPECT_EQ(rabund.get(3), 4);
+}
+/**************************************************************************************************/
+TEST(Test_Container_ListVector, MergeBinsLikeCluster) {
+    ListVector list(3);
+    list.set(0, "seqA"); list.set(1, "seqB,seqC"); list.set(2, "seqD");
+
+    list.mergeBins(1, 2);
+    EXPECT_EQ(list.get(1), "");
+    EXPECT_EQ(list.get(2), "seqB,seqC,seqD");
+    EXPECT_EQ(list.getNumBins(), 2);
+    EXPECT_EQ(list.getNumSeqs(), 4);
+    EXPECT_EQ(list.getMaxRank(), 3);
+
+    //a copy shares the names, another list numbers its own
+    ListVector copy(list);
+    copy.push_back("seqA,seqE");
+    EXPECT_EQ(copy.getIndexes(3)[0], list.getIndexes(0)[0]);
+    EXPECT_EQ(list.getNameTable()->getName(copy.getIndexes(3)[1]), "seqE");
+
+    ListVector other;
+    other.push_back("seqF");
+    other.push_back(list, 2);
+    EXPECT_EQ(other.get(1), "seqB,seqC,seqD");
+    EXPECT_EQ(other.getIndexes(1)[0], 1);
+    EXPECT_EQ(other.getNumSeqs(), 4);
+}
+/**************************************************************************************************/
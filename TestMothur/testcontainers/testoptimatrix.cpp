@@ -73,9 +73,9 @@ TEST(Test_Container_OptiMatrix, getCloseSeqs) {
     
     //11	GQY1XT001B04KZ,GQY1XT001EBRFH	17	32	52	55	57
     string Expected_ReturnResults = ""; Expected_ReturnResults += "17"; Expected_ReturnResults += "32"; Expected_ReturnResults += "52"; Expected_ReturnResults += "55"; Expected_ReturnResults += "57";
-    set<long long> temp = matrix.getCloseSeqs(11);
+    CloseSeqs temp = matrix.getCloseSeqs(11);
     string ReturnResults = "";
-    for (set<long long>::iterator it = temp.begin(); it != temp.end(); it++) { ReturnResults += toString(*it); }
+    for (CloseSeqs::iterator it = temp.begin(); it != temp.end(); it++) { ReturnResults += toString(*it); }
     
     EXPECT_EQ(Expected_ReturnResults, ReturnResults);
     
@@ -83,7 +83,7 @@ TEST(Test_Container_OptiMatrix, getCloseSeqs) {
     Expected_ReturnResults = ""; Expected_ReturnResults += "26"; Expected_ReturnResults += "42"; Expected_ReturnResults += "46";
     temp = matrix.getCloseSeqs(21);
     ReturnResults = "";
-    for (set<long long>::iterator it = temp.begin(); it != temp.end(); it++) { ReturnResults += toString(*it); }
+    for (CloseSeqs::iterator it = temp.begin(); it != temp.end(); it++) { ReturnResults += toString(*it); }
     
     EXPECT_EQ(Expected_ReturnResults, ReturnResults);
 
@@ -91,7 +91,7 @@ TEST(Test_Container_OptiMatrix, getCloseSeqs) {
     Expected_ReturnResults = ""; Expected_ReturnResults += "20"; Expected_ReturnResults += "27";
     temp = matrix.getCloseSeqs(31);
     ReturnResults = "";
-    for (set<long long>::iterator it = temp.begin(); it != temp.end(); it++) { ReturnResults += toString(*it); }
+    for (CloseSeqs::iterator it = temp.begin(); it != temp.end(); it++) { ReturnResults += toString(*it); }
     
     EXPECT_EQ(Expected_ReturnResults, ReturnResults);
 
@@ -99,7 +99,7 @@ TEST(Test_Container_OptiMatrix, getCloseSeqs) {
     Expected_ReturnResults = ""; Expected_ReturnResults += "19"; Expected_ReturnResults += "29";
     temp = matrix.getCloseSeqs(41);
     ReturnResults = "";
-    for (set<long long>::iterator it = temp.begin(); it != temp.end(); it++) { ReturnResults += toString(*it); }
+    for (CloseSeqs::iterator it = temp.begin(); it != temp.end(); it++) { ReturnResults += toString(*it); }
     
     EXPECT_EQ(Expected_ReturnResults, ReturnResults);
 
@@ -107,7 +107,7 @@ TEST(Test_Container_OptiMatrix, getCloseSeqs) {
     Expected_ReturnResults = ""; Expected_ReturnResults += "49";
     temp = matrix.getCloseSeqs(51);
     ReturnResults = "";
-    for (set<long long>::iterator it = temp.begin(); it != temp.end(); it++) { ReturnResults += toString(*it); }
+    for (CloseSeqs::iterator it = temp.begin(); it != temp.end(); it++) { ReturnResults += toString(*it); }
     
     EXPECT_EQ(Expected_ReturnResults, ReturnResults);
 }
@@ -159,3 +159,80 @@ TEST(Test_Container_OptiMatrix, getListSingle) {
 /**************************************************************************************************/
 
 
+
+TEST(Test_Container_OptiMatrix, readBinary) {
+    TestOptiMatrix testOMatrix;
+    OptiMatrix matrix(testOMatrix.columnFile, testOMatrix.filenames[1], "name", "column", 0.03, false);
+    
+    //write the column file as a binary distance file
+    vector<string> names; map<string, long long> nameIndex;
+    map<long long, map<long long, float> > rowDists;
+    ColumnDistReader in(testOMatrix.columnFile);
+    string seqA, seqB; float dist;
+    while (in.next(seqA, seqB, dist)) {
+        if (nameIndex.count(seqA) == 0) { nameIndex[seqA] = names.size(); names.push_back(seqA); }
+        if (nameIndex.count(seqB) == 0) { nameIndex[seqB] = names.size(); names.push_back(seqB); }
+        long long i = max(nameIndex[seqA], nameIndex[seqB]); long long j = min(nameIndex[seqA], nameIndex[seqB]);
+        if (i != j) { rowDists[i][j] = dist; }
+    }
+    in.close();
+    
+    string binaryFile = testOMatrix.columnFile + ".binary.temp";
+    BinaryDistWriter writer(binaryFile, names, false, 1);
+    BinaryDistRows rows;
+    for (long long i = 0; i < names.size(); i++) {
+        for (map<long long, float>::iterator it = rowDists[i].begin(); it != rowDists[i].end(); it++) { rows.add(it->first, it->second); }
+        rows.endRow();
+    }
+    writer.write(0, rows);
+    writer.close();
+    
+    OptiMatrix bmatrix(binaryFile, testOMatrix.filenames[1], "name", "column", 0.03, false);
+    Utils util; util.mothurRemove(binaryFile);
+    
+    EXPECT_EQ(matrix.getNumDists(), bmatrix.getNumDists());
+    EXPECT_EQ(matrix.getNumSeqs(), bmatrix.getNumSeqs());
+    EXPECT_EQ(matrix.getNumSingletons(), bmatrix.getNumSingletons());
+    
+    //the same sequences are close to each other
+    for (long long i = 0; i < bmatrix.getNumSeqs(); i++) {
+        CloseSeqs close = bmatrix.getCloseSeqs(i);
+        set<string> bNames, closeNames;
+        for (CloseSeqs::iterator it = close.begin(); it != close.end(); it++) { bNames.insert(bmatrix.getName(*it)); }
+        
+        long long index = matrix.getNameIndexMap()[bmatrix.getName(i)];
+        close = matrix.getCloseSeqs(index);
+        for (CloseSeqs::iterator it = close.begin(); it != close.end(); it++) { closeNames.insert(matrix.getName(*it)); }
+        
+        EXPECT_EQ(closeNames, bNames);
+    }
+    
+    EXPECT_EQ(0.5f, BinaryDistFile::halfToFloat(BinaryDistFile::floatToHalf(0.5f)));
+    EXPECT_NEAR(0.0312f, BinaryDistFile::halfToFloat(BinaryDistFile::floatToHalf(0.0312f)), 0.0001);
+}
+/**************************************************************************************************/
+TEST(Test_Container_OptiMatrix, packCloseness) {
+    OptiCloseness closeness;
+    closeness.resize(4);
+    
+    //repeats and pairs in both directions, the way the readers add them
+    closeness.insert(2, 3); closeness.insert(3, 2);
+    closeness.insert(0, 3); closeness.insert(3, 0);
+    closeness.insert(3, 2); closeness.insert(0, 1);
+    closeness.pack();
+    
+    EXPECT_EQ(4, closeness.size());
+    EXPECT_EQ(5, closeness.getNumPairs());
+    EXPECT_EQ(vector<uint32_t>({ 1, 3 }), vector<uint32_t>(closeness[0].begin(), closeness[0].end()));
+    EXPECT_EQ(vector<uint32_t>({ 0, 2 }), vector<uint32_t>(closeness[3].begin(), closeness[3].end()));
+    EXPECT_TRUE(closeness[1].empty());
+    EXPECT_EQ(1, closeness[2].count(3));
+    EXPECT_EQ(0, closeness[2].count(0));
+    
+    //pairs added after a pack are merged in
+    closeness.insert(1, 2); closeness.insert(2, 1);
+    closeness.pack();
+    EXPECT_EQ(7, closeness.getNumPairs());
+    EXPECT_EQ(vector<uint32_t>({ 1, 3 }), vector<uint32_t>(closeness[2].begin(), closeness[2].end()));
+}
+/**************************************************************************************************/
@@ -0,0 +1,74 @@
+//
+//  testsparsedistancematrix.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "gtest/gtest.h"
+#include "sparsedistancematrix.h"
+#include "testhelpers.hpp"
+
+/**************************************************************************************************/
+//every cell getSmallestCell could pick, found by looking at all of them
+static vector<PDistCellMin> getMins(SparseDistanceMatrix& matrix, float& smallest) {
+    vector<PDistCellMin> mins;
+    smallest = MOTHURMAX;
+    for (int i = 0; i < matrix.seqVec.size(); i++) {
+        for (int j = 0; j < matrix.seqVec[i].size(); j++) {
+            if (matrix.seqVec[i][j].index <= i) { continue; }
+            float dist = matrix.seqVec[i][j].dist;
+            if (dist < smallest) { mins.clear(); smallest = dist; mins.push_back(PDistCellMin(i, matrix.seqVec[i][j].index)); }
+            else if (fabs(dist-smallest) <= fabs(dist * 0.001)) { mins.push_back(PDistCellMin(i, matrix.seqVec[i][j].index)); }
+        }
+    }
+    return mins;
+}
+/**************************************************************************************************/
+TEST(Test_Container_SparseDistanceMatrix, SmallestCellAfterChanges) {
+    unsigned int seed = 11;
+    int numRows = 60;
+
+    SparseDistanceMatrix matrix;
+    matrix.resize(numRows);
+    set<pair<int, int> > pairs;
+    while (pairs.size() < 600) {
+        int row = nextRandom(seed, numRows), column = nextRandom(seed, numRows);
+        if ((row == column) || (pairs.count(make_pair(min(row, column), max(row, column))) != 0)) { continue; }
+        pairs.insert(make_pair(min(row, column), max(row, column)));
+        matrix.addCell(row, PDistCell(column, (1 + nextRandom(seed, 5)) / 100.0)); //lots of ties
+    }
+
+    for (int k = 0; k < 300; k++) {
+        ull row, column;
+        column = matrix.getSmallestCell(row);
+
+        float smallest;
+        vector<PDistCellMin> mins = getMins(matrix, smallest);
+        if (mins.size() == 0) { break; }
+
+        EXPECT_EQ(matrix.getSmallDist(), smallest);
+        bool found = false;
+        for (int i = 0; i < mins.size(); i++) { if ((mins[i].row == row) && (mins[i].col == column)) { found = true; } }
+        EXPECT_TRUE(found);
+
+        //change, remove or add a distance the way Cluster::update does
+        int changeRow = nextRandom(seed, numRows);
+        if (matrix.seqVec[changeRow].size() == 0) { continue; }
+        int cell = nextRandom(seed, matrix.seqVec[changeRow].size());
+        int change = nextRandom(seed, 3);
+
+        if (change == 0) {
+            matrix.seqVec[changeRow][cell].dist = (1 + nextRandom(seed, 5)) / 100.0;
+            matrix.updateCellCompliment(changeRow, cell);
+        }else if (change == 1) {
+            matrix.rmCell(changeRow, cell);
+        }else {
+            int other = nextRandom(seed, numRows);
+            bool missing = (other != changeRow);
+            for (int i = 0; i < matrix.seqVec[changeRow].size(); i++) { if (matrix.seqVec[changeRow][i].index == other) { missing = false; } }
+            if (missing) { matrix.addCellSorted(changeRow, PDistCell(other, (nextRandom(seed, 5)) / 100.0)); }
+        }
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,144 @@
+//
+//  testsparsesharedtable.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "gtest/gtest.h"
+#include "sparsesharedtable.hpp"
+#include "inputdata.h"
+#include <utime.h>
+
+/**************************************************************************************************/
+TEST(Test_Container_SparseSharedTable, ReadsTheSameTablesAsTheDenseVectors) {
+    Utils util;
+    string sharedFile = "sparsesharedtest.shared";
+    util.mothurRemove(sharedFile + ".sparse");
+
+    ofstream out; util.openOutputFile(sharedFile, out);
+    out << "label\tGroup\tnumOtus\tOtu1\tOtu2\tOtu3\tOtu4\n";
+    out << "0.01\tA\t4\t1\t0\t3\t0\n0.01\tB\t4\t0\t0\t6\t0\n0.01\tC\t4\t0\t0\t0\t5\n";
+    out << "0.03\tA\t3\t4\t0\t0\n0.03\tB\t3\t0\t6\t0\n0.03\tC\t3\t0\t0\t5\n";
+    out.close();
+
+    SparseSharedFile file(sharedFile);
+    ASSERT_EQ(file.getNumLabels(), 2);
+    EXPECT_EQ(file.find("0.03"), 1);
+    EXPECT_EQ(file.getOTUNames().size(), 4);
+
+    SparseSharedTable* table = file.getTable(0);
+    ASSERT_TRUE(table != NULL);
+    EXPECT_EQ(table->getNumNonZero(), 4);
+    SparseSharedVector row = table->getRow(0);
+    ASSERT_EQ(row.size, 2);
+    EXPECT_EQ(row.indexes[1], 2); EXPECT_EQ(row.counts[1], 3);
+    SparseSharedVector column = table->getColumn(2);
+    ASSERT_EQ(column.size, 2);
+    EXPECT_EQ(column.indexes[1], 1); EXPECT_EQ(column.counts[1], 6);
+    EXPECT_EQ(table->get(2, 3), 5); EXPECT_EQ(table->get(2, 0), 0);
+    EXPECT_EQ(table->getColumnTotal(2), 9);
+    delete table;
+
+    //picking groups drops the OTUs that are left empty, like the dense vectors do
+    vector<string> groups; groups.push_back("A"); groups.push_back("B");
+    InputData dense(sharedFile, "sharedfile", groups);
+    InputData sparse(sharedFile, "sharedfile", groups);
+
+    vector<string> labels; labels.push_back("0.01"); labels.push_back("0.03");
+    for (int i = 0; i < labels.size(); i++) {
+        SharedRAbundVectors* lookup = dense.getSharedRAbundVectors(labels[i]);
+        table = sparse.getSparseSharedTable(labels[i]);
+        ASSERT_TRUE((lookup != NULL) && (table != NULL));
+
+        EXPECT_EQ(table->getNumOtus(), lookup->getNumBins());
+        EXPECT_EQ(table->getOTUNames(), lookup->getOTUNames());
+
+        ostringstream denseOut, sparseOut; bool denseHeaders = true, sparseHeaders = true;
+        lookup->print(denseOut, denseHeaders);
+        table->print(sparseOut, sparseHeaders);
+        EXPECT_EQ(sparseOut.str(), denseOut.str());
+
+        delete lookup; delete table;
+    }
+
+    //the saved copy maps the same tables
+    SparseSharedFile saved(sharedFile);
+    table = saved.getTable(1);
+    ASSERT_TRUE(table != NULL);
+    EXPECT_EQ(table->getRowTotal(1), 6);
+    table->removeOTUs(vector<int>(1, 0));
+    table->push_back(vector<int>(3, 1), "OTURare1");
+    EXPECT_EQ(table->getOTUName(2), "OTURare1");
+    EXPECT_EQ(table->getColumnTotal(2), 3);
+    EXPECT_EQ(table->getRowTotal(0), 1);
+    delete table;
+
+    util.mothurRemove(sharedFile);
+}
+/**************************************************************************************************/
+TEST(Test_Container_SparseSharedTable, DeflatedCopyReadsTheSameTables) {
+    Utils util;
+    string sharedFile = "sparsedeflatetest.shared";
+    util.mothurRemove(sharedFile + ".sparse");
+
+    ofstream out; util.openOutputFile(sharedFile, out);
+    out << "label\tGroup\tnumOtus\tOtu1\tOtu2\tOtu3\tOtu4\n";
+    out << "0.01\tA\t4\t1\t0\t3\t0\n0.01\tB\t4\t0\t0\t6\t0\n0.01\tC\t4\t0\t0\t0\t5\n";
+    out.close();
+
+    SparseSharedFile::write(sharedFile, true);
+    SparseSharedFile deflated(sharedFile);
+    SparseSharedFile::write(sharedFile, false);
+    SparseSharedFile plain(sharedFile);
+
+    SparseSharedTable* deflatedTable = deflated.getTable(0);
+    SparseSharedTable* plainTable = plain.getTable(0);
+    ASSERT_TRUE((deflatedTable != NULL) && (plainTable != NULL));
+
+    ostringstream deflatedOut, plainOut; bool deflatedHeaders = true, plainHeaders = true;
+    deflatedTable->print(deflatedOut, deflatedHeaders);
+    plainTable->print(plainOut, plainHeaders);
+    EXPECT_EQ(deflatedOut.str(), plainOut.str());
+    EXPECT_EQ(deflatedTable->getColumnTotal(2), 9);
+    delete deflatedTable; delete plainTable;
+
+    util.mothurRemove(sharedFile);
+}
+/**************************************************************************************************/
+TEST(Test_Container_SparseSharedTable, RebuildsACopyThatDoesNotMatch) {
+    Utils util;
+    string sharedFile = "sparsematchtest.shared";
+    util.mothurRemove(sharedFile + ".sparse");
+
+    ofstream out; util.openOutputFile(sharedFile, out);
+    out << "0.01\tA\t2\t1\t0\n0.01\tB\t2\t0\t6\n0.03\tA\t1\t1\n0.03\tB\t1\t6\n";
+    out.close();
+    { SparseSharedFile file(sharedFile); ASSERT_EQ(file.getNumLabels(), 2); }
+
+    //same size, and the copy is left newer, so only its contents give it away
+    util.openOutputFile(sharedFile, out);
+    out << "0.02\tB\t2\t1\t0\n0.02\tA\t2\t0\t6\n0.04\tB\t1\t1\n0.04\tA\t1\t6\n";
+    out.close();
+    struct utimbuf times; times.actime = times.modtime = time(NULL) + 60;
+    utime((util.getFullPathName(sharedFile) + ".sparse").c_str(), &times);
+
+    SparseSharedFile file(sharedFile);
+    ASSERT_EQ(file.getNumLabels(), 2);
+    EXPECT_EQ(file.find("0.04"), 1);
+    SparseSharedTable* table = file.getTable(0);
+    ASSERT_TRUE(table != NULL);
+    EXPECT_EQ(table->get(0, 1), 6); //A is 0 6 in the edit
+    delete table;
+
+    //a short line is an error, not a table
+    util.openOutputFile(sharedFile, out);
+    out << "0.01\tA\t2\t1\t0\n0.01\tB\t2\t0\n";
+    out.close();
+    SparseSharedFile::write(sharedFile, false);
+    EXPECT_TRUE(MothurOut::getInstance()->getControl_pressed());
+    MothurOut::getInstance()->setControl_pressed(false);
+
+    util.mothurRemove(sharedFile);
+}
+/**************************************************************************************************/
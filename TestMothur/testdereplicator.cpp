@@ -0,0 +1,54 @@
+//
+//  testdereplicator.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "gtest/gtest.h"
+#include "dereplicator.hpp"
+
+/**************************************************************************************************/
+//reads drawn from a few sequences, every 7th read can't start a unique
+static vector<DerepUnique> dereplicate(int processors, long long memoryBudget, bool& spilled) {
+    Dereplicator dereplicator(processors, memoryBudget, "testdereplicator");
+    string bases = "ACGT";
+
+    vector<string> seqs, comments; vector<char> canStart;
+    for (int i = 0; i < 5000; i++) {
+        int which = (i * 7919) % 53;
+        string seq = "";
+        for (int j = 0; j < 40 + which; j++) { seq += bases[(j * which + j / 3) % 4]; }
+        seqs.push_back(seq); comments.push_back(""); canStart.push_back((i % 7) != 0);
+
+        if (seqs.size() == 300) { dereplicator.add(seqs, comments, canStart); seqs.clear(); comments.clear(); canStart.clear(); }
+    }
+    dereplicator.add(seqs, comments, canStart);
+    dereplicator.finish();
+    spilled = dereplicator.getSpilled();
+
+    vector<DerepUnique> uniques; DerepUnique unique;
+    while (dereplicator.getNext(unique)) { uniques.push_back(unique); }
+    EXPECT_EQ(uniques.size(), dereplicator.getNumUniques());
+    return uniques;
+}
+/**************************************************************************************************/
+TEST(Test_Dereplicator, SameInMemoryAndOnDisk) {
+    bool spilled = true;
+    vector<DerepUnique> inMemory = dereplicate(1, 100000000, spilled);
+    EXPECT_FALSE(spilled);
+
+    vector<DerepUnique> threaded = dereplicate(3, 100000000, spilled);
+    vector<DerepUnique> onDisk = dereplicate(3, 5000, spilled);
+    EXPECT_TRUE(spilled);
+
+    ASSERT_EQ(inMemory.size(), threaded.size());
+    ASSERT_EQ(inMemory.size(), onDisk.size());
+    for (int i = 0; i < inMemory.size(); i++) {
+        EXPECT_EQ(inMemory[i].seq, threaded[i].seq); EXPECT_EQ(inMemory[i].reads, threaded[i].reads);
+        EXPECT_EQ(inMemory[i].seq, onDisk[i].seq); EXPECT_EQ(inMemory[i].reads, onDisk[i].reads);
+        EXPECT_EQ(inMemory[i].registered, onDisk[i].registered);
+        if (i != 0) { EXPECT_LT(inMemory[i-1].reads[0], inMemory[i].reads[0]); }
+    }
+}
+/**************************************************************************************************/
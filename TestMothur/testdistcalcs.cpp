@@ -0,0 +1,146 @@
+//
+//  testdistcalcs.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testdistcalcs.hpp"
+
+/**************************************************************************************************/
+TestDistCalcs::TestDistCalcs(string calc, bool countends, double cutoff) {  //setup
+    m = MothurOut::getInstance();
+    
+    if (countends) {
+        if (calc == "nogaps")           {   distCalculator = new ignoreGaps(cutoff);                }
+        else if (calc == "eachgap")     {   distCalculator = new eachGapDist(cutoff);               }
+        else                            {   distCalculator = new oneGapDist(cutoff);                }
+    }else {
+        if (calc == "nogaps")           {   distCalculator = new ignoreGaps(cutoff);                }
+        else if (calc == "eachgap")     {   distCalculator = new eachGapIgnoreTermGapDist(cutoff);  }
+        else                            {   distCalculator = new oneGapIgnoreTermGapDist(cutoff);   }
+    }
+    
+    //hand made edge cases: terminal gaps, gap runs crossing the 64 column blocks, non overlapping and unencodable seqs
+    string block = "ACGTACGTAC-GT--ACG.TAC--GTACGTACG---TACGTACGTAC---GTACGTACGTACGTACG";
+    seqs.push_back(Sequence("seq1", "...." + block + block + "......"));
+    seqs.push_back(Sequence("seq2", "..AC" + block + block.substr(0, 40) + "--------------------------------" + "......"));
+    seqs.push_back(Sequence("seq3", "...................................................................................ACGTTTGCAAGT--ACGTTGCAGT-----------ACGT..........."));
+    seqs.push_back(Sequence("seq4", ".......ACG-TTGC----------------------------------------------------------------------AAC--GT..............................................."));
+    seqs.push_back(Sequence("seq5", "......................................................................................................................................................"));
+    seqs.push_back(Sequence("seq6", "NNRY" + block + block + "ACGTAC"));
+    seqs.push_back(Sequence("seq7", "----" + block + block + "------"));
+    
+    int length = seqs[0].getAligned().length();
+    for (int i = 0; i < seqs.size(); i++) { //pad or trim to the same alignment length
+        string aligned = seqs[i].getAligned(); aligned.resize(length, '.');
+        seqs[i].setAligned(aligned);
+    }
+    
+    //random alignments
+    Utils util;
+    string chars = "ACGT--";
+    for (int i = 0; i < 20; i++) {
+        string aligned = "";
+        int start = util.getRandomIndex(40); int end = length - util.getRandomIndex(40);
+        for (int j = 0; j < length; j++) {
+            if ((j < start) || (j >= end))  { aligned += '.';                                   }
+            else                            { aligned += chars[util.getRandomIndex((int)chars.length()-1)];   }
+        }
+        seqs.push_back(Sequence("random" + toString(i), aligned));
+    }
+}
+/**************************************************************************************************/
+TestDistCalcs::~TestDistCalcs() { delete distCalculator; }
+/**************************************************************************************************/
+//the bit packed distances must be identical to the character by character distances
+static void compareEncoded(string calc, bool countends, double cutoff) {
+    TestDistCalcs test(calc, countends, cutoff);
+    
+    vector<EncodedSeq> encoded;
+    for (int i = 0; i < test.seqs.size(); i++) { encoded.push_back(EncodedSeq(test.seqs[i].getAligned())); }
+    
+    for (int i = 0; i < test.seqs.size(); i++) {
+        for (int j = 0; j < test.seqs.size(); j++) {
+            if (test.seqs[i].getAligned().length() != test.seqs[j].getAligned().length()) { continue; }
+            
+            ASSERT_TRUE(test.distCalculator->canCalcEncoded(encoded[i], encoded[j]));
+            
+            double expected = test.distCalculator->calcDist(test.seqs[i], test.seqs[j]);
+            double result = test.distCalculator->calcDist(encoded[i], encoded[j]);
+            
+            EXPECT_EQ(expected, result) << calc << " " << test.seqs[i].getName() << " " << test.seqs[j].getName();
+        }
+    }
+}
+/**************************************************************************************************/
+//the packed rows, including the rows that fall back to the character comparisons, must match the Sequence distances
+static void comparePacked(string calc, bool countends, double cutoff) {
+    TestDistCalcs test(calc, countends, cutoff);
+    
+    string unencodable = test.seqs[0].getAligned(); unencodable[10] = 'X';
+    test.seqs.push_back(Sequence("unencodable", unencodable));
+    
+    SequenceDB db;
+    for (int i = 0; i < test.seqs.size(); i++) { db.push_back(test.seqs[i]); }
+    PackedSequenceDB packed(db);
+    
+    ASSERT_EQ(packed.getNumSeqs(), test.seqs.size());
+    EXPECT_EQ(packed.getNumEncoded(), test.seqs.size()-1);
+    
+    for (int i = 0; i < test.seqs.size(); i++) {
+        EXPECT_EQ(packed.getName(i), test.seqs[i].getName());
+        
+        for (int j = 0; j < test.seqs.size(); j++) {
+            double expected = test.distCalculator->calcDist(test.seqs[i], test.seqs[j]);
+            double result = test.distCalculator->calcDist(packed.get(i), packed.get(j));
+            
+            EXPECT_EQ(expected, result) << calc << " " << test.seqs[i].getName() << " " << test.seqs[j].getName();
+        }
+    }
+}
+/**************************************************************************************************/
+TEST(Test_Calc_DistCalcs, nogaps) {
+    compareEncoded("nogaps", true, 1.0);
+    compareEncoded("nogaps", true, 0.1);
+}
+
+TEST(Test_Calc_DistCalcs, eachgap) {
+    compareEncoded("eachgap", true, 1.0);
+    compareEncoded("eachgap", true, 0.1);
+}
+
+TEST(Test_Calc_DistCalcs, onegap) {
+    compareEncoded("onegap", true, 1.0);
+    compareEncoded("onegap", true, 0.1);
+}
+
+TEST(Test_Calc_DistCalcs, eachgapIgnoreTermGaps) {
+    compareEncoded("eachgap", false, 1.0);
+    compareEncoded("eachgap", false, 0.1);
+}
+
+TEST(Test_Calc_DistCalcs, onegapIgnoreTermGaps) {
+    compareEncoded("onegap", false, 1.0);
+    compareEncoded("onegap", false, 0.1);
+}
+
+TEST(Test_Calc_DistCalcs, packedRows) {
+    comparePacked("nogaps", true, 0.1);
+    comparePacked("eachgap", true, 1.0);
+    comparePacked("onegap", true, 0.1);
+    comparePacked("eachgap", false, 0.1);
+    comparePacked("onegap", false, 1.0);
+}
+
+TEST(Test_Calc_DistCalcs, unencodable) {
+    TestDistCalcs test("onegap", true, 1.0);
+    
+    EncodedSeq good(test.seqs[0].getAligned());
+    EncodedSeq bad("....ACGTXACGT");
+    
+    EXPECT_TRUE(good.isEncoded());
+    EXPECT_FALSE(bad.isEncoded());
+    EXPECT_FALSE(test.distCalculator->canCalcEncoded(good, bad));
+}
+/**************************************************************************************************/
@@ -0,0 +1,31 @@
+//
+//  testdistcalcs.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef testdistcalcs_hpp
+#define testdistcalcs_hpp
+
+#include "gtest/gtest.h"
+#include "ignoregaps.h"
+#include "eachgapdist.h"
+#include "eachgapignore.h"
+#include "onegapdist.h"
+#include "onegapignore.h"
+#include "packedsequencedb.hpp"
+
+class TestDistCalcs   {
+    
+public:
+    
+    TestDistCalcs(string, bool, double);
+    ~TestDistCalcs();
+    
+    MothurOut* m;
+    DistCalc* distCalculator;
+    vector<Sequence> seqs;
+};
+
+#endif /* testdistcalcs_hpp */
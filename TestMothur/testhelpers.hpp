@@ -0,0 +1,40 @@
+//
+//  testhelpers.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef testhelpers_hpp
+#define testhelpers_hpp
+
+#include "gtest/gtest.h"
+#include "mothur.h"
+#include "alignment.hpp"
+
+/**************************************************************************************************/
+//a small linear congruential generator, so the random inputs of a test are the same on every platform and seed
+inline int nextRandom(unsigned int& seed, int range) { seed = seed * 1103515245 + 12345; return (seed >> 16) % range; }
+/**************************************************************************************************/
+inline string randomBases(int length, unsigned int& seed, string bases = "ACGT") {
+    string seq = "";
+    for (int i = 0; i < length; i++) { seq += bases[nextRandom(seed, bases.length())]; }
+    return seq;
+}
+/**************************************************************************************************/
+//the aligner under test has to give the same alignment as the one it replaces
+inline void expectSameAlignment(Alignment& expected, Alignment& aligner, string A, string B) {
+    expected.align(A, B, true); aligner.align(A, B, true);
+
+    EXPECT_EQ(aligner.getSeqAAln(), expected.getSeqAAln());
+    EXPECT_EQ(aligner.getSeqBAln(), expected.getSeqBAln());
+    EXPECT_EQ(aligner.getCandidateStartPos(), expected.getCandidateStartPos());
+    EXPECT_EQ(aligner.getCandidateEndPos(), expected.getCandidateEndPos());
+    EXPECT_EQ(aligner.getTemplateStartPos(), expected.getTemplateStartPos());
+    EXPECT_EQ(aligner.getTemplateEndPos(), expected.getTemplateEndPos());
+    EXPECT_EQ(aligner.getPairwiseLength(), expected.getPairwiseLength());
+    EXPECT_EQ(aligner.getSeqAAlnBaseMap(), expected.getSeqAAlnBaseMap());
+}
+/**************************************************************************************************/
+
+#endif /* testhelpers_hpp */
@@ -47,9 +47,43 @@ TEST(Test_Cluster_OptiCluster, getCloseFarCounts) {
     test.initialize(initialMetricValue, false, "singleton"); //no randomization
     test.update(initialMetricValue);
     
-    vector<long long> results = test.getCloseFarCounts(0, 31);
+    vector<double> results = test.getCloseFarCounts(0, 31);
     
     ASSERT_EQ(results[0], 0); //number of close sequences in bin 31 to seq 0
     ASSERT_EQ(results[1], 10); //number of far sequences in bin 31 to seq 0
 }
 /**************************************************************************************************/
+
+TEST(Test_Cluster_OptiCluster, updateParallel) {
+    MothurOut* m = MothurOut::getInstance();
+    Utils util;
+    FakeOptiMatrix matrix(60); //600 seqs, more than one batch with 2 processors
+    MCC metric;
+    
+    vector< vector<string> > otus(2);
+    for (int processors = 1; processors < 3; processors++) {
+        m->setRandomSeed(123456); //same randomization for both
+        OptiCluster cluster(&matrix, &metric, matrix.getNumSingletons(), processors);
+        
+        double metricValue;
+        cluster.initialize(metricValue, true, "singleton");
+        for (int i = 0; i < 3; i++) { cluster.update(metricValue); }
+        EXPECT_NEAR(1, metricValue, 0.00001);
+        
+        //the bins can be numbered differently, so compare them sorted
+        ListVector* list = cluster.getList();
+        for (int i = 0; i < list->getNumBins(); i++) {
+            string bin = list->get(i);
+            vector<string> names; util.splitAtComma(bin, names);
+            sort(names.begin(), names.end());
+            string otu = ""; for (int j = 0; j < names.size(); j++) { otu += names[j] + ","; }
+            otus[processors-1].push_back(otu);
+        }
+        sort(otus[processors-1].begin(), otus[processors-1].end());
+        delete list;
+    }
+    
+    EXPECT_EQ(70, otus[0].size()); //60 sets and 10 singletons
+    EXPECT_EQ(otus[0], otus[1]);
+}
+/**************************************************************************************************/
@@ -0,0 +1,67 @@
+//
+//  testpermutationtest.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "gtest/gtest.h"
+#include "permutationtest.hpp"
+
+/**************************************************************************************************/
+//how far the permutation moves the indexes, 0 for the identity
+static double displacement(const vector<int>& permutation) {
+    double sum = 0.0;
+    for (int i = 0; i < permutation.size(); i++) { sum += abs(permutation[i] - i); }
+    return sum;
+}
+/**************************************************************************************************/
+TEST(Test_PermutationTest, SameForAnyProcessors) {
+    MothurOut* m = MothurOut::getInstance();
+    m->setRandomSeed(123456); //stabilize radomization
+    PermutationTest single("test", 500, 1, 0), threaded("test", 500, 3, 0);
+    PermutationTest::Statistic statistic = displacement;
+
+    for (int test = 0; test < 3; test++) {
+        double observed = 40.0 + 8.0 * test;
+        double pValue = single.getPValue(statistic, 12, observed, PermutationTest::atMost);
+
+        EXPECT_EQ(pValue, threaded.getPValue(statistic, 12, observed, PermutationTest::atMost));
+        EXPECT_EQ(single.getNumRun(), 500);
+        EXPECT_GT(pValue, 0.0); EXPECT_LT(pValue, 1.0);
+    }
+
+    //only the identity is as close as the data
+    EXPECT_EQ(single.getPValue(statistic, 12, 0.0, PermutationTest::atMost), 0.0);
+}
+/**************************************************************************************************/
+TEST(Test_PermutationTest, StopsOnceDecided) {
+    MothurOut* m = MothurOut::getInstance();
+    m->setRandomSeed(123456); //stabilize radomization
+    PermutationTest::Statistic statistic = displacement;
+
+    //most randomizations move the indexes at least this far, so the test ends after the 10th
+    PermutationTest early("test", 2000, 3, 10);
+    double pValue = early.getPValue(statistic, 12, 20.0, PermutationTest::atLeast);
+    EXPECT_LT(early.getNumRun(), 20);
+    EXPECT_EQ(pValue, 10.0 / early.getNumRun());
+
+    //it stops at the randomization that makes the 10th hit. The first test of a name uses the same randomizations,
+    //so running just that many and one less without a stop count finds 10 and 9 as extreme
+    PermutationTest middle("test", 2000, 3, 10);
+    double middlePValue = middle.getPValue(statistic, 12, 52.0, PermutationTest::atLeast);
+    int numRun = middle.getNumRun();
+    ASSERT_LT(numRun, 2000);
+    EXPECT_EQ(middlePValue, 10.0 / numRun);
+
+    PermutationTest upTo("test", numRun, 1, 0), upToBefore("test", numRun - 1, 1, 0);
+    EXPECT_DOUBLE_EQ(upTo.getPValue(statistic, 12, 52.0, PermutationTest::atLeast) * numRun, 10.0);
+    EXPECT_DOUBLE_EQ(upToBefore.getPValue(statistic, 12, 52.0, PermutationTest::atLeast) * (numRun - 1), 9.0);
+
+    //a small p-value still runs all the iters, only the identity is as close as the data
+    PermutationTest small("test", 2000, 3, 10), full("test", 2000, 1, 0);
+    double smallPValue = small.getPValue(statistic, 12, 0.0, PermutationTest::atMost);
+    EXPECT_EQ(small.getNumRun(), 2000);
+    EXPECT_EQ(smallPValue, full.getPValue(statistic, 12, 0.0, PermutationTest::atMost));
+}
+/**************************************************************************************************/
@@ -0,0 +1,93 @@
+//
+//  testrandomstream.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "gtest/gtest.h"
+#include "randomstream.hpp"
+
+/**************************************************************************************************/
+//runs the generator on a raw Philox counter and key
+class TestRandomStream {
+public:
+    static vector<uint32_t> getBlock(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3, uint32_t k0, uint32_t k1) {
+        RandomStream random(k0, k1, ((unsigned long long)c3 << 32) | c2);
+        random.block = ((unsigned long long)c1 << 32) | c0;
+        random.generate();
+        return vector<uint32_t>(random.output, random.output+4);
+    }
+};
+
+/**************************************************************************************************/
+//the Philox4x32-10 known answers from Random123's kat_vectors
+TEST(Test_RandomStream, PhiloxKnownAnswers) {
+    uint32_t zeros[4] = { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 };
+    EXPECT_EQ(TestRandomStream::getBlock(0, 0, 0, 0, 0, 0), vector<uint32_t>(zeros, zeros+4));
+
+    uint32_t ones[4] = { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd };
+    EXPECT_EQ(TestRandomStream::getBlock(0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff), vector<uint32_t>(ones, ones+4));
+
+    uint32_t pi[4] = { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 };
+    EXPECT_EQ(TestRandomStream::getBlock(0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344, 0xa4093822, 0x299f31d0), vector<uint32_t>(pi, pi+4));
+}
+/**************************************************************************************************/
+TEST(Test_RandomStream, StreamsDependOnlyOnTheirKeys) {
+    RandomStream first(19760620, "rarefaction.single", 7), again(19760620, "rarefaction.single", 7);
+    RandomStream otherItem(19760620, "rarefaction.single", 8), otherName(19760620, "rarefaction.shared", 7), otherSeed(9, "rarefaction.single", 7);
+
+    //work item 7 gives the same numbers however many other streams were used before it
+    for (int i = 0; i < 1000; i++) { otherItem(); }
+
+    int numSame = 0;
+    for (int i = 0; i < 100; i++) {
+        unsigned long long value = first();
+        EXPECT_EQ(value, again());
+        if ((value == otherItem()) || (value == otherName()) || (value == otherSeed())) { numSame++; }
+    }
+    EXPECT_EQ(numSame, 0);
+
+    //a piece of a work item has its own stream, the same each time it is split off
+    RandomStream piece = RandomStream(19760620, "rarefaction.single", 7).split(3), samePiece = RandomStream(19760620, "rarefaction.single", 7).split(3);
+    RandomStream otherPiece = RandomStream(19760620, "rarefaction.single", 8).split(3), parent(19760620, "rarefaction.single", 3);
+    for (int i = 0; i < 100; i++) {
+        unsigned long long value = piece();
+        EXPECT_EQ(value, samePiece());
+        EXPECT_NE(value, otherPiece());
+        EXPECT_NE(value, parent());
+    }
+
+    //the constructors that use the seed from set.seed key the stream the same way
+    MothurOut* m = MothurOut::getInstance();
+    unsigned oldSeed = m->getRandomSeed();
+    m->setRandomSeed(19760620);
+    RandomStream fromSetSeed("rarefaction.single", 7), seeded(19760620, "rarefaction.single", 7);
+    for (int i = 0; i < 100; i++) { EXPECT_EQ(fromSetSeed(), seeded()); }
+    m->setRandomSeed(oldSeed);
+}
+/**************************************************************************************************/
+TEST(Test_RandomStream, IndexesAndShuffles) {
+    RandomStream random(5, "test", 0);
+
+    vector<int> counts(10, 0);
+    for (int i = 0; i < 10000; i++) {
+        long long index = random.getRandomIndex(9);
+        ASSERT_GE(index, 0); ASSERT_LE(index, 9);
+        counts[index]++;
+
+        double value = random.getRandomDouble0to1();
+        ASSERT_GE(value, 0.0); ASSERT_LT(value, 1.0);
+    }
+    for (int i = 0; i < counts.size(); i++) { EXPECT_GT(counts[i], 800); EXPECT_LT(counts[i], 1200); }
+    EXPECT_EQ(random.getRandomIndex(0), 0);
+
+    vector<int> items;
+    for (int i = 0; i < 100; i++) { items.push_back(i); }
+    vector<int> shuffled = items;
+    random.shuffle(shuffled);
+    EXPECT_NE(shuffled, items);
+    sort(shuffled.begin(), shuffled.end());
+    EXPECT_EQ(shuffled, items);
+}
+/**************************************************************************************************/
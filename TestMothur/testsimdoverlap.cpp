@@ -0,0 +1,50 @@
+//
+//  testsimdoverlap.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "gtest/gtest.h"
+#include "simdoverlap.hpp"
+#include "needlemanoverlap.hpp"
+#include "gotohoverlap.hpp"
+#include "testhelpers.hpp"
+
+/**************************************************************************************************/
+//a mutated copy of seq, so the pairs have real alignments with gaps at both ends
+static string mutate(string seq, unsigned int& seed) {
+    string mutated = "";
+    for (int i = 0; i < seq.length(); i++) {
+        int roll = nextRandom(seed, 20);
+        if (roll == 0)      { continue; }
+        else if (roll == 1) { mutated += randomBases(1, seed, "ACGTN") + seq[i]; }
+        else if (roll == 2) { mutated += randomBases(1, seed, "ACGTN"); }
+        else                { mutated += seq[i]; }
+    }
+    return mutated;
+}
+/**************************************************************************************************/
+TEST(Test_SIMDOverlap, MatchesNeedlemanAndGotoh) {
+    unsigned int seed = 11;
+    int longest = 700;
+
+    //the defaults use the int16 kernel, the fractional penalties use the scalar fill
+    NeedlemanOverlap needleman(-2.0, 1.0, -1.0, longest);       NeedlemanSIMDOverlap simdNeedleman(-2.0, 1.0, -1.0, longest);
+    GotohOverlap gotoh(-2.0, -1.0, 1.0, -1.0, longest);         GotohSIMDOverlap simdGotoh(-2.0, -1.0, 1.0, -1.0, longest);
+    GotohOverlap fractional(-1.5, -0.5, 1.0, -1.0, longest);    GotohSIMDOverlap simdFractional(-1.5, -0.5, 1.0, -1.0, longest);
+
+    for (int i = 0; i < 30; i++) {
+        string A = randomBases(1 + (i * 37) % 600, seed, "ACGTN");
+        string B = mutate(A, seed);
+        if ((i % 3) == 0)       { B = B.substr(B.length() / 4); }                  //B starts inside A
+        else if ((i % 3) == 1)  { B = randomBases(20, seed, "ACGTN") + B.substr(0, B.length() / 2); } //B hangs off the front of A
+        if (B == "") { B = "A"; }
+
+        expectSameAlignment(needleman, simdNeedleman, A, B);
+        expectSameAlignment(gotoh, simdGotoh, A, B);
+        expectSameAlignment(fractional, simdFractional, A, B);
+        expectSameAlignment(gotoh, simdGotoh, B, A);
+    }
+}
+/**************************************************************************************************/
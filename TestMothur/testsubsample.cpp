@@ -42,3 +42,53 @@ TEST(Test_SubSample, getWeightedSample) {
 }
 
 /**************************************************************************************************/
+TEST(Test_SubSample, getSampleFromAbundances) {
+    TestSubSample test;
+    
+    vector<int> abunds; abunds.push_back(1); abunds.push_back(0); abunds.push_back(5); abunds.push_back(100); abunds.push_back(20); abunds.push_back(2); //128 total reads
+    
+    for (int i = 0; i < 20; i++) {
+        vector<int> sampled = test.getSample(abunds, 50);
+        ASSERT_EQ(sampled.size(), abunds.size());
+        
+        int total = 0;
+        for (int j = 0; j < sampled.size(); j++) { total += sampled[j]; EXPECT_LE(sampled[j], abunds[j]); EXPECT_GE(sampled[j], 0); }
+        EXPECT_EQ(total, 50);
+        
+        sampled = test.getSampleWithReplacement(abunds, 500);
+        total = 0;
+        for (int j = 0; j < sampled.size(); j++) { total += sampled[j]; if (abunds[j] == 0) { EXPECT_EQ(sampled[j], 0); } }
+        EXPECT_EQ(total, 500);
+    }
+    
+    EXPECT_EQ(test.getSample(abunds, 128), abunds); //select all the reads
+}
+
+/**************************************************************************************************/
+TEST(Test_SubSample, getSampleFromAbundancesMeans) {
+    MothurOut* m = MothurOut::getInstance();
+    m->setRandomSeed(123456); //stabilize radomization
+    TestSubSample test;
+    
+    vector<int> abunds; abunds.push_back(1); abunds.push_back(0); abunds.push_back(5); abunds.push_back(100); abunds.push_back(20); abunds.push_back(2); //128 total reads
+    double total = 128; int numDraws = 20000;
+    
+    vector<double> sums(abunds.size(), 0), sumsWithReplacement(abunds.size(), 0);
+    for (int i = 0; i < numDraws; i++) {
+        vector<int> sampled = test.getSample(abunds, 50);
+        vector<int> sampledWithReplacement = test.getSampleWithReplacement(abunds, 500);
+        for (int j = 0; j < abunds.size(); j++) { sums[j] += sampled[j]; sumsWithReplacement[j] += sampledWithReplacement[j]; }
+    }
+    
+    //each OTU's mean draw is size * n_i / N, within 4 standard errors
+    for (int j = 0; j < abunds.size(); j++) {
+        double share = abunds[j] / total;
+        
+        double variance = 50 * share * (1 - share) * (total - 50) / (total - 1); //hypergeometric
+        EXPECT_NEAR(sums[j] / numDraws, 50 * share, 4 * sqrt(variance / numDraws) + 1e-9);
+        
+        variance = 500 * share * (1 - share); //binomial
+        EXPECT_NEAR(sumsWithReplacement[j] / numDraws, 500 * share, 4 * sqrt(variance / numDraws) + 1e-9);
+    }
+}
+/**************************************************************************************************/
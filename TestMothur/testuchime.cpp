@@ -0,0 +1,114 @@
+//
+//  testuchime.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "gtest/gtest.h"
+#include "uchimelib.h"
+#include "utils.hpp"
+
+/**************************************************************************************************/
+//three abundant parents, a chimera of the first two and a few rare variants of the parents
+static vector<UchimeQuery> getQueries(vector<string>& parents) {
+    string bases = "ACGT";
+    unsigned long long state = 12345;
+    parents.clear();
+    for (int i = 0; i < 3; i++) {
+        string seq = "";
+        for (int j = 0; j < 300; j++) { state = state * 6364136223846793005ULL + 1442695040888963407ULL; seq += bases[(state >> 33) % 4]; }
+        parents.push_back(seq);
+    }
+
+    vector<UchimeQuery> queries;
+    for (int i = 0; i < parents.size(); i++) { queries.push_back(UchimeQuery("parent" + toString(i) + "/ab=100/", parents[i], 100)); }
+    queries.push_back(UchimeQuery("chimera/ab=5/", parents[0].substr(0, 150) + parents[1].substr(150), 5));
+    for (int i = 0; i < parents.size(); i++) {
+        string variant = parents[i];
+        variant[50 + 10 * i] = (variant[50 + 10 * i] == 'A') ? 'C' : 'A';
+        queries.push_back(UchimeQuery("variant" + toString(i) + "/ab=2/", variant, 2));
+    }
+    return queries;
+}
+/**************************************************************************************************/
+static void deNovo(vector<UchimeQuery>* queries, vector<UchimeHit>* hits) { UchimeDeNovo(*queries, true, *hits); }
+/**************************************************************************************************/
+static void searchReference(UchimeReference* reference, vector<UchimeQuery>* queries, vector<UchimeHit>* hits) { reference->Search(*queries, true, *hits); }
+/**************************************************************************************************/
+static void expectSameHits(vector<UchimeHit>& left, vector<UchimeHit>& right) {
+    ASSERT_EQ(left.size(), right.size());
+    for (int i = 0; i < left.size(); i++) {
+        EXPECT_EQ(left[i].Index, right[i].Index);
+        EXPECT_EQ(left[i].Line, right[i].Line);
+        EXPECT_EQ(left[i].Alns, right[i].Alns);
+        EXPECT_EQ(left[i].Chimera, right[i].Chimera);
+    }
+}
+/**************************************************************************************************/
+TEST(Test_Uchime, DeNovoFindsChimeraOnAnyThread) {
+    SetUchimeOptions(vector<string>(1, "--quiet"));
+
+    vector<string> parents;
+    vector<UchimeQuery> queries = getQueries(parents);
+
+    vector<UchimeHit> hits;
+    UchimeDeNovo(queries, true, hits);
+    ASSERT_EQ(hits.size(), queries.size());
+    for (int i = 0; i < hits.size(); i++) {
+        EXPECT_EQ(hits[i].Chimera, (queries[hits[i].Index].Label == "chimera/ab=5/"));
+        if (hits[i].Chimera) { EXPECT_NE(hits[i].Alns, ""); }
+    }
+
+    vector<vector<UchimeHit> > threadHits(3);
+    vector<std::thread*> threads;
+    for (int i = 0; i < threadHits.size(); i++) { threads.push_back(new std::thread(deNovo, &queries, &threadHits[i])); }
+    for (int i = 0; i < threads.size(); i++) { threads[i]->join(); delete threads[i]; expectSameHits(hits, threadHits[i]); }
+}
+/**************************************************************************************************/
+TEST(Test_Uchime, ReferenceSharedByThreads) {
+    SetUchimeOptions(vector<string>(1, "--quiet"));
+
+    vector<string> parents;
+    vector<UchimeQuery> queries = getQueries(parents);
+
+    Utils util;
+    string refFile = "testuchime.ref.fasta";
+    ofstream out; util.openOutputFile(refFile, out);
+    for (int i = 0; i < parents.size(); i++) { out << ">ref" << i << endl << parents[i] << endl; }
+    out.close();
+
+    UchimeReference reference(refFile);
+    util.mothurRemove(refFile);
+    EXPECT_EQ(reference.GetSeqCount(), parents.size());
+
+    vector<UchimeHit> hits;
+    reference.Search(queries, true, hits);
+    ASSERT_EQ(hits.size(), queries.size());
+    for (int i = 0; i < hits.size(); i++) {
+        EXPECT_EQ(hits[i].Index, i);
+        EXPECT_EQ(hits[i].Chimera, (queries[i].Label == "chimera/ab=5/"));
+    }
+
+    vector<vector<UchimeHit> > threadHits(3);
+    vector<std::thread*> threads;
+    for (int i = 0; i < threadHits.size(); i++) { threads.push_back(new std::thread(searchReference, &reference, &queries, &threadHits[i])); }
+    for (int i = 0; i < threads.size(); i++) { threads[i]->join(); delete threads[i]; expectSameHits(hits, threadHits[i]); }
+}
+/**************************************************************************************************/
+TEST(Test_Uchime, ErrorsThrowRatherThanExit) {
+    SetUchimeOptions(vector<string>(1, "--quiet"));
+
+    EXPECT_THROW(UchimeReference reference("testuchime.missing.fasta"), UchimeError);
+
+    vector<UchimeHit> hits;
+    vector<UchimeQuery> protein(1, UchimeQuery("protein/ab=1/", "MKVLWEQHPRSFDIYLMKVLWEQHPRSFDIYL", 1));
+    EXPECT_THROW(UchimeDeNovo(protein, false, hits), UchimeError);
+
+    //the thread can search again after an error
+    vector<string> parents;
+    vector<UchimeQuery> queries = getQueries(parents);
+    UchimeDeNovo(queries, false, hits);
+    EXPECT_EQ(hits.size(), queries.size());
+}
+/**************************************************************************************************/
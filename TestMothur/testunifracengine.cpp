@@ -0,0 +1,83 @@
+//
+//  testunifracengine.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "gtest/gtest.h"
+#include "unifracengine.hpp"
+
+/**************************************************************************************************/
+//((s0:0.1,s1:0.2):0.5,(s2:0.3,s3:0.4):0.6) with
+//  s0  A=2     s1  A=1     s2  A=1 B=3     s3  B=1 C=4
+//the pairs are B-A, C-A and C-B. The root of C-B is the parent of s2 and s3, the other pairs' is the top of the tree.
+class TestUnifracTree {
+public:
+    TestUnifracTree() {
+        ct = new CountTable();
+        vector<string> groups; groups.push_back("A"); groups.push_back("B"); groups.push_back("C");
+        ct->setNamesOfGroups(groups);
+
+        int abunds[4][3] = { {2, 0, 0}, {1, 0, 0}, {1, 3, 0}, {0, 1, 4} };
+        vector<string> names;
+        for (int i = 0; i < 4; i++) {
+            names.push_back("s" + toString(i));
+            ct->push_back(names[i], vector<int>(abunds[i], abunds[i]+3));
+        }
+
+        tree = new Tree(ct, names);
+        float lengths[6] = { 0.1, 0.2, 0.3, 0.4, 0.5, 0.6 };
+        for (int i = 0; i < 6; i++) { tree->tree[i].setBranchLength(lengths[i]); }
+        tree->tree[4].setChildren(0, 1); tree->tree[0].setParent(4); tree->tree[1].setParent(4);
+        tree->tree[5].setChildren(2, 3); tree->tree[2].setParent(5); tree->tree[3].setParent(5);
+        tree->tree[6].setChildren(4, 5); tree->tree[4].setParent(6); tree->tree[5].setParent(6);
+        tree->assembleTree();
+
+        Groups = groups;
+    }
+    ~TestUnifracTree() { delete tree; delete ct; }
+
+    CountTable* ct;
+    Tree* tree;
+    vector<string> Groups;
+};
+/**************************************************************************************************/
+static void expectScores(EstOutput scores, double ba, double ca, double cb) {
+    ASSERT_EQ(scores.size(), 3);
+    EXPECT_NEAR(scores[0], ba, 0.00001);
+    EXPECT_NEAR(scores[1], ca, 0.00001);
+    EXPECT_NEAR(scores[2], cb, 0.00001);
+}
+/**************************************************************************************************/
+TEST(Test_Calc_UnifracEngine, UsersTree) {
+    TestUnifracTree data;
+
+    UnifracEngine withRoot(data.tree, data.Groups, true);
+    expectScores(withRoot.getUnweighted(1), 1.2 / 2.1, 1.5 / 2.1, 0.3 / 1.3);
+    expectScores(withRoot.getWeighted(2), 1.175 / 1.625, 1.4 / 1.7, 0.525 / 1.925);
+
+    //C-B leaves out the branch above s2 and s3
+    UnifracEngine withoutRoot(data.tree, data.Groups, false);
+    expectScores(withoutRoot.getUnweighted(2), 1.2 / 2.1, 1.5 / 2.1, 0.3 / 0.7);
+    expectScores(withoutRoot.getWeighted(1), 1.175 / 1.625, 1.4 / 1.7, 0.525 / 0.725);
+}
+/**************************************************************************************************/
+TEST(Test_Calc_UnifracEngine, RandomTrees) {
+    TestUnifracTree data;
+
+    //B-A swaps s0 and s3, C-A keeps the users tree, C-B swaps s2 and s3
+    vector< vector<int> > swaps(3);
+    swaps[0].push_back(0); swaps[0].push_back(3);
+    swaps[2].push_back(2); swaps[2].push_back(3);
+
+    UnifracEngine withRoot(data.tree, data.Groups, true);
+    expectScores(withRoot.getUnweighted(swaps, 2), 0.7 / 2.1, 1.5 / 2.1, 0.4 / 1.3);
+    expectScores(withRoot.getWeighted(swaps, 1), 0.425 / 1.725, 1.4 / 1.7, 0.525 / 1.875);
+
+    //the random trees keep the users tree's roots
+    UnifracEngine withoutRoot(data.tree, data.Groups, false);
+    expectScores(withoutRoot.getUnweighted(swaps, 1), 0.7 / 2.1, 1.5 / 2.1, 0.4 / 0.7);
+    expectScores(withoutRoot.getWeighted(swaps, 2), 0.425 / 1.725, 1.4 / 1.7, 0.525 / 0.675);
+}
+/**************************************************************************************************/
@@ -0,0 +1,168 @@
+//
+//  bandedoverlap.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "bandedoverlap.hpp"
+
+static const float unreachable = -1e30; //score of the cells outside the band
+
+/**************************************************************************************************/
+BandedOverlap::BandedOverlap(float gO, float gE, float f, float mm, bool a) :
+Alignment(), gapOpen(gO), gapExtend(gE), match(f), mismatch(mm), affine(a) {
+    try {
+        nRows = 0; nCols = 0;
+        diagonal = 0; width = 0; lower = 0; bandWidth = 1; upFromRow = 0; leftFromColumn = 0;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BandedOverlap", "BandedOverlap");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void BandedOverlap::align(string A, string B, bool createBaseMap){
+    try {
+        seqA = ' ' + A;	lA = seqA.length();		//	the algorithm requires that the first character be a dummy value
+        seqB = ' ' + B;	lB = seqB.length();		//	the algorithm requires that the first character be a dummy value
+
+        lower = diagonal - width;
+        bandWidth = 2 * width + 1;
+        pointers.assign((long long)lB * bandWidth, 'x');
+
+        //row 0 and column 0 are free starts
+        lastColumn.assign(lB, unreachable); lastColumn[0] = 0;
+        lastRow.assign(lA, unreachable); lastRow[0] = 0;
+        if (lA == 1) { lastColumn.assign(lB, 0); }
+        if (lB == 1) { lastRow.assign(lA, 0); }
+
+        fill();
+        setOverlap();                           //	Fix the gaps at the ends of the sequences
+        traceBack(createBaseMap);               //	Construct the alignment and set seqAaln and seqBaln
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BandedOverlap", "align");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//the recursions and ties of NeedlemanOverlap::align and GotohOverlap::align, a row of the band at a time. Cell k of a
+//row is column i+lower+k, so the cell up and to the left is cell k of the row above and the cell above is cell k+1.
+void BandedOverlap::fill() {
+    try {
+        previousScores.assign(bandWidth, unreachable); currentScores.assign(bandWidth, unreachable);
+        upGaps.assign(bandWidth, unreachable); nextUpGaps.assign(bandWidth, unreachable);
+
+        for (int k = 0; k < bandWidth; k++) {
+            int j = lower + k;
+            if ((j >= 0) && (j < lA)) { previousScores[k] = 0; upGaps[k] = 0; }
+        }
+
+        for (int i = 1; i < lB; i++) {
+            char* pointerRow = &pointers[0] + (long long)i * bandWidth;
+            int firstColumn = i + lower;
+
+            float leftScore = unreachable, leftGap = unreachable; //the cell left of the band
+            if (firstColumn == 1) { leftScore = 0; leftGap = 0; }
+
+            for (int k = 0; k < bandWidth; k++) {
+                int j = firstColumn + k;
+
+                if ((j <= 0) || (j >= lA)) { //off the matrix, column 0 is a free start
+                    float score = (j == 0) ? 0 : unreachable;
+                    currentScores[k] = score; nextUpGaps[k] = score;
+                    leftScore = score; leftGap = score;
+                    continue;
+                }
+
+                float diagonal = previousScores[k] + ((seqB[i] == seqA[j]) ? match : mismatch);
+                float aboveScore = (k+1 < bandWidth) ? previousScores[k+1] : unreachable;
+                float score; char prevCell;
+
+                if (affine) {
+                    float aboveGap = (k+1 < bandWidth) ? upGaps[k+1] : unreachable;
+                    leftGap = max(leftGap, leftScore + gapOpen) + gapExtend;
+                    float up = max(aboveGap, aboveScore + gapOpen) + gapExtend;
+                    nextUpGaps[k] = up;
+
+                    if (leftGap > up) {
+                        if (leftGap > diagonal) { score = leftGap; prevCell = 'l'; }
+                        else { score = diagonal; prevCell = 'd'; }
+                    }else {
+                        if (up > diagonal) { score = up; prevCell = 'u'; }
+                        else { score = diagonal; prevCell = 'd'; }
+                    }
+                }else {
+                    float up = aboveScore + gapOpen;
+                    float left = leftScore + gapOpen;
+
+                    if (diagonal >= up) {
+                        if (diagonal >= left) { score = diagonal; prevCell = 'd'; }
+                        else { score = left; prevCell = 'l'; }
+                    }else {
+                        if (up >= left) { score = up; prevCell = 'u'; }
+                        else { score = left; prevCell = 'l'; }
+                    }
+                }
+
+                currentScores[k] = score;
+                pointerRow[k] = prevCell;
+                leftScore = score;
+
+                if (j == lA-1) { lastColumn[i] = score; }
+                if (i == lB-1) { lastRow[j] = score; }
+            }
+
+            swap(previousScores, currentScores);
+            swap(upGaps, nextUpGaps);
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BandedOverlap", "fill");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//Overlap::setOverlap on the saved last column and row, like SIMDOverlap::setOverlap
+void BandedOverlap::setOverlap() {
+    try {
+        int row = lB-1;
+        int column = lA-1;
+
+        float maxScore = -100;
+        int rowIndex = column; //Overlap starts both searches from the other dimension's end
+        for (int i = 0; i < lB; i++) { if (lastColumn[i] >= maxScore) { rowIndex = i; maxScore = lastColumn[i]; } }
+
+        maxScore = -100;
+        int colIndex = row;
+        for (int i = 0; i < lA; i++) { if (lastRow[i] >= maxScore) { colIndex = i; maxScore = lastRow[i]; } }
+
+        upFromRow = lB; leftFromColumn = lA;
+
+        float rowScore = (colIndex < lA) ? lastRow[colIndex] : lastRow[column];
+        float columnScore = (rowIndex < lB) ? lastColumn[rowIndex] : lastColumn[row];
+
+        if (colIndex == column && rowIndex == row) {}   //	if the max values are the lower right corner, then we're good
+        else if (rowScore < columnScore)    { upFromRow = rowIndex + 1;         }
+        else                                { leftFromColumn = colIndex + 1;    }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BandedOverlap", "setOverlap");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+char BandedOverlap::getPrevCell(int row, int column) {
+    if ((column == lA-1) && (row >= upFromRow))         { return 'u'; }
+    if ((row == lB-1) && (column >= leftFromColumn))    { return 'l'; }
+
+    if (row == 0)       { return (column == 0) ? 'x' : 'l'; }
+    if (column == 0)    { return 'u'; }
+
+    int k = column - row - lower;
+    if ((k < 0) || (k >= bandWidth)) { return 'x'; } //outside the band, nothing points here
+
+    return pointers[(long long)row * bandWidth + k];
+}
+/**************************************************************************************************/
@@ -0,0 +1,67 @@
+//
+//  bandedoverlap.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef bandedoverlap_hpp
+#define bandedoverlap_hpp
+
+#include "mothur.h"
+#include "alignment.hpp"
+
+/**************************************************************************************************/
+//BandedOverlap is the Needleman-Wunsch and Gotoh overlap alignments of NeedlemanOverlap and GotohOverlap, filled only
+//for the cells within width diagonals of a given diagonal (column - row, A against B). The cells outside the band
+//can't be reached, everything else, the free end gaps, the pointers, the ties and the overlap fix, is the same as the
+//full alignments. When the full alignment's path stays inside the band both give the same alignment.
+//
+//pre.cluster uses it for pairs that are at most diffs apart, their paths can only move diffs diagonals off the
+//diagonal found from the kmers the pair shares. In repeats that diagonal can be off the path, so pre.cluster aligns a
+//pair the band puts past diffs again with a band as wide as the matrix.
+
+class BandedOverlap : public Alignment {
+
+public:
+    BandedOverlap(float, float, float, float, bool); //gapOpen, gapExtend, match, mismatch, affine
+    virtual ~BandedOverlap() {}
+
+    void setBand(int d, int w) { diagonal = d; width = max(w, 0); } //used by the next align
+    void align(string, string, bool createBaseMap=false);
+    void resize(int A) { nRows = A; nCols = A; } //the band grows to fit each pair
+
+protected:
+    char getPrevCell(int, int);
+
+private:
+    float gapOpen, gapExtend, match, mismatch;
+    bool affine; //false is Needleman-Wunsch, every gap position costs gapOpen
+    int diagonal, width, lower, bandWidth, upFromRow, leftFromColumn;
+
+    vector<char> pointers; //lB rows of bandWidth cells, cell k of row i is column i+lower+k
+    vector<float> lastColumn, lastRow; //scores of column lA-1 and row lB-1 for the overlap fix
+    vector<float> previousScores, currentScores, upGaps, nextUpGaps;
+
+    void fill();
+    void setOverlap();
+};
+/**************************************************************************************************/
+
+class NeedlemanBandedOverlap : public BandedOverlap {
+
+public:
+    NeedlemanBandedOverlap(float gap, float f, float mm) : BandedOverlap(gap, 0, f, mm, false) {}
+    ~NeedlemanBandedOverlap() {}
+};
+/**************************************************************************************************/
+
+class GotohBandedOverlap : public BandedOverlap {
+
+public:
+    GotohBandedOverlap(float gO, float gE, float f, float mm) : BandedOverlap(gO, gE, f, mm, true) {}
+    ~GotohBandedOverlap() {}
+};
+/**************************************************************************************************/
+
+#endif /* bandedoverlap_hpp */
@@ -0,0 +1,346 @@
+//
+//  betadiversityengine.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "betadiversityengine.hpp"
+
+//the second samples of a tile, shares and counts of about this many OTUs stay in cache
+#define TILE_ENTRIES 16384
+
+/***********************************************************************/
+BetaDiversityEngine::BetaDiversityEngine(vector<SharedRAbundVector*>& samples, vector<string> calcNames) {
+    try {
+        m = MothurOut::getInstance();
+        setCalcs(calcNames);
+
+        numSamples = samples.size();
+        numOtus = 0; if (numSamples != 0) { numOtus = samples[0]->getNumBins(); }
+
+        rowStarts.push_back(0);
+        for (int i = 0; i < numSamples; i++) {
+            vector<int> data = samples[i]->get();
+            for (int j = 0; j < data.size(); j++) {
+                if (data[j] != 0) { otus.push_back(j); counts.push_back(data[j]); }
+            }
+            addRow(samples[i]->getNumSeqs());
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BetaDiversityEngine", "BetaDiversityEngine");
+        exit(1);
+    }
+}
+/***********************************************************************/
+BetaDiversityEngine::BetaDiversityEngine(SparseSharedTable& table, vector<string> calcNames) {
+    try {
+        m = MothurOut::getInstance();
+        setCalcs(calcNames);
+
+        numSamples = table.getNumGroups();
+        numOtus = table.getNumOtus();
+
+        //the rows are already the nonzero OTUs, the seqs are the sum of the counts
+        rowStarts.push_back(0);
+        for (int i = 0; i < numSamples; i++) {
+            SparseSharedVector row = table.getRow(i);
+            double seqs = 0;
+            for (int j = 0; j < row.size; j++) {
+                if (row.counts[j] != 0) { otus.push_back(row.indexes[j]); counts.push_back(row.counts[j]); seqs += row.counts[j]; }
+            }
+            addRow(seqs);
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BetaDiversityEngine", "BetaDiversityEngine");
+        exit(1);
+    }
+}
+/***********************************************************************/
+void BetaDiversityEngine::setCalcs(vector<string> calcNames) {
+    try {
+        for (int i = 0; i < calcNames.size(); i++) {
+            if (!isBatched(calcNames[i]) || (find(calcNames[i]) != -1)) { continue; }
+
+            string name = calcNames[i];
+            int calc = JSD;
+            if (name == "sharedsobs")               { calc = SHAREDSOBS;        }
+            else if (name == "sharednseqs")         { calc = SHAREDNSEQS;       }
+            else if (name == "jclass")              { calc = JCLASS;            }
+            else if (name == "sorclass")            { calc = SORCLASS;          }
+            else if (name == "ochiai")              { calc = OCHIAI;            }
+            else if (name == "anderberg")           { calc = ANDERBERG;         }
+            else if (name == "kulczynski")          { calc = KULCZYNSKI;        }
+            else if (name == "kulczynskicody")      { calc = KULCZYNSKICODY;    }
+            else if (name == "lennon")              { calc = LENNON;            }
+            else if (name == "braycurtis")          { calc = BRAYCURTIS;        }
+            else if (name == "manhattan")           { calc = MANHATTAN;         }
+            else if (name == "thetayc")             { calc = THETAYC;           }
+            else if (name == "thetan")              { calc = THETAN;            }
+            else if (name == "morisitahorn")        { calc = MORISITAHORN;      }
+
+            names.push_back(name); calcs.push_back(calc);
+            if (calc == THETAYC) { cols.push_back(3); } else { cols.push_back(1); }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BetaDiversityEngine", "setCalcs");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//the row's OTUs and counts were just added, this ends the row and works out its shares and sums
+void BetaDiversityEngine::addRow(double seqs) {
+    try {
+        long long start = rowStarts.back();
+        rowStarts.push_back(otus.size());
+
+        double total = 0, observed = 0;
+        for (long long e = start; e < otus.size(); e++) { total += counts[e]; observed++; }
+        numSeqs.push_back(seqs); totals.push_back(total); numObserved.push_back(observed);
+
+        //thetayc and jsd divide by the seqs the sample says it has, morisitahorn and thetan by the sum of the counts
+        double sumSquare = 0, sumCube = 0, sumRelSquare = 0;
+        for (long long e = start; e < otus.size(); e++) {
+            double share = counts[e] / seqs;
+            float relShare = counts[e] / total;
+            shares.push_back(share); relShares.push_back(relShare); sharesN.push_back(counts[e] / (double)(float)total);
+
+            sumSquare += share * share;
+            sumCube += share * share * share;
+            sumRelSquare += relShare * relShare;
+        }
+
+        //an empty sample's shares are 0/0, which the calculators carry through to their nan checks
+        if (util.isEqual(seqs, 0)) { sumSquare = NAN; sumCube = NAN; }
+        if (util.isEqual(total, 0)) { sumRelSquare = NAN; }
+        sumSquares.push_back(sumSquare); sumCubes.push_back(sumCube); sumRelSquares.push_back(sumRelSquare);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BetaDiversityEngine", "addRow");
+        exit(1);
+    }
+}
+/***********************************************************************/
+bool BetaDiversityEngine::isBatched(string name) {
+    return ((name == "sharedsobs") || (name == "sharednseqs") || (name == "jclass") || (name == "sorclass") || (name == "ochiai")
+            || (name == "anderberg") || (name == "kulczynski") || (name == "kulczynskicody") || (name == "lennon") || (name == "braycurtis")
+            || (name == "manhattan") || (name == "thetayc") || (name == "thetan") || (name == "morisitahorn") || (name == "jsd"));
+}
+/***********************************************************************/
+int BetaDiversityEngine::find(string name) {
+    for (int i = 0; i < names.size(); i++) { if (names[i] == name) { return i; } }
+    return -1;
+}
+/***********************************************************************/
+void BetaDiversityEngine::print(ostream& f, const double* values, int numCols) {
+    f.setf(ios::fixed, ios::floatfield); f.setf(ios::showpoint);
+    f << values[0]; for (int i = 1; i < numCols; i++) { f << '\t' << values[i]; }
+}
+/***********************************************************************/
+void BetaDiversityEngine::getValues(int start, int end, vector< vector<double> >& values) {
+    try {
+        long long firstPair = (long long)start * (start - 1) / 2;
+        long long numPairs = (long long)end * (end - 1) / 2 - firstPair;
+
+        values.resize(calcs.size());
+        for (int c = 0; c < calcs.size(); c++) { values[c].assign(numPairs * cols[c], 0.0); }
+
+        driver(start, end, &values, firstPair);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BetaDiversityEngine", "getValues");
+        exit(1);
+    }
+}
+/***********************************************************************/
+void BetaDiversityEngine::getValues(int processors, vector< vector<double> >& values) {
+    try {
+        long long numPairs = (long long)numSamples * (numSamples - 1) / 2;
+
+        values.resize(calcs.size());
+        for (int c = 0; c < calcs.size(); c++) { values[c].assign(numPairs * cols[c], 0.0); }
+
+        if (processors > numSamples) { processors = numSamples; }
+        if (processors < 1) { processors = 1; }
+
+        //sample k has k pairs, so the rows are split where the pairs are split evenly
+        vector<linePair> lines;
+        for (int i = 0; i < processors; i++) {
+            lines.push_back(linePair(int(sqrt(float(i)/float(processors)) * numSamples), int(sqrt(float(i+1)/float(processors)) * numSamples)));
+        }
+        lines.back().end = numSamples;
+
+        //Lauch worker threads
+        vector<std::thread*> workerThreads;
+        for (int i = 0; i < processors-1; i++) {
+            workerThreads.push_back(new std::thread(&BetaDiversityEngine::driver, this, (int)lines[i+1].start, (int)lines[i+1].end, &values, 0LL));
+        }
+
+        driver((int)lines[0].start, (int)lines[0].end, &values, 0);
+
+        for (int i = 0; i < processors-1; i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BetaDiversityEngine", "getValues");
+        exit(1);
+    }
+}
+/***********************************************************************/
+void BetaDiversityEngine::driver(int start, int end, vector< vector<double> >* values, long long firstPair) {
+    try {
+        vector<long long> spread(numOtus, -1); //OTU -> entry of sample k
+
+        for (int tileStart = 0; tileStart < end-1;) {
+            int tileEnd = tileStart; long long tileEntries = 0;
+            while ((tileEnd < end-1) && ((tileEnd == tileStart) || (tileEntries + (rowStarts[tileEnd+1] - rowStarts[tileEnd]) <= TILE_ENTRIES))) {
+                tileEntries += rowStarts[tileEnd+1] - rowStarts[tileEnd];
+                tileEnd++;
+            }
+
+            for (int k = max(start, tileStart+1); k < end; k++) {
+                if (m->getControl_pressed()) { return; }
+
+                for (long long e = rowStarts[k]; e < rowStarts[k+1]; e++) { spread[otus[e]] = e; }
+
+                long long pair = (long long)k * (k - 1) / 2 - firstPair;
+                for (int l = tileStart; l < min(tileEnd, k); l++) { getPair(k, l, spread, *values, pair + l); }
+
+                for (long long e = rowStarts[k]; e < rowStarts[k+1]; e++) { spread[otus[e]] = -1; }
+            }
+
+            tileStart = tileEnd;
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BetaDiversityEngine", "driver");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//the formulas are the calculators', with sample k as the first sample
+void BetaDiversityEngine::getPair(int k, int l, vector<long long>& spread, vector< vector<double> >& values, long long pair) {
+    try {
+        double S12 = 0, sumMin = 0, d = 0, sumPQsq = 0, sumPsqQ = 0, relD = 0, sharedA = 0, sharedB = 0;
+
+        for (long long e = rowStarts[l]; e < rowStarts[l+1]; e++) {
+            long long f = spread[otus[e]];
+            if (f == -1) { continue; }
+
+            S12++;
+            if (counts[f] < counts[e]) { sumMin += counts[f]; } else { sumMin += counts[e]; }
+
+            double pi = shares[f], qi = shares[e];
+            d += pi * qi;
+            sumPQsq += pi * qi * qi;
+            sumPsqQ += pi * pi * qi;
+            relD += relShares[f] * relShares[e];
+            sharedA += sharesN[f]; sharedB += sharesN[e];
+        }
+
+        double S1 = numObserved[k], S2 = numObserved[l];
+        double Atotal = numSeqs[k], Btotal = numSeqs[l];
+
+        for (int c = 0; c < calcs.size(); c++) {
+            double* result = &values[c][pair * cols[c]];
+
+            switch (calcs[c]) {
+                case SHAREDSOBS:    result[0] = S12;                                                            break;
+                case SHAREDNSEQS:   result[0] = Atotal + Btotal;                                                break;
+                case JCLASS:        result[0] = 1.0 - S12 / (float)(S1 + S2 - S12);                             break;
+                case SORCLASS:      result[0] = 1.0-(2 * S12) / (float)(S1 + S2);                               break;
+                case OCHIAI:        result[0] = S12 / ((float)pow((S1 * S2), 0.5));                             break;
+                case ANDERBERG:     result[0] = 1.0 - S12 / ((float)((2 * S1) + (2 * S2) - (3 * S12)));         break;
+                case KULCZYNSKI:    result[0] = 1.0 - S12 / (float)(S1 + S2 - (2 * S12));                      break;
+                case KULCZYNSKICODY: result[0] = 1.0 - 0.5 * ((S12 / (float)S1) + (S12 / (float)S2));          break;
+                case LENNON:        result[0] = 1.0 - S12 / (float)(S12 + min(S1 - S12, S2 - S12));            break;
+                case BRAYCURTIS:    result[0] = 1.0 - (2 * sumMin) / (float)(Atotal + Btotal);                  break;
+                case MANHATTAN:     result[0] = (totals[k] + totals[l]) - 2 * sumMin;                           break;
+                case JSD:           result[0] = getJSD(k, l);                                                   break;
+                case THETAN: {
+                    double thetaN = (sharedA * sharedB) / (sharedA + sharedB - (sharedA * sharedB));
+                    if (isnan(thetaN) || isinf(thetaN)) { thetaN = 0; }
+                    result[0] = 1.0 - thetaN;
+                    break;
+                }
+                case MORISITAHORN: {
+                    double morhorn = 1- (2 * relD) / (sumRelSquares[k] + sumRelSquares[l]);
+                    if (isnan(morhorn) || isinf(morhorn)) { morhorn = 1; }
+                    result[0] = morhorn;
+                    break;
+                }
+                case THETAYC: {
+                    double a = sumSquares[k], b = sumSquares[l], sumPcubed = sumCubes[k], sumQcubed = sumCubes[l];
+
+                    double thetaYC = d / (a + b - d);
+                    if (isnan(thetaYC) || isinf(thetaYC)) { thetaYC = 0; }
+
+                    double varA = 4 / Atotal * (sumPcubed - a * a);
+                    double varB = 4 / Btotal * (sumQcubed - b * b);
+                    double varD = sumPQsq / Atotal + sumPsqQ / Btotal - d * d * (1/Atotal + 1/Btotal);
+                    double covAD = 2 / Atotal * (sumPsqQ - a * d);
+                    double covBD = 2 / Btotal * (sumPQsq - b* d);
+
+                    double varT = d * d * (varA + varB) / pow(a + b - d, (double)4.0) + pow(a+b, (double)2.0) * varD / pow(a+b-d, (double)4.0)
+                                    - 2.0 * (a + b) * d / pow(a + b - d, (double)4.0) * (covAD + covBD);
+
+                    double ci = 1.95 * sqrt(varT);
+
+                    result[0] = thetaYC;
+                    result[1] = thetaYC - ci;
+                    result[2] = thetaYC + ci;
+                    if (isnan(result[1]) || isinf(result[1])) { result[1] = 0; }
+                    if (isnan(result[2]) || isinf(result[2])) { result[2] = 0; }
+
+                    result[0] = 1.0 - result[0];
+                    double hold = result[1];
+                    result[1] = 1.0 - result[2];
+                    result[2] = 1.0 - hold;
+                    break;
+                }
+            }
+
+            if ((calcs[c] != THETAYC) && (calcs[c] != MORISITAHORN)) {
+                if (isnan(result[0]) || isinf(result[0])) { result[0] = 0; }
+            }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BetaDiversityEngine", "getPair");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//the union of the two samples' OTUs, the OTUs neither has add 0
+double BetaDiversityEngine::getJSD(int k, int l) {
+    try {
+        if (util.isEqual(numSeqs[k], 0) || util.isEqual(numSeqs[l], 0)) { return 0; } //0/0 shares
+
+        double KLD1 = 0.0;
+        double KLD2 = 0.0;
+
+        long long i = rowStarts[k], j = rowStarts[l];
+        while ((i < rowStarts[k+1]) || (j < rowStarts[l+1])) {
+            double tempA = 0.000001;
+            double tempB = 0.000001;
+
+            if ((j == rowStarts[l+1]) || ((i < rowStarts[k+1]) && (otus[i] < otus[j])))     { tempA = shares[i]; i++; }
+            else if ((i == rowStarts[k+1]) || (otus[j] < otus[i]))                          { tempB = shares[j]; j++; }
+            else                                                                            { tempA = shares[i]; tempB = shares[j]; i++; j++; }
+
+            double denom = (tempA+tempB)/(double)2.0;
+
+            KLD1 += tempA * log(tempA/denom); //KLD(x,m)
+            KLD2 += tempB * log(tempB/denom); //KLD(y,m)
+        }
+
+        return ((0.5*KLD1) + (0.5*KLD2));
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BetaDiversityEngine", "getJSD");
+        exit(1);
+    }
+}
+/***********************************************************************/
@@ -0,0 +1,70 @@
+//
+//  betadiversityengine.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef betadiversityengine_hpp
+#define betadiversityengine_hpp
+
+#include "calculator.h"
+#include "sharedrabundvector.hpp"
+#include "sparsesharedtable.hpp"
+
+/***********************************************************************/
+//BetaDiversityEngine computes the pairwise calculators dist.shared and summary.shared use for every pair of samples at
+//once. The samples are copied once into sparse rows, the nonzero OTUs and their counts, with each OTU's share of the
+//sample's seqs and the sample's totals and sums of shares worked out ahead. A SparseSharedTable's rows already are
+//that, so they are copied as they are. A pair is then only its shared OTUs: the first sample is spread into a table by
+//OTU and the second one's OTUs are looked up in it. The second samples are taken a tile at a time, as many as fit in
+//cache, and every first sample is run against the tile before moving on.
+//
+//The sums are added in OTU order, like the calculators add them, so the values are the calculators' to the last bit.
+
+class BetaDiversityEngine {
+
+public:
+    BetaDiversityEngine(vector<SharedRAbundVector*>&, vector<string>); //samples, calculator names. Names the engine doesn't compute are left out
+    BetaDiversityEngine(SparseSharedTable&, vector<string>);            //table, calculator names. The rows are copied as they are, without a dense sample
+    ~BetaDiversityEngine() {}
+
+    static bool isBatched(string);      //calculator name
+    int find(string);                   //position of the calculator in the values, -1 if the engine doesn't compute it
+    int getCols(int c)                  { return cols[c];   }
+
+    //the pairs k, l < k in the order dist.shared and summary.shared list them. values[c] holds the getCols(c) values of
+    //calculator c for each pair
+    void getValues(int, int, vector< vector<double> >&);    //first sample start, end, values. Only the pairs with start <= k < end
+    void getValues(int, vector< vector<double> >&);         //processors, values. All the pairs
+
+    static void print(ostream&, const double*, int);        //values, cols. Prints them like Calculator::print
+
+private:
+    enum { SHAREDSOBS, SHAREDNSEQS, JCLASS, SORCLASS, OCHIAI, ANDERBERG, KULCZYNSKI, KULCZYNSKICODY, LENNON, BRAYCURTIS, MANHATTAN, THETAYC, THETAN, MORISITAHORN, JSD };
+
+    MothurOut* m;
+    Utils util;
+    vector<string> names;
+    vector<int> calcs, cols;
+    int numSamples, numOtus;
+
+    //the rows, sample i's nonzero OTUs are rowStarts[i] to rowStarts[i+1]
+    vector<long long> rowStarts;
+    vector<int> otus, counts;
+    vector<double> shares;      //count / sample seqs
+    vector<double> sharesN;     //count / (float) sample seqs, for thetan
+    vector<float> relShares;    //shares as floats, for morisitahorn
+
+    vector<double> numSeqs, totals, numObserved; //seqs the sample says it has, sum of the counts, nonzero OTUs
+    vector<double> sumSquares, sumCubes, sumRelSquares; //of shares, of relShares
+
+    void setCalcs(vector<string>);
+    void addRow(double);        //sample seqs. Ends the row of the OTUs and counts added since the last one
+    void getPair(int, int, vector<long long>&, vector< vector<double> >&, long long); //samples k, l, k spread by OTU, values, pair
+    double getJSD(int, int);
+    void driver(int, int, vector< vector<double> >*, long long); //start, end, values, first pair
+};
+/***********************************************************************/
+
+#endif /* betadiversityengine_hpp */
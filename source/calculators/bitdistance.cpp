@@ -0,0 +1,480 @@
+//
+//  bitdistance.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "bitdistance.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    #define USE_X86_KERNELS
+    #include <immintrin.h>
+#endif
+
+/**************************************************************************************************/
+//symbols that can be encoded in the 4 code planes. Gaps are kept in their own planes.
+static const string encodedSymbols = "ACGTURYSWKMBDHVN";
+
+static const uint64_t allColumns = ~((uint64_t)0);
+
+/**************************************************************************************************/
+EncodedSeq::EncodedSeq(const string& aligned) : planes(NULL), aligned(NULL), alignLength(0), numBlocks(0), firstNonDot(-1), lastNonDot(-1), firstBase(-1), lastBase(-1), encoded(false) {
+    encode(aligned);
+}
+/**************************************************************************************************/
+EncodedSeq::EncodedSeq(const EncodedSeq& e) : data(e.data), alignedData(e.alignedData), alignLength(e.alignLength), numBlocks(e.numBlocks), firstNonDot(e.firstNonDot), lastNonDot(e.lastNonDot), firstBase(e.firstBase), lastBase(e.lastBase), encoded(e.encoded) {
+    setPointers(e);
+}
+/**************************************************************************************************/
+EncodedSeq& EncodedSeq::operator=(const EncodedSeq& e) {
+    if (this != &e) {
+        data = e.data; alignedData = e.alignedData;
+        alignLength = e.alignLength; numBlocks = e.numBlocks;
+        firstNonDot = e.firstNonDot; lastNonDot = e.lastNonDot; firstBase = e.firstBase; lastBase = e.lastBase;
+        encoded = e.encoded;
+        setPointers(e);
+    }
+    return *this;
+}
+/**************************************************************************************************/
+//owned storage is copied, so point at our copy. Views keep pointing at the packed rows
+void EncodedSeq::setPointers(const EncodedSeq& e) {
+    if (e.planes == e.data.data())          { planes = data.data();         }
+    else                                    { planes = e.planes;            }
+
+    if (e.aligned == e.alignedData.c_str()) { aligned = alignedData.c_str(); }
+    else                                    { aligned = e.aligned;          }
+}
+/**************************************************************************************************/
+static vector<int> buildSymbolCodes() {
+    vector<int> codes(256, -1);
+    for (int i = 0; i < encodedSymbols.length(); i++) { codes[(unsigned char)encodedSymbols[i]] = i; }
+    return codes;
+}
+/**************************************************************************************************/
+void EncodedSeq::encode(const string& seq) {
+    alignedData = seq;
+    data.assign(getNumPlaneWords(seq.length()), 0);
+
+    encode(alignedData.c_str(), alignedData.length(), data.data());
+}
+/**************************************************************************************************/
+void EncodedSeq::encode(const char* seq, int length, uint64_t* words) {
+    try {
+        static const vector<int> symbolCodes = buildSymbolCodes();
+
+        aligned = seq;
+        planes = words;
+        alignLength = length;
+        numBlocks = getNumBlocks(length);
+        firstNonDot = -1; lastNonDot = -1; firstBase = -1; lastBase = -1;
+        encoded = true;
+
+        for (int i = 0; i < alignLength; i++) {
+            int block = i / 64;
+            uint64_t bit = ((uint64_t)1) << (i % 64);
+
+            if (seq[i] == '-')      { words[DASH*numBlocks+block] |= bit; }
+            else if (seq[i] == '.') { words[DOT*numBlocks+block] |= bit;  }
+            else {
+                int code = symbolCodes[(unsigned char)seq[i]];
+
+                if (code == -1) { encoded = false; break; } //unknown character, use character comparisons
+
+                for (int p = 0; p < 4; p++) { if ((code >> p) & 1) { words[(CODE0+p)*numBlocks+block] |= bit; } }
+
+                if (firstBase == -1) { firstBase = i; }
+                lastBase = i;
+            }
+
+            if (seq[i] != '.') {
+                if (firstNonDot == -1) { firstNonDot = i; }
+                lastNonDot = i;
+            }
+        }
+    }
+    catch(exception& e) {
+        MothurOut::getInstance()->errorOut(e, "EncodedSeq", "encode");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+static inline int popCount(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+/**************************************************************************************************/
+static inline int firstBit(uint64_t x) { //x != 0
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    int i = 0; while (((x >> i) & 1) == 0) { i++; } return i;
+#endif
+}
+/**************************************************************************************************/
+static inline int lastBit(uint64_t x) { //x != 0
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(x);
+#else
+    int i = 63; while (((x >> i) & 1) == 0) { i--; } return i;
+#endif
+}
+/**************************************************************************************************/
+//mask of the columns [lo, hi) that fall in block b
+static inline uint64_t rangeMask(int b, int lo, int hi) {
+    int blockStart = b * 64;
+    uint64_t mask = allColumns;
+    if (lo > blockStart)        { mask &= (allColumns << (lo - blockStart));          }
+    if (hi < blockStart + 64)   { mask &= (allColumns >> (blockStart + 64 - hi));     }
+    return mask;
+}
+/**************************************************************************************************/
+enum ColumnTest { BOTHDOT, ANYDOT, BOTHNONDOT, BOTHBASE };
+
+static inline uint64_t columnTest(ColumnTest test, const EncodedSeq& A, const EncodedSeq& B, int b) {
+    uint64_t dotA = A.getPlane(EncodedSeq::DOT)[b];     uint64_t dotB = B.getPlane(EncodedSeq::DOT)[b];
+
+    if (test == BOTHDOT)            { return (dotA & dotB);     }
+    else if (test == ANYDOT)        { return (dotA | dotB);     }
+    else if (test == BOTHNONDOT)    { return ~(dotA | dotB);    }
+
+    uint64_t dashA = A.getPlane(EncodedSeq::DASH)[b];   uint64_t dashB = B.getPlane(EncodedSeq::DASH)[b];
+    return ~(dotA | dotB | dashA | dashB);
+}
+/**************************************************************************************************/
+//first column >= from that passes the test, returns alignLength if none
+static int findFirst(ColumnTest test, const EncodedSeq& A, const EncodedSeq& B, int from) {
+    int alignLength = A.getAlignLength();
+    if ((from < 0) || (from >= alignLength)) { return alignLength; }
+
+    for (int b = from / 64; b < A.getNumBlocks(); b++) {
+        uint64_t bits = columnTest(test, A, B, b) & rangeMask(b, from, alignLength);
+        if (bits != 0) { return b * 64 + firstBit(bits); }
+    }
+    return alignLength;
+}
+/**************************************************************************************************/
+//last column <= from that passes the test, returns -1 if none
+static int findLast(ColumnTest test, const EncodedSeq& A, const EncodedSeq& B, int from) {
+    if (from >= A.getAlignLength()) { from = A.getAlignLength() - 1; }
+    if (from < 0) { return -1; }
+
+    for (int b = from / 64; b >= 0; b--) {
+        uint64_t bits = columnTest(test, A, B, b) & rangeMask(b, 0, from+1);
+        if (bits != 0) { return b * 64 + lastBit(bits); }
+    }
+    return -1;
+}
+/**************************************************************************************************/
+//running totals for a pair. seed and carry hold the open gap state of the onegap models between blocks
+struct BlockCounts {
+    long long diff, skip;
+    uint64_t seedA, seedB, carryA, carryB;
+
+    BlockCounts() : diff(0), skip(0), seedA(0), seedB(0), carryA(0), carryB(0) {}
+};
+/**************************************************************************************************/
+//marks the columns whose previous non skipped column is set in gaps. The seeds are moved one column
+//to the right and carried through runs of skipped columns by adding them to the skip mask.
+static inline uint64_t openGaps(uint64_t gaps, uint64_t skip, uint64_t& seed, uint64_t& carry) {
+    uint64_t x = (gaps << 1) | seed;
+    uint64_t partial = skip + x;
+    uint64_t sum = partial + carry;
+
+    uint64_t open = x | (sum ^ skip ^ x);
+
+    carry = ((partial < skip) || (sum < partial)) ? 1 : 0;
+    seed = gaps >> 63;
+
+    return open;
+}
+/**************************************************************************************************/
+template<int MODEL>
+static inline void countBlock(const EncodedSeq& A, const EncodedSeq& B, int b, uint64_t inRange, BlockCounts& counts) {
+    uint64_t dashA = A.getPlane(EncodedSeq::DASH)[b];   uint64_t dashB = B.getPlane(EncodedSeq::DASH)[b];
+    uint64_t dotA = A.getPlane(EncodedSeq::DOT)[b];     uint64_t dotB = B.getPlane(EncodedSeq::DOT)[b];
+
+    uint64_t codeDiff = (A.getPlane(EncodedSeq::CODE0)[b] ^ B.getPlane(EncodedSeq::CODE0)[b]) | (A.getPlane(EncodedSeq::CODE1)[b] ^ B.getPlane(EncodedSeq::CODE1)[b])
+                      | (A.getPlane(EncodedSeq::CODE2)[b] ^ B.getPlane(EncodedSeq::CODE2)[b]) | (A.getPlane(EncodedSeq::CODE3)[b] ^ B.getPlane(EncodedSeq::CODE3)[b]);
+
+    if (MODEL == BitDistance::NOGAPS) { //no '.' in range
+        uint64_t skip = (dashA | dashB) & inRange;
+        counts.skip += popCount(skip);
+        counts.diff += popCount(codeDiff & ~skip & inRange);
+    }else if (MODEL == BitDistance::EACHGAP) {
+        uint64_t gapA = dashA | dotA; uint64_t gapB = dashB | dotB;
+        uint64_t skip = gapA & gapB & inRange;
+        counts.skip += popCount(skip);
+        counts.diff += popCount(((gapA ^ gapB) | codeDiff) & ~skip & inRange);
+    }else if (MODEL == BitDistance::EACHGAPIGNORE) { //no '.' in range
+        uint64_t skip = dashA & dashB & inRange;
+        counts.skip += popCount(skip);
+        counts.diff += popCount(((dashA ^ dashB) | codeDiff) & ~skip & inRange);
+    }else {
+        uint64_t gapA = dashA; uint64_t gapB = dashB;
+
+        if (MODEL == BitDistance::ONEGAP)   {   gapA |= dotA; gapB |= dotB; }
+        else                                {   codeDiff |= (dotA ^ dotB);  } //ignoring terminal gaps, '.' is compared like a base
+
+        uint64_t skip = gapA & gapB & inRange;
+        uint64_t onlyA = gapA & ~gapB & inRange;
+        uint64_t onlyB = gapB & ~gapA & inRange;
+        uint64_t mismatch = codeDiff & ~(gapA | gapB) & inRange;
+
+        uint64_t continuedA = onlyA & openGaps(onlyA, skip, counts.seedA, counts.carryA);
+        uint64_t continuedB = onlyB & openGaps(onlyB, skip, counts.seedB, counts.carryB);
+
+        counts.skip += popCount(skip) + popCount(continuedA) + popCount(continuedB);
+        counts.diff += popCount(mismatch) + popCount(onlyA & ~continuedA) + popCount(onlyB & ~continuedB);
+    }
+}
+/**************************************************************************************************/
+typedef void (*BlockKernel)(const EncodedSeq&, const EncodedSeq&, int, int, BlockCounts&);
+
+template<int MODEL>
+static void countBlocksScalar(const EncodedSeq& A, const EncodedSeq& B, int b, int e, BlockCounts& counts) {
+    for (; b < e; b++) { countBlock<MODEL>(A, B, b, allColumns, counts); }
+}
+/**************************************************************************************************/
+#ifdef USE_X86_KERNELS
+
+template<int MODEL>
+__attribute__((target("popcnt")))
+static void countBlocksPopcnt(const EncodedSeq& A, const EncodedSeq& B, int b, int e, BlockCounts& counts) {
+    for (; b < e; b++) { countBlock<MODEL>(A, B, b, allColumns, counts); }
+}
+/**************************************************************************************************/
+__attribute__((target("avx2")))
+static inline __m256i popCount256(__m256i v) { //per 64 bit lane counts
+    const __m256i lookup = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4, 0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+    const __m256i lowMask = _mm256_set1_epi8(0x0f);
+
+    __m256i lo = _mm256_and_si256(v, lowMask);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowMask);
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+
+    return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+/**************************************************************************************************/
+__attribute__((target("avx2")))
+static inline __m256i load256(const uint64_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+
+__attribute__((target("avx2")))
+static inline long long sum256(__m256i v) {
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, v);
+    return (long long)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+}
+/**************************************************************************************************/
+//4 blocks per step. The onegap models carry state from block to block so they use the popcnt kernel.
+template<int MODEL>
+__attribute__((target("avx2,popcnt")))
+static void countBlocksAVX2(const EncodedSeq& A, const EncodedSeq& B, int b, int e, BlockCounts& counts) {
+    if ((MODEL == BitDistance::ONEGAP) || (MODEL == BitDistance::ONEGAPIGNORE)) {
+        for (; b < e; b++) { countBlock<MODEL>(A, B, b, allColumns, counts); }
+        return;
+    }
+
+    const uint64_t* dashA = A.getPlane(EncodedSeq::DASH);   const uint64_t* dashB = B.getPlane(EncodedSeq::DASH);
+    const uint64_t* dotA = A.getPlane(EncodedSeq::DOT);     const uint64_t* dotB = B.getPlane(EncodedSeq::DOT);
+    const uint64_t* c0A = A.getPlane(EncodedSeq::CODE0);    const uint64_t* c0B = B.getPlane(EncodedSeq::CODE0);
+    const uint64_t* c1A = A.getPlane(EncodedSeq::CODE1);    const uint64_t* c1B = B.getPlane(EncodedSeq::CODE1);
+    const uint64_t* c2A = A.getPlane(EncodedSeq::CODE2);    const uint64_t* c2B = B.getPlane(EncodedSeq::CODE2);
+    const uint64_t* c3A = A.getPlane(EncodedSeq::CODE3);    const uint64_t* c3B = B.getPlane(EncodedSeq::CODE3);
+
+    __m256i skipTotal = _mm256_setzero_si256();
+    __m256i diffTotal = _mm256_setzero_si256();
+
+    for (; b + 4 <= e; b += 4) {
+        __m256i codeDiff = _mm256_or_si256(_mm256_or_si256(_mm256_xor_si256(load256(c0A+b), load256(c0B+b)), _mm256_xor_si256(load256(c1A+b), load256(c1B+b))),
+                                           _mm256_or_si256(_mm256_xor_si256(load256(c2A+b), load256(c2B+b)), _mm256_xor_si256(load256(c3A+b), load256(c3B+b))));
+        __m256i gapA = load256(dashA+b); __m256i gapB = load256(dashB+b);
+        __m256i skip, diff;
+
+        if (MODEL == BitDistance::NOGAPS) {
+            skip = _mm256_or_si256(gapA, gapB);
+            diff = _mm256_andnot_si256(skip, codeDiff);
+        }else {
+            if (MODEL == BitDistance::EACHGAP) { gapA = _mm256_or_si256(gapA, load256(dotA+b)); gapB = _mm256_or_si256(gapB, load256(dotB+b)); }
+
+            skip = _mm256_and_si256(gapA, gapB);
+            diff = _mm256_andnot_si256(skip, _mm256_or_si256(_mm256_xor_si256(gapA, gapB), codeDiff));
+        }
+
+        skipTotal = _mm256_add_epi64(skipTotal, popCount256(skip));
+        diffTotal = _mm256_add_epi64(diffTotal, popCount256(diff));
+    }
+
+    counts.skip += sum256(skipTotal);
+    counts.diff += sum256(diffTotal);
+
+    for (; b < e; b++) { countBlock<MODEL>(A, B, b, allColumns, counts); }
+}
+
+#endif
+/**************************************************************************************************/
+struct KernelTable {
+    BlockKernel kernels[5];
+    string name;
+
+    KernelTable() {
+        kernels[BitDistance::NOGAPS] = countBlocksScalar<BitDistance::NOGAPS>;
+        kernels[BitDistance::EACHGAP] = countBlocksScalar<BitDistance::EACHGAP>;
+        kernels[BitDistance::ONEGAP] = countBlocksScalar<BitDistance::ONEGAP>;
+        kernels[BitDistance::EACHGAPIGNORE] = countBlocksScalar<BitDistance::EACHGAPIGNORE>;
+        kernels[BitDistance::ONEGAPIGNORE] = countBlocksScalar<BitDistance::ONEGAPIGNORE>;
+        name = "scalar";
+
+#ifdef USE_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+            kernels[BitDistance::NOGAPS] = countBlocksAVX2<BitDistance::NOGAPS>;
+            kernels[BitDistance::EACHGAP] = countBlocksAVX2<BitDistance::EACHGAP>;
+            kernels[BitDistance::ONEGAP] = countBlocksAVX2<BitDistance::ONEGAP>;
+            kernels[BitDistance::EACHGAPIGNORE] = countBlocksAVX2<BitDistance::EACHGAPIGNORE>;
+            kernels[BitDistance::ONEGAPIGNORE] = countBlocksAVX2<BitDistance::ONEGAPIGNORE>;
+            name = "avx2";
+        }else if (__builtin_cpu_supports("popcnt")) {
+            kernels[BitDistance::NOGAPS] = countBlocksPopcnt<BitDistance::NOGAPS>;
+            kernels[BitDistance::EACHGAP] = countBlocksPopcnt<BitDistance::EACHGAP>;
+            kernels[BitDistance::ONEGAP] = countBlocksPopcnt<BitDistance::ONEGAP>;
+            kernels[BitDistance::EACHGAPIGNORE] = countBlocksPopcnt<BitDistance::EACHGAPIGNORE>;
+            kernels[BitDistance::ONEGAPIGNORE] = countBlocksPopcnt<BitDistance::ONEGAPIGNORE>;
+            name = "popcnt";
+        }
+#endif
+    }
+};
+
+static const KernelTable& getKernels() {
+    static KernelTable table; //initialized once, thread safe
+    return table;
+}
+/**************************************************************************************************/
+string BitDistance::getKernelName() { return getKernels().name; }
+/**************************************************************************************************/
+//eachgap ignoring terminal gaps keeps counting gaps past the last shared base, so the comparison length can
+//reach 0 or go negative before the terminal gaps are found. The running distance is not monotone in that case,
+//so the columns are replayed one at a time like eachGapIgnoreTermGapDist::calcDist does.
+static double replayEachGapIgnore(const EncodedSeq& A, const EncodedSeq& B, int start, int stop, long long maxMinLength, double cutoff) {
+    long long diff = 0;
+    double dist = 0;
+
+    for (int i = start; i < stop; i++) {
+        int b = i / 64; uint64_t bit = ((uint64_t)1) << (i % 64);
+
+        bool dashA = (A.getPlane(EncodedSeq::DASH)[b] & bit) != 0; bool dashB = (B.getPlane(EncodedSeq::DASH)[b] & bit) != 0;
+
+        if (dashA && dashB) { maxMinLength--; }
+        else {
+            bool same = (dashA == dashB);
+            for (int p = EncodedSeq::CODE0; p <= EncodedSeq::CODE3; p++) {
+                if ((A.getPlane(p)[b] & bit) != (B.getPlane(p)[b] & bit)) { same = false; }
+            }
+            if (!same) { diff++; }
+        }
+
+        dist = (double)diff / maxMinLength;
+
+        if (dist > cutoff) { return 1.0000; }
+    }
+
+    if (maxMinLength == 0)  { dist = 1.0000;                                  }
+    else                    { dist = ((double)diff  / (double)maxMinLength);  }
+
+    return dist;
+}
+/**************************************************************************************************/
+template<int MODEL>
+static double calcModelDist(const EncodedSeq& A, const EncodedSeq& B, double cutoff) {
+    int alignLength = A.getAlignLength();
+    int start = 0; int end = 0; int stop = 0;
+
+    if ((MODEL == BitDistance::EACHGAP) || (MODEL == BitDistance::ONEGAP)) { //setStart and setEnd
+        if (A.getFirstNonDot() != -1 || B.getFirstNonDot() != -1) {
+            if (A.getFirstNonDot() == -1)        { start = B.getFirstNonDot(); }
+            else if (B.getFirstNonDot() == -1)   { start = A.getFirstNonDot(); }
+            else { start = min(A.getFirstNonDot(), B.getFirstNonDot()); }
+            end = max(A.getLastNonDot(), B.getLastNonDot());
+        }
+        stop = findFirst(BOTHDOT, A, B, start);
+    }else if (MODEL == BitDistance::NOGAPS) {
+        if ((A.getFirstNonDot() == -1) || (B.getFirstNonDot() == -1)) { return 1.0000; } //non-overlapping sequences
+
+        start = findFirst(BOTHNONDOT, A, B, max(A.getFirstNonDot(), B.getFirstNonDot()));
+        if (start == alignLength) { return 1.0000; }
+
+        end = findLast(BOTHNONDOT, A, B, min(A.getLastNonDot(), B.getLastNonDot()));
+        stop = findFirst(ANYDOT, A, B, start);
+    }else { //setStartIgnoreTermGap and setEndIgnoreTermGap
+        if ((A.getFirstBase() == -1) || (B.getFirstBase() == -1)) { return 1.0000; }
+
+        start = findFirst(BOTHBASE, A, B, max(A.getFirstBase(), B.getFirstBase()));
+        if (start == alignLength) { return 1.0000; }
+
+        end = findLast(BOTHBASE, A, B, min(A.getLastBase(), B.getLastBase()));
+
+        if (MODEL == BitDistance::EACHGAPIGNORE)    { stop = findFirst(ANYDOT, A, B, start);    }
+        else                                        { stop = end + 1;                           }
+    }
+
+    long long maxMinLength = end - start + 1;
+    if (MODEL == BitDistance::ONEGAPIGNORE) { maxMinLength = end - start; }
+
+    //the running distance only grows as columns are added, so the cutoff can be checked every few blocks
+    //instead of every column without changing which pairs are above the cutoff
+    const int blocksPerCheck = 8;
+    BlockKernel kernel = getKernels().kernels[MODEL];
+    BlockCounts counts;
+
+    if (stop > start) {
+        int firstBlock = start / 64; int lastBlock = (stop - 1) / 64;
+
+        countBlock<MODEL>(A, B, firstBlock, rangeMask(firstBlock, start, stop), counts);
+
+        for (int b = firstBlock + 1; b < lastBlock; b += blocksPerCheck) {
+            kernel(A, B, b, min(b + blocksPerCheck, lastBlock), counts);
+
+            long long length = maxMinLength - counts.skip;
+            if ((length > 0) && (((double)counts.diff / (double)length) > cutoff)) { return 1.0000; }
+        }
+
+        if (lastBlock != firstBlock) { countBlock<MODEL>(A, B, lastBlock, rangeMask(lastBlock, start, stop), counts); }
+    }
+
+    long long length = maxMinLength - counts.skip;
+
+    if ((MODEL == BitDistance::EACHGAPIGNORE) && (length <= 0)) { return replayEachGapIgnore(A, B, start, stop, maxMinLength, cutoff); }
+
+    if (length == 0) { return 1.0000; }
+
+    double dist = (double)counts.diff / (double)length;
+
+    if (dist > cutoff) { return 1.0000; }
+
+    return dist;
+}
+/**************************************************************************************************/
+double BitDistance::calcDist(Model model, const EncodedSeq& A, const EncodedSeq& B, double cutoff) {
+    try {
+        if      (model == NOGAPS)           { return calcModelDist<NOGAPS>(A, B, cutoff);           }
+        else if (model == EACHGAP)          { return calcModelDist<EACHGAP>(A, B, cutoff);          }
+        else if (model == ONEGAP)           { return calcModelDist<ONEGAP>(A, B, cutoff);           }
+        else if (model == EACHGAPIGNORE)    { return calcModelDist<EACHGAPIGNORE>(A, B, cutoff);    }
+        else if (model == ONEGAPIGNORE)     { return calcModelDist<ONEGAPIGNORE>(A, B, cutoff);     }
+
+        return 1.0000;
+    }
+    catch(exception& e) {
+        MothurOut::getInstance()->errorOut(e, "BitDistance", "calcDist");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,83 @@
+//
+//  bitdistance.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef bitdistance_hpp
+#define bitdistance_hpp
+
+#include "mothurout.h"
+#include <cstdint>
+
+/**************************************************************************************************/
+//EncodedSeq stores an aligned sequence as bit planes. Each block of 64 alignment columns has a plane for
+//the '-' gaps, a plane for the '.' terminal gaps and 4 planes holding a 4-bit symbol code for the bases.
+//The planes are stored plane-major, so plane p of block b is at planes[p*numBlocks+b].
+//Sequences containing characters outside of the 16 symbol alphabet are not encoded, isEncoded() returns false
+//and the distance calculators fall back to the character by character calculation using getAligned().
+//An EncodedSeq either owns its planes and characters, or is a view of a row in a PackedSequenceDB.
+
+class EncodedSeq {
+
+public:
+
+    EncodedSeq() : planes(NULL), aligned(NULL), alignLength(0), numBlocks(0), firstNonDot(-1), lastNonDot(-1), firstBase(-1), lastBase(-1), encoded(false) {}
+    explicit EncodedSeq(const string&);
+    EncodedSeq(const EncodedSeq&);
+    EncodedSeq& operator=(const EncodedSeq&);
+    ~EncodedSeq() {}
+
+    void encode(const string&);
+    //encodes length characters into planes, which must hold getNumPlaneWords(length) zeroed words. The object
+    //becomes a view of aligned and planes, so both must outlive it.
+    void encode(const char* aligned, int length, uint64_t* planes);
+
+    static int getNumBlocks(int length)     { return (length + 63) / 64;                }
+    static int getNumPlaneWords(int length) { return NUMPLANES * getNumBlocks(length);   }
+
+    bool isEncoded() const          { return encoded;       }
+    int getAlignLength() const      { return alignLength;   }
+    int getNumBlocks() const        { return numBlocks;     }
+    int getFirstNonDot() const      { return firstNonDot;   } //first column that is not a '.', -1 if none
+    int getLastNonDot() const       { return lastNonDot;    }
+    int getFirstBase() const        { return firstBase;     } //first column that is not a '.' or '-', -1 if none
+    int getLastBase() const         { return lastBase;      }
+    const char* getAligned() const  { return aligned;       } //alignLength characters, not null terminated for views
+
+    const uint64_t* getPlane(int p) const { return &planes[p*numBlocks]; }
+
+    enum { DASH = 0, DOT = 1, CODE0 = 2, CODE1 = 3, CODE2 = 4, CODE3 = 5, NUMPLANES = 6 };
+
+private:
+
+    vector<uint64_t> data; //owned planes, empty for views
+    string alignedData;     //owned characters, empty for views
+    const uint64_t* planes;
+    const char* aligned;
+    int alignLength, numBlocks, firstNonDot, lastNonDot, firstBase, lastBase;
+    bool encoded;
+
+    void setPointers(const EncodedSeq&);
+
+};
+/**************************************************************************************************/
+//BitDistance computes the dist.seqs gap models on EncodedSeqs. Each 64 column block is reduced to a skip mask
+//(columns that shorten the comparison length) and a mismatch mask which are counted with popcounts.
+//The AVX2 or POPCNT kernels are selected at runtime if the cpu supports them, otherwise the scalar kernel is used.
+//Results are identical to the calcDist(Sequence, Sequence) functions of the matching calculators.
+
+class BitDistance {
+
+public:
+
+    enum Model { NOGAPS, EACHGAP, ONEGAP, EACHGAPIGNORE, ONEGAPIGNORE, NONE };
+
+    static double calcDist(Model, const EncodedSeq&, const EncodedSeq&, double cutoff);
+    static string getKernelName();
+
+};
+/**************************************************************************************************/
+
+#endif /* bitdistance_hpp */
@@ -9,10 +9,25 @@
 #include "calculator.h"
 
 /***********************************************************************/
-int DistCalc::setStart(string seqA, string seqB) {
+//calculators without a row version compare copies of the rows
+double DistCalc::calcDist(const char* seqA, const char* seqB, int alignLength) {
+    try {
+        Sequence A("seqA", string(seqA, alignLength));
+        Sequence B("seqB", string(seqB, alignLength));
+        
+        dist = calcDist(A, B);
+        
+        return dist;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "DistCalc", "calcDist");
+        exit(1);
+    }
+}
+/***********************************************************************/
+int DistCalc::setStart(const char* seqA, const char* seqB, int alignLength) {
     try {
         int start = 0;
-        int alignLength = seqA.length();
         
         for(int i=0;i<alignLength;i++){
             if((seqA[i] != '.' || seqB[i] != '.')){ //one of you is not a terminal gap
@@ -29,10 +44,9 @@ int DistCalc::setStart(string seqA, string seqB) {
     }
 }
 /***********************************************************************/
-int DistCalc::setEnd(string seqA, string seqB) {
+int DistCalc::setEnd(const char* seqA, const char* seqB, int alignLength) {
     try {
         int end = 0;
-        int alignLength = seqA.length();
         
         for(int i=alignLength-1;i>=0;i--){
             if((seqA[i] != '.' || seqB[i] != '.')){ //one of you is not a terminal gap
@@ -49,11 +63,10 @@ int DistCalc::setEnd(string seqA, string seqB) {
 }
 /***********************************************************************/
 // this assumes that sequences start and end with '.'s instead of'-'s.
-int DistCalc::setStartIgnoreTermGap(string seqA, string seqB, bool& overlap) {
+int DistCalc::setStartIgnoreTermGap(const char* seqA, const char* seqB, int alignLength, bool& overlap) {
     try {
         
         int start = 0;
-        int alignLength = seqA.length();
         
         for(int i=0;i<alignLength;i++){
             if(seqA[i] != '.' && seqB[i] != '.' && seqA[i] != '-' && seqB[i] != '-' ){ //skip leading gaps
@@ -73,11 +86,10 @@ int DistCalc::setStartIgnoreTermGap(string seqA, string seqB, bool& overlap) {
 }
 /***********************************************************************/
 // this assumes that sequences start and end with '.'s instead of'-'s.
-int DistCalc::setEndIgnoreTermGap(string seqA, string seqB, bool& overlap) {
+int DistCalc::setEndIgnoreTermGap(const char* seqA, const char* seqB, int alignLength, bool& overlap) {
     try {
         
         int end = 0;
-        int alignLength = seqA.length();
         
         for(int i=alignLength-1;i>=0;i--){
             if(seqA[i] != '.' && seqB[i] != '.' && seqA[i] != '-' && seqB[i] != '-' ){ //ignore terminal gaps
@@ -7,6 +7,7 @@
 #include "sequence.hpp"
 #include "mothurout.h"
 #include "utils.hpp"
+#include "bitdistance.hpp"
 
 /* The calculator class is the parent class for all the different estimators implemented in mothur except the tree calculators.
 It has 2 pure functions EstOutput getValues(SAbundVector*), which works on a single group, and 
@@ -84,11 +85,21 @@ protected:
 class DistCalc {
     
 public:
-    DistCalc(double c){ dist = 0; cutoff = c;  m = MothurOut::getInstance(); }
+    DistCalc(double c){ dist = 0; cutoff = c;  m = MothurOut::getInstance(); model = BitDistance::NONE; }
 
     virtual ~DistCalc() {}
     virtual double calcDist(Sequence, Sequence) = 0;
     
+    //calc distance between 2 aligned rows of length alignLength, does not copy the sequences
+    virtual double calcDist(const char* seqA, const char* seqB, int alignLength);
+    
+    //uses the bit packed kernels if canCalcEncoded returns true for the pair, otherwise compares the characters
+    double calcDist(const EncodedSeq& A, const EncodedSeq& B) {
+        if (canCalcEncoded(A, B)) { dist = BitDistance::calcDist(model, A, B, cutoff); return dist; }
+        return calcDist(A.getAligned(), B.getAligned(), A.getAlignLength());
+    }
+    bool canCalcEncoded(const EncodedSeq& A, const EncodedSeq& B) { return ((model != BitDistance::NONE) && A.isEncoded() && B.isEncoded() && (A.getAlignLength() == B.getAlignLength())); }
+    
     //currently not used
     virtual vector<double> calcDist(Sequence A, classifierOTU otu, vector<int> cols) { vector<double> dists; dists.resize(otu.numSeqs, 1.0); return dists; }
     
@@ -97,6 +108,7 @@ protected:
     MothurOut* m;
     Utils util;
     double cutoff;
+    BitDistance::Model model;
     
     vector<int> setStartsIgnoreTermGap(classifierOTU seqA, classifierOTU otu, vector<int> cols);
     vector<int> setEndsIgnoreTermGap(classifierOTU seqA, classifierOTU otu, vector<int> cols);
@@ -104,10 +116,10 @@ protected:
     vector<int> setStarts(classifierOTU seqA, classifierOTU otu, vector<int> cols);
     vector<int> setEnds(classifierOTU seqA, classifierOTU otu, vector<int> cols);
     
-    int setStart(string, string);
-    int setEnd(string, string);
-    int setStartIgnoreTermGap(string, string, bool&);
-    int setEndIgnoreTermGap(string, string, bool&);
+    int setStart(const char*, const char*, int);
+    int setEnd(const char*, const char*, int);
+    int setStartIgnoreTermGap(const char*, const char*, int, bool&);
+    int setEndIgnoreTermGap(const char*, const char*, int, bool&);
     
 };
 /**************************************************************************************************/
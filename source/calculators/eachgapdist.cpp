@@ -11,14 +11,16 @@
 /***********************************************************************/
 
 double eachGapDist::calcDist(Sequence A, Sequence B){
+    string seqA = A.getAligned();
+    string seqB = B.getAligned();
+    
+    return calcDist(seqA.c_str(), seqB.c_str(), (int)seqA.length());
+}
+/***********************************************************************/
+double eachGapDist::calcDist(const char* seqA, const char* seqB, int alignLength){
     try {
-        string seqA = A.getAligned();
-        string seqB = B.getAligned();
-        
-        int alignLength = (int)seqA.length();
-        
-        int start = setStart(seqA, seqB);
-        int end = setEnd(seqA, seqB);
+        int start = setStart(seqA, seqB, alignLength);
+        int end = setEnd(seqA, seqB, alignLength);
         
         int maxMinLength = end - start + 1;
         int diff = 0;
@@ -11,15 +11,18 @@
 /***********************************************************************/
 
 double eachGapIgnoreTermGapDist::calcDist(Sequence A, Sequence B){
+    string seqA = A.getAligned();
+    string seqB = B.getAligned();
+    
+    return calcDist(seqA.c_str(), seqB.c_str(), (int)seqA.length());
+}
+/***********************************************************************/
+double eachGapIgnoreTermGapDist::calcDist(const char* seqA, const char* seqB, int alignLength){
     try {
-        string seqA = A.getAligned();
-        string seqB = B.getAligned();
-        
-        int alignLength = seqA.length();
         bool overlap = false;
         
-        int start = setStartIgnoreTermGap(seqA, seqB, overlap);
-        int end = setEndIgnoreTermGap(seqA, seqB, overlap);
+        int start = setStartIgnoreTermGap(seqA, seqB, alignLength, overlap);
+        int end = setEndIgnoreTermGap(seqA, seqB, alignLength, overlap);
         
         //non-overlapping sequences
         if (!overlap) { return 1.0000; }
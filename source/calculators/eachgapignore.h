@@ -18,9 +18,10 @@ class eachGapIgnoreTermGapDist : public DistCalc {
 	
 public:
     
-    eachGapIgnoreTermGapDist(double c) : DistCalc(c) {}
+    eachGapIgnoreTermGapDist(double c) : DistCalc(c) { model = BitDistance::EACHGAPIGNORE; }
 	
     double calcDist(Sequence A, Sequence B);
+    double calcDist(const char* seqA, const char* seqB, int alignLength); //calc distance between 2 aligned rows
 	
     vector<double> calcDist(Sequence A, classifierOTU otu, vector<int> cols);
 
@@ -10,15 +10,19 @@
 
 /***********************************************************************/
 double ignoreGaps::calcDist(Sequence A, Sequence B){
+    string seqA = A.getAligned();
+    string seqB = B.getAligned();
+    
+    return calcDist(seqA.c_str(), seqB.c_str(), (int)seqA.length());
+}
+/***********************************************************************/
+double ignoreGaps::calcDist(const char* seqA, const char* seqB, int alignLength){
     try {
         int diff = 0;
         int start = 0;
         int end = 0;
         bool overlap = false;
         
-        string seqA = A.getAligned();
-        string seqB = B.getAligned();
-        int alignLength = (int)seqA.length();
         
         for(int i=0;i<alignLength;i++){
             if(seqA[i] != '.' && seqB[i] != '.'){
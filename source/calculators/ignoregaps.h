@@ -20,11 +20,12 @@ class ignoreGaps : public DistCalc {
 	
 public:
 	
-    ignoreGaps(double c) : DistCalc(c) {}
+    ignoreGaps(double c) : DistCalc(c) { model = BitDistance::NOGAPS; }
 	
     vector<double> calcDist(Sequence A, classifierOTU otu, vector<int> cols);
      
     double calcDist(Sequence A, Sequence B); //calc distance between 2 seqeunces
+    double calcDist(const char* seqA, const char* seqB, int alignLength); //calc distance between 2 aligned rows
     
 private:
     
@@ -11,17 +11,20 @@
 /***********************************************************************/
 
 double oneGapDist::calcDist(Sequence A, Sequence B){
+    string seqA = A.getAligned();
+    string seqB = B.getAligned();
+    
+    return calcDist(seqA.c_str(), seqB.c_str(), (int)seqA.length());
+}
+/***********************************************************************/
+double oneGapDist::calcDist(const char* seqA, const char* seqB, int alignLength){
     try {
         int difference = 0;
         bool openGapA = false;
         bool openGapB = false;
         
-        string seqA = A.getAligned();
-        string seqB = B.getAligned();
-        int alignLength = seqA.length();
-        
-        int start = setStart(seqA, seqB);
-        int end = setEnd(seqA, seqB);
+        int start = setStart(seqA, seqB, alignLength);
+        int end = setEnd(seqA, seqB, alignLength);
         
         int maxMinLength = end - start + 1;
         
@@ -18,13 +18,14 @@ class oneGapDist : public DistCalc {
 	
 public:
 	
-    oneGapDist(double c) : DistCalc(c) {}
+    oneGapDist(double c) : DistCalc(c) { model = BitDistance::ONEGAP; }
 	
     //finds the distance from A to each seq in otu.
     //this function calcs the distance using only the columns provided, if cols is empty, use all
     vector<double> calcDist(Sequence A, classifierOTU otu, vector<int> cols);
     
     double calcDist(Sequence A, Sequence B); //calc distance between 2 seqeunces
+    double calcDist(const char* seqA, const char* seqB, int alignLength); //calc distance between 2 aligned rows
     
   
 	
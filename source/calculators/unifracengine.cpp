@@ -0,0 +1,378 @@
+//
+//  unifracengine.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "unifracengine.hpp"
+
+/***********************************************************************/
+static inline int firstBit(uint64_t x) { //x != 0
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    int i = 0; while (((x >> i) & 1) == 0) { i++; } return i;
+#endif
+}
+/***********************************************************************/
+UnifracEngine::UnifracEngine(Tree* t, vector<string> G, bool r) : includeRoot(r), Groups(G) {
+    try {
+        m = MothurOut::getInstance();
+        CountTable* ct = t->getCountTable();
+        numLeaves = t->getNumLeaves();
+
+        //put the nodes in postorder, children before their parents
+        vector<int> order;
+        vector< pair<int, bool> > toVisit; toVisit.push_back(make_pair(t->findRoot(), false)); //node, children visited
+        while (!toVisit.empty()) {
+            pair<int, bool> node = toVisit.back(); toVisit.pop_back();
+
+            if (node.second) { order.push_back(node.first); continue; }
+
+            toVisit.push_back(make_pair(node.first, true));
+            int lc = t->tree[node.first].getLChild();
+            int rc = t->tree[node.first].getRChild();
+            if (rc != -1) { toVisit.push_back(make_pair(rc, false)); }
+            if (lc != -1) { toVisit.push_back(make_pair(lc, false)); }
+        }
+
+        numNodes = order.size();
+        numWords = (numNodes + 63) / 64;
+
+        vector<int> positions(t->getNumNodes(), -1);
+        for (int p = 0; p < numNodes; p++) { positions[order[p]] = p; }
+
+        lengths.resize(numNodes, 0.0); parents.resize(numNodes, -1); subtreeStarts.resize(numNodes, 0); leafPositions.resize(numLeaves, -1);
+        for (int p = 0; p < numNodes; p++) {
+            int index = order[p];
+
+            if (!util.isEqual(t->tree[index].getBranchLength(), -1)) { lengths[p] = abs(t->tree[index].getBranchLength()); }
+
+            int parent = t->tree[index].getParent();
+            if (parent != -1) { parents[p] = positions[parent]; }
+
+            //the left child's subtree comes first
+            subtreeStarts[p] = p;
+            int lc = t->tree[index].getLChild();
+            int rc = t->tree[index].getRChild();
+            if (lc != -1) { subtreeStarts[p] = min(subtreeStarts[p], subtreeStarts[positions[lc]]); }
+            if (rc != -1) { subtreeStarts[p] = min(subtreeStarts[p], subtreeStarts[positions[rc]]); }
+
+            if (index < numLeaves) { leafPositions[index] = p; }
+        }
+
+        int numGroups = Groups.size();
+        map<string, int> groupIndexes;
+        for (int i = 0; i < numGroups; i++) {
+            groupIndexes[Groups[i]] = i;
+
+            //calculate number of comparisons i.e. with groups A,B,C = AB, AC, BC = 3;
+            for (int l = 0; l < i; l++) {
+                vector<string> groups; groups.push_back(Groups[i]); groups.push_back(Groups[l]);
+                namesOfGroupCombos.push_back(groups);
+                groupCombos.push_back(make_pair(i, l));
+            }
+        }
+
+        leafCounts.resize(numGroups);
+        for (int i = 0; i < numLeaves; i++) {
+            if (leafPositions[i] == -1) { continue; }
+
+            for (map<string, int>::iterator it = t->tree[i].pcount.begin(); it != t->tree[i].pcount.end(); it++) {
+                map<string, int>::iterator itGroup = groupIndexes.find(it->first);
+                if (itGroup != groupIndexes.end()) { leafCounts[itGroup->second].push_back(make_pair(leafPositions[i], it->second)); }
+            }
+        }
+
+        //count each group's seqs below every node
+        groupTotals.resize(numGroups, 0.0); presence.resize(numGroups); proportions.resize(numGroups); groupTops.resize(numGroups, -1);
+        vector<int> counts(numNodes, 0);
+        for (int g = 0; g < numGroups; g++) {
+            if (m->getControl_pressed()) { break; }
+
+            presence[g].resize(numWords, 0);
+            if (leafCounts[g].size() == 0) { continue; }
+
+            groupTotals[g] = ct->getGroupCount(Groups[g]);
+
+            fill(counts.begin(), counts.end(), 0);
+            int numSeqs = 0;
+            for (int j = 0; j < leafCounts[g].size(); j++) { counts[leafCounts[g][j].first] = leafCounts[g][j].second; numSeqs += leafCounts[g][j].second; }
+
+            for (int p = 0; p < numNodes; p++) {
+                if (counts[p] == 0) { continue; }
+
+                presence[g][p / 64] |= (1ULL << (p % 64));
+                proportions[g].push_back(make_pair(p, counts[p] / groupTotals[g]));
+
+                //the first node with all the group's seqs is the smallest subtree with all its leaves
+                if ((groupTops[g] == -1) && (counts[p] == numSeqs)) { groupTops[g] = p; }
+
+                if (parents[p] != -1) { counts[parents[p]] += counts[p]; }
+            }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracEngine", "UnifracEngine");
+        exit(1);
+    }
+}
+/***********************************************************************/
+EstOutput UnifracEngine::getUnweighted(int processors) {
+    try {
+        return createProcesses(NULL, false, processors);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracEngine", "getUnweighted");
+        exit(1);
+    }
+}
+/***********************************************************************/
+EstOutput UnifracEngine::getWeighted(int processors) {
+    try {
+        return createProcesses(NULL, true, processors);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracEngine", "getWeighted");
+        exit(1);
+    }
+}
+/***********************************************************************/
+EstOutput UnifracEngine::getUnweighted(vector<vector<int> >& randomTreeNodes, int processors) {
+    try {
+        return createProcesses(&randomTreeNodes, false, processors);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracEngine", "getUnweighted");
+        exit(1);
+    }
+}
+/***********************************************************************/
+EstOutput UnifracEngine::getWeighted(vector<vector<int> >& randomTreeNodes, int processors) {
+    try {
+        return createProcesses(&randomTreeNodes, true, processors);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracEngine", "getWeighted");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//climbs from first until its subtree holds second
+int UnifracEngine::getCommonAncestor(int first, int second) {
+    try {
+        if (first == -1) { return second; }
+        if (second == -1) { return first; }
+
+        while ((first != -1) && ((second > first) || (second < subtreeStarts[first]))) { first = parents[first]; }
+
+        return first;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracEngine", "getCommonAncestor");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//the swaps only move seqs between the pair's leaves, so the random trees have the same root as the users tree
+int UnifracEngine::getPairRoot(int h) {
+    try {
+        int top = getCommonAncestor(groupTops[groupCombos[h].first], groupTops[groupCombos[h].second]);
+
+        if (top == -1) { return -1; }
+
+        //you are a leaf so get your parent
+        if (subtreeStarts[top] == top) { return parents[top]; }
+
+        return top;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracEngine", "getPairRoot");
+        exit(1);
+    }
+}
+/***********************************************************************/
+void UnifracEngine::warnEmptyPair(int h) {
+    try {
+        m->mothurOut("[WARNING]: cannot find a nodes in the tree from grouping " + namesOfGroupCombos[h][0] + "-" + namesOfGroupCombos[h][1] + ", skipping.\n");
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracEngine", "warnEmptyPair");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//a branch is unique if only one of the groups has seqs below it
+double UnifracEngine::getPairUnweighted(int h) {
+    try {
+        int groupA = groupCombos[h].first; int groupB = groupCombos[h].second;
+
+        if ((leafCounts[groupA].size() == 0) && (leafCounts[groupB].size() == 0)) { warnEmptyPair(h); return 0.0; }
+
+        int root = getPairRoot(h);
+        double UniqueBL = 0.0; double totalBL = 0.0;
+
+        for (int w = 0; w < numWords; w++) {
+            uint64_t either = presence[groupA][w] | presence[groupB][w];
+            uint64_t unique = presence[groupA][w] ^ presence[groupB][w];
+
+            while (either != 0) {
+                int bit = firstBit(either); either &= (either - 1);
+                int p = w * 64 + bit;
+
+                if (isExcluded(p, root)) { continue; }
+
+                totalBL += lengths[p];
+                if ((unique >> bit) & 1) { UniqueBL += lengths[p]; }
+            }
+        }
+
+        double UW = UniqueBL / totalBL;
+        if (isnan(UW) || isinf(UW)) { UW = 0; }
+
+        return UW;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracEngine", "getPairUnweighted");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//walks the nodes with seqs from either group, the top of the tree is left out of the normalizing sum
+double UnifracEngine::getPairWeighted(int h) {
+    try {
+        vector< pair<int, double> >& A = proportions[groupCombos[h].first];
+        vector< pair<int, double> >& B = proportions[groupCombos[h].second];
+
+        int root = getPairRoot(h);
+        double WScore = 0.0; double D = 0.0;
+
+        int i = 0; int j = 0;
+        while ((i < A.size()) || (j < B.size())) {
+            int p; double u_a = 0.0; double u_b = 0.0;
+
+            if ((j == B.size()) || ((i < A.size()) && (A[i].first < B[j].first)))       { p = A[i].first; u_a = A[i].second; i++; }
+            else if ((i == A.size()) || (B[j].first < A[i].first))                      { p = B[j].first; u_b = B[j].second; j++; }
+            else                                                                        { p = A[i].first; u_a = A[i].second; u_b = B[j].second; i++; j++; }
+
+            if (isExcluded(p, root)) { continue; }
+
+            WScore += lengths[p] * abs(u_a - u_b);
+            if (p != (numNodes-1)) { D += lengths[p] * (u_a + u_b); }
+        }
+
+        double W = WScore / D;
+        if (isnan(W) || isinf(W)) { W = 0; }
+
+        return W;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracEngine", "getPairWeighted");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//swaps the seqs of the leaves in pairs like Tree::randomLabels, a leftover leaf keeps its seqs, then recounts the pair's groups
+double UnifracEngine::getRandomScore(int h, vector<int>& nodesToSwap, bool weighted, vector<int>& countsA, vector<int>& countsB) {
+    try {
+        int groupA = groupCombos[h].first; int groupB = groupCombos[h].second;
+
+        if (!weighted && (leafCounts[groupA].size() == 0) && (leafCounts[groupB].size() == 0)) { warnEmptyPair(h); return 0.0; }
+
+        fill(countsA.begin(), countsA.end(), 0); fill(countsB.begin(), countsB.end(), 0);
+        for (int j = 0; j < leafCounts[groupA].size(); j++) { countsA[leafCounts[groupA][j].first] = leafCounts[groupA][j].second; }
+        for (int j = 0; j < leafCounts[groupB].size(); j++) { countsB[leafCounts[groupB][j].first] = leafCounts[groupB][j].second; }
+
+        for (int j = 0; j+1 < nodesToSwap.size(); j += 2) {
+            int first = leafPositions[nodesToSwap[j]]; int second = leafPositions[nodesToSwap[j+1]];
+            swap(countsA[first], countsA[second]); swap(countsB[first], countsB[second]);
+        }
+
+        for (int p = 0; p < numNodes-1; p++) { countsA[parents[p]] += countsA[p]; countsB[parents[p]] += countsB[p]; }
+
+        int root = getPairRoot(h);
+        double numerator = 0.0; double denominator = 0.0;
+
+        for (int p = 0; p < numNodes; p++) {
+            if ((countsA[p] == 0) && (countsB[p] == 0)) { continue; }
+            if (isExcluded(p, root)) { continue; }
+
+            if (weighted) {
+                double u_a = 0.0; if (countsA[p] != 0) { u_a = countsA[p] / groupTotals[groupA]; }
+                double u_b = 0.0; if (countsB[p] != 0) { u_b = countsB[p] / groupTotals[groupB]; }
+
+                numerator += lengths[p] * abs(u_a - u_b);
+                if (p != (numNodes-1)) { denominator += lengths[p] * (u_a + u_b); }
+            }else {
+                denominator += lengths[p];
+                if ((countsA[p] == 0) || (countsB[p] == 0)) { numerator += lengths[p]; }
+            }
+        }
+
+        double score = numerator / denominator;
+        if (isnan(score) || isinf(score)) { score = 0; }
+
+        return score;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracEngine", "getRandomScore");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//the pairs share the engine's arrays, each thread only writes its own pairs' results
+void UnifracEngine::driver(int start, int num, vector<vector<int> >* randomTreeNodes, bool weighted, EstOutput* results) {
+    try {
+        vector<int> countsA, countsB;
+        if (randomTreeNodes != NULL) { countsA.resize(numNodes, 0); countsB.resize(numNodes, 0); }
+
+        for (int h = start; h < (start+num); h++) {
+            if (m->getControl_pressed()) { break; }
+
+            if (randomTreeNodes != NULL)    { (*results)[h] = getRandomScore(h, (*randomTreeNodes)[h], weighted, countsA, countsB);  }
+            else if (weighted)              { (*results)[h] = getPairWeighted(h);                                                   }
+            else                            { (*results)[h] = getPairUnweighted(h);                                                 }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracEngine", "driver");
+        exit(1);
+    }
+}
+/***********************************************************************/
+EstOutput UnifracEngine::createProcesses(vector<vector<int> >* randomTreeNodes, bool weighted, int processors) {
+    try {
+        EstOutput results(groupCombos.size(), 0.0);
+
+        vector<linePair> lines;
+        int remainingPairs = groupCombos.size();
+        if (remainingPairs == 0) { return results; }
+        if (remainingPairs < processors) { processors = remainingPairs; }
+        int startIndex = 0;
+        for (int remainingProcessors = processors; remainingProcessors > 0; remainingProcessors--) {
+            int numPairs = remainingPairs; //case for last processor
+            if (remainingProcessors != 1) { numPairs = ceil(remainingPairs / remainingProcessors); }
+            lines.push_back(linePair(startIndex, numPairs)); //startIndex, numPairs
+            startIndex = startIndex + numPairs;
+            remainingPairs = remainingPairs - numPairs;
+        }
+
+        //Lauch worker threads
+        vector<std::thread*> workerThreads;
+        for (int i = 0; i < processors-1; i++) {
+            workerThreads.push_back(new std::thread(&UnifracEngine::driver, this, (int)lines[i+1].start, (int)lines[i+1].end, randomTreeNodes, weighted, &results));
+        }
+
+        driver((int)lines[0].start, (int)lines[0].end, randomTreeNodes, weighted, &results);
+
+        for (int i = 0; i < processors-1; i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+
+        return results;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracEngine", "createProcesses");
+        exit(1);
+    }
+}
+/***********************************************************************/
@@ -0,0 +1,73 @@
+//
+//  unifracengine.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef unifracengine_hpp
+#define unifracengine_hpp
+
+#include "treecalculator.h"
+#include "counttable.h"
+#include <cstdint>
+
+/***********************************************************************/
+//UnifracEngine converts a tree once into arrays in postorder: the branch lengths, each node's parent and the start of
+//its subtree, and for each group a bitset of the nodes with seqs from the group and the nodes' shares of the group's
+//seqs. The scores for every pair of groups are then sums over those arrays, the unweighted ones walk the set bits of
+//the two groups' bitsets. The random scores swap the leaves' contents the way assembleRandomUnifracTree does and
+//recount the pair's two groups, the tree is never copied.
+//
+//The scores are the same as the node by node calculations Unweighted and Weighted used to do, including where the
+//root is put for each pair when the root is not included.
+
+class UnifracEngine {
+
+public:
+    UnifracEngine(Tree*, vector<string>, bool); //tree, groups to compare, include root
+    ~UnifracEngine() {}
+
+    //one score per pair of groups, in the order Unweighted and Weighted list the combinations
+    EstOutput getUnweighted(int);   //processors
+    EstOutput getWeighted(int);     //processors
+
+    //for each pair of groups, the tree's leaves with seqs from the pair in the order they are swapped, see Tree::randomLabels
+    EstOutput getUnweighted(vector<vector<int> >&, int);
+    EstOutput getWeighted(vector<vector<int> >&, int);
+
+private:
+    MothurOut* m;
+    Utils util;
+    bool includeRoot;
+    int numNodes, numLeaves, numWords;
+    vector<string> Groups;
+    vector< vector<string> > namesOfGroupCombos;
+    vector< pair<int, int> > groupCombos; //indexes into Groups
+
+    //by postorder position, the top of the tree is numNodes-1
+    vector<double> lengths;         //abs of the branch length, 0 for nodes without one
+    vector<int> parents;            //-1 for the top
+    vector<int> subtreeStarts;      //a node's subtree is the positions subtreeStarts[p] to p
+    vector<int> leafPositions;      //tree leaf index -> postorder position
+
+    vector< vector< pair<int, int> > > leafCounts;      //[group] position and seqs from the group for the leaves with seqs from the group
+    vector<double> groupTotals;                         //seqs in the group in the count table
+    vector< vector<uint64_t> > presence;                //[group] bit p is set if the node at position p has seqs from the group
+    vector< vector< pair<int, double> > > proportions;  //[group] position and share of the group's seqs for the nodes with seqs from the group
+    vector<int> groupTops;                              //[group] smallest subtree with all the group's leaves, -1 if the group has none
+
+    int getCommonAncestor(int, int);    //positions, -1 is no node
+    int getPairRoot(int);               //pair -> its root, the smallest subtree with all the pair's leaves or a lone leaf's parent
+    bool isExcluded(int p, int root) { return (!includeRoot && (root != -1) && (p >= root) && (subtreeStarts[p] <= root)); } //root and its ancestors
+    void warnEmptyPair(int);
+
+    double getPairUnweighted(int);
+    double getPairWeighted(int);
+    double getRandomScore(int, vector<int>&, bool, vector<int>&, vector<int>&); //pair, leaves to swap, weighted, counts for the pair's two groups
+    void driver(int, int, vector<vector<int> >*, bool, EstOutput*);
+    EstOutput createProcesses(vector<vector<int> >*, bool, int);
+};
+/***********************************************************************/
+
+#endif /* unifracengine_hpp */
@@ -12,7 +12,7 @@
  */
 
 #include "treecalculator.h"
-#include "counttable.h"
+#include "unifracengine.hpp"
 
 /***********************************************************************/
 
@@ -22,17 +22,12 @@ class Unweighted : public TreeCalculator  {
         Unweighted(bool r, vector<string> g);
 		~Unweighted() {};
 		EstOutput getValues(Tree*, int, string);
-		EstOutput getValues(Tree*, vector<vector<int> >&, int, string);
 		
 	private:
-		vector< vector<string> > namesOfGroupCombos;
         vector<string> Groups;
 		int processors;
 		string outputDir;
 		bool includeRoot;
-		
-		EstOutput createProcesses(Tree*, CountTable*);
-		EstOutput createProcesses(Tree*, vector<vector<int> >&, CountTable*);
 };
 
 /**************************************************************************************************/
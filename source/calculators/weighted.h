@@ -12,7 +12,7 @@
  */
 
 #include "treecalculator.h"
-#include "counttable.h"
+#include "unifracengine.hpp"
 
 /***********************************************************************/
 
@@ -22,18 +22,13 @@ class Weighted : public TreeCalculator  {
         Weighted( bool r, vector<string> G);
 		~Weighted() {};
 		
-		EstOutput getValues(Tree*, string, string);
 		EstOutput getValues(Tree*, int, string);
 		
 	private:
-        Utils util;
         int processors;
         string outputDir;
         bool includeRoot;
         vector<string> Groups;
-        vector< vector<string> > namesOfGroupCombos;
-		
-		EstOutput createProcesses(Tree*, CountTable*);
 };
 /**************************************************************************************************/
 
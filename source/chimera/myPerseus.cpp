@@ -48,7 +48,9 @@ vector<vector<double> > Perseus::binomial(int maxOrder){
 }
 
 /**************************************************************************************************/
-double Perseus::basicPairwiseAlignSeqs(string query, string reference, string& qAlign, string& rAlign, pwModel model){
+//the matrix and moves are kept between calls, so aligning a query against each of its parents only allocates when a
+//pair is larger than any before it. The alignment is traced back into the strings backwards and then reversed
+double Perseus::basicPairwiseAlignSeqs(const string& query, const string& reference, string& qAlign, string& rAlign, pwModel model){
 	try {
 		double GAP = model.GAP_OPEN;
 		double MATCH = model.MATCH;
@@ -56,65 +58,63 @@ double Perseus::basicPairwiseAlignSeqs(string query, string reference, string& q
 		
 		int queryLength = query.size();
 		int refLength = reference.size();
+		int width = refLength + 1;
 		
-		vector<vector<double> > alignMatrix(queryLength + 1);
-		vector<vector<char> > alignMoves(queryLength + 1);
-		
-		for(int i=0;i<=queryLength;i++){
-			if (m->getControl_pressed()) { return 0; }
-			alignMatrix[i].resize(refLength + 1, 0);
-			alignMoves[i].resize(refLength + 1, 'x');
-		}
+		size_t numCells = (size_t)(queryLength + 1) * width;
+		if (alignMatrix.size() < numCells) { alignMatrix.resize(numCells); alignMoves.resize(numCells); }
 		
 		for(int i=0;i<=queryLength;i++){
-			if (m->getControl_pressed()) { return 0; }
-			alignMatrix[i][0] = GAP * i;
-			alignMoves[i][0] = 'u';
+			alignMatrix[i*width] = GAP * i;
+			alignMoves[i*width] = 'u';
 		}
 		
 		for(int i=0;i<=refLength;i++){
-			if (m->getControl_pressed()) { return 0; }
-			alignMatrix[0][i] = GAP * i;
-			alignMoves[0][i] = 'l';
+			alignMatrix[i] = GAP * i;
+			alignMoves[i] = 'l';
 		}
 		
 		for(int i=1;i<=queryLength;i++){
 			
 			if (m->getControl_pressed()) { return 0; }
 			
+			double* row = &alignMatrix[i*width];
+			double* above = &alignMatrix[(i-1)*width];
+			char* moves = &alignMoves[i*width];
+			char queryBase = query[i-1];
+			
 			for(int j=1;j<=refLength;j++){
 				
 				double nogapScore;		
-				if(query[i-1] == reference[j-1]){	nogapScore = alignMatrix[i-1][j-1] + MATCH;		}
-				else							{	nogapScore = alignMatrix[i-1][j-1] + MISMATCH;	}
+				if(queryBase == reference[j-1])	{	nogapScore = above[j-1] + MATCH;		}
+				else							{	nogapScore = above[j-1] + MISMATCH;		}
 				
 				double leftScore;
-				if(i == queryLength)			{	leftScore = alignMatrix[i][j-1];				}
-				else							{	leftScore = alignMatrix[i][j-1] + GAP;			}
+				if(i == queryLength)			{	leftScore = row[j-1];					}
+				else							{	leftScore = row[j-1] + GAP;				}
 				
 				
 				double upScore;
-				if(j == refLength)				{	upScore = alignMatrix[i-1][j];					}
-				else							{	upScore = alignMatrix[i-1][j] + GAP;			}
+				if(j == refLength)				{	upScore = above[j];						}
+				else							{	upScore = above[j] + GAP;				}
 				
 				if(nogapScore > leftScore){
 					if(nogapScore > upScore){
-						alignMoves[i][j] = 'd';
-						alignMatrix[i][j] = nogapScore;
+						moves[j] = 'd';
+						row[j] = nogapScore;
 					}
 					else{
-						alignMoves[i][j] = 'u';
-						alignMatrix[i][j] = upScore;
+						moves[j] = 'u';
+						row[j] = upScore;
 					}
 				}
 				else{
 					if(leftScore > upScore){
-						alignMoves[i][j] = 'l';
-						alignMatrix[i][j] = leftScore;
+						moves[j] = 'l';
+						row[j] = leftScore;
 					}
 					else{
-						alignMoves[i][j] = 'u';
-						alignMatrix[i][j] = upScore;
+						moves[j] = 'u';
+						row[j] = upScore;
 					}
 				}
 			}
@@ -133,9 +133,10 @@ double Perseus::basicPairwiseAlignSeqs(string query, string reference, string& q
 			
 			if (m->getControl_pressed()) { return 0; }
 			
-			if(alignMoves[i][j] == 'd'){
-				qAlign = query[i-1] + qAlign;
-				rAlign = reference[j-1] + rAlign;
+			char move = alignMoves[i*width+j];
+			if(move == 'd'){
+				qAlign += query[i-1];
+				rAlign += reference[j-1];
 
 				if(query[i-1] != reference[j-1]){	diffs++;	}
 				length++;
@@ -143,42 +144,37 @@ double Perseus::basicPairwiseAlignSeqs(string query, string reference, string& q
 				i--;
 				j--;
 			}
-			else if(alignMoves[i][j] == 'u'){
-				qAlign = query[i-1] + qAlign;
+			else if(move == 'u'){
+				qAlign += query[i-1];
 				
-				if(j != refLength)	{	rAlign = '-' + rAlign;	diffs++;	length++;	}
-				else				{	rAlign = '.' + rAlign;	}
+				if(j != refLength)	{	rAlign += '-';	diffs++;	length++;	}
+				else				{	rAlign += '.';	}
 				i--;
 			}
-			else if(alignMoves[i][j] == 'l'){
-				rAlign = reference[j-1] + rAlign;
+			else if(move == 'l'){
+				rAlign += reference[j-1];
 				
-				if(i != queryLength){	qAlign = '-' + qAlign;	diffs++;	length++;	}
-				else				{	qAlign = '.' + qAlign;	}
+				if(i != queryLength){	qAlign += '-';	diffs++;	length++;	}
+				else				{	qAlign += '.';	}
 				j--;
 			}
 		}
 		
 		while(i>0){
-			
-			if (m->getControl_pressed()) { return 0; }
-			
-			rAlign = '.' + rAlign;
-			qAlign = query[i-1] + qAlign;
+			rAlign += '.';
+			qAlign += query[i-1];
 			i--;
 		}
 		
 		while(j>0){
-			
-			if (m->getControl_pressed()) { return 0; }
-			
-			rAlign = reference[j-1] + rAlign;
-			qAlign = '.' + qAlign;
+			rAlign += reference[j-1];
+			qAlign += '.';
 			j--;
 		}
 		
+		reverse(qAlign.begin(), qAlign.end());
+		reverse(rAlign.begin(), rAlign.end());
 		
-
 		return double(diffs)/double(length);
 	}
 	catch(exception& e) {
@@ -432,12 +428,12 @@ double Perseus::modeledPairwiseAlignSeqs(string query, string reference, string&
 }
 
 /**************************************************************************************************/
-int Perseus::getAlignments(int curSequenceIndex, vector<seqData> sequences, vector<pwAlign>& alignments, vector<vector<int> >& leftDiffs, vector<vector<int> >& leftMaps, vector<vector<int> >& rightDiffs, vector<vector<int> >& rightMaps, int& bestRefSeq, int& bestRefDiff, vector<bool>& restricted){
+int Perseus::getAlignments(int curSequenceIndex, const vector<seqData>& sequences, vector<pwAlign>& alignments, vector<vector<int> >& leftDiffs, vector<vector<int> >& leftMaps, vector<vector<int> >& rightDiffs, vector<vector<int> >& rightMaps, int& bestRefSeq, int& bestRefDiff, vector<bool>& restricted){
 	try {
 		int numSeqs = sequences.size();
 		//int bestSequenceMismatch = PERSEUSMAXINT;
 
-		string curSequence = sequences[curSequenceIndex].sequence;
+		const string& curSequence = sequences[curSequenceIndex].sequence;
 		int curFrequency = sequences[curSequenceIndex].frequency; 
 
 		bestRefSeq = -1;
@@ -453,7 +449,7 @@ int Perseus::getAlignments(int curSequenceIndex, vector<seqData> sequences, vect
 			if (m->getControl_pressed()) { return 0; }
 			
 			if(i != curSequenceIndex && restricted[i] != 1 && sequences[i].frequency >= 2 * curFrequency){
-				string refSequence = sequences[i].sequence;
+				const string& refSequence = sequences[i].sequence;
 				
 				leftDiffs[i].assign(curSequence.length(), 0);
 				leftMaps[i].assign(curSequence.length(), 0);
@@ -490,7 +486,7 @@ int Perseus::getAlignments(int curSequenceIndex, vector<seqData> sequences, vect
 	}
 }
 /**************************************************************************************************/
-int Perseus::getChimera(vector<seqData> sequences,
+int Perseus::getChimera(const vector<seqData>& sequences,
 			   vector<vector<int> >& leftDiffs, 
 			   vector<vector<int> >& rightDiffs,
 			   int& leftParent, 
@@ -500,10 +496,12 @@ int Perseus::getChimera(vector<seqData> sequences,
 			   vector<int>& bestLeft, 
 			   vector<int>& singleRight, 
 			   vector<int>& bestRight, 
-			   vector<bool> restricted){
+			   const vector<bool>& restricted){
 	try {
 		int numRefSeqs = restricted.size();
-		int seqLength = leftDiffs[0].size();
+		//only the compared sequences have diffs, the most abundant one may have been pruned
+		int seqLength = 0;
+		for(int i=0;i<numRefSeqs;i++){ if(!restricted[i]){ seqLength = leftDiffs[i].size(); break; } }
 		
 		singleLeft.resize(seqLength, PERSEUSMAXINT);
 		bestLeft.resize(seqLength, -1);
@@ -607,7 +605,7 @@ string Perseus::stitchBimera(vector<pwAlign>& alignments, int leftParent, int ri
 	}
 }
 /**************************************************************************************************/
-int Perseus::getTrimera(vector<seqData>& sequences,
+int Perseus::getTrimera(const vector<seqData>& sequences,
 			   vector<vector<int> >& leftDiffs,
 			   int& leftParent,
 			   int& middleParent,
@@ -618,10 +616,11 @@ int Perseus::getTrimera(vector<seqData>& sequences,
 			   vector<int>& bestLeft, 
 			   vector<int>& singleRight,
 			   vector<int>& bestRight,
-			   vector<bool> restricted){
+			   const vector<bool>& restricted){
 	try {
 		int numRefSeqs = leftDiffs.size();
-		int alignLength = leftDiffs[0].size();
+		int alignLength = 0;
+		for(int i=0;i<numRefSeqs;i++){ if(!restricted[i]){ alignLength = leftDiffs[i].size(); break; } }
 		int bestTrimeraMismatches = PERSEUSMAXINT;
 		
 		leftParent = -1;
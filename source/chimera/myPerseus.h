@@ -60,18 +60,20 @@ public:
 	
 	vector<vector<double> > binomial(int);
 	double modeledPairwiseAlignSeqs(string, string, string&, string&, vector<vector<double> >&);
-	int getAlignments(int, vector<seqData>, vector<pwAlign>&, vector<vector<int> >& , vector<vector<int> >&, vector<vector<int> >&, vector<vector<int> >&, int&, int&, vector<bool>&);
-	int getChimera(vector<seqData>,vector<vector<int> >&, vector<vector<int> >&,int&, int&, int&,vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<bool>);
+	int getAlignments(int, const vector<seqData>&, vector<pwAlign>&, vector<vector<int> >& , vector<vector<int> >&, vector<vector<int> >&, vector<vector<int> >&, int&, int&, vector<bool>&);
+	int getChimera(const vector<seqData>&,vector<vector<int> >&, vector<vector<int> >&,int&, int&, int&,vector<int>&, vector<int>&, vector<int>&, vector<int>&, const vector<bool>&);
 	string stitchBimera(vector<pwAlign>&, int, int, int, vector<vector<int> >&, vector<vector<int> >&);
-	int getTrimera(vector<seqData>&, vector<vector<int> >&, int&, int&, int&, int&, int&, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<bool>);
+	int getTrimera(const vector<seqData>&, vector<vector<int> >&, int&, int&, int&, int&, int&, vector<int>&, vector<int>&, vector<int>&, vector<int>&, const vector<bool>&);
 	string stitchTrimera(vector<pwAlign>, int, int, int, int, int, vector<vector<int> >&, vector<vector<int> >&);
 	double calcLoonIndex(string, string, string, int, vector<vector<double> >&);
 	double classifyChimera(double, double, double, double, double);
 	
 private:
 	MothurOut* m;
+	vector<double> alignMatrix;	//basicPairwiseAlignSeqs's matrix and moves, reused between pairs
+	vector<char> alignMoves;
 	int toInt(char);
-	double basicPairwiseAlignSeqs(string, string, string&, string&, pwModel);
+	double basicPairwiseAlignSeqs(const string&, const string&, string&, string&, pwModel);
 	int getDiffs(string, string, vector<int>&, vector<int>&, vector<int>&, vector<int>&);
 	int getLastMatch(char, vector<vector<char> >&, int, int, string&, string&);
 	int threeWayAlign(string, string, string, string&, string&, string&);
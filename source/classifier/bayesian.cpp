@@ -10,6 +10,68 @@
 #include "bayesian.h"
 #include "kmer.hpp"
 #include "phylosummary.h"
+#include "randomstream.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    #define USE_X86_KERNELS
+    #include <immintrin.h>
+#endif
+
+/**************************************************************************************************/
+//scores[k] = the sum of wordGenusProb rows kmers[0..numQueryKmers) at genus k. The rows are added one after another in
+//the query's order, so each genus sums its probabilities in the same order the genus at a time loop did.
+static void sumGenusScoresScalar(const float* table, long long numGenera, const int* kmers, int numQueryKmers, double* scores) {
+    for (long long k = 0; k < numGenera; k++) { scores[k] = 0.0; }
+    for (int i = 0; i < numQueryKmers; i++) {
+        const float* row = table + (long long)kmers[i] * numGenera;
+        for (long long k = 0; k < numGenera; k++) { scores[k] += row[k]; }
+    }
+}
+/**************************************************************************************************/
+#ifdef USE_X86_KERNELS
+
+//8 genera of row added to the 8 scores in sumLow and sumHigh
+__attribute__((target("avx2")))
+static inline void addRow(const float* row, __m256d& sumLow, __m256d& sumHigh) {
+    sumLow = _mm256_add_pd(sumLow, _mm256_cvtps_pd(_mm_loadu_ps(row)));
+    sumHigh = _mm256_add_pd(sumHigh, _mm256_cvtps_pd(_mm_loadu_ps(row+4)));
+}
+/**************************************************************************************************/
+//four rows at a time are streamed into the scores, which stay in the L1 cache
+__attribute__((target("avx2")))
+static void sumGenusScoresAVX2(const float* table, long long numGenera, const int* kmers, int numQueryKmers, double* scores) {
+    for (long long k = 0; k < numGenera; k++) { scores[k] = 0.0; }
+    
+    int i = 0;
+    for (; i < numQueryKmers; i += 4) {
+        int numRows = min(4, numQueryKmers - i);
+        const float* rows[4];
+        for (int r = 0; r < 4; r++) { rows[r] = table + (long long)kmers[i + min(r, numRows-1)] * numGenera; }
+        
+        long long k = 0;
+        for (; k + 8 <= numGenera; k += 8) {
+            __m256d sumLow = _mm256_loadu_pd(scores+k), sumHigh = _mm256_loadu_pd(scores+k+4);
+            addRow(rows[0]+k, sumLow, sumHigh);
+            if (numRows > 1) { addRow(rows[1]+k, sumLow, sumHigh); }
+            if (numRows > 2) { addRow(rows[2]+k, sumLow, sumHigh); }
+            if (numRows > 3) { addRow(rows[3]+k, sumLow, sumHigh); }
+            _mm256_storeu_pd(scores+k, sumLow); _mm256_storeu_pd(scores+k+4, sumHigh);
+        }
+        for (; k < numGenera; k++) {
+            for (int r = 0; r < numRows; r++) { scores[k] += rows[r][k]; }
+        }
+    }
+}
+#endif
+/**************************************************************************************************/
+static bool useAVX2GenusScores() {
+#ifdef USE_X86_KERNELS
+    static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+    return hasAVX2;
+#else
+    return false;
+#endif
+}
 
 /**************************************************************************************************/
 Bayesian::Bayesian(string txfile, string tempFile, string method, int ksize, int cutoff, int i, int tid, bool f, bool sh, string version) :
@@ -31,8 +93,7 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
         string probFileName = tfileroot + tempfileroot + char('0'+ kmerSize) + "mer.prob";
         string probFileName2 = tfileroot + tempfileroot + char('0'+ kmerSize) + "mer.numNonZero";
         
-        ofstream out;
-        ofstream out2;
+        wordGenusProb = NULL; probIndex = NULL;
         
         vector<ifstream*> files;
         ifstream* phyloTreeTest = new ifstream(phyloTreeName.c_str()); files.push_back(phyloTreeTest);
@@ -40,13 +101,17 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 		ifstream* probFileTest = new ifstream(probFileName.c_str());   files.push_back(probFileTest);
 		ifstream* probFileTest3 = new ifstream(phyloTreeSumName.c_str()); files.push_back(probFileTest3);
 		
+		//the binary prob file holds everything that was in the numNonZero file
+		bool probFileIsIndex = ReferenceIndex::isIndex(probFileName);
+		if (probFileIsIndex) { files.erase(files.begin()+1); delete probFileTest2; probFileTest2 = NULL; }
+		
 		long start = time(NULL);
 		
 		//if they are there make sure they were created after this release date
 		bool FilesGood = false;
-		if(probFileTest && probFileTest2 && phyloTreeTest && probFileTest3){ FilesGood = checkReleaseDate(files, version); }
+		if(probFileTest && phyloTreeTest && probFileTest3){ FilesGood = checkReleaseDate(files, version); }
 
-		if(probFileTest && probFileTest2 && phyloTreeTest && probFileTest3 && FilesGood){
+		if(FilesGood){
 			
 			m->mothurOut("Reading template taxonomy...     "); cout.flush();
 			
@@ -59,7 +124,8 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 			genusTotals = phyloTree->getGenusTotals();
 			
             m->mothurOut("Reading template probabilities...     "); cout.flush();
-            readProbFile(*probFileTest, *probFileTest2, probFileName, probFileName2);
+            if (probFileIsIndex)    { probFileTest->close(); readProbIndex(probFileName);                       }
+            else                    { readProbFile(*probFileTest, *probFileTest2, probFileName, probFileName2);  }
 			
         }else{
 		
@@ -81,40 +147,23 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 				m->mothurOut("Calculating template probabilities...     "); cout.flush();
 				
 				numKmers = database->getMaxKmer() + 1;
+				int numGenera = genusNodes.size();
 			
 				//initialze probabilities
-				wordGenusProb.resize(numKmers);
+				wordGenusProbData.assign((long long)numKmers * numGenera, 0.0);
+				wordGenusProb = wordGenusProbData.data();
                 for (int j = 0; j < numKmers; j++) {  diffPair tempDiffPair; WordPairDiffArr.push_back(tempDiffPair); }
-			
-                for (int j = 0; j < wordGenusProb.size(); j++) {	wordGenusProb[j].resize(genusNodes.size(), 0.0);		}
-                ofstream out; ofstream out2;
-
-                if (shortcuts) { 
-                    util.openOutputFile(probFileName, out); 
-				
-                    //output mothur version
-                    out << "#" << version << endl;
-				
-                    out << numKmers << endl;
-				
-                    util.openOutputFile(probFileName2, out2);
-				
-                    //output mothur version
-                    out2 << "#" << version << endl;
-                }
 
 				//for each word
 				for (int i = 0; i < numKmers; i++) {
                     //m->mothurOut("[DEBUG]: kmer = " + toString(i) + "\n");
                     
 					if (m->getControl_pressed()) {  break; }
-
-                    if (shortcuts) {  out << i << '\t'; }
 					
 					vector<int> seqsWithWordi = database->getSequencesWithKmer(i);
 					
 					//for each sequence with that word
-                    vector<int> count; count.resize(genusNodes.size(), 0);
+                    vector<int> count; count.resize(numGenera, 0);
 					for (int j = 0; j < seqsWithWordi.size(); j++) {
 						int temp = phyloTree->getGenusIndex(names[seqsWithWordi[j]]);
 						count[temp]++;  //increment count of seq in this genus who have this word
@@ -124,28 +173,15 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 					float probabilityInTemplate = (seqsWithWordi.size() + 0.50) / (float) (names.size() + 1);
 					diffPair tempProb(log(probabilityInTemplate), 0.0);
 					WordPairDiffArr[i] = tempProb;
-						
-					int numNotZero = 0;
-					for (int k = 0; k < genusNodes.size(); k++) {
+					
+					float* wordProbs = &wordGenusProbData[(long long)i * numGenera];
+					for (int k = 0; k < numGenera; k++) {
 						//probabilityInThisTaxonomy = (# of seqs with that word in this taxonomy + probabilityInTemplate) / (total number of seqs in this taxonomy + 1);
-						
-						
-						wordGenusProb[i][k] = log((count[k] + probabilityInTemplate) / (float) (genusTotals[k] + 1));  
-									
-						if (count[k] != 0) {
-                            if (shortcuts) { out << k << '\t' << wordGenusProb[i][k] << '\t' ; }
-							numNotZero++;
-						}
+						wordProbs[k] = log((count[k] + probabilityInTemplate) / (float) (genusTotals[k] + 1));  
 					}
-					
-                    
-                    if (shortcuts) {
-                        out << endl;
-                        out2 << probabilityInTemplate << '\t' << numNotZero << '\t' << log(probabilityInTemplate) << endl;
-                    }
-                    
 				}
-                if (shortcuts) { out.close(); out2.close();  }
+                
+                if (shortcuts && !m->getControl_pressed()) { writeProbIndex(probFileName, version); }
 				
 				//read in new phylotree with less info. - its faster
 				ifstream phyloTreeTest(phyloTreeName.c_str());
@@ -160,6 +196,10 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 		generateWordPairDiffArr();
         if (m->getDebug()) { m->mothurOut("[DEBUG]: done generateWordPairDiffArr\n"); }
         
+        if (phyloTree != NULL) {
+            for (int i = 0; i < phyloTree->getNumNodes(); i++) { nodeParents.push_back(phyloTree->getParent(i)); nodeLevels.push_back(phyloTree->getLevel(i)); }
+        }
+        
         for (int i = 0; i < files.size(); i++) { delete files[i]; }
 			
 		m->mothurOut("DONE.\n");
@@ -175,6 +215,7 @@ Bayesian::~Bayesian() {
 	try {
         if (phyloTree != NULL) { delete phyloTree; }
         if (database != NULL) {  delete database; }
+        if (probIndex != NULL) {  delete probIndex; }
 	}
 	catch(exception& e) {
 		m->errorOut(e, "Bayesian", "~Bayesian");
@@ -229,7 +270,7 @@ string Bayesian::getTaxonomy(Sequence* seq, string& simpleTax, bool& flipped) {
 	
         if (m->getDebug()) {  m->mothurOut(seq->getName() + "\t"); }
         
-		tax = bootstrapResults(queryKmers, index, numToSelect, simpleTax);
+		tax = bootstrapResults(queryKmers, index, numToSelect, seq->getName(), simpleTax);
         
         if (m->getDebug()) {  m->mothurOut("\n"); }
 		
@@ -241,83 +282,49 @@ string Bayesian::getTaxonomy(Sequence* seq, string& simpleTax, bool& flipped) {
 	}
 }
 /**************************************************************************************************/
-string Bayesian::bootstrapResults(vector<int> kmers, int tax, int numToSelect, string& simpleTax) {
+string Bayesian::bootstrapResults(const vector<int>& kmers, int tax, int numToSelect, string seqName, string& simpleTax) {
 	try {
-				
-		map<int, int> confidenceScores; 
 		
-		//initialize confidences to 0 
-		int seqIndex = tax;
-		TaxNode seq = phyloTree->get(tax);
-		confidenceScores[tax] = 0;
+		//tax and its ancestors below the root are the classifications we need a confidence for
+		vector<int> taxPath;
+		for (int node = tax; nodeLevels[node] != 0; node = nodeParents[node]) { taxPath.push_back(node); }
+		vector<int> confidenceScores(taxPath.size(), 0);
 		
-		while (seq.level != 0) { //while you are not at the root
-			seqIndex = seq.parent;
-			confidenceScores[seqIndex] = 0;
-			seq = phyloTree->get(seq.parent);
-		}
-				
-		map<int, int>::iterator itBoot;
-		map<int, int>::iterator itBoot2;
-		map<int, int>::iterator itConvert;
-        
+		//draw the words of every iteration up front. The draws come from the query's own stream, so a query gets the
+		//same confidences whichever thread classifies it
         int numKmers = kmers.size()-1;
-        Utils util;
+        RandomStream random("classify.seqs", seqName);
+        vector<int> selected; selected.reserve((long long)iters * numToSelect);
+		for (int i = 0; i < iters; i++) {
+			for (int j = 0; j < numToSelect; j++) { selected.push_back(kmers[random.getRandomIndex(numKmers)]); }
+		}
+		
 		for (int i = 0; i < iters; i++) {
 			if (m->getControl_pressed()) { return "control"; }
 			
-            vector<int> temp;
-			for (int j = 0; j < numToSelect; j++) {
-				int index = util.getRandomIndex(numKmers);
-                
-				//add word to temp
-				temp.push_back(kmers[index]);
-			}
-            
 			//get taxonomy
-			int newTax = getMostProbableTaxonomy(temp);
-			//int newTax = 1;
-			TaxNode taxonomyTemp = phyloTree->get(newTax);
+			int newTax = getMostProbableTaxonomy(selected.data() + (long long)i * numToSelect, numToSelect);
 			
 			//add to confidence results
-			while (taxonomyTemp.level != 0) { //while you are not at the root
-				itBoot2 = confidenceScores.find(newTax); //is this a classification we already have a count on
-				
-				if (itBoot2 != confidenceScores.end()) { //this is a classification we need a confidence for
-					(itBoot2->second)++;
-				}
-				
-				newTax = taxonomyTemp.parent;
-				taxonomyTemp = phyloTree->get(newTax);
+			for (int node = newTax; nodeLevels[node] != 0; node = nodeParents[node]) { //while you are not at the root
+				vector<int>::iterator itPath = find(taxPath.begin(), taxPath.end(), node); //is this a classification we need a confidence for
+				if (itPath != taxPath.end()) { confidenceScores[itPath - taxPath.begin()]++; }
 			}
-	
 		}
 		
 		string confidenceTax = "";
 		simpleTax = "";
 		
-		int seqTaxIndex = tax;
-		TaxNode seqTax = phyloTree->get(tax);
-		
-        
-		while (seqTax.level != 0) { //while you are not at the root
-					
-				itBoot2 = confidenceScores.find(seqTaxIndex); //is this a classification we already have a count on
+		for (int i = 0; i < taxPath.size(); i++) {
+				int confidence = confidenceScores[i];
+				string taxName = phyloTree->getName(taxPath[i]);
 				
-				int confidence = 0;
-				if (itBoot2 != confidenceScores.end()) { //already in confidence scores
-					confidence = itBoot2->second;
-				}
-				
-                if (m->getDebug()) { m->mothurOut(seqTax.name + "(" + toString(((confidence/(float)iters) * 100)) + ");"); }
+                if (m->getDebug()) { m->mothurOut(taxName + "(" + toString(((confidence/(float)iters) * 100)) + ");"); }
             
 				if (((confidence/(float)iters) * 100) >= confidenceThreshold) {
-					confidenceTax = seqTax.name + "(" + toString(((confidence/(float)iters) * 100)) + ");" + confidenceTax;
-					simpleTax = seqTax.name + ";" + simpleTax;
+					confidenceTax = taxName + "(" + toString(((confidence/(float)iters) * 100)) + ");" + confidenceTax;
+					simpleTax = taxName + ";" + simpleTax;
 				}
-            
-				seqTaxIndex = seqTax.parent;
-				seqTax = phyloTree->get(seqTax.parent);
 		}
 		
 		if (confidenceTax == "") { confidenceTax = "unknown;"; simpleTax = "unknown;";  }
@@ -331,23 +338,30 @@ string Bayesian::bootstrapResults(vector<int> kmers, int tax, int numToSelect, s
 	}
 }
 /**************************************************************************************************/
-int Bayesian::getMostProbableTaxonomy(vector<int> queryKmer) {
+int Bayesian::getMostProbableTaxonomy(const vector<int>& queryKmer) {
+	return getMostProbableTaxonomy(queryKmer.data(), queryKmer.size());
+}
+/**************************************************************************************************/
+int Bayesian::getMostProbableTaxonomy(const int* queryKmer, int numQueryKmers) {
 	try {
 		int indexofGenus = 0;
+		long long numGenera = genusNodes.size();
+		
+		//the probability of each genus, one scratch per thread so the classifier can be shared
+		static thread_local vector<double> genusScores;
+		if (genusScores.size() < numGenera) { genusScores.resize(numGenera); }
+		double* scores = genusScores.data();
+		
+		if (useAVX2GenusScores())	{ sumGenusScoresAVX2(wordGenusProb, numGenera, queryKmer, numQueryKmers, scores);		}
+		else						{ sumGenusScoresScalar(wordGenusProb, numGenera, queryKmer, numQueryKmers, scores);	}
 		
 		double maxProbability = -1000000.0;
 		//find taxonomy with highest probability that this sequence is from it
-
-        for (int k = 0; k < genusNodes.size(); k++) {
-			//for each taxonomy calc its probability
-			
-			double prob = 0.0000;
-			for (int i = 0; i < queryKmer.size(); i++) { prob += wordGenusProb[queryKmer[i]][k]; }
-
+        for (int k = 0; k < numGenera; k++) {
 			//is this the taxonomy with the greatest probability?
-			if (prob > maxProbability) { 
+			if (scores[k] > maxProbability) { 
 				indexofGenus = genusNodes[k];
-				maxProbability = prob;
+				maxProbability = scores[k];
 			}
 		}
 			
@@ -408,8 +422,9 @@ void Bayesian::readProbFile(ifstream& in, ifstream& inNum, string inName, string
         in >> numKmers; util.gobble(in);
         //initialze probabilities
         
-        wordGenusProb.resize(numKmers);
-        for (int j = 0; j < wordGenusProb.size(); j++) {	wordGenusProb[j].resize(genusNodes.size());		}
+        int numGenera = genusNodes.size();
+        wordGenusProbData.resize((long long)numKmers * numGenera);
+        wordGenusProb = wordGenusProbData.data();
         
         int kmer, name, count;  count = 0;
         vector<int> num; num.resize(numKmers);
@@ -438,13 +453,13 @@ void Bayesian::readProbFile(ifstream& in, ifstream& inNum, string inName, string
             
             //set them all to zero value
             for (int i = 0; i < genusNodes.size(); i++) {
-                wordGenusProb[kmer][i] = log(zeroCountProb[kmer] / (float) (genusTotals[i]+1));
+                wordGenusProbData[(long long)kmer*numGenera + i] = log(zeroCountProb[kmer] / (float) (genusTotals[i]+1));
             }
            
             //get probs for nonzero values
             for (int i = 0; i < num[kmer]; i++) {
                 in >> name >> prob;
-                wordGenusProb[kmer][name] = prob;
+                wordGenusProbData[(long long)kmer*numGenera + name] = prob;
                 if (m->getDebug()) { m->mothurOut("[DEBUG]: " + toString(name) + '\t' + toString(prob) + '\t' + toString(kmer) + "\n"); }
             }
             
@@ -459,9 +474,61 @@ void Bayesian::readProbFile(ifstream& in, ifstream& inNum, string inName, string
 	}
 }
 /**************************************************************************************************/
-
-
-
-
-
-
+/**************************************************************************************************/
+//maps the probabilities from the binary prob file. The genera have to match the ones in the tree.train file.
+bool Bayesian::readProbIndex(string indexFileName) {
+	try{
+        probIndex = new ReferenceIndex(indexFileName);
+        
+        long long numInfo, numProbs, numNodes, numTotals, numWordProbs;
+        const uint64_t* info = probIndex->getArray<uint64_t>("wang.info", numInfo);
+        const float* probs = probIndex->getArray<float>("wang.wordGenusProb", numProbs);
+        const int* nodes = probIndex->getArray<int>("wang.genusNodes", numNodes);
+        const int* totals = probIndex->getArray<int>("wang.genusTotals", numTotals);
+        const float* wordProbs = probIndex->getArray<float>("wang.wordProb", numWordProbs);
+        
+        bool good = ((info != NULL) && (probs != NULL) && (nodes != NULL) && (totals != NULL) && (wordProbs != NULL) && (numInfo == 2));
+        if (good) { good = ((info[0] == numWordProbs) && (info[1] == genusNodes.size()) && (numProbs == (info[0] * info[1]))); }
+        if (good) { good = ((numNodes == genusNodes.size()) && equal(genusNodes.begin(), genusNodes.end(), nodes) && (numTotals == genusTotals.size()) && equal(genusTotals.begin(), genusTotals.end(), totals)); }
+        
+        if (!good) {
+            m->mothurOut("[ERROR]: " + indexFileName + " does not match the template taxonomy, please remove it so mothur can rebuild it.\n");
+            m->setControl_pressed(true); return false;
+        }
+        
+        numKmers = info[0];
+        wordGenusProb = probs;
+        
+        WordPairDiffArr.resize(numKmers);
+        for (int i = 0; i < numKmers; i++) { WordPairDiffArr[i].prob = wordProbs[i]; }
+        
+        return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "readProbIndex");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void Bayesian::writeProbIndex(string indexFileName, string version) {
+	try{
+        ReferenceIndexWriter indexFile(indexFileName, version);
+        
+        vector<uint64_t> info; info.push_back(numKmers); info.push_back(genusNodes.size());
+        vector<float> wordProbs(numKmers);
+        for (int i = 0; i < numKmers; i++) { wordProbs[i] = WordPairDiffArr[i].prob; }
+        
+        indexFile.addArray("wang.info", info);
+        indexFile.addArray("wang.genusNodes", genusNodes);
+        indexFile.addArray("wang.genusTotals", genusTotals);
+        indexFile.addArray("wang.wordProb", wordProbs);
+        indexFile.addArray("wang.wordGenusProb", wordGenusProbData);
+        
+        indexFile.close();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "writeProbIndex");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
@@ -12,6 +12,7 @@
 
 #include "mothur.h"
 #include "classify.h"
+#include "referenceindex.hpp"
 
 /**************************************************************************************************/
 
@@ -24,19 +25,26 @@ public:
 	string getTaxonomy(Sequence*, string&, bool&);
 	
 private:
-	vector< vector<float> > wordGenusProb;	//vector of maps from genus to probability
-										//wordGenusProb[0][392] = probability that a sequence within genus that's index in the tree is 392 would contain kmer 0;
+	const float* wordGenusProb;	//numKmers rows of genusNodes.size() log probabilities, kmer major
+								//wordGenusProb[0*genusNodes.size()+392] = probability that a sequence within genus that's index in the tree is 392 would contain kmer 0;
+	vector<float> wordGenusProbData;	//wordGenusProb when it's not mapped from the shortcut file
+	ReferenceIndex* probIndex;
 	
 	vector<int> genusTotals;
 	vector<int> genusNodes;  //indexes in phyloTree where genus' are located
 	
+	vector<int> nodeParents, nodeLevels; //parent and level of each node in phyloTree, so the bootstrap doesn't copy TaxNodes
+	
 	vector<diffPair> WordPairDiffArr; 
 	
 	int kmerSize, numKmers, confidenceThreshold, iters;
 	
-	string bootstrapResults(vector<int>, int, int, string&);
-	int getMostProbableTaxonomy(vector<int>);
+	string bootstrapResults(const vector<int>&, int, int, string, string&);
+	int getMostProbableTaxonomy(const vector<int>&);
+	int getMostProbableTaxonomy(const int*, int);
 	void readProbFile(ifstream&, ifstream&, string, string);
+	bool readProbIndex(string);
+	void writeProbIndex(string, string);
 	bool isReversed(vector<int>&);
 	vector<int> createWordIndexArr(Sequence*);
 	int generateWordPairDiffArr();
@@ -60,6 +60,8 @@ public:
 	int getMaxLevel()		{	return maxLevel;	}
 	int getNumSeqs()		{	return numSeqs;		}
 	int getNumNodes()		{	return (int)tree.size();	}
+	int getParent(int i)	{	return tree[i].parent;		}
+	int getLevel(int i)		{	return tree[i].level;		}
 	
 	bool ErrorCheck(vector<string>);
 	
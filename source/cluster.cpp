@@ -47,8 +47,7 @@ void Cluster::clusterNames(){
 	try {
 		if (mapWanted) {  updateMap();  }
 		
-		list->set(smallCol, list->get(smallRow)+','+list->get(smallCol));
-		list->set(smallRow, "");	
+		list->mergeBins(smallRow, smallCol);
 		list->setLabel(toString(smallDist));
     }
 	catch(exception& e) {
@@ -76,30 +75,29 @@ bool Cluster::update(double& cutOFF){
                 search = dMatrix->seqVec[smallRow][i].index;
                 
 				bool merged = false;
-				for (int j=0;j<nColCells;j++) {  //go through each distance the smallCol has looking for matching distance to find
-                    
-					if (dMatrix->seqVec[smallCol][j].index != smallRow) {  //if you are not the smallest distance
-						if (dMatrix->seqVec[smallCol][j].index == search) {  //we found a distance for the merge
-							foundCol[j] = 1;
-							merged = true;
-							changed = updateDistance(dMatrix->seqVec[smallCol][j], dMatrix->seqVec[smallRow][i]);
-                            dMatrix->updateCellCompliment(smallCol, j);
-							break;
-						}else if (dMatrix->seqVec[smallCol][j].index < search) { //we don't have a distance for this cell
-                            if (!util.isEqual(adjust, -1)) { //adjust
-                                merged = true;
-                                PDistCell value(search, adjust); //create a distance for the missing value
-                                int location = dMatrix->addCellSorted(smallCol, value);
-                                changed = updateDistance(dMatrix->seqVec[smallCol][location], dMatrix->seqVec[smallRow][i]);
-                                dMatrix->updateCellCompliment(smallCol, location);
-                                nColCells++;
-                                foundCol.push_back(0); //add a new found column
-                                //adjust value
-                                for (int k = foundCol.size()-1; k > location; k--) { foundCol[k] = foundCol[k-1]; }
-                                foundCol[location] = 1;
-                            }
-                            j+=nColCells;  //jump out of loop and remove cell below
-                        } 
+                //the smallCol's distances are sorted the same way, so look for the first one that is not larger than search
+                int j = lower_bound(dMatrix->seqVec[smallCol].begin(), dMatrix->seqVec[smallCol].end(), PDistCell(search, 0), compareIndexes) - dMatrix->seqVec[smallCol].begin();
+                if ((j < nColCells) && (dMatrix->seqVec[smallCol][j].index == smallRow)) { j++; } //if you are the smallest distance
+                
+                if (j < nColCells) {
+                    if (dMatrix->seqVec[smallCol][j].index == search) {  //we found a distance for the merge
+                        foundCol[j] = 1;
+                        merged = true;
+                        changed = updateDistance(dMatrix->seqVec[smallCol][j], dMatrix->seqVec[smallRow][i]);
+                        dMatrix->updateCellCompliment(smallCol, j);
+                    }else { //we don't have a distance for this cell
+                        if (!util.isEqual(adjust, -1)) { //adjust
+                            merged = true;
+                            PDistCell value(search, adjust); //create a distance for the missing value
+                            int location = dMatrix->addCellSorted(smallCol, value);
+                            changed = updateDistance(dMatrix->seqVec[smallCol][location], dMatrix->seqVec[smallRow][i]);
+                            dMatrix->updateCellCompliment(smallCol, location);
+                            nColCells++;
+                            foundCol.push_back(0); //add a new found column
+                            //adjust value
+                            for (int k = foundCol.size()-1; k > location; k--) { foundCol[k] = foundCol[k-1]; }
+                            foundCol[location] = 1;
+                        }
                     }
 				}
 				//if not merged it you need it for warning 
@@ -159,22 +157,10 @@ void Cluster::setMapWanted(bool f)  {
 		mapWanted = f;
 		
         //initialize map
+        nameBins.assign(list->getNameTable()->size(), -1);
 		for (int k = 0; k < list->getNumBins(); k++) {
-            
-            string names = list->get(k);
-            
-            //parse bin
-            string individual = "";
-            int binNameslength = names.size();
-            for(int j=0;j<binNameslength;j++){
-                if(names[j] == ','){
-                    seq2Bin[individual] = k;
-                    individual = "";				
-                }
-                else{  individual += names[j];  }
-            }
-            //get last name
-            seq2Bin[individual] = k;
+            const vector<unsigned int>& binIndexes = list->getIndexes(k);
+            for(int j=0;j<binIndexes.size();j++){ nameBins[binIndexes[j]] = k; }
 		}
 		
 	}
@@ -187,20 +173,8 @@ void Cluster::setMapWanted(bool f)  {
 void Cluster::updateMap() {
     try {
 		//update location of seqs in smallRow since they move to smallCol now
-		string names = list->get(smallRow);
-		
-        string individual = "";
-        int binNameslength = names.size();
-        for(int j=0;j<binNameslength;j++){
-            if(names[j] == ','){
-                seq2Bin[individual] = smallCol;
-                individual = "";				
-            }
-            else{  individual += names[j];  }
-        }
-        //get last name
-        seq2Bin[individual] = smallCol;		
-	
+        const vector<unsigned int>& binIndexes = list->getIndexes(smallRow);
+        for(int j=0;j<binIndexes.size();j++){ nameBins[binIndexes[j]] = smallCol; }
 	}
 	catch(exception& e) {
 		m->errorOut(e, "Cluster", "updateMap");
@@ -208,6 +182,21 @@ void Cluster::updateMap() {
 	}
 }
 /***********************************************************************/
+map<string, int> Cluster::getSeqtoBin() {
+    try {
+        map<string, int> seq2Bin;
+        std::shared_ptr<NameTable> nameTable = list->getNameTable();
+        for (int i = 0; i < nameBins.size(); i++) {
+            if (nameBins[i] != -1) { seq2Bin[nameTable->getName(i)] = nameBins[i]; }
+        }
+        return seq2Bin;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Cluster", "getSeqtoBin");
+		exit(1);
+	}
+}
+/***********************************************************************/
 
 
 
@@ -18,7 +18,7 @@ public:
     virtual bool update(double&);
 	virtual string getTag() = 0;
 	virtual void setMapWanted(bool m);  
-	virtual map<string, int> getSeqtoBin()  {  return seq2Bin;	}
+	virtual map<string, int> getSeqtoBin();
     
 protected:	    
 	virtual bool updateDistance(PDistCell& colCell, PDistCell& rowCell) = 0;
@@ -36,7 +36,7 @@ protected:
 	float smallDist, adjust;
 	bool mapWanted;
 	float cutoff;
-	map<string, int> seq2Bin;
+	vector<int> nameBins; //bin of each name, by the list's NameTable index
 	string method;
 	
 	ull nRowCells;
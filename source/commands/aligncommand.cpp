@@ -317,13 +317,13 @@ struct alignStruct {
         
         int longestBase = templateDB->getLongestBase();
         if (m->getDebug()) { m->mothurOut("[DEBUG]: template longest base = "  + toString(longestBase) + " \n");            }
-        if(al == "gotoh")            {    alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, longestBase);   }
-        else if(al == "needleman")    {    alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);         }
+        if(al == "gotoh")            {    alignment = new GotohSIMDOverlap(gapOpen, gapExtend, match, misMatch, longestBase);   }
+        else if(al == "needleman")    {    alignment = new NeedlemanSIMDOverlap(gapOpen, match, misMatch, longestBase);         }
         else if(al == "blast")        {    alignment = new BlastAlignment(gapOpen, gapExtend, match, misMatch);             }
         else if(al == "noalign")        {    alignment = new NoAlign();                                                     }
         else {
             m->mothurOut(al + " is not a valid alignment option. I will run the command using needleman.\n");
-            alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);
+            alignment = new NeedlemanSIMDOverlap(gapOpen, match, misMatch, longestBase);
         }
     }
     ~alignStruct() { delete alignment;  }
@@ -502,9 +502,10 @@ long long AlignCommand::createProcesses(string alignFileName, string reportFileN
 
         for (int i = 0; i < processors-1; i++) {
             
-            OutputWriter* threadAlignWriter = new OutputWriter(synchronizedOutputAlignFile);
-            OutputWriter* threadReportWriter = new OutputWriter(synchronizedOutputReportFile);
-            OutputWriter* threadAccnosWriter = new OutputWriter(synchronizedOutputAccnosFile);
+            //ordered by the piece of the fasta file, so the output is in input order
+            OutputWriter* threadAlignWriter = new OutputWriter(synchronizedOutputAlignFile, i+1);
+            OutputWriter* threadReportWriter = new OutputWriter(synchronizedOutputReportFile, i+1);
+            OutputWriter* threadAccnosWriter = new OutputWriter(synchronizedOutputAccnosFile, i+1);
 
             
             alignStruct* dataBundle = new alignStruct(lines[i+1], threadAlignWriter, threadReportWriter, threadAccnosWriter, filename, templateDB, align, match, misMatch, gapOpen, gapExtend, threshold, flip, kmerSize, search);
@@ -513,9 +514,9 @@ long long AlignCommand::createProcesses(string alignFileName, string reportFileN
             workerThreads.push_back(new std::thread(alignDriver, dataBundle));
          }
         
-        OutputWriter* threadAlignWriter = new OutputWriter(synchronizedOutputAlignFile);
-        OutputWriter* threadReportWriter = new OutputWriter(synchronizedOutputReportFile);
-        OutputWriter* threadAccnosWriter = new OutputWriter(synchronizedOutputAccnosFile);
+        OutputWriter* threadAlignWriter = new OutputWriter(synchronizedOutputAlignFile, 0);
+        OutputWriter* threadReportWriter = new OutputWriter(synchronizedOutputReportFile, 0);
+        OutputWriter* threadAccnosWriter = new OutputWriter(synchronizedOutputAccnosFile, 0);
         
         alignStruct* dataBundle = new alignStruct(lines[0], threadAlignWriter, threadReportWriter, threadAccnosWriter, filename, templateDB, align, match, misMatch, gapOpen, gapExtend, threshold, flip, kmerSize, search);
         alignDriver(dataBundle);
@@ -16,6 +16,7 @@
 #include "sequence.hpp"
 #include "gotohoverlap.hpp"
 #include "needlemanoverlap.hpp"
+#include "simdoverlap.hpp"
 #include "blastalign.hpp"
 #include "noalign.hpp"
 #include "nast.hpp"
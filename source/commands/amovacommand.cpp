@@ -10,6 +10,7 @@
 #include "amovacommand.h"
 #include "readphylipvector.h"
 #include "designmap.h"
+#include "permutationtest.hpp"
 
 
 
@@ -21,6 +22,8 @@ vector<string> AmovaCommand::setParameters(){
 		CommandParameter pphylip("phylip", "InputTypes", "", "", "none", "none", "none","amova",false,true,true); parameters.push_back(pphylip);
 		CommandParameter piters("iters", "Number", "", "1000", "", "", "","",false,false); parameters.push_back(piters);
 		CommandParameter palpha("alpha", "Number", "", "0.05", "", "", "","",false,false); parameters.push_back(palpha);
+        CommandParameter pearlystop("earlystop", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pearlystop);
+        CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -49,6 +52,8 @@ string AmovaCommand::getHelpString(){
 		helpString += "The design parameter allows you to assign your samples to groups when you are running amova. It is required.\n";
         helpString += "The sets parameter allows you to specify which of the sets in your designfile you would like to analyze. The set names are separated by dashes. The default is all sets in the design file.\n";
 		helpString += "The iters parameter allows you to set number of randomization for the P value.  The default is 1000.\n";
+        helpString += "The earlystop parameter allows you to stop the randomizations once this many have scored at least as extreme as your data. The P value is then estimated from the randomizations run, so large P values are found quickly. The default is 0, meaning run all the iters.\n";
+        helpString += "The processors parameter allows you to specify the number of processors to use for the randomizations. The default is all available.\n";
 		helpString += "The amova command should be in the following format: amova(phylip=file.dist, design=file.design).\n";
 		
         getCommonQuestions();
@@ -133,6 +138,13 @@ AmovaCommand::AmovaCommand(string option) {
 			if (temp == "not found") { temp = "0.05"; }
 			util.mothurConvert(temp, experimentwiseAlpha); 
             
+            temp = validParameter.valid(parameters, "earlystop");
+			if (temp == "not found") { temp = "0"; }
+			util.mothurConvert(temp, earlyStop);
+            
+            temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+            processors = current->setProcessors(temp);
+            
             string sets = validParameter.valid(parameters, "sets");			
 			if (sets == "not found") { sets = ""; }
 			else { 
@@ -208,7 +220,9 @@ int AmovaCommand::execute(){
 		util.openOutputFile(AMOVAFileName, AMOVAFile);
 		outputNames.push_back(AMOVAFileName); outputTypes["amova"].push_back(AMOVAFileName);
 		
-		double fullANOVAPValue = runAMOVA(AMOVAFile, origGroupSampleMap, experimentwiseAlpha);
+		PermutationTest permutationTest("amova", iters, processors, earlyStop);
+		
+		double fullANOVAPValue = runAMOVA(AMOVAFile, permutationTest, origGroupSampleMap, experimentwiseAlpha);
 		if(fullANOVAPValue <= experimentwiseAlpha && numGroups > 2){
 			
 			int numCombos = numGroups * (numGroups-1) / 2;
@@ -225,7 +239,7 @@ int AmovaCommand::execute(){
 					pairwiseGroupSampleMap[itA->first] = itA->second;
 					pairwiseGroupSampleMap[itB->first] = itB->second;
 					
-					runAMOVA(AMOVAFile, pairwiseGroupSampleMap, pairwiseAlpha);
+					runAMOVA(AMOVAFile, permutationTest, pairwiseGroupSampleMap, pairwiseAlpha);
 				}			
 			}
 			m->mothurOut("Experiment-wise error rate: " + toString(experimentwiseAlpha) + '\n');
@@ -252,31 +266,26 @@ int AmovaCommand::execute(){
 
 //**********************************************************************************************************************
 
-double AmovaCommand::runAMOVA(ofstream& AMOVAFile, map<string, vector<int> > groupSampleMap, double alpha) {
+double AmovaCommand::runAMOVA(ofstream& AMOVAFile, PermutationTest& permutationTest, map<string, vector<int> > groupSampleMap, double alpha) {
 	try {
 		map<string, vector<int> >::iterator it;
 
 		int numGroups = groupSampleMap.size();
-		int totalNumSamples = 0;
 
-		for(it = groupSampleMap.begin();it!=groupSampleMap.end();it++){
-			totalNumSamples += it->second.size();			
-		}
+		vector<int> samples, groupStarts;
+		PermutationTest::getSamplesByGroup(groupSampleMap, samples, groupStarts);
+		int totalNumSamples = samples.size();
 
 		double ssTotalOrig = calcSSTotal(groupSampleMap);
-		double ssWithinOrig = calcSSWithin(groupSampleMap);
+		double ssWithinOrig = calcSSWithin(samples, groupStarts);
 		double ssAmongOrig = ssTotalOrig - ssWithinOrig;
 		
-		double counter = 0;
-		for(int i=0;i<iters;i++){
-			map<string, vector<int> > randomizedGroup = getRandomizedGroups(groupSampleMap);
-			double ssWithinRand = calcSSWithin(randomizedGroup);
-			if(ssWithinRand <= ssWithinOrig){	counter++;	}
-		}
+		PermutationTest::GroupStatistic ssWithinRand = [&](const vector<int>& randomSamples, const vector<int>& starts) { return calcSSWithin(randomSamples, starts); };
 		
-		double pValue = (double)counter / (double) iters;
+		double pValue = permutationTest.getPValue(ssWithinRand, samples, groupStarts, ssWithinOrig, PermutationTest::atMost);
+		int numRun = permutationTest.getNumRun();
 		string pString = "";
-		if(pValue < 1/(double)iters){	pString = '<' + toString(1/(double)iters);	}
+		if(pValue < 1/(double)numRun){	pString = '<' + toString(1/(double)numRun);	}
 		else						{	pString = toString(pValue);					}
 		
         vector<string> sampleNames;
@@ -322,38 +331,6 @@ double AmovaCommand::runAMOVA(ofstream& AMOVAFile, map<string, vector<int> > gro
 
 //**********************************************************************************************************************
 
-map<string, vector<int> > AmovaCommand::getRandomizedGroups(map<string, vector<int> > origMapping){
-	try{
-		vector<int> sampleIndices;
-		vector<int> samplesPerGroup;
-		
-		map<string, vector<int> >::iterator it;
-		for(it=origMapping.begin();it!=origMapping.end();it++){
-			vector<int> indices = it->second;
-			samplesPerGroup.push_back(indices.size());
-			sampleIndices.insert(sampleIndices.end(), indices.begin(), indices.end());
-		}
-		
-		util.mothurRandomShuffle(sampleIndices);
-		
-		int index = 0;
-		map<string, vector<int> > randomizedGroups = origMapping;
-		for(it=randomizedGroups.begin();it!=randomizedGroups.end();it++){
-			for(int i=0;i<it->second.size();i++){
-				it->second[i] = sampleIndices[index++];				
-			}
-		}
-
-		return randomizedGroups;		
-	}
-	catch (exception& e) {
-		m->errorOut(e, "AmovaCommand", "getRandomizedGroups");
-		exit(1);
-	}
-}
-
-//**********************************************************************************************************************
-
 double AmovaCommand::calcSSTotal(map<string, vector<int> >& groupSampleMap) {
 	try {
 		
@@ -386,22 +363,20 @@ double AmovaCommand::calcSSTotal(map<string, vector<int> >& groupSampleMap) {
 
 //**********************************************************************************************************************
 
-double AmovaCommand::calcSSWithin(map<string, vector<int> >& groupSampleMap) {
+//group g's samples are samples[groupStarts[g]] to samples[groupStarts[g+1]-1]
+double AmovaCommand::calcSSWithin(const vector<int>& samples, const vector<int>& groupStarts) {
 	try {
 
 		double ssWithin = 0.0;
 		
-		map<string, vector<int> >::iterator it;
-		for(it=groupSampleMap.begin();it!=groupSampleMap.end();it++){
+		for(int g=0;g<groupStarts.size()-1;g++){
 			
 			double withinGroup = 0;
 			
-			vector<int> samples = it->second;
-			
-			for(int i=0;i<samples.size();i++){
+			for(int i=groupStarts[g];i<groupStarts[g+1];i++){
 				int row = samples[i];
 
-				for(int j=0;j<samples.size();j++){
+				for(int j=groupStarts[g];j<groupStarts[g+1];j++){
 					int col = samples[j];
 
 					if(col < row){
@@ -411,7 +386,7 @@ double AmovaCommand::calcSSWithin(map<string, vector<int> >& groupSampleMap) {
 				}
 			}
 
-			ssWithin += withinGroup / samples.size();
+			ssWithin += withinGroup / (groupStarts[g+1] - groupStarts[g]);
 		}
 
 		return ssWithin;
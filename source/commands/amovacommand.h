@@ -12,6 +12,7 @@
 
 #include "command.hpp"
 class DesignMap;
+class PermutationTest;
 
 class AmovaCommand : public Command {
 	
@@ -33,10 +34,9 @@ public:
 	void help() { m->mothurOut(getHelpString()); }
 	
 private:
-	double runAMOVA(ofstream&, map<string, vector<int> >, double);
-	double calcSSWithin(map<string, vector<int> >&);
+	double runAMOVA(ofstream&, PermutationTest&, map<string, vector<int> >, double);
+	double calcSSWithin(const vector<int>&, const vector<int>&); //samples by group, where each group starts
 	double calcSSTotal(map<string, vector<int> >&);
-	map<string, vector<int> > getRandomizedGroups(map<string, vector<int> >);
 
 	bool abort;
 	vector<string> outputNames, Sets;
@@ -44,7 +44,7 @@ private:
 	string inputDir, designFileName, phylipFileName;
 	DesignMap* designMap;
 	vector< vector<double> > distanceMatrix;
-	int iters;
+	int iters, earlyStop, processors;
 	double experimentwiseAlpha;
 };
 
@@ -11,6 +11,7 @@
 #include "inputdata.h"
 #include "readphylipvector.h"
 #include "designmap.h"
+#include "permutationtest.hpp"
 
 //**********************************************************************************************************************
 vector<string> AnosimCommand::setParameters(){	
@@ -19,6 +20,8 @@ vector<string> AnosimCommand::setParameters(){
 		CommandParameter pphylip("phylip", "InputTypes", "", "", "none", "none", "none","anosim",false,true,true); parameters.push_back(pphylip);
 		CommandParameter piters("iters", "Number", "", "1000", "", "", "","",false,false); parameters.push_back(piters);
 		CommandParameter palpha("alpha", "Number", "", "0.05", "", "", "","",false,false); parameters.push_back(palpha);
+        CommandParameter pearlystop("earlystop", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pearlystop);
+        CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -43,10 +46,12 @@ string AnosimCommand::getHelpString(){
 		string helpString = "";
 		helpString += "Referenced: Clarke, K. R. (1993). Non-parametric multivariate analysis of changes in community structure.   _Australian Journal of Ecology_ 18, 117-143.\n";
 		helpString += "The anosim command outputs a .anosim file. \n";
-		helpString += "The anosim command parameters are phylip, iters, and alpha.  The phylip and design parameters are required, unless you have valid current files.\n";
+		helpString += "The anosim command parameters are phylip, iters, alpha, earlystop and processors.  The phylip and design parameters are required, unless you have valid current files.\n";
 		helpString += "The design parameter allows you to assign your samples to groups when you are running anosim. It is required. \n";
 		helpString += "The design file looks like the group file.  It is a 2 column tab delimited file, where the first column is the sample name and the second column is the group the sample belongs to.\n";
 		helpString += "The iters parameter allows you to set number of randomization for the P value.  The default is 1000. \n";
+        helpString += "The earlystop parameter allows you to stop the randomizations once this many have scored at least as extreme as your data. The P value is then estimated from the randomizations run, so large P values are found quickly. The default is 0, meaning run all the iters.\n";
+        helpString += "The processors parameter allows you to specify the number of processors to use for the randomizations. The default is all available.\n";
 		helpString += "The anosim command should be in the following format: anosim(phylip=file.dist, design=file.design).\n";
 		return helpString;
 	}
@@ -112,6 +117,13 @@ AnosimCommand::AnosimCommand(string option) {
 			temp = validParameter.valid(parameters, "alpha");
 			if (temp == "not found") { temp = "0.05"; }
 			util.mothurConvert(temp, experimentwiseAlpha); 
+            
+            temp = validParameter.valid(parameters, "earlystop");
+			if (temp == "not found") { temp = "0"; }
+			util.mothurConvert(temp, earlyStop);
+            
+            temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+            processors = current->setProcessors(temp);
 		}
 		
 	}
@@ -165,7 +177,9 @@ int AnosimCommand::execute(){
 		ANOSIMFile << "comparison\tR-value\tP-value\n";
 		
 		
-		double fullANOSIMPValue = runANOSIM(ANOSIMFile, distanceMatrix, origGroupSampleMap, experimentwiseAlpha);
+		PermutationTest permutationTest("anosim", iters, processors, earlyStop);
+		
+		double fullANOSIMPValue = runANOSIM(ANOSIMFile, permutationTest, distanceMatrix, origGroupSampleMap, experimentwiseAlpha);
 		
 		
 		if(fullANOSIMPValue <= experimentwiseAlpha && numGroups > 2){
@@ -202,7 +216,7 @@ int AnosimCommand::execute(){
 						}
 					}
 
-					runANOSIM(ANOSIMFile, subDistMatrix, subGroupSampleMap, pairwiseAlpha);
+					runANOSIM(ANOSIMFile, permutationTest, subDistMatrix, subGroupSampleMap, pairwiseAlpha);
 
 				}
 			}
@@ -230,22 +244,21 @@ int AnosimCommand::execute(){
 }
 //**********************************************************************************************************************
 
-double AnosimCommand::runANOSIM(ofstream& ANOSIMFile, vector<vector<double> > dMatrix, map<string, vector<int> > groupSampleMap, double alpha) {
+double AnosimCommand::runANOSIM(ofstream& ANOSIMFile, PermutationTest& permutationTest, vector<vector<double> > dMatrix, map<string, vector<int> > groupSampleMap, double alpha) {
 	try {
 
+		vector<int> samples, groupStarts;
+		PermutationTest::getSamplesByGroup(groupSampleMap, samples, groupStarts);
+
 		vector<vector<double> > rankMatrix = convertToRanks(dMatrix);
-		double RValue = calcR(rankMatrix, groupSampleMap);
+		double RValue = calcR(rankMatrix, samples, groupStarts);
 		
-		int pCount = 0;
-		for(int i=0;i<iters;i++){
-			map<string, vector<int> > randGroupSampleMap = getRandomizedGroups(groupSampleMap);
-			double RValueRand = calcR(rankMatrix, randGroupSampleMap);
-			if(RValue <= RValueRand){	pCount++;	}
-		}
+		PermutationTest::GroupStatistic RValueRand = [&](const vector<int>& randomSamples, const vector<int>& starts) { return calcR(rankMatrix, randomSamples, starts); };
 
-		double pValue = (double)pCount / (double) iters;
+		double pValue = permutationTest.getPValue(RValueRand, samples, groupStarts, RValue, PermutationTest::atLeast);
+		int numRun = permutationTest.getNumRun();
 		string pString = "";
-		if(pValue < 1/(double)iters){	pString = '<' + toString(1/(double)iters);	}
+		if(pValue < 1/(double)numRun){	pString = '<' + toString(1/(double)numRun);	}
 		else						{	pString = toString(pValue);					}
 		
 		
@@ -274,24 +287,21 @@ double AnosimCommand::runANOSIM(ofstream& ANOSIMFile, vector<vector<double> > dM
 
 //**********************************************************************************************************************
 
-double AnosimCommand::calcR(vector<vector<double> > rankMatrix, map<string, vector<int> > groupSampleMap){
+//group g's samples are samples[groupStarts[g]] to samples[groupStarts[g+1]-1]
+double AnosimCommand::calcR(const vector<vector<double> >& rankMatrix, const vector<int>& samples, const vector<int>& groupStarts){
 	try {
 
-		int numSamples = 0;
-		for(map<string, vector<int> >::iterator it=groupSampleMap.begin();it!=groupSampleMap.end();it++){
-			numSamples += it->second.size();
-		}
-		
+		int numSamples = samples.size();
+		int numGroups = groupStarts.size() - 1;
 		
 		double within = 0.0;
 		int numWithinComps = 0;		
 		
-		for(map<string, vector<int> >::iterator it=groupSampleMap.begin();it!=groupSampleMap.end();it++){
-			vector<int> indices = it->second;
-			for(int i=0;i<indices.size();i++){
-				for(int j=0;j<i;j++){
-					if(indices[i] > indices[j])	{	within += rankMatrix[indices[i]][indices[j]];	}
-					else						{	within += rankMatrix[indices[j]][indices[i]];	}
+		for(int g=0;g<numGroups;g++){
+			for(int i=groupStarts[g];i<groupStarts[g+1];i++){
+				for(int j=groupStarts[g];j<i;j++){
+					if(samples[i] > samples[j])	{	within += rankMatrix[samples[i]][samples[j]];	}
+					else						{	within += rankMatrix[samples[j]][samples[i]];	}
 					numWithinComps++;
 				}
 			}
@@ -302,17 +312,13 @@ double AnosimCommand::calcR(vector<vector<double> > rankMatrix, map<string, vect
 		double between = 0.0;
 		int numBetweenComps = 0;
 
-		map<string, vector<int> >::iterator itB;
-		
-		for(map<string, vector<int> >::iterator itA=groupSampleMap.begin();itA!=groupSampleMap.end();itA++){
+		for(int gA=0;gA<numGroups;gA++){
 
-			for(int i=0;i<itA->second.size();i++){
-				int A = itA->second[i];
-				map<string, vector<int> >::iterator itB = itA;
-				itB++;
-				for(;itB!=groupSampleMap.end();itB++){
-					for(int j=0;j<itB->second.size();j++){
-						int B = itB->second[j];
+			for(int i=groupStarts[gA];i<groupStarts[gA+1];i++){
+				int A = samples[i];
+				for(int gB=gA+1;gB<numGroups;gB++){
+					for(int j=groupStarts[gB];j<groupStarts[gB+1];j++){
+						int B = samples[j];
 						if(A>B)	{	between += rankMatrix[A][B];	}
 						else	{	between += rankMatrix[B][A];	}
 						numBetweenComps++;
@@ -390,37 +396,5 @@ vector<vector<double> > AnosimCommand::convertToRanks(vector<vector<double> > di
 
 //**********************************************************************************************************************
 
-map<string, vector<int> > AnosimCommand::getRandomizedGroups(map<string, vector<int> > origMapping){
-	try{
-		vector<int> sampleIndices;
-		vector<int> samplesPerGroup;
-		
-		map<string, vector<int> >::iterator it;
-		for(it=origMapping.begin();it!=origMapping.end();it++){
-			vector<int> indices = it->second;
-			samplesPerGroup.push_back(indices.size());
-			sampleIndices.insert(sampleIndices.end(), indices.begin(), indices.end());
-		}
-		
-		util.mothurRandomShuffle(sampleIndices);
-		
-		int index = 0;
-		map<string, vector<int> > randomizedGroups = origMapping;
-		for(it=randomizedGroups.begin();it!=randomizedGroups.end();it++){
-			for(int i=0;i<it->second.size();i++){
-				it->second[i] = sampleIndices[index++];				
-			}
-		}
-		
-		return randomizedGroups;		
-	}
-	catch (exception& e) {
-		m->errorOut(e, "AnosimCommand", "randomizeGroups");
-		exit(1);
-	}
-}
-
-//**********************************************************************************************************************
-
 
 
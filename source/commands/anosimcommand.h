@@ -14,6 +14,7 @@
 #include "command.hpp"
 
 class DesignMap;
+class PermutationTest;
 
 class AnosimCommand : public Command {
 	
@@ -39,13 +40,12 @@ private:
 	string inputDir, designFileName, phylipFileName;
 	
 	vector<vector<double> > convertToRanks(vector<vector<double> >);
-	double calcR(vector<vector<double> >, map<string, vector<int> >);
-	map<string, vector<int> > getRandomizedGroups(map<string, vector<int> >);
-	double runANOSIM(ofstream&, vector<vector<double> >, map<string, vector<int> >, double);
+	double calcR(const vector<vector<double> >&, const vector<int>&, const vector<int>&); //ranks, samples by group, where each group starts
+	double runANOSIM(ofstream&, PermutationTest&, vector<vector<double> >, map<string, vector<int> >, double);
 	
 	vector< vector<double> > distanceMatrix;
 	vector<string> outputNames;
-	int iters;
+	int iters, earlyStop, processors;
 	double experimentwiseAlpha;
 	vector< vector<string> > namesOfGroupCombos;
 	
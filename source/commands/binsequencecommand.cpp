@@ -265,9 +265,8 @@ int BinSeqCommand::process(ListVector* list, FastaMap& fasta) {
             
             if (m->getControl_pressed()) {  return 1; }
             
-            string binnames = list->get(i);
             vector<string> names;
-            util.splitAtComma(binnames, names);
+            list->getNames(i, names);
             
             for (int j = 0; j < names.size(); j++) {
                 string name = names[j];
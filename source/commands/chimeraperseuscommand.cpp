@@ -28,6 +28,7 @@ vector<string> ChimeraPerseusCommand::setParameters(){
 		CommandParameter pcutoff("cutoff", "Number", "", "0.5", "", "", "","",false,false); parameters.push_back(pcutoff);
 		CommandParameter palpha("alpha", "Number", "", "-5.54", "", "", "","",false,false); parameters.push_back(palpha);
 		CommandParameter pbeta("beta", "Number", "", "0.33", "", "", "","",false,false); parameters.push_back(pbeta);
+        CommandParameter pmaxp("maxp", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pmaxp);
         
         abort = false; calledHelp = false;
         
@@ -50,7 +51,7 @@ string ChimeraPerseusCommand::getHelpString(){
 	try {
 		string helpString = "";
 		helpString += "The chimera.perseus command reads a fastafile and namefile or countfile and outputs potentially chimeric sequences.\n";
-		helpString += "The chimera.perseus command parameters are fasta, name, group, cutoff, processors, dereplicate, alpha and beta.\n";
+		helpString += "The chimera.perseus command parameters are fasta, name, group, cutoff, processors, dereplicate, alpha, beta and maxp.\n";
 		helpString += "The fasta parameter allows you to enter the fasta file containing your potentially chimeric sequences, and is required, unless you have a valid current fasta file. \n";
 		helpString += "The name parameter allows you to provide a name file associated with your fasta file.\n";
         helpString += "The count parameter allows you to provide a count file associated with your fasta file. A count or name file is required. When you use a count file with group info and dereplicate=T, mothur will create a *.pick.count_table file containing seqeunces after chimeras are removed.\n";
@@ -59,6 +60,7 @@ string ChimeraPerseusCommand::getHelpString(){
         helpString += "If the dereplicate parameter is false, then if one group finds the seqeunce to be chimeric, then all groups find it to be chimeric, default=f.\n";
 		helpString += "The alpha parameter ....  The default is -5.54. \n";
 		helpString += "The beta parameter ....  The default is 0.33. \n";
+        helpString += "The maxp parameter limits the more abundant sequences each sequence is aligned to. The maxp sequences sharing the most 8-mers with the left half of the sequence and the maxp sharing the most with its right half are aligned, the rest are skipped. The default is 0, which aligns all of them. \n";
 		helpString += "The cutoff parameter ....  The default is 0.50. \n";
 		helpString += "The chimera.perseus command should be in the following format: \n";
 		helpString += "chimera.perseus(fasta=yourFastaFile, name=yourNameFile) \n";
@@ -160,6 +162,9 @@ ChimeraPerseusCommand::ChimeraPerseusCommand(string option)  {
 			temp = validParameter.valid(parameters, "beta");	if (temp == "not found"){	temp = "0.33";	}
 			util.mothurConvert(temp, beta);
             
+			temp = validParameter.valid(parameters, "maxp");	if (temp == "not found"){	temp = "0";	}
+			util.mothurConvert(temp, maxp);
+            
 			temp = validParameter.valid(parameters, "dereplicate");	
 			if (temp == "not found") { temp = "false";			}
 			dups = util.isTrue(temp);
@@ -194,12 +199,17 @@ struct perseusData {
     MothurOut* m;
     vector<seqData> sequences;
     string group;
-    int count, numChimeras;
+    int count, numChimeras, processors, maxp;
     string chimeraFileName;
     string accnosFileName;
     double alpha, beta, cutoff;
     
-    perseusData(string cf, string ac, double a, double b, double c){
+    //shared by the threads checking the group's sequences
+    vector<vector<double> > correctModel, binMatrix;
+    vector<vector<int> > kmers; //distinct 8-mers of each sequence, only filled when maxp is set
+    vector<bool> chimeras;
+    
+    perseusData(string cf, string ac, double a, double b, double c, int p, int mp){
         m = MothurOut::getInstance();
         count = 0;
         numChimeras = 0;
@@ -208,13 +218,200 @@ struct perseusData {
         alpha = a;
         beta = b;
         cutoff = c;
+        processors = p;
+        maxp = mp;
     }
 };
 //**********************************************************************************************************************
-//void driver(string chimeraFileName, vector<seqData>& sequences, string accnosFileName, int& numChimeras){
+static const int perseusKmerSize = 8;
+
+vector<int> getKmers(const string& seq, int start, int end){
+    vector<int> kmers;
+    int code = 0, numBases = 0;
+    for (int i = start; i < end; i++) {
+        int base = 0;
+        switch (seq[i]) {
+            case 'A': base = 0; break;
+            case 'C': base = 1; break;
+            case 'G': base = 2; break;
+            case 'T': base = 3; break;
+            default: numBases = 0; continue;
+        }
+        code = ((code << 2) | base) & ((1 << (2*perseusKmerSize)) - 1);
+        if (++numBases >= perseusKmerSize) { kmers.push_back(code); }
+    }
+    sort(kmers.begin(), kmers.end());
+    kmers.erase(unique(kmers.begin(), kmers.end()), kmers.end());
+    return kmers;
+}
+//**********************************************************************************************************************
+//keeps the maxp parents sharing the most 8-mers with the left half of the query and the maxp sharing the most with
+//its right half, the other parents are restricted so they are never aligned
+void pruneParents(perseusData* params, int query, int numParents, vector<bool>& restricted, vector<char>& marks){
+    try {
+        const string& seq = params->sequences[query].sequence;
+        vector<int> leftKmers = getKmers(seq, 0, seq.length() / 2);
+        vector<int> rightKmers = getKmers(seq, seq.length() / 2, seq.length());
+        for (int k = 0; k < leftKmers.size(); k++) { marks[leftKmers[k]] |= 1; }
+        for (int k = 0; k < rightKmers.size(); k++) { marks[rightKmers[k]] |= 2; }
+        
+        vector<pair<int, int> > leftShared, rightShared; //-shared kmers, parent
+        for (int i = 0; i < numParents; i++) {
+            if (restricted[i]) { continue; }
+            int left = 0, right = 0;
+            const vector<int>& parentKmers = params->kmers[i];
+            for (int k = 0; k < parentKmers.size(); k++) {
+                char mark = marks[parentKmers[k]];
+                if (mark & 1) { left++;  }
+                if (mark & 2) { right++; }
+            }
+            leftShared.push_back(pair<int, int>(-left, i));
+            rightShared.push_back(pair<int, int>(-right, i));
+        }
+        
+        for (int k = 0; k < leftKmers.size(); k++) { marks[leftKmers[k]] = 0; }
+        for (int k = 0; k < rightKmers.size(); k++) { marks[rightKmers[k]] = 0; }
+        
+        if (leftShared.size() <= params->maxp) { return; }
+        
+        partial_sort(leftShared.begin(), leftShared.begin()+params->maxp, leftShared.end());
+        partial_sort(rightShared.begin(), rightShared.begin()+params->maxp, rightShared.end());
+        
+        vector<bool> keep(numParents, false);
+        for (int k = 0; k < params->maxp; k++) { keep[leftShared[k].second] = true; keep[rightShared[k].second] = true; }
+        for (int i = 0; i < numParents; i++) { if (!keep[i]) { restricted[i] = true; } }
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "ChimeraPerseusCommand", "pruneParents");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+//checks sequence i against the more abundant sequences that are not chimeras, numParents of them come first in the
+//frequency order. Returns the sequence's line of the chimera file
+string checkSequence(perseusData* params, Perseus& myPerseus, int i, int numParents, vector<char>& marks, bool& isChimera){
+    try {
+        isChimera = false;
+        int numSeqs = params->sequences.size();
+        
+        vector<bool> restricted = params->chimeras;
+        if (params->maxp > 0) { pruneParents(params, i, numParents, restricted, marks); }
+        
+        vector<vector<int> > leftDiffs(numSeqs);
+        vector<vector<int> > leftMaps(numSeqs);
+        vector<vector<int> > rightDiffs(numSeqs);
+        vector<vector<int> > rightMaps(numSeqs);
+        
+        vector<int> singleLeft, bestLeft;
+        vector<int> singleRight, bestRight;
+        
+        int bestSingleIndex, bestSingleDiff;
+        vector<pwAlign> alignments(numSeqs);
+        
+        int comparisons = myPerseus.getAlignments(i, params->sequences, alignments, leftDiffs, leftMaps, rightDiffs, rightMaps, bestSingleIndex, bestSingleDiff, restricted);
+        if (params->m->getControl_pressed()) { return ""; }
+        
+        int minMismatchToChimera, leftParentBi, rightParentBi, breakPointBi;
+        
+        string dummyA, dummyB;
+        ostringstream chimeraLine;
+        
+        if (params->sequences[i].sequence.size() < 3) {
+            chimeraLine << i << '\t' << params->sequences[i].seqName << "\t0\t0\tNull\t0\t0\t0\tNull\tNull\t0.0\t0.0\t0.0\t0\t0\t0\t0.0\t0.0\tgood" << endl;
+        }else if(comparisons >= 2){
+            minMismatchToChimera = myPerseus.getChimera(params->sequences, leftDiffs, rightDiffs, leftParentBi, rightParentBi, breakPointBi, singleLeft, bestLeft, singleRight, bestRight, restricted);
+            if (params->m->getControl_pressed()) { return ""; }
+            
+            int minMismatchToTrimera = numeric_limits<int>::max();
+            int leftParentTri, middleParentTri, rightParentTri, breakPointTriA, breakPointTriB;
+            
+            if(minMismatchToChimera >= 3 && comparisons >= 3){
+                minMismatchToTrimera = myPerseus.getTrimera(params->sequences, leftDiffs, leftParentTri, middleParentTri, rightParentTri, breakPointTriA, breakPointTriB, singleLeft, bestLeft, singleRight, bestRight, restricted);
+                if (params->m->getControl_pressed()) { return ""; }
+            }
+            
+            double singleDist = myPerseus.modeledPairwiseAlignSeqs(params->sequences[i].sequence, params->sequences[bestSingleIndex].sequence, dummyA, dummyB, params->correctModel);
+            
+            if (params->m->getControl_pressed()) { return ""; }
+            
+            string type;
+            string chimeraRefSeq;
+            
+            if(minMismatchToChimera - minMismatchToTrimera >= 3){
+                type = "trimera";
+                chimeraRefSeq = myPerseus.stitchTrimera(alignments, leftParentTri, middleParentTri, rightParentTri, breakPointTriA, breakPointTriB, leftMaps, rightMaps);
+            }
+            else{
+                type = "chimera";
+                chimeraRefSeq = myPerseus.stitchBimera(alignments, leftParentBi, rightParentBi, breakPointBi, leftMaps, rightMaps);
+            }
+            
+            if (params->m->getControl_pressed()) { return ""; }
+            
+            double chimeraDist = myPerseus.modeledPairwiseAlignSeqs(params->sequences[i].sequence, chimeraRefSeq, dummyA, dummyB, params->correctModel);
+            
+            if (params->m->getControl_pressed()) { return ""; }
+            
+            double cIndex = chimeraDist;//modeledPairwiseAlignSeqs(sequences[i].sequence, chimeraRefSeq);
+            double loonIndex = myPerseus.calcLoonIndex(params->sequences[i].sequence, params->sequences[leftParentBi].sequence, params->sequences[rightParentBi].sequence, breakPointBi, params->binMatrix);
+            
+            if (params->m->getControl_pressed()) { return ""; }
+            
+            chimeraLine << i << '\t' << params->sequences[i].seqName << '\t' << bestSingleDiff << '\t' << bestSingleIndex << '\t' << params->sequences[bestSingleIndex].seqName << '\t';
+            chimeraLine << minMismatchToChimera << '\t' << leftParentBi << '\t' << rightParentBi << '\t' << params->sequences[leftParentBi].seqName << '\t' << params->sequences[rightParentBi].seqName << '\t';
+            chimeraLine << singleDist << '\t' << cIndex << '\t' << (cIndex - singleDist) << '\t' << loonIndex << '\t';
+            chimeraLine << minMismatchToChimera << '\t' << minMismatchToTrimera << '\t' << breakPointBi << '\t';
+            
+            double probability = myPerseus.classifyChimera(singleDist, cIndex, loonIndex, params->alpha, params->beta);
+            
+            chimeraLine << probability << '\t';
+            
+            if(probability > params->cutoff){
+                chimeraLine << type << endl;
+                isChimera = true;
+            }
+            else{ chimeraLine << "good" << endl; }
+        }
+        else{
+            chimeraLine << i << '\t' << params->sequences[i].seqName << "\t0\t0\tNull\t0\t0\t0\tNull\tNull\t0.0\t0.0\t0.0\t0\t0\t0\t0.0\t0.0\tgood" << endl;
+        }
+        
+        return chimeraLine.str();
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "ChimeraPerseusCommand", "checkSequence");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+//thread t checks sequences start+t, start+t+numThreads, ... so the threads share the later, more expensive sequences
+void checkSequences(perseusData* params, vector<int>* numParents, int start, int end, int thread, int numThreads, vector<string>* lines, vector<char>* isChimera){
+    try {
+        Perseus myPerseus; //keeps its alignment buffers between the thread's sequences
+        vector<char> marks;
+        if (params->maxp > 0) { marks.assign(1 << (2*perseusKmerSize), 0); }
+        
+        for (int i = start+thread; i < end; i += numThreads) {
+            if (params->m->getControl_pressed()) { break; }
+            
+            bool chimera = false;
+            (*lines)[i-start] = checkSequence(params, myPerseus, i, (*numParents)[i], marks, chimera);
+            (*isChimera)[i-start] = chimera;
+        }
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "ChimeraPerseusCommand", "checkSequences");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+//A sequence's parents are the sequences at least twice as abundant, a prefix of the frequency order, and only the ones
+//not already found to be chimeras. So the sequences are checked in runs whose parents have all been decided, the
+//sequences of a run are split between the threads and the run's results are written in order.
 void driver(perseusData* params){
     try {
-        vector<vector<double> > correctModel(4);	//could be an option in the future to input own model matrix
+        params->correctModel.resize(4);	//could be an option in the future to input own model matrix
+        vector<vector<double> >& correctModel = params->correctModel;
         for(int i=0;i<4;i++){	correctModel[i].resize(4);	}
         
         correctModel[0][0] = 0.000000;	//AA
@@ -242,100 +439,59 @@ void driver(perseusData* params){
         params->util.openOutputFile(params->accnosFileName, accnosFile);
         
         Perseus myPerseus;
-        vector<vector<double> > binMatrix = myPerseus.binomial(alignLength);
+        params->binMatrix = myPerseus.binomial(alignLength);
+        
+        if (params->maxp > 0) {
+            params->kmers.resize(numSeqs);
+            for (int i = 0; i < numSeqs; i++) { params->kmers[i] = getKmers(params->sequences[i].sequence, 0, params->sequences[i].sequence.length()); }
+        }
+        
+        //the sequences are sorted by frequency, so sequence i's parents are the first numParents[i] sequences
+        vector<int> numParents(numSeqs, 0);
+        int parentEnd = 0;
+        for (int i = 0; i < numSeqs; i++) {
+            while ((parentEnd < numSeqs) && (params->sequences[parentEnd].frequency >= 2 * params->sequences[i].frequency)) { parentEnd++; }
+            numParents[i] = parentEnd;
+        }
         
         chimeraFile << "SequenceIndex\tName\tDiffsToBestMatch\tBestMatchIndex\tBestMatchName\tDiffstToChimera\tIndexofLeftParent\tIndexOfRightParent\tNameOfLeftParent\tNameOfRightParent\tDistanceToBestMatch\tcIndex\t(cIndex - singleDist)\tloonIndex\tMismatchesToChimera\tMismatchToTrimera\tChimeraBreakPoint\tLogisticProbability\tTypeOfSequence\n";
         
-        vector<bool> chimeras(numSeqs, 0);
+        params->chimeras.assign(numSeqs, 0);
         
-        for(int i=0;i<numSeqs;i++){
+        int start = 0;
+        while (start < numSeqs) {
             if (params->m->getControl_pressed()) { chimeraFile.close(); accnosFile.close(); break; }
             
-            vector<bool> restricted = chimeras;
-            
-            vector<vector<int> > leftDiffs(numSeqs);
-            vector<vector<int> > leftMaps(numSeqs);
-            vector<vector<int> > rightDiffs(numSeqs);
-            vector<vector<int> > rightMaps(numSeqs);
+            int end = start + 1;
+            while ((end < numSeqs) && (numParents[end] <= start)) { end++; }
             
-            vector<int> singleLeft, bestLeft;
-            vector<int> singleRight, bestRight;
+            vector<string> lines(end-start);
+            vector<char> isChimera(end-start, 0);
             
-            int bestSingleIndex, bestSingleDiff;
-            vector<pwAlign> alignments(numSeqs);
+            int numThreads = min(params->processors, end-start);
+            vector<std::thread*> workerThreads;
+            for (int t = 1; t < numThreads; t++) {
+                workerThreads.push_back(new std::thread(checkSequences, params, &numParents, start, end, t, numThreads, &lines, &isChimera));
+            }
+            checkSequences(params, &numParents, start, end, 0, numThreads, &lines, &isChimera);
+            for (int t = 0; t < workerThreads.size(); t++) { workerThreads[t]->join(); delete workerThreads[t]; }
             
-            int comparisons = myPerseus.getAlignments(i, params->sequences, alignments, leftDiffs, leftMaps, rightDiffs, rightMaps, bestSingleIndex, bestSingleDiff, restricted);
             if (params->m->getControl_pressed()) { chimeraFile.close(); accnosFile.close(); break; }
             
-            int minMismatchToChimera, leftParentBi, rightParentBi, breakPointBi;
-            
-            string dummyA, dummyB;
-            
-            if (params->sequences[i].sequence.size() < 3) {
-                chimeraFile << i << '\t' << params->sequences[i].seqName << "\t0\t0\tNull\t0\t0\t0\tNull\tNull\t0.0\t0.0\t0.0\t0\t0\t0\t0.0\t0.0\tgood" << endl;
-            }else if(comparisons >= 2){
-                minMismatchToChimera = myPerseus.getChimera(params->sequences, leftDiffs, rightDiffs, leftParentBi, rightParentBi, breakPointBi, singleLeft, bestLeft, singleRight, bestRight, restricted);
-                if (params->m->getControl_pressed()) { chimeraFile.close(); accnosFile.close(); break; }
-                
-                int minMismatchToTrimera = numeric_limits<int>::max();
-                int leftParentTri, middleParentTri, rightParentTri, breakPointTriA, breakPointTriB;
-                
-                if(minMismatchToChimera >= 3 && comparisons >= 3){
-                    minMismatchToTrimera = myPerseus.getTrimera(params->sequences, leftDiffs, leftParentTri, middleParentTri, rightParentTri, breakPointTriA, breakPointTriB, singleLeft, bestLeft, singleRight, bestRight, restricted);
-                    if (params->m->getControl_pressed()) { chimeraFile.close(); accnosFile.close(); break; }
-                }
-                
-                double singleDist = myPerseus.modeledPairwiseAlignSeqs(params->sequences[i].sequence, params->sequences[bestSingleIndex].sequence, dummyA, dummyB, correctModel);
-                
-                if (params->m->getControl_pressed()) { chimeraFile.close(); accnosFile.close(); break; }
-                
-                string type;
-                string chimeraRefSeq;
-                
-                if(minMismatchToChimera - minMismatchToTrimera >= 3){
-                    type = "trimera";
-                    chimeraRefSeq = myPerseus.stitchTrimera(alignments, leftParentTri, middleParentTri, rightParentTri, breakPointTriA, breakPointTriB, leftMaps, rightMaps);
-                }
-                else{
-                    type = "chimera";
-                    chimeraRefSeq = myPerseus.stitchBimera(alignments, leftParentBi, rightParentBi, breakPointBi, leftMaps, rightMaps);
-                }
-                
-                if (params->m->getControl_pressed()) { chimeraFile.close(); accnosFile.close(); break; }
-                
-                double chimeraDist = myPerseus.modeledPairwiseAlignSeqs(params->sequences[i].sequence, chimeraRefSeq, dummyA, dummyB, correctModel);
-                
-                if (params->m->getControl_pressed()) { chimeraFile.close(); accnosFile.close(); break; }
-                
-                double cIndex = chimeraDist;//modeledPairwiseAlignSeqs(sequences[i].sequence, chimeraRefSeq);
-                double loonIndex = myPerseus.calcLoonIndex(params->sequences[i].sequence, params->sequences[leftParentBi].sequence, params->sequences[rightParentBi].sequence, breakPointBi, binMatrix);
-                
-                if (params->m->getControl_pressed()) { chimeraFile.close(); accnosFile.close(); break; }
-                
-                chimeraFile << i << '\t' << params->sequences[i].seqName << '\t' << bestSingleDiff << '\t' << bestSingleIndex << '\t' << params->sequences[bestSingleIndex].seqName << '\t';
-                chimeraFile << minMismatchToChimera << '\t' << leftParentBi << '\t' << rightParentBi << '\t' << params->sequences[leftParentBi].seqName << '\t' << params->sequences[rightParentBi].seqName << '\t';
-                chimeraFile << singleDist << '\t' << cIndex << '\t' << (cIndex - singleDist) << '\t' << loonIndex << '\t';
-                chimeraFile << minMismatchToChimera << '\t' << minMismatchToTrimera << '\t' << breakPointBi << '\t';
-                
-                double probability = myPerseus.classifyChimera(singleDist, cIndex, loonIndex, params->alpha, params->beta);
-                
-                chimeraFile << probability << '\t';
-                
-                if(probability > params->cutoff){
-                    chimeraFile << type << endl;
+            for (int i = start; i < end; i++) {
+                chimeraFile << lines[i-start];
+                if (isChimera[i-start]) {
                     accnosFile << params->sequences[i].seqName << endl;
-                    chimeras[i] = 1;
+                    params->chimeras[i] = 1;
                     params->numChimeras++;
                 }
-                else{ chimeraFile << "good" << endl; }
-            }
-            else{
-                chimeraFile << i << '\t' << params->sequences[i].seqName << "\t0\t0\tNull\t0\t0\t0\tNull\tNull\t0.0\t0.0\t0.0\t0\t0\t0\t0.0\t0.0\tgood" << endl;
+                
+                //report progress
+                if((i+1) % 100 == 0){ 	params->m->mothurOutJustToScreen("Processing sequence: " + toString(i+1) + "\n");		}
+                params->count++; //# of sequences completed. Used by calling function to check for failure
             }
             
-            //report progress
-            if((i+1) % 100 == 0){ 	params->m->mothurOutJustToScreen("Processing sequence: " + toString(i+1) + "\n");		}
-            params->count++; //# of sequences completed. Used by calling function to check for failure
+            start = end;
         }
         
         if((numSeqs) % 100 != 0){ 	params->m->mothurOutJustToScreen("Processing sequence: " + toString(numSeqs) + "\n");		}
@@ -437,15 +593,13 @@ int ChimeraPerseusCommand::execute(){
                 if (m->getControl_pressed()) {   for (int j = 0; j < outputNames.size(); j++) {	util.mothurRemove(outputNames[j]);	}  return 0;  }
                 
             }else {
-                if (processors != 1) { m->mothurOut("Your count file does not contain group information, mothur can only use 1 processor, continuing.\n");  processors = 1; }
-                
                 //read sequences and store sorted by frequency
                 ct.readTable(countfile, false, false);
                 vector<seqData> sequences = readFiles(fastafile, ct.getNameMap());
                 
                 if (m->getControl_pressed()) {  for (int j = 0; j < outputNames.size(); j++) {	util.mothurRemove(outputNames[j]);	} return 0; }
                 
-                perseusData* dataBundle = new perseusData(outputFileName, accnosFileName, alpha, beta, cutoff);
+                perseusData* dataBundle = new perseusData(outputFileName, accnosFileName, alpha, beta, cutoff, processors, maxp);
                 dataBundle->sequences = sequences;
                 driver(dataBundle);
                 numSeqs = dataBundle->count; numChimeras = dataBundle->numChimeras;
@@ -526,14 +680,14 @@ struct perseusGroupsData {
     map<string, vector<string> > parsedFiles;
     
     bool hasCount, dups;
-    int threadID, count, numChimeras;
+    int threadID, count, numChimeras, processors, maxp;
     double alpha, beta, cutoff;
     vector<string> groups;
     Utils util;
     MothurOut* m;
     
     perseusGroupsData(){}
-    perseusGroupsData(map<string, vector<string> >& g2f,bool dps, bool hc, double a, double b, double c, string o,  string f, string n, string ac, string ctlist, vector<string> gr, int tid) {
+    perseusGroupsData(map<string, vector<string> >& g2f,bool dps, bool hc, double a, double b, double c, string o,  string f, string n, string ac, string ctlist, vector<string> gr, int tid, int p, int mp) {
         alpha = a;
         beta = b;
         cutoff = c;
@@ -544,6 +698,8 @@ struct perseusGroupsData {
         accnosFileName = ac;
         m = MothurOut::getInstance();
         threadID = tid;
+        processors = p;
+        maxp = mp;
         groups = gr;
         hasCount = hc;
         dups = dps;
@@ -622,7 +778,7 @@ void driverGroups(perseusGroupsData* params){
 
 			params->m->mothurOut("\nChecking sequences from group " + thisGroup + "...\n");
 			
-            perseusData* driverParams = new perseusData((params->chimeraFileName+thisGroup), (params->accnosFileName+thisGroup), params->alpha, params->beta, params->cutoff);
+            perseusData* driverParams = new perseusData((params->chimeraFileName+thisGroup), (params->accnosFileName+thisGroup), params->alpha, params->beta, params->cutoff, params->processors, params->maxp);
 			driverParams->sequences = loadSequences(nameMap, it->second[0], params);
 			
             if (params->m->getControl_pressed()) { break; }
@@ -713,6 +869,9 @@ int ChimeraPerseusCommand::createProcessesGroups(map<string, vector<string> >& p
 	try {
         numChimeras = 0;
         
+		//processors left over when there are fewer groups check each group's sequences in parallel
+		int groupProcessors = max(1, processors / max(1, (int)groups.size()));
+		
 		//sanity check
 		if (groups.size() < processors) { processors = groups.size(); m->mothurOut("Reducing processors to " + toString(groups.size()) + ".\n"); }
 		
@@ -750,7 +909,7 @@ int ChimeraPerseusCommand::createProcessesGroups(map<string, vector<string> >& p
                 }
                 else { m->mothurOut("[ERROR]: missing files for group " + groups[j] + ", skipping\n"); }
             }
-            perseusGroupsData* dataBundle = new perseusGroupsData(thisGroupsParsedFiles, dups, hasCount, alpha, beta, cutoff, (outputFName+extension), fasta, dupsFile,  (accnos+extension), (countlisttemp+extension), thisGroups, (i+1));
+            perseusGroupsData* dataBundle = new perseusGroupsData(thisGroupsParsedFiles, dups, hasCount, alpha, beta, cutoff, (outputFName+extension), fasta, dupsFile,  (accnos+extension), (countlisttemp+extension), thisGroups, (i+1), groupProcessors, maxp);
             data.push_back(dataBundle);
             
             workerThreads.push_back(new std::thread(driverGroups, dataBundle));
@@ -767,7 +926,7 @@ int ChimeraPerseusCommand::createProcessesGroups(map<string, vector<string> >& p
             }
             else { m->mothurOut("[ERROR]: missing files for group " + groups[j] + ", skipping\n"); }
         }
-        perseusGroupsData* dataBundle = new perseusGroupsData(thisGroupsParsedFiles, dups, hasCount, alpha, beta, cutoff, outputFName, fasta, dupsFile,  accnos, countlisttemp, thisGroups, 0);
+        perseusGroupsData* dataBundle = new perseusGroupsData(thisGroupsParsedFiles, dups, hasCount, alpha, beta, cutoff, outputFName, fasta, dupsFile,  accnos, countlisttemp, thisGroups, 0, groupProcessors, maxp);
         driverGroups(dataBundle);
         num = dataBundle->count;
         numChimeras = dataBundle->numChimeras;
@@ -41,7 +41,7 @@ public:
 private:
 	bool abort, hasCount, dups;
 	string fastafile, countfile;
-	int processors, alignLength;
+	int processors, alignLength, maxp;
 	double cutoff, alpha, beta;
     vector<string> outputNames;
 	
@@ -10,7 +10,6 @@
 #include "chimerauchimecommand.h"
 #include "deconvolutecommand.h"
 #include "sequence.hpp"
-#include "systemcommand.h"
 
 //**********************************************************************************************************************
 vector<string> ChimeraUchimeCommand::setParameters(){	
@@ -76,7 +75,6 @@ string ChimeraUchimeCommand::getHelpString(){
         helpString += "If the dereplicate parameter is false, then if one group finds the sequence to be chimeric, then all groups find it to be chimeric, default=f.\n";
 		helpString += "The reference parameter allows you to enter a reference file containing known non-chimeric sequences, and is required. You may also set template=self, in this case the abundant sequences will be used as potential parents. \n";
 		helpString += "The processors parameter allows you to specify how many processors you would like to use.  The default is 1. \n";
-        helpString += "The uchime parameter allows you to specify the name and location of your uchime executable. By default mothur will look in your path and mothur's executable and mothur tools locations.  You can set the uchime location as follows, uchime=/usr/bin/uchime.\n";
 		helpString += "The abskew parameter can only be used with template=self. Minimum abundance skew. Default 1.9. Abundance skew is: min [ abund(parent1), abund(parent2) ] / abund(query).\n";
 		helpString += "The chimealns parameter allows you to indicate you would like a file containing multiple alignments of query sequences to parents in human readable format. Alignments show columns with differences that support or contradict a chimeric model.\n";
 		helpString += "The minh parameter - mininum score to report chimera. Default 0.3. Values from 0.1 to 5 might be reasonable. Lower values increase sensitivity but may report more false positives. If you decrease xn you may need to increase minh, and vice versa.\n";
@@ -235,32 +233,9 @@ ChimeraUchimeCommand::ChimeraUchimeCommand(string option)  {
             if (hasCount && (templatefile != "self")) { m->mothurOut("You have provided a countfile and the reference parameter is not set to self. I am not sure what reference you are trying to use, aborting.\n");  abort=true; }
 			if (hasGroup && (templatefile != "self")) { m->mothurOut("You have provided a group file and the reference parameter is not set to self. I am not sure what reference you are trying to use, aborting.\n");  abort=true; }
 			
-            vector<string> versionOutputs;
-            bool foundTool = false;
-            string path = current->getProgramPath();
-            string programName = "uchime"; programName += EXECUTABLE_EXT;
-            
-            uchimeLocation = validParameter.validFile(parameters, "uchime");
-            if (uchimeLocation == "not found") {
-                uchimeLocation = "";
-                foundTool = util.findTool(programName, uchimeLocation, path, versionOutputs, current->getLocations());
-            }
-            else {
-                //test to make sure uchime exists
-                ifstream in;
-                uchimeLocation = util.getFullPathName(uchimeLocation);
-                foundTool = util.openInputFile(uchimeLocation, in, "no error"); in.close();
-                if(!foundTool) {
-                    m->mothurOut(uchimeLocation + " file does not exist or cannot be opened, ignoring.\n"); uchimeLocation = "";
-                    foundTool = util.findTool(programName, uchimeLocation, path, versionOutputs, current->getLocations());
-                }
-            }
-            
-            if (!foundTool) { abort = true; }
-            
-            uchimeLocation = util.getFullPathName(uchimeLocation);
-            m->mothurOut("[DEBUG]: uchime location using " + uchimeLocation + "\n");
-            if (m->getDebug()) { m->mothurOut("[DEBUG]: uchime location using " + uchimeLocation + "\n"); }
+            //uchime is part of mothur now, the parameter is left so older batch files still run
+            string temp2 = validParameter.valid(parameters, "uchime");
+            if (temp2 != "not found") { m->mothurOut("uchime is built into mothur, ignoring the uchime parameter.\n"); }
             
             if (!abort) {
                 if ((namefile != "") || (groupfile != "")) { //convert to count
@@ -287,260 +262,89 @@ ChimeraUchimeCommand::ChimeraUchimeCommand(string option)  {
 	}
 }
 /**************************************************************************************************/
+//uchime's command line options, set once before the searches start because uchime keeps them in globals
+vector<string> getUchimeOptions(uchimeVariables* vars){
+    vector<string> options;
+    options.push_back("--quiet");
+    
+    if (vars->strand != "")         { options.push_back("--strand");            options.push_back(vars->strand);            }
+    if (vars->useAbskew)            { options.push_back("--abskew");            options.push_back(vars->abskew);            }
+    if (vars->useMinH)              { options.push_back("--minh");              options.push_back(vars->minh);              }
+    if (vars->useMindiv)            { options.push_back("--mindiv");            options.push_back(vars->mindiv);            }
+    if (vars->useXn)                { options.push_back("--xn");                options.push_back(vars->xn);                }
+    if (vars->useDn)                { options.push_back("--dn");                options.push_back(vars->dn);                }
+    if (vars->useXa)                { options.push_back("--xa");                options.push_back(vars->xa);                }
+    if (vars->useChunks)            { options.push_back("--chunks");            options.push_back(vars->chunks);            }
+    if (vars->useMinchunk)          { options.push_back("--minchunk");          options.push_back(vars->minchunk);          }
+    if (vars->useIdsmoothwindow)    { options.push_back("--idsmoothwindow");    options.push_back(vars->idsmoothwindow);    }
+    if (vars->useMaxp)              { options.push_back("--maxp");              options.push_back(vars->maxp);              }
+    if (!vars->skipgaps)            { options.push_back("--noskipgaps");                                                    }
+    if (!vars->skipgaps2)           { options.push_back("--noskipgaps2");                                                   }
+    if (vars->useMinlen)            { options.push_back("--minlen");            options.push_back(vars->minlen);            }
+    if (vars->useMaxlen)            { options.push_back("--maxlen");            options.push_back(vars->maxlen);            }
+    if (vars->ucl)                  { options.push_back("--ucl");                                                           }
+    if (vars->useQueryfract)        { options.push_back("--queryfract");        options.push_back(vars->queryfract);        }
+    
+    return options;
+}
+/**************************************************************************************************/
 struct uchimeData {
-    string fastafile;
-    string dupsfile;
-    string outputFName;
-    string accnos, alns, formattedFastaFilename, templatefile, uchimeLocation;
-    string driverAccnos, driverAlns, driverOutputFName;
     map<string, vector<string> > parsedFiles;
     map<string, vector<string> > seqs2RemoveByGroup;
+    vector<UchimeQuery> queries;    //sequences to check
+    vector<string> names;           //names of the queries, the labels of the de novo queries carry their abundances
+    string results, accnos, alns;   //uchime's output, the groups in order
+    UchimeReference* reference;     //NULL for reference=self
     
-    int count, numChimeras;
-    vector<string> groups;
+    long long count;
+    int numChimeras;
     uchimeVariables* vars;
     MothurOut* m;
     Utils util;
     
     uchimeData(){}
-    uchimeData(map<string, vector<string> > g2f, string o, string uloc, string t, string file, string f, string n, string ac,  string al, vector<string> gr, uchimeVariables* vs) {
-        fastafile = f;
-        dupsfile = n;
-        formattedFastaFilename = file;
-        outputFName = o;
-        templatefile = t;
-        accnos = ac;
-        alns = al;
+    uchimeData(map<string, vector<string> > g2f, UchimeReference* r, uchimeVariables* vs) {
+        parsedFiles = g2f;
+        reference = r;
+        vars = vs;
         m = MothurOut::getInstance();
-        groups = gr;
         count = 0;
         numChimeras = 0;
-        uchimeLocation = uloc;
-        vars = vs;
-        driverAccnos = ac;
-        driverAlns = al;
-        driverOutputFName = o;
-        parsedFiles = g2f;
     }
-    void setDriverNames(string o, string al, string ac) {
-        driverAccnos = ac;
-        driverAlns = al;
-        driverOutputFName = o;
-    }
-    
 };
 //**********************************************************************************************************************
-int driver(uchimeData* params){
+//the de novo search wants the most abundant sequences first, the same order printVsearchFile writes them in
+void addQueries(vector<seqPriorityNode>& nameVector, vector<UchimeQuery>& queries, vector<string>& names){
+    sort(nameVector.begin(), nameVector.end(), compareSeqPriorityNodes);
+    
+    for (int i = 0; i < nameVector.size(); i++) {
+        string label = nameVector[i].name + "/ab=" + toString(nameVector[i].numIdentical) + "/";
+        queries.push_back(UchimeQuery(label, nameVector[i].seq, nameVector[i].numIdentical));
+        names.push_back(nameVector[i].name);
+    }
+}
+//**********************************************************************************************************************
+//checks params->queries, returns the number of sequences checked and the names of the chimeras
+int driver(uchimeData* params, vector<string>& chimeras){
     try {
+        vector<UchimeHit> hits;
+        if (params->reference == NULL)  { UchimeDeNovo(params->queries, params->vars->chimealns, hits);         }
+        else                            { params->reference->Search(params->queries, params->vars->chimealns, hits); }
         
-        params->driverOutputFName = params->util.getFullPathName(params->driverOutputFName);
-        params->formattedFastaFilename = params->util.getFullPathName(params->formattedFastaFilename);
-        params->driverAlns = params->util.getFullPathName(params->driverAlns);
-        
-        //to allow for spaces in the path
-        params->driverOutputFName = "\"" + params->driverOutputFName + "\"";
-        params->formattedFastaFilename = "\"" + params->formattedFastaFilename + "\"";
-        params->driverAlns = "\"" + params->driverAlns + "\"";
-        
-        if (params->formattedFastaFilename.length() > 257) {
-            params->m->mothurOut("[ERROR]: " + params->formattedFastaFilename + " filename is " + toString(params->formattedFastaFilename.length()) + " long. The uchime program can't handle files with a full path longer than 257 characters, please correct.\n"); params->m->setControl_pressed(true); return 0;
-        }else if ((params->driverAlns.length() > 257) && (params->vars->chimealns)) {
-            params->m->mothurOut("[ERROR]: " + params->driverAlns + " filename is " + toString(params->driverAlns.length()) + " long. The uchime program can't handle files with a full path longer than 257 characters, please correct.\n"); params->m->setControl_pressed(true); return 0;
-        }else if (params->driverOutputFName.length() > 257) {
-            params->m->mothurOut("[ERROR]: " + params->driverOutputFName + " filename is " + toString(params->driverOutputFName.length()) + " long. The uchime program can't handle files with a full path longer than 257 characters, please correct input file name.\n"); params->m->setControl_pressed(true); return 0;
-        }
-        
-        vector<char*> cPara;
-        
-        string uchimeCommand = params->uchimeLocation;
-        uchimeCommand = "\"" + uchimeCommand + "\" ";
-        cPara.push_back(params->util.mothurConvert(uchimeCommand));
-        
-        //are you using a reference file
-        if (params->templatefile != "self") {
-            string outputFileName = params->formattedFastaFilename.substr(1, params->formattedFastaFilename.length()-2) + ".uchime_formatted";
-            ifstream in;
-            params->util.openInputFile(params->formattedFastaFilename.substr(1, params->formattedFastaFilename.length()-2), in);
-            
-            ofstream out;
-            params->util.openOutputFile(outputFileName, out);
-            
-            while (!in.eof()) {
-                if (params->m->getControl_pressed()) { break;  }
-                
-                Sequence seq(in); params->util.gobble(in);
-                
-                if (seq.getName() != "") { seq.printSequence(out); }
-            }
-            in.close(); out.close();
-            
-            params->formattedFastaFilename = outputFileName;
-            params->formattedFastaFilename = "\"" + params->formattedFastaFilename + "\"";
-            
-            cPara.push_back(params->util.mothurConvert("--db"));
-            cPara.push_back(params->util.mothurConvert(params->templatefile));
-        }
-        
-        //input filename
-        cPara.push_back(params->util.mothurConvert("--input"));
-        cPara.push_back(params->util.mothurConvert(params->formattedFastaFilename));
-        
-        //output filename
-        cPara.push_back(params->util.mothurConvert("--uchimeout"));
-        cPara.push_back(params->util.mothurConvert(params->driverOutputFName));
-        
-        if (params->vars->chimealns) {
-            //output alns filename
-            cPara.push_back(params->util.mothurConvert("--uchimealns"));
-            cPara.push_back(params->util.mothurConvert(params->driverAlns));
-        }
-        
-        //strand
-        if (params->vars->strand != "") {
-            cPara.push_back(params->util.mothurConvert("--strand"));
-            cPara.push_back(params->util.mothurConvert(params->vars->strand));
-        }
-        
-        if (params->vars->useAbskew) {
-            cPara.push_back(params->util.mothurConvert("--abskew"));
-            cPara.push_back(params->util.mothurConvert(params->vars->abskew));
-        }
-        
-        if (params->vars->useMinH) {
-            cPara.push_back(params->util.mothurConvert("--minh"));
-            cPara.push_back(params->util.mothurConvert(params->vars->minh));
-        }
-        
-        if (params->vars->useMindiv) {
-            cPara.push_back(params->util.mothurConvert("--mindiv"));
-            cPara.push_back(params->util.mothurConvert(params->vars->mindiv));
-        }
-        
-        if (params->vars->useXn) {
-            cPara.push_back(params->util.mothurConvert("--xn"));
-            cPara.push_back(params->util.mothurConvert(params->vars->xn));
-        }
-        
-        if (params->vars->useDn) {
-            cPara.push_back(params->util.mothurConvert("--dn"));
-            cPara.push_back(params->util.mothurConvert(params->vars->dn));
-        }
-        
-        if (params->vars->useXa) {
-            cPara.push_back(params->util.mothurConvert("--xa"));
-            cPara.push_back(params->util.mothurConvert(params->vars->xa));
-        }
-        
-        if (params->vars->useChunks) {
-            cPara.push_back(params->util.mothurConvert("--chunks"));
-            cPara.push_back(params->util.mothurConvert(params->vars->chunks));
-        }
-        
-        if (params->vars->useMinchunk) {
-            cPara.push_back(params->util.mothurConvert("--minchunk"));
-            cPara.push_back(params->util.mothurConvert(params->vars->minchunk));
-        }
-        
-        if (params->vars->useIdsmoothwindow) {
-            cPara.push_back(params->util.mothurConvert("--idsmoothwindow"));
-            cPara.push_back(params->util.mothurConvert(params->vars->idsmoothwindow));
-        }
-        
-        if (params->vars->useMaxp) {
-            cPara.push_back(params->util.mothurConvert("--maxp"));
-            cPara.push_back(params->util.mothurConvert(params->vars->maxp));
-        }
-        
-        if (!params->vars->skipgaps) {
-            cPara.push_back(params->util.mothurConvert("--noskipgaps"));
-        }
-        
-        if (!params->vars->skipgaps2) {
-            cPara.push_back(params->util.mothurConvert("--noskipgaps2"));
-        }
-        
-        if (params->vars->useMinlen) {
-            cPara.push_back(params->util.mothurConvert("--minlen"));
-            cPara.push_back(params->util.mothurConvert(params->vars->minlen));
-        }
-        
-        if (params->vars->useMaxlen) {
-            cPara.push_back(params->util.mothurConvert("--maxlen"));
-            cPara.push_back(params->util.mothurConvert(params->vars->maxlen));
-        }
-        
-        if (params->vars->ucl) {
-            cPara.push_back(params->util.mothurConvert("--ucl"));
-        }
-        
-        if (params->vars->useQueryfract) {
-            cPara.push_back(params->util.mothurConvert("--queryfract"));
-            cPara.push_back(params->util.mothurConvert(params->vars->queryfract));
-        }
-        
-        
-        char** uchimeParameters;
-        uchimeParameters = new char*[cPara.size()];
-        string commandString = "";
-        for (int i = 0; i < cPara.size(); i++) {  uchimeParameters[i] = cPara[i];  commandString += toString(cPara[i]) + " "; }
-        
-        //int numArgs = cPara.size();
-        //uchime_main(numArgs, uchimeParameters);
-        
-#if defined NON_WINDOWS
-#else
-        commandString = "\"" + commandString + "\"";
-#endif
-        if (params->m->getDebug()) { params->m->mothurOut("[DEBUG]: uchime command = " + commandString + ".\n"); }
-        system(commandString.c_str());
-        
-        //free memory
-        for(int i = 0; i < cPara.size(); i++)  {  delete cPara[i];  }
-        delete[] uchimeParameters;
-        
-        //remove "" from filenames
-        params->driverOutputFName = params->driverOutputFName.substr(1, params->driverOutputFName.length()-2);
-        params->formattedFastaFilename = params->formattedFastaFilename.substr(1, params->formattedFastaFilename.length()-2);
-        params->driverAlns = params->driverAlns.substr(1, params->driverAlns.length()-2);
-        
-        if (params->m->getControl_pressed()) { return 0; }
-        
-        //create accnos file from uchime results
-        ifstream in;
-        params->util.openInputFile(params->driverOutputFName, in);
-        
-        ofstream out;
-        params->util.openOutputFile(params->driverAccnos, out);
-        
-        int num = 0;
-        params->numChimeras = 0;
-        while(!in.eof()) {
-            
+        for (int i = 0; i < hits.size(); i++) {
             if (params->m->getControl_pressed()) { break; }
             
-            string name = ""; string chimeraFlag = "";
-            
-            string line = params->util.getline(in); params->util.gobble(in);
-            
-            vector<string> pieces = params->util.splitWhiteSpace(line);
-            if (pieces.size() > 2) {
-                name = pieces[1];
-                //fix name if needed
-                if (params->templatefile == "self") {
-                    name = name.substr(0, name.length()-1); //rip off last /
-                    name = name.substr(0, name.find_last_of('/'));
-                }
-                
-                chimeraFlag = pieces[pieces.size()-1];
-            }
+            params->results += hits[i].Line;
+            params->alns += hits[i].Alns;
             
-            if (chimeraFlag == "Y") { out << name << endl; params->numChimeras++; }
-            num++;
+            if (hits[i].Chimera) { chimeras.push_back(params->names[hits[i].Index]); params->numChimeras++; }
         }
-        in.close();
-        out.close();
         
-        return num;
+        return hits.size();
+    }
+    catch(UchimeError& e) {
+        params->m->mothurOut("[ERROR]: " + string(e.what()) + "\n"); params->m->setControl_pressed(true);
+        return 0;
     }
     catch(exception& e) {
         params->m->errorOut(e, "ChimeraUchimeCommand", "driver");
@@ -559,6 +363,8 @@ int ChimeraUchimeCommand::execute(){
         vars = new uchimeVariables();
         vars->setBooleans(dups, useAbskew, chimealns, useMinH, useMindiv, useXn, useDn, useXa, useChunks, useMinchunk, useIdsmoothwindow, useMinsmoothid, useMaxp, skipgaps, skipgaps2, useMinlen, useMaxlen, ucl, useQueryfract, hasCount);
         vars->setVariables(abskew, minh, mindiv, xn, dn, xa, chunks, minchunk, idsmoothwindow, minsmoothid, maxp, minlen, maxlen, queryfract, strand);
+        try { SetUchimeOptions(getUchimeOptions(vars)); }
+        catch(UchimeError& e) { m->mothurOut("[ERROR]: " + string(e.what()) + "\n"); m->setControl_pressed(true); delete vars; return 0; }
 
         m->mothurOut("Checking sequences from " + fastafile + " ...\n" ); 
         
@@ -571,7 +377,6 @@ int ChimeraUchimeCommand::execute(){
         string outputFileName = getOutputFileName("chimera", variables);
         string accnosFileName = getOutputFileName("accnos", variables);
         string alnsFileName = getOutputFileName("alns", variables);
-        string newFasta = util.getRootName(fastafile) + "temp";
         string newCountFile = "";
         
         //you provided a groupfile
@@ -584,6 +389,7 @@ int ChimeraUchimeCommand::execute(){
             newCountFile = getOutputFileName("count", variables);
         }
         
+        vector<UchimeQuery> queries; vector<string> names;
         if ((templatefile == "self") && (!hasGroups)) { //you want to run uchime with a template=self and no groups
             
             if (processors != 1) { m->mothurOut("When using template=self, mothur can only use 1 processor, continuing.\n"); processors = 1; }
@@ -596,7 +402,7 @@ int ChimeraUchimeCommand::execute(){
             
             //read namefile
             vector<seqPriorityNode> nameMapCount;
-            int error;
+            int error = 0;
             if (hasCount) {
                 CountTable ct;
                 ct.readTable(countfile, true, false);
@@ -613,8 +419,7 @@ int ChimeraUchimeCommand::execute(){
             if (error == 1) { for (int j = 0; j < outputNames.size(); j++) {	util.mothurRemove(outputNames[j]);	}  return 0; }
             if (seqs.size() != nameMapCount.size()) { m->mothurOut( "The number of sequences in your fastafile does not match the number of sequences in your countfile, aborting.\n"); for (int j = 0; j < outputNames.size(); j++) {	util.mothurRemove(outputNames[j]);	}  return 0; }
             
-            util.printVsearchFile(nameMapCount, newFasta, "/ab=", "/");
-            fastafile = newFasta;
+            addQueries(nameMapCount, queries, names);
         }
         
         if (m->getControl_pressed()) {  for (int j = 0; j < outputNames.size(); j++) {	util.mothurRemove(outputNames[j]);	} delete vars; return 0;	}
@@ -633,14 +438,8 @@ int ChimeraUchimeCommand::execute(){
                 
             }
             
-            //clears files
-            ofstream out, out1, out2;
-            util.openOutputFile(outputFileName, out); out.close();
-            util.openOutputFile(accnosFileName, out1); out1.close();
-            if (chimealns) { util.openOutputFile(alnsFileName, out2); out2.close(); }
-            
             map<string, vector<string> > seqs2RemoveByGroup;
-            int totalSeqs = createProcessesGroups(group2Files, outputFileName, newFasta, accnosFileName, alnsFileName, groups, seqs2RemoveByGroup);
+            int totalSeqs = createProcessesGroups(group2Files, outputFileName, accnosFileName, alnsFileName, groups, seqs2RemoveByGroup);
             
             if (hasCount && dups) {
                 CountTable newCount; newCount.readTable(countfile, true, false);
@@ -682,30 +481,30 @@ int ChimeraUchimeCommand::execute(){
         }else{
             if (m->getControl_pressed()) {  for (int j = 0; j < outputNames.size(); j++) {	util.mothurRemove(outputNames[j]);	}  delete vars; return 0;	}
             
-            int numSeqs = 0;
-            int numChimeras = 0;
-            map<string, vector<string> > dummy;
-            
-            uchimeData* dataBundle = new uchimeData(dummy, outputFileName, uchimeLocation, templatefile, fastafile, fastafile, countfile, accnosFileName, alnsFileName, nullVector, vars);
-            
-            numSeqs = driver(dataBundle);
-            numChimeras = dataBundle->numChimeras;
-            delete dataBundle;
-            
-            //add headings
-            ofstream out;
-            util.openOutputFile(outputFileName+".temp", out);
-            out << "Score\tQuery\tParentA\tParentB\tIdQM\tIdQA\tIdQB\tIdAB\tIdQT\tLY\tLN\tLA\tRY\tRN\tRA\tDiv\tYN\n";
-            out.close();
+            //reference sequences are checked with the labels they have in the fasta file
+            UchimeReference* reference = NULL;
+            if (templatefile != "self") {
+                try { reference = new UchimeReference(templatefile); }
+                catch(UchimeError& e) { m->mothurOut("[ERROR]: " + string(e.what()) + "\n"); m->setControl_pressed(true); for (int j = 0; j < outputNames.size(); j++) {	util.mothurRemove(outputNames[j]);	} delete vars; return 0; }
+                
+                ifstream in;
+                util.openInputFile(fastafile, in);
+                while (!in.eof()) {
+                    if (m->getControl_pressed()) { break;  }
+                    
+                    Sequence seq(in); util.gobble(in);
+                    
+                    if (seq.getName() != "") { queries.push_back(UchimeQuery(seq.getName() + seq.getComment(), seq.getAligned(), 0)); names.push_back(seq.getName()); }
+                }
+                in.close();
+            }
             
-            util.appendFiles(outputFileName, outputFileName+".temp");
-            util.mothurRemove(outputFileName); rename((outputFileName+".temp").c_str(), outputFileName.c_str());
+            int numChimeras = 0;
+            int numSeqs = createProcesses(queries, names, reference, outputFileName, accnosFileName, alnsFileName, numChimeras);
+            if (reference != NULL) { delete reference; }
             
             if (m->getControl_pressed()) { for (int j = 0; j < outputNames.size(); j++) {	util.mothurRemove(outputNames[j]);	} delete vars; return 0; }
             
-            //remove file made for uchime
-            if (templatefile == "self") {  util.mothurRemove(fastafile); }
-            
             m->mothurOut("\nIt took " + toString(time(NULL) - start) + " secs to check " + toString(numSeqs) + " sequences. " + toString(numChimeras) + " chimeras were found.\n");
         }
         
@@ -1036,8 +835,7 @@ string ChimeraUchimeCommand::getCountFile(string& inputFile){
 	}
 }
 //**********************************************************************************************************************
-
-int getSeqs(map<string, int>& nameMap, string thisGroupsFormattedOutputFilename, string tag, string tag2, long long& numSeqs, string thisGroupsFastaFile, MothurOut* m){
+int getQueries(map<string, int>& nameMap, vector<UchimeQuery>& queries, vector<string>& names, string thisGroupsFastaFile, MothurOut* m){
     try {
         int error = 0;
         ifstream in;
@@ -1066,14 +864,12 @@ int getSeqs(map<string, int>& nameMap, string thisGroupsFormattedOutputFilename,
         
         if (error == 1) {  return 1; }
         
-        numSeqs = nameVector.size();
-        
-        util.printVsearchFile(nameVector, thisGroupsFormattedOutputFilename, tag, tag2);
+        addQueries(nameVector, queries, names);
         
         return error;
     }
     catch(exception& e) {
-        m->errorOut(e, "ChimeraVsearchCommand", "getSeqs");
+        m->errorOut(e, "ChimeraUchimeCommand", "getQueries");
         exit(1);
     }
 }
@@ -1088,7 +884,6 @@ void driverGroups(uchimeData* params){
             if (params->m->getControl_pressed()) {  break; }
             
             int error;
-            long long numSeqs = 0;
             string thisGroup = it->first;
             
             map<string, int> nameMap;
@@ -1098,62 +893,41 @@ void driverGroups(uchimeData* params){
             }
             else { nameMap = params->util.readNames(it->second[1]); }
             
-            error = getSeqs(nameMap, params->formattedFastaFilename, "/ab=", "/", numSeqs, it->second[0], params->m); if ((error == 1) || params->m->getControl_pressed()) {  break; }
+            params->queries.clear(); params->names.clear();
+            error = getQueries(nameMap, params->queries, params->names, it->second[0], params->m); if ((error == 1) || params->m->getControl_pressed()) {  break; }
             
+            long long numSeqs = params->queries.size();
 			totalSeqs += numSeqs;
             
-            params->setDriverNames((params->outputFName + thisGroup), (params->alns+thisGroup), (params->accnos+thisGroup));
-			driver(params);
+            vector<string> namesOfChimeras;
+			driver(params, namesOfChimeras);
 			
             if (params->m->getControl_pressed()) { break; }
 			
-			//remove file made for uchime
-			if (!params->m->getDebug()) {  params->util.mothurRemove(params->formattedFastaFilename);  }
-            else { params->m->mothurOut("[DEBUG]: saving file: " + params->formattedFastaFilename + ".\n"); }
-			
             //if we provided a count file with group info and set dereplicate=t, then we want to create a *.pick.count_table
             //This table will zero out group counts for seqs determined to be chimeric by that group.
             if (params->vars->dups) {
-                if (!params->util.isBlank(params->accnos+thisGroup)) {
-                    ifstream in;
-                    params->util.openInputFile(params->accnos+thisGroup, in);
-                    string name;
-                    if (params->vars->hasCount) {
-                        vector<string> namesOfChimeras;
-                        while (!in.eof()) {
-                            in >> name; params->util.gobble(in);
-                            namesOfChimeras.push_back(name);
-                        }
-                        in.close();
-                        params->seqs2RemoveByGroup[thisGroup] = namesOfChimeras;
-                    }else {
-                        map<string, string> thisnamemap; params->util.readNames(it->second[1], thisnamemap);
-                        map<string, string>::iterator itN;
-                        ofstream out;
-                        params->util.openOutputFile(params->accnos+thisGroup+".temp", out);
-                        while (!in.eof()) {
-                            in >> name; params->util.gobble(in);
-                            itN = thisnamemap.find(name);
-                            if (itN != thisnamemap.end()) {
-                                vector<string> tempNames; params->util.splitAtComma(itN->second, tempNames);
-                                for (int j = 0; j < tempNames.size(); j++) { out << tempNames[j] << endl; }
-                                
-                            }else { params->m->mothurOut("[ERROR]: parsing cannot find " + name + ".\n"); params->m->setControl_pressed(true); }
-                        }
-                        out.close();
-                        in.close();
-                        params->util.renameFile(params->accnos+thisGroup+".temp", params->accnos+thisGroup);
+                if (params->vars->hasCount) { params->seqs2RemoveByGroup[thisGroup] = namesOfChimeras; }
+                else {
+                    map<string, string> thisnamemap; params->util.readNames(it->second[1], thisnamemap);
+                    map<string, string>::iterator itN;
+                    vector<string> redundantNames;
+                    for (int j = 0; j < namesOfChimeras.size(); j++) {
+                        itN = thisnamemap.find(namesOfChimeras[j]);
+                        if (itN != thisnamemap.end()) {
+                            vector<string> tempNames; params->util.splitAtComma(itN->second, tempNames);
+                            redundantNames.insert(redundantNames.end(), tempNames.begin(), tempNames.end());
+                        }else { params->m->mothurOut("[ERROR]: parsing cannot find " + namesOfChimeras[j] + ".\n"); params->m->setControl_pressed(true); }
                     }
+                    namesOfChimeras = redundantNames;
                 }
             }
             
-			//append files
-			params->util.appendFiles((params->outputFName+thisGroup), params->outputFName); params->util.mothurRemove((params->outputFName+thisGroup));
-			params->util.appendFiles((params->accnos+thisGroup), params->accnos); params->util.mothurRemove((params->accnos+thisGroup));
-			if (params->vars->chimealns) { params->util.appendFiles((params->alns+thisGroup), params->alns); params->util.mothurRemove((params->alns+thisGroup)); }
+            for (int j = 0; j < namesOfChimeras.size(); j++) { params->accnos += namesOfChimeras[j] + "\n"; }
 			
 			params->m->mothurOut("\nIt took " + toString(time(NULL) - start) + " secs to check " + toString(numSeqs) + " sequences from group " + thisGroup + ".\n");
 		}
+        params->queries.clear(); params->names.clear();
     
         params->count = totalSeqs;
 		
@@ -1165,7 +939,7 @@ void driverGroups(uchimeData* params){
 }	
 /**************************************************************************************************/
 
-int ChimeraUchimeCommand::createProcessesGroups(map<string, vector<string> >& groups2Files, string outputFName, string filename, string accnos, string alns, vector<string> groups, map<string, vector<string> >& seqs2RemoveByGroup) {
+int ChimeraUchimeCommand::createProcessesGroups(map<string, vector<string> >& groups2Files, string outputFName, string accnos, string alns, vector<string> groups, map<string, vector<string> >& seqs2RemoveByGroup) {
 	try {
         //sanity check
         if (groups.size() < processors) { processors = groups.size(); m->mothurOut("Reducing processors to " + toString(groups.size()) + ".\n"); }
@@ -1192,44 +966,39 @@ int ChimeraUchimeCommand::createProcessesGroups(map<string, vector<string> >& gr
         
         //Lauch worker threads
         for (int i = 0; i < processors-1; i++) {
-            string extension = toString(i+1) + ".temp";
-            vector<string> thisGroups;
             map<string, vector<string> > thisGroupsParsedFiles;
             for (int j = lines[i+1].start; j < lines[i+1].end; j++) {
                 
                 map<string, vector<string> >::iterator it = groups2Files.find(groups[j]);
-                if (it != groups2Files.end()) {
-                    thisGroupsParsedFiles[groups[j]] = (it->second);
-                    thisGroups.push_back(groups[j]);
-                }
+                if (it != groups2Files.end()) { thisGroupsParsedFiles[groups[j]] = (it->second); }
                 else { m->mothurOut("[ERROR]: missing files for group " + groups[j] + ", skipping\n"); }
             }
-            uchimeData* dataBundle = new uchimeData(thisGroupsParsedFiles, outputFName+extension, uchimeLocation, templatefile, filename+extension, fastafile, countfile,  accnos+extension, alns+extension, thisGroups, vars);
+            uchimeData* dataBundle = new uchimeData(thisGroupsParsedFiles, NULL, vars);
             data.push_back(dataBundle);
             
             workerThreads.push_back(new std::thread(driverGroups, dataBundle));
         }
         
-        vector<string> thisGroups;
         map<string, vector<string> > thisGroupsParsedFiles;
         for (int j = lines[0].start; j < lines[0].end; j++) {
             map<string, vector<string> >::iterator it = groups2Files.find(groups[j]);
-            if (it != groups2Files.end()) {
-                thisGroupsParsedFiles[groups[j]] = (it->second);
-                thisGroups.push_back(groups[j]);
-            }
+            if (it != groups2Files.end()) { thisGroupsParsedFiles[groups[j]] = (it->second); }
             else { m->mothurOut("[ERROR]: missing files for group " + groups[j] + ", skipping\n"); }
         }
-        uchimeData* dataBundle = new uchimeData(thisGroupsParsedFiles, outputFName, uchimeLocation, templatefile, filename, fastafile, countfile, accnos, alns, thisGroups, vars);
+        uchimeData* dataBundle = new uchimeData(thisGroupsParsedFiles, NULL, vars);
         driverGroups(dataBundle);
         num = dataBundle->count;
-        int numChimeras = dataBundle->numChimeras;
         seqs2RemoveByGroup = dataBundle->seqs2RemoveByGroup;
+        
+        //each thread has a block of groups, so the results are written in the order of the groups
+        ofstream out, out1, out2;
+        util.openOutputFile(outputFName, out); out << dataBundle->results;
+        util.openOutputFile(accnos, out1); out1 << dataBundle->accnos;
+        if (vars->chimealns) { util.openOutputFile(alns, out2); out2 << dataBundle->alns; }
 
         for (int i = 0; i < processors-1; i++) {
             workerThreads[i]->join();
             num += data[i]->count;
-            numChimeras += data[i]->numChimeras;
             
             for (map<string, vector<string> >::iterator it = data[i]->seqs2RemoveByGroup.begin(); it != data[i]->seqs2RemoveByGroup.end(); it++) {
                            
@@ -1239,16 +1008,16 @@ int ChimeraUchimeCommand::createProcessesGroups(map<string, vector<string> >& gr
                 }
             }
             
-            string extension = toString(i+1) + ".temp";
-            util.appendFiles((outputFName+extension), outputFName);
-            util.mothurRemove((outputFName+extension));
-            
-            util.appendFiles((accnos+extension), accnos);
-            util.mothurRemove((accnos+extension));
+            out << data[i]->results;
+            out1 << data[i]->accnos;
+            if (vars->chimealns) { out2 << data[i]->alns; }
             
             delete data[i];
             delete workerThreads[i];
         }
+        out.close(); out1.close();
+        if (vars->chimealns) { out2.close(); }
+        
         delete dataBundle;
         time(&end);
         m->mothurOut("It took " + toString(difftime(end, start)) + " secs to check " + toString(num) + " sequences.\n\n");
@@ -1261,5 +1030,81 @@ int ChimeraUchimeCommand::createProcessesGroups(map<string, vector<string> >& gr
 		exit(1);
 	}
 }
+//**********************************************************************************************************************
+void driverReference(uchimeData* params){
+    try {
+        vector<string> namesOfChimeras;
+        params->count = driver(params, namesOfChimeras);
+        
+        for (int j = 0; j < namesOfChimeras.size(); j++) { params->accnos += namesOfChimeras[j] + "\n"; }
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "ChimeraUchimeCommand", "driverReference");
+        exit(1);
+    }
+}
 /**************************************************************************************************/
+//the reference is shared by the threads, each thread checks a block of the queries
+int ChimeraUchimeCommand::createProcesses(vector<UchimeQuery>& queries, vector<string>& names, UchimeReference* reference, string outputFName, string accnos, string alns, int& numChimeras) {
+	try {
+        //divide the queries between the processors
+        vector<linePair> lines;
+        int remainingSeqs = queries.size();
+        int startIndex = 0;
+        for (int remainingProcessors = processors; remainingProcessors > 0; remainingProcessors--) {
+            int numSeqs = remainingSeqs; //case for last processor
+            if (remainingProcessors != 1) { numSeqs = ceil(remainingSeqs / remainingProcessors); }
+            lines.push_back(linePair(startIndex, (startIndex+numSeqs))); //startIndex, endIndex
+            startIndex = startIndex + numSeqs;
+            remainingSeqs = remainingSeqs - numSeqs;
+        }
+        
+        //create array of worker threads
+        vector<std::thread*> workerThreads;
+        vector<uchimeData*> data;
+        map<string, vector<string> > dummy;
+        
+        for (int i = 0; i < processors; i++) {
+            uchimeData* dataBundle = new uchimeData(dummy, reference, vars);
+            dataBundle->queries.assign(queries.begin()+lines[i].start, queries.begin()+lines[i].end);
+            dataBundle->names.assign(names.begin()+lines[i].start, names.begin()+lines[i].end);
+            data.push_back(dataBundle);
+            
+            //Lauch worker threads
+            if (i != 0) { workerThreads.push_back(new std::thread(driverReference, dataBundle)); }
+        }
+        
+        driverReference(data[0]);
+        for (int i = 0; i < workerThreads.size(); i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+        
+        //add headings
+        ofstream out, out1, out2;
+        util.openOutputFile(outputFName, out);
+        out << "Score\tQuery\tParentA\tParentB\tIdQM\tIdQA\tIdQB\tIdAB\tIdQT\tLY\tLN\tLA\tRY\tRN\tRA\tDiv\tYN\n";
+        util.openOutputFile(accnos, out1);
+        if (vars->chimealns) { util.openOutputFile(alns, out2); }
+        
+        int num = 0;
+        for (int i = 0; i < data.size(); i++) {
+            num += data[i]->count;
+            numChimeras += data[i]->numChimeras;
+            
+            out << data[i]->results;
+            out1 << data[i]->accnos;
+            if (vars->chimealns) { out2 << data[i]->alns; }
+            
+            delete data[i];
+        }
+        out.close(); out1.close();
+        if (vars->chimealns) { out2.close(); }
+        
+        return num;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ChimeraUchimeCommand", "createProcesses");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
 
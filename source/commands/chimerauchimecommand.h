@@ -15,6 +15,7 @@
 #include "sequenceparser.h"
 #include "counttable.h"
 #include "sequencecountparser.h"
+#include "uchimelib.h"
 
 /***********************************************************/
 struct uchimeVariables {
@@ -85,7 +86,7 @@ public:
 	
 private:
 	bool abort, useAbskew, chimealns, useMinH, useMindiv, useXn, useDn, useXa, useChunks, useMinchunk, useIdsmoothwindow, useMinsmoothid, useMaxp, skipgaps, skipgaps2, useMinlen, useMaxlen, ucl, useQueryfract, hasCount, dups;
-	string fastafile, templatefile, countfile, abskew, minh, mindiv, xn, dn, xa, chunks, minchunk, idsmoothwindow, minsmoothid, maxp, minlen, maxlen, queryfract, uchimeLocation, strand;
+	string fastafile, templatefile, countfile, abskew, minh, mindiv, xn, dn, xa, chunks, minchunk, idsmoothwindow, minsmoothid, maxp, minlen, maxlen, queryfract, strand;
 	int processors;
 	vector<string> outputNames;
     uchimeVariables* vars;
@@ -93,7 +94,8 @@ private:
 	string getCountFile(string&);
 	int readFasta(string, map<string, string>&);
 	int deconvoluteResults(string, string, string);
-	int createProcessesGroups(map<string, vector<string> >&, string, string, string, string, vector<string>, map<string, vector<string> >&);
+	int createProcessesGroups(map<string, vector<string> >&, string, string, string, vector<string>, map<string, vector<string> >&);
+	int createProcesses(vector<UchimeQuery>&, vector<string>&, UchimeReference*, string, string, string, int&);
 };
 /**************************************************************************************************/
 
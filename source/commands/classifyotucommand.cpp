@@ -474,9 +474,8 @@ int ClassifyOtuCommand::process(ListVector* processList) {
 			if (m->getControl_pressed()) { break; }
 			
 			vector<string> names;
-            string binnames = processList->get(i);
             vector<string> thisNames;
-            util.splitAtComma(binnames, thisNames);
+            processList->getNames(i, thisNames);
             
 			names = findConsensusTaxonomy(thisNames, size, conTax, "");
 		
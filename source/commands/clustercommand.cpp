@@ -28,6 +28,7 @@
 #include "tn.hpp"
 #include "fn.hpp"
 #include "accuracy.hpp"
+#include "labelindex.hpp"
 
 
 
@@ -87,7 +88,7 @@ string ClusterCommand::getHelpString(){
         helpString += "The initialize parameter allows to select the initial randomization for the opticluster method. Options are singleton, meaning each sequence is randomly assigned to its own OTU, or oneotu meaning all sequences are assigned to one otu. Default=singleton.\n";
         helpString += "The delta parameter allows to set the stable value for the metric in the opticluster method (delta=0.0001). \n";
         helpString += "The method parameter allows you to enter your clustering mothod. Options are furthest, nearest, average, weighted, agc, dgc, unique and opti. Default=opti.  The agc and dgc methods require a fasta file.";
-        helpString += "The processors parameter allows you to specify the number of processors to use. The default is 1.\n";
+        helpString += "The processors parameter allows you to specify the number of processors to use with the opti, agc and dgc methods. The default is 1.\n";
          helpString += "The vsearch parameter allows you to specify the name and location of your vsearch executable if using agc or dgc clustering methods. By default mothur will look in your path, mothur's executable and mothur tools locations.  You can set the vsearch location as follows, vsearch=/usr/bin/vsearch.\n";
        helpString += "The cluster command should be in the following format: \n";
 		helpString += "cluster(method=yourMethod, cutoff=yourCutoff, precision=yourPrecision) \n";
@@ -287,8 +288,8 @@ ClusterCommand::ClusterCommand(string option)  {
             
             if ((method == "agc") || (method == "dgc")) {
                 if (fastafile == "") { m->mothurOut("[ERROR]: You must provide a fasta file when using the agc or dgc clustering methods, aborting\n."); abort = true;}
-            }else if (setProcessors) {
-                m->mothurOut("[WARNING]: You can only use the processors option when using the agc or dgc clustering methods. Using 1 processor.\n.");
+            }else if ((method != "opti") && setProcessors) {
+                m->mothurOut("[WARNING]: You can only use the processors option when using the opti, agc or dgc clustering methods. Using 1 processor.\n.");
             }
             
             cutOffSet = false;
@@ -379,6 +380,9 @@ int ClusterCommand::execute(){
 		if (itTypes != outputTypes.end()) {
 			if ((itTypes->second).size() != 0) { currentName = (itTypes->second)[0]; current->setSabundFile(currentName); }
 		}
+        
+        //index the labels now, so the commands reading the list file can seek to them
+        for (int i = 0; i < outputTypes["list"].size(); i++) { LabelIndex::write(outputTypes["list"][i], "list"); }
 		
 		m->mothurOut("\nOutput File Names: \n"); 
 		for (int i = 0; i < outputNames.size(); i++) {	m->mothurOut(outputNames[i] +"\n"); 	} m->mothurOutEndLine();
@@ -829,7 +833,7 @@ int ClusterCommand::runOptiCluster(){
             
             OptiData* matrix = new OptiMatrix(distfile, thisNamefile, nameOrCount, format, cutoff, false);
             
-            OptiCluster cluster(matrix, metric, 0);
+            OptiCluster cluster(matrix, metric, 0, processors);
             
             int iters = 0;
             double listVectorMetric = 0; //worst state
@@ -780,8 +780,8 @@ int ClusterSplitCommand::mergeLists(vector<string> listNames, map<double, int> u
 			if (listSingle != NULL) {
 				for (int j = 0; j < listSingle->getNumBins(); j++) {
 					//outList << listSingle->get(j) << '\t';
-                    completeList.push_back(listSingle->get(j));
-					if (countfile == "") { rabund->push_back(util.getNumNames(listSingle->get(j))); }
+                    completeList.push_back(*listSingle, j);
+					if (countfile == "") { rabund->push_back(listSingle->getBinSize(j)); }
 				}
 			}
 			
@@ -797,8 +797,8 @@ int ClusterSplitCommand::mergeLists(vector<string> listNames, map<double, int> u
 				if (list == NULL) { m->mothurOut("Error merging listvectors in file " + listNames[k]); m->mothurOutEndLine();  }	
 				else {		
 					for (int j = 0; j < list->getNumBins(); j++) {
-                        completeList.push_back(list->get(j));
-						if (countfile == "") { rabund->push_back(util.getNumNames(list->get(j))); }
+                        completeList.push_back(*list, j);
+						if (countfile == "") { rabund->push_back(list->getBinSize(j)); }
 					}
 					delete list;
 				}
@@ -839,7 +839,7 @@ int ClusterSplitCommand::mergeLists(vector<string> listNames, map<double, int> u
 struct clusterData {
     MothurOut* m;
     Utils util;
-    int count, precision, length, numSingletons, maxIters;
+    int count, precision, length, numSingletons, maxIters, optiProcessors;
     bool showabund, classic, useName, useCount, deleteFiles, cutoffNotSet;
     double cutoff, stableMetric;
     ofstream outList, outRabund, outSabund;
@@ -866,8 +866,10 @@ struct clusterData {
         useName = false;
         useCount = false;
         numSingletons = 0;
+        optiProcessors = 1;
     }
-    void setOptiOptions(string metn, double stabMet, string init, int mxi ) {
+    void setOptiOptions(string metn, double stabMet, string init, int mxi, int proc) {
+        optiProcessors = proc;
         metricName = metn;
         stableMetric = stabMet;
         maxIters = mxi;
@@ -887,8 +889,7 @@ int createRabund(CountTable*& ct, ListVector*& list, RAbundVector*& rabund, clus
         for(int i = 0; i < list->getNumBins(); i++) {
             if (params->m->getControl_pressed()) { break; }
             vector<string> binNames;
-            string bin = list->get(i);
-            params->util.splitAtComma(bin, binNames);
+            list->getNames(i, binNames);
             int total = 0;
             for (int j = 0; j < binNames.size(); j++) { total += ct->getNumSeqs(binNames[j]);  }
             rabund->push_back(total);
@@ -1033,7 +1034,7 @@ string runOptiCluster(string thisDistFile, string thisNamefile, double& smallest
         else if (params->metricName == "fdr")        { metric = new FDR();              }
         else if (params->metricName == "fpfn")       { metric = new FPFN();             }
         
-        OptiCluster cluster(&matrix, metric, 0);
+        OptiCluster cluster(&matrix, metric, 0, params->optiProcessors);
         params->tag = cluster.getTag();
         
         params->m->mothurOut("\nClustering " + thisDistFile + "\n");
@@ -1447,8 +1448,9 @@ void printData(ListVector* oldList, clusterData* params){
 //**********************************************************************************************************************
 vector<string>  ClusterSplitCommand::createProcesses(vector< map<string, string> > distName, set<string>& labels){
 	try {
-        //sanity check
-        if (processors > distName.size()) { processors = distName.size(); }
+        //sanity check, processors left over when there are fewer files than processors are used by the opti update
+        int optiProcessors = 1;
+        if (processors > distName.size()) { if (distName.size() != 0) { optiProcessors = processors / distName.size(); } processors = distName.size(); }
         deleteFiles = false; //so if we need to recalc the processors the files are still there
         vector<string> listFiles;
         vector < vector < map<string, string> > > dividedNames; //distNames[1] = vector of filenames for process 1...
@@ -1480,7 +1482,7 @@ vector<string>  ClusterSplitCommand::createProcesses(vector< map<string, string>
         //Lauch worker threads
         for (int i = 0; i < processors-1; i++) {
             clusterData* dataBundle = new clusterData(showabund, classic, deleteFiles, dividedNames[i+1], cutoffNotSet, cutoff, precision, length, method, outputdir, vsearchLocation);
-            dataBundle->setOptiOptions(metricName, stableMetric, initialize, maxIters);
+            dataBundle->setOptiOptions(metricName, stableMetric, initialize, maxIters, optiProcessors);
             dataBundle->setNamesCount(namefile, countfile);
             data.push_back(dataBundle);
             
@@ -1489,7 +1491,7 @@ vector<string>  ClusterSplitCommand::createProcesses(vector< map<string, string>
         
         
         clusterData* dataBundle = new clusterData(showabund, classic, deleteFiles, dividedNames[0], cutoffNotSet, cutoff, precision, length, method, outputdir, vsearchLocation);
-        dataBundle->setOptiOptions(metricName, stableMetric, initialize, maxIters);
+        dataBundle->setOptiOptions(metricName, stableMetric, initialize, maxIters, optiProcessors);
         dataBundle->setNamesCount(namefile, countfile);
         cluster(dataBundle);
         listFiles = dataBundle->listFileNames;
@@ -9,6 +9,7 @@
 
 #include "deconvolutecommand.h"
 #include "sequence.hpp"
+#include <unordered_set>
 
 //**********************************************************************************************************************
 vector<string> DeconvoluteCommand::setParameters(){	
@@ -17,6 +18,8 @@ vector<string> DeconvoluteCommand::setParameters(){
 		CommandParameter pname("name", "InputTypes", "", "", "namecount", "none", "none","name",false,false,true); parameters.push_back(pname);
         CommandParameter pcount("count", "InputTypes", "", "", "namecount", "none", "none","count",false,false,true); parameters.push_back(pcount);
         CommandParameter pformat("format", "Multiple", "count-name", "name", "", "", "","",false,false, true); parameters.push_back(pformat);
+        CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
+        CommandParameter pmemory("memory", "Number", "", "4000", "", "", "","",false,false); parameters.push_back(pmemory);
         CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -46,6 +49,8 @@ string DeconvoluteCommand::getHelpString(){
         helpString += "The name parameter is used to provide an existing name file associated with the fasta file. \n";
         helpString += "The count parameter is used to provide an existing count file associated with the fasta file. \n";
         helpString += "The format parameter is used to indicate what type of file you want outputted.  Choices are name and count, default=name unless count file used then default=count.\n";
+        helpString += "The processors parameter allows you to specify the number of processors to use. The default is all available.\n";
+        helpString += "The memory parameter is the memory in MB the unique sequences may use before unique.seqs continues on disk, default=4000.\n";
 		helpString += "The unique.seqs command should be in the following format: \n";
 		helpString += "unique.seqs(fasta=yourFastaFile) \n";	
 		return helpString;
@@ -110,6 +115,13 @@ DeconvoluteCommand::DeconvoluteCommand(string option)  {
 			
             if ((countfile != "") && (namefile != "")) { m->mothurOut("When executing a unique.seqs command you must enter ONLY ONE of the following: count or name.\n");  abort = true; }
 			
+            string temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+            processors = current->setProcessors(temp);
+
+            temp = validParameter.valid(parameters, "memory");	if (temp == "not found"){	temp = "4000";	}
+            util.mothurConvert(temp, memory);
+            if (memory < 1) { m->mothurOut("[WARNING]: memory must be at least 1 MB, using 1.\n"); memory = 1; }
+
             format = validParameter.valid(parameters, "format");
             if(format == "not found"){
                 if (countfile != "") { format = "count";    }
@@ -176,132 +188,122 @@ int DeconvoluteCommand::execute() {
 		
 		if (m->getControl_pressed()) { return 0; }
 		
-		ifstream in; 
+		ifstream in;
 		util.openInputFile(fastafile, in);
-		
-		ofstream outFasta;
-		util.openOutputFile(outFastaFile, outFasta);
-		
-		map<string, string> sequenceStrings; //sequenceString -> list of names.  "atgc...." -> seq1,seq2,seq3.
-		map<string, string>::iterator itStrings;
-		set<string> nameInFastaFile; //for sanity checking
-		set<string>::iterator itname;
-		vector<string> nameFileOrder;
-        CountTable newCt;
+
+		Dereplicator dereplicator(processors, memory * 1000000LL, outputdir + util.getRootName(util.getSimpleName(fastafile)));
+		vector<string> readNames; //read number -> name, the uniques keep their reads as read numbers
+		vector<string> seqs, comments; vector<char> canStart; //reads not yet given to the dereplicator
+		unordered_set<string> nameInFastaFile; //for sanity checking
 		int count = 0;
 		while (!in.eof()) {
-			
-			if (m->getControl_pressed()) { in.close(); outFasta.close(); util.mothurRemove(outFastaFile); return 0; }
-			
+
+			if (m->getControl_pressed()) { in.close(); return 0; }
+
 			Sequence seq(in);
-			
+
 			if (seq.getName() != "") {
-				
+
 				//sanity checks
-				itname = nameInFastaFile.find(seq.getName());
-				if (itname == nameInFastaFile.end()) { nameInFastaFile.insert(seq.getName());  }
-				else { m->mothurOut("[ERROR]: You already have a sequence named " + seq.getName() + " in your fasta file, sequence names must be unique, please correct.\n");  }
+				if (!nameInFastaFile.insert(seq.getName()).second) { m->mothurOut("[ERROR]: You already have a sequence named " + seq.getName() + " in your fasta file, sequence names must be unique, please correct.\n");  }
 
-				itStrings = sequenceStrings.find(seq.getAligned());
-				
-				if (itStrings == sequenceStrings.end()) { //this is a new unique sequence
-					//output to unique fasta file
-					seq.printSequence(outFasta);
-					
-					if (namefile != "") {
-						itNames = nameMap.find(seq.getName());
-						
-						if (itNames == nameMap.end()) { //namefile and fastafile do not match
-							m->mothurOut("[ERROR]: " + seq.getName() + " is in your fasta file, and not in your namefile, please correct.\n"); 
-						}else {
-                            if (format == "name") { sequenceStrings[seq.getAligned()] = itNames->second;  nameFileOrder.push_back(seq.getAligned());
-                            }else {  newCt.push_back(seq.getName(), util.getNumNames(itNames->second)); sequenceStrings[seq.getAligned()] = seq.getName();	nameFileOrder.push_back(seq.getAligned()); }
-						}
-					}else if (countfile != "") {
-                        if (format == "name") {
-                            int numSeqs = ct.getNumSeqs(seq.getName());
-                            string expandedName = seq.getName()+"_0";
-                            for (int i = 1; i < numSeqs; i++) {  expandedName += "," + seq.getName() + "_" + toString(i);  }
-                            sequenceStrings[seq.getAligned()] = expandedName;  nameFileOrder.push_back(seq.getAligned());
-                        }else {
-                            ct.getNumSeqs(seq.getName()); //checks to make sure seq is in table
-                            sequenceStrings[seq.getAligned()] = seq.getName();	nameFileOrder.push_back(seq.getAligned());
-                        }
-                    }else {
-                        if (format == "name") { sequenceStrings[seq.getAligned()] = seq.getName();	nameFileOrder.push_back(seq.getAligned()); }
-                        else {  newCt.push_back(seq.getName()); sequenceStrings[seq.getAligned()] = seq.getName();	nameFileOrder.push_back(seq.getAligned()); }
-                    }
-				}else { //this is a dup
-					if (namefile != "") {
-						itNames = nameMap.find(seq.getName());
-						
-						if (itNames == nameMap.end()) { //namefile and fastafile do not match
-							m->mothurOut("[ERROR]: " + seq.getName() + " is in your fasta file, and not in your namefile, please correct.\n"); 
-						}else {
-                            if (format == "name") { sequenceStrings[seq.getAligned()] += "," + itNames->second;  }
-                            else {  int currentReps = newCt.getNumSeqs(itStrings->second);  newCt.setNumSeqs(itStrings->second, currentReps+(util.getNumNames(itNames->second)));  }
-						}
-                    }else if (countfile != "") {
-                        if (format == "name") {
-                            int numSeqs = ct.getNumSeqs(seq.getName());
-                            string expandedName = seq.getName()+"_0";
-                            for (int i = 1; i < numSeqs; i++) {  expandedName += "," + seq.getName() + "_" + toString(i);  }
-                            sequenceStrings[seq.getAligned()] += "," + expandedName;
-                        }else {
-                            int num = ct.getNumSeqs(seq.getName()); //checks to make sure seq is in table
-                            if (num != 0) { //its in the table
-                                ct.mergeCounts(itStrings->second, seq.getName()); //merges counts and saves in uniques name
-                            }
-                        }
-                    }else {
-                        if (format == "name") {  sequenceStrings[seq.getAligned()] += "," + seq.getName(); }
-                        else {  int currentReps = newCt.getNumSeqs(itStrings->second); newCt.setNumSeqs(itStrings->second, currentReps+1);  }
-                    }
+				//a read that is not in the namefile is still output, but it can't represent the reads after it
+				bool inNameFile = true;
+				if (namefile != "") {
+					if (nameMap.count(seq.getName()) == 0) { //namefile and fastafile do not match
+						m->mothurOut("[ERROR]: " + seq.getName() + " is in your fasta file, and not in your namefile, please correct.\n"); inNameFile = false;
+					}
 				}
+
+				readNames.push_back(seq.getName());
+				seqs.push_back(seq.getAligned()); comments.push_back(seq.getComment()); canStart.push_back(inNameFile);
 				count++;
 			}
-			
+
 			util.gobble(in);
-			
-			if(count % 1000 == 0)	{ m->mothurOutJustToScreen(toString(count) + "\t" + toString(sequenceStrings.size()) + "\n");	}
+
+			if(count % 1000 == 0)	{
+				if (seqs.size() != 0) { dereplicator.add(seqs, comments, canStart); seqs.clear(); comments.clear(); canStart.clear(); }
+				m->mothurOutJustToScreen(toString(count) + "\t" + toString(dereplicator.getNumUniques()) + "\n");
+			}
 		}
-		
-		if(count % 1000 != 0)	{ m->mothurOut(toString(count) + "\t" + toString(sequenceStrings.size())); m->mothurOutEndLine();	}
-		
 		in.close();
-		outFasta.close();
-		
-		if (m->getControl_pressed()) { util.mothurRemove(outFastaFile); return 0; }
-        
+
+		if (seqs.size() != 0) { dereplicator.add(seqs, comments, canStart); }
+		dereplicator.finish();
+
+		if(count % 1000 != 0)	{ m->mothurOut(toString(count) + "\t" + toString(dereplicator.getNumUniques())); m->mothurOutEndLine();	}
+
+		if (m->getControl_pressed()) { return 0; }
+
+		ofstream outFasta;
+		util.openOutputFile(outFastaFile, outFasta);
+
 		//print new names file
 		ofstream outNames;
 		if (format == "name") { util.openOutputFile(outNameFile, outNames); outputNames.push_back(outNameFile); outputTypes["name"].push_back(outNameFile);   }
         else { util.openOutputFile(outCountFile, outNames); outputTypes["count"].push_back(outCountFile); outputNames.push_back(outCountFile);                }
-        
+
+        CountTable newCt;
         if ((countfile != "") && (format == "count")) { ct.printHeaders(outNames); }
         else if ((countfile == "") && (format == "count")) { newCt.printHeaders(outNames); }
-		
-		for (int i = 0; i < nameFileOrder.size(); i++) {
-			if (m->getControl_pressed()) { outputTypes.clear(); util.mothurRemove(outFastaFile); outNames.close(); for (int j = 0; j < outputNames.size(); j++) { util.mothurRemove(outputNames[j]); } return 0; }
-			
-			itStrings = sequenceStrings.find(nameFileOrder[i]);
-			
-			if (itStrings != sequenceStrings.end()) {
-                if (format == "name") {
-                    //get rep name
-                    int pos = (itStrings->second).find_first_of(',');
-                    
-                    if (pos == string::npos) { // only reps itself
-                        outNames << itStrings->second << '\t' << itStrings->second << endl;
-                    }else {
-                        outNames << (itStrings->second).substr(0, pos) << '\t' << itStrings->second << endl;
-                    }
-                }else {
-                    if (countfile != "") {  ct.printSeq(outNames, itStrings->second);  }
-                    else if (format == "count")  {  newCt.printSeq(outNames, itStrings->second);  }
-                }
-			}else{ m->mothurOut("[ERROR]: mismatch in namefile print.\n");  m->setControl_pressed(true); }
+
+		//uniques come back in the order of their first reads, the first read is the unique's representative
+		DerepUnique unique;
+		while (dereplicator.getNext(unique)) {
+			if (m->getControl_pressed()) { outputTypes.clear(); outFasta.close(); util.mothurRemove(outFastaFile); outNames.close(); for (int j = 0; j < outputNames.size(); j++) { util.mothurRemove(outputNames[j]); } return 0; }
+
+			string repName = readNames[unique.reads[0]];
+			outFasta << ">" << repName << unique.comment << endl << unique.seq << endl;
+
+			if (!unique.registered) { continue; } //representative is not in the namefile
+
+			if (format == "name") {
+				string names = "";
+				for (int i = 0; i < unique.reads.size(); i++) {
+					string readName = readNames[unique.reads[i]];
+					string theseNames = readName;
+					if (namefile != "") {
+						itNames = nameMap.find(readName);
+						if (itNames == nameMap.end()) { continue; }
+						theseNames = itNames->second;
+					}else if (countfile != "") {
+						int numSeqs = ct.getNumSeqs(readName);
+						theseNames = readName + "_0";
+						for (int j = 1; j < numSeqs; j++) {  theseNames += "," + readName + "_" + toString(j);  }
+					}
+					if (i != 0) { names += ","; }
+					names += theseNames;
+				}
+
+				//get rep name
+				int pos = names.find_first_of(',');
+
+				if (pos == string::npos) { // only reps itself
+					outNames << names << '\t' << names << endl;
+				}else {
+					outNames << names.substr(0, pos) << '\t' << names << endl;
+				}
+			}else if (countfile != "") {
+				ct.getNumSeqs(repName); //checks to make sure seq is in table
+				for (int i = 1; i < unique.reads.size(); i++) {
+					string readName = readNames[unique.reads[i]];
+					if (ct.getNumSeqs(readName) != 0) { ct.mergeCounts(repName, readName); } //merges counts and saves in uniques name
+				}
+				ct.printSeq(outNames, repName);
+			}else {
+				int total = 0;
+				for (int i = 0; i < unique.reads.size(); i++) {
+					if (namefile != "") {
+						itNames = nameMap.find(readNames[unique.reads[i]]);
+						if (itNames != nameMap.end()) { total += util.getNumNames(itNames->second); }
+					}else { total++; }
+				}
+				newCt.push_back(repName, total);
+				newCt.printSeq(outNames, repName);
+			}
 		}
+		outFasta.close();
 		outNames.close();
 		
 		if (m->getControl_pressed()) { outputTypes.clear(); util.mothurRemove(outFastaFile); for (int j = 0; j < outputNames.size(); j++) { util.mothurRemove(outputNames[j]); }  return 0; }
@@ -15,11 +15,12 @@ vector<string> DistanceCommand::setParameters(){
 		CommandParameter pcolumn("column", "InputTypes", "", "", "none", "none", "OldFastaColumn","column",false,false); parameters.push_back(pcolumn);
 		CommandParameter poldfasta("oldfasta", "InputTypes", "", "", "none", "none", "OldFastaColumn","",false,false); parameters.push_back(poldfasta);
 		CommandParameter pfasta("fasta", "InputTypes", "", "", "none", "none", "none","phylip-column",false,true, true); parameters.push_back(pfasta);
-		CommandParameter poutput("output", "Multiple", "column-lt-square-phylip", "column", "", "", "","phylip-column",false,false, true); parameters.push_back(poutput);
+		CommandParameter poutput("output", "Multiple", "column-lt-square-phylip-binary", "column", "", "", "","phylip-column-binary",false,false, true); parameters.push_back(poutput);
 		CommandParameter pcalc("calc", "Multiple", "nogaps-eachgap-onegap", "onegap", "", "", "","",false,false); parameters.push_back(pcalc);
 		CommandParameter pcountends("countends", "Boolean", "", "T", "", "", "","",false,false); parameters.push_back(pcountends);
         CommandParameter pfitcalc("fitcalc", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pfitcalc);
 		CommandParameter pcompress("compress", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pcompress);
+        CommandParameter pfloat16("float16", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pfloat16);
 		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false, true); parameters.push_back(pprocessors);
 		CommandParameter pcutoff("cutoff", "Number", "", "1.0", "", "", "","",false,false, true); parameters.push_back(pcutoff);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
@@ -31,6 +32,7 @@ vector<string> DistanceCommand::setParameters(){
         vector<string> tempOutNames;
         outputTypes["phylip"] = tempOutNames;
         outputTypes["column"] = tempOutNames;
+        outputTypes["binary"] = tempOutNames;
         
 		vector<string> myArray;
 		for (int i = 0; i < parameters.size(); i++) {	myArray.push_back(parameters[i].name);		}
@@ -46,13 +48,15 @@ string DistanceCommand::getHelpString(){
 	try {
 		string helpString = "";
 		helpString += "The dist.seqs command reads a file containing sequences and creates a distance file.\n";
-		helpString += "The dist.seqs command parameters are fasta, oldfasta, column, calc, countends, output, compress, cutoff and processors.  \n";
+		helpString += "The dist.seqs command parameters are fasta, oldfasta, column, calc, countends, output, float16, compress, cutoff and processors.  \n";
 		helpString += "The fasta parameter is required, unless you have a valid current fasta file.\n";
 		helpString += "The oldfasta and column parameters allow you to append the distances calculated to the column file.\n";
 		helpString += "The calc parameter allows you to specify the method of calculating the distances.  Your options are: nogaps, onegap or eachgap. The default is onegap.\n";
 		helpString += "The countends parameter allows you to specify whether to include terminal gaps in distance.  Your options are: T or F. The default is T.\n";
 		helpString += "The cutoff parameter allows you to specify maximum distance to keep. The default is 1.0.\n";
-		helpString += "The output parameter allows you to specify format of your distance matrix. Options are column, lt, and square. The default is column.\n";
+		helpString += "The output parameter allows you to specify format of your distance matrix. Options are column, lt, square and binary. The default is column.\n";
+		helpString += "The binary output stores the distances below the cutoff in a compact file the clustering commands read in place. Give it to cluster or cluster.split as the column file, it is not made the current column file.\n";
+		helpString += "The float16 parameter allows you to store the binary distances as half precision floats, halving the size of the distances. The default is false.\n";
 		helpString += "The processors parameter allows you to specify number of processors to use.  The default is 1.\n";
 		helpString += "The compress parameter allows you to indicate that you want the resulting distance file compressed.  The default is false.\n";
 		helpString += "The dist.seqs command should be in the following format: \n";
@@ -72,6 +76,7 @@ string DistanceCommand::getOutputPattern(string type) {
         
         if (type == "phylip") {  pattern = "[filename],[outputtag],dist"; } 
         else if (type == "column") { pattern = "[filename],dist-[filename],[outputtag],dist"; }
+        else if (type == "binary") { pattern = "[filename],[outputtag],dist"; }
         else { m->mothurOut("[ERROR]: No definition for type " + type + " output pattern.\n"); m->setControl_pressed(true);  }
         
         return pattern;
@@ -149,12 +154,18 @@ DistanceCommand::DistanceCommand(string option) {
 
 			output = validParameter.valid(parameters, "output");		if(output == "not found"){	output = "column"; }
             if (output == "phylip") { output = "lt";  }
+            
+            temp = validParameter.valid(parameters, "float16");		if(temp == "not found"){  temp = "F"; }
+			float16 = util.isTrue(temp);
 			
 			if (((column != "") && (oldfastafile == "")) || ((column == "") && (oldfastafile != ""))) { m->mothurOut("If you provide column or oldfasta, you must provide both.\n");  abort=true; }
 			
 			if ((column != "") && (oldfastafile != "") && (output != "column")) { m->mothurOut("You have provided column and oldfasta, indicating you want to append distances to your column file. Your output must be in column format to do so.\n"); abort=true; }
 			
-			if ((output != "column") && (output != "lt") && (output != "square")) { m->mothurOut(output + " is not a valid output form. Options are column, lt and square. I will use column.\n");  output = "column"; }
+			if ((output != "column") && (output != "lt") && (output != "square") && (output != "binary")) { m->mothurOut(output + " is not a valid output form. Options are column, lt, square and binary. I will use column.\n");  output = "column"; }
+            
+            if ((output == "binary") && fitCalc) { m->mothurOut("[ERROR]: fitcalc requires column output.\n"); abort=true; }
+            if ((output == "binary") && util.isTrue(compress)) { m->mothurOut("[WARNING]: binary distance files are read in place, ignoring compress.\n"); compress = "F"; }
             
             if ((calc != "onegap") && (calc != "eachgap") && (calc != "nogaps")) { m->mothurOut(calc + " is not a valid output form. Options are eachgap, onegap and nogaps. I'll use onegap.\n");  calc = "onegap";  }
 
@@ -274,13 +285,17 @@ int DistanceCommand::execute(){
 			}
 			
 			util.mothurRemove(outputFile);
+		}else if (output == "binary") { //user wants binary format, only the clustering commands read it
+            variables["[outputtag]"] = "binary";
+			outputFile = getOutputFileName("binary", variables);
+			util.mothurRemove(outputFile); outputTypes["binary"].push_back(outputFile);
 		}else { //assume square
 			variables["[outputtag]"] = "square";
 			outputFile = getOutputFileName("phylip", variables);
 			util.mothurRemove(outputFile);
 			outputTypes["phylip"].push_back(outputFile);
 		}
-        m->mothurOut("\nSequence\tTime\tNum_Dists_Below_Cutoff\n");
+        m->mothurOut("\nTile\tTime\tNum_Dists_Below_Cutoff\n");
                      
         createProcesses(outputFile);
 		
@@ -344,6 +359,32 @@ int DistanceCommand::execute(){
 	}
 }
 /**************************************************************************************************/
+//adds "nameA nameB dist" to the buffer, formatting dist like toString(dist) without the stringstream
+static void appendDistance(string& buffer, const string& nameA, const string& nameB, double dist){
+    char distString[32];
+    int length = snprintf(distString, sizeof(distString), "%g", dist);
+    
+    buffer.append(nameA); buffer += ' ';
+    buffer.append(nameB); buffer += ' ';
+    buffer.append(distString, length); buffer += '\n';
+}
+/**************************************************************************************************/
+//adds dist to the buffer the way the phylip files have always printed them, precision 4
+static void appendPhylipDistance(string& buffer, double dist){
+    char distString[32];
+    int length = snprintf(distString, sizeof(distString), "%.4g", dist);
+    
+    buffer.append(distString, length);
+}
+/**************************************************************************************************/
+static void reportTile(distanceData* params, long long count, int startTime){
+    long long numDone = params->scheduler->tileDone(count);
+    
+    if ((numDone % 100 == 0) || (numDone == params->scheduler->getNumTiles())) {
+        params->m->mothurOutJustToScreen(toString(numDone) + "\t" + toString(time(NULL) - startTime) + "\t" + toString(params->scheduler->getNumBelowCutoff()) +"\n");
+    }
+}
+/**************************************************************************************************/
 void driverColumn(distanceData* params){
     try {
         ValidCalculators validCalculator;
@@ -366,30 +407,34 @@ void driverColumn(distanceData* params){
        
         params->count = 0;
         string buffer = "";
-        for(int i=params->startLine;i<params->endLine;i++){
+        DistanceTile tile;
+        while (params->scheduler->getNextTile(params->threadID, tile)) {
             
-            Sequence seqI = params->alignDB.get(i);
-            for(int j=0;j<i;j++){
-                
-                if (params->m->getControl_pressed()) { break;  }
-                
-                if ((i >= params->numNewFasta) && (j >= params->numNewFasta)) { break; }
-                
-                Sequence seqJ = params->alignDB.get(j);
-                double dist = distCalculator->calcDist(seqI, seqJ);
+            if (params->m->getControl_pressed()) { break;  }
+            
+            long long count = 0;
+            for(long long i=tile.rowStart;i<tile.rowEnd;i++){
                 
-                if(dist <= params->cutoff){
-                    buffer += (seqI.getName() + " " + seqJ.getName() + " " + toString(dist) + "\n");
-                    params->count++;
+                const EncodedSeq& seqI = params->alignDB->get(i);
+                long long colEnd = min(tile.colEnd, i);
+                for(long long j=tile.colStart;j<colEnd;j++){
+                    
+                    if ((i >= params->numNewFasta) && (j >= params->numNewFasta)) { break; }
+                    
+                    double dist = distCalculator->calcDist(seqI, params->alignDB->get(j));
+                    
+                    if(dist <= params->cutoff){
+                        appendDistance(buffer, params->alignDB->getName(i), params->alignDB->getName(j), dist);
+                        count++;
+                    }
                 }
             }
             
-            if(i % 100 == 0){ params->threadWriter->write(buffer);  buffer = ""; params->m->mothurOutJustToScreen(toString(i) + "\t" + toString(time(NULL) - startTime) + "\t" + toString(params->count) +"\n"); }
+            params->threadWriter->write(buffer); buffer.clear();
+            params->count += count;
             
+            reportTile(params, count, startTime);
         }
-        params->threadWriter->write(buffer);
-        
-        if((params->endLine-1) % 100 != 0){ params->m->mothurOutJustToScreen(toString(params->endLine-1) + "\t" + toString(time(NULL) - startTime) + "\t" + toString(params->count) +"\n"); }
         
         delete distCalculator;
     }
@@ -419,45 +464,50 @@ void driverLt(distanceData* params){
         }
         
         int startTime = time(NULL);
-        long long numSeqs = params->alignDB.getNumSeqs();
-        
-        //column file
-        ofstream outFile;
-        params->util.openOutputFile(params->outputFileName, outFile);
-        outFile.setf(ios::fixed, ios::showpoint);
-        outFile << setprecision(4);
-        
-        if(params->startLine == 0){	outFile << numSeqs << endl;	}
-        
         
         params->count = 0;
-        for(int i=params->startLine;i<params->endLine;i++){
+        vector<string> rows;
+        string buffer = "";
+        DistanceTile tile;
+        while (params->scheduler->getNextTile(params->threadID, tile)) {
             
-            string name = params->alignDB.get(i).getName();
-            if (name.length() < 10) {  while (name.length() < 10) {  name += " ";  } }
-            outFile << name;
+            if (params->m->getControl_pressed()) { break;  }
             
-            for(int j=0;j<i;j++){
-                
-                if (params->m->getControl_pressed()) { break;  }
-                
-                if ((i >= params->numNewFasta) && (j >= params->numNewFasta)) { break; }
-                
-                double dist = distCalculator->calcDist(params->alignDB.get(i), params->alignDB.get(j));
-                
-                if(dist <= params->cutoff){ params->count++; }
-                outFile  << '\t' << dist;
+            rows.assign(tile.rowEnd-tile.rowStart, "");
+            for(long long i=tile.rowStart;i<tile.rowEnd;i++){
+                string& row = rows[i-tile.rowStart];
+                row = params->alignDB->getName(i);
+                if (row.length() < 10) {  while (row.length() < 10) {  row += " ";  } }
             }
             
-            outFile << endl;
+            //fill the rows a block of columns at a time, so the column sequences stay in cache
+            long long count = 0;
+            for(long long colStart=0;colStart<tile.rowEnd-1;colStart+=params->tileSize){
+                for(long long i=tile.rowStart;i<tile.rowEnd;i++){
+                    
+                    const EncodedSeq& seqI = params->alignDB->get(i);
+                    string& row = rows[i-tile.rowStart];
+                    long long colEnd = min(colStart+params->tileSize, i);
+                    for(long long j=colStart;j<colEnd;j++){
+                        
+                        if ((i >= params->numNewFasta) && (j >= params->numNewFasta)) { break; }
+                        
+                        double dist = distCalculator->calcDist(seqI, params->alignDB->get(j));
+                        
+                        if(dist <= params->cutoff){ count++; }
+                        row += '\t'; appendPhylipDistance(row, dist);
+                    }
+                }
+            }
             
-            if(i % 100 == 0){ params->m->mothurOutJustToScreen(toString(i) + "\t" + toString(time(NULL) - startTime) + "\t" + toString(params->count) +"\n"); }
+            buffer.clear();
+            for (int k = 0; k < rows.size(); k++) { buffer += rows[k]; buffer += '\n'; }
+            params->orderedWriter->write(tile.index, buffer);
+            params->count += count;
             
+            reportTile(params, count, startTime);
         }
         
-        if((params->endLine-1) % 100 != 0){ params->m->mothurOutJustToScreen(toString(params->endLine-1) + "\t" + toString(time(NULL) - startTime) + "\t" + toString(params->count) +"\n"); }
-        
-        outFile.close();
         delete distCalculator;
     }
     catch(exception& e) {
@@ -486,43 +536,51 @@ void driverSquare(distanceData* params){
         }
         int startTime = time(NULL);
         
-        //column file
-        ofstream outFile;
-        params->util.openOutputFile(params->outputFileName, outFile);
-        outFile.setf(ios::fixed, ios::showpoint);
-        outFile << setprecision(4);
-        
-        long long numSeqs = params->alignDB.getNumSeqs();
-        if(params->startLine == 0){	outFile << numSeqs << endl;	}
+        long long numSeqs = params->alignDB->getNumSeqs();
         
         params->count = 0;
-        for(int i=params->startLine;i<params->endLine;i++){
+        vector<string> rows;
+        string buffer = "";
+        DistanceTile tile;
+        while (params->scheduler->getNextTile(params->threadID, tile)) {
             
-            string name = params->alignDB.get(i).getName();
-            //pad with spaces to make compatible
-            if (name.length() < 10) { while (name.length() < 10) {  name += " ";  } }
+            if (params->m->getControl_pressed()) { break;  }
             
-            outFile << name << '\t';
+            rows.assign(tile.rowEnd-tile.rowStart, "");
+            for(long long i=tile.rowStart;i<tile.rowEnd;i++){
+                string& row = rows[i-tile.rowStart];
+                row = params->alignDB->getName(i);
+                //pad with spaces to make compatible
+                if (row.length() < 10) { while (row.length() < 10) {  row += " ";  } }
+                row += '\t';
+            }
             
-            for(int j=0;j<numSeqs;j++){
-                
-                if (params->m->getControl_pressed()) { break; }
-                
-                double dist = distCalculator->calcDist(params->alignDB.get(i), params->alignDB.get(j));
-                
-                if(dist <= params->cutoff){ params->count++; }
-                
-                outFile << dist << '\t'; 
+            //fill the rows a block of columns at a time, so the column sequences stay in cache
+            long long count = 0;
+            for(long long colStart=0;colStart<numSeqs;colStart+=params->tileSize){
+                long long colEnd = min(colStart+params->tileSize, numSeqs);
+                for(long long i=tile.rowStart;i<tile.rowEnd;i++){
+                    
+                    const EncodedSeq& seqI = params->alignDB->get(i);
+                    string& row = rows[i-tile.rowStart];
+                    for(long long j=colStart;j<colEnd;j++){
+                        
+                        double dist = distCalculator->calcDist(seqI, params->alignDB->get(j));
+                        
+                        if(dist <= params->cutoff){ count++; }
+                        appendPhylipDistance(row, dist); row += '\t';
+                    }
+                }
             }
             
-            outFile << endl; 
+            buffer.clear();
+            for (int k = 0; k < rows.size(); k++) { buffer += rows[k]; buffer += '\n'; }
+            params->orderedWriter->write(tile.index, buffer);
+            params->count += count;
             
-            if(i % 100 == 0){ params->m->mothurOutJustToScreen(toString(i) + "\t" + toString(time(NULL) - startTime) + "\t" + toString(params->count) +"\n");  }
+            reportTile(params, count, startTime);
         }
         
-        if((params->endLine-1) % 100 != 0){ params->m->mothurOutJustToScreen(toString(params->endLine-1) + "\t" + toString(time(NULL) - startTime) + "\t" + toString(params->count) +"\n"); }
-        
-        outFile.close();
         delete distCalculator;
     }
     catch(exception& e) {
@@ -531,6 +589,80 @@ void driverSquare(distanceData* params){
     }
 }
 /**************************************************************************************************/
+void driverBinary(distanceData* params){
+    try {
+        ValidCalculators validCalculator;
+        DistCalc* distCalculator;
+        if (params->countends) {
+            if (validCalculator.isValidCalculator("distance", params->calc) ) {
+                if (params->calc == "nogaps")			{	distCalculator = new ignoreGaps(params->cutoff);	}
+                else if (params->calc == "eachgap")	{	distCalculator = new eachGapDist(params->cutoff);	}
+                else if (params->calc == "onegap")		{	distCalculator = new oneGapDist(params->cutoff);	}
+            }
+        }else {
+            if (validCalculator.isValidCalculator("distance", params->calc) ) {
+                if (params->calc == "nogaps")		{	distCalculator = new ignoreGaps(params->cutoff);					}
+                else if (params->calc == "eachgap"){	distCalculator = new eachGapIgnoreTermGapDist(params->cutoff);	}
+                else if (params->calc == "onegap")	{	distCalculator = new oneGapIgnoreTermGapDist(params->cutoff);		}
+            }
+        }
+        
+        int startTime = time(NULL);
+        
+        params->count = 0;
+        vector< vector<uint32_t> > columns;
+        vector< vector<float> > dists;
+        BinaryDistRows rows;
+        DistanceTile tile;
+        while (params->scheduler->getNextTile(params->threadID, tile)) {
+            
+            if (params->m->getControl_pressed()) { break;  }
+            
+            columns.assign(tile.rowEnd-tile.rowStart, vector<uint32_t>());
+            dists.assign(tile.rowEnd-tile.rowStart, vector<float>());
+            
+            //fill the rows a block of columns at a time, so the column sequences stay in cache
+            long long count = 0;
+            for(long long colStart=0;colStart<tile.rowEnd-1;colStart+=params->tileSize){
+                for(long long i=tile.rowStart;i<tile.rowEnd;i++){
+                    
+                    const EncodedSeq& seqI = params->alignDB->get(i);
+                    long long colEnd = min(colStart+params->tileSize, i);
+                    for(long long j=colStart;j<colEnd;j++){
+                        
+                        if ((i >= params->numNewFasta) && (j >= params->numNewFasta)) { break; }
+                        
+                        double dist = distCalculator->calcDist(seqI, params->alignDB->get(j));
+                        
+                        if(dist <= params->cutoff){
+                            columns[i-tile.rowStart].push_back(j);
+                            dists[i-tile.rowStart].push_back(dist);
+                            count++;
+                        }
+                    }
+                }
+            }
+            
+            rows.clear();
+            for (int k = 0; k < columns.size(); k++) {
+                rows.columns.insert(rows.columns.end(), columns[k].begin(), columns[k].end());
+                rows.dists.insert(rows.dists.end(), dists[k].begin(), dists[k].end());
+                rows.endRow();
+            }
+            params->binaryWriter->write(tile.index, rows);
+            params->count += count;
+            
+            reportTile(params, count, startTime);
+        }
+        
+        delete distCalculator;
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "DistanceCommand", "driverBinary");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
 void driverFitCalc(distanceData* params){
     try {
         ValidCalculators validCalculator;
@@ -552,28 +684,31 @@ void driverFitCalc(distanceData* params){
         int startTime = time(NULL);
         params->count = 0;
         string buffer = "";
-        for(int i=params->startLine;i<params->endLine;i++){
+        DistanceTile tile;
+        while (params->scheduler->getNextTile(params->threadID, tile)) {
             
-            Sequence seqI = params->oldFastaDB.get(i);
-            for(int j = 0; j < params->alignDB.getNumSeqs(); j++){
-                
-                if (params->m->getControl_pressed()) { break;  }
-                
-                Sequence seqJ = params->alignDB.get(j);
-                double dist = distCalculator->calcDist(seqI, seqJ);
+            if (params->m->getControl_pressed()) { break;  }
+            
+            long long count = 0;
+            for(long long i=tile.rowStart;i<tile.rowEnd;i++){
                 
-                if(dist <= params->cutoff){
-                    buffer += seqI.getName() + " " + seqJ.getName() + " " + toString(dist) + "\n";
-                    params->count++;
+                const EncodedSeq& seqI = params->oldFastaDB->get(i);
+                for(long long j=tile.colStart;j<tile.colEnd;j++){
+                    
+                    double dist = distCalculator->calcDist(seqI, params->alignDB->get(j));
+                    
+                    if(dist <= params->cutoff){
+                        appendDistance(buffer, params->oldFastaDB->getName(i), params->alignDB->getName(j), dist);
+                        count++;
+                    }
                 }
             }
             
-            if(i % 100 == 0){ params->threadWriter->write(buffer);  buffer = ""; params->m->mothurOutJustToScreen(toString(i) + "\t" + toString(time(NULL) - startTime) + "\t" + toString(params->count) +"\n"); }
+            params->threadWriter->write(buffer); buffer.clear();
+            params->count += count;
             
+            reportTile(params, count, startTime);
         }
-        params->threadWriter->write(buffer);
-        
-        if((params->endLine-1) % 100 != 0){ params->m->mothurOutJustToScreen(toString(params->endLine-1) + "\t" + toString(time(NULL) - startTime) + "\t" + toString(params->count) +"\n"); }
         
         delete distCalculator;
 
@@ -601,22 +736,12 @@ void DistanceCommand::createProcesses(string filename) {
         else { for(int i=0;i<numSeqs;i++){ for(int j=0;j<i;j++){ numDists++; if (numDists > processors) { break; } } } }
         if (numDists < processors) { processors = numDists; }
         
-        vector<linePair> lines;
-        for (int i = 0; i < processors; i++) {
-            linePair tempLine;
-            lines.push_back(tempLine);
-            if (output != "square") {
-                lines[i].start = int (sqrt(float(i)/float(processors)) * numSeqs);
-                lines[i].end = int (sqrt(float(i+1)/float(processors)) * numSeqs);
-            }else{
-                lines[i].start = int ((float(i)/float(processors)) * numSeqs);
-                lines[i].end = int ((float(i+1)/float(processors)) * numSeqs);
-            }
+        std::shared_ptr<SynchronizedOutputFile> synchronizedOutputFile;
+        if (output != "binary") {
+            synchronizedOutputFile = std::make_shared<SynchronizedOutputFile>(filename);
+            synchronizedOutputFile->setFixedShowPoint(); synchronizedOutputFile->setPrecision(4);
         }
         
-        auto synchronizedOutputFile = std::make_shared<SynchronizedOutputFile>(filename);
-        synchronizedOutputFile->setFixedShowPoint(); synchronizedOutputFile->setPrecision(4);
-        
         SequenceDB oldFastaDB;
         if (fitCalc) {
             ifstream inFASTA;
@@ -624,29 +749,48 @@ void DistanceCommand::createProcesses(string filename) {
             oldFastaDB = SequenceDB(inFASTA);
             inFASTA.close();
             
-            lines.clear();
             if (processors > oldFastaDB.getNumSeqs()) { processors = oldFastaDB.getNumSeqs(); }
-            int remainingSeqs = oldFastaDB.getNumSeqs();
-            int startIndex = 0;
-            for (int remainingProcessors = processors; remainingProcessors > 0; remainingProcessors--) {
-                int numSeqsToFit = remainingSeqs; //case for last processor
-                if (remainingProcessors != 1) { numSeqsToFit = ceil(remainingSeqs / remainingProcessors); }
-                lines.push_back(linePair(startIndex, (startIndex+numSeqsToFit))); //startIndex, endIndex
-                startIndex = startIndex + numSeqsToFit;
-                remainingSeqs -= numSeqsToFit;
-            }
+        }
+        
+        //pack the sequences once, all threads share the packed rows
+        PackedSequenceDB packedDB(alignDB);
+        PackedSequenceDB packedOldFastaDB(oldFastaDB);
+        
+        m->mothurOutJustToLog("Using " + BitDistance::getKernelName() + " distance kernels for " + toString(packedDB.getNumEncoded()) + " of " + toString(packedDB.getNumSeqs()) + " sequences.\n");
+        
+        //split the matrix into tiles the threads take as they go
+        long long bytesPerRow = packedDB.getRowWidth() + EncodedSeq::getNumPlaneWords(packedDB.getRowWidth()) * sizeof(uint64_t);
+        long long numRows = numSeqs; if (fitCalc) { numRows = packedOldFastaDB.getNumSeqs(); }
+        long long tileSize = TileScheduler::getTileSize(bytesPerRow, numRows, processors);
+        
+        vector<DistanceTile> tiles;
+        if (output == "column") {
+            if (fitCalc)    { tiles = TileScheduler::getRectangleTiles(numRows, numSeqs, tileSize);  }
+            else            { tiles = TileScheduler::getTriangleTiles(numSeqs, tileSize);            }
+        }else               { tiles = TileScheduler::getRowTiles(numSeqs, numSeqs, tileSize);        }
+        
+        //the phylip and binary files are written in row order, so the threads share one run of tiles and few tiles wait to be written
+        int numRuns = processors; if (output != "column") { numRuns = 1; }
+        TileScheduler scheduler(tiles, numRuns);
+        
+        OrderedOutputWriter* orderedWriter = NULL;
+        BinaryDistWriter* binaryWriter = NULL;
+        if (output == "binary") {
+            vector<string> names;
+            for (long long i = 0; i < numSeqs; i++) { names.push_back(packedDB.getName(i)); }
+            binaryWriter = new BinaryDistWriter(filename, names, float16, tiles.size());
+        }else if (output != "column") {
+            synchronizedOutputFile->write(toString(numSeqs) + "\n");
+            orderedWriter = new OrderedOutputWriter(synchronizedOutputFile);
         }
         
         //Lauch worker threads
         for (int i = 0; i < processors-1; i++) {
-            OutputWriter* threadWriter = NULL;
             distanceData* dataBundle = NULL;
-            string extension = toString(i+1) + ".temp";
-            if (output == "column") {
-                threadWriter = new OutputWriter(synchronizedOutputFile);
-                dataBundle = new distanceData(threadWriter);
-            }else { dataBundle = new distanceData(filename+extension); }
-            dataBundle->setVariables(lines[i+1].start, lines[i+1].end, cutoff, alignDB, oldFastaDB, calc, numNewFasta, countends);
+            if (output == "column")         { dataBundle = new distanceData(new OutputWriter(synchronizedOutputFile));    }
+            else if (output == "binary")    { dataBundle = new distanceData(binaryWriter);                                }
+            else                            { dataBundle = new distanceData(orderedWriter);                               }
+            dataBundle->setVariables(i+1, &scheduler, tileSize, cutoff, &packedDB, &packedOldFastaDB, calc, numNewFasta, countends);
             data.push_back(dataBundle);
             
             std::thread* thisThread = NULL;
@@ -655,6 +799,7 @@ void DistanceCommand::createProcesses(string filename) {
                 else            {  thisThread = new std::thread(driverColumn, dataBundle);   }
             }
             else if (output == "lt")    { thisThread = new std::thread(driverLt, dataBundle);            }
+            else if (output == "binary"){ thisThread = new std::thread(driverBinary, dataBundle);        }
             else                        { thisThread = new std::thread(driverSquare, dataBundle);        }
             workerThreads.push_back(thisThread);
         }
@@ -664,32 +809,31 @@ void DistanceCommand::createProcesses(string filename) {
         if (output == "column") {
             threadWriter = new OutputWriter(synchronizedOutputFile);
             dataBundle = new distanceData(threadWriter);
-        }else { dataBundle = new distanceData(filename); }
-        dataBundle->setVariables(lines[0].start, lines[0].end, cutoff, alignDB, oldFastaDB, calc, numNewFasta, countends);
+        }else if (output == "binary")   { dataBundle = new distanceData(binaryWriter);    }
+        else                            { dataBundle = new distanceData(orderedWriter);   }
+        dataBundle->setVariables(0, &scheduler, tileSize, cutoff, &packedDB, &packedOldFastaDB, calc, numNewFasta, countends);
         
         if (output == "column")     {
             if (fitCalc)    { driverFitCalc(dataBundle);    }
             else            { driverColumn(dataBundle);     }
         }
         else if (output == "lt")    { driverLt(dataBundle);            }
+        else if (output == "binary"){ driverBinary(dataBundle);        }
         else                        { driverSquare(dataBundle);        }
         distsBelowCutoff = dataBundle->count;
         
-        
         for (int i = 0; i < processors-1; i++) {
             workerThreads[i]->join();
             
             distsBelowCutoff += data[i]->count;
             if (output == "column") {  delete data[i]->threadWriter; }
-            else {
-                string extension = toString(i+1) + ".temp";
-                util.appendFiles((filename+extension), filename);
-                util.mothurRemove(filename+extension);
-            }
             delete data[i];
             delete workerThreads[i];
         }
-        if (output == "column")     { synchronizedOutputFile->close(); delete threadWriter; }
+        if (output == "binary")     { binaryWriter->close(); delete binaryWriter;   }
+        else                        { synchronizedOutputFile->close();              }
+        if (output == "column")     { delete threadWriter;   }
+        else                        { delete orderedWriter;  }
         delete dataBundle;
         
         time(&end);
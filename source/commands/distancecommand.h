@@ -15,38 +15,57 @@
 #include "validcalculator.h"
 #include "calculator.h"
 #include "sequencedb.h"
+#include "packedsequencedb.hpp"
 #include "ignoregaps.h"
 #include "eachgapdist.h"
 #include "eachgapignore.h"
 #include "onegapdist.h"
 #include "onegapignore.h"
 #include "writer.h"
+#include "tilescheduler.hpp"
+#include "binarydistfile.hpp"
 
 /**************************************************************************************************/
 struct distanceData {
-    long long startLine, endLine, numNewFasta, count;
+    long long numNewFasta, count, tileSize;
+    int threadID;
 	float cutoff;
-    SequenceDB alignDB;
-    SequenceDB oldFastaDB;
+    const PackedSequenceDB* alignDB;
+    const PackedSequenceDB* oldFastaDB;
+    TileScheduler* scheduler;
 	MothurOut* m;
 	OutputWriter* threadWriter;
-    string outputFileName, calc;
+    OrderedOutputWriter* orderedWriter;
+    BinaryDistWriter* binaryWriter;
+    string calc;
 	bool countends;
     Utils util;
 	
 	distanceData(){}
     distanceData(OutputWriter* ofn) {
         threadWriter = ofn;
+        orderedWriter = NULL;
+        binaryWriter = NULL;
+        m = MothurOut::getInstance();
+    }
+    
+    distanceData(OrderedOutputWriter* ofn) {
+        orderedWriter = ofn;
+        threadWriter = NULL;
+        binaryWriter = NULL;
         m = MothurOut::getInstance();
     }
     
-    distanceData(string ofn) {
-        outputFileName = ofn;
+    distanceData(BinaryDistWriter* ofn) {
+        binaryWriter = ofn;
+        threadWriter = NULL;
+        orderedWriter = NULL;
         m = MothurOut::getInstance();
     }
-	void setVariables(int s, int e,  float c, SequenceDB db, SequenceDB oldfn, string Est, long long num, bool cnt) {
-		startLine = s;
-		endLine = e;
+	void setVariables(int tid, TileScheduler* sched, long long ts, float c, const PackedSequenceDB* db, const PackedSequenceDB* oldfn, string Est, long long num, bool cnt) {
+        threadID = tid;
+        scheduler = sched;
+        tileSize = ts;
 		cutoff = c;
 		alignDB = db;
         oldFastaDB = oldfn;
@@ -84,7 +103,7 @@ private:
     long long numNewFasta, numSeqs, numDistsBelowCutoff;
 	float cutoff;
 	
-	bool abort, countends, fitCalc;
+	bool abort, countends, fitCalc, float16;
 	vector<string> outputNames; 
 	
 	void createProcesses(string);
@@ -186,35 +186,49 @@ int DistSharedCommand::execute(){
         set<string> userLabels = labels;
         string lastLabel = "";
         
-        SharedRAbundVectors* lookup = util.getNextShared(input, allLines, userLabels, processedLabels, lastLabel);
-        Groups = lookup->getNamesGroups();
+        //without subsampling the engine computes every calculator from the sparse tables, the dense samples aren't needed
+        bool useTables = (!subsample) && input.hasLabelIndex();
+        for (int i = 0; i < Estimators.size(); i++) { if (!BetaDiversityEngine::isBatched(Estimators[i])) { useTables = false; } }
+        
+        if (useTables) { processTables(input, userLabels, processedLabels, lastLabel); }
+        else {
+            vector<SharedRAbundVectors*> lookups = util.getNextShared(input, allLines, userLabels, processedLabels, lastLabel, 1);
+            if (lookups.size() == 0) { return 0; }
+            SharedRAbundVectors* lookup = lookups[0];
+            Groups = lookup->getNamesGroups();
 					
-        if (lookup->size() < 2) { m->mothurOut("[ERROR]: You have not provided enough valid groups.  I cannot run the command.\n");  delete lookup; return 0;}
-        
-        if (subsample) { 
-            if (subsampleSize == -1) { //user has not set size, set size = smallest samples size
-                subsampleSize = lookup->getNumSeqsSmallestGroup();
-                m->mothurOut("\nSetting sample size to " + toString(subsampleSize) + ".\n\n");
-            }else {
-                lookup->removeGroups(subsampleSize);
-                Groups = lookup->getNamesGroups();
-            }
+            if (lookup->size() < 2) { m->mothurOut("[ERROR]: You have not provided enough valid groups.  I cannot run the command.\n");  delete lookup; return 0;}
+        
+            if (subsample) { 
+                if (subsampleSize == -1) { //user has not set size, set size = smallest samples size
+                    subsampleSize = lookup->getNumSeqsSmallestGroup();
+                    m->mothurOut("\nSetting sample size to " + toString(subsampleSize) + ".\n\n");
+                }else {
+                    lookup->removeGroups(subsampleSize);
+                    Groups = lookup->getNamesGroups();
+                }
             
-            if (lookup->size() < 2) { m->mothurOut("[ERROR]: You have not provided enough valid groups.  I cannot run the command.\n"); m->setControl_pressed(true);  return 0; }
-        }
-		numGroups = lookup->size();
+                if (lookup->size() < 2) { m->mothurOut("[ERROR]: You have not provided enough valid groups.  I cannot run the command.\n"); m->setControl_pressed(true);  return 0; }
+            }
+            numGroups = lookup->size();
         
-        if (m->getControl_pressed()) { delete lookup;  return 0;  }
+            if (m->getControl_pressed()) { delete lookup;  return 0;  }
         
-        while (lookup != NULL) {
+            //the labels are read in batches of up to processors labels, in parallel
+            int numReaders = processors;
+            while (lookups.size() != 0) {
             
-            if (m->getControl_pressed()) { delete lookup; break; }
+                for (int i = 0; i < lookups.size(); i++) {
+                    if (!m->getControl_pressed()) { createProcesses(lookups[i]); }
+                    delete lookups[i];
+                }
             
-            createProcesses(lookup); delete lookup;
+                if (m->getControl_pressed()) { break; }
             
-            lookup = util.getNextShared(input, allLines, userLabels, processedLabels, lastLabel);
+                lookups = util.getNextShared(input, allLines, userLabels, processedLabels, lastLabel, numReaders);
+            }
         }
-				
+        
 		if (m->getControl_pressed()) { outputTypes.clear();  for (int i = 0; i < outputNames.size(); i++) {	util.mothurRemove(outputNames[i]); }  return 0;  }
 		
 		//set phylip file as new current phylipfile
@@ -237,6 +251,68 @@ int DistSharedCommand::execute(){
 	}
 }
 /***********************************************************/
+//the engine's values are read straight into the matrices, one label at a time
+int DistSharedCommand::processTables(InputData& input, set<string>& userLabels, set<string>& processedLabels, string& lastLabel){
+    try {
+        SparseSharedTable* table = util.getNextSparseShared(input, allLines, userLabels, processedLabels, lastLabel);
+        if (table == NULL) { return 0; }
+        Groups = table->getGroups();
+        
+        if (table->getNumGroups() < 2) { m->mothurOut("[ERROR]: You have not provided enough valid groups.  I cannot run the command.\n");  delete table; return 0;}
+        numGroups = table->getNumGroups();
+        
+        while (table != NULL) {
+            if (m->getControl_pressed()) { delete table; break; }
+            
+            vector<string> groupNames = table->getGroups();
+            int numSamples = groupNames.size();
+            
+            BetaDiversityEngine engine(*table, Estimators);
+            vector< vector<double> > engineValues; engine.getValues(processors, engineValues);
+            
+            map<string, string> variables;
+            variables["[filename]"] = outputdir + util.getRootName(util.getSimpleName(sharedfile));
+            variables["[distance]"] = table->getLabel();
+            variables["[tag2]"] = "";
+            variables["[outputtag]"] = output;
+            
+            for (int i = 0; i < Estimators.size(); i++) {
+                int c = engine.find(Estimators[i]);
+                
+                vector< vector<double> > matrix; matrix.resize(numSamples);
+                for (int k = 0; k < numSamples; k++) {  matrix[k].resize(numSamples, 0.0); }
+                
+                long long pair = 0;
+                for (int k = 0; k < numSamples; k++) {
+                    for (int l = 0; l < k; l++) {
+                        double dist = engineValues[c][pair * engine.getCols(c)];
+                        matrix[k][l] = dist; matrix[l][k] = dist;
+                        pair++;
+                    }
+                }
+                
+                variables["[calc]"] = Estimators[i];
+                string distFileName = getOutputFileName("phylip",variables);
+                outputNames.push_back(distFileName); outputTypes["phylip"].push_back(distFileName);
+                
+                ofstream outDist; util.openOutputFile(distFileName, outDist);
+                outDist.setf(ios::fixed, ios::floatfield); outDist.setf(ios::showpoint);
+                
+                printDists(outDist, matrix, groupNames); outDist.close();
+            }
+            
+            delete table;
+            table = util.getNextSparseShared(input, allLines, userLabels, processedLabels, lastLabel);
+        }
+        
+        return 0;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "DistSharedCommand", "processTables");
+        exit(1);
+    }
+}
+/***********************************************************/
 void DistSharedCommand::printDists(ostream& out, vector< vector<double> >& simMatrix, vector<string> groupNames) {
     try {
         
@@ -274,10 +350,18 @@ void DistSharedCommand::printDists(ostream& out, vector< vector<double> >& simMa
     }
 }
 /**************************************************************************************************/
-int driver(vector<SharedRAbundVector*>& thisLookup, vector< vector<seqDist> >& calcDists, vector<Calculator*> matrixCalculators, MothurOut* m) {
+//the calculators the engine computes are read out of engineValues, the rest are run pair by pair
+int driver(vector<SharedRAbundVector*>& thisLookup, vector< vector<seqDist> >& calcDists, vector<Calculator*> matrixCalculators, BetaDiversityEngine& engine, vector< vector<double> >& engineValues, MothurOut* m) {
     try {
-        vector<SharedRAbundVector*> subset;
+        vector<int> engineCalcs; vector<int> engineCols;
+        for(int i=0;i<matrixCalculators.size();i++) {
+            int index = engine.find(matrixCalculators[i]->getName());
+            engineCalcs.push_back(index);
+            if (index != -1) { engineCols.push_back(engine.getCols(index)); } else { engineCols.push_back(0); }
+        }
         
+        vector<SharedRAbundVector*> subset;
+        long long pair = 0;
         for (int k = 0; k < thisLookup.size(); k++) { // pass cdd each set of groups to compare
             
             for (int l = 0; l < k; l++) {
@@ -289,6 +373,12 @@ int driver(vector<SharedRAbundVector*>& thisLookup, vector< vector<seqDist> >& c
                     
                     for(int i=0;i<matrixCalculators.size();i++) {
                         
+                        if (engineCalcs[i] != -1) {
+                            seqDist temp(l, k, engineValues[engineCalcs[i]][pair * engineCols[i]]);
+                            calcDists[i].push_back(temp);
+                            continue;
+                        }
+                        
                         //if this calc needs all groups to calculate the pair load all groups
                         if (matrixCalculators[i]->getNeedsAll()) {
                             //load subset with rest of lookup for those calcs that need everyone to calc for a pair
@@ -304,6 +394,7 @@ int driver(vector<SharedRAbundVector*>& thisLookup, vector< vector<seqDist> >& c
                         seqDist temp(l, k, tempdata[0]);
                         calcDists[i].push_back(temp);
                     }
+                    pair++;
                 }
             }
         }
@@ -434,7 +525,10 @@ int process(distSharedData* params){
             vector<string> thisItersGroupNames = params->thisLookup->getNamesGroups();
             
             start = time(NULL);
-            driver(thisItersRabunds, calcDists, matrixCalculators, params->m);
+            BetaDiversityEngine engine(thisItersRabunds, params->Estimators);
+            vector< vector<double> > engineValues; engine.getValues(params->processors, engineValues);
+            
+            driver(thisItersRabunds, calcDists, matrixCalculators, engine, engineValues, params->m);
             if (params->m->getDebug()) { params->m->mothurOut("\nIt took " + toString(time(NULL) - start) + " seconds to calc dist for shared file.\n");  }
             
             //params->m->mothurOut(toString(thisIter) + " It took " + toString(time(NULL) - start) + " seconds to calc dist for shared file.\n");
@@ -487,12 +581,14 @@ int DistSharedCommand::createProcesses(SharedRAbundVectors*& thisLookup){
         vector<string> groupNames = thisLookup->getNamesGroups();
         
         vector<int> lines;
-        if (processors > (iters)) { processors = iters; }
+        int numProcessors = processors;
+        if (numProcessors > (iters)) { numProcessors = iters; }
+        int pairProcessors = processors / numProcessors; //the processors left over share each iter's pairs
         
         //figure out how many sequences you have to process
-        int numItersPerProcessor = (iters) / processors;
-        for (int i = 0; i < processors; i++) {
-            if(i == (processors - 1)){	numItersPerProcessor = (iters) - i * numItersPerProcessor; 	}
+        int numItersPerProcessor = (iters) / numProcessors;
+        for (int i = 0; i < numProcessors; i++) {
+            if(i == (numProcessors - 1)){	numItersPerProcessor = (iters) - i * numItersPerProcessor; 	}
             lines.push_back(numItersPerProcessor);
         }
         
@@ -501,11 +597,11 @@ int DistSharedCommand::createProcesses(SharedRAbundVectors*& thisLookup){
         vector<distSharedData*> data;
         
         //Lauch worker threads
-        for (int i = 0; i < processors-1; i++) {
+        for (int i = 0; i < numProcessors-1; i++) {
             
             //make copy of lookup so we don't get access violations
             SharedRAbundVectors* newLookup = new SharedRAbundVectors(*thisLookup);
-            distSharedData* dataBundle = new distSharedData(lines[i+1], false, subsample, subsampleSize, withReplacement, Estimators, newLookup);
+            distSharedData* dataBundle = new distSharedData(lines[i+1], false, subsample, subsampleSize, withReplacement, Estimators, newLookup, pairProcessors);
             
             data.push_back(dataBundle);
             
@@ -514,7 +610,7 @@ int DistSharedCommand::createProcesses(SharedRAbundVectors*& thisLookup){
         
         //make copy of lookup so we don't get access violations
         SharedRAbundVectors* newLookup = new SharedRAbundVectors(*thisLookup);
-        distSharedData* dataBundle = new distSharedData(lines[0], true, subsample, subsampleSize, withReplacement, Estimators, newLookup);
+        distSharedData* dataBundle = new distSharedData(lines[0], true, subsample, subsampleSize, withReplacement, Estimators, newLookup, pairProcessors);
         process(dataBundle);
         delete newLookup;
         
@@ -541,7 +637,7 @@ int DistSharedCommand::createProcesses(SharedRAbundVectors*& thisLookup){
         }
         vector< vector< vector<seqDist> > > calcDistsTotals = dataBundle->calcDistsTotals;
         
-        for (int i = 0; i < processors-1; i++) {
+        for (int i = 0; i < numProcessors-1; i++) {
             workerThreads[i]->join();
             
             //get calcDistsTotal info - one entry per iter
@@ -55,6 +55,7 @@
 #include "mempearson.h"
 #include "sharedjsd.h"
 #include "sharedrjsd.h"
+#include "betadiversityengine.hpp"
 
 
 // aka. dist.shared()
@@ -94,6 +95,7 @@ private:
 	vector<string>  Estimators, Groups, outputNames; //holds estimators to be used
 	
     int createProcesses(SharedRAbundVectors*&);
+    int processTables(InputData&, set<string>&, set<string>&, string&); //input, userLabels, processedLabels, lastLabel
 	int driver(vector<SharedRAbundVector*>&, vector< vector<seqDist> >&, vector<Calculator*>);
     void printDists(ostream&, vector< vector<double> >&, vector<string>);
 
@@ -107,11 +109,11 @@ struct distSharedData {
     vector<string>  Estimators;
     long long numIters;
 	MothurOut* m;
-    int count, subsampleSize;
+    int count, subsampleSize, processors; //processors computing each iter's pairs
     bool mainThread, subsample, withReplacement;
 	
 	distSharedData(){}
-	distSharedData(long long st, bool mt, bool su, int subsize, bool wr, vector<string> est, SharedRAbundVectors* lu) {
+	distSharedData(long long st, bool mt, bool su, int subsize, bool wr, vector<string> est, SharedRAbundVectors* lu, int proc) {
         m = MothurOut::getInstance();
 		numIters = st;
         Estimators = est;
@@ -121,6 +123,7 @@ struct distSharedData {
         subsample = su;
         subsampleSize = subsize;
         withReplacement = wr;
+        processors = proc;
 	}
 };
 /**************************************************************************************************/
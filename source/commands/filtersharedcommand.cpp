@@ -206,16 +206,16 @@ int FilterSharedCommand::execute(){
         set<string> userLabels = labels;
         string lastLabel = "";
         
-        SharedRAbundVectors* lookup = util.getNextShared(input, allLines, userLabels, processedLabels, lastLabel);
-        Groups = lookup->getNamesGroups();
+        SparseSharedTable* table = util.getNextSparseShared(input, allLines, userLabels, processedLabels, lastLabel);
+        if (table != NULL) { Groups = table->getGroups(); }
 		
-        while (lookup != NULL) {
+        while (table != NULL) {
             
-            if (m->getControl_pressed()) { delete lookup; break; }
+            if (m->getControl_pressed()) { delete table; break; }
             
-            processShared(lookup); delete lookup;
+            processShared(table); delete table;
             
-            lookup = util.getNextShared(input, allLines, userLabels, processedLabels, lastLabel);
+            table = util.getNextSparseShared(input, allLines, userLabels, processedLabels, lastLabel);
         }
         
         if (m->getControl_pressed()) { return 0; }
@@ -238,29 +238,34 @@ int FilterSharedCommand::execute(){
 	}
 }
 //**********************************************************************************************************************
-int FilterSharedCommand::processShared(SharedRAbundVectors*& sharedLookup) {
+int FilterSharedCommand::processShared(SparseSharedTable*& table) {
 	try {
         map<string, string> variables; 
         variables["[filename]"] = outputdir + util.getRootName(util.getSimpleName(sharedfile));
         variables["[extension]"] = util.getExtension(sharedfile);
-        variables["[distance]"] = sharedLookup->getLabel();
+        variables["[distance]"] = table->getLabel();
 		string outputFileName = getOutputFileName("shared", variables);        
         
         if (m->getControl_pressed()) {  return 0; }
         
-        vector<int> rareCounts; rareCounts.resize(Groups.size(), 0);
-        int numGroups = Groups.size();
+        int numGroups = table->getNumGroups();
+        vector<int> rareCounts; rareCounts.resize(numGroups, 0);
         float defaultSetting = -0.01;
         
+        //the filters only look at the groups an OTU is in, the columns of the table
+        vector<int> otuTotals = table->getColumnTotals();
+        vector<int> groupTotals = table->getRowTotals();
+        
         //you want to remove a percentage of OTUs
         set<string> removeLabels;
         if (!util.isEqual(rarePercent, defaultSetting)) {
             vector<spearmanRank> otus;
             //rank otus by abundance
-            for (int i = 0; i < sharedLookup->getNumBins(); i++) {
+            for (int i = 0; i < table->getNumOtus(); i++) {
+                SparseSharedVector abunds = table->getColumn(i);
                 float otuTotal = 0.0;
-                for (int j = 0; j < numGroups; j++) { otuTotal += sharedLookup->get(i, Groups[j]); }
-                spearmanRank temp(sharedLookup->getOTUName(i), otuTotal);
+                for (int j = 0; j < abunds.size; j++) { otuTotal += abunds.counts[j]; }
+                spearmanRank temp(table->getOTUName(i), otuTotal);
                 otus.push_back(temp);
             }
             
@@ -268,7 +273,7 @@ int FilterSharedCommand::processShared(SharedRAbundVectors*& sharedLookup) {
             sort(otus.begin(), otus.end(), compareSpearman);
             
             //find index of cutoff
-            int indexFirstNotRare = ceil(rarePercent * (float)sharedLookup->getNumBins());
+            int indexFirstNotRare = ceil(rarePercent * (float)table->getNumOtus());
             
             //handle ties
             if (keepties) { //adjust indexFirstNotRare if needed
@@ -280,7 +285,7 @@ int FilterSharedCommand::processShared(SharedRAbundVectors*& sharedLookup) {
                                 indexFirstNotRare = i+1; tie = false; break;
                             }
                         }
-                        if (tie) { if (m->getDebug()) { m->mothurOut("For distance " + sharedLookup->getLabel() + " all rare OTUs abundance tie with first 'non rare' OTU, not removing any for rarepercent parameter.\n"); }indexFirstNotRare = 0; }
+                        if (tie) { if (m->getDebug()) { m->mothurOut("For distance " + table->getLabel() + " all rare OTUs abundance tie with first 'non rare' OTU, not removing any for rarepercent parameter.\n"); }indexFirstNotRare = 0; }
                     }
                 }
             }
@@ -289,62 +294,48 @@ int FilterSharedCommand::processShared(SharedRAbundVectors*& sharedLookup) {
             for (int i = 0; i < indexFirstNotRare; i++) { removeLabels.insert(otus[i].name); }
         }
         
+        double total = 0;
+        for (int j = 0; j < numGroups; j++) { total += groupTotals[j]; }
+        
         bool filteredSomething = false;
         int numRemoved = 0;
         vector<int> binsToRemove;
-        for (int i = 0; i < sharedLookup->getNumBins(); i++) {
+        for (int i = 0; i < table->getNumOtus(); i++) {
             
             if (m->getControl_pressed()) { return 0; }
             
-            vector<int> abunds = sharedLookup->getOTU(i);
+            SparseSharedVector abunds = table->getColumn(i); //the groups that have the OTU
             
             bool okay = true; //innocent until proven guilty
             if (minAbund != -1) {
-                for (int j = 0; j < numGroups; j++) {
-                    if (abunds[j] < minAbund) { okay = false; break; }
+                if ((abunds.size < numGroups) && (0 < minAbund)) { okay = false; } //a group without the OTU
+                for (int j = 0; j < abunds.size; j++) {
+                    if (abunds.counts[j] < minAbund) { okay = false; break; }
                 }
             }
             
             if (okay && (minTotal != -1)) {
-                int otuTotal = 0;
-                for (int j = 0; j < numGroups; j++) {
-                    otuTotal += abunds[j];
-                }
-                if (otuTotal < minTotal) { okay = false; }
+                if (otuTotals[i] < minTotal) { okay = false; }
             }
             
             if (okay && (!util.isEqual(minPercent, defaultSetting))) {
-                double otuTotal = 0;
-                double total = 0;
-                for (int j = 0; j < numGroups; j++) {
-                    otuTotal += abunds[j];
-                    total += sharedLookup->getNumSeqs(Groups[j]);
-                }
-                double percent = otuTotal / total; 
+                double percent = otuTotals[i] / total; 
                 if (percent < minPercent) { okay = false; }
             }
             
             
             if (okay && (minSamples != -1)) {
-                int samples = 0;
-                for (int j = 0; j < numGroups; j++) {
-                    if (abunds[j] != 0) { samples++; }
-                }
-                if (samples < minSamples) { okay = false; }
+                if (abunds.size < minSamples) { okay = false; }
             }
             
             if (okay && (!util.isEqual(minPercentSamples, defaultSetting))) {
-                double samples = 0;
-                double total = numGroups;
-                for (int j = 0; j < numGroups; j++) {
-                    if (abunds[j] != 0) { samples++; }
-                }
-                double percent = samples / total; 
+                double samples = abunds.size;
+                double percent = samples / (double) numGroups; 
                 if (percent < minPercentSamples) { okay = false; }
             }
             
             if (okay && (!util.isEqual(rarePercent, defaultSetting))) {
-                if (removeLabels.count(sharedLookup->getOTUName(i)) != 0) { //are we on the 'bad' list
+                if (removeLabels.count(table->getOTUName(i)) != 0) { //are we on the 'bad' list
                     okay = false;
                 }
             }
@@ -354,26 +345,26 @@ int FilterSharedCommand::processShared(SharedRAbundVectors*& sharedLookup) {
                 
                 filteredSomething = true;
                 if (makeRare) {
-                    for (int j = 0; j < numGroups; j++) {
-                        rareCounts[j] += abunds[j];
+                    for (int j = 0; j < abunds.size; j++) {
+                        rareCounts[abunds.indexes[j]] += abunds.counts[j];
                     }
                 }
-                if (m->getDebug()) { m->mothurOut("[DEBUG]: removing OTU " + sharedLookup->getOTUName(i) + "\n"); }
+                if (m->getDebug()) { m->mothurOut("[DEBUG]: removing OTU " + table->getOTUName(i) + "\n"); }
                 binsToRemove.push_back(i);
                 numRemoved++;
             }
             
         }
         
-        sharedLookup->removeOTUs(binsToRemove, true);
+        table->removeOTUs(binsToRemove);
         
         //if we are saving the counts add a "rare" OTU if anything was filtered
-        if (makeRare) { if (filteredSomething) { sharedLookup->push_back(rareCounts, "OTURare1"); } }
+        if (makeRare) { if (filteredSomething) { table->push_back(rareCounts, "OTURare1"); } }
         
         ofstream out;
 		util.openOutputFile(outputFileName, out);
 		outputTypes["shared"].push_back(outputFileName);  outputNames.push_back(outputFileName);  bool printHeaders = true;
-        sharedLookup->print(out, printHeaders);
+        table->print(out, printHeaders);
 		out.close();
         
         m->mothurOut("\nRemoved " + toString(numRemoved) + " OTUs.\n");
@@ -12,6 +12,7 @@
 #include "command.hpp"
 
 #include "inputdata.h"
+#include "sparsesharedtable.hpp"
 
 
 class FilterSharedCommand : public Command {
@@ -40,7 +41,7 @@ private:
 	int minAbund, minTotal, minSamples;
     float minPercent, minPercentSamples, rarePercent;
     
-    int processShared(SharedRAbundVectors*&);
+    int processShared(SparseSharedTable*&);
 	
 };
 
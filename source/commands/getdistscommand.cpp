@@ -332,6 +332,8 @@ int GetDistsCommand::readPhylip(){
 //**********************************************************************************************************************
 int GetDistsCommand::readColumn(){
 	try {
+        if (BinaryDistFile::isBinary(columnfile)) { m->mothurOut("[ERROR]: " + columnfile + " is a binary distance file, get.dists needs a column file.\n"); m->setControl_pressed(true); return 0; }
+        
 		string thisOutputDir = outputdir;
 		if (outputdir == "") {  thisOutputDir += util.hasPath(columnfile);  }
         map<string, string> variables; 
@@ -10,6 +10,7 @@
 #define Mothur_getdistscommand_h
 
 #include "command.hpp"
+#include "binarydistfile.hpp"
 
 class GetDistsCommand : public Command {
 	
@@ -721,9 +721,8 @@ int GetOTURepCommand::process(ListVector* processList, GroupMap& groupMap) {
             
 			if (m->getControl_pressed()) { out.close(); if (Groups.size() == 0) { newNamesOutput.close(); } return 0; }
 			
-			string temp = processList->get(i);
 			vector<string> namesInBin;
-			util.splitAtComma(temp, namesInBin);
+			processList->getNames(i, namesInBin);
 			
 			if (Groups.size() == 0) {
 				nameRep = findRep(namesInBin, matrixNameIndexes, "");
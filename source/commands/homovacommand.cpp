@@ -12,6 +12,7 @@
 #include "readphylipvector.h"
 
 #include "designmap.h"
+#include "permutationtest.hpp"
 
 //**********************************************************************************************************************
 vector<string> HomovaCommand::setParameters(){	
@@ -21,6 +22,8 @@ vector<string> HomovaCommand::setParameters(){
         CommandParameter psets("sets", "String", "", "", "", "", "","",false,false); parameters.push_back(psets);
 		CommandParameter piters("iters", "Number", "", "1000", "", "", "","",false,false); parameters.push_back(piters);
 		CommandParameter palpha("alpha", "Number", "", "0.05", "", "", "","",false,false); parameters.push_back(palpha);
+        CommandParameter pearlystop("earlystop", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pearlystop);
+        CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -45,11 +48,13 @@ string HomovaCommand::getHelpString(){
 		string helpString = "";
 		helpString += "Referenced: Stewart CN, Excoffier L (1996). Assessing population genetic structure and variability with RAPD data: Application to Vaccinium macrocarpon (American Cranberry). J Evol Biol 9: 153-71.\n";
 		helpString += "The homova command outputs a .homova file. \n";
-		helpString += "The homova command parameters are phylip, iters, sets and alpha.  The phylip and design parameters are required, unless valid current files exist.\n";
+		helpString += "The homova command parameters are phylip, iters, sets, alpha, earlystop and processors.  The phylip and design parameters are required, unless valid current files exist.\n";
 		helpString += "The design parameter allows you to assign your samples to groups when you are running homova. It is required. \n";
 		helpString += "The design file looks like the group file.  It is a 2 column tab delimited file, where the first column is the sample name and the second column is the group the sample belongs to.\n";
         helpString += "The sets parameter allows you to specify which of the sets in your designfile you would like to analyze. The set names are separated by dashes. THe default is all sets in the designfile.\n";
 		helpString += "The iters parameter allows you to set number of randomization for the P value.  The default is 1000. \n";
+        helpString += "The earlystop parameter allows you to stop the randomizations once this many have scored at least as extreme as your data. The P value is then estimated from the randomizations run, so large P values are found quickly. The default is 0, meaning run all the iters.\n";
+        helpString += "The processors parameter allows you to specify the number of processors to use for the randomizations. The default is all available.\n";
 		helpString += "The homova command should be in the following format: homova(phylip=file.dist, design=file.design).\n";
 		return helpString;
 	}
@@ -117,6 +122,13 @@ HomovaCommand::HomovaCommand(string option) {
 			if (temp == "not found") { temp = "0.05"; }
 			util.mothurConvert(temp, experimentwiseAlpha); 
             
+            temp = validParameter.valid(parameters, "earlystop");
+			if (temp == "not found") { temp = "0"; }
+			util.mothurConvert(temp, earlyStop);
+            
+            temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+            processors = current->setProcessors(temp);
+            
             string sets = validParameter.valid(parameters, "sets");			
 			if (sets == "not found") { sets = ""; }
 			else { 
@@ -195,7 +207,9 @@ int HomovaCommand::execute(){
 		HOMOVAFile << "HOMOVA\tBValue\tP-value\tSSwithin/(Ni-1)_values" << endl;
 		m->mothurOut("HOMOVA\tBValue\tP-value\tSSwithin/(Ni-1)_values\n");
 		
-		double fullHOMOVAPValue = runHOMOVA(HOMOVAFile, origGroupSampleMap, experimentwiseAlpha);
+		PermutationTest permutationTest("homova", iters, processors, earlyStop);
+		
+		double fullHOMOVAPValue = runHOMOVA(HOMOVAFile, permutationTest, origGroupSampleMap, experimentwiseAlpha);
 
 		if(fullHOMOVAPValue <= experimentwiseAlpha && numGroups > 2){
 			
@@ -212,7 +226,7 @@ int HomovaCommand::execute(){
 					pairwiseGroupSampleMap[itA->first] = itA->second;
 					pairwiseGroupSampleMap[itB->first] = itB->second;
 					
-					runHOMOVA(HOMOVAFile, pairwiseGroupSampleMap, pairwiseAlpha);
+					runHOMOVA(HOMOVAFile, permutationTest, pairwiseGroupSampleMap, pairwiseAlpha);
 				}			
 			}
 			HOMOVAFile << endl;
@@ -238,25 +252,26 @@ int HomovaCommand::execute(){
 }
 //**********************************************************************************************************************
 
-double HomovaCommand::runHOMOVA(ofstream& HOMOVAFile, map<string, vector<int> > groupSampleMap, double alpha){
+double HomovaCommand::runHOMOVA(ofstream& HOMOVAFile, PermutationTest& permutationTest, map<string, vector<int> > groupSampleMap, double alpha){
 	try {
 		map<string, vector<int> >::iterator it;
 		int numGroups = groupSampleMap.size();
 		
+		vector<int> samples, groupStarts;
+		PermutationTest::getSamplesByGroup(groupSampleMap, samples, groupStarts);
+		
 		vector<double> ssWithinOrigVector;
-		double bValueOrig = calcBValue(groupSampleMap, ssWithinOrigVector);
+		double bValueOrig = calcBValue(samples, groupStarts, ssWithinOrigVector);
 		
-		double counter = 0;
-		for(int i=0;i<iters;i++){
+		PermutationTest::GroupStatistic bValueRand = [&](const vector<int>& randomSamples, const vector<int>& starts) {
 			vector<double> ssWithinRandVector;
-			map<string, vector<int> > randomizedGroup = getRandomizedGroups(groupSampleMap);
-			double bValueRand = calcBValue(randomizedGroup, ssWithinRandVector);
-			if(bValueRand >= bValueOrig){	counter++;	}
-		}
+			return calcBValue(randomSamples, starts, ssWithinRandVector);
+		};
 		
-		double pValue = (double) counter / (double) iters;
+		double pValue = permutationTest.getPValue(bValueRand, samples, groupStarts, bValueOrig, PermutationTest::atLeast);
+		int numRun = permutationTest.getNumRun();
 		string pString = "";
-		if(pValue < 1/(double)iters){	pString = '<' + toString(1/(double)iters);	}
+		if(pValue < 1/(double)numRun){	pString = '<' + toString(1/(double)numRun);	}
 		else						{	pString = toString(pValue);					}
 		
 		
@@ -295,15 +310,16 @@ double HomovaCommand::runHOMOVA(ofstream& HOMOVAFile, map<string, vector<int> >
 
 //**********************************************************************************************************************
 
-double HomovaCommand::calcSigleSSWithin(vector<int> sampleIndices) {
+//the group's samples are sampleIndices[start] to sampleIndices[end-1]
+double HomovaCommand::calcSigleSSWithin(const vector<int>& sampleIndices, int start, int end) {
 	try {
 		double ssWithin = 0.0;
-		int numSamplesInGroup = sampleIndices.size();
+		int numSamplesInGroup = end - start;
 		
-		for(int i=0;i<numSamplesInGroup;i++){
+		for(int i=start;i<end;i++){
 			int row = sampleIndices[i];
 			
-			for(int j=0;j<numSamplesInGroup;j++){
+			for(int j=start;j<end;j++){
 				int col = sampleIndices[j];
 				
 				if(col < row){ ssWithin += distanceMatrix[row][col]; }
@@ -321,18 +337,18 @@ double HomovaCommand::calcSigleSSWithin(vector<int> sampleIndices) {
 
 //**********************************************************************************************************************
 
-double HomovaCommand::calcBValue(map<string, vector<int> > groupSampleMap, vector<double>& ssWithinVector) {
+double HomovaCommand::calcBValue(const vector<int>& samples, const vector<int>& groupStarts, vector<double>& ssWithinVector) {
 	try {
-		double numGroups = (double)groupSampleMap.size();
+		double numGroups = (double)(groupStarts.size() - 1);
 		ssWithinVector.resize(numGroups, 0);
 		
 		double totalNumSamples = 0; double ssWithinFull = 0; double secondTermSum = 0; double inverseOneMinusSum = 0; int index = 0;
 		
-		for(map<string, vector<int> >::iterator it = groupSampleMap.begin();it!=groupSampleMap.end();it++){
-			int numSamplesInGroup = it->second.size();
+		for(int g = 0; g < groupStarts.size()-1; g++){
+			int numSamplesInGroup = groupStarts[g+1] - groupStarts[g];
 			totalNumSamples += numSamplesInGroup;
 			
-			ssWithinVector[index] = calcSigleSSWithin(it->second);
+			ssWithinVector[index] = calcSigleSSWithin(samples, groupStarts[g], groupStarts[g+1]);
 			ssWithinFull += ssWithinVector[index];
 			
 			secondTermSum += (numSamplesInGroup - 1) * log(ssWithinVector[index] / (double)(numSamplesInGroup - 1));
@@ -355,35 +371,4 @@ double HomovaCommand::calcBValue(map<string, vector<int> > groupSampleMap, vecto
 }
 //**********************************************************************************************************************
 
-map<string, vector<int> > HomovaCommand::getRandomizedGroups(map<string, vector<int> > origMapping){
-	try{
-		vector<int> sampleIndices;
-		vector<int> samplesPerGroup;
-		
-		for(map<string, vector<int> >::iterator it=origMapping.begin();it!=origMapping.end();it++){
-			vector<int> indices = it->second;
-			samplesPerGroup.push_back(indices.size());
-			sampleIndices.insert(sampleIndices.end(), indices.begin(), indices.end());
-		}
-		
-		util.mothurRandomShuffle(sampleIndices);
-		
-		int index = 0;
-		map<string, vector<int> > randomizedGroups = origMapping;
-		for(map<string, vector<int> >::iterator it=randomizedGroups.begin();it!=randomizedGroups.end();it++){
-			for(int i=0;i<it->second.size();i++){
-				it->second[i] = sampleIndices[index++];				
-			}
-		}
-		
-		return randomizedGroups;		
-	}
-	catch (exception& e) {
-		m->errorOut(e, "AmovaCommand", "randomizeGroups");
-		exit(1);
-	}
-}
-
-//**********************************************************************************************************************
-
 
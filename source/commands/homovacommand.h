@@ -14,6 +14,7 @@
 #include "command.hpp"
 
 class DesignMap;
+class PermutationTest;
 
 class HomovaCommand : public Command {
 	
@@ -34,16 +35,15 @@ public:
 	void help() { m->mothurOut(getHelpString()); }	
 	
 private:
-	double runHOMOVA(ofstream& , map<string, vector<int> >, double);
-	double calcSigleSSWithin(vector<int>);
-	double calcBValue(map<string, vector<int> >, vector<double>&);
-	map<string, vector<int> > getRandomizedGroups(map<string, vector<int> >);
+	double runHOMOVA(ofstream& , PermutationTest&, map<string, vector<int> >, double);
+	double calcSigleSSWithin(const vector<int>&, int, int);
+	double calcBValue(const vector<int>&, const vector<int>&, vector<double>&); //samples by group, where each group starts
 
 	bool abort;
 	vector<string> outputNames, Sets;
 	string  inputDir, designFileName, phylipFileName;
 	vector< vector<double> > distanceMatrix;
-	int iters;
+	int iters, earlyStop, processors;
 	double experimentwiseAlpha;
 };
 
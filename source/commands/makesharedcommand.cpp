@@ -9,6 +9,7 @@
 
 #include "makesharedcommand.h"
 #include "counttable.h"
+#include "labelindex.hpp"
 
 //********************************************************************************************************************
 //sorts lowest to highest
@@ -247,6 +248,11 @@ int SharedCommand::execute(){
 		if (itTypes != outputTypes.end()) {
 			if ((itTypes->second).size() != 0) { currentName = (itTypes->second)[0]; current->setGroupFile(currentName); }
 		}
+        
+        //index the labels now, so the commands reading the files can seek to them
+        for (int i = 0; i < outputTypes["shared"].size(); i++) { LabelIndex::write(outputTypes["shared"][i], "sharedfile"); }
+        for (int i = 0; i < outputTypes["relabund"].size(); i++) { LabelIndex::write(outputTypes["relabund"][i], "relabund"); }
+        for (int i = 0; i < outputTypes["list"].size(); i++) { LabelIndex::write(outputTypes["list"][i], "list"); }
 
 		m->mothurOut("\nOutput File Names:\n");
 		for (int i = 0; i < outputNames.size(); i++) {	m->mothurOut(outputNames[i] +"\n"); 	} m->mothurOutEndLine();
@@ -1206,10 +1212,8 @@ int SharedCommand::ListGroupSameSeqs(vector<string>& groupMapsSeqs, SharedListVe
 		for (int i = 0; i < SharedList->getNumBins(); i++) {
 			if (m->getControl_pressed()) { return 0; }
 
-			string names = SharedList->get(i);
-
 			vector<string> listNames;
-			util.splitAtComma(names, listNames);
+			SharedList->getNames(i, listNames);
 
 			for (int j = 0; j < listNames.size(); j++) {
 				int num = groupNamesSeqs.count(listNames[j]);
@@ -9,6 +9,7 @@
 
 #include "mantelcommand.h"
 #include "readphylipvector.h"
+#include "permutationtest.hpp"
 
 
 //**********************************************************************************************************************
@@ -18,6 +19,8 @@ vector<string> MantelCommand::setParameters(){
 		CommandParameter pphylip2("phylip2", "InputTypes", "", "", "none", "none", "none","mantel",false,true,true); parameters.push_back(pphylip2);
 		CommandParameter piters("iters", "Number", "", "1000", "", "", "","",false,false); parameters.push_back(piters);
 		CommandParameter pmethod("method", "Multiple", "pearson-spearman-kendall", "pearson", "", "", "","",false,false); parameters.push_back(pmethod);
+        CommandParameter pearlystop("earlystop", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pearlystop);
+        CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -42,9 +45,12 @@ string MantelCommand::getHelpString(){
 		string helpString = "";
 		helpString += "Sokal, R. R., & Rohlf, F. J. (1995). Biometry, 3rd edn. New York: Freeman.\n";
 		helpString += "The mantel command reads two distance matrices and calculates the mantel correlation coefficient.\n";
-		helpString += "The mantel command parameters are phylip1, phylip2, iters and method.  The phylip1 and phylip2 parameters are required.  Matrices must be the same size and contain the same names.\n";
+		helpString += "The mantel command parameters are phylip1, phylip2, iters, method, earlystop and processors.  The phylip1 and phylip2 parameters are required.  Matrices must be the same size and contain the same names.\n";
 		helpString += "The method parameter allows you to select what method you would like to use. Options are pearson, spearman and kendall. Default=pearson.\n";
 		helpString += "The iters parameter allows you to set number of randomization for the P value.  The default is 1000. \n";
+		helpString += "Each randomization relabels the samples of phylip2, shuffling its rows and columns together.\n";
+        helpString += "The earlystop parameter allows you to stop the randomizations once this many have scored at least as extreme as your data. The P value is then estimated from the randomizations run, so large P values are found quickly. The default is 0, meaning run all the iters.\n";
+        helpString += "The processors parameter allows you to specify the number of processors to use for the randomizations. The default is all available.\n";
 		helpString += "The mantel command should be in the following format: mantel(phylip1=veg.dist, phylip2=env.dist).\n";
 		helpString += "The mantel command outputs a .mantel file.\n";
 		return helpString;
@@ -97,6 +103,12 @@ MantelCommand::MantelCommand(string option)  {
 			string temp = validParameter.valid(parameters, "iters");			if (temp == "not found") { temp = "1000"; }
 			util.mothurConvert(temp, iters);
 			
+			temp = validParameter.valid(parameters, "earlystop");			if (temp == "not found") { temp = "0"; }
+			util.mothurConvert(temp, earlyStop);
+			
+			temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+            processors = current->setProcessors(temp);
+			
 			if ((method != "pearson") && (method != "spearman") && (method != "kendall")) { m->mothurOut(method + " is not a valid method. Valid methods are pearson, spearman, and kendall.\n"); abort = true; }
 		}
 	}
@@ -146,33 +158,25 @@ int MantelCommand::execute(){
 		/***************************************************/
 		
 		//calc mantel coefficient
-		LinearAlgebra linear;
-		double mantel = 0.0;
-		if (method == "pearson")		{  mantel = linear.calcPearson(matrix1, matrix2);	}
-		else if (method == "spearman")	{  mantel = linear.calcSpearman(matrix1, matrix2);	}
-		else if (method == "kendall")	{  mantel = linear.calcKendall(matrix1, matrix2);	}
-		
-		
-		//calc signifigance
-		int count = 0;
-		for (int i = 0; i < iters; i++) {
-			
-			if (m->getControl_pressed()) { return 0; }
-			
-			//randomize matrix2
-			vector< vector<double> > matrix2Copy = matrix2;
-			util.mothurRandomShuffle(matrix2Copy);
-		
-			//calc random mantel
-			double randomMantel = 0.0;
-			if (method == "pearson")		{  randomMantel = linear.calcPearson(matrix1, matrix2Copy);	}
-			else if (method == "spearman")	{  randomMantel = linear.calcSpearman(matrix1, matrix2Copy);	}
-			else if (method == "kendall")	{  randomMantel = linear.calcKendall(matrix1, matrix2Copy);	}
-			
-			if (randomMantel >= mantel) { count++; }
-		}
-		
-		double pValue = count / (float) iters;
+		double mantel = calcCoefficient(matrix1, matrix2);
+		
+		//calc signifigance, each randomization relabels matrix2's samples
+		PermutationTest::Statistic randomMantel = [&](const vector<int>& permutation) {
+			//the calculators only read the lower triangle
+			vector< vector<double> > randomMatrix2(matrix2.size());
+			for (int i = 0; i < matrix2.size(); i++) {
+				randomMatrix2[i].resize(i);
+				for (int j = 0; j < i; j++) {
+					int row = permutation[i]; int col = permutation[j];
+					if (row > col)	{ randomMatrix2[i][j] = matrix2[row][col]; }
+					else			{ randomMatrix2[i][j] = matrix2[col][row]; }
+				}
+			}
+			return calcCoefficient(matrix1, randomMatrix2);
+		};
+		
+		PermutationTest permutationTest("mantel", iters, processors, earlyStop);
+		double pValue = permutationTest.getPValue(randomMantel, matrix2.size(), mantel, PermutationTest::atLeast);
 		
 		if (m->getControl_pressed()) { return 0; }
 		
@@ -206,5 +210,22 @@ int MantelCommand::execute(){
 }
 
 //**********************************************************************************************************************
+double MantelCommand::calcCoefficient(vector< vector<double> >& matrix1, vector< vector<double> >& matrix2){
+	try {
+		LinearAlgebra linear;
+		
+		double coefficient = 0.0;
+		if (method == "pearson")		{  coefficient = linear.calcPearson(matrix1, matrix2);	}
+		else if (method == "spearman")	{  coefficient = linear.calcSpearman(matrix1, matrix2);	}
+		else if (method == "kendall")	{  coefficient = linear.calcKendall(matrix1, matrix2);	}
+		
+		return coefficient;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "MantelCommand", "calcCoefficient");	
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
 
 
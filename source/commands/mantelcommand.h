@@ -34,7 +34,9 @@ private:
 	
 	string phylipfile1, phylipfile2,  method;
 	bool abort;
-	int iters;
+	int iters, earlyStop, processors;
+	
+	double calcCoefficient(vector< vector<double> >&, vector< vector<double> >&);
 	
 	vector<string> outputNames;
 };
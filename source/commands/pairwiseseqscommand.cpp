@@ -23,10 +23,11 @@ vector<string> PairwiseSeqsCommand::setParameters(){
 		CommandParameter pgapopen("gapopen", "Number", "", "-2.0", "", "", "","",false,false); parameters.push_back(pgapopen);
 		CommandParameter pgapextend("gapextend", "Number", "", "-1.0", "", "", "","",false,false); parameters.push_back(pgapextend);
 		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
-		CommandParameter poutput("output", "Multiple", "column-lt-square-phylip", "column", "", "", "","phylip-column",false,false,true); parameters.push_back(poutput);
+		CommandParameter poutput("output", "Multiple", "column-lt-square-phylip-binary", "column", "", "", "","phylip-column-binary",false,false,true); parameters.push_back(poutput);
 		CommandParameter pcalc("calc", "Multiple", "nogaps-eachgap-onegap", "onegap", "", "", "","",false,false); parameters.push_back(pcalc);
 		CommandParameter pcountends("countends", "Boolean", "", "T", "", "", "","",false,false); parameters.push_back(pcountends);
 		CommandParameter pcompress("compress", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pcompress);
+        CommandParameter pfloat16("float16", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pfloat16);
 		CommandParameter pcutoff("cutoff", "Number", "", "1.0", "", "", "","",false,false,true); parameters.push_back(pcutoff);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
@@ -37,6 +38,7 @@ vector<string> PairwiseSeqsCommand::setParameters(){
         vector<string> tempOutNames;
         outputTypes["phylip"] = tempOutNames;
         outputTypes["column"] = tempOutNames;
+        outputTypes["binary"] = tempOutNames;
 		
 		vector<string> myArray;
 		for (int i = 0; i < parameters.size(); i++) {	myArray.push_back(parameters[i].name);		}
@@ -52,7 +54,7 @@ string PairwiseSeqsCommand::getHelpString(){
 	try {
 		string helpString = "";
 		helpString += "The pairwise.seqs command reads a fasta file and creates distance matrix.\n";
-		helpString += "The pairwise.seqs command parameters are fasta, align, match, mismatch, gapopen, gapextend, calc, output, cutoff, oldfasta, column and processors.\n";
+		helpString += "The pairwise.seqs command parameters are fasta, align, match, mismatch, gapopen, gapextend, calc, output, float16, cutoff, oldfasta, column and processors.\n";
 		helpString += "The fasta parameter is required.\n";
 		helpString += "The align parameter allows you to specify the alignment method to use.  Your options are: gotoh, needleman, blast and noalign. The default is needleman.\n";
 		helpString += "The match parameter allows you to specify the bonus for having the same base. The default is 1.0.\n";
@@ -62,7 +64,9 @@ string PairwiseSeqsCommand::getHelpString(){
 		helpString += "The calc parameter allows you to specify the method of calculating the distances.  Your options are: nogaps, onegap or eachgap. The default is onegap.\n";
 		helpString += "The countends parameter allows you to specify whether to include terminal gaps in distance.  Your options are: T or F. The default is T.\n";
 		helpString += "The cutoff parameter allows you to specify maximum distance to keep. The default is 1.0.\n";
-		helpString += "The output parameter allows you to specify format of your distance matrix. Options are column, lt, and square. The default is column.\n";
+		helpString += "The output parameter allows you to specify format of your distance matrix. Options are column, lt, square and binary. The default is column.\n";
+		helpString += "The binary output stores the distances below the cutoff in a compact file the clustering commands read in place. Give it to cluster or cluster.split as the column file, it is not made the current column file.\n";
+		helpString += "The float16 parameter allows you to store the binary distances as half precision floats. The default is false.\n";
         helpString += "The oldfasta and column parameters allow you to append the distances calculated to the column file.\n";
 		helpString += "The compress parameter allows you to indicate that you want the resulting distance file compressed.  The default is false.\n";
 		helpString += "The pairwise.seqs command should be in the following format: \n";
@@ -83,6 +87,7 @@ string PairwiseSeqsCommand::getOutputPattern(string type) {
         
         if (type == "phylip") {  pattern = "[filename],[outputtag],dist"; } 
         else if (type == "column") { pattern = "[filename],dist"; }
+        else if (type == "binary") { pattern = "[filename],[outputtag],dist"; }
         else { m->mothurOut("[ERROR]: No definition for type " + type + " output pattern.\n"); m->setControl_pressed(true);  }
         
         return pattern;
@@ -171,7 +176,13 @@ PairwiseSeqsCommand::PairwiseSeqsCommand(string option)  {
 			
 			output = validParameter.valid(parameters, "output");		if(output == "not found"){	output = "column"; }
             if (output=="phylip") { output = "lt"; }
-			if ((output != "column") && (output != "lt") && (output != "square")) { m->mothurOut(output + " is not a valid output form. Options are column, lt and square. I will use column.\n");  output = "column"; }
+			if ((output != "column") && (output != "lt") && (output != "square") && (output != "binary")) { m->mothurOut(output + " is not a valid output form. Options are column, lt, square and binary. I will use column.\n");  output = "column"; }
+            
+            temp = validParameter.valid(parameters, "float16");		if(temp == "not found"){  temp = "F"; }
+			float16 = util.isTrue(temp);
+            
+            if ((output == "binary") && ((column != "") || fitCalc)) { m->mothurOut("[ERROR]: appending distances to a column file and fitcalc require column output.\n"); abort=true; }
+            if ((output == "binary") && compress) { m->mothurOut("[WARNING]: binary distance files are read in place, ignoring compress.\n"); compress = false; }
 			
 			calc = validParameter.valid(parameters, "calc");			
 			if (calc == "not found") { calc = "onegap";  }
@@ -235,6 +246,10 @@ int PairwiseSeqsCommand::execute(){
             outputFile = getOutputFileName("column", variables);
             outputTypes["column"].push_back(outputFile);
             util.mothurRemove(outputFile);
+        }else if (output == "binary") { //user wants binary format, only the clustering commands read it
+            variables["[outputtag]"] = "binary";
+            outputFile = getOutputFileName("binary", variables);
+            util.mothurRemove(outputFile); outputTypes["binary"].push_back(outputFile);
         }else { //assume square
             variables["[outputtag]"] = "square";
             outputFile = getOutputFileName("phylip", variables);
@@ -319,16 +334,27 @@ struct pairwiseData {
     SequenceDB alignDB;
     SequenceDB oldFastaDB;
     OutputWriter* threadWriter;
+    BinaryDistWriter* binaryWriter;
+    TileScheduler* scheduler;
     Utils util;
     
     pairwiseData(){}
     pairwiseData(OutputWriter* ofn) {
         threadWriter = ofn;
+        binaryWriter = NULL; scheduler = NULL;
         m = MothurOut::getInstance();
     }
     
     pairwiseData(string ofn) {
         outputFileName = ofn;
+        threadWriter = NULL; binaryWriter = NULL; scheduler = NULL;
+        m = MothurOut::getInstance();
+    }
+    
+    pairwiseData(BinaryDistWriter* ofn, TileScheduler* sched) {
+        binaryWriter = ofn;
+        scheduler = sched;
+        threadWriter = NULL;
         m = MothurOut::getInstance();
     }
     
@@ -355,13 +381,13 @@ int driverColumn(pairwiseData* params){
         int startTime = time(NULL);
         
         Alignment* alignment;
-        if(params->align == "gotoh")			{	alignment = new GotohOverlap(params->gapOpen, params->gapExtend, params->match, params->misMatch, params->longestBase);			}
-        else if(params->align == "needleman")	{	alignment = new NeedlemanOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);				}
+        if(params->align == "gotoh")			{	alignment = new GotohSIMDOverlap(params->gapOpen, params->gapExtend, params->match, params->misMatch, params->longestBase);			}
+        else if(params->align == "needleman")	{	alignment = new NeedlemanSIMDOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);				}
         else if(params->align == "blast")		{	alignment = new BlastAlignment(params->gapOpen, params->gapExtend, params->match, params->misMatch);		}
         else if(params->align == "noalign")		{	alignment = new NoAlign();													}
         else {
             params->m->mothurOut(params->align + " is not a valid alignment option. I will run the command using needleman.\n");
-            alignment = new NeedlemanOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);
+            alignment = new NeedlemanSIMDOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);
         }
         
         ValidCalculators validCalculator;
@@ -423,13 +449,13 @@ int driverFitCalc(pairwiseData* params){
         int startTime = time(NULL);
         
         Alignment* alignment;
-        if(params->align == "gotoh")			{	alignment = new GotohOverlap(params->gapOpen, params->gapExtend, params->match, params->misMatch, params->longestBase);			}
-        else if(params->align == "needleman")	{	alignment = new NeedlemanOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);				}
+        if(params->align == "gotoh")			{	alignment = new GotohSIMDOverlap(params->gapOpen, params->gapExtend, params->match, params->misMatch, params->longestBase);			}
+        else if(params->align == "needleman")	{	alignment = new NeedlemanSIMDOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);				}
         else if(params->align == "blast")		{	alignment = new BlastAlignment(params->gapOpen, params->gapExtend, params->match, params->misMatch);		}
         else if(params->align == "noalign")		{	alignment = new NoAlign();													}
         else {
             params->m->mothurOut(params->align + " is not a valid alignment option. I will run the command using needleman.\n");
-            alignment = new NeedlemanOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);
+            alignment = new NeedlemanSIMDOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);
         }
         
         ValidCalculators validCalculator;
@@ -493,13 +519,13 @@ int driverLt(pairwiseData* params){
         int startTime = time(NULL);
         
         Alignment* alignment;
-        if(params->align == "gotoh")			{	alignment = new GotohOverlap(params->gapOpen, params->gapExtend, params->match, params->misMatch, params->longestBase);			}
-        else if(params->align == "needleman")	{	alignment = new NeedlemanOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);				}
+        if(params->align == "gotoh")			{	alignment = new GotohSIMDOverlap(params->gapOpen, params->gapExtend, params->match, params->misMatch, params->longestBase);			}
+        else if(params->align == "needleman")	{	alignment = new NeedlemanSIMDOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);				}
         else if(params->align == "blast")		{	alignment = new BlastAlignment(params->gapOpen, params->gapExtend, params->match, params->misMatch);		}
         else if(params->align == "noalign")		{	alignment = new NoAlign();													}
         else {
             params->m->mothurOut(params->align + " is not a valid alignment option. I will run the command using needleman.\n");
-            alignment = new NeedlemanOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);
+            alignment = new NeedlemanSIMDOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);
         }
         
         ValidCalculators validCalculator;
@@ -575,19 +601,99 @@ int driverLt(pairwiseData* params){
     }
 }
 /**************************************************************************************************/
+//the threads take blocks of rows from the scheduler, the writer puts the blocks back in row order
+int driverBinary(pairwiseData* params){
+    try {
+        int startTime = time(NULL);
+        
+        Alignment* alignment;
+        if(params->align == "gotoh")			{	alignment = new GotohSIMDOverlap(params->gapOpen, params->gapExtend, params->match, params->misMatch, params->longestBase);			}
+        else if(params->align == "needleman")	{	alignment = new NeedlemanSIMDOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);				}
+        else if(params->align == "blast")		{	alignment = new BlastAlignment(params->gapOpen, params->gapExtend, params->match, params->misMatch);		}
+        else if(params->align == "noalign")		{	alignment = new NoAlign();													}
+        else {
+            params->m->mothurOut(params->align + " is not a valid alignment option. I will run the command using needleman.\n");
+            alignment = new NeedlemanSIMDOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);
+        }
+        
+        ValidCalculators validCalculator;
+        DistCalc* distCalculator;
+        if (params->countends) {
+            if (validCalculator.isValidCalculator("distance", params->distcalcType) ) {
+                if (params->distcalcType == "nogaps")			{	distCalculator = new ignoreGaps(params->cutoff);	}
+                else if (params->distcalcType == "eachgap")	{	distCalculator = new eachGapDist(params->cutoff);	}
+                else if (params->distcalcType == "onegap")		{	distCalculator = new oneGapDist(params->cutoff);	}
+            }
+        }else {
+            if (validCalculator.isValidCalculator("distance", params->distcalcType) ) {
+                if (params->distcalcType == "nogaps")		{	distCalculator = new ignoreGaps(params->cutoff);					}
+                else if (params->distcalcType == "eachgap"){	distCalculator = new eachGapIgnoreTermGapDist(params->cutoff);	}
+                else if (params->distcalcType == "onegap")	{	distCalculator = new oneGapIgnoreTermGapDist(params->cutoff);		}
+            }
+        }
+        
+        BinaryDistRows rows;
+        DistanceTile tile;
+        while (params->scheduler->getNextTile(0, tile)) {
+            
+            long long count = 0;
+            for(long long i=tile.rowStart;i<tile.rowEnd;i++){
+                
+                Sequence seq = params->alignDB.get(i);
+                if (seq.getUnaligned().length() > alignment->getnRows()) { alignment->resize(seq.getUnaligned().length()+1); }
+                
+                for(long long j=0;j<i;j++){
+                    
+                    if (params->m->getControl_pressed()) {  break;  }
+                    
+                    Sequence seqI = seq;
+                    Sequence seqJ = params->alignDB.get(j);
+                    if (seqJ.getUnaligned().length() > alignment->getnRows()) { alignment->resize(seqJ.getUnaligned().length()+1); }
+                    
+                    alignment->align(seqI.getUnaligned(), seqJ.getUnaligned());
+                    seqI.setAligned(alignment->getSeqAAln());
+                    seqJ.setAligned(alignment->getSeqBAln());
+                    
+                    double dist = distCalculator->calcDist(seqI, seqJ);
+                    
+                    if (params->m->getDebug()) { params->m->mothurOut("[DEBUG]: " + seqI.getName() + '\t' +  alignment->getSeqAAln() + '\n' + seqJ.getName() + alignment->getSeqBAln() + "\n distance = " + toString(dist) + "\n"); }
+                    
+                    if(dist <= params->cutoff){ rows.add(j, dist); count++; }
+                }
+                rows.endRow();
+            }
+            
+            params->binaryWriter->write(tile.index, rows);
+            params->count += count;
+            
+            params->scheduler->tileDone(count);
+            params->m->mothurOutJustToScreen(toString(tile.rowEnd-1) + "\t" + toString(time(NULL) - startTime)+ "\t" + toString(params->scheduler->getNumBelowCutoff()) +"\n");
+        }
+        
+        delete alignment;
+        delete distCalculator;
+        
+        return 0;
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "PairwiseSeqsCommand", "driverBinary");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
 int driverSquare(pairwiseData* params){
     try {
         
         int startTime = time(NULL);
         
         Alignment* alignment;
-        if(params->align == "gotoh")			{	alignment = new GotohOverlap(params->gapOpen, params->gapExtend, params->match, params->misMatch, params->longestBase);			}
-        else if(params->align == "needleman")	{	alignment = new NeedlemanOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);				}
+        if(params->align == "gotoh")			{	alignment = new GotohSIMDOverlap(params->gapOpen, params->gapExtend, params->match, params->misMatch, params->longestBase);			}
+        else if(params->align == "needleman")	{	alignment = new NeedlemanSIMDOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);				}
         else if(params->align == "blast")		{	alignment = new BlastAlignment(params->gapOpen, params->gapExtend, params->match, params->misMatch);		}
         else if(params->align == "noalign")		{	alignment = new NoAlign();													}
         else {
             params->m->mothurOut(params->align + " is not a valid alignment option. I will run the command using needleman.\n");
-            alignment = new NeedlemanOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);
+            alignment = new NeedlemanSIMDOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);
         }
         
         ValidCalculators validCalculator;
@@ -676,6 +782,40 @@ void PairwiseSeqsCommand::createProcesses(string filename) {
         if (output == "square") { numDists = numSeqs * numSeqs; }
         else { for(int i=0;i<numSeqs;i++){ for(int j=0;j<i;j++){ numDists++; if (numDists > processors) { break; } } } }
         if (numDists < processors) { processors = numDists; }
+        
+        if (output == "binary") {
+            //every row costs as many alignments as its index, so hand out small blocks of rows as the threads free up
+            long long rowsPerTile = max(min(numSeqs / (16*(long long)processors), (long long)100), (long long)1);
+            vector<DistanceTile> tiles = TileScheduler::getRowTiles(numSeqs, numSeqs, rowsPerTile);
+            TileScheduler scheduler(tiles, 1);
+            
+            vector<string> names;
+            for (long long i = 0; i < numSeqs; i++) { names.push_back(alignDB.get(i).getName()); }
+            BinaryDistWriter binaryWriter(filename, names, float16, tiles.size());
+            
+            for (int i = 0; i < processors-1; i++) {
+                pairwiseData* dataBundle = new pairwiseData(&binaryWriter, &scheduler);
+                dataBundle->setVariables(align, Estimators[0], countends, output, alignDB, SequenceDB(), 0, numSeqs, match, misMatch, gapOpen, gapExtend, longestBase, cutoff);
+                data.push_back(dataBundle);
+                workerThreads.push_back(new std::thread(driverBinary, dataBundle));
+            }
+            
+            pairwiseData* dataBundle = new pairwiseData(&binaryWriter, &scheduler);
+            dataBundle->setVariables(align, Estimators[0], countends, output, alignDB, SequenceDB(), 0, numSeqs, match, misMatch, gapOpen, gapExtend, longestBase, cutoff);
+            driverBinary(dataBundle);
+            numDistsBelowCutoff = dataBundle->count;
+            
+            for (int i = 0; i < processors-1; i++) {
+                workerThreads[i]->join();
+                numDistsBelowCutoff += data[i]->count;
+                delete data[i];
+                delete workerThreads[i];
+            }
+            delete dataBundle;
+            
+            binaryWriter.close();
+            return;
+        }
        
         for (int i = 0; i < processors; i++) {
             linePair tempLine;
@@ -21,6 +21,7 @@
 
 #include "gotohoverlap.hpp"
 #include "needlemanoverlap.hpp"
+#include "simdoverlap.hpp"
 #include "blastalign.hpp"
 #include "noalign.hpp"
 
@@ -30,6 +31,8 @@
 #include "onegapdist.h"
 #include "onegapignore.h"
 #include "writer.h"
+#include "tilescheduler.hpp"
+#include "binarydistfile.hpp"
 
 class PairwiseSeqsCommand : public Command {
 	
@@ -60,7 +63,7 @@ private:
 	int processors, longestBase, numDistsBelowCutoff;
 	vector<string> Estimators, outputNames;
 	
-	bool abort, countends, compress, fitCalc;
+	bool abort, countends, compress, fitCalc, float16;
 };
 
 #endif
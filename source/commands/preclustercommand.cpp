@@ -69,6 +69,8 @@ string PreClusterCommand::getHelpString(){
     helpString += "The method parameter allows you to specify the algorithm to use to complete the preclusterign step. Possible methods include simple, tree, unoise, and deblur.  Default=simple.\n";
     helpString += "The clump parameter allows you to specify which reads can be combined. Possible options include lessthan and lessthanequal. lessthan -> merge reads with less abundance. lessthanequal -> merge reads with less than or equal abundance Default=lessthan.\n";
     helpString += "The align parameter allows you to specify the alignment align_method to use.  Your options are: gotoh, needleman, blast and noalign. The default is needleman.\n";
+    helpString += "With needleman and gotoh, pairs that can't share enough kmers to be within diffs are skipped and the rest are aligned in a band diffs wide.\n";
+    helpString += "The processors parameter allows you to specify the number of processors to use. The groups are split between the processors, and when there are fewer groups than processors the pairs within each group are split as well.\n";
     helpString += "The match parameter allows you to specify the bonus for having the same base. The default is 1.0.\n";
     helpString += "The mistmatch parameter allows you to specify the penalty for having different bases.  The default is -1.0.\n";
     helpString += "The gapopen parameter allows you to specify the penalty for opening a gap in an alignment. The default is -2.0.\n";
@@ -286,7 +288,7 @@ struct preClusterData {
   string fastafile, countfile, pc_method, align_method, align, newMName, clump;
   OutputWriter* newNName;
   MothurOut* m;
-  int start, end, count, diffs, length, numGroups;
+  int start, end, count, diffs, length, numGroups, processors;
   vector<string> groups;
   bool hasCount;
   float match, misMatch, gapOpen, gapExtend, alpha, delta, error_rate, indel_prob, max_indels;
@@ -321,7 +323,7 @@ struct preClusterData {
       parsedFiles = g2f;
   }
 
-  void setVariables(int d, string pcm, string am, string al, float ma, float misma, float gpOp, float gpEx, float a, float del, float me, float ip, float mi, vector<float> ed) {
+  void setVariables(int d, string pcm, string am, string al, float ma, float misma, float gpOp, float gpEx, float a, float del, float me, float ip, float mi, vector<float> ed, int p) {
     
       numGroups = groups.size();
     diffs = d;
@@ -338,37 +340,32 @@ struct preClusterData {
 		indel_prob = ip;
 		max_indels = mi;
 		error_dist = ed;
+    processors = p;
     length = 0;
 
-    if (align_method == "unaligned") {
-      if(align == "gotoh")	{	alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, 1000);	}
-      else if(align == "needleman")	{	alignment = new NeedlemanOverlap(gapOpen, match, misMatch, 1000);			}
-      else if(align == "blast")		{	alignment = new BlastAlignment(gapOpen, gapExtend, match, misMatch);		}
-      else if(align == "noalign")		{	alignment = new NoAlign();													}
-      else {
-          m->mothurOut(align + " is not a valid alignment option. I will run the command using needleman.");
-          m->mothurOutEndLine();
-          alignment = new NeedlemanOverlap(gapOpen, match, misMatch, 1000);
-      }
-    } else { alignment = NULL; }
+    if (align_method == "unaligned") { alignment = createAlignment(); }
+    else { alignment = NULL; }
+  }
+
+  //the pair search threads each need their own
+  Alignment* createAlignment() {
+      if(align == "gotoh")	{	return new GotohOverlap(gapOpen, gapExtend, match, misMatch, 1000);	}
+      else if(align == "needleman")	{	return new NeedlemanOverlap(gapOpen, match, misMatch, 1000);			}
+      else if(align == "blast")		{	return new BlastAlignment(gapOpen, gapExtend, match, misMatch);		}
+      else if(align == "noalign")		{	return new NoAlign();													}
+
+      m->mothurOut(align + " is not a valid alignment option. I will run the command using needleman.");
+      m->mothurOutEndLine();
+      return new NeedlemanOverlap(gapOpen, match, misMatch, 1000);
   }
 };
 
 /**************************************************************************************************/
 
-int calcMisMatches(string seq1, string seq2, preClusterData* params){
+//diffs over the span of seq2 in its pairwise alignment to seq1
+int countMisMatches(string seq1, string seq2, preClusterData* params){
   try {
-    int numBad = 0;
-
-    if (params->align_method == "unaligned") {
-      //align to eachother
-      Sequence seqI("seq1", seq1);
-      Sequence seqJ("seq2", seq2);
-
-      //align seq2 to seq1 - less abundant to more abundant
-      params->alignment->align(seqJ.getUnaligned(), seqI.getUnaligned());
-      seq2 = params->alignment->getSeqAAln();
-      seq1 = params->alignment->getSeqBAln();
+      int numBad = 0;
 
       //chop gap ends
       int startPos = 0;
@@ -381,6 +378,29 @@ int calcMisMatches(string seq1, string seq2, preClusterData* params){
         if (seq2[i] != seq1[i]) { numBad++; }
         if (numBad > params->diffs) { return params->length;  } //too far to cluster
       }
+      return numBad;
+  }
+  catch(exception& e) {
+      params->m->errorOut(e, "PreClusterCommand", "countMisMatches");
+      exit(1);
+  }
+}
+
+/**************************************************************************************************/
+
+int calcMisMatches(string seq1, string seq2, Alignment* alignment, preClusterData* params){
+  try {
+    int numBad = 0;
+
+    if (params->align_method == "unaligned") {
+      //align to eachother
+      Sequence seqI("seq1", seq1);
+      Sequence seqJ("seq2", seq2);
+
+      //align seq2 to seq1 - less abundant to more abundant
+      alignment->align(seqJ.getUnaligned(), seqI.getUnaligned());
+
+      numBad = countMisMatches(alignment->getSeqBAln(), alignment->getSeqAAln(), params);
 
     } else {
       //count diffs
@@ -472,6 +492,268 @@ void mergeSeqs(seqPNode* representative, seqPNode* duplicate, string& chunk, int
 }
 /**************************************************************************************************/
 
+//a pair the merge loops in process() can use, seq j is within diffs of the more abundant seq i
+struct preClusterPair {
+    int i, j, mismatch;
+
+    preClusterPair(int a, int b, int mm) : i(a), j(b), mismatch(mm) {}
+};
+/**************************************************************************************************/
+inline bool comparePreClusterPairs(const preClusterPair& left, const preClusterPair& right) {
+    if (left.i != right.i) { return (left.i < right.i); }
+    return (left.j < right.j);
+}
+/**************************************************************************************************/
+static const int preClusterKmerSize = 8;
+
+struct preClusterPairData {
+    preClusterData* params;
+    TileScheduler* scheduler;
+    vector<int>* originalCount;
+    vector<string>* unaligned; //ungapped seqs, filled when the pairs are banded
+    vector< vector<int> >* kmers; //sorted kmer numbers of the ungapped seqs
+    vector<preClusterPair> pairs;
+    int threadID;
+    bool banded;
+    MothurOut* m;
+
+    preClusterPairData(preClusterData* p, TileScheduler* s, vector<int>* oc, vector<string>* u, vector< vector<int> >* k, int t, bool b) {
+        params = p;
+        scheduler = s;
+        originalCount = oc;
+        unaligned = u;
+        kmers = k;
+        threadID = t;
+        banded = b;
+        m = MothurOut::getInstance();
+    }
+};
+/**************************************************************************************************/
+//the abundance tests of the merge loops in process(), they don't change as seqs are merged
+bool isMergeCandidate(int i, int j, vector<int>& originalCount, preClusterData* params){
+    if (params->pc_method == "tree")            { return (originalCount[i] > originalCount[j] * params->delta); }
+    else if (params->pc_method == "unoise")     { return (originalCount[j] < originalCount[i]);                  }
+    else if (params->clump == "lessthanequal")  { return (originalCount[j] <= originalCount[i]);                 }
+    return (originalCount[j] < originalCount[i]);
+}
+/**************************************************************************************************/
+//A diff in the alignment takes at most preClusterKmerSize of seq j's kmers, the kmers that miss every diff are also in
+//seq i. So a pair within diffs shares at least (number of kmers in j - preClusterKmerSize * diffs) kmers.
+bool mayBeWithinDiffs(int i, int j, preClusterPairData* params){
+    try {
+        int diffs = params->params->diffs;
+        int lengthI = (*params->unaligned)[i].length();
+        int lengthJ = (*params->unaligned)[j].length();
+
+        //the bases of seq j past the length of seq i can only be aligned to gaps
+        if ((lengthJ - lengthI) > diffs) { return false; }
+
+        int needed = (lengthJ - preClusterKmerSize + 1) - (preClusterKmerSize * diffs);
+        if (needed <= 0) { return true; }
+
+        vector<int>& kmersI = (*params->kmers)[i];
+        vector<int>& kmersJ = (*params->kmers)[j];
+
+        int shared = 0;
+        int a = 0, b = 0;
+        while ((a < kmersI.size()) && (b < kmersJ.size())) {
+            if ((shared + min(kmersI.size() - a, kmersJ.size() - b)) < needed) { return false; }
+
+            if (kmersI[a] == kmersJ[b])     { shared++; a++; b++; if (shared >= needed) { return true; } }
+            else if (kmersI[a] < kmersJ[b]) { a++; }
+            else                            { b++; }
+        }
+        return (shared >= needed);
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "PreClusterCommand", "mayBeWithinDiffs");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//the diagonal (position in seq j - position in seq i) with the most shared kmers, false if they share none
+bool getSeedDiagonal(const string& seqI, const string& seqJ, Kmer& kmer, vector< pair<int, int> >& kmersI, vector<int>& votes, int& diagonal){
+    int lengthI = seqI.length();
+    int lengthJ = seqJ.length();
+    int ambiguous = (int)pow(4.0, preClusterKmerSize); //kmers with an N
+
+    kmersI.clear();
+    for (int p = 0; p <= lengthI - preClusterKmerSize; p++) { kmersI.push_back(pair<int, int>(kmer.getKmerNumber(seqI, p), p)); }
+    sort(kmersI.begin(), kmersI.end());
+
+    votes.assign(lengthI + lengthJ + 1, 0);
+    for (int q = 0; q <= lengthJ - preClusterKmerSize; q++) {
+        int kmerNumber = kmer.getKmerNumber(seqJ, q);
+        if (kmerNumber == ambiguous) { continue; }
+
+        vector< pair<int, int> >::iterator it = lower_bound(kmersI.begin(), kmersI.end(), pair<int, int>(kmerNumber, 0));
+        for (; (it != kmersI.end()) && (it->first == kmerNumber); it++) { votes[q - it->second + lengthI]++; }
+    }
+
+    //ties go to the diagonal nearest the main one
+    int best = 0;
+    for (int d = 0; d < votes.size(); d++) {
+        if ((votes[d] > best) || ((votes[d] == best) && (best != 0) && (abs(d - lengthI) < abs(diagonal)))) {
+            best = votes[d]; diagonal = d - lengthI;
+        }
+    }
+    return (best != 0);
+}
+/**************************************************************************************************/
+//The pair's alignment can only leave the seed diagonal by one diagonal per diff, so a band diffs wide holds the
+//alignment of any pair within diffs, if the seed diagonal is on it. Pairs that share no kmers get the whole matrix.
+int bandedMisMatches(int i, int j, preClusterPairData* params, BandedOverlap* alignment, Kmer& kmer, vector< pair<int, int> >& kmersI, vector<int>& votes){
+    try {
+        string& seqI = (*params->unaligned)[i];
+        string& seqJ = (*params->unaligned)[j];
+        int wholeMatrix = max(seqI.length(), seqJ.length());
+
+        int diagonal = 0;
+        bool seeded = getSeedDiagonal(seqI, seqJ, kmer, kmersI, votes, diagonal);
+        if (seeded) { alignment->setBand(diagonal, params->params->diffs); }
+        else { alignment->setBand(0, wholeMatrix); }
+
+        //align seq j to seq i - less abundant to more abundant
+        alignment->align(seqJ, seqI);
+
+        int mismatches = countMisMatches(alignment->getSeqBAln(), alignment->getSeqAAln(), params->params);
+
+        //in repeats the most voted diagonal can be off the best path, so a pair the band puts past diffs gets the whole matrix
+        if (seeded && (mismatches > params->params->diffs)) {
+            alignment->setBand(0, wholeMatrix);
+            alignment->align(seqJ, seqI);
+            mismatches = countMisMatches(alignment->getSeqBAln(), alignment->getSeqAAln(), params->params);
+        }
+
+        return mismatches;
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "PreClusterCommand", "bandedMisMatches");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//the tiles are the lower triangle, row j against the more abundant columns i
+void driverPairs(preClusterPairData* params){
+    try {
+        preClusterData* data = params->params;
+
+        BandedOverlap* bandedAlignment = NULL;
+        Alignment* alignment = NULL;
+        if (params->banded) {
+            if (data->align == "gotoh") { bandedAlignment = new GotohBandedOverlap(data->gapOpen, data->gapExtend, data->match, data->misMatch); }
+            else { bandedAlignment = new NeedlemanBandedOverlap(data->gapOpen, data->match, data->misMatch); }
+        }else if (data->align_method == "unaligned") { alignment = data->createAlignment(); }
+
+        Kmer kmer(preClusterKmerSize);
+        vector< pair<int, int> > kmersI;
+        vector<int> votes;
+
+        DistanceTile tile;
+        while (params->scheduler->getNextTile(params->threadID, tile)) {
+
+            if (params->m->getControl_pressed()) { break; }
+
+            for (long long j = tile.rowStart; j < tile.rowEnd; j++) {
+
+                long long colEnd = min(tile.colEnd, j);
+                for (long long i = tile.colStart; i < colEnd; i++) {
+
+                    if (!isMergeCandidate(i, j, *params->originalCount, data)) { continue; }
+
+                    int mismatch = data->length;
+                    if (params->banded) {
+                        if (mayBeWithinDiffs(i, j, params)) { mismatch = bandedMisMatches(i, j, params, bandedAlignment, kmer, kmersI, votes); }
+                    }else {
+                        mismatch = calcMisMatches(data->alignSeqs[i]->sequence, data->alignSeqs[j]->sequence, alignment, data);
+                    }
+
+                    if (mismatch <= data->diffs) { params->pairs.push_back(preClusterPair(i, j, mismatch)); }
+                }
+            }
+            params->scheduler->tileDone(0);
+        }
+
+        if (bandedAlignment != NULL) { delete bandedAlignment; }
+        if (alignment != NULL) { delete alignment; }
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "PreClusterCommand", "driverPairs");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//Finds every pair the merge loops can use, i < j, j within diffs of i, before any are merged. The pairs don't depend
+//on the merging, so the O(n^2) comparisons are split between the processors and the merge walks the lists in order.
+vector< vector< pair<int, int> > > getMergePairs(vector<int>& originalCount, preClusterData* params){
+    try {
+        long long numSeqs = params->alignSeqs.size();
+        vector< vector< pair<int, int> > > neighbors(numSeqs); //neighbors[i] = (j, mismatch) in j order
+
+        bool banded = (params->align_method == "unaligned") && ((params->align == "needleman") || (params->align == "gotoh"));
+
+        vector<string> unaligned;
+        vector< vector<int> > kmers;
+        long long bytesPerRow = params->length;
+        if (banded) {
+            Kmer kmer(preClusterKmerSize);
+            bytesPerRow = 0;
+            for (int i = 0; i < numSeqs; i++) {
+                Sequence seq("seq", params->alignSeqs[i]->sequence);
+                unaligned.push_back(seq.getUnaligned());
+
+                vector<int> seqKmers;
+                for (int p = 0; p <= (int)unaligned[i].length() - preClusterKmerSize; p++) { seqKmers.push_back(kmer.getKmerNumber(unaligned[i], p)); }
+                sort(seqKmers.begin(), seqKmers.end());
+                kmers.push_back(seqKmers);
+                bytesPerRow += seqKmers.size() * sizeof(int);
+            }
+            if (numSeqs != 0) { bytesPerRow /= numSeqs; }
+        }
+
+        int processors = max(params->processors, 1);
+        long long tileSize = TileScheduler::getTileSize(bytesPerRow, numSeqs, processors);
+        TileScheduler scheduler(TileScheduler::getTriangleTiles(numSeqs, tileSize), processors);
+
+        //create array of worker threads
+        vector<std::thread*> workerThreads;
+        vector<preClusterPairData*> data;
+
+        //Lauch worker threads
+        for (int i = 0; i < processors-1; i++) {
+            preClusterPairData* dataBundle = new preClusterPairData(params, &scheduler, &originalCount, &unaligned, &kmers, i+1, banded);
+            data.push_back(dataBundle);
+
+            workerThreads.push_back(new std::thread(driverPairs, dataBundle));
+        }
+
+        preClusterPairData* dataBundle = new preClusterPairData(params, &scheduler, &originalCount, &unaligned, &kmers, 0, banded);
+        driverPairs(dataBundle);
+
+        vector<preClusterPair> pairs = dataBundle->pairs;
+        delete dataBundle;
+
+        for (int i = 0; i < processors-1; i++) {
+            workerThreads[i]->join();
+
+            pairs.insert(pairs.end(), data[i]->pairs.begin(), data[i]->pairs.end());
+
+            delete data[i];
+            delete workerThreads[i];
+        }
+
+        sort(pairs.begin(), pairs.end(), comparePreClusterPairs);
+        for (int k = 0; k < pairs.size(); k++) { neighbors[pairs[k].i].push_back(pair<int, int>(pairs[k].j, pairs[k].mismatch)); }
+
+        return neighbors;
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "PreClusterCommand", "getMergePairs");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
 int process(string group, string newMapFile, preClusterData* params){
     try {
         ofstream out;
@@ -492,8 +774,10 @@ int process(string group, string newMapFile, preClusterData* params){
         
         for (int i = 0; i < numSeqs; i++) { originalCount[i] = params->alignSeqs[i]->numIdentical; }
         
-        bool lessThan = true;
-        if (params->clump == "lessthanequal") { lessThan = false; }
+        vector< vector< pair<int, int> > > neighbors; //(j, mismatch) of the pairs within diffs
+        if(params->pc_method != "deblur"){ neighbors = getMergePairs(originalCount, params); }
+        
+        if (params->m->getControl_pressed()) { out.close(); return 0; }
         
         if(params->pc_method == "simple"){
             for (int i = 0; i < numSeqs; i++) {
@@ -502,22 +786,16 @@ int process(string group, string newMapFile, preClusterData* params){
                     
                     string chunk = params->alignSeqs[i]->name + "\t" + params->alignSeqs[i]->name + "\t" + toString(originalCount[i]) + "\t" + toString(0) + "\t" + params->alignSeqs[i]->sequence + "\n";
                     
-                    //try to merge it with all smaller seqs
-                    for (int j = i+1; j < numSeqs; j++) {
+                    //try to merge it with all smaller seqs within "diff" bases
+                    for (int k = 0; k < neighbors[i].size(); k++) {
                         
                         if (params->m->getControl_pressed()) { out.close(); return 0; }
                         
-                        bool ableToMerge = false;
-                        if (lessThan) { //default
-                            if (originalCount[j] < originalCount[i]) { ableToMerge = true; }
-                        }else { //less than equal to
-                            if (originalCount[j] <= originalCount[i]) { ableToMerge = true; }
-                        }
-                        if ((params->alignSeqs[j]->numIdentical != 0) && (ableToMerge)) {  //this sequence has not been merged yet //
-                            //are you within "diff" bases
-                            int mismatch = calcMisMatches(params->alignSeqs[i]->sequence, params->alignSeqs[j]->sequence, params);
-                            
-                            if (mismatch <= params->diffs) { mergeSeqs(params->alignSeqs[i], params->alignSeqs[j], chunk, mismatch, originalCount[j], params); count++; }
+                        int j = neighbors[i][k].first;
+                        int mismatch = neighbors[i][k].second;
+                        
+                        if (params->alignSeqs[j]->numIdentical != 0) {  //this sequence has not been merged yet //
+                            mergeSeqs(params->alignSeqs[i], params->alignSeqs[j], chunk, mismatch, originalCount[j], params); count++;
                         }
                     }
                     out << chunk;
@@ -540,21 +818,20 @@ int process(string group, string newMapFile, preClusterData* params){
                     
                     string chunk = params->alignSeqs[i]->name + "\t" + params->alignSeqs[i]->name + "\t" + toString(originalCount[i]) + "\t" + toString(0) + "\t" + params->alignSeqs[i]->sequence + "\n";
                     
-                    //try to merge it with all smaller seqs
-                    for (int j = i+1; j < numSeqs; j++) {
+                    //try to merge it with all smaller seqs within "diff" bases
+                    for (int k = 0; k < neighbors[i].size(); k++) {
                         
                         if (params->m->getControl_pressed()) { out.close(); return 0; }
                         
-                        if (params->alignSeqs[j]->numIdentical != 0 && (originalCount[j] < originalCount[i])) {  //this sequence has not been merged yet
+                        int j = neighbors[i][k].first;
+                        int mismatch = neighbors[i][k].second;
+                        
+                        if (params->alignSeqs[j]->numIdentical != 0) {  //this sequence has not been merged yet
                             
                             double skew = (double)originalCount[j]/(double)originalCount[i];
                             
-                            int mismatch = calcMisMatches(params->alignSeqs[i]->sequence, params->alignSeqs[j]->sequence, params);
-                        
-                            if (mismatch <= params->diffs) {
-                                if (skew <= beta[mismatch]) {
-                                    mergeSeqs(params->alignSeqs[i], params->alignSeqs[j], chunk, mismatch, originalCount[j], params); count++;
-                                }
+                            if (skew <= beta[mismatch]) {
+                                mergeSeqs(params->alignSeqs[i], params->alignSeqs[j], chunk, mismatch, originalCount[j], params); count++;
                             }
                         }
                     }
@@ -576,15 +853,14 @@ int process(string group, string newMapFile, preClusterData* params){
                 
                 if (params->m->getControl_pressed()) { out.close(); return 0; }
                 
-                for (int j=i+1;j<numSeqs;j++) {
+                for (int k = 0; k < neighbors[i].size(); k++) {
                     
                     if (params->m->getControl_pressed()) { out.close(); return 0; }
                     
-                    if(originalCount[i] > originalCount[j] * params->delta){
-                        int mismatches = calcMisMatches(params->alignSeqs[i]->sequence, params->alignSeqs[j]->sequence, params);
-                        
-                        if(mismatches == 1){ cluster[j] = cluster[i]; }
-                    }
+                    int j = neighbors[i][k].first;
+                    int mismatches = neighbors[i][k].second;
+                    
+                    if(mismatches == 1){ cluster[j] = cluster[i]; }
                 }
                 
                 if(cluster[i] == i) count++;
@@ -596,6 +872,7 @@ int process(string group, string newMapFile, preClusterData* params){
             
             count = 0;
             vector<string> chunk(numSeqs, "");
+            int maxDiffs = params->diffs; //the diffs are reported in full, the next group's pairs still use diffs
             
             for(int i=0;i<numSeqs;i++){
                 
@@ -609,7 +886,7 @@ int process(string group, string newMapFile, preClusterData* params){
                     params->alignSeqs[cluster[i]]->numIdentical += params->alignSeqs[i]->numIdentical;
                     
                     params->diffs = params->length;
-                    int mismatches = calcMisMatches(params->alignSeqs[i]->sequence, params->alignSeqs[cluster[i]]->sequence, params);
+                    int mismatches = calcMisMatches(params->alignSeqs[i]->sequence, params->alignSeqs[cluster[i]]->sequence, params->alignment, params);
                     
                     chunk[cluster[i]] += params->alignSeqs[cluster[i]]->name + "\t" + params->alignSeqs[i]->name + "\t" + toString(originalCount[i]) + "\t" + toString(mismatches) + "\t" + params->alignSeqs[i]->sequence + "\n";
                     params->alignSeqs[i]->numIdentical = 0;
@@ -623,6 +900,7 @@ int process(string group, string newMapFile, preClusterData* params){
                     out << chunk[i];
                 }
             }
+            params->diffs = maxDiffs;
             
         } else if(params->pc_method == "deblur") {
             
@@ -928,12 +1206,10 @@ int PreClusterCommand::execute(){
             m->mothurOut("It took " + toString(time(NULL) - start) + " secs to run pre.cluster.\n");
             
         }else {
-            if (processors != 1) { m->mothurOut("When using running without group information mothur can only use 1 processor, continuing.\n");  processors = 1; }
-            
             vector<string> groups;
             map<string, vector<string> > group2Files;
             preClusterData* params = new preClusterData(group2Files, fastafile, countfile, pc_method, align_method, clump, NULL, newMapFile, nullVector);
-            params->setVariables(diffs, pc_method, align_method, align, match, misMatch, gapOpen, gapExtend, alpha, delta, error_rate, indel_prob, max_indels, error_dist);
+            params->setVariables(diffs, pc_method, align_method, align, match, misMatch, gapOpen, gapExtend, alpha, delta, error_rate, indel_prob, max_indels, error_dist, processors);
             
             //reads fasta file and return number of seqs
             long long numSeqs = 0; params->alignSeqs = readFASTA(params, numSeqs); //fills alignSeqs and makes all seqs active
@@ -1270,14 +1546,15 @@ string PreClusterCommand::mergeGroupCounts(string newcount, string newname){
 void PreClusterCommand::createProcessesGroups(map<string, vector<string> >& parsedFiles, vector<string> groups, string newNName, string newMFile) {
   try {
     
-    //sanity check
-    if (groups.size() < processors) { processors = groups.size(); m->mothurOut("Reducing processors to " + toString(groups.size()) + ".\n"); }
+    //divide the groups between the processors, with fewer groups than processors the rest split each group's pairs
+    int groupProcessors = processors;
+    if (groups.size() < groupProcessors) { groupProcessors = max((int)groups.size(), 1); }
+    int pairProcessors = processors / groupProcessors;
 
-    //divide the groups between the processors
     vector<linePair> lines;
     int remainingPairs = groups.size();
     int startIndex = 0;
-    for (int remainingProcessors = processors; remainingProcessors > 0; remainingProcessors--) {
+    for (int remainingProcessors = groupProcessors; remainingProcessors > 0; remainingProcessors--) {
       int numPairs = remainingPairs; //case for last processor
       if (remainingProcessors != 1) { numPairs = ceil(remainingPairs / remainingProcessors); }
       lines.push_back(linePair(startIndex, (startIndex+numPairs))); //startIndex, endIndex
@@ -1292,7 +1569,7 @@ void PreClusterCommand::createProcessesGroups(map<string, vector<string> >& pars
     auto synchronizedNameFile = std::make_shared<SynchronizedOutputFile>(newNName);
 
     //Lauch worker threads
-    for (int i = 0; i < processors-1; i++) {
+    for (int i = 0; i < groupProcessors-1; i++) {
       OutputWriter* threadNameWriter = new OutputWriter(synchronizedNameFile);
         
         vector<string> thisGroups;
@@ -1308,7 +1585,7 @@ void PreClusterCommand::createProcessesGroups(map<string, vector<string> >& pars
         }
         
       preClusterData* dataBundle = new preClusterData(thisGroupsParsedFiles, fastafile, countfile, pc_method, align_method, clump, threadNameWriter, newMFile, thisGroups);
-      dataBundle->setVariables(diffs, pc_method, align_method, align, match, misMatch, gapOpen, gapExtend, alpha, delta, error_rate, indel_prob, max_indels, error_dist);
+      dataBundle->setVariables(diffs, pc_method, align_method, align, match, misMatch, gapOpen, gapExtend, alpha, delta, error_rate, indel_prob, max_indels, error_dist, pairProcessors);
       data.push_back(dataBundle);
 
       workerThreads.push_back(new std::thread(driverGroups, dataBundle));
@@ -1327,7 +1604,7 @@ void PreClusterCommand::createProcessesGroups(map<string, vector<string> >& pars
           else { m->mothurOut("[ERROR]: missing files for group " + groups[j] + ", skipping\n"); }
       }
     preClusterData* dataBundle = new preClusterData(thisGroupsParsedFiles, fastafile, countfile, pc_method, align_method, clump, threadNameWriter, newMFile, thisGroups);
-    dataBundle->setVariables(diffs, pc_method, align_method, align, match, misMatch, gapOpen, gapExtend, alpha, delta, error_rate, indel_prob, max_indels, error_dist);
+    dataBundle->setVariables(diffs, pc_method, align_method, align, match, misMatch, gapOpen, gapExtend, alpha, delta, error_rate, indel_prob, max_indels, error_dist, pairProcessors);
 
     driverGroups(dataBundle);
 
@@ -1336,7 +1613,7 @@ void PreClusterCommand::createProcessesGroups(map<string, vector<string> >& pars
         outputTypes[itTypes->first].insert(outputTypes[itTypes->first].end(), itTypes->second.begin(), itTypes->second.end());
     }
 
-    for (int i = 0; i < processors-1; i++) {
+    for (int i = 0; i < groupProcessors-1; i++) {
       workerThreads[i]->join();
 
       delete data[i]->newNName;
@@ -19,6 +19,9 @@
 #include "alignment.hpp"
 #include "gotohoverlap.hpp"
 #include "needlemanoverlap.hpp"
+#include "bandedoverlap.hpp"
+#include "kmer.hpp"
+#include "tilescheduler.hpp"
 #include "blastalign.hpp"
 #include "noalign.hpp"
 #include "filters.h"
@@ -335,6 +335,8 @@ int RemoveDistsCommand::readPhylip(){
 //**********************************************************************************************************************
 int RemoveDistsCommand::readColumn(){
 	try {
+        if (BinaryDistFile::isBinary(columnfile)) { m->mothurOut("[ERROR]: " + columnfile + " is a binary distance file, remove.dists needs a column file.\n"); m->setControl_pressed(true); return 0; }
+        
 		string thisOutputDir = outputdir;
 		if (outputdir == "") {  thisOutputDir += util.hasPath(columnfile);  }
         map<string, string> variables; 
@@ -10,6 +10,7 @@
 #define Mothur_removedistscommand_h
 
 #include "command.hpp"
+#include "binarydistfile.hpp"
 
 class RemoveDistsCommand : public Command {
 	
@@ -1046,8 +1046,9 @@ int ScreenSeqsCommand::createProcesses(string goodFileName, string badAccnos, st
         //Lauch worker threads
         for (int i = 0; i < processors-1; i++) {
             
-            OutputWriter* outputThreadWriter = new OutputWriter(synchronizedOutputFile);
-            OutputWriter* accnosThreadWriter = new OutputWriter(synchronizedAccnosFile);
+            //ordered by the piece of the fasta file, so the output is in input order
+            OutputWriter* outputThreadWriter = new OutputWriter(synchronizedOutputFile, i+1);
+            OutputWriter* accnosThreadWriter = new OutputWriter(synchronizedAccnosFile, i+1);
             
             sumScreenData* dataBundle = new sumScreenData(startPos, endPos, maxAmbig, maxHomoP, minLength, maxLength, maxN, badSeqNames, filename, summaryfile, contigsreport, lines[i+1].start, lines[i+1].end,outputThreadWriter, accnosThreadWriter);
             
@@ -1055,8 +1056,8 @@ int ScreenSeqsCommand::createProcesses(string goodFileName, string badAccnos, st
             workerThreads.push_back(new std::thread(driverScreen, dataBundle));
         }
         
-        OutputWriter* outputThreadWriter = new OutputWriter(synchronizedOutputFile);
-        OutputWriter* accnosThreadWriter = new OutputWriter(synchronizedAccnosFile);
+        OutputWriter* outputThreadWriter = new OutputWriter(synchronizedOutputFile, 0);
+        OutputWriter* accnosThreadWriter = new OutputWriter(synchronizedAccnosFile, 0);
 
         sumScreenData* dataBundle = new sumScreenData(startPos, endPos, maxAmbig, maxHomoP, minLength, maxLength, maxN, badSeqNames, filename, summaryfile, contigsreport, lines[0].start, lines[0].end,outputThreadWriter, accnosThreadWriter);
         driverScreen(dataBundle);
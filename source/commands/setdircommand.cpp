@@ -42,7 +42,7 @@ string SetDirectoryCommand::getHelpString(){
 		helpString += "The set.dir command can also be used to specify the directory where your input files are located, the directory must exist.\n";
 		helpString += "The set.dir command can also be used to override or set the default location mothur will look for files if it is unable to find them, the directory must exist.\n";
         helpString += "The set.dir command can also be used to set the location of the blast directory if other than mothur's executable location, the directory must exist.\n";
-        helpString += "The set.dir command can also be used to set the location of the directory containing mothur's external tools, i.e. vsearch, uchime, blast, fasterqdump, if other than mothur's executable location. You can set this to /usr/bin for example. \n";
+        helpString += "The set.dir command can also be used to set the location of the directory containing mothur's external tools, i.e. vsearch, blast, fasterqdump, if other than mothur's executable location. You can set this to /usr/bin for example. \n";
         helpString += "The set.dir command can also be used to run mothur in debug mode.\n";
         helpString += "The set.dir command can also be used to seed random.\n";
         helpString += "The set.dir command can also be used to set the modifynames parameter. Default=t, meaning if your sequence names contain ':' change them to '_' to avoid issues while making trees.  modifynames=F will leave sequence names as they are.\n";
@@ -292,8 +292,23 @@ int SummarySharedCommand::execute(){
         set<string> userLabels = labels;
         string lastLabel = "";
         
-        SharedRAbundVectors* lookup = util.getNextShared(input, allLines, userLabels, processedLabels, lastLabel);
-        Groups = lookup->getNamesGroups();
+        //without subsampling or the calculators that take every group, the engine computes every calculator from the sparse tables
+        bool useTables = (!subsample) && (!mult) && input.hasLabelIndex();
+        for (int i = 0; i < sumCalculators.size(); i++) { if (!BetaDiversityEngine::isBatched(sumCalculators[i]->getName())) { useTables = false; } }
+        
+        vector<SharedRAbundVectors*> lookups; SharedRAbundVectors* lookup = NULL; SparseSharedTable* table = NULL;
+        if (useTables) {
+            table = util.getNextSparseShared(input, allLines, userLabels, processedLabels, lastLabel);
+            if (table == NULL) { for(int i=0;i<sumCalculators.size();i++){  delete sumCalculators[i]; } return 0; }
+            Groups = table->getGroups();
+            numGroups = table->getNumGroups();
+        }else {
+            lookups = util.getNextShared(input, allLines, userLabels, processedLabels, lastLabel, 1);
+            if (lookups.size() == 0) { for(int i=0;i<sumCalculators.size();i++){  delete sumCalculators[i]; } return 0; }
+            lookup = lookups[0];
+            Groups = lookup->getNamesGroups();
+            numGroups = lookup->size();
+        }
 
 		/******************************************************/
 		//output headings for files
@@ -324,9 +339,9 @@ int SummarySharedCommand::execute(){
             }
 		}
 		
-		if (lookup->size() < 2) {
+		if (numGroups < 2) {
 			m->mothurOut("I cannot run the command without at least 2 valid groups."); 
-			delete lookup;
+			delete lookup; delete table;
 			
             if (!subsample) {
                 //close files and clean up
@@ -335,13 +350,13 @@ int SummarySharedCommand::execute(){
             }
 			return 0;
 		//if you only have 2 groups you don't need a .sharedmultiple file
-		}else if ((lookup->size() == 2) && (mult )) {
+		}else if ((numGroups == 2) && (mult )) {
 			mult = false;
 			util.mothurRemove(outAllFileName);
 			outputNames.pop_back();
 		}
 		
-		if (m->getControl_pressed()) { if (mult) {  util.mothurRemove(outAllFileName);  } util.mothurRemove(outputFileName); delete lookup; for(int i=0;i<sumCalculators.size();i++){  delete sumCalculators[i]; }   return 0; }
+		if (m->getControl_pressed()) { if (mult) {  util.mothurRemove(outAllFileName);  } util.mothurRemove(outputFileName); delete lookup; delete table; for(int i=0;i<sumCalculators.size();i++){  delete sumCalculators[i]; }   return 0; }
 		/******************************************************/
         if (subsample) { 
             if (subsampleSize == -1) { //user has not set size, set size = smallest samples size
@@ -352,12 +367,12 @@ int SummarySharedCommand::execute(){
             }
             
             if (lookup->size() < 2) { m->mothurOut("You have not provided enough valid groups.  I cannot run the command.\n"); m->setControl_pressed(true);  return 0; }
+            numGroups = lookup->size();
         }
 
 		
 		/******************************************************/
 		//comparison breakup to be used by different processes later
-		numGroups = lookup->size();
         numCalcs = sumCalculators.size();
         for(int i=0;i<sumCalculators.size();i++){  sumCalculatorsNames.push_back(sumCalculators[i]->getName()); }
         
@@ -368,15 +383,30 @@ int SummarySharedCommand::execute(){
 		}		
 		/******************************************************/
 		
-        vector<string> currentLabels = lookup->getOTUNames();
-        
-        while (lookup != NULL) {
-            
-            if (m->getControl_pressed()) { delete lookup; break; }
-            
-            process(lookup, outputFileName, outAllFileName, currentLabels); delete lookup;
+        if (useTables) {
+            while (table != NULL) {
+                if (!m->getControl_pressed()) { processTable(table, outputFileName); }
+                delete table;
+                
+                if (m->getControl_pressed()) { break; }
+                
+                table = util.getNextSparseShared(input, allLines, userLabels, processedLabels, lastLabel);
+            }
+        }else {
+            vector<string> currentLabels = lookup->getOTUNames();
             
-            lookup = util.getNextShared(input, allLines, userLabels, processedLabels, lastLabel);
+            //the labels are read in batches of up to processors labels, in parallel
+            while (lookups.size() != 0) {
+                
+                for (int i = 0; i < lookups.size(); i++) {
+                    if (!m->getControl_pressed()) { process(lookups[i], outputFileName, outAllFileName, currentLabels); }
+                    delete lookups[i];
+                }
+                
+                if (m->getControl_pressed()) { break; }
+                
+                lookups = util.getNextShared(input, allLines, userLabels, processedLabels, lastLabel, processors);
+            }
         }
 
 		for(int i=0;i<sumCalculators.size();i++){  delete sumCalculators[i]; }
@@ -398,6 +428,87 @@ int SummarySharedCommand::execute(){
 	}
 }
 /***********************************************************/
+//every calculator is the engine's, so the rows are printed straight from its values in the order the threads append them
+int SummarySharedCommand::processTable(SparseSharedTable* table, string sumFileName) {
+	try {
+        BetaDiversityEngine engine(*table, sumCalculatorsNames);
+        vector< vector<double> > engineValues; engine.getValues(processors, engineValues);
+        
+        vector<int> engineCalcs; vector<int> engineCols;
+        for (int i = 0; i < sumCalculatorsNames.size(); i++) {
+            engineCalcs.push_back(engine.find(sumCalculatorsNames[i]));
+            engineCols.push_back(engine.getCols(engineCalcs[i]));
+        }
+        
+        vector<string> groupNames = table->getGroups();
+        int numSamples = groupNames.size();
+        
+        ofstream outputFileHandle;
+        util.openOutputFileAppend(sumFileName, outputFileHandle);
+        
+        long long pair = 0;
+        for (int k = 0; k < numSamples; k++) {
+            
+            if (m->getControl_pressed()) { break; }
+            
+            for (int l = 0; l < k; l++) {
+                outputFileHandle << table->getLabel() << '\t';
+                //sort groups to be alphanumeric
+                if (groupNames[k] > groupNames[l])  { outputFileHandle << (groupNames[l] + '\t' + groupNames[k]) << '\t'; }
+                else                                { outputFileHandle << (groupNames[k] + '\t' + groupNames[l]) << '\t'; }
+                
+                for (int i = 0; i < engineCalcs.size(); i++) {
+                    outputFileHandle << '\t';
+                    BetaDiversityEngine::print(outputFileHandle, &engineValues[engineCalcs[i]][pair * engineCols[i]], engineCols[i]);
+                }
+                outputFileHandle << endl;
+                pair++;
+            }
+        }
+        outputFileHandle.close();
+        
+        if (createPhylip) {
+            for (int i = 0; i < engineCalcs.size(); i++) {
+                if (m->getControl_pressed()) { break; }
+                
+                vector< vector<double> > matrix; matrix.resize(numSamples);
+                for (int k = 0; k < numSamples; k++) {  matrix[k].resize(numSamples, 0.0);  }
+                
+                pair = 0;
+                for (int k = 0; k < numSamples; k++) {
+                    for (int l = 0; l < k; l++) {
+                        double dist = engineValues[engineCalcs[i]][pair * engineCols[i]];
+                        matrix[k][l] = dist; matrix[l][k] = dist;
+                        pair++;
+                    }
+                }
+                
+                map<string, string> variables;
+                variables["[filename]"] = outputdir + util.getRootName(util.getSimpleName(sharedfile));
+                variables["[calc]"] = sumCalculatorsNames[i];
+                variables["[distance]"] = table->getLabel();
+                variables["[outputtag]"] = output;
+                variables["[tag2]"] = "";
+                string distFileName = getOutputFileName("phylip",variables);
+                outputNames.push_back(distFileName); outputTypes["phylip"].push_back(distFileName);
+                ofstream outDist;
+                util.openOutputFile(distFileName, outDist);
+                outDist.setf(ios::fixed, ios::floatfield); outDist.setf(ios::showpoint);
+                
+                printSims(outDist, matrix, groupNames);
+                
+                outDist.close();
+            }
+        }
+        
+        return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SummarySharedCommand", "processTable");
+		exit(1);
+	}
+}
+/***********************************************************/
 int SummarySharedCommand::printSims(ostream& out, vector< vector<double> >& simMatrix, vector<string> theseGroups) {
 	try {
 		
@@ -529,6 +640,15 @@ void driverSummaryShared(summarySharedData* params) {
         
         params->calcDists.resize(sumCalculators.size());
         
+        //the calculators the engine computes are read out of engineValues, the rest are run pair by pair
+        vector<int> engineCalcs; vector<int> engineCols;
+        for(int i=0;i<sumCalculators.size();i++) {
+            int index = params->engine->find(sumCalculators[i]->getName());
+            engineCalcs.push_back(index);
+            if (index != -1) { engineCols.push_back(params->engine->getCols(index)); } else { engineCols.push_back(0); }
+        }
+        vector< vector<double> > engineValues; params->engine->getValues((int)params->start, (int)params->end, engineValues);
+        
         //loop through calculators and add to file all for all calcs that can do mutiple groups
         if (params->mult && params->main) {
             ofstream outAll;
@@ -564,6 +684,7 @@ void driverSummaryShared(summarySharedData* params) {
         if (!params->subsample) {  params->util.openOutputFile(params->sumFile, outputFileHandle); }
         
         vector<SharedRAbundVector*> subset;
+        long long pair = 0;
         for (int k = params->start; k < params->end; k++) { // pass cdd each set of groups to compare
             
             if (params->m->getControl_pressed()) { break; }
@@ -586,6 +707,17 @@ void driverSummaryShared(summarySharedData* params) {
                 
                 for(int i=0;i<sumCalculators.size();i++) {
                     
+                    if (engineCalcs[i] != -1) {
+                        double* values = &engineValues[engineCalcs[i]][pair * engineCols[i]];
+                        if (!params->subsample) {
+                            outputFileHandle << '\t';
+                            BetaDiversityEngine::print(outputFileHandle, values, engineCols[i]);
+                        }
+                        seqDist temp(l, k, values[0]);
+                        params->calcDists[i].push_back(temp);
+                        continue;
+                    }
+                    
                     //if this calc needs all groups to calculate the pair load all groups
                     if (sumCalculators[i]->getNeedsAll()) {
                         //load subset with rest of lookup for those calcs that need everyone to calc for a pair
@@ -606,6 +738,7 @@ void driverSummaryShared(summarySharedData* params) {
                     params->calcDists[i].push_back(temp);
                 }
                 if (!params->subsample) { outputFileHandle << endl; }
+                pair++;
             }
         }
         
@@ -622,6 +755,10 @@ void driverSummaryShared(summarySharedData* params) {
 /***********************************************************/
 int SummarySharedCommand::runCalcs(SharedRAbundVectors*& thisItersLookup, string sumFileName, string sumAllFile, vector< vector<seqDist>  >& calcDists) {
     try{
+        vector<SharedRAbundVector*> samples = thisItersLookup->getSharedRAbundVectors();
+        BetaDiversityEngine engine(samples, sumCalculatorsNames);
+        for (int i = 0; i < samples.size(); i++) { delete samples[i]; }
+        
         //create array of worker threads
         vector<std::thread*> workerThreads;
         vector<summarySharedData*> data;
@@ -630,7 +767,7 @@ int SummarySharedCommand::runCalcs(SharedRAbundVectors*& thisItersLookup, string
         for (int i = 0; i < processors-1; i++) {
             // Allocate memory for thread data.
             string extension = toString(i+1) + ".temp";
-            summarySharedData* dataBundle = new summarySharedData(sumFileName+extension, sumAllFile+extension, m, lines[i+1].start, lines[i+1].end, Estimators, thisItersLookup, false, mult, subsample);
+            summarySharedData* dataBundle = new summarySharedData(sumFileName+extension, sumAllFile+extension, m, lines[i+1].start, lines[i+1].end, Estimators, thisItersLookup, false, mult, subsample, &engine);
             
             data.push_back(dataBundle);
             workerThreads.push_back(new std::thread(driverSummaryShared, dataBundle));
@@ -639,7 +776,7 @@ int SummarySharedCommand::runCalcs(SharedRAbundVectors*& thisItersLookup, string
         //make copy of lookup so we don't get access violations
         //SharedRAbundVectors* newLookup = new SharedRAbundVectors(*thisItersLookup);
         string extension = toString(0) + ".temp";
-        summarySharedData* dataBundle = new summarySharedData(sumFileName+extension, sumAllFile+extension, m, lines[0].start, lines[0].end, Estimators, thisItersLookup, true, mult, subsample);
+        summarySharedData* dataBundle = new summarySharedData(sumFileName+extension, sumAllFile+extension, m, lines[0].start, lines[0].end, Estimators, thisItersLookup, true, mult, subsample, &engine);
         
         driverSummaryShared(dataBundle);
         for (int k = 0; k < calcDists.size(); k++) {
@@ -57,6 +57,7 @@
 #include "mempearson.h"
 #include "sharedjsd.h"
 #include "sharedrjsd.h"
+#include "betadiversityengine.hpp"
 
 class SummarySharedCommand : public Command {
 
@@ -88,6 +89,7 @@ private:
 	string format;
 	int numGroups, processors, subsampleSize, iters, numCalcs;
 	int process(SharedRAbundVectors*, string, string, vector<string>);
+    int processTable(SparseSharedTable*, string); //table, summary file
     int printSims(ostream&, vector< vector<double> >&, vector<string>);
     int runCalcs(SharedRAbundVectors*&, string, string, vector< vector<seqDist>  >&);
 
@@ -109,10 +111,11 @@ struct summarySharedData {
     int count;
     bool main, mult;
     bool subsample;
+    BetaDiversityEngine* engine; //shared by the threads, computes their rows of the calculators it can
     Utils util;
     
 	summarySharedData(){}
-	summarySharedData(string sf, string sfa, MothurOut* mout, unsigned long long st, unsigned long long en, vector<string> est, SharedRAbundVectors*& lu, bool mai, bool mu, bool sub) {
+	summarySharedData(string sf, string sfa, MothurOut* mout, unsigned long long st, unsigned long long en, vector<string> est, SharedRAbundVectors*& lu, bool mai, bool mu, bool sub, BetaDiversityEngine* eng) {
 		sumFile = sf;
         sumAllFile = sfa;
 		m = mout;
@@ -124,6 +127,7 @@ struct summarySharedData {
         main = mai;
         mult = mu;
         subsample = sub;
+        engine = eng;
 	}
     ~summarySharedData() { for (int j = 0; j < thisLookup.size(); j++) { delete thisLookup[j]; } thisLookup.clear(); }
 };
@@ -600,7 +600,7 @@ int UnifracUnweightedCommand::runRandomCalcs(Tree* thisTree, vector<double> user
 	try {
         vector<double> randomData; randomData.resize(numComp,0); //weighted score info for random trees. data[0] = weightedscore AB, data[1] = weightedscore AC...
         
-        Unweighted unweighted(includeRoot, Groups);
+        UnifracEngine engine(thisTree, Groups, includeRoot);
         
         vector< vector<string> > namesOfGroupCombos;
         numGroups = Groups.size();
@@ -624,8 +624,8 @@ int UnifracUnweightedCommand::runRandomCalcs(Tree* thisTree, vector<double> user
             
             for (int f = 0; f < numComp; f++) { util.mothurRandomShuffle(randomTreeNodes[f]);  } //randomize labels
             
-            //we need a different getValues because when we swap the labels we only want to swap those in each pairwise comparison
-            randomData = unweighted.getValues(thisTree, randomTreeNodes, processors, outputdir);
+            //when we swap the labels we only want to swap those in each pairwise comparison
+            randomData = engine.getUnweighted(randomTreeNodes, processors);
             
             if (m->getControl_pressed()) { return 0; }
 			
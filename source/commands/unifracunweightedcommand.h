@@ -12,6 +12,7 @@
 
 #include "command.hpp"
 #include "unweighted.h"
+#include "unifracengine.hpp"
 #include "counttable.h"
 
 #include "fileoutput.h"
@@ -545,6 +545,8 @@ int UnifracWeightedCommand::runRandomCalcs(Tree* thisTree, CountTable* ct, vecto
         for (int f = 0; f < numComp; f++) { randomTreeNodes.push_back(thisTree->getNodes(namesOfGroupCombos[f])); }
         vector<vector<int> > savedRandomTreeNodes = randomTreeNodes;
         
+        UnifracEngine engine(thisTree, Groups, includeRoot);
+        
         //get scores for random trees
         vector<vector<double> > rScores; rScores.resize(numComp);
         for (int i = 0; i < iters; i++) {
@@ -553,7 +555,7 @@ int UnifracWeightedCommand::runRandomCalcs(Tree* thisTree, CountTable* ct, vecto
             
             for (int f = 0; f < numComp; f++) {   util.mothurRandomShuffle(randomTreeNodes[f]);   }
             
-            vector<double> thisItersRScores = createProcesses(thisTree, ct, namesOfGroupCombos, randomTreeNodes);
+            vector<double> thisItersRScores = engine.getWeighted(randomTreeNodes, processors);
             
             for (int f = 0; f < numComp; f++) {   rScores[f].push_back(thisItersRScores[f]);  }
             
@@ -597,128 +599,6 @@ int UnifracWeightedCommand::runRandomCalcs(Tree* thisTree, CountTable* ct, vecto
 		exit(1);
 	}
 }
-/***********************************************************************/
-struct weightedRandomData {
-    bool includeRoot;
-    int count, numComps, start, num;
-    vector<string> Groups, Treenames;
-    vector<double> scores;
-    vector< vector<string> > namesOfGroupCombos;
-    vector<vector<int> > randomizedTreeNodes;
-    MothurOut* m;
-    Tree* t;
-    CountTable* ct;
-    Utils util;
-    
-    weightedRandomData(){}
-    weightedRandomData(int st, int en, vector< vector<string> > ngc, Tree* tree, CountTable* count, bool ir, vector<string> g, vector<vector<int> > randomTreeNodes) {
-        m = MothurOut::getInstance();
-        num = en;
-        start = st;
-        namesOfGroupCombos = ngc;
-        numComps = namesOfGroupCombos.size();
-        randomizedTreeNodes = randomTreeNodes;
-        t = tree;
-        ct = count;
-        includeRoot = ir;
-        Groups = g;
-        Treenames = t->getTreeNames();
-        count = 0;
-    }
-};
-/**************************************************************************************************/
-void driverWeightedRandom(weightedRandomData* params) {
-    try {
-        Weighted weighted(params->includeRoot, params->Groups);
-        
-        params->count = 0;
-        
-        Tree* randT = new Tree(params->ct, params->Treenames);
-
-        for (int h = params->start; h < (params->start+params->num); h++) {
-            
-            if (params->m->getControl_pressed()) { break; }
-            
-            string groupA = params->namesOfGroupCombos[h][0];
-            string groupB = params->namesOfGroupCombos[h][1];
-            vector<int> treeNodesFromTheseGroups = params->randomizedTreeNodes[h];
-                       
-            //copy T[i]'s info.
-            randT->getCopy(params->t);
-            
-            //create a random tree with same topology as T[i], but different labels
-            randT->assembleRandomUnifracTree(params->randomizedTreeNodes[h]);
-            
-            if (params->m->getControl_pressed()) { break; }
-            
-            //get wscore of random tree
-            EstOutput randomData = weighted.getValues(randT, groupA, groupB);
-            
-            if (params->m->getControl_pressed()) { break; }
-            
-            //save scores
-            params->scores.push_back(randomData[0]);
-        }
-        
-        delete randT;
-    }
-    catch(exception& e) {
-        params->m->errorOut(e, "UnifracWeightedCommand", "driver");
-        exit(1);
-    }
-}
-/**************************************************************************************************/
-vector<double> UnifracWeightedCommand::createProcesses(Tree* t, CountTable* ct, vector< vector<string> > namesOfGroupCombos, vector<vector<int> >& randomizedTreeNodes) {
-	try {
-        //breakdown work between processors
-        vector<linePair> lines;
-        int remainingPairs = namesOfGroupCombos.size();
-        if (remainingPairs < processors) { processors = remainingPairs; }
-        int startIndex = 0;
-        for (int remainingProcessors = processors; remainingProcessors > 0; remainingProcessors--) {
-            int numPairs = remainingPairs; //case for last processor
-            if (remainingProcessors != 1) { numPairs = ceil(remainingPairs / remainingProcessors); }
-            lines.push_back(linePair(startIndex, numPairs)); //startIndex, numPairs
-            startIndex = startIndex + numPairs;
-            remainingPairs = remainingPairs - numPairs;
-        }
-        //create array of worker threads
-        vector<std::thread*> workerThreads;
-        vector<weightedRandomData*> data;
-        
-        //Lauch worker threads
-        for (int i = 0; i < processors-1; i++) {
-            CountTable* copyCount = new CountTable();
-            copyCount->copy(ct);
-            vector<string> Treenames = t->getTreeNames();
-            Tree* copyTree = new Tree(copyCount, Treenames);
-            copyTree->getCopy(t);
-            
-            weightedRandomData* dataBundle = new weightedRandomData(lines[i+1].start, lines[i+1].end, namesOfGroupCombos, copyTree, copyCount, includeRoot, Groups, randomizedTreeNodes);
-            data.push_back(dataBundle);
-            workerThreads.push_back(new std::thread(driverWeightedRandom, dataBundle));
-        }
-        
-        weightedRandomData* dataBundle = new weightedRandomData(lines[0].start, lines[0].end, namesOfGroupCombos, t, ct, includeRoot, Groups, randomizedTreeNodes);
-        driverWeightedRandom(dataBundle);
-        vector<double> scores = dataBundle->scores;
-        
-        
-        for (int i = 0; i < processors-1; i++) {
-            workerThreads[i]->join();
-            
-            scores.insert(scores.end(), data[i]->scores.begin(), data[i]->scores.end());
-            
-            delete data[i]->t; delete data[i]->ct; delete data[i]; delete workerThreads[i];
-        }
-        delete dataBundle;
-        return scores;
-	}
-	catch(exception& e) {
-		m->errorOut(e, "UnifracWeightedCommand", "createProcesses");
-		exit(1);
-	}
-}
 /***********************************************************/
 void UnifracWeightedCommand::printWSummaryFile(int treeIndex, vector<double> utreeScores, vector<double> WScoreSig, vector<string> groupComb) {
 	try {
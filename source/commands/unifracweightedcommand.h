@@ -12,6 +12,7 @@
 
 #include "command.hpp"
 #include "weighted.h"
+#include "unifracengine.hpp"
 #include "counttable.h"
 
 #include "fileoutput.h"
@@ -47,7 +48,6 @@ class UnifracWeightedCommand : public Command {
         //random comparison functions
 		int findIndex(float, int, vector< vector<double> >&);
 		void calculateFreqsCumuls(set<double>&, vector< vector<double> > rScores, vector< map<double, double> >&, vector< map<double, double> >&);
-		vector<double> createProcesses(Tree*, CountTable*, vector< vector<string> >, vector<vector<int> >&);
         int runRandomCalcs(Tree*, CountTable*, vector<double>, int, vector<double>&, vector<string>);
     
         vector<Tree*> buildTrees(vector< vector<double> >&, int, CountTable&);
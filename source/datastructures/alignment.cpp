@@ -77,31 +77,31 @@ void Alignment::traceBack(bool createBaseMap){			//	This traceback routine is us
 		//	seqAstart = 1;
 		//	seqAend = column;
 		
-		AlignmentCell currentCell = alignment[row][column];	//	Start the traceback from the bottom-right corner of the
-		//	matrix
+		char prevCell = getPrevCell(row, column);	//	Start the traceback from the bottom-right corner of the
+		//	matrix. The alignment is built backwards and reversed at the end
 		
-		if(currentCell.prevCell == 'x'){	seqAaln = seqBaln = "NOALIGNMENT";		}//If there's an 'x' in the bottom-
+		if(prevCell == 'x'){	seqAaln = seqBaln = "NOALIGNMENT";		}//If there's an 'x' in the bottom-
 		else{	//	right corner bail out because it means nothing got aligned
             int count = 0;
-			while(currentCell.prevCell != 'x'){				//	while the previous cell isn't an 'x', keep going...
+			while(prevCell != 'x'){				//	while the previous cell isn't an 'x', keep going...
 				
-				if(currentCell.prevCell == 'u'){			//	if the pointer to the previous cell is 'u', go up in the
-					seqAaln = '-' + seqAaln;				//	matrix.  this indicates that we need to insert a gap in
-					seqBaln = seqB[row] + seqBaln;			//	seqA and a base in seqB
+				if(prevCell == 'u'){			//	if the pointer to the previous cell is 'u', go up in the
+					seqAaln += '-';				//	matrix.  this indicates that we need to insert a gap in
+					seqBaln += seqB[row];			//	seqA and a base in seqB
                     if (createBaseMap) { BBaseMap[row] = count; }
 					//currentCell = alignment[--row][column];
                     --row;
 				}
-				else if(currentCell.prevCell == 'l'){		//	if the pointer to the previous cell is 'l', go to the left
-					seqBaln = '-' + seqBaln;				//	in the matrix.  this indicates that we need to insert a gap
-					seqAaln = seqA[column] + seqAaln;		//	in seqB and a base in seqA
+				else if(prevCell == 'l'){		//	if the pointer to the previous cell is 'l', go to the left
+					seqBaln += '-';				//	in the matrix.  this indicates that we need to insert a gap
+					seqAaln += seqA[column];		//	in seqB and a base in seqA
                     if (createBaseMap) { ABaseMap[column] = count; }
 					//currentCell = alignment[row][--column];
                     --column;
 				}
 				else{
-					seqAaln = seqA[column] + seqAaln;		//	otherwise we need to go diagonally up and to the left,
-					seqBaln = seqB[row] + seqBaln;			//	here we add a base to both alignments
+					seqAaln += seqA[column];		//	otherwise we need to go diagonally up and to the left,
+					seqBaln += seqB[row];			//	here we add a base to both alignments
                     if (createBaseMap) {
                         BBaseMap[row] = count;
                         ABaseMap[column] = count;
@@ -109,10 +109,12 @@ void Alignment::traceBack(bool createBaseMap){			//	This traceback routine is us
 					//currentCell = alignment[--row][--column];
                     --row; --column;
 				}
-                if ((row >= 0) && (column >= 0)) { currentCell = alignment[row][column]; }
+                if ((row >= 0) && (column >= 0)) { prevCell = getPrevCell(row, column); }
                 else { break; }
                 count++;
 			}
+            reverse(seqAaln.begin(), seqAaln.end());
+            reverse(seqBaln.begin(), seqBaln.end());
 		}
 		
        
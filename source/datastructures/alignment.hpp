@@ -44,6 +44,7 @@ public:
 
 protected:
 	void traceBack(bool createBaseMap);
+	virtual char getPrevCell(int row, int column) { return alignment[row][column].prevCell; } //for aligners that don't keep the AlignmentCell matrix
 	string seqA, seqAaln;
 	string seqB, seqBaln;
 	int seqAstart, seqAend;
@@ -19,42 +19,52 @@ AlignmentDB::AlignmentDB(string fastaFileName, string s, int kmerSize, float gap
         current = CurrentFile::getInstance();
 		longest = 0;
 		method = s;
+		templateIndex = NULL;
 		bool needToGenerate = true;
 		threadID = tid;
 		Utils util;
         
         long start = time(NULL);
         m->mothurOut("\nReading in the " + fastaFileName + " template sequences...\t");	cout.flush();
-        //bool aligned = false;
-        int tempLength = 0;
         
-        ifstream fastaFile;
-        util.openInputFile(fastaFileName, fastaFile);
-        
-        while (!fastaFile.eof()) {
-            Sequence temp(fastaFile);  util.gobble(fastaFile);
+        //the template shortcut file lets us map the templates instead of parsing the fasta file
+        string templateIndexName = fastaFileName + ".index";
+        if (readTemplateIndex(templateIndexName, fastaFileName)) { numSeqs = templateNames.numStrings; }
+        else {
+            //bool aligned = false;
+            int tempLength = 0;
             
-            if (m->getControl_pressed()) {  templateSequences.clear(); break;  }
+            ifstream fastaFile;
+            util.openInputFile(fastaFileName, fastaFile);
             
-            if (temp.getName() != "") {
-                templateSequences.push_back(temp);
+            while (!fastaFile.eof()) {
+                Sequence temp(fastaFile);  util.gobble(fastaFile);
                 
-                //save longest base
-                if (temp.getUnaligned().length() >= longest)  { longest = ((int)temp.getUnaligned().length()+1); }
+                if (m->getControl_pressed()) {  templateSequences.clear(); break;  }
                 
-                if (tempLength != 0) {
-                    if (tempLength != temp.getAligned().length()) { m->mothurOut("[ERROR]: template is not aligned, aborting.\n"); m->setControl_pressed(true); }
-                }else { tempLength = (int)temp.getAligned().length(); }
+                if (temp.getName() != "") {
+                    templateSequences.push_back(temp);
+                    
+                    //save longest base
+                    if (temp.getUnaligned().length() >= longest)  { longest = ((int)temp.getUnaligned().length()+1); }
+                    
+                    if (tempLength != 0) {
+                        if (tempLength != temp.getAligned().length()) { m->mothurOut("[ERROR]: template is not aligned, aborting.\n"); m->setControl_pressed(true); }
+                    }else { tempLength = (int)temp.getAligned().length(); }
+                }
             }
+            fastaFile.close();
+            
+            numSeqs = (int)templateSequences.size();
+            
+            if (writeShortcut && !m->getControl_pressed()) { writeTemplateIndex(templateIndexName); }
         }
-        fastaFile.close();
         
-        numSeqs = (int)templateSequences.size();
         //all of this is elsewhere already!
         
         m->mothurOut("DONE.\n");
         cout.flush();
-        m->mothurOut("It took " + toString(time(NULL) - start) + " to read  " + toString(templateSequences.size()) + " sequences.\n");   
+        m->mothurOut("It took " + toString(time(NULL) - start) + " to read  " + toString(numSeqs) + " sequences.\n");   
 
 		
 		//in case you delete the seqs and then ask for them
@@ -96,8 +106,8 @@ AlignmentDB::AlignmentDB(string fastaFileName, string s, int kmerSize, float gap
 		if (!m->getControl_pressed()) {
 			if (needToGenerate) {
 				//add sequences to search 
-				for (int i = 0; i < templateSequences.size(); i++) {
-					search->addSequence(templateSequences[i]);
+				for (int i = 0; i < numSeqs; i++) {
+					search->addSequence(getTemplate(i));
 					
 					if (m->getControl_pressed()) {  templateSequences.clear(); break;  }
 				}
@@ -125,6 +135,7 @@ AlignmentDB::AlignmentDB(string s){
 	try {											
 		m = MothurOut::getInstance();
 		method = s;
+		templateIndex = NULL;
 		
 		if(method == "suffix")		{	search = new SuffixDB();	}
 		else if(method == "blast")	{	search = new BlastDB("", 0);		}
@@ -144,7 +155,7 @@ AlignmentDB::AlignmentDB(string s){
 	}
 }
 /**************************************************************************************************/
-AlignmentDB::~AlignmentDB() {  delete search;	}
+AlignmentDB::~AlignmentDB() {  delete search; if (templateIndex != NULL) { delete templateIndex; }	}
 /**************************************************************************************************/
 Sequence AlignmentDB::findClosestSequence(Sequence* seq, float& searchScore) const {
 	try{
@@ -152,7 +163,7 @@ Sequence AlignmentDB::findClosestSequence(Sequence* seq, float& searchScore) con
         vector<float> scores;
 		vector<int> spot = search->findClosestSequences(seq, 1, scores);
 	
-        if (spot.size() != 0)	{	searchScore = scores[0]; return templateSequences[spot[0]];	}
+        if (spot.size() != 0)	{	searchScore = scores[0]; return getTemplate(spot[0]);	}
         else					{ 	searchScore = 0; return emptySequence;                      }
 		
 	}
@@ -162,9 +173,80 @@ Sequence AlignmentDB::findClosestSequence(Sequence* seq, float& searchScore) con
 	}
 }
 /**************************************************************************************************/
-
-
-
-
-
-
+/**************************************************************************************************/
+Sequence AlignmentDB::getTemplate(int i) const {
+	try {
+		if (templateIndex != NULL) { return Sequence(templateNames.get(i), templateAligned.get(i)); }
+		return templateSequences[i];
+	}
+	catch(exception& e) {
+		m->errorOut(e, "AlignmentDB", "getTemplate");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//maps the template shortcut file if it was made by this version of mothur from the current fasta file
+bool AlignmentDB::readTemplateIndex(string indexFileName, string fastaFileName) {
+	try {
+		Utils util;
+		
+		if (!ReferenceIndex::isIndex(indexFileName)) { return false; }
+		if (util.getTimeStamp(indexFileName) < util.getTimeStamp(fastaFileName)) { return false; }
+		
+		ReferenceIndex* index = new ReferenceIndex(indexFileName);
+		
+		long long numInfo = 0;
+		const uint64_t* info = index->getArray<uint64_t>("templates.info", numInfo);
+		
+		bool good = (index->isOpen() && util.checkReleaseVersion("#" + index->getVersion(), current->getVersion()));
+		if (good) { good = ((info != NULL) && (numInfo == 2) && index->getStrings("templates.names", templateNames) && index->getStrings("templates.aligned", templateAligned)); }
+		if (good) { good = ((templateNames.numStrings == info[0]) && (templateAligned.numStrings == info[0])); }
+		
+		if (!good) { delete index; return false; }
+		
+		templateIndex = index;
+		longest = info[1];
+		
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "AlignmentDB", "readTemplateIndex");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void AlignmentDB::writeTemplateIndex(string indexFileName) {
+	try {
+		ReferenceIndexWriter indexFile(indexFileName, current->getVersion());
+		
+		vector<uint64_t> info; info.push_back(templateSequences.size()); info.push_back(longest);
+		indexFile.addArray("templates.info", info);
+		
+		vector<uint64_t> nameOffsets(1, 0), alignedOffsets(1, 0);
+		
+		indexFile.startSection("templates.names");
+		for (int i = 0; i < templateSequences.size(); i++) {
+			string name = templateSequences[i].getName();
+			indexFile.append(name.c_str(), name.length());
+			nameOffsets.push_back(nameOffsets.back() + name.length());
+		}
+		indexFile.endSection();
+		indexFile.addArray("templates.names.offsets", nameOffsets);
+		
+		indexFile.startSection("templates.aligned");
+		for (int i = 0; i < templateSequences.size(); i++) {
+			string aligned = templateSequences[i].getAligned();
+			indexFile.append(aligned.c_str(), aligned.length());
+			alignedOffsets.push_back(alignedOffsets.back() + aligned.length());
+		}
+		indexFile.endSection();
+		indexFile.addArray("templates.aligned.offsets", alignedOffsets);
+		
+		indexFile.close();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "AlignmentDB", "writeTemplateIndex");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
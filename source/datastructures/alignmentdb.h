@@ -15,6 +15,7 @@
 #include "database.hpp"
 #include "utils.hpp"
 #include "currentfile.h"
+#include "referenceindex.hpp"
 
 /**************************************************************************************************/
 
@@ -35,10 +36,16 @@ private:
 	
 	Database* search;
 	vector<Sequence> templateSequences;
+	ReferenceIndex* templateIndex;          //the mapped template shortcut file, used in place of templateSequences
+	MappedStrings templateNames, templateAligned;
 	Sequence emptySequence;
 	MothurOut* m;
     CurrentFile* current;
     
+	Sequence getTemplate(int) const;
+	bool readTemplateIndex(string, string);
+	void writeTemplateIndex(string);
+
 };
 
 /**************************************************************************************************/
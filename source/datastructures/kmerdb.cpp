@@ -19,6 +19,9 @@
  *	on average a kmer is found in ~100 other sequences with a database of ~5000 sequences.  If this is the case then the
  *	time would be on the order of O(0.1LN) -> fast.
  *
+ *	The counts for a search live in a per thread scratch vector that is reused, and the best matches are picked
+ *	with a heap instead of sorting every template sequence.
+ *
 
  */
 
@@ -27,6 +30,11 @@
 #include "database.hpp"
 #include "kmerdb.hpp"
 
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    #define USE_X86_KERNELS
+    #include <immintrin.h>
+#endif
+
 /**************************************************************************************************/
 
 KmerDB::KmerDB(string fastaFileName, int kSize) : Database(), kmerSize(kSize) {
@@ -35,7 +43,8 @@ KmerDB::KmerDB(string fastaFileName, int kSize) : Database(), kmerSize(kSize) {
 		kmerDBName = fastaFileName.substr(0,fastaFileName.find_last_of(".")+1) + char('0'+ kmerSize) + "mer";
 		
 		int power4s[14] = { 1, 4, 16, 64, 256, 1024, 4096, 16384, 65536, 262144, 1048576, 4194304, 16777216, 67108864 };
-		count = 0;
+		count = 0; packed = false; numIndexed = 0;
+		index = NULL; startsData = NULL; postingsData = NULL;
 		
 		maxKmer = power4s[kmerSize];
 		kmerLocations.resize(maxKmer+1);
@@ -51,77 +60,198 @@ KmerDB::KmerDB(string fastaFileName, int kSize) : Database(), kmerSize(kSize) {
 
 }
 /**************************************************************************************************/
-KmerDB::KmerDB() : Database() {
+KmerDB::KmerDB() : Database(), kmerSize(0), maxKmer(0), count(0), packed(false), numIndexed(0), index(NULL), startsData(NULL), postingsData(NULL) {
     CurrentFile* current; current = CurrentFile::getInstance();
     version = current->getVersion();
 }
 /**************************************************************************************************/
 
-KmerDB::~KmerDB(){}
+KmerDB::~KmerDB(){ if (index != NULL) { delete index; } }
+
+/**************************************************************************************************/
+//scratch space for the searches, one per thread so the database can be shared. counts is all zeros between searches.
+struct KmerSearchScratch {
+	vector<int> counts;         //number of the query's kmers each template sequence has
+	vector<int> queryKmers;     //the distinct kmers in the query
+};
+static KmerSearchScratch& getSearchScratch() {
+	static thread_local KmerSearchScratch scratch;
+	return scratch;
+}
+/**************************************************************************************************/
+//ranks the most shared kmers first, ties go to the lower sequence index
+inline bool compareRankedMatches (const seqMatch& member, const seqMatch& member2){
+	if (member.match != member2.match) { return (member.match > member2.match); }
+	return (member.seq < member2.seq);
+}
+/**************************************************************************************************/
+//matches is a heap with the worst of the num best matches on top
+inline void offerMatch(vector<seqMatch>& matches, int num, int seq, int match) {
+	if (matches.size() < num) {
+		matches.push_back(seqMatch(seq, match));
+		push_heap(matches.begin(), matches.end(), compareRankedMatches);
+	}else if (match > matches.front().match) { //seqs come in increasing order, so a tie never beats the top of the heap
+		pop_heap(matches.begin(), matches.end(), compareRankedMatches);
+		matches.back() = seqMatch(seq, match);
+		push_heap(matches.begin(), matches.end(), compareRankedMatches);
+	}
+}
+/**************************************************************************************************/
+//the worst match a new sequence has to beat to get into the heap, counts are never negative
+inline int getMatchThreshold(const vector<seqMatch>& matches, int num) {
+	if (matches.size() < num) { return -1; }
+	return matches.front().match;
+}
+/**************************************************************************************************/
+static int findMaxCountScalar(const int* counts, int n) {
+	int best = -1;
+	for (int i = 0; i < n; i++) { if (counts[i] > best) { best = counts[i]; } }
+	return best;
+}
+/**************************************************************************************************/
+static void selectTopMatchesScalar(const int* counts, int n, int num, vector<seqMatch>& matches) {
+	int threshold = -1;
+	for (int i = 0; i < n; i++) {
+		if (counts[i] > threshold) { offerMatch(matches, num, i, counts[i]); threshold = getMatchThreshold(matches, num); }
+	}
+}
+/**************************************************************************************************/
+#ifdef USE_X86_KERNELS
 
+__attribute__((target("avx2")))
+static int findMaxCountAVX2(const int* counts, int n) {
+	int i = 0;
+	int best = -1;
+	
+	if (n >= 8) {
+		__m256i bestVector = _mm256_set1_epi32(-1);
+		for (; i + 8 <= n; i += 8) { bestVector = _mm256_max_epi32(bestVector, _mm256_loadu_si256((const __m256i*)(counts+i))); }
+		
+		int lanes[8]; _mm256_storeu_si256((__m256i*)lanes, bestVector);
+		for (int j = 0; j < 8; j++) { if (lanes[j] > best) { best = lanes[j]; } }
+	}
+	for (; i < n; i++) { if (counts[i] > best) { best = counts[i]; } }
+	
+	return best;
+}
+/**************************************************************************************************/
+//compares 8 counts at a time to the heap threshold, only the ones that beat it are offered
+__attribute__((target("avx2")))
+static void selectTopMatchesAVX2(const int* counts, int n, int num, vector<seqMatch>& matches) {
+	int i = 0;
+	int threshold = -1;
+	
+	for (; i + 8 <= n; i += 8) {
+		__m256i above = _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i*)(counts+i)), _mm256_set1_epi32(threshold));
+		int mask = _mm256_movemask_ps(_mm256_castsi256_ps(above));
+		
+		while (mask != 0) {
+			int j = __builtin_ctz(mask); mask &= mask - 1;
+			if (counts[i+j] > threshold) { offerMatch(matches, num, i+j, counts[i+j]); threshold = getMatchThreshold(matches, num); }
+		}
+	}
+	for (; i < n; i++) {
+		if (counts[i] > threshold) { offerMatch(matches, num, i, counts[i]); threshold = getMatchThreshold(matches, num); }
+	}
+}
+#endif
+/**************************************************************************************************/
+static bool useAVX2Counts() {
+#ifdef USE_X86_KERNELS
+	static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+	return hasAVX2;
+#else
+	return false;
+#endif
+}
+/**************************************************************************************************/
+//adds one to counts[seq] for each distinct kmer of the query that seq has. Returns the query's kmers in queryKmers.
+void KmerDB::countSharedKmers(const string& unaligned, int numKmers, vector<int>& queryKmers) const {
+	try {
+		KmerSearchScratch& scratch = getSearchScratch();
+		Kmer kmer(kmerSize);
+		
+		queryKmers.clear();
+		for(int i=0;i<numKmers;i++){ queryKmers.push_back(kmer.getKmerNumber(unaligned, i)); }	//	go through the query sequence and get a kmer number
+		sort(queryKmers.begin(), queryKmers.end());
+		queryKmers.erase(unique(queryKmers.begin(), queryKmers.end()), queryKmers.end());		//	each kmer is only counted once
+		
+		int* counts = scratch.counts.data();
+		for (int i = 0; i < queryKmers.size(); i++) {
+			const uint32_t* seq = postingsData + startsData[queryKmers[i]];
+			const uint32_t* end = postingsData + startsData[queryKmers[i]+1];
+			for (; seq != end; seq++) { counts[*seq]++; }		//increase the count for each sequence that also has that kmer
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "countSharedKmers");
+		exit(1);
+	}
+}
 /**************************************************************************************************/
 
 vector<int> KmerDB::findClosestSequences(Sequence* candidateSeq, int num, vector<float>& Scores) const{
 	try {
 		if (num > numSeqs) { m->mothurOut("[WARNING]: you requested " + toString(num) + " closest sequences, but the template only contains " + toString(numSeqs) + ", adjusting.\n");  num = numSeqs; }
+		if (!packed) { m->mothurOut("[ERROR]: the kmer database has not been packed, please set the number of sequences before searching.\n"); m->setControl_pressed(true); return nullIntVector; }
 		
 		vector<int> topMatches;
-		Kmer kmer(kmerSize);
 		float searchScore = 0;
 		Scores.clear();
 		
-		vector<int> matches(numSeqs, 0);						//	a record of the sequences with shared kmers
-		vector<bool> timesKmerFound(kmerLocations.size()+1, false);	//	a record of the kmers that we have already found
+		KmerSearchScratch& scratch = getSearchScratch();
+		int numCounts = max(numSeqs, numIndexed);
+		if (scratch.counts.size() < numCounts) { scratch.counts.resize(numCounts, 0); }
 		
+		string unaligned = candidateSeq->getUnaligned();
 		int numKmers = candidateSeq->getNumBases() - kmerSize + 1;	
-	
-		for(int i=0;i<numKmers;i++){
-			int kmerNumber = kmer.getKmerNumber(candidateSeq->getUnaligned(), i);		//	go through the query sequence and get a kmer number
-			if(!timesKmerFound[kmerNumber]){				//	if we haven't seen it before...
-				for(int j=0;j<kmerLocations[kmerNumber].size();j++){//increase the count for each sequence that also has
-					matches[kmerLocations[kmerNumber][j]]++;	//	that kmer
-				}
-			}
-			timesKmerFound[kmerNumber] = true;						//	ok, we've seen the kmer now
-		}
+		
+		countSharedKmers(unaligned, numKmers, scratch.queryKmers);
+		
+		const int* matches = scratch.counts.data();
+		bool useAVX2 = useAVX2Counts();
 		
 		if (num != 1) {
-			vector<seqMatch> seqMatches; seqMatches.resize(numSeqs);
-			for(int i=0;i<numSeqs;i++){		
-				seqMatches[i].seq = i;
-				seqMatches[i].match = matches[i];
-			}
+			vector<seqMatch> seqMatches; seqMatches.reserve(num);
+			
+#ifdef USE_X86_KERNELS
+			if (useAVX2) { selectTopMatchesAVX2(matches, numSeqs, num, seqMatches); }
+			else
+#endif
+			{ selectTopMatchesScalar(matches, numSeqs, num, seqMatches); }
 			
 			//sorts putting largest matches first
-			sort(seqMatches.begin(), seqMatches.end(), compareSeqMatches);
+			sort_heap(seqMatches.begin(), seqMatches.end(), compareRankedMatches);
 			
-			searchScore = seqMatches[0].match;
+			if (seqMatches.size() != 0) { searchScore = seqMatches[0].match; }
 			searchScore = 100 * searchScore / (float) numKmers;		//	return the Sequence object corresponding to the db
             Scores.push_back(searchScore);
             
 			//save top matches
-			for (int i = 0; i < num; i++) {
+			for (int i = 0; i < seqMatches.size(); i++) {
 				topMatches.push_back(seqMatches[i].seq);
 				float thisScore = 100 * seqMatches[i].match / (float) numKmers;
 				Scores.push_back(thisScore);
 			}
 		}else{
-			int bestIndex = 0;
 			int bestMatch = -1;
-            
-			for(int i=0;i<numSeqs;i++){	
-				
-				if (matches[i] > bestMatch) {
-					bestIndex = i;
-					bestMatch = matches[i];
-				}
-			}
+#ifdef USE_X86_KERNELS
+			if (useAVX2) { bestMatch = findMaxCountAVX2(matches, numSeqs); }
+			else
+#endif
+			{ bestMatch = findMaxCountScalar(matches, numSeqs); }
+			
+			int bestIndex = 0;
+			for(int i=0;i<numSeqs;i++){ if (matches[i] == bestMatch) { bestIndex = i; break; } }	//	first sequence with the most shared kmers
             
 			searchScore = bestMatch;
 			searchScore = 100 * searchScore / (float) numKmers;		//	return the Sequence object corresponding to the db
 			topMatches.push_back(bestIndex);
 			Scores.push_back(searchScore);
 		}
+		
+		fill(scratch.counts.begin(), scratch.counts.begin()+numCounts, 0);	//	ready for the next search
+		
 		return topMatches;		
 	}
 	catch(exception& e) {
@@ -129,26 +259,77 @@ vector<int> KmerDB::findClosestSequences(Sequence* candidateSeq, int num, vector
 		exit(1);
 	}	
 }
-
 /**************************************************************************************************/
-//print shortcut file
-void KmerDB::generateDB(){
+//moves kmerLocations into the contiguous postings
+void KmerDB::pack(){
 	try {
+		if (packed) { return; }
+		
+		if (kmerLocations.size() < maxKmer+1) { kmerLocations.resize(maxKmer+1); }
 		
-		ofstream kmerFile;										//	once we have the kmerLocations folder print it out
-		util.openOutputFile(kmerDBName, kmerFile);					//	to a file
+		long long total = 0;
+		for (int i = 0; i < kmerLocations.size(); i++) { total += kmerLocations[i].size(); }
 		
-		//output version
-		kmerFile << "#" << version << endl;
+		postingStarts.assign(maxKmer+2, 0);
+		postings.clear(); postings.reserve(total);
+		numIndexed = 0;
 		
-		for(int i=0;i<maxKmer;i++){								//	step through all of the possible kmer numbers
-			kmerFile << i << ' ' << kmerLocations[i].size();	//	print the kmer number and the number of sequences with
-			for(int j=0;j<kmerLocations[i].size();j++){			//	that kmer.  then print out the indices of the sequences
-				kmerFile << ' ' << kmerLocations[i][j];			//	with that kmer.
+		for (int i = 0; i <= maxKmer; i++) {
+			postingStarts[i] = postings.size();
+			for (int j = 0; j < kmerLocations[i].size(); j++) {
+				postings.push_back(kmerLocations[i][j]);
+				if (kmerLocations[i][j] >= numIndexed) { numIndexed = kmerLocations[i][j] + 1; }
 			}
-			kmerFile << endl;
+			vector<int>().swap(kmerLocations[i]);
+		}
+		postingStarts[maxKmer+1] = postings.size();
+		vector<vector<int> >().swap(kmerLocations);
+		
+		startsData = postingStarts.data(); postingsData = postings.data();
+		packed = true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "pack");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//sequences added after packing go back into kmerLocations
+void KmerDB::unpack(){
+	try {
+		if (!packed) { return; }
+		
+		kmerLocations.assign(maxKmer+1, vector<int>());
+		for (int i = 0; i <= maxKmer; i++) {
+			kmerLocations[i].assign(postingsData+startsData[i], postingsData+startsData[i+1]);
 		}
-		kmerFile.close();
+		vector<uint32_t>().swap(postings);
+		vector<uint64_t>().swap(postingStarts);
+		if (index != NULL) { delete index; index = NULL; }
+		startsData = NULL; postingsData = NULL;
+		
+		packed = false;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "unpack");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//print shortcut file
+void KmerDB::generateDB(){
+	try {
+		
+		pack();
+		
+		ReferenceIndexWriter indexFile(kmerDBName, version);	//	once we have the postings packed write them out
+		
+		vector<uint64_t> info; info.push_back(kmerSize); info.push_back(numIndexed);
+		indexFile.addArray("kmerdb.info", info);
+		indexFile.addSection("kmerdb.starts", startsData, (maxKmer+2) * sizeof(uint64_t));
+		indexFile.addSection("kmerdb.postings", postingsData, startsData[maxKmer+1] * sizeof(uint32_t));
+		
+		indexFile.close();
 		
 	}
 	catch(exception& e) {
@@ -160,6 +341,8 @@ void KmerDB::generateDB(){
 /**************************************************************************************************/
 void KmerDB::addSequence(Sequence seq) {
 	try {
+		unpack();
+		
 		Kmer kmer(kmerSize);
 		
 		string unaligned = seq.getUnaligned();	//	...take the unaligned sequence...
@@ -202,10 +385,46 @@ void KmerDB::readSeqs(ifstream& fastaFile){
     }
 }
 /**************************************************************************************************/
+//maps the shortcut file written by generateDB
+bool KmerDB::readIndex(){
+	try {
+		ReferenceIndex* kmerIndex = new ReferenceIndex(kmerDBName);
+		
+		long long numInfo, numStarts, numPostings;
+		const uint64_t* info = kmerIndex->getArray<uint64_t>("kmerdb.info", numInfo);
+		const uint64_t* starts = kmerIndex->getArray<uint64_t>("kmerdb.starts", numStarts);
+		const uint32_t* kmerPostings = kmerIndex->getArray<uint32_t>("kmerdb.postings", numPostings);
+		
+		bool good = ((info != NULL) && (starts != NULL) && (kmerPostings != NULL) && (numInfo == 2));
+		if (good) { good = ((info[0] == kmerSize) && (numStarts == (maxKmer+2)) && (starts[maxKmer+1] == numPostings)); }
+		
+		if (!good) { m->mothurOut("[ERROR]: " + kmerDBName + " is not a valid kmer shortcut file, please remove it.\n"); delete kmerIndex; m->setControl_pressed(true); return false; }
+		
+		vector<vector<int> >().swap(kmerLocations);
+		vector<uint64_t>().swap(postingStarts);
+		vector<uint32_t>().swap(postings);
+		if (index != NULL) { delete index; }
+		
+		index = kmerIndex;
+		startsData = starts; postingsData = kmerPostings;
+		numIndexed = info[1];
+		packed = true;
+		
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "readIndex");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
 //reads shortcut file
 void KmerDB::readDB(ifstream& kmerDBFile){
 	try {
-					
+		
+		if (ReferenceIndex::isIndex(kmerDBName)) { kmerDBFile.close(); readIndex(); return; }
+		
+		//text shortcut files from older versions
 		kmerDBFile.seekg(0);									//	start at the beginning of the file
 		
 		//read version
@@ -213,18 +432,31 @@ void KmerDB::readDB(ifstream& kmerDBFile){
 		
 		string seqName;
 		int seqNumber;
+		
+		//read straight into the postings
+		vector<vector<int> >().swap(kmerLocations);
+		postingStarts.assign(maxKmer+2, 0);
+		postings.clear();
+		numIndexed = 0;
 
 		for(int i=0;i<maxKmer;i++){
 			int numValues = 0;	
 			kmerDBFile >> seqName >> numValues;
 			
+			postingStarts[i] = postings.size();
 			for(int j=0;j<numValues;j++){						//	for each kmer number get the...
 				kmerDBFile >> seqNumber;						//		1. number of sequences with the kmer number
-				kmerLocations[i].push_back(seqNumber);			//		2. sequence indices
+				postings.push_back(seqNumber);					//		2. sequence indices
+				if (seqNumber >= numIndexed) { numIndexed = seqNumber + 1; }
 			}
 		}
+		postingStarts[maxKmer] = postings.size();
+		postingStarts[maxKmer+1] = postings.size();
 		kmerDBFile.close();
 		
+		startsData = postingStarts.data(); postingsData = postings.data();
+		packed = true;
+		
 	}
 	catch(exception& e) {
 		m->errorOut(e, "KmerDB", "readDB");
@@ -237,7 +469,7 @@ int KmerDB::getCount(int kmer) {
 	try {
 		if (kmer < 0) { return 0; }  //if user gives negative number
 		else if (kmer > maxKmer) {	return 0;	}  //or a kmer that is bigger than maxkmer
-		else {	return kmerLocations[kmer].size();	}  // kmer is in vector range
+		else {	pack(); return (startsData[kmer+1] - startsData[kmer]);	}  // kmer is in vector range
 	}
 	catch(exception& e) {
 		m->errorOut(e, "KmerDB", "getCount");
@@ -266,7 +498,7 @@ vector<int> KmerDB::getSequencesWithKmer(int kmer) {
 	
 		if (kmer < 0) { }  //if user gives negative number
 		else if (kmer > maxKmer) {	}  //or a kmer that is bigger than maxkmer
-		else {	seqs = kmerLocations[kmer];	}
+		else {	pack(); seqs.assign(postingsData+startsData[kmer], postingsData+startsData[kmer+1]);	}
 		
 		return seqs;
 	}
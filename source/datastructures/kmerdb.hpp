@@ -16,11 +16,18 @@
  *	Construction of an object of this type will first look for an appropriately named database file and if it is found
  *	then will read in the database file (readKmerDB), otherwise it will generate one and store the data in memory
  *	(generateKmerDB)
+ *
+ *	Once the database is filled (setNumSeqs or readDB) kmerLocations is packed into one contiguous postings array,
+ *	postings[postingStarts[k]] to postings[postingStarts[k+1]] are the sequences with kmer k. Searches only read the
+ *	packed postings, so one KmerDB can be searched by many threads. The shortcut file is a ReferenceIndex holding the
+ *	packed postings, readDB maps it instead of copying it.
 
  */
 
 #include "mothur.h"
 #include "database.hpp"
+#include "referenceindex.hpp"
+#include <cstdint>
 
 class KmerDB : public Database {
 	
@@ -38,6 +45,7 @@ public:
 	vector<int> getSequencesWithKmer(int);  //returns vector of sequences that contain kmer passed in
 	int getReversed(int);  //returns reverse compliment kmerNumber 
 	int getMaxKmer() { return maxKmer; }
+	void setNumSeqs(int i) { numSeqs = i; pack(); }
 	
 private:
 	
@@ -45,7 +53,20 @@ private:
 	int kmerSize;
 	int maxKmer, count;
 	string kmerDBName;
-	vector<vector<int> > kmerLocations;
+	vector<vector<int> > kmerLocations; //used while sequences are added
+	
+	bool packed;
+	int numIndexed;                     //largest sequence index in the postings + 1
+	vector<uint64_t> postingStarts;     //maxKmer+2 entries
+	vector<uint32_t> postings;
+	ReferenceIndex* index;              //the mapped shortcut file, if we read one
+	const uint64_t* startsData;         //postingStarts or the mapped starts
+	const uint32_t* postingsData;       //postings or the mapped postings
+	
+	void pack();
+	void unpack();
+	bool readIndex();
+	void countSharedKmers(const string&, int, vector<int>&) const;
 };
 
 #endif
@@ -0,0 +1,208 @@
+//
+//  labelindex.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "labelindex.hpp"
+
+/**************************************************************************************************/
+static long long getFileBytes(string filename) {
+    ifstream in(filename.c_str(), ios::binary | ios::ate);
+    if (!in) { return -1; }
+    return (long long)in.tellg();
+}
+/**************************************************************************************************/
+//the first numTokens whitespace separated words of a line
+static int splitLine(const string& line, string* tokens, int numTokens) {
+    int count = 0; size_t i = 0;
+    while ((count < numTokens) && (i < line.length())) {
+        while ((i < line.length()) && isspace(line[i])) { i++; }
+        size_t start = i;
+        while ((i < line.length()) && !isspace(line[i])) { i++; }
+        if (i > start) { tokens[count++] = line.substr(start, i-start); }
+    }
+    return count;
+}
+/**************************************************************************************************/
+LabelIndex::LabelIndex(string f, string form) : filename(f), format(form) {
+    try {
+        m = MothurOut::getInstance();
+
+        if ((filename == "") || !isIndexed(format)) { return; }
+
+        filename = util.getFullPathName(filename);
+        long long bytes = getFileBytes(filename);
+        if (bytes < 0) { return; }
+
+        string indexFileName = filename + ".labels";
+        if (read(indexFileName, bytes)) { return; }
+
+        labels.clear(); offsets.clear(); numOtus.clear(); numLines.clear(); positions.clear();
+        if (scan()) { save(indexFileName, bytes); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "LabelIndex", "LabelIndex");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+bool LabelIndex::isIndexed(string format) {
+    return ((format == "list") || (format == "shared") || (format == "sharedfile") || (format == "relabund"));
+}
+/**************************************************************************************************/
+void LabelIndex::write(string filename, string format) {
+    try {
+        removeIndex(filename); //a rewrite in the same second as the old index would look current
+        LabelIndex index(filename, format);
+    }
+    catch(exception& e) {
+        MothurOut::getInstance()->errorOut(e, "LabelIndex", "write");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void LabelIndex::removeIndex(string filename) {
+    try {
+        Utils util;
+        remove((util.getFullPathName(filename) + ".labels").c_str());
+    }
+    catch(exception& e) {
+        MothurOut::getInstance()->errorOut(e, "LabelIndex", "removeIndex");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void LabelIndex::rebuild() {
+    try {
+        if ((filename == "") || !isIndexed(format)) { return; }
+
+        m->mothurOut("[WARNING]: " + filename + " does not match its label index, rebuilding it.\n");
+
+        labels.clear(); offsets.clear(); numOtus.clear(); numLines.clear(); positions.clear();
+
+        long long bytes = getFileBytes(filename);
+        if ((bytes >= 0) && scan()) { save(filename + ".labels", bytes); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "LabelIndex", "rebuild");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+int LabelIndex::find(string label) {
+    map<string, int>::iterator it = positions.find(label);
+    if (it == positions.end()) { return -1; }
+    return it->second;
+}
+/**************************************************************************************************/
+void LabelIndex::add(string label, long long offset, int otus) {
+    //a label that shows up again later in the file is found where the scans of InputData found it, the first time
+    if (positions.count(label) == 0) { positions[label] = labels.size(); }
+    labels.push_back(label); offsets.push_back(offset); numOtus.push_back(otus); numLines.push_back(1);
+}
+/**************************************************************************************************/
+bool LabelIndex::read(string indexFileName, long long bytes) {
+    try {
+        ifstream in;
+        if (!util.openInputFile(indexFileName, in, "no error")) { return false; }
+        if (util.getTimeStamp(indexFileName) < util.getTimeStamp(filename)) { in.close(); return false; }
+
+        string tag, indexFormat; long long indexBytes = -1;
+        in >> tag >> indexFormat >> indexBytes;
+        if ((tag != "#labelindex") || (indexFormat != format) || (indexBytes != bytes)) { in.close(); return false; }
+
+        string label; long long offset; int otus, lines;
+        while (in >> label >> offset >> otus >> lines) {
+            if ((offset < 0) || (offset >= bytes)) { in.close(); return false; }
+            add(label, offset, otus); numLines.back() = lines;
+        }
+        in.close();
+
+        return (labels.size() != 0);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "LabelIndex", "read");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//reads the labels and sizes at the start of the lines, the OTUs are skipped over
+bool LabelIndex::scan() {
+    try {
+        ifstream in(filename.c_str(), ios::binary);
+        if (!in) { return false; }
+
+        int otuColumn = 1; //label numOtus ...
+        if ((format == "sharedfile") || (format == "relabund")) { otuColumn = 2; } //label group numOtus ...
+
+        string line; string tokens[3];
+        long long offset = 0;
+        bool firstLine = true;
+        string previousLabel = "";
+
+        while (std::getline(in, line)) {
+            if (m->getControl_pressed()) { return false; }
+
+            long long lineOffset = offset;
+            offset += line.length() + 1;
+
+            int numTokens = splitLine(line, tokens, otuColumn+1);
+            if (numTokens == 0) { continue; }
+
+            if (firstLine) {
+                firstLine = false;
+                if (tokens[0] == "label") { continue; } //headers
+            }
+
+            if (tokens[0] == previousLabel) { numLines.back()++; continue; }
+
+            int otus = 0;
+            if (numTokens > otuColumn) { otus = atoi(tokens[otuColumn].c_str()); }
+
+            add(tokens[0], lineOffset, otus);
+            previousLabel = tokens[0];
+        }
+        in.close();
+
+        return (labels.size() != 0);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "LabelIndex", "scan");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//written under a temp name and renamed, so other processes never read half an index
+void LabelIndex::save(string indexFileName, long long bytes) {
+    try {
+#ifdef NON_WINDOWS
+        string tempFile = indexFileName + "." + toString(getpid()) + ".temp";
+#else
+        string tempFile = indexFileName + ".temp";
+#endif
+        ofstream out(tempFile.c_str(), ios::trunc);
+        if (!out) { return; } //a directory we can't write to, the index is only kept in memory
+
+        out << "#labelindex\t" << format << '\t' << bytes << '\n';
+        for (int i = 0; i < labels.size(); i++) {
+            out << labels[i] << '\t' << offsets[i] << '\t' << numOtus[i] << '\t' << numLines[i] << '\n';
+        }
+
+        bool good = !out.fail();
+        out.close();
+
+        if (!good) { util.mothurRemove(tempFile); return; }
+
+#ifndef NON_WINDOWS
+        util.mothurRemove(indexFileName);
+#endif
+        if (rename(tempFile.c_str(), indexFileName.c_str()) != 0) { util.mothurRemove(tempFile); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "LabelIndex", "save");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
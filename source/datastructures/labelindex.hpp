@@ -0,0 +1,61 @@
+//
+//  labelindex.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef labelindex_hpp
+#define labelindex_hpp
+
+#include "mothur.h"
+#include "utils.hpp"
+
+/**************************************************************************************************/
+//LabelIndex knows where each label of a list, shared or relabund file starts, so InputData can seek to the labels a
+//command asks for instead of parsing every OTU line in front of them. The index is saved next to the file as
+//<file>.labels, a header line "#labelindex <format> <file bytes>" and a line per label:
+//
+//  label   offset of the label's first line    numOtus     number of lines (the groups of a shared file)
+//
+//It is rebuilt if the file is newer than the index or its size changed. A file rewritten to the same size in the same
+//second as its index isn't caught by that, so InputData checks the label at each offset it seeks to and calls rebuild
+//when it isn't there. If the index can't be saved it is only kept in memory.
+
+class LabelIndex {
+
+public:
+
+    LabelIndex(string, string); //filename, format. Reads filename.labels, or scans filename and saves it
+    ~LabelIndex() {}
+
+    static bool isIndexed(string); //format
+    static void write(string, string); //filename, format. Used by the commands that just wrote filename
+    static void removeIndex(string);   //filename. Utils::mothurRemove calls it, so a removed file doesn't leave its index behind
+    void rebuild();                 //scans the file again and saves the index
+
+    int getNumLabels()              { return labels.size();     }
+    int find(string);               //position of the label in the file, -1 if the file doesn't have it
+    string getLabel(int i)          { return labels[i];         }
+    long long getOffset(int i)      { return offsets[i];        }
+    int getNumOtus(int i)           { return numOtus[i];        }
+    int getNumLines(int i)          { return numLines[i];       }
+
+private:
+
+    bool read(string, long long);   //index filename, file bytes
+    bool scan();
+    void save(string, long long);   //index filename, file bytes
+    void add(string, long long, int);
+
+    string filename, format;
+    vector<string> labels;
+    vector<long long> offsets;
+    vector<int> numOtus, numLines;
+    map<string, int> positions;
+    MothurOut* m;
+    Utils util;
+};
+/**************************************************************************************************/
+
+#endif /* labelindex_hpp */
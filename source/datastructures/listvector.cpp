@@ -13,27 +13,6 @@
 #include "ordervector.hpp"
 #include "listvector.hpp"
 
-//sorts highest to lowest
-/***********************************************************************/
-inline bool abundNamesSort(string left, string right){
-    
-    int countLeft = 0;
-    if(left != ""){
-        countLeft = 1;
-        for(int i=0;i<left.size();i++){  if(left[i] == ','){  countLeft++;  }  }
-    }
-    
-    int countRight = 0;
-    if(right != ""){
-        countRight = 1;
-        for(int i=0;i<right.size();i++){  if(right[i] == ','){  countRight++;  }  }
-    }
-    
-	if (countLeft > countRight) {
-        return true;
-    }
-    return false;	
-}
 //sorts highest to lowest
 /***********************************************************************/
 inline bool abundNamesSort2(listCt left, listCt right){
@@ -48,22 +27,23 @@ inline bool abundNamesSort2(listCt left, listCt right){
 
 /***********************************************************************/
 
-ListVector::ListVector() : DataVector(), maxRank(0), numBins(0), numSeqs(0), otuTag("Otu"), printListHeaders(true) {}
+ListVector::ListVector() : DataVector(), maxRank(0), numBins(0), numSeqs(0), otuTag("Otu"), printListHeaders(true) { nameTable.reset(new NameTable()); }
 
 /***********************************************************************/
 
-ListVector::ListVector(int n):	DataVector(), data(n, "") , maxRank(0), numBins(0), numSeqs(0), otuTag("Otu"), printListHeaders(true){}
+ListVector::ListVector(int n):	DataVector(), data(n) , maxRank(0), numBins(0), numSeqs(0), otuTag("Otu"), printListHeaders(true){ nameTable.reset(new NameTable()); }
 
 /***********************************************************************/
 
-ListVector::ListVector(string id, vector<string> lv, string& tag) : DataVector(id), data(lv){
+ListVector::ListVector(string id, vector<string> lv, string& tag) : DataVector(id), data(lv.size()), maxRank(0), numBins(0), numSeqs(0){
 	try {
         printListHeaders = true;
         otuTag = tag;
-        Utils util;
+        nameTable.reset(new NameTable());
 		for(int i=0;i<data.size();i++){
-			if(data[i] != ""){
-				int binSize = util.getNumNames(data[i]);
+            nameTable->getIndexes(lv[i], data[i]);
+			if(data[i].size() != 0){
+				int binSize = data[i].size();
 				numBins = i+1;
 				if(binSize > maxRank)	{	maxRank = binSize;	}
 				numSeqs += binSize;
@@ -83,6 +63,7 @@ ListVector::ListVector(ifstream& f, string& readHeaders, string& labelTag) : Dat
         printListHeaders = true;
 		int thisNumBins = 0;
         Utils util;
+        nameTable.reset(new NameTable());
         
         //are we at the beginning of the file??
 		if (readHeaders == "") {
@@ -133,7 +114,7 @@ ListVector::ListVector(ifstream& f, string& readHeaders, string& labelTag) : Dat
 		}else { f >> label >> thisNumBins; }
 		
         util.gobble(f);
-		data.assign(thisNumBins, "");
+		data.assign(thisNumBins, emptyBin);
 		string inputData = "";
         otuTag = labelTag;
 	
@@ -155,10 +136,22 @@ ListVector::ListVector(ifstream& f, string& readHeaders, string& labelTag) : Dat
 
 void ListVector::set(int binNumber, string seqNames){
 	try {
-        Utils util;
-		int nNames_old = util.getNumNames(data[binNumber]);
-		data[binNumber] = seqNames;
-		int nNames_new = util.getNumNames(seqNames);
+        vector<unsigned int> binIndexes;
+        nameTable->getIndexes(seqNames, binIndexes);
+        set(binNumber, binIndexes);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ListVector", "set");
+		exit(1);
+	}
+}
+/***********************************************************************/
+
+void ListVector::set(int binNumber, const vector<unsigned int>& binIndexes){
+	try {
+		int nNames_old = data[binNumber].size();
+		data[binNumber] = binIndexes;
+		int nNames_new = binIndexes.size();
 	
 		if(nNames_old == 0)			{	numBins++;				}
 		if(nNames_new == 0)			{	numBins--;				}
@@ -175,12 +168,46 @@ void ListVector::set(int binNumber, string seqNames){
 /***********************************************************************/
 
 string ListVector::get(int index){
-    if (index < data.size()) {  return data[index];  }
+    if (index < data.size()) {  return nameTable->getNames(data[index]);  }
     
 	return "";
 }
 /***********************************************************************/
 
+const vector<unsigned int>& ListVector::getIndexes(int index){
+    if (index < data.size()) {  return data[index];  }
+    
+    return emptyBin;
+}
+/***********************************************************************/
+
+void ListVector::getNames(int index, vector<string>& binNames){
+    nameTable->getNames(getIndexes(index), binNames);
+}
+/***********************************************************************/
+
+int ListVector::getBinSize(int index){
+    if (index < data.size()) {  return data[index].size();  }
+    
+    return 0;
+}
+/***********************************************************************/
+
+void ListVector::mergeBins(int from, int to){
+	try {
+        vector<unsigned int> merged = data[from];
+        merged.insert(merged.end(), data[to].begin(), data[to].end());
+        
+        set(to, merged);
+        set(from, emptyBin);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ListVector", "mergeBins");
+		exit(1);
+	}
+}
+/***********************************************************************/
+
 void ListVector::setLabels(vector<string> labels){
 	try {
 		binLabels = labels;
@@ -235,7 +262,7 @@ int ListVector::getOTUTotal(string otuLabel){
         
         if (binNumber == -1) { return 0; }
         
-        return (util.getNumNames(get(binNumber)));
+        return getBinSize(binNumber);
     }
     catch(exception& e) {
         m->errorOut(e, "ListVector", "getOTUTotal");
@@ -247,9 +274,19 @@ int ListVector::getOTUTotal(string otuLabel){
 
 void ListVector::push_back(string seqNames){
 	try {
-        Utils util;
-		data.push_back(seqNames);
-		int nNames = util.getNumNames(seqNames);
+        vector<unsigned int> binIndexes;
+        nameTable->getIndexes(seqNames, binIndexes);
+        push_back(binIndexes);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ListVector", "push_back");
+		exit(1);
+	}
+}/***********************************************************************/
+void ListVector::push_back(const vector<unsigned int>& binIndexes){
+	try {
+		data.push_back(binIndexes);
+		int nNames = binIndexes.size();
 	
 		numBins++;
 	
@@ -261,7 +298,23 @@ void ListVector::push_back(string seqNames){
 		m->errorOut(e, "ListVector", "push_back");
 		exit(1);
 	}
-}/***********************************************************************/
+}
+/***********************************************************************/
+void ListVector::push_back(ListVector& other, int bin){
+	try {
+        if (other.nameTable == nameTable) { push_back(other.getIndexes(bin)); return; }
+        
+        const vector<unsigned int>& otherIndexes = other.getIndexes(bin);
+        vector<unsigned int> binIndexes(otherIndexes.size());
+        for (int i = 0; i < otherIndexes.size(); i++) { binIndexes[i] = nameTable->getIndex(other.nameTable->getName(otherIndexes[i])); }
+        push_back(binIndexes);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ListVector", "push_back");
+		exit(1);
+	}
+}
+/***********************************************************************/
 int ListVector::push_back(string bin, int nNames, string binLabel){
     try {
         if (binLabel == "") { //create one
@@ -298,7 +351,8 @@ int ListVector::push_back(string bin, int nNames, string binLabel){
         }
         binLabels.push_back(binLabel);
         
-        data.push_back(bin);
+        data.push_back(emptyBin);
+        nameTable->getIndexes(bin, data.back());
         numBins++;
         
         if(nNames > maxRank)	{	maxRank = nNames;	}
@@ -334,7 +388,7 @@ void ListVector::clear(){
 }
 
 /***********************************************************************/
-void ListVector::printHeaders(ostream& output, map<string, int>& ct, bool sortPlease){
+void ListVector::printHeaders(ostream& output, map<string, int>* ct, bool sortPlease){
 	try {
         if (printListHeaders) {
             if (binLabels.size() == 0) { sortPlease = false; } //we are creating arbitary otuNames
@@ -344,21 +398,10 @@ void ListVector::printHeaders(ostream& output, map<string, int>& ct, bool sortPl
             output << "label\tnum" + otuTag + "s";
             
             if (sortPlease) {
-                Utils util;
                 vector<listCt> hold;
                 for (int i = 0; i < data.size(); i++) {
-                    if (data[i] != "") {
-                        vector<string> binNames;
-                        string bin = data[i];
-                        util.splitAtComma(bin, binNames);
-                        int total = 0;
-                        for (int j = 0; j < binNames.size(); j++) {
-                            map<string, int>::iterator it = ct.find(binNames[j]);
-                            if (it == ct.end()) {
-                                m->mothurOut("[ERROR]: " + binNames[j] + " is not in your count table. Please correct.\n"); m->setControl_pressed(true);
-                            }else { total += ct[binNames[j]]; }
-                        }
-                        listCt temp(data[i], total, theseLabels[i]);
+                    if (data[i].size() != 0) {
+                        listCt temp(get(i), getBinTotal(i, ct), theseLabels[i]);
                         hold.push_back(temp);
                     }
                 }
@@ -380,29 +423,42 @@ void ListVector::printHeaders(ostream& output, map<string, int>& ct, bool sortPl
 		exit(1);
 	}
 }
+/***********************************************************************/
+//abundance of the bin from the count table, or the number of names in it without one
+int ListVector::getBinTotal(int bin, map<string, int>* ct){
+	try {
+        if (ct == NULL) { return data[bin].size(); }
+        
+        vector<string> binNames;
+        nameTable->getNames(data[bin], binNames);
+        
+        int total = 0;
+        for (int j = 0; j < binNames.size(); j++) {
+            map<string, int>::iterator it = ct->find(binNames[j]);
+            if (it == ct->end()) {
+                m->mothurOut("[ERROR]: " + binNames[j] + " is not in your count table. Please correct.\n"); m->setControl_pressed(true);
+            }else { total += it->second; }
+        }
+        
+        return total;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ListVector", "getBinTotal");
+		exit(1);
+	}
+}
 
 /***********************************************************************/
 
 void ListVector::print(ostream& output, map<string, int>& ct){
 	try {
-        printHeaders(output, ct, true);
+        printHeaders(output, &ct, true);
 		output << label << '\t' << numBins;
         
-        Utils util;
         vector<listCt> hold;
         for (int i = 0; i < data.size(); i++) {
-            if (data[i] != "") {
-                vector<string> binNames;
-                string bin = data[i];
-                util.splitAtComma(bin, binNames);
-                int total = 0;
-                for (int j = 0; j < binNames.size(); j++) {
-                    map<string, int>::iterator it = ct.find(binNames[j]);
-                    if (it == ct.end()) {
-                        m->mothurOut("[ERROR]: " + binNames[j] + " is not in your count table. Please correct.\n"); m->setControl_pressed(true);
-                    }else { total += ct[binNames[j]]; }
-                }
-                listCt temp(data[i], total, "");
+            if (data[i].size() != 0) {
+                listCt temp(get(i), getBinTotal(i, &ct), "");
                 hold.push_back(temp);
             }
         }
@@ -423,19 +479,23 @@ void ListVector::print(ostream& output, map<string, int>& ct){
 }
 
 /***********************************************************************/
-
+//without a count table every name counts once
 void ListVector::print(ostream& output){
     try {
-        map<string, int> ct;
+        printHeaders(output, NULL, true);
+		output << label << '\t' << numBins;
+        
+        vector<listCt> hold;
         for (int i = 0; i < data.size(); i++) {
-            if (data[i] != "") {
-                string bin = data[i];
-                vector<string> binNames; util.splitAtComma(bin, binNames);
-                for (int j = 0; j < binNames.size(); j++) { ct[binNames[j]] = 1; }
+            if (data[i].size() != 0) {
+                listCt temp(get(i), data[i].size(), "");
+                hold.push_back(temp);
             }
         }
+        sort(hold.begin(), hold.end(), abundNamesSort2);
         
-        print(output, ct);
+        for(int i=0;i<hold.size();i++){ output  << '\t' << hold[i].bin; }
+        output << endl;
     }
     catch(exception& e) {
         m->errorOut(e, "ListVector", "print");
@@ -446,28 +506,16 @@ void ListVector::print(ostream& output){
 //no sort for subsampling and get.otus and remove.otus
 void ListVector::print(ostream& output, bool sortOtus){
     try {
-        map<string, int> ct;
-        for (int i = 0; i < data.size(); i++) {
-            if (data[i] != "") {
-                string bin = data[i];
-                vector<string> binNames; util.splitAtComma(bin, binNames);
-                for (int j = 0; j < binNames.size(); j++) { ct[binNames[j]] = 1; }
-            }
-        }
-        
-        printHeaders(output, ct, sortOtus);
+        printHeaders(output, NULL, sortOtus);
         output << label << '\t' << numBins;
         
-        vector<string> hold = data;
-        if (sortOtus) { sort(hold.begin(), hold.end(), abundNamesSort); }
-        
-        //find first non blank otu
-        int start = 0;
-        for(int i=0;i<hold.size();i++){  if(hold[i] != ""){  start = i; break; } }
+        vector<listCt> hold;
+        for (int i = 0; i < data.size(); i++) { hold.push_back(listCt(get(i), data[i].size(), "")); }
+        if (sortOtus) { sort(hold.begin(), hold.end(), abundNamesSort2); } //largest first, blank otus last
         
-        for(int i=start;i<hold.size();i++){
-            if(hold[i] != ""){
-                output << '\t' << hold[i];
+        for(int i=0;i<hold.size();i++){
+            if(hold[i].bin != ""){
+                output << '\t' << hold[i].bin;
             }
         }
         output << endl;
@@ -477,16 +525,13 @@ void ListVector::print(ostream& output, bool sortOtus){
         exit(1);
     }
 }
-
 /***********************************************************************/
 
 RAbundVector ListVector::getRAbundVector(){
 	try {
 		RAbundVector rav;
-        Utils util;
 		for(int i=0;i<data.size();i++){
-			int binSize = util.getNumNames(data[i]);
-			rav.push_back(binSize);
+			rav.push_back(data[i].size());
 		}
 		rav.setLabel(label);
 	
@@ -503,9 +548,8 @@ RAbundVector ListVector::getRAbundVector(){
 SAbundVector ListVector::getSAbundVector(){
 	try {
 		SAbundVector sav(maxRank+1);
-        Utils util;
 		for(int i=0;i<data.size();i++){
-			int binSize = util.getNumNames(data[i]);	
+			int binSize = data[i].size();
 			sav.set(binSize, sav.get(binSize) + 1);	
 		}
 		sav.set(0, 0);
@@ -528,7 +572,7 @@ OrderVector ListVector::getOrderVector(map<string,int>* orderMap = NULL){
 			
             vector<int> ovData;
 			for(int i=0;i<data.size();i++){
-				int binSize = util.getNumNames(data[i]);		
+				int binSize = data[i].size();
 				for(int j=0;j<binSize;j++){
 					ovData.push_back(i);
 				}
@@ -546,32 +590,16 @@ OrderVector ListVector::getOrderVector(map<string,int>* orderMap = NULL){
 			OrderVector ov(numSeqs);
 		
 			for(int i=0;i<data.size();i++){
-				string listOTU = data[i];
-				int length = listOTU.size();
-				
-				string seqName="";
+				vector<string> binNames;
+                nameTable->getNames(data[i], binNames);
 			
-				for(int j=0;j<length;j++){
-				
-					if(listOTU[j] != ','){
-						seqName += listOTU[j];
+				for(int j=0;j<binNames.size();j++){
+					if(orderMap->count(binNames[j]) == 0){
+						m->mothurOut(binNames[j] + " not found, check *.names file\n");
+						exit(1);
 					}
-					else{
-						if(orderMap->count(seqName) == 0){
-							m->mothurOut(seqName + " not found, check *.names file\n");
-							exit(1);
-						}
-					
-						ov.set((*orderMap)[seqName], i);
-						seqName = "";
-					}						
-				}
-			
-				if(orderMap->count(seqName) == 0){
-					m->mothurOut(seqName + " not found, check *.names file\n");
-					exit(1);
+					ov.set((*orderMap)[binNames[j]], i);
 				}
-				ov.set((*orderMap)[seqName], i);	
 			}
 		
 			ov.setLabel(label);
@@ -2,12 +2,13 @@
 #define LIST_H
 
 #include "datavector.hpp"
+#include "nametable.hpp"
 
 /*	DataStructure for a list file.
 	This class is a child to datavector.  It represents OTU information at a certain distance. 
 	A list vector can be converted into and ordervector, rabundvector or sabundvector.
-	Each member of the internal container "data" represents an individual OTU.
-	So data[0] = "a,b,c,d,e,f".
+	Each member of the internal container "data" represents an individual OTU, kept as the NameTable indexes of its names.
+	So get(0) = "a,b,c,d,e,f".
 	example: listvector		=	a,b,c,d,e,f		g,h,i		j,k		l		m  
 			 rabundvector	=	6				3			2		1		1
 			 sabundvector	=	2		1		1		0		0		1
@@ -19,7 +20,7 @@ public:
     ListVector();
     ListVector(int);
     ListVector(string, vector<string>, string&);
-    ListVector(const ListVector& lv) : DataVector(lv.label), data(lv.data), maxRank(lv.maxRank), numBins(lv.numBins), numSeqs(lv.numSeqs), binLabels(lv.binLabels), otuTag(lv.otuTag), printListHeaders(lv.printListHeaders) {};
+    ListVector(const ListVector& lv) : DataVector(lv.label), data(lv.data), maxRank(lv.maxRank), numBins(lv.numBins), numSeqs(lv.numSeqs), binLabels(lv.binLabels), otuTag(lv.otuTag), printListHeaders(lv.printListHeaders), nameTable(lv.nameTable) {};
     ListVector(ifstream&, string&, string&);
     ~ListVector(){};
     
@@ -28,7 +29,13 @@ public:
     int getMaxRank()							{	return maxRank;		}
     
     void set(int, string);
+    void set(int, const vector<unsigned int>&);
     string get(int);
+    const vector<unsigned int>& getIndexes(int);    //NameTable indexes of the names in the bin
+    void getNames(int, vector<string>&);
+    std::shared_ptr<NameTable> getNameTable()   {   return nameTable;   }
+    int getBinSize(int);
+    void mergeBins(int, int);                       //puts the first bin's names in front of the second's
     vector<string> getLabels();
     string getOTUName(int bin);
     int getOTUTotal(string otuLabel); //returns 0 if otuLabel is not found
@@ -37,6 +44,8 @@ public:
     void setPrintedLabels(bool pl) { printListHeaders = pl; }
     
     void push_back(string);
+    void push_back(const vector<unsigned int>&);
+    void push_back(ListVector&, int);               //a bin of another list, renumbered if the lists have different NameTables
     int push_back(string, int, string binLabel="");
     void resize(int);
     void clear();
@@ -50,14 +59,17 @@ public:
     OrderVector getOrderVector(map<string,int>*);
     
 private:
-    vector<string> data;  //data[i] is a list of names of sequences in the ith OTU.
+    vector< vector<unsigned int> > data;  //data[i] is the NameTable indexes of the sequences in the ith OTU.
+    vector<unsigned int> emptyBin;
     int maxRank;
     int numBins;
     int numSeqs;
     vector<string> binLabels;
     string otuTag;
     bool printListHeaders;
-    void printHeaders(ostream&, map<string, int>&, bool);
+    std::shared_ptr<NameTable> nameTable; //shared with the copies of the list
+    void printHeaders(ostream&, map<string, int>*, bool);
+    int getBinTotal(int, map<string, int>*);
     
 };
 
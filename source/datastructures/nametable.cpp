@@ -0,0 +1,157 @@
+//
+//  nametable.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "nametable.hpp"
+
+/**************************************************************************************************/
+static const unsigned int emptySlot = 0xFFFFFFFF;
+/**************************************************************************************************/
+NameTable::NameTable() {
+    m = MothurOut::getInstance();
+    starts.push_back(0);
+    slots.assign(1024, emptySlot);
+}
+/**************************************************************************************************/
+//FNV-1a
+unsigned long long NameTable::hashName(const char* name, unsigned long long length) {
+    unsigned long long hash = 14695981039346656037ULL;
+    for (unsigned long long i = 0; i < length; i++) { hash ^= (unsigned char)name[i]; hash *= 1099511628211ULL; }
+    return hash;
+}
+/**************************************************************************************************/
+bool NameTable::isName(unsigned int index, const string& name) {
+    unsigned long long length = starts[index+1] - starts[index];
+    if (length != name.length()) { return false; }
+    return (nameChars.compare(starts[index], length, name) == 0);
+}
+/**************************************************************************************************/
+//keeps the slots at most half full
+void NameTable::growSlots() {
+    try {
+        vector<unsigned int> newSlots(slots.size() * 2, emptySlot);
+        unsigned long long mask = newSlots.size() - 1;
+
+        for (unsigned int i = 0; i < starts.size()-1; i++) {
+            unsigned long long slot = hashName(nameChars.data() + starts[i], starts[i+1] - starts[i]) & mask;
+            while (newSlots[slot] != emptySlot) { slot = (slot + 1) & mask; }
+            newSlots[slot] = i;
+        }
+
+        slots.swap(newSlots);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "NameTable", "growSlots");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+unsigned int NameTable::addName(const string& name) {
+    try {
+        unsigned long long mask = slots.size() - 1;
+        unsigned long long slot = hashName(name.data(), name.length()) & mask;
+
+        while (slots[slot] != emptySlot) {
+            if (isName(slots[slot], name)) { return slots[slot]; }
+            slot = (slot + 1) & mask;
+        }
+
+        if ((starts.size() - 1) >= emptySlot) { //the indexes are 32 bits and emptySlot marks an open slot
+            m->mothurOut("[ERROR]: more than " + toString(emptySlot) + " sequence names, mothur can't number them all.\n"); m->setControl_pressed(true);
+            return 0;
+        }
+
+        unsigned int index = starts.size() - 1;
+        nameChars += name;
+        starts.push_back(nameChars.length());
+        slots[slot] = index;
+
+        if (2 * (index + 1) > slots.size()) { growSlots(); }
+
+        return index;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "NameTable", "addName");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+unsigned int NameTable::getIndex(const string& name) {
+    try {
+        return addName(name);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "NameTable", "getIndex");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//every name between the commas, so getNames gives back the same string
+void NameTable::getIndexes(const string& bin, vector<unsigned int>& binIndexes) {
+    try {
+        binIndexes.clear();
+        if (bin == "") { return; }
+
+        string name = "";
+        for (int i = 0; i < bin.length(); i++) {
+            if (bin[i] == ',') { binIndexes.push_back(addName(name)); name = ""; }
+            else { name += bin[i]; }
+        }
+        binIndexes.push_back(addName(name));
+    }
+    catch(exception& e) {
+        m->errorOut(e, "NameTable", "getIndexes");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+string NameTable::getName(unsigned int index) {
+    try {
+        return nameChars.substr(starts[index], starts[index+1] - starts[index]);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "NameTable", "getName");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void NameTable::getNames(const vector<unsigned int>& binIndexes, vector<string>& binNames) {
+    try {
+        binNames.clear(); binNames.reserve(binIndexes.size());
+
+        for (int i = 0; i < binIndexes.size(); i++) {
+            unsigned int index = binIndexes[i];
+            binNames.push_back(nameChars.substr(starts[index], starts[index+1] - starts[index]));
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "NameTable", "getNames");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+string NameTable::getNames(const vector<unsigned int>& binIndexes) {
+    try {
+        string bin = "";
+
+        for (int i = 0; i < binIndexes.size(); i++) {
+            if (i != 0) { bin += ','; }
+            unsigned int index = binIndexes[i];
+            bin.append(nameChars, starts[index], starts[index+1] - starts[index]);
+        }
+
+        return bin;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "NameTable", "getNames");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+unsigned int NameTable::size() {
+    return starts.size() - 1;
+}
+/**************************************************************************************************/
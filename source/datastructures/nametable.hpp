@@ -0,0 +1,50 @@
+//
+//  nametable.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef nametable_hpp
+#define nametable_hpp
+
+#include "mothurout.h"
+#include <memory>
+
+/**************************************************************************************************/
+//NameTable gives each sequence name a number the first time it is seen. The list vectors keep the numbers of the
+//names in their OTUs instead of the comma separated names, the names are only put back together for printing and
+//for the commands that still want them. A list makes a table when it is made and its copies share it, so the table
+//lives as long as the lists of the command that read or clustered them. Names are never removed, so a number
+//stays good for the table's lifetime. Not locked, the threads of cluster.split each make their own lists.
+
+class NameTable {
+
+public:
+    NameTable();
+    ~NameTable() {}
+
+    unsigned int getIndex(const string&);                       //adds the name if it is new
+    void getIndexes(const string&, vector<unsigned int>&);      //"a,b,c" -> indexes of a, b and c
+    string getName(unsigned int);
+    void getNames(const vector<unsigned int>&, vector<string>&);
+    string getNames(const vector<unsigned int>&);               //indexes of a, b and c -> "a,b,c"
+    unsigned int size();
+
+private:
+    NameTable(const NameTable&);
+    NameTable& operator=(const NameTable&);
+
+    unsigned int addName(const string&);
+    unsigned long long hashName(const char*, unsigned long long);
+    bool isName(unsigned int, const string&);
+    void growSlots();
+
+    string nameChars;                       //all the names back to back, name i starts at starts[i]
+    vector<unsigned long long> starts;      //starts[i+1] is the end of name i
+    vector<unsigned int> slots;             //open addressing hash of the names, empty slots are emptySlot
+    MothurOut* m;
+};
+/**************************************************************************************************/
+
+#endif /* nametable_hpp */
@@ -20,6 +20,7 @@ OptiBlastMatrix::OptiBlastMatrix(string d, string nc, string f, bool s, double c
     else { countfile = ""; namefile = ""; }
     
     readBlast();
+    closeness.pack();
 }
 /***********************************************************************/
 string OptiBlastMatrix::getOverlapName(long long index) {
@@ -408,8 +409,8 @@ int OptiBlastMatrix::readBlast(){
                                 
                                 int newB = singletonIndexSwap[indexB];
                                 int newA = singletonIndexSwap[indexA];
-                                closeness[newA].insert(newB);
-                                closeness[newB].insert(newA);
+                                closeness.insert(newA, newB);
+                                closeness.insert(newB, newA);
                             }
                             //not going to need this again
                             dists[itB->second].erase(itDist);
@@ -480,8 +481,8 @@ int OptiBlastMatrix::readBlast(){
                     
                     int newB = singletonIndexSwap[indexB];
                     int newA = singletonIndexSwap[indexA];
-                    closeness[newA].insert(newB);
-                    closeness[newB].insert(newA);
+                    closeness.insert(newA, newB);
+                    closeness.insert(newB, newA);
                 }
                 //not going to need this again
                 dists[itB->second].erase(itDist);
@@ -8,13 +8,57 @@
 
 #include "optidata.hpp"
 
+/***********************************************************************/
+void OptiCloseness::resize(long long n) {
+    numSeqs = n;
+    offsets.assign(numSeqs+1, 0);
+    vector<uint32_t>().swap(neighbors);
+    vector<uint64_t>().swap(pending);
+}
+/***********************************************************************/
+//counting sort of the pairs by seq, then each list is sorted and the repeats removed
+void OptiCloseness::pack() {
+    if (pending.size() == 0) { return; }
+    
+    //pairs added since the last pack go with the ones already packed
+    for (long long i = 0; i < numSeqs; i++) {
+        for (uint64_t k = offsets[i]; k < offsets[i+1]; k++) { pending.push_back(((uint64_t)i << 32) | neighbors[k]); }
+    }
+    
+    vector<uint64_t> starts(numSeqs+1, 0);
+    for (long long k = 0; k < pending.size(); k++) { starts[(pending[k] >> 32)+1]++; }
+    for (long long i = 0; i < numSeqs; i++) { starts[i+1] += starts[i]; }
+    
+    neighbors.resize(pending.size());
+    vector<uint64_t> next(starts.begin(), starts.end()-1);
+    for (long long k = 0; k < pending.size(); k++) { neighbors[next[pending[k] >> 32]++] = (uint32_t)pending[k]; }
+    vector<uint64_t>().swap(pending);
+    vector<uint64_t>().swap(next);
+    
+    uint64_t packedEnd = 0;
+    for (long long i = 0; i < numSeqs; i++) {
+        uint32_t* first = neighbors.data() + starts[i];
+        uint32_t* last = neighbors.data() + starts[i+1];
+        sort(first, last);
+        last = unique(first, last);
+        
+        offsets[i] = packedEnd;
+        uint32_t* destination = neighbors.data() + packedEnd;
+        if (destination != first) { copy(first, last, destination); }
+        packedEnd += (last - first);
+    }
+    offsets[numSeqs] = packedEnd;
+    neighbors.resize(packedEnd);
+    neighbors.shrink_to_fit();
+}
+
 /***********************************************************************/
 long long OptiData::print(ostream& out) {
     try {
         long long count = 0;
         for (long long i = 0; i < closeness.size(); i++) {
             out << i << '\t' << getName(i) << '\t';
-            for(set<long long>::iterator it = closeness[i].begin(); it != closeness[i].end(); it++){
+            for(CloseSeqs::iterator it = closeness[i].begin(); it != closeness[i].end(); it++){
                 out << *it << '\t';
                 count++;
             }
@@ -32,7 +76,7 @@ long long OptiData::print(ostream& out) {
 long long OptiData::getNumClose(long long index) {
     try {
         if (index < 0) { return 0; }
-        else if (index > closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true); return 0; }
+        else if (index >= closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true); return 0; }
         else { return closeness[index].size(); }
     }
     catch(exception& e) {
@@ -44,7 +88,7 @@ long long OptiData::getNumClose(long long index) {
 bool OptiData::isClose(long long i, long long toFind){
     try {
         if (i < 0) { return false; }
-        else if (i > closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true); return false; }
+        else if (i >= closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true); return false; }
         
         bool found = false;
         if (closeness[i].count(toFind) != 0) { found = true; }
@@ -56,15 +100,15 @@ bool OptiData::isClose(long long i, long long toFind){
     }
 }
 /***********************************************************************/
-set<long long> OptiData::getCloseSeqs(long long i){
+CloseSeqs OptiData::getCloseSeqs(long long i){
     try {
-        if (i < 0) { set<long long> temp; return temp; }
-        else if (i > closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true); set<long long> temp; return temp; }
+        if (i < 0) { return CloseSeqs(); }
+        else if (i >= closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true); return CloseSeqs(); }
         
         return closeness[i];
     }
     catch(exception& e) {
-        m->errorOut(e, "OptiData", "getNumClose");
+        m->errorOut(e, "OptiData", "getCloseSeqs");
         exit(1);
     }
 }
@@ -137,7 +181,7 @@ set<string> OptiData::getNames(set<long long> indexes) {
 long long OptiData::getNumDists(){
     try {
         long long foundDists = 0;
-        for (int i = 0; i < closeness.size(); i++) { foundDists += closeness[i].size(); }
+        foundDists = closeness.getNumPairs();
         return foundDists;
     }
     catch(exception& e) {
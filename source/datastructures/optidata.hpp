@@ -13,6 +13,51 @@
 #include "listvector.hpp"
 #include "sparsedistancematrix.h"
 #include "counttable.h"
+#include <cstdint>
+
+/***********************************************************************/
+//the seqs close to one seq, sorted. A view into OptiCloseness, valid until it is resized.
+struct CloseSeqs {
+    typedef const uint32_t* iterator;
+    
+    CloseSeqs() : first(NULL), last(NULL) {}
+    CloseSeqs(const uint32_t* f, const uint32_t* l) : first(f), last(l) {}
+    
+    iterator begin() const { return first; }
+    iterator end() const { return last; }
+    long long size() const { return (last - first); }
+    bool empty() const { return (first == last); }
+    long long count(long long seq) const { return ((seq >= 0) && binary_search(first, last, (uint32_t)seq)) ? 1 : 0; }
+    
+private:
+    const uint32_t* first;
+    const uint32_t* last;
+};
+/***********************************************************************/
+//closeness[0] contains indexes of seqs "close" to seq 0. The lists are stored one after another in neighbors,
+//offsets[i] to offsets[i+1]. While a matrix is read the pairs are collected with insert, pack sorts them into place.
+class OptiCloseness {
+    
+public:
+    
+    OptiCloseness() : numSeqs(0) { offsets.push_back(0); }
+    
+    void resize(long long); //clears, numSeqs
+    void insert(long long i, long long j) { pending.push_back(((uint64_t)i << 32) | (uint32_t)j); } //j is close to i
+    void pack(); //call after the last insert
+    
+    long long size() const { return numSeqs; }
+    long long getNumPairs() const { return neighbors.size(); }
+    CloseSeqs operator[](long long i) const { return CloseSeqs(neighbors.data() + offsets[i], neighbors.data() + offsets[i+1]); }
+    
+private:
+    
+    long long numSeqs;
+    vector<uint64_t> offsets;
+    vector<uint32_t> neighbors;
+    vector<uint64_t> pending; //seq << 32 | close seq
+};
+/***********************************************************************/
 
 class OptiData {
     
@@ -26,7 +71,7 @@ public:
     OptiData(double c)  { m = MothurOut::getInstance(); cutoff = c; }
     virtual ~OptiData(){}
     
-    set<long long> getCloseSeqs(long long i);// { return closeness[i]; }
+    CloseSeqs getCloseSeqs(long long i);
     bool isClose(long long, long long);
     long long getNumClose(long long);
     map<string, long long> getNameIndexMap();
@@ -70,7 +115,7 @@ protected:
     
     Utils util;
     MothurOut* m;
-    vector< set<long long> > closeness;  //closeness[0] contains indexes of seqs "close" to seq 0.
+    OptiCloseness closeness;  //closeness[0] contains indexes of seqs "close" to seq 0.
     vector<string> singletons; //name of seqs with NO distances in matrix, if name file is given then it contains 2nd column of namefile
     vector<string> nameMap;  //name of seqs with distances in matrix, if name file is given then it contains 2nd column of namefile
     double cutoff;
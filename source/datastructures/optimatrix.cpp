@@ -10,8 +10,9 @@
 #include "counttable.h"
 
 /***********************************************************************/
-OptiMatrix::OptiMatrix(vector< set<long long> > close, vector<string> name, vector<string> single, double c) : OptiData(c) {
-    closeness = close;
+OptiMatrix::OptiMatrix(OptiCloseness& close, vector<string> name, vector<string> single, double c) : OptiData(c) {
+    swap(closeness, close);
+    closeness.pack();
     nameMap = name;
     singletons = single;
 }
@@ -25,6 +26,7 @@ OptiMatrix::OptiMatrix(string d, string nc, string f, string df, double c, bool
     if (distFormat == "phylip")         { readPhylip();     }
     else if (distFormat == "column")    { readColumn();     }
     
+    closeness.pack();
 }
 /***********************************************************************/
 
@@ -147,8 +149,8 @@ int OptiMatrix::readPhylip(){
                     if(distance <= cutoff){
                         long long newB = singletonIndexSwap[j];
                         long long newA = singletonIndexSwap[i];
-                        closeness[newA].insert(newB);
-                        closeness[newB].insert(newA);
+                        closeness.insert(newA, newB);
+                        closeness.insert(newB, newA);
                     }
                     index++; 
                 }
@@ -174,8 +176,8 @@ int OptiMatrix::readPhylip(){
                     if(distance <= cutoff && j < i){
                         long long newB = singletonIndexSwap[j];
                         long long newA = singletonIndexSwap[i];
-                        closeness[newA].insert(newB);
-                        closeness[newB].insert(newA);
+                        closeness.insert(newA, newB);
+                        closeness.insert(newB, newA);
                     }
                     index++; 
                 }
@@ -211,6 +213,8 @@ int OptiMatrix::readColumn(){
             nameMap.push_back(it->first);
         }
         
+        if (BinaryDistFile::isBinary(distFile)) { return readBinary(nameAssignment); }
+        
         string firstName, secondName;
         float distance;
         
@@ -297,8 +301,8 @@ int OptiMatrix::readColumn(){
                 
                 long long newB = singletonIndexSwap[indexB];
                 long long newA = singletonIndexSwap[indexA];
-                closeness[newA].insert(newB);
-                closeness[newB].insert(newA);
+                closeness.insert(newA, newB);
+                closeness.insert(newB, newA);
                 
                 if (namefile != "") {
                     firstName = names[firstName];  //redundant names
@@ -320,6 +324,97 @@ int OptiMatrix::readColumn(){
         exit(1);
     }
 }
+/***********************************************************************/
+//same two passes as readColumn, but the names are looked up once per sequence instead of once per distance
+int OptiMatrix::readBinary(map<string, long long>& nameAssignment){
+    try {
+        Utils util;
+        BinaryDistFile binaryFile(distFile);
+        if (m->getControl_pressed()) { return 0; }
+        
+        long long numSeqs = binaryFile.getNumSeqs();
+        vector<long long> indexes(numSeqs);
+        for (long long i = 0; i < numSeqs; i++) {
+            map<string,long long>::iterator it = nameAssignment.find(binaryFile.getName(i));
+            if(it == nameAssignment.end()){  m->mothurOut("AAError: Sequence '" + binaryFile.getName(i) + "' was not found in the name or count file, please correct\n"); exit(1);  }
+            indexes[i] = it->second;
+        }
+        
+        ///////////////////// Read to eliminate singletons ///////////////////////
+        vector<bool> singleton; singleton.resize(nameAssignment.size(), true);
+        for (long long i = 0; i < numSeqs; i++) {
+            if (m->getControl_pressed()) {  return 0; }
+            
+            for (long long k = binaryFile.getRowStart(i); k < binaryFile.getRowEnd(i); k++) {
+                float distance = binaryFile.getDist(k);
+                
+                if (util.isEqual(distance,-1)) { distance = 1000000; }
+                else if (sim) { distance = 1.0 - distance;  }  //user has entered a sim matrix that we need to convert.
+                
+                if(distance <= cutoff){
+                    singleton[indexes[i]] = false;
+                    singleton[indexes[binaryFile.getColumn(k)]] = false;
+                }
+            }
+        }
+        //////////////////////////////////////////////////////////////////////////
+        
+        vector<long long> singletonIndexSwap(singleton.size(), 0);
+        long long nonSingletonCount = 0;
+        for (long long i = 0; i < singleton.size(); i++) {
+            if (!singleton[i]) { //if you are a singleton
+                singletonIndexSwap[i] = nonSingletonCount;
+                nonSingletonCount++;
+            }else { singletons.push_back(nameMap[i]); }
+        }
+        
+        closeness.resize(nonSingletonCount);
+        
+        map<string, string> names;
+        if (namefile != "") {
+            util.readNames(namefile, names);
+            for (long long i = 0; i < singletons.size(); i++) {
+                singletons[i] = names[singletons[i]];
+            }
+        }
+        
+        //the names of the non singletons, with their redundant names
+        vector<string> seqNames(numSeqs);
+        for (long long i = 0; i < numSeqs; i++) {
+            seqNames[i] = binaryFile.getName(i);
+            if (namefile != "") { seqNames[i] = names[seqNames[i]]; }
+        }
+        
+        for (long long i = 0; i < numSeqs; i++) {
+            if (m->getControl_pressed()) {  return 0; }
+            
+            for (long long k = binaryFile.getRowStart(i); k < binaryFile.getRowEnd(i); k++) {
+                float distance = binaryFile.getDist(k);
+                
+                if (util.isEqual(distance,-1)) { distance = 1000000; }
+                else if (sim) { distance = 1.0 - distance;  }  //user has entered a sim matrix that we need to convert.
+                
+                if(distance <= cutoff){
+                    long long j = binaryFile.getColumn(k);
+                    long long newA = singletonIndexSwap[indexes[i]];
+                    long long newB = singletonIndexSwap[indexes[j]];
+                    closeness.insert(newA, newB);
+                    closeness.insert(newB, newA);
+                    
+                    nameMap[newA] = seqNames[i];
+                    nameMap[newB] = seqNames[j];
+                }
+            }
+        }
+        nameAssignment.clear();
+        
+        return 1;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiMatrix", "readBinary");
+        exit(1);
+    }
+}
 
 /***********************************************************************/
 
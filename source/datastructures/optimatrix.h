@@ -10,6 +10,7 @@
 #define __Mothur__optimatrix__
 
 #include "optidata.hpp"
+#include "binarydistfile.hpp"
 
 
 class OptiMatrix : public OptiData {
@@ -21,7 +22,7 @@ public:
     OptiMatrix() : OptiData(0.03) {};
 #endif
     
-    OptiMatrix(vector< set<long long> >, vector<string>, vector<string>, double); //closeness, namemap, singleton, cutoff
+    OptiMatrix(OptiCloseness&, vector<string>, vector<string>, double); //closeness (taken), namemap, singleton, cutoff
     OptiMatrix(string, string, string, string, double, bool); //distfile, dupsFile, dupsFormat, distFormat, cutoff, sim
     ~OptiMatrix(){}
     
@@ -32,6 +33,7 @@ protected:
 
     int readPhylip();
     int readColumn();
+    int readBinary(map<string, long long>&); //name -> index
 };
 
 
@@ -85,7 +85,7 @@ OptiData* OptiRefMatrix::extractRefMatrix() {
             
         vector<string> subsetNameMap;
         vector<string> subsetSingletons;
-        vector< set<long long> > subsetCloseness;
+        OptiCloseness subsetCloseness;
         map<long long, long long> thisNameMap;
         map<long long, long long> nonSingletonNameMap;
         vector<bool> singleton; singleton.resize(seqs.size(), true);
@@ -96,8 +96,8 @@ OptiData* OptiRefMatrix::extractRefMatrix() {
             thisNameMap[seqNum] = count;
             nonSingletonNameMap[count] = seqNum;
             
-            set<long long> thisSeqsCloseSeqs = getCloseSeqs(seqNum);
-            for (set<long long>::iterator itClose = thisSeqsCloseSeqs.begin(); itClose != thisSeqsCloseSeqs.end(); itClose++) {
+            CloseSeqs thisSeqsCloseSeqs = getCloseSeqs(seqNum);
+            for (CloseSeqs::iterator itClose = thisSeqsCloseSeqs.begin(); itClose != thisSeqsCloseSeqs.end(); itClose++) {
                 
                 if (m->getControl_pressed()) { break; }
                 
@@ -125,9 +125,9 @@ OptiData* OptiRefMatrix::extractRefMatrix() {
             
             long long seqNum = *it;
             
-            set<long long> thisSeqsCloseSeqs = getCloseSeqs(seqNum);
+            CloseSeqs thisSeqsCloseSeqs = getCloseSeqs(seqNum);
             set<long long> thisSeqsCloseUnFittedSeqs;
-            for (set<long long>::iterator itClose = thisSeqsCloseSeqs.begin(); itClose != thisSeqsCloseSeqs.end(); itClose++) {
+            for (CloseSeqs::iterator itClose = thisSeqsCloseSeqs.begin(); itClose != thisSeqsCloseSeqs.end(); itClose++) {
                 
                 if (m->getControl_pressed()) { break; }
                 
@@ -138,7 +138,8 @@ OptiData* OptiRefMatrix::extractRefMatrix() {
             }
             
             if (!thisSeqsCloseUnFittedSeqs.empty()) {
-                subsetCloseness[nonSingletonNameMap[thisNameMap[seqNum]]] = thisSeqsCloseUnFittedSeqs;
+                long long subsetSeq = nonSingletonNameMap[thisNameMap[seqNum]];
+                for (set<long long>::iterator itUnFitted = thisSeqsCloseUnFittedSeqs.begin(); itUnFitted != thisSeqsCloseUnFittedSeqs.end(); itUnFitted++) { subsetCloseness.insert(subsetSeq, *itUnFitted); }
                 subsetNameMap.push_back(getName(seqNum));
             }
             
@@ -174,7 +175,7 @@ OptiData* OptiRefMatrix::extractMatrixSubset(set<long long> & seqs) {
     try {
         vector<string> subsetNameMap;
         vector<string> subsetSingletons;
-        vector< set<long long> > subsetCloseness;
+        OptiCloseness subsetCloseness;
         map<long long, long long> thisNameMap;
         map<long long, long long> nonSingletonNameMap;
         vector<bool> singleton; singleton.resize(seqs.size(), true);
@@ -186,8 +187,8 @@ OptiData* OptiRefMatrix::extractMatrixSubset(set<long long> & seqs) {
             thisNameMap[seqNum] = count;
             nonSingletonNameMap[count] = seqNum;
             
-            set<long long> thisSeqsCloseSeqs = getCloseSeqs(seqNum);
-            for (set<long long>::iterator itClose = thisSeqsCloseSeqs.begin(); itClose != thisSeqsCloseSeqs.end(); itClose++) {
+            CloseSeqs thisSeqsCloseSeqs = getCloseSeqs(seqNum);
+            for (CloseSeqs::iterator itClose = thisSeqsCloseSeqs.begin(); itClose != thisSeqsCloseSeqs.end(); itClose++) {
                 
                 if (m->getControl_pressed()) { break; }
                 
@@ -215,9 +216,9 @@ OptiData* OptiRefMatrix::extractMatrixSubset(set<long long> & seqs) {
             
             long long seqNum = *it;
             
-            set<long long> thisSeqsCloseSeqs = getCloseSeqs(seqNum);
+            CloseSeqs thisSeqsCloseSeqs = getCloseSeqs(seqNum);
             set<long long> thisSeqsCloseUnFittedSeqs;
-            for (set<long long>::iterator itClose = thisSeqsCloseSeqs.begin(); itClose != thisSeqsCloseSeqs.end(); itClose++) {
+            for (CloseSeqs::iterator itClose = thisSeqsCloseSeqs.begin(); itClose != thisSeqsCloseSeqs.end(); itClose++) {
                 
                 if (m->getControl_pressed()) { break; }
                 
@@ -228,7 +229,8 @@ OptiData* OptiRefMatrix::extractMatrixSubset(set<long long> & seqs) {
             }
             
             if (!thisSeqsCloseUnFittedSeqs.empty()) {
-                subsetCloseness[nonSingletonNameMap[thisNameMap[seqNum]]] = thisSeqsCloseUnFittedSeqs;
+                long long subsetSeq = nonSingletonNameMap[thisNameMap[seqNum]];
+                for (set<long long>::iterator itUnFitted = thisSeqsCloseUnFittedSeqs.begin(); itUnFitted != thisSeqsCloseUnFittedSeqs.end(); itUnFitted++) { subsetCloseness.insert(subsetSeq, *itUnFitted); }
                 subsetNameMap.push_back(getName(seqNum));
             }
             
@@ -289,7 +291,7 @@ vector<long long> OptiRefMatrix::getTranslatedBins(vector<vector<string> > & bin
 bool OptiRefMatrix::isCloseFit(long long i, long long toFind, bool& isFit){
     try {
         if (i < 0) { return false; }
-        else if (i > closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true); return false; }
+        else if (i >= closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true); return false; }
         
         bool found = false;
         if (!isRef[toFind]) { //are you a fit seq
@@ -372,10 +374,10 @@ long long OptiRefMatrix::getNumFitClose(long long index) {
         long long numClose = 0;
         
         if (index < 0) { }
-        else if (index > closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true);  }
+        else if (index >= closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true);  }
         else {
             //reference seqs all have indexes less than refEnd
-            for (set<long long>::iterator it = closeness[index].begin(); it != closeness[index].end(); it++) {
+            for (CloseSeqs::iterator it = closeness[index].begin(); it != closeness[index].end(); it++) {
                 if (!isRef[*it]) {  numClose++; } //you are a fit seq
             }
         }
@@ -393,10 +395,10 @@ long long OptiRefMatrix::getNumRefClose(long long index) {
         long long numClose = 0;
         
         if (index < 0) { }
-        else if (index > closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true);  }
+        else if (index >= closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true);  }
         else {
             //reference seqs all have indexes less than refEnd
-            for (set<long long>::iterator it = closeness[index].begin(); it != closeness[index].end(); it++) {
+            for (CloseSeqs::iterator it = closeness[index].begin(); it != closeness[index].end(); it++) {
                 if (isRef[*it]) {  numClose++; } //you are a ref seq
             }
         }
@@ -414,10 +416,10 @@ set<long long> OptiRefMatrix::getCloseFitSeqs(long long index){
         set<long long> closeSeqs;
         
         if (index < 0) { }
-        else if (index > closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true);  } //
+        else if (index >= closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true);  } //
         else {
             //reference seqs all have indexes less than refEnd
-            for (set<long long>::iterator it = closeness[index].begin(); it != closeness[index].end(); it++) {
+            for (CloseSeqs::iterator it = closeness[index].begin(); it != closeness[index].end(); it++) {
                 if (!isRef[*it]) {  closeSeqs.insert(*it); } //you are a fit seq
             }
         }
@@ -435,10 +437,10 @@ set<long long> OptiRefMatrix::getCloseRefSeqs(long long index){
         set<long long> closeSeqs;
         
         if (index < 0) { }
-        else if (index > closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true);  }
+        else if (index >= closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true);  }
         else {
             //reference seqs all have indexes less than refEnd
-            for (set<long long>::iterator it = closeness[index].begin(); it != closeness[index].end(); it++) {
+            for (CloseSeqs::iterator it = closeness[index].begin(); it != closeness[index].end(); it++) {
                 if (isRef[*it]) { closeSeqs.insert(*it); } //you are a ref seq
             }
         }
@@ -615,6 +617,8 @@ int OptiRefMatrix::readFiles(string distFile, string distFormat, string dupsFile
         }
         singleton.clear();
         
+        closeness.pack();
+        
         //find number of fitDists, refDists and between dists
         calcCounts();
         
@@ -744,6 +748,8 @@ int OptiRefMatrix::readFiles(string refdistfile, string refnamefile, string refc
         if (betweendistformat == "column")        {  readColumn(betweendistfile, hasName, names, nameAssignment, singletonIndexSwap);     }
         else if (betweendistformat == "phylip")   {  readPhylip(betweendistfile, hasName, names, nameAssignment, singletonIndexSwap);     }
         
+        closeness.pack();
+        
         //find number of fitDists, refDists and between dists
         calcCounts();
         
@@ -757,12 +763,13 @@ int OptiRefMatrix::readFiles(string refdistfile, string refnamefile, string refc
 /***********************************************************************/
 map<long long, long long> OptiRefMatrix::readColumnSingletons(vector<bool>& singleton, string distFile, map<string, long long>& nameAssignment){
     try {
+        map<long long, long long> singletonIndexSwap;
+        if (BinaryDistFile::isBinary(distFile)) { m->mothurOut("[ERROR]: " + distFile + " is a binary distance file, cluster.fit needs a column file.\n"); m->setControl_pressed(true); return singletonIndexSwap; }
         
         ifstream fileHandle; util.openInputFile(distFile, fileHandle);
         
         string firstName, secondName;
         double distance;
-        map<long long, long long> singletonIndexSwap;
         
         while(fileHandle){  //let's assume it's a triangular matrix...
             
@@ -927,8 +934,8 @@ int OptiRefMatrix::readPhylip(string distFile, bool hasName, map<string, string>
                         }
                         long long newB = singletonIndexSwap[j];
                         long long newA = singletonIndexSwap[i];
-                        closeness[newA].insert(newB);
-                        closeness[newB].insert(newA);
+                        closeness.insert(newA, newB);
+                        closeness.insert(newB, newA);
                     }
                 }
             }
@@ -954,8 +961,8 @@ int OptiRefMatrix::readPhylip(string distFile, bool hasName, map<string, string>
                         }
                         long long newB = singletonIndexSwap[j];
                         long long newA = singletonIndexSwap[i];
-                        closeness[newA].insert(newB);
-                        closeness[newB].insert(newA);
+                        closeness.insert(newA, newB);
+                        closeness.insert(newB, newA);
                     }
                 }
             }
@@ -973,6 +980,8 @@ int OptiRefMatrix::readPhylip(string distFile, bool hasName, map<string, string>
 
 int OptiRefMatrix::readColumn(string distFile, bool hasName, map<string, string>& names, map<string, long long>& nameAssignment, map<long long, long long>& singletonIndexSwap){
     try {
+        if (BinaryDistFile::isBinary(distFile)) { m->mothurOut("[ERROR]: " + distFile + " is a binary distance file, cluster.fit needs a column file.\n"); m->setControl_pressed(true); return 0; }
+        
         string firstName, secondName;
         double distance;
         
@@ -1006,8 +1015,8 @@ int OptiRefMatrix::readColumn(string distFile, bool hasName, map<string, string>
                 
                 long long newB = singletonIndexSwap[indexB];
                 long long newA = singletonIndexSwap[indexA];
-                closeness[newA].insert(newB);
-                closeness[newB].insert(newA);
+                closeness.insert(newA, newB);
+                closeness.insert(newB, newA);
                 
                 if (hasName) {
                     map<string, string>::iterator itName1 = names.find(firstName);
@@ -1050,7 +1059,7 @@ void OptiRefMatrix::calcCounts(){
             long long thisSeqsNumRefDists = 0;
             long long thisSeqsNumFitDists = 0;
             
-            for (set<long long>::iterator it = closeness[i].begin(); it != closeness[i].end(); it++) {
+            for (CloseSeqs::iterator it = closeness[i].begin(); it != closeness[i].end(); it++) {
                 long long newB = *it;
                 
                 if ((thisSeqIsRef) && (isRef[newB])) {  thisSeqsNumRefDists++; } //both refs
@@ -0,0 +1,54 @@
+//
+//  packedsequencedb.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "packedsequencedb.hpp"
+
+/**************************************************************************************************/
+PackedSequenceDB::PackedSequenceDB() : rowWidth(0), rowWords(0), numEncoded(0) { m = MothurOut::getInstance(); }
+/**************************************************************************************************/
+PackedSequenceDB::PackedSequenceDB(SequenceDB& db) : rowWidth(0), rowWords(0), numEncoded(0) {
+    try {
+        m = MothurOut::getInstance();
+
+        long long numSeqs = db.getNumSeqs();
+
+        for (long long i = 0; i < numSeqs; i++) {
+            int length = db.get(i).getAligned().length();
+            if (length > rowWidth) { rowWidth = length; }
+        }
+        rowWords = EncodedSeq::getNumPlaneWords(rowWidth);
+
+        //size the blocks before encoding, the views hold pointers into them
+        names.resize(numSeqs);
+        aligned.assign(numSeqs*rowWidth, '.');
+        planes.assign(numSeqs*rowWords, 0);
+        rows.resize(numSeqs);
+
+        for (long long i = 0; i < numSeqs; i++) {
+
+            if (m->getControl_pressed()) { break; }
+
+            Sequence seq = db.get(i);
+            string seqAligned = seq.getAligned();
+
+            names[i] = seq.getName();
+
+            char* row = aligned.data() + i*rowWidth;
+            copy(seqAligned.begin(), seqAligned.end(), row);
+
+            //each row has rowWords words, the row's planes are sized by its own length
+            rows[i].encode(row, seqAligned.length(), planes.data() + i*rowWords);
+
+            if (rows[i].isEncoded()) { numEncoded++; }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "PackedSequenceDB", "PackedSequenceDB");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
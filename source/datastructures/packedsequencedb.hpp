@@ -0,0 +1,51 @@
+//
+//  packedsequencedb.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef packedsequencedb_hpp
+#define packedsequencedb_hpp
+
+#include "sequencedb.h"
+
+/**************************************************************************************************/
+//PackedSequenceDB is a read only copy of a SequenceDB laid out for the pairwise distance drivers.
+//The aligned sequences are stored in one block of fixed width rows and their bit planes in a second block,
+//and get(i) returns an EncodedSeq view of row i with the start and end columns already found.
+//Nothing is copied when comparing two rows, so the driver loops do not allocate.
+
+class PackedSequenceDB {
+
+public:
+
+    PackedSequenceDB();
+    PackedSequenceDB(SequenceDB&);
+    ~PackedSequenceDB() {}
+
+    long long getNumSeqs() const                { return rows.size();   }
+    int getRowWidth() const                     { return rowWidth;      } //longest alignment in the db
+    long long getNumEncoded() const             { return numEncoded;    } //rows that can use the bit packed kernels
+    const string& getName(long long i) const    { return names[i];      }
+    const EncodedSeq& get(long long i) const    { return rows[i];       }
+
+private:
+
+    MothurOut* m;
+
+    vector<string> names;
+    vector<char> aligned;       //numSeqs rows of rowWidth characters
+    vector<uint64_t> planes;    //numSeqs rows of rowWords bit plane words
+    vector<EncodedSeq> rows;    //views of the rows in aligned and planes
+    int rowWidth, rowWords;
+    long long numEncoded;
+
+    //the rows point into this object's blocks, so it can't be copied
+    PackedSequenceDB(const PackedSequenceDB&);
+    PackedSequenceDB& operator=(const PackedSequenceDB&);
+
+};
+/**************************************************************************************************/
+
+#endif /* packedsequencedb_hpp */
@@ -0,0 +1,273 @@
+//
+//  referenceindex.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "referenceindex.hpp"
+
+#ifdef NON_WINDOWS
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+static const char referenceIndexMagic[8] = { 'M', 'O', 'T', 'H', 'R', 'I', 'D', 'X' };
+static const uint32_t referenceIndexVersion = 1;
+static const int preludeVersionBytes = 48;
+static const int preludeBytes = 64;
+static const int trailerBytes = 16;
+
+/**************************************************************************************************/
+ReferenceIndex::ReferenceIndex(string f) : filename(f), base(NULL), size(0), mapped(false) {
+    try {
+        m = MothurOut::getInstance();
+
+        if (!open()) {
+            m->mothurOut("[ERROR]: " + filename + " is not a valid reference index, please remove it so mothur can rebuild it.\n");
+            sections.clear();
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "ReferenceIndex", "ReferenceIndex");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+ReferenceIndex::~ReferenceIndex() {
+#ifdef NON_WINDOWS
+    if (mapped) { munmap((void*)base, size); }
+#endif
+}
+/**************************************************************************************************/
+bool ReferenceIndex::isIndex(string filename) {
+    try {
+        ifstream in(filename.c_str(), ios::binary);
+        if (!in) { return false; }
+
+        char prelude[preludeBytes];
+        in.read(prelude, preludeBytes);
+
+        return ((in.gcount() == preludeBytes) && (memcmp(prelude+preludeVersionBytes, referenceIndexMagic, 8) == 0));
+    }
+    catch(exception& e) {
+        MothurOut::getInstance()->errorOut(e, "ReferenceIndex", "isIndex");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+bool ReferenceIndex::open() {
+    try {
+#ifdef NON_WINDOWS
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd == -1) { return false; }
+
+        struct stat fileStats;
+        if (fstat(fd, &fileStats) == -1) { ::close(fd); return false; }
+        size = fileStats.st_size;
+
+        if (size >= (preludeBytes + trailerBytes)) {
+            void* address = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+            if (address != MAP_FAILED) {
+                base = (const char*)address; mapped = true;
+                madvise(address, size, MADV_RANDOM); //lookups jump around the postings and probabilities
+            }
+        }
+        ::close(fd);
+#endif
+        if (base == NULL) { //no mmap, read the whole file
+            ifstream in(filename.c_str(), ios::binary);
+            if (!in) { return false; }
+
+            in.seekg(0, ios::end); size = in.tellg(); in.seekg(0, ios::beg);
+            if (size < (preludeBytes + trailerBytes)) { return false; }
+
+            data.resize(size);
+            in.read(&data[0], size);
+            if (in.gcount() != size) { return false; }
+            base = &data[0];
+        }
+
+        if (memcmp(base+preludeVersionBytes, referenceIndexMagic, 8) != 0) { return false; }
+
+        uint32_t formatVersion; memcpy(&formatVersion, base+preludeVersionBytes+8, 4);
+        if (formatVersion != referenceIndexVersion) { m->mothurOut("[ERROR]: " + filename + " was written by a different version of mothur.\n"); return false; }
+
+        const char* versionEnd = (const char*)memchr(base, '\n', preludeVersionBytes);
+        if ((versionEnd == NULL) || (base[0] != '#')) { return false; }
+        version = string(base+1, versionEnd);
+
+        uint64_t contentsOffset, numSections;
+        memcpy(&contentsOffset, base+size-trailerBytes, 8);
+        memcpy(&numSections, base+size-trailerBytes+8, 8);
+        if ((contentsOffset + numSections * sizeof(ReferenceIndexSection) + trailerBytes) != size) { return false; }
+
+        for (uint64_t i = 0; i < numSections; i++) {
+            ReferenceIndexSection section;
+            memcpy(&section, base+contentsOffset+i*sizeof(ReferenceIndexSection), sizeof(ReferenceIndexSection));
+            section.name[31] = '\0';
+
+            if ((section.offset + section.bytes) > contentsOffset) { return false; }
+            sections[section.name] = section;
+        }
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "ReferenceIndex", "open");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+bool ReferenceIndex::hasSection(string name) {
+    return (sections.count(name) != 0);
+}
+/**************************************************************************************************/
+const void* ReferenceIndex::getSection(string name, long long& bytes) {
+    try {
+        map<string, ReferenceIndexSection>::iterator it = sections.find(name);
+        if (it == sections.end()) { bytes = 0; return NULL; }
+
+        bytes = it->second.bytes;
+        return (const void*)(base + it->second.offset);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "ReferenceIndex", "getSection");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+bool ReferenceIndex::getStrings(string name, MappedStrings& strings) {
+    try {
+        long long numOffsets, numChars;
+        strings.offsets = getArray<uint64_t>(name + ".offsets", numOffsets);
+        strings.chars = getArray<char>(name, numChars);
+
+        if ((strings.offsets == NULL) || (strings.chars == NULL) || (numOffsets == 0)) { return false; }
+        if (strings.offsets[numOffsets-1] != numChars) { return false; }
+
+        strings.numStrings = numOffsets - 1;
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "ReferenceIndex", "getStrings");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+ReferenceIndexWriter::ReferenceIndexWriter(string f, string version) : filename(f), inSection(false) {
+    try {
+        m = MothurOut::getInstance();
+#ifdef NON_WINDOWS
+        tempFile = filename + "." + toString(getpid()) + ".temp"; //processes building the same index don't share a temp file
+#else
+        tempFile = filename + ".temp";
+#endif
+
+        out.open(tempFile.c_str(), ios::binary | ios::trunc);
+        if (!out) { m->mothurOut("[ERROR]: Could not open " + tempFile + "\n"); m->setControl_pressed(true); return; }
+
+        char prelude[preludeBytes]; memset(prelude, 0, preludeBytes);
+        string versionLine = "#" + version + "\n";
+        memcpy(prelude, versionLine.c_str(), min((int)versionLine.length(), preludeVersionBytes));
+        memcpy(prelude+preludeVersionBytes, referenceIndexMagic, 8);
+        memcpy(prelude+preludeVersionBytes+8, &referenceIndexVersion, 4);
+
+        out.write(prelude, preludeBytes);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "ReferenceIndexWriter", "ReferenceIndexWriter");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+ReferenceIndexWriter::~ReferenceIndexWriter() {
+    if (out.is_open()) { out.close(); util.mothurRemove(tempFile); } //never closed, don't leave half an index
+}
+/**************************************************************************************************/
+void ReferenceIndexWriter::pad() {
+    long long position = out.tellp();
+    long long padding = (64 - (position % 64)) % 64;
+    char zeros[64]; memset(zeros, 0, 64);
+    out.write(zeros, padding);
+}
+/**************************************************************************************************/
+void ReferenceIndexWriter::addSection(string name, const void* values, long long bytes) {
+    try {
+        startSection(name);
+        append(values, bytes);
+        endSection();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "ReferenceIndexWriter", "addSection");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void ReferenceIndexWriter::startSection(string name) {
+    try {
+        if (inSection) { endSection(); }
+        if (name.length() > 31) { m->mothurOut("[ERROR]: reference index section name " + name + " is too long.\n"); m->setControl_pressed(true); }
+
+        pad();
+
+        ReferenceIndexSection section; memset(&section, 0, sizeof(section));
+        strncpy(section.name, name.c_str(), 31);
+        section.offset = out.tellp();
+        sections.push_back(section);
+
+        inSection = true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "ReferenceIndexWriter", "startSection");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void ReferenceIndexWriter::append(const void* values, long long bytes) {
+    if (bytes == 0) { return; }
+    out.write((const char*)values, bytes);
+    sections.back().bytes += bytes;
+}
+/**************************************************************************************************/
+void ReferenceIndexWriter::endSection() {
+    inSection = false;
+}
+/**************************************************************************************************/
+bool ReferenceIndexWriter::close() {
+    try {
+        if (!out.is_open()) { return false; }
+        if (inSection) { endSection(); }
+
+        pad();
+
+        uint64_t contentsOffset = out.tellp();
+        uint64_t numSections = sections.size();
+        for (int i = 0; i < sections.size(); i++) { out.write((const char*)&sections[i], sizeof(ReferenceIndexSection)); }
+        out.write((const char*)&contentsOffset, 8);
+        out.write((const char*)&numSections, 8);
+
+        bool good = !out.fail();
+        out.close();
+
+        if (!good || m->getControl_pressed()) { util.mothurRemove(tempFile); return false; }
+
+        //rename replaces the old index in one step, processes that have it mapped keep their copy
+#ifndef NON_WINDOWS
+        util.mothurRemove(filename);
+#endif
+        if (rename(tempFile.c_str(), filename.c_str()) != 0) {
+            m->mothurOut("[ERROR]: Could not rename " + tempFile + " to " + filename + ".\n");
+            util.mothurRemove(tempFile); return false;
+        }
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "ReferenceIndexWriter", "close");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,116 @@
+//
+//  referenceindex.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef referenceindex_hpp
+#define referenceindex_hpp
+
+#include "mothur.h"
+#include "utils.hpp"
+#include <cstdint>
+
+/**************************************************************************************************/
+//The binary shortcut file for a reference, used for the kmer postings, the wang probabilities and the template
+//sequences. It is a set of named arrays, mapped read only so the processes using a reference share one copy in the
+//page cache and don't parse anything at startup. The file is little endian and laid out as:
+//
+//  prelude     "#<mothur version>\n" padded with nulls to 48 bytes, so the shortcut version checks work unchanged,
+//              then "MOTHRIDX" and uint32 format version, uint32 unused
+//  sections    the arrays, each starting on a 64 byte boundary
+//  contents    per section 32 byte null padded name, uint64 offset, uint64 bytes
+//  trailer     uint64 offset of the contents, uint64 number of sections
+
+struct ReferenceIndexSection {
+    char name[32];
+    uint64_t offset, bytes;
+};
+/**************************************************************************************************/
+//the string arrays are stored as name.offsets, numStrings+1 uint64, and name, the characters
+struct MappedStrings {
+    const uint64_t* offsets;
+    const char* chars;
+    long long numStrings;
+
+    MappedStrings() : offsets(NULL), chars(NULL), numStrings(0) {}
+    string get(long long i) const { return string(chars + offsets[i], offsets[i+1] - offsets[i]); }
+};
+/**************************************************************************************************/
+//ReferenceIndex maps an index file for reading.
+
+class ReferenceIndex {
+
+public:
+
+    ReferenceIndex(string);
+    ~ReferenceIndex();
+
+    static bool isIndex(string); //true if the file is a reference index
+
+    bool isOpen()           { return (base != NULL);    }
+    string getVersion()     { return version;           }
+
+    bool hasSection(string);
+    const void* getSection(string, long long&); //name, bytes. NULL if the section is missing
+    bool getStrings(string, MappedStrings&);
+
+    //count is the number of T in the section
+    template<class T> const T* getArray(string name, long long& count) {
+        long long bytes = 0;
+        const T* data = (const T*)getSection(name, bytes);
+        count = bytes / sizeof(T);
+        return data;
+    }
+
+private:
+
+    MothurOut* m;
+    string filename, version;
+    const char* base;
+    size_t size;
+    bool mapped;
+    vector<char> data; //file contents when the file can't be mapped
+    map<string, ReferenceIndexSection> sections;
+
+    bool open();
+
+    ReferenceIndex(const ReferenceIndex&);
+    ReferenceIndex& operator=(const ReferenceIndex&);
+};
+/**************************************************************************************************/
+//ReferenceIndexWriter writes the sections as they are added. The file is written under a temp name and renamed when
+//it is closed, so other processes never map a partly written index.
+
+class ReferenceIndexWriter {
+
+public:
+
+    ReferenceIndexWriter(string, string); //filename, mothur version
+    ~ReferenceIndexWriter();
+
+    void addSection(string, const void*, long long); //name, data, bytes
+    template<class T> void addArray(string name, const vector<T>& values) { addSection(name, values.data(), values.size() * sizeof(T)); }
+
+    //sections that are too big to build in memory, like the template sequences, are added a piece at a time
+    void startSection(string);
+    void append(const void*, long long);
+    void endSection();
+
+    bool close();
+
+private:
+
+    MothurOut* m;
+    Utils util;
+    string filename, tempFile;
+    ofstream out;
+    vector<ReferenceIndexSection> sections;
+    bool inSection;
+
+    void pad();
+};
+/**************************************************************************************************/
+
+#endif /* referenceindex_hpp */
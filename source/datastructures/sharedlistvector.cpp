@@ -26,6 +26,7 @@
 SharedListVector::SharedListVector(ifstream& f, vector<string>& userGroups, string& previousLabel, string& labelTag) : DataVector(), maxRank(0), numBins(0), numSeqs(0) {
 	try {
         Utils util;
+        nameTable.reset(new NameTable());
         groups = userGroups; fillGroups = true;
         if (groups.size() > 0) { fillGroups = false; }
         
@@ -97,7 +98,7 @@ SharedListVector::SharedListVector(ifstream& f, vector<string>& userGroups, stri
             
 		}else {  f >> label >> hold; }
         
-		data.assign(hold, "");
+		data.assign(hold, vector<unsigned int>());
 		string inputData = "";
         otuTag = labelTag;
         previousLabel = label;
@@ -117,10 +118,9 @@ SharedListVector::SharedListVector(ifstream& f, vector<string>& userGroups, stri
 /***********************************************************************/
 void SharedListVector::set(int binNumber, string seqNames){
 	try {
-        Utils util;
-		int nNames_old = util.getNumNames(data[binNumber]);
-		data[binNumber] = seqNames;
-		int nNames_new = util.getNumNames(seqNames);
+		int nNames_old = data[binNumber].size();
+        nameTable->getIndexes(seqNames, data[binNumber]);
+		int nNames_new = data[binNumber].size();
 	
 		if(nNames_old == 0)			{	numBins++;				}
 		if(nNames_new == 0)			{	numBins--;				}
@@ -139,7 +139,12 @@ void SharedListVector::set(int binNumber, string seqNames){
 /***********************************************************************/
 
 string SharedListVector::get(int index){
-	return data[index];
+	return nameTable->getNames(data[index]);
+}
+/***********************************************************************/
+
+void SharedListVector::getNames(int index, vector<string>& binNames){
+	nameTable->getNames(data[index], binNames);
 }
 /***********************************************************************/
 
@@ -173,8 +178,9 @@ vector<string> SharedListVector::getLabels(){
 void SharedListVector::push_back(string seqNames){
 	try {
         Utils util;
-		data.push_back(seqNames);
-		int nNames = util.getNumNames(seqNames);
+		data.push_back(vector<unsigned int>());
+        nameTable->getIndexes(seqNames, data.back());
+		int nNames = data.back().size();
 	
 		numBins++;
 	
@@ -247,8 +253,8 @@ void SharedListVector::print(ostream& output){
 		output << label << '\t' << numBins;
 	
 		for(int i=0;i<data.size();i++){
-			if(data[i] != ""){
-				output << '\t' << data[i];
+			if(data[i].size() != 0){
+				output << '\t' << get(i);
 			}
 		}
 		output << endl;
@@ -265,10 +271,8 @@ void SharedListVector::print(ostream& output){
 RAbundVector SharedListVector::getRAbundVector(){
 	try {
 		RAbundVector rav;
-        Utils util;
 		for(int i=0;i<data.size();i++){
-			int binSize = util.getNumNames(data[i]);
-			rav.push_back(binSize);
+			rav.push_back(data[i].size());
 		}
 	
 		rav.setLabel(label);
@@ -286,9 +290,8 @@ RAbundVector SharedListVector::getRAbundVector(){
 SAbundVector SharedListVector::getSAbundVector(){
 	try {
 		SAbundVector sav(maxRank+1);
-        Utils util;
 		for(int i=0;i<data.size();i++){
-			int binSize = util.getNumNames(data[i]);	
+			int binSize = data[i].size();
 			sav.set(binSize, sav.get(binSize) + 1);	
 		}
 		sav.set(0, 0);
@@ -310,9 +313,8 @@ SharedOrderVector* SharedListVector::getSharedOrderVector(){
         Utils util;
 		for(int i=0;i<numBins;i++){
 
-			string names = get(i);
             vector<string> binNames;
-            util.splitAtComma(names, binNames);
+            getNames(i, binNames);
             
 			for (int j = 0; j < binNames.size(); j++) { 
                 if (m->getControl_pressed()) { return order; }
@@ -347,35 +349,48 @@ SharedOrderVector* SharedListVector::getSharedOrderVector(){
 SharedRAbundVectors* SharedListVector::getSharedRAbundVector() {
 	try {
         vector<SharedRAbundVector*> lookup;  //contains just the groups the user selected
-        //vector<string> groups;
-        map<string, SharedRAbundVector*> finder;  //contains all groups in groupmap
-        map<string, SharedRAbundVector*>::iterator it;
+        map<string, int> finder;  //position of the selected groups in lookup
+        map<string, int>::iterator it;
         
 		for (int i = 0; i < groups.size(); i++) {
             SharedRAbundVector* temp = new SharedRAbundVector(numBins);
-            finder[groups[i]] = temp;
-            finder[groups[i]]->setLabel(label);
-            finder[groups[i]]->setGroup(groups[i]);
-            lookup.push_back(finder[groups[i]]);
+            temp->setLabel(label);
+            temp->setGroup(groups[i]);
+            finder[groups[i]] = lookup.size();
+            lookup.push_back(temp);
         }
-        Utils util;
+        
+        //the group of each name, by NameTable index, is looked up the first time the name is seen
+        vector<int> countGroups; //position in lookup of each group of the count table, -1 if it wasn't selected
+        vector<int> nameGroups;
+        if (groupMode != "group") {
+            vector<string> allGroups = countTable->getNamesOfGroups();
+            for (int k = 0; k < allGroups.size(); k++) {
+                it = finder.find(allGroups[k]);
+                if (it != finder.end()) { countGroups.push_back(it->second); }
+                else { countGroups.push_back(-1); }
+            }
+        }else { nameGroups.assign(nameTable->size(), -2); } //-2 not looked up yet, -1 not selected
+        
 		//fill vectors
 		for(int i=0;i<numBins;i++){
-			string names = get(i);  
-			vector<string> binNames;
-            util.splitAtComma(names, binNames);
-            for (int j = 0; j < binNames.size(); j++) { 
+            const vector<unsigned int>& binIndexes = data[i];
+            for (int j = 0; j < binIndexes.size(); j++) {
                 if (groupMode == "group") {
-                    string group = groupmap->getGroup(binNames[j]);
-                    if(group == "not found") {	m->mothurOut("Error: Sequence '" + binNames[j] + "' was not found in the group file, please correct.\n");   exit(1); }
-                    it = finder.find(group);
-                    if (it != finder.end()) { it->second->set(i, it->second->get(i) + 1); } //i represents what bin you are in
+                    int& position = nameGroups[binIndexes[j]];
+                    if (position == -2) {
+                        string name = nameTable->getName(binIndexes[j]);
+                        string group = groupmap->getGroup(name);
+                        if(group == "not found") {	m->mothurOut("Error: Sequence '" + name + "' was not found in the group file, please correct.\n");   exit(1); }
+                        it = finder.find(group);
+                        if (it != finder.end()) { position = it->second; }
+                        else { position = -1; }
+                    }
+                    if (position != -1) { lookup[position]->set(i, lookup[position]->get(i) + 1); } //i represents what bin you are in
                 }else{
-                    vector<int> counts = countTable->getGroupCounts(binNames[j]);
-                    vector<string> allGroups = countTable->getNamesOfGroups();
-                    for (int k = 0; k < allGroups.size(); k++) {
-                        it = finder.find(allGroups[k]);
-                        if (it != finder.end()) { it->second->set(i, it->second->get(i) + counts[k]); } //i represents what bin you are in
+                    vector<int> counts = countTable->getGroupCounts(nameTable->getName(binIndexes[j]));
+                    for (int k = 0; k < counts.size(); k++) {
+                        if (countGroups[k] != -1) { lookup[countGroups[k]]->set(i, lookup[countGroups[k]]->get(i) + counts[k]); } //i represents what bin you are in
                     }
                 }
 			}
@@ -418,9 +433,8 @@ OrderVector SharedListVector::getOrderVector(map<string,int>* orderMap = NULL){
 			OrderVector ov;
 		
 			for(int i=0;i<data.size();i++){
-                string names = data[i];
                 vector<string> binNames;
-                util.splitAtComma(names, binNames);
+                getNames(i, binNames);
 				int binSize = binNames.size();	
                 if (groupMode != "group") {
                     binSize = 0;
@@ -441,9 +455,8 @@ OrderVector SharedListVector::getOrderVector(map<string,int>* orderMap = NULL){
 			OrderVector ov(numSeqs);
 		
 			for(int i=0;i<data.size();i++){
-				string listOTU = data[i];
 				vector<string> binNames;
-                util.splitAtComma(listOTU, binNames);
+                getNames(i, binNames);
                 for (int j = 0; j < binNames.size(); j++) { 
                     if(orderMap->count(binNames[j]) == 0){
                         m->mothurOut(binNames[j] + " not found, check *.names file\n");
@@ -16,13 +16,14 @@
 #include "sharedrabundvectors.hpp"
 #include "sharedrabundfloatvectors.hpp"
 #include "currentfile.h"
+#include "nametable.hpp"
 
 /* This class is a child to datavector.  It represents OTU information at a certain distance. 
 	A sharedlistvector can be converted into a sharedordervector, sharedrabundvector or sharedsabundvectorand 
 	as well as an ordervector, rabundvector or sabundvector.
-	Each member of the internal container "data" represents an individual OTU.
+	Each member of the internal container "data" represents an individual OTU, kept as the NameTable indexes of its names.
 	Each individual in the OTU belongs to a group.
-	So data[0] = "a,b,c,d,e,f".
+	So get(0) = "a,b,c,d,e,f".
 	example: listvector		=	a,b,c,d,e,f		g,h,i		j,k		l		m  
 			 rabundvector	=	6				3			2		1		1
 			 sabundvector	=	2		1		1		0		0		1
@@ -32,7 +33,7 @@ class SharedListVector : public DataVector {
 	
 public:
 	SharedListVector(ifstream&, vector<string>&, string&, string&);
-	SharedListVector(const SharedListVector& lv) : DataVector(lv.label), data(lv.data), maxRank(lv.maxRank), numBins(lv.numBins), numSeqs(lv.numSeqs), binLabels(lv.binLabels), groups(lv.groups), fillGroups(lv.fillGroups), groupMode(lv.groupMode), otuTag(lv.otuTag) { groupmap = NULL; countTable = NULL; };
+	SharedListVector(const SharedListVector& lv) : DataVector(lv.label), data(lv.data), maxRank(lv.maxRank), numBins(lv.numBins), numSeqs(lv.numSeqs), binLabels(lv.binLabels), groups(lv.groups), fillGroups(lv.fillGroups), groupMode(lv.groupMode), otuTag(lv.otuTag), nameTable(lv.nameTable) { groupmap = NULL; countTable = NULL; };
 	~SharedListVector(){ if (groupmap != NULL) { delete groupmap; } if (countTable != NULL) { delete countTable; } };
 	
 	int getNumBins()							{	return numBins;		}
@@ -41,6 +42,7 @@ public:
 
 	void set(int, string);	
 	string get(int);
+    void getNames(int, vector<string>&);
     vector<string> getLabels();
     void setLabels(vector<string>);
 	void push_back(string);
@@ -57,7 +59,7 @@ public:
     SharedRAbundFloatVectors* getSharedRAbundFloatVector(); //returns sharedRabundVectors for all the users groups
 	
 private:
-	vector<string> data;  //data[i] is a list of names of sequences in the ith OTU.
+	vector< vector<unsigned int> > data;  //data[i] is the NameTable indexes of the sequences in the ith OTU.
 	GroupMap* groupmap;
     CountTable* countTable;
     vector<string> groups;
@@ -67,6 +69,7 @@ private:
 	int numSeqs;
     vector<string> binLabels;
     string groupMode, otuTag;
+    std::shared_ptr<NameTable> nameTable; //shared with the copies of the list
 
 };
 
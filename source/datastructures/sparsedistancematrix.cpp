@@ -36,12 +36,9 @@ int SparseDistanceMatrix::updateCellCompliment(ull row, ull col){
     try {
         
         ull vrow = seqVec[row][col].index;
-        ull vcol = 0;
+        ull vcol = findCell(vrow, row); //find the columns entry for this cell as well
         
-        //find the columns entry for this cell as well
-        for (int i = 0; i < seqVec[vrow].size(); i++) {  
-            if (seqVec[vrow][i].index == row) { vcol = i;  break; }  
-        }
+        cellChanged(row, vrow, seqVec[vrow][vcol].dist, seqVec[row][col].dist);
        
         seqVec[vrow][vcol].dist = seqVec[row][col].dist;
         
@@ -59,11 +56,9 @@ int SparseDistanceMatrix::rmCell(ull row, ull col){
         numNodes-=2;
  
         ull vrow = seqVec[row][col].index;
-        ull vcol = 0;
-        
-        //find the columns entry for this cell as well
-        for (int i = 0; i < seqVec[vrow].size(); i++) {  if (seqVec[vrow][i].index == row) { vcol = i;  break; }  }
+        ull vcol = findCell(vrow, row); //find the columns entry for this cell as well
         
+        cellChanged(row, vrow, seqVec[row][col].dist, MOTHURMAX);
         
         seqVec[vrow].erase(seqVec[vrow].begin()+vcol);
         seqVec[row].erase(seqVec[row].begin()+col);
@@ -86,6 +81,8 @@ void SparseDistanceMatrix::addCell(ull row, PDistCell cell){
         seqVec[row].push_back(cell);
         PDistCell temp(row, cell.dist);
         seqVec[cell.index].push_back(temp);
+        
+        cellChanged(row, cell.index, MOTHURMAX, cell.dist);
 	}
 	catch(exception& e) {
 		m->errorOut(e, "SparseDistanceMatrix", "addCell");
@@ -98,15 +95,22 @@ int SparseDistanceMatrix::addCellSorted(ull row, PDistCell cell){
 		numNodes+=2;
 		if(cell.dist < smallDist){ smallDist = cell.dist; }
         
-        seqVec[row].push_back(cell);
         PDistCell temp(row, cell.dist);
-        seqVec[cell.index].push_back(temp);
         
-        sortSeqVec(row);
-        sortSeqVec(cell.index);
+        if (sorted) { //rows are already in order, put the cells where the sort would
+            seqVec[row].insert(lower_bound(seqVec[row].begin(), seqVec[row].end(), cell, compareIndexes), cell);
+            seqVec[cell.index].insert(lower_bound(seqVec[cell.index].begin(), seqVec[cell.index].end(), temp, compareIndexes), temp);
+        }else {
+            seqVec[row].push_back(cell);
+            seqVec[cell.index].push_back(temp);
+            
+            sortSeqVec(row);
+            sortSeqVec(cell.index);
+        }
         
-        int location = -1; //find location of new cell when sorted
-        for (int i = 0; i < seqVec[row].size(); i++) {  if (seqVec[row][i].index == cell.index) { location = i; break; } }
+        cellChanged(row, cell.index, MOTHURMAX, cell.dist);
+        
+        int location = findCell(row, cell.index); //find location of new cell when sorted
         
         return location;
 	}
@@ -120,14 +124,27 @@ int SparseDistanceMatrix::addCellSorted(ull row, PDistCell cell){
 
 ull SparseDistanceMatrix::getSmallestCell(ull& row){
 	try {
-        if (!sorted) { sortSeqVec(); sorted = true; }
+        if (!sorted) { sortSeqVec(); sorted = true; buildHeap(); }
+        
+        for (int i = 0; i < changedRows.size(); i++) { setRowMin(changedRows[i]); }
+        changedRows.clear();
         
         //print();
         
         vector<PDistCellMin> mins;
         smallDist = MOTHURMAX;
+        
+        //only the rows whose smallest distance is close to the heap's smallest can hold one of the mins,
+        //the bound is a little past the distances util.isEqual matches
+        vector<ull> rows;
+        if (heap.size() != 0) {
+            float least = rowMins[heap[0]];
+            findRows(0, least + fabs(least * 0.0011), rows);
+        }
+        sort(rows.begin(), rows.end()); //same order as the scan of every row
        
-        for (int i = 0; i < seqVec.size(); i++) {
+        for (int r = 0; r < rows.size(); r++) {
+            ull i = rows[r];
             for (int j = 0; j < seqVec[i].size(); j++) {
                 
                 if (m->getControl_pressed()) { return smallDist; }
@@ -153,6 +170,8 @@ ull SparseDistanceMatrix::getSmallestCell(ull& row){
 			}
 		}
         
+        if (mins.size() == 0) { row = 0; return 0; } //no distances left
+        
 		util.mothurRandomShuffle(mins);  //randomize the order of the iterators in the mins vector
         
         row = mins[0].row;
@@ -168,6 +187,151 @@ ull SparseDistanceMatrix::getSmallestCell(ull& row){
 	}
 }
 /***********************************************************************/
+//location of the cell for index in row, rows are sorted by index from largest to smallest after the first search
+ull SparseDistanceMatrix::findCell(ull row, ull index){
+    try {
+        if (sorted) {
+            vector<PDistCell>::iterator it = lower_bound(seqVec[row].begin(), seqVec[row].end(), PDistCell(index, 0), compareIndexes);
+            if ((it != seqVec[row].end()) && (it->index == index)) { return (it - seqVec[row].begin()); }
+        }else {
+            for (int i = 0; i < seqVec[row].size(); i++) {  if (seqVec[row][i].index == index) { return i; }  }
+        }
+        
+        return 0;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseDistanceMatrix", "findCell");
+        exit(1);
+    }
+}
+/***********************************************************************/
+
+void SparseDistanceMatrix::buildHeap(){
+    try {
+        ull numRows = seqVec.size();
+        rowMins.assign(numRows, MOTHURMAX);
+        rowChanged.assign(numRows, false);
+        changedRows.clear();
+        heap.resize(numRows); heapLocation.resize(numRows);
+        
+        for (ull i = 0; i < numRows; i++) {
+            for (int j = 0; j < seqVec[i].size(); j++) {
+                if (i < seqVec[i][j].index) { if (seqVec[i][j].dist < rowMins[i]) { rowMins[i] = seqVec[i][j].dist; } }
+                else { break; }
+            }
+            heap[i] = i; heapLocation[i] = i;
+        }
+        
+        for (ull i = numRows/2; i > 0; i--) { moveDown(i-1); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseDistanceMatrix", "buildHeap");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//finds the smallest distance of a row marked by cellChanged again
+void SparseDistanceMatrix::setRowMin(ull row){
+    try {
+        float oldMin = rowMins[row];
+        float newMin = MOTHURMAX;
+        
+        for (int j = 0; j < seqVec[row].size(); j++) {
+            if (row < seqVec[row][j].index) { if (seqVec[row][j].dist < newMin) { newMin = seqVec[row][j].dist; } }
+            else { break; }
+        }
+        
+        rowMins[row] = newMin;
+        rowChanged[row] = false;
+        
+        if (newMin < oldMin) { moveUp(heapLocation[row]); }
+        else { moveDown(heapLocation[row]); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseDistanceMatrix", "setRowMin");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//the distance between row and index went from oldDist to newDist, MOTHURMAX for a cell that is added or removed.
+//The cell is in the smaller index's row min, a smaller distance moves the row up the heap right away, a row that
+//may have lost its smallest distance is found again by the next getSmallestCell.
+void SparseDistanceMatrix::cellChanged(ull row, ull index, float oldDist, float newDist){
+    try {
+        if (!sorted) { return; } //the heap is built with the first search
+        
+        ull lowRow = min(row, index);
+        if (rowChanged[lowRow]) { return; }
+        
+        if (newDist < rowMins[lowRow]) { rowMins[lowRow] = newDist; moveUp(heapLocation[lowRow]); }
+        else if (oldDist <= rowMins[lowRow]) { rowChanged[lowRow] = true; changedRows.push_back(lowRow); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseDistanceMatrix", "cellChanged");
+        exit(1);
+    }
+}
+/***********************************************************************/
+
+void SparseDistanceMatrix::moveUp(ull location){
+    try {
+        ull row = heap[location];
+        
+        while (location > 0) {
+            ull parent = (location - 1) / 2;
+            if (rowMins[heap[parent]] <= rowMins[row]) { break; }
+            
+            heap[location] = heap[parent]; heapLocation[heap[location]] = location;
+            location = parent;
+        }
+        
+        heap[location] = row; heapLocation[row] = location;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseDistanceMatrix", "moveUp");
+        exit(1);
+    }
+}
+/***********************************************************************/
+
+void SparseDistanceMatrix::moveDown(ull location){
+    try {
+        ull row = heap[location];
+        ull numRows = heap.size();
+        
+        while ((2 * location + 1) < numRows) {
+            ull child = 2 * location + 1;
+            if (((child + 1) < numRows) && (rowMins[heap[child+1]] < rowMins[heap[child]])) { child++; }
+            if (rowMins[row] <= rowMins[heap[child]]) { break; }
+            
+            heap[location] = heap[child]; heapLocation[heap[location]] = location;
+            location = child;
+        }
+        
+        heap[location] = row; heapLocation[row] = location;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseDistanceMatrix", "moveDown");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//rows under location in the heap whose smallest distance is at most bound, a row's children are never smaller
+void SparseDistanceMatrix::findRows(ull location, float bound, vector<ull>& rows){
+    try {
+        if (location >= heap.size()) { return; }
+        if (rowMins[heap[location]] > bound) { return; }
+        
+        rows.push_back(heap[location]);
+        findRows(2 * location + 1, bound, rows);
+        findRows(2 * location + 2, bound, rows);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseDistanceMatrix", "findRows");
+        exit(1);
+    }
+}
+/***********************************************************************/
 
 void SparseDistanceMatrix::print(){
     try {
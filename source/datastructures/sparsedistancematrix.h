@@ -45,6 +45,23 @@ private:
     int sortSeqVec(int);
 	float smallDist, aboveCutoff;
     
+    //the smallest distance of each row to the larger indexes, kept in an indexed min heap so getSmallestCell
+    //only looks at the rows that hold the smallest distance. Built with the first sort, rows whose smallest
+    //distance grows or is removed are marked and found again before the next search.
+    vector<float> rowMins;
+    vector<ull> heap;
+    vector<ull> heapLocation;
+    vector<ull> changedRows;
+    vector<bool> rowChanged;
+    
+    ull findCell(ull, ull);
+    void buildHeap();
+    void setRowMin(ull);
+    void cellChanged(ull, ull, float, float);
+    void moveUp(ull);
+    void moveDown(ull);
+    void findRows(ull, float, vector<ull>&);
+    
 	MothurOut* m;
     Utils util;
 
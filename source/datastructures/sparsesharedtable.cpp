@@ -0,0 +1,688 @@
+//
+//  sparsesharedtable.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "sparsesharedtable.hpp"
+#include "currentfile.h"
+
+#ifdef USE_BOOST
+    #include <zlib.h>
+#endif
+
+/**************************************************************************************************/
+SparseSharedTable::SparseSharedTable(string l, vector<string> g, int n, vector<uint64_t>& r, vector<uint32_t>& o, vector<int>& c) : label(l), otuTag("Otu"), groups(g), numOtus(n) {
+    try {
+        m = MothurOut::getInstance();
+        own(r, o, c);
+        sortRows();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedTable", "SparseSharedTable");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+SparseSharedTable::SparseSharedTable(string l, vector<string> g, int n, const uint64_t* r, const uint32_t* o, const int* c, std::shared_ptr<ReferenceIndex> file) : label(l), otuTag("Otu"), groups(g), numOtus(n), rowStarts(r), otus(o), counts(c), mapping(file) {
+    try {
+        m = MothurOut::getInstance();
+        sortRows();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedTable", "SparseSharedTable");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+SparseSharedTable::SparseSharedTable(const SparseSharedTable& table) : label(table.label), otuTag(table.otuTag), groups(table.groups), otuNames(table.otuNames), numOtus(table.numOtus), rowStarts(table.rowStarts), otus(table.otus), counts(table.counts), ownRowStarts(table.ownRowStarts), ownOtus(table.ownOtus), ownCounts(table.ownCounts), mapping(table.mapping) {
+    m = MothurOut::getInstance();
+    if (ownRowStarts.size() != 0) { rowStarts = ownRowStarts.data(); otus = ownOtus.data(); counts = ownCounts.data(); }
+}
+/**************************************************************************************************/
+void SparseSharedTable::own(vector<uint64_t>& r, vector<uint32_t>& o, vector<int>& c) {
+    ownRowStarts.swap(r); ownOtus.swap(o); ownCounts.swap(c);
+    rowStarts = ownRowStarts.data(); otus = ownOtus.data(); counts = ownCounts.data();
+    mapping.reset();
+    columnStarts.clear(); columnGroups.clear(); columnCounts.clear();
+}
+/**************************************************************************************************/
+//the rows are in group order like the lookups of SharedRAbundVectors, make.shared writes them that way so a mapped
+//table is almost never copied
+void SparseSharedTable::sortRows() {
+    try {
+        bool sorted = true;
+        for (int i = 1; i < groups.size(); i++) { if (groups[i] < groups[i-1]) { sorted = false; break; } }
+        if (sorted) { return; }
+
+        vector< pair<string, int> > order;
+        for (int i = 0; i < groups.size(); i++) { order.push_back(make_pair(groups[i], i)); }
+        sort(order.begin(), order.end());
+
+        vector<uint64_t> newRowStarts(1, 0); vector<uint32_t> newOtus; vector<int> newCounts;
+        newOtus.reserve(rowStarts[groups.size()]); newCounts.reserve(rowStarts[groups.size()]);
+        for (int i = 0; i < order.size(); i++) {
+            int row = order[i].second;
+            groups[i] = order[i].first;
+            newOtus.insert(newOtus.end(), otus+rowStarts[row], otus+rowStarts[row+1]);
+            newCounts.insert(newCounts.end(), counts+rowStarts[row], counts+rowStarts[row+1]);
+            newRowStarts.push_back(newOtus.size());
+        }
+        own(newRowStarts, newOtus, newCounts);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedTable", "sortRows");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+vector<string> SparseSharedTable::getOTUNames() {
+    try {
+        util.getOTUNames(otuNames, numOtus, otuTag);
+        return otuNames;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedTable", "getOTUNames");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+string SparseSharedTable::getOTUName(int bin) {
+    try {
+        if (otuNames.size() <= bin) { util.getOTUNames(otuNames, numOtus, otuTag); }
+        return otuNames[bin];
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedTable", "getOTUName");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void SparseSharedTable::setOTUNames(vector<string> names, string tag) {
+    try {
+        otuNames = names; otuTag = tag;
+        util.getOTUNames(otuNames, numOtus, otuTag);
+        if (otuNames.size() > numOtus) { otuNames.resize(numOtus); } //a later label with fewer OTUs than the first
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedTable", "setOTUNames");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void SparseSharedTable::makeColumns() {
+    try {
+        long long numNonZero = rowStarts[groups.size()];
+
+        columnStarts.assign(numOtus+1, 0);
+        for (long long k = 0; k < numNonZero; k++) { columnStarts[otus[k]+1]++; }
+        for (int j = 0; j < numOtus; j++) { columnStarts[j+1] += columnStarts[j]; }
+
+        columnGroups.resize(numNonZero); columnCounts.resize(numNonZero);
+        vector<uint64_t> next(columnStarts.begin(), columnStarts.end()-1);
+        for (int i = 0; i < groups.size(); i++) {
+            for (uint64_t k = rowStarts[i]; k < rowStarts[i+1]; k++) {
+                uint64_t position = next[otus[k]]++;
+                columnGroups[position] = i; columnCounts[position] = counts[k];
+            }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedTable", "makeColumns");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+SparseSharedVector SparseSharedTable::getColumn(int bin) {
+    if (columnStarts.size() == 0) { makeColumns(); }
+    return SparseSharedVector(columnGroups.data()+columnStarts[bin], columnCounts.data()+columnStarts[bin], columnStarts[bin+1]-columnStarts[bin]);
+}
+/**************************************************************************************************/
+int SparseSharedTable::get(int group, int bin) {
+    const uint32_t* start = otus+rowStarts[group];
+    const uint32_t* end = otus+rowStarts[group+1];
+    const uint32_t* found = lower_bound(start, end, (uint32_t)bin);
+
+    if ((found == end) || (*found != bin)) { return 0; }
+    return counts[found-otus];
+}
+/**************************************************************************************************/
+int SparseSharedTable::getRowTotal(int group) {
+    int total = 0;
+    for (uint64_t k = rowStarts[group]; k < rowStarts[group+1]; k++) { total += counts[k]; }
+    return total;
+}
+/**************************************************************************************************/
+int SparseSharedTable::getColumnTotal(int bin) {
+    SparseSharedVector column = getColumn(bin);
+    int total = 0;
+    for (int k = 0; k < column.size; k++) { total += column.counts[k]; }
+    return total;
+}
+/**************************************************************************************************/
+vector<int> SparseSharedTable::getRowTotals() {
+    vector<int> totals(groups.size(), 0);
+    for (int i = 0; i < groups.size(); i++) { totals[i] = getRowTotal(i); }
+    return totals;
+}
+/**************************************************************************************************/
+vector<int> SparseSharedTable::getColumnTotals() {
+    vector<int> totals(numOtus, 0);
+    long long numNonZero = rowStarts[groups.size()];
+    for (long long k = 0; k < numNonZero; k++) { totals[otus[k]] += counts[k]; }
+    return totals;
+}
+/**************************************************************************************************/
+bool SparseSharedTable::selectGroups(vector<string>& userGroups) {
+    try {
+        if (userGroups.size() == 0) { userGroups = groups; return false; } //user has not specified groups, so we will use all of them
+
+        set<string> keep(userGroups.begin(), userGroups.end());
+        vector<int> rows;
+        for (int i = 0; i < groups.size(); i++) { if (keep.count(groups[i]) != 0) { rows.push_back(i); } }
+
+        if (rows.size() == groups.size()) { return false; }
+
+        vector<string> newGroups;
+        vector<uint64_t> newRowStarts(1, 0); vector<uint32_t> newOtus; vector<int> newCounts;
+        for (int i = 0; i < rows.size(); i++) {
+            newGroups.push_back(groups[rows[i]]);
+            newOtus.insert(newOtus.end(), otus+rowStarts[rows[i]], otus+rowStarts[rows[i]+1]);
+            newCounts.insert(newCounts.end(), counts+rowStarts[rows[i]], counts+rowStarts[rows[i]+1]);
+            newRowStarts.push_back(newOtus.size());
+        }
+        groups = newGroups;
+        own(newRowStarts, newOtus, newCounts);
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedTable", "selectGroups");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void SparseSharedTable::eliminateZeroOTUs() {
+    try {
+        if (groups.size() <= 1) { return; }
+
+        vector<int> totals = getColumnTotals();
+        vector<int> otusToRemove;
+        for (int i = 0; i < numOtus; i++) { if (totals[i] == 0) { otusToRemove.push_back(i); } } //sorted order
+
+        removeOTUs(otusToRemove);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedTable", "eliminateZeroOTUs");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void SparseSharedTable::removeOTUs(vector<int> bins) {
+    try {
+        if (bins.size() == 0) { return; }
+
+        getOTUNames(); //fills the names we are about to remove some of
+
+        vector<int> newBin(numOtus, 0);
+        for (int i = 0; i < bins.size(); i++) { newBin[bins[i]] = -1; }
+
+        vector<string> newNames; int numKept = 0;
+        for (int j = 0; j < numOtus; j++) {
+            if (newBin[j] == -1) { continue; }
+            newBin[j] = numKept++;
+            newNames.push_back(otuNames[j]);
+        }
+
+        vector<uint64_t> newRowStarts(1, 0); vector<uint32_t> newOtus; vector<int> newCounts;
+        newOtus.reserve(rowStarts[groups.size()]); newCounts.reserve(rowStarts[groups.size()]);
+        for (int i = 0; i < groups.size(); i++) {
+            for (uint64_t k = rowStarts[i]; k < rowStarts[i+1]; k++) {
+                if (newBin[otus[k]] == -1) { continue; }
+                newOtus.push_back(newBin[otus[k]]); newCounts.push_back(counts[k]);
+            }
+            newRowStarts.push_back(newOtus.size());
+        }
+
+        numOtus = numKept;
+        otuNames = newNames;
+        own(newRowStarts, newOtus, newCounts);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedTable", "removeOTUs");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void SparseSharedTable::push_back(vector<int> abunds, string binLabel) {
+    try {
+        if (abunds.size() != groups.size()) {  m->mothurOut("[ERROR]: you have provided " + toString(abunds.size()) + " abundances, but mothur was expecting " + toString(groups.size()) + ", please correct.\n"); m->setControl_pressed(true); return; }
+
+        getOTUNames();
+
+        vector<uint64_t> newRowStarts(1, 0); vector<uint32_t> newOtus; vector<int> newCounts;
+        for (int i = 0; i < groups.size(); i++) {
+            newOtus.insert(newOtus.end(), otus+rowStarts[i], otus+rowStarts[i+1]);
+            newCounts.insert(newCounts.end(), counts+rowStarts[i], counts+rowStarts[i+1]);
+            if (abunds[i] != 0) { newOtus.push_back(numOtus); newCounts.push_back(abunds[i]); }
+            newRowStarts.push_back(newOtus.size());
+        }
+
+        numOtus++;
+        otuNames.push_back(binLabel);
+        own(newRowStarts, newOtus, newCounts);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedTable", "push_back");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+SharedRAbundVectors* SparseSharedTable::getSharedRAbundVectors() {
+    try {
+        SharedRAbundVectors* lookup = new SharedRAbundVectors();
+
+        for (int i = 0; i < groups.size(); i++) {
+            vector<int> abunds(numOtus, 0);
+            for (uint64_t k = rowStarts[i]; k < rowStarts[i+1]; k++) { abunds[otus[k]] = counts[k]; }
+
+            SharedRAbundVector* temp = new SharedRAbundVector(abunds);
+            temp->setLabel(label); temp->setGroup(groups[i]);
+            lookup->push_back(temp);
+        }
+        lookup->setOTUNames(getOTUNames());
+
+        return lookup;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedTable", "getSharedRAbundVectors");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void SparseSharedTable::print(ostream& output, bool& printOTUHeaders) {
+    try {
+        if (printOTUHeaders) {
+            getOTUNames();
+
+            output << "label\tGroup\tnumOtus";
+            for (int j = 0; j < numOtus; j++) { output  << '\t' << otuNames[j]; } output << endl;
+
+            printOTUHeaders = false;
+        }
+
+        vector<int> abunds(numOtus, 0);
+        for (int i = 0; i < groups.size(); i++) {
+            if (m->getControl_pressed()) { break; }
+
+            for (uint64_t k = rowStarts[i]; k < rowStarts[i+1]; k++) { abunds[otus[k]] = counts[k]; }
+
+            output << label << '\t' << groups[i] << '\t' << numOtus;
+            for (int j = 0; j < numOtus; j++) { output << '\t' << abunds[j]; }
+            output << '\n';
+
+            for (uint64_t k = rowStarts[i]; k < rowStarts[i+1]; k++) { abunds[otus[k]] = 0; }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedTable", "print");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+static long long getFileBytes(string filename) {
+    ifstream in(filename.c_str(), ios::binary | ios::ate);
+    if (!in) { return -1; }
+    return (long long)in.tellg();
+}
+/**************************************************************************************************/
+//the next whitespace separated word, word is "" at the end of the line
+static const char* nextWord(const char* position, string& word) {
+    while (isspace(*position)) { position++; }
+    const char* start = position;
+    while ((*position != '\0') && !isspace(*position)) { position++; }
+    word.assign(start, position-start);
+    return position;
+}
+/**************************************************************************************************/
+//the numOtus counts of a line, the nonzero ones go on the end of otus and counts. False if the line is short
+static bool parseCounts(const char* position, int numOtus, vector<uint32_t>& otus, vector<int>& counts) {
+    for (int i = 0; i < numOtus; i++) {
+        char* end;
+        long count = strtol(position, &end, 10);
+        if (end == position) { return false; }
+        position = end;
+        while ((*position != '\0') && !isspace(*position)) { position++; }
+
+        if (count != 0) { otus.push_back(i); counts.push_back(count); }
+    }
+    return true;
+}
+/**************************************************************************************************/
+static void addStrings(ReferenceIndexWriter& file, string name, const vector<string>& strings) {
+    vector<uint64_t> offsets(1, 0);
+    file.startSection(name);
+    for (int i = 0; i < strings.size(); i++) {
+        file.append(strings[i].c_str(), strings[i].length());
+        offsets.push_back(offsets.back() + strings[i].length());
+    }
+    file.endSection();
+    file.addArray(name + ".offsets", offsets);
+}
+/**************************************************************************************************/
+static void addDeflated(ReferenceIndexWriter& file, string name, const void* data, long long bytes) {
+#ifdef USE_BOOST
+    uLongf deflatedBytes = compressBound(bytes);
+    vector<char> deflated(8 + deflatedBytes);
+    uint64_t inflatedBytes = bytes; memcpy(&deflated[0], &inflatedBytes, 8);
+
+    if (compress2((Bytef*)&deflated[8], &deflatedBytes, (const Bytef*)data, bytes, Z_DEFAULT_COMPRESSION) == Z_OK) {
+        file.addSection(name + ".z", &deflated[0], 8 + deflatedBytes);
+        return;
+    }
+#endif
+    file.addSection(name, data, bytes); //no zlib, saved as is
+}
+/**************************************************************************************************/
+SparseSharedFile::SparseSharedFile(string f, bool deflate) : filename(f) {
+    try {
+        m = MothurOut::getInstance();
+
+        if (filename == "") { return; }
+
+        filename = util.getFullPathName(filename);
+        long long bytes = getFileBytes(filename);
+        if (bytes < 0) { return; }
+
+        string sparseFileName = filename + ".sparse";
+        if (open(sparseFileName, bytes)) { return; }
+
+        clear();
+        if (!build(sparseFileName, bytes, deflate)) { clear(); }
+        else if (tables.size() == 0) { clear(); open(sparseFileName, bytes); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedFile", "SparseSharedFile");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+SparseSharedFile::~SparseSharedFile() { clear(); }
+/**************************************************************************************************/
+void SparseSharedFile::clear() {
+    labels.clear(); otuNames.clear(); numOtus.clear(); offsets.clear(); positions.clear(); index.reset();
+    for (int i = 0; i < tables.size(); i++) { delete tables[i]; }
+    tables.clear();
+}
+/**************************************************************************************************/
+void SparseSharedFile::write(string filename, bool deflate) {
+    try {
+        removeCopy(filename); //a rewrite in the same second as the old copy would look current
+        SparseSharedFile file(filename, deflate);
+    }
+    catch(exception& e) {
+        MothurOut::getInstance()->errorOut(e, "SparseSharedFile", "write");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void SparseSharedFile::removeCopy(string filename) {
+    try {
+        Utils util;
+        remove((util.getFullPathName(filename) + ".sparse").c_str());
+    }
+    catch(exception& e) {
+        MothurOut::getInstance()->errorOut(e, "SparseSharedFile", "removeCopy");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+int SparseSharedFile::find(string label) {
+    map<string, int>::iterator it = positions.find(label);
+    if (it == positions.end()) { return -1; }
+    return it->second;
+}
+/**************************************************************************************************/
+bool SparseSharedFile::open(string sparseFileName, long long bytes) {
+    try {
+        if (!ReferenceIndex::isIndex(sparseFileName)) { return false; }
+        if (util.getTimeStamp(sparseFileName) < util.getTimeStamp(filename)) { return false; }
+
+        std::shared_ptr<ReferenceIndex> file(new ReferenceIndex(sparseFileName));
+        if (!file->isOpen()) { return false; }
+
+        long long count = 0;
+        const uint64_t* source = file->getArray<uint64_t>("source", count);
+        if ((source == NULL) || (count != 1) || (source[0] != bytes)) { return false; }
+
+        MappedStrings mappedLabels, mappedNames;
+        if (!file->getStrings("labels", mappedLabels) || !file->getStrings("otuNames", mappedNames)) { return false; }
+
+        const uint32_t* labelOtus = file->getArray<uint32_t>("numOtus", count);
+        if ((labelOtus == NULL) || (count != mappedLabels.numStrings)) { return false; }
+
+        const uint64_t* labelOffsets = file->getArray<uint64_t>("offsets", count);
+        if ((labelOffsets == NULL) || (count != mappedLabels.numStrings)) { return false; }
+
+        for (long long i = 0; i < mappedNames.numStrings; i++) { otuNames.push_back(mappedNames.get(i)); }
+        for (long long i = 0; i < mappedLabels.numStrings; i++) {
+            labels.push_back(mappedLabels.get(i)); numOtus.push_back(labelOtus[i]); offsets.push_back(labelOffsets[i]);
+            if (positions.count(labels.back()) == 0) { positions[labels.back()] = i; }
+        }
+
+        if (!matches(*file, bytes)) {
+            m->mothurOut("[WARNING]: " + filename + " does not match its sparse copy, rebuilding it.\n");
+            clear(); return false;
+        }
+        index = file;
+
+        return (labels.size() != 0);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedFile", "open");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//the first line of each label has to be where the copy says it is, with the label and first group the copy has. An
+//edit that keeps the size and timestamp of the file moves or changes one of them
+bool SparseSharedFile::matches(ReferenceIndex& file, long long bytes) {
+    try {
+        ifstream in(filename.c_str(), ios::binary);
+        if (!in) { return false; }
+
+        string line, label, group;
+        for (int i = 0; i < labels.size(); i++) {
+            MappedStrings mappedGroups;
+            if (!file.getStrings("groups." + toString(i), mappedGroups) || (mappedGroups.numStrings == 0) || (offsets[i] >= (uint64_t)bytes)) { return false; }
+
+            in.seekg(offsets[i]);
+            if (!std::getline(in, line)) { return false; }
+
+            const char* position = nextWord(line.c_str(), label);
+            nextWord(position, group);
+            if ((label != labels[i]) || (group != mappedGroups.get(0))) { return false; }
+        }
+        in.close();
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedFile", "matches");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//one pass over the text, each label's table is saved as soon as its last group is read
+bool SparseSharedFile::build(string sparseFileName, long long bytes, bool deflate) {
+    try {
+        ifstream in(filename.c_str(), ios::binary);
+        if (!in) { return false; }
+
+        ReferenceIndexWriter* indexFile = NULL;
+        bool canSave = true;
+#ifdef NON_WINDOWS
+        string path = util.hasPath(sparseFileName); if (path == "") { path = "."; }
+        canSave = (access(path.c_str(), W_OK) == 0);
+#endif
+        if (canSave) { indexFile = new ReferenceIndexWriter(sparseFileName, CurrentFile::getInstance()->getVersion()); }
+
+        string line, label, group, num, blockLabel = "";
+        int blockOtus = 0;
+        vector<string> groups;
+        vector<uint64_t> rowStarts(1, 0); vector<uint32_t> otus; vector<int> counts;
+        bool firstLine = true;
+        long long offset = 0;
+
+        while (std::getline(in, line)) {
+            if (m->getControl_pressed()) { delete indexFile; clear(); return false; }
+
+            long long lineOffset = offset;
+            offset += line.length() + 1;
+
+            const char* position = nextWord(line.c_str(), label);
+            if (label == "") { continue; }
+
+            if (firstLine) {
+                firstLine = false;
+                if (label == "label") { //headers
+                    position = nextWord(position, group); position = nextWord(position, num);
+                    for (position = nextWord(position, num); num != ""; position = nextWord(position, num)) { otuNames.push_back(num); }
+                    continue;
+                }
+            }
+
+            if ((label != blockLabel) && (groups.size() != 0)) { add(indexFile, blockLabel, groups, blockOtus, rowStarts, otus, counts, deflate); }
+
+            position = nextWord(position, group); position = nextWord(position, num);
+            if (groups.size() == 0) { //the groups are read with the first group's numOtus, like SharedRAbundVectors
+                blockLabel = label; blockOtus = atoi(num.c_str()); offsets.push_back(lineOffset);
+            }
+
+            groups.push_back(group);
+            if (!parseCounts(position, blockOtus, otus, counts)) {
+                m->mothurOut("[ERROR]: " + filename + " is malformed, group " + group + " of label " + label + " has fewer than " + toString(blockOtus) + " OTU counts.\n");
+                m->setControl_pressed(true); delete indexFile; clear(); return false;
+            }
+            rowStarts.push_back(otus.size());
+        }
+        in.close();
+        if (groups.size() != 0) { add(indexFile, blockLabel, groups, blockOtus, rowStarts, otus, counts, deflate); }
+
+        if (indexFile == NULL) { return (labels.size() != 0); }
+
+        vector<uint64_t> source(1, bytes);
+        indexFile->addArray("source", source);
+        addStrings(*indexFile, "labels", labels);
+        addStrings(*indexFile, "otuNames", otuNames);
+        indexFile->addArray("numOtus", numOtus);
+        indexFile->addArray("offsets", offsets);
+
+        bool good = indexFile->close();
+        delete indexFile;
+
+        return good;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedFile", "build");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//saves the label's table, or keeps it if there is no file to save it in, and clears the arrays for the next label
+void SparseSharedFile::add(ReferenceIndexWriter* indexFile, string label, vector<string>& groups, int otuCount, vector<uint64_t>& rowStarts, vector<uint32_t>& otus, vector<int>& counts, bool deflate) {
+    try {
+        string position = toString(labels.size());
+
+        if (positions.count(label) == 0) { positions[label] = labels.size(); }
+        labels.push_back(label); numOtus.push_back(otuCount);
+
+        if (indexFile == NULL) { tables.push_back(new SparseSharedTable(label, groups, otuCount, rowStarts, otus, counts)); }
+        else {
+            addStrings(*indexFile, "groups." + position, groups);
+            indexFile->addArray("rows." + position, rowStarts);
+            if (deflate) {
+                addDeflated(*indexFile, "otus." + position, otus.data(), otus.size() * sizeof(uint32_t));
+                addDeflated(*indexFile, "counts." + position, counts.data(), counts.size() * sizeof(int));
+            }else {
+                indexFile->addArray("otus." + position, otus);
+                indexFile->addArray("counts." + position, counts);
+            }
+        }
+
+        groups.clear(); rowStarts.assign(1, 0); otus.clear(); counts.clear();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedFile", "add");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+bool SparseSharedFile::inflate(string name, vector<char>& inflated) {
+    try {
+#ifdef USE_BOOST
+        long long bytes = 0;
+        const char* data = (const char*)index->getSection(name + ".z", bytes);
+        if ((data == NULL) || (bytes < 8)) { return false; }
+
+        uint64_t inflatedBytes; memcpy(&inflatedBytes, data, 8);
+        inflated.resize(inflatedBytes);
+        if (inflatedBytes == 0) { return true; }
+
+        uLongf outBytes = inflatedBytes;
+        return ((uncompress((Bytef*)&inflated[0], &outBytes, (const Bytef*)(data+8), bytes-8) == Z_OK) && (outBytes == inflatedBytes));
+#else
+        m->mothurOut("[ERROR]: " + filename + ".sparse was saved deflated and this mothur was built without zlib, please remove it so mothur can rebuild it.\n");
+        return false;
+#endif
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedFile", "inflate");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+SparseSharedTable* SparseSharedFile::getTable(int i) {
+    try {
+        if ((i < 0) || (i >= labels.size())) { return NULL; }
+        if (!index) { return new SparseSharedTable(*tables[i]); }
+
+        string position = toString(i);
+        MappedStrings mappedGroups;
+        long long numRows = 0, numCounts = 0, numOtuIndexes = 0;
+        const uint64_t* rowStarts = index->getArray<uint64_t>("rows." + position, numRows);
+
+        if (!index->getStrings("groups." + position, mappedGroups) || (rowStarts == NULL) || (numRows != (mappedGroups.numStrings+1))) {
+            m->mothurOut("[ERROR]: " + filename + ".sparse is damaged, please remove it so mothur can rebuild it.\n"); m->setControl_pressed(true); return NULL;
+        }
+
+        vector<string> groups;
+        for (long long j = 0; j < mappedGroups.numStrings; j++) { groups.push_back(mappedGroups.get(j)); }
+
+        if (index->hasSection("otus." + position)) {
+            const uint32_t* otus = index->getArray<uint32_t>("otus." + position, numOtuIndexes);
+            const int* counts = index->getArray<int>("counts." + position, numCounts);
+            if ((otus == NULL) || (counts == NULL) || (numOtuIndexes != numCounts) || (rowStarts[numRows-1] != numCounts)) {
+                m->mothurOut("[ERROR]: " + filename + ".sparse is damaged, please remove it so mothur can rebuild it.\n"); m->setControl_pressed(true); return NULL;
+            }
+            return new SparseSharedTable(labels[i], groups, numOtus[i], rowStarts, otus, counts, index);
+        }
+
+        vector<char> otuBytes, countBytes;
+        if (!inflate("otus." + position, otuBytes) || !inflate("counts." + position, countBytes) || (otuBytes.size() != countBytes.size()) || (rowStarts[numRows-1] != (otuBytes.size() / sizeof(uint32_t)))) {
+            m->mothurOut("[ERROR]: could not read " + labels[i] + " from " + filename + ".sparse.\n"); m->setControl_pressed(true); return NULL;
+        }
+
+        vector<uint64_t> rows(rowStarts, rowStarts+numRows);
+        vector<uint32_t> otus(otuBytes.size() / sizeof(uint32_t)); vector<int> counts(countBytes.size() / sizeof(int));
+        if (otus.size() != 0) { memcpy(&otus[0], &otuBytes[0], otuBytes.size()); memcpy(&counts[0], &countBytes[0], countBytes.size()); }
+
+        return new SparseSharedTable(labels[i], groups, numOtus[i], rows, otus, counts);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SparseSharedFile", "getTable");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
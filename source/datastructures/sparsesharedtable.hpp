@@ -0,0 +1,153 @@
+//
+//  sparsesharedtable.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef sparsesharedtable_hpp
+#define sparsesharedtable_hpp
+
+#include "mothur.h"
+#include "utils.hpp"
+#include "referenceindex.hpp"
+#include "sharedrabundvectors.hpp"
+#include <memory>
+
+/**************************************************************************************************/
+//a row or column of a SparseSharedTable, the nonzero counts and the OTUs (or groups) they are in, in order. The
+//pointers point into the table, so a view is only good while the table is
+struct SparseSharedVector {
+    const uint32_t* indexes;
+    const int* counts;
+    int size;
+
+    SparseSharedVector() : indexes(NULL), counts(NULL), size(0) {}
+    SparseSharedVector(const uint32_t* i, const int* c, int s) : indexes(i), counts(c), size(s) {}
+};
+/**************************************************************************************************/
+//SparseSharedTable is one label of a shared file kept as compressed sparse rows, a row per group in group order like
+//the lookups of SharedRAbundVectors. Only the nonzero counts are stored:
+//
+//  rowStarts   numGroups+1, the nonzero counts of group i are rowStarts[i] to rowStarts[i+1]
+//  otus        the OTU of each count, increasing in a row
+//  counts      the counts
+//
+//The arrays are either the table's own or point into a mapped SparseSharedFile, the table keeps the file mapped for
+//as long as it needs it. The columns are made the first time one is asked for, the same three arrays by OTU.
+
+class SparseSharedTable {
+
+public:
+
+    SparseSharedTable(string, vector<string>, int, vector<uint64_t>&, vector<uint32_t>&, vector<int>&); //label, groups, numOtus, rowStarts, otus, counts. The arrays are swapped into the table
+    SparseSharedTable(string, vector<string>, int, const uint64_t*, const uint32_t*, const int*, std::shared_ptr<ReferenceIndex>); //label, groups, numOtus, rowStarts, otus, counts in the mapped file
+    SparseSharedTable(const SparseSharedTable&);
+    ~SparseSharedTable() {}
+
+    string getLabel()                       { return label;                 }
+    int getNumGroups()                      { return groups.size();         }
+    int getNumOtus()                        { return numOtus;               }
+    long long getNumNonZero()               { return rowStarts[groups.size()]; }
+    vector<string> getGroups()              { return groups;                }
+    string getGroup(int i)                  { return groups[i];             }
+    string getOTUTag()                      { return otuTag;                }
+
+    vector<string> getOTUNames();
+    string getOTUName(int);
+    void setOTUNames(vector<string>, string); //names, otuTag. Missing names are made like SharedRAbundVectors does
+
+    SparseSharedVector getRow(int i) { return SparseSharedVector(otus+rowStarts[i], counts+rowStarts[i], rowStarts[i+1]-rowStarts[i]); }
+    SparseSharedVector getColumn(int);
+    int get(int, int); //group, otu
+    int getRowTotal(int);
+    int getColumnTotal(int);
+    vector<int> getRowTotals();
+    vector<int> getColumnTotals();
+
+    bool selectGroups(vector<string>&); //keeps the rows of the groups, fills groups with all of them if it is empty. True if rows were left out
+    void eliminateZeroOTUs();           //only when there is more than one group, like SharedRAbundVectors
+    void removeOTUs(vector<int>);       //sorted bins
+    void push_back(vector<int>, string); //count for each group, OTU name
+
+    SharedRAbundVectors* getSharedRAbundVectors(); //dense copy, for the code that still wants one
+    void print(ostream&, bool&);        //same as SharedRAbundVectors::print
+
+private:
+
+    MothurOut* m;
+    Utils util;
+    string label, otuTag;
+    vector<string> groups, otuNames;
+    int numOtus;
+
+    const uint64_t* rowStarts;
+    const uint32_t* otus;
+    const int* counts;
+    vector<uint64_t> ownRowStarts;
+    vector<uint32_t> ownOtus;
+    vector<int> ownCounts;
+    std::shared_ptr<ReferenceIndex> mapping;
+
+    vector<uint64_t> columnStarts;
+    vector<uint32_t> columnGroups;
+    vector<int> columnCounts;
+
+    void own(vector<uint64_t>&, vector<uint32_t>&, vector<int>&);
+    void sortRows();
+    void makeColumns();
+};
+/**************************************************************************************************/
+//SparseSharedFile is the binary copy of a shared file, saved next to it as <file>.sparse in the ReferenceIndex
+//container so the tables are mapped instead of parsed. The sections are
+//
+//  source                  uint64 bytes of the shared file, the copy is rebuilt if they change or the file is newer
+//  labels, otuNames        strings, otuNames are the headers of the shared file, empty if it has none
+//  numOtus                 uint32 per label
+//  offsets                 uint64 per label, where its first line starts in the shared file. The copy is rebuilt if
+//                          the label and first group aren't there, an edit that kept the size and timestamp
+//  groups.<i>              strings, the groups of label i in file order
+//  rows.<i>, otus.<i>, counts.<i>      the arrays of label i's SparseSharedTable
+//
+//otus.<i> and counts.<i> may be written deflated as otus.<i>.z and counts.<i>.z, a uint64 of the inflated bytes
+//followed by the deflate stream. Deflated tables are inflated when they are read instead of mapped, and need a
+//mothur built with zlib. If the copy can't be saved the tables are kept in memory.
+
+class SparseSharedFile {
+
+public:
+
+    SparseSharedFile(string, bool deflate = false); //shared filename. Maps filename.sparse, or builds it
+    ~SparseSharedFile();
+
+    static void write(string, bool); //shared filename, deflate
+    static void removeCopy(string);  //shared filename
+
+    int getNumLabels()                      { return labels.size();     }
+    string getLabel(int i)                  { return labels[i];         }
+    int find(string);                       //position of the label, -1 if the file doesn't have it
+    vector<string> getOTUNames()            { return otuNames;          }
+    SparseSharedTable* getTable(int);       //all the groups of the label, in group order
+
+private:
+
+    MothurOut* m;
+    Utils util;
+    string filename;
+    vector<string> labels, otuNames;
+    vector<uint32_t> numOtus; //per label
+    vector<uint64_t> offsets; //per label, of its first line
+    map<string, int> positions;
+    std::shared_ptr<ReferenceIndex> index;
+    vector<SparseSharedTable*> tables; //when the copy can't be saved
+
+    bool open(string, long long);           //sparse filename, shared file bytes
+    bool matches(ReferenceIndex&, long long); //mapped copy, shared file bytes
+    bool build(string, long long, bool);    //sparse filename, shared file bytes, deflate
+    void add(ReferenceIndexWriter*, string, vector<string>&, int, vector<uint64_t>&, vector<uint32_t>&, vector<int>&, bool); //label, groups, numOtus, rowStarts, otus, counts, deflate
+    bool inflate(string, vector<char>&);    //section, inflated bytes
+    void clear();
+};
+/**************************************************************************************************/
+
+#endif /* sparsesharedtable_hpp */
@@ -0,0 +1,393 @@
+//
+//  dereplicator.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "dereplicator.hpp"
+
+/***********************************************************************/
+static inline uint64_t rotateLeft(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+static inline uint64_t finalMix(uint64_t x) {
+    x ^= x >> 33; x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+/***********************************************************************/
+Dereplicator::Dereplicator(int p, long long budget, string root) : processors(p), memoryBudget(budget), tempRoot(root) {
+    try {
+        m = MothurOut::getInstance();
+        if (processors < 1) { processors = 1; }
+        numPartitions = 64;
+        numReads = 0; numUniques = 0;
+        spilled = false; finished = false;
+        tables.resize(processors);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "Dereplicator");
+        exit(1);
+    }
+}
+/***********************************************************************/
+Dereplicator::~Dereplicator() {
+    for (int i = 0; i < partitionFiles.size(); i++) { partitionFiles[i]->close(); delete partitionFiles[i]; }
+    for (int i = 0; i < sortedFiles.size(); i++) { sortedFiles[i]->close(); delete sortedFiles[i]; }
+    for (int i = 0; i < partitionNames.size(); i++) { util.mothurRemove(partitionNames[i]); }
+    for (int i = 0; i < sortedNames.size(); i++) { util.mothurRemove(sortedNames[i]); }
+}
+/***********************************************************************/
+//murmur3 style, 16 bytes of state over 8 byte words
+DerepHash Dereplicator::getHash(const string& seq) {
+    const uint64_t c1 = 0x87c37b91114253d5ULL, c2 = 0x4cf5ad432745937fULL;
+    uint64_t h1 = seq.length(), h2 = ~(uint64_t)seq.length();
+
+    const char* data = seq.data();
+    size_t length = seq.length();
+    for (size_t i = 0; i < length; i += 8) {
+        uint64_t word = 0;
+        memcpy(&word, data+i, min((size_t)8, length-i));
+
+        uint64_t k1 = rotateLeft(word * c1, 31) * c2;
+        h1 ^= k1; h1 = rotateLeft(h1, 27) + h2; h1 = h1 * 5 + 0x52dce729;
+
+        uint64_t k2 = rotateLeft(word * c2, 33) * c1;
+        h2 ^= k2; h2 = rotateLeft(h2, 31) + h1; h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    h1 += h2; h2 += h1;
+    h1 = finalMix(h1); h2 = finalMix(h2);
+    h1 += h2; h2 += h1;
+
+    DerepHash hash; hash.high = h1; hash.low = h2;
+    return hash;
+}
+/***********************************************************************/
+void Dereplicator::grow(Table& table) {
+    try {
+        size_t size = max((size_t)1024, table.slots.size() * 2);
+        table.slots.assign(size, -1);
+
+        uint64_t mask = size - 1;
+        for (int i = 0; i < table.uniques.size(); i++) {
+            if (!table.uniques[i].registered) { continue; }
+            uint64_t pos = table.uniques[i].hash.high & mask;
+            while (table.slots[pos] != -1) { pos = (pos + 1) & mask; }
+            table.slots[pos] = i;
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "grow");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//read holds one read or, read back from a partition, a unique found before the spill. Its reads join the unique with
+//the same sequence, otherwise it starts a unique of its own that is only in the table if it is registered
+void Dereplicator::insert(Table& table, DerepUnique& read) {
+    try {
+        if (read.registered && ((table.numInTable + 1) * 2 > table.slots.size())) { grow(table); }
+
+        if (table.slots.size() != 0) {
+            uint64_t mask = table.slots.size() - 1;
+            uint64_t pos = read.hash.high & mask;
+            while (table.slots[pos] != -1) {
+                DerepUnique& unique = table.uniques[table.slots[pos]];
+                if ((unique.hash == read.hash) && (unique.seq == read.seq)) {
+                    unique.reads.insert(unique.reads.end(), read.reads.begin(), read.reads.end());
+                    table.bytes += read.reads.size() * sizeof(int);
+                    return;
+                }
+                pos = (pos + 1) & mask;
+            }
+
+            if (read.registered) { table.slots[pos] = table.uniques.size(); table.numInTable++; }
+        }
+
+        table.bytes += sizeof(DerepUnique) + read.seq.length() + read.comment.length() + read.reads.size() * sizeof(int);
+        table.uniques.push_back(DerepUnique());
+        std::swap(table.uniques.back(), read);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "insert");
+        exit(1);
+    }
+}
+/***********************************************************************/
+void Dereplicator::hashReads(vector<string>* seqs, vector<DerepHash>* hashes, int start, int end) {
+    try {
+        for (int i = start; i < end; i++) { (*hashes)[i] = getHash((*seqs)[i]); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "hashReads");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//thread t owns table t and takes the reads of the batch that hash to it, in read order
+void Dereplicator::driver(int thread, vector<string>* seqs, vector<string>* comments, vector<char>* canStart, vector<DerepHash>* hashes, long long firstRead) {
+    try {
+        Table& table = tables[thread];
+
+        for (int i = 0; i < seqs->size(); i++) {
+            if (getThread((*hashes)[i]) != thread) { continue; }
+
+            DerepUnique read;
+            read.hash = (*hashes)[i];
+            read.seq.swap((*seqs)[i]);
+            read.comment.swap((*comments)[i]);
+            read.reads.push_back(firstRead + i);
+            read.registered = (*canStart)[i];
+
+            insert(table, read);
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "driver");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//the seqs and comments are moved out of the vectors
+void Dereplicator::add(vector<string>& seqs, vector<string>& comments, vector<char>& canStart) {
+    try {
+        int num = seqs.size();
+        vector<DerepHash> hashes(num);
+
+        int numThreads = min(processors, max(num, 1));
+        vector<std::thread*> workerThreads;
+        for (int i = 1; i < numThreads; i++) {
+            int start = (num * (long long)i) / numThreads;
+            int end = (num * (long long)(i+1)) / numThreads;
+            workerThreads.push_back(new std::thread(&Dereplicator::hashReads, this, &seqs, &hashes, start, end));
+        }
+        hashReads(&seqs, &hashes, 0, num / numThreads);
+        for (int i = 0; i < workerThreads.size(); i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+        workerThreads.clear();
+
+        if (!spilled) {
+            for (int i = 1; i < processors; i++) {
+                workerThreads.push_back(new std::thread(&Dereplicator::driver, this, i, &seqs, &comments, &canStart, &hashes, numReads));
+            }
+            driver(0, &seqs, &comments, &canStart, &hashes, numReads);
+            for (int i = 0; i < workerThreads.size(); i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+
+            numReads += num;
+
+            long long bytes = 0; numUniques = 0;
+            for (int i = 0; i < tables.size(); i++) {
+                bytes += tables[i].bytes + tables[i].slots.size() * sizeof(int);
+                numUniques += tables[i].uniques.size();
+            }
+            if (bytes > memoryBudget) { spill(); }
+        }else {
+            for (int i = 0; i < num; i++) {
+                DerepUnique read;
+                read.hash = hashes[i];
+                read.seq.swap(seqs[i]);
+                read.comment.swap(comments[i]);
+                read.reads.push_back(numReads + i);
+                read.registered = canStart[i];
+
+                writeUnique(*partitionFiles[getPartition(read.hash)], read);
+            }
+            numReads += num;
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "add");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//writes the uniques found so far to the partitions in first read order, so reading a partition back in file order
+//keeps the uniques and their reads in order
+void Dereplicator::spill() {
+    try {
+        m->mothurOutJustToScreen("Unique sequences are over the memory budget, continuing on disk.\n");
+
+        spilled = true;
+        for (int i = 0; i < numPartitions; i++) {
+            string name = tempRoot + toString(i) + ".derep.temp";
+            partitionNames.push_back(name);
+            partitionFiles.push_back(new ofstream());
+            util.openOutputFileBinary(name, *partitionFiles.back());
+        }
+
+        startMerge();
+        DerepUnique unique;
+        while (getNext(unique)) { writeUnique(*partitionFiles[getPartition(unique.hash)], unique); }
+
+        vector<Table> empty; tables.swap(empty);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "spill");
+        exit(1);
+    }
+}
+/***********************************************************************/
+void Dereplicator::finish() {
+    try {
+        if (finished) { return; }
+        finished = true;
+
+        if (spilled) {
+            for (int i = 0; i < partitionFiles.size(); i++) { partitionFiles[i]->close(); delete partitionFiles[i]; }
+            partitionFiles.clear();
+
+            for (int i = 0; i < numPartitions; i++) { sortedNames.push_back(tempRoot + toString(i) + ".derep.sorted.temp"); }
+            tables.clear(); tables.resize(numPartitions);
+
+            int numThreads = min(processors, numPartitions);
+            vector<std::thread*> workerThreads;
+            for (int i = 1; i < numThreads; i++) { workerThreads.push_back(new std::thread(&Dereplicator::dereplicatePartitions, this, i)); }
+            dereplicatePartitions(0);
+            for (int i = 0; i < workerThreads.size(); i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+
+            numUniques = 0;
+            for (int i = 0; i < numPartitions; i++) {
+                numUniques += tables[i].numInTable;
+                sortedFiles.push_back(new ifstream());
+                util.openInputFileBinary(sortedNames[i], *sortedFiles.back());
+            }
+            tables.clear();
+        }
+
+        startMerge();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "finish");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//partitions thread, thread+processors, ... are dereplicated one at a time and written back sorted. Only the count of
+//uniques is kept in the partition's table afterwards
+void Dereplicator::dereplicatePartitions(int thread) {
+    try {
+        for (int i = thread; i < numPartitions; i += processors) {
+            if (m->getControl_pressed()) { break; }
+
+            Table table;
+            ifstream in; util.openInputFileBinary(partitionNames[i], in);
+            DerepUnique read;
+            while (readUnique(in, read)) { insert(table, read); }
+            in.close();
+            util.mothurRemove(partitionNames[i]);
+
+            ofstream out; util.openOutputFileBinary(sortedNames[i], out);
+            for (int j = 0; j < table.uniques.size(); j++) { writeUnique(out, table.uniques[j]); }
+            out.close();
+
+            tables[i].numInTable = table.uniques.size();
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "dereplicatePartitions");
+        exit(1);
+    }
+}
+/***********************************************************************/
+void Dereplicator::writeUnique(ofstream& out, DerepUnique& unique) {
+    try {
+        int numUniqueReads = unique.reads.size();
+        int seqLength = unique.seq.length();
+        int commentLength = unique.comment.length();
+        char registered = unique.registered;
+
+        out.write((char*)&unique.hash, sizeof(DerepHash));
+        out.write(&registered, 1);
+        out.write((char*)&numUniqueReads, sizeof(int));
+        out.write((char*)&unique.reads[0], numUniqueReads * sizeof(int));
+        out.write((char*)&seqLength, sizeof(int));
+        out.write(unique.seq.data(), seqLength);
+        out.write((char*)&commentLength, sizeof(int));
+        out.write(unique.comment.data(), commentLength);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "writeUnique");
+        exit(1);
+    }
+}
+/***********************************************************************/
+bool Dereplicator::readUnique(ifstream& in, DerepUnique& unique) {
+    try {
+        int numUniqueReads, seqLength, commentLength;
+        char registered;
+
+        if (!in.read((char*)&unique.hash, sizeof(DerepHash))) { return false; }
+        in.read(&registered, 1);
+        in.read((char*)&numUniqueReads, sizeof(int));
+        unique.reads.resize(numUniqueReads);
+        in.read((char*)&unique.reads[0], numUniqueReads * sizeof(int));
+        in.read((char*)&seqLength, sizeof(int));
+        unique.seq.resize(seqLength);
+        in.read(&unique.seq[0], seqLength);
+        in.read((char*)&commentLength, sizeof(int));
+        unique.comment.resize(commentLength);
+        if (commentLength != 0) { in.read(&unique.comment[0], commentLength); }
+        unique.registered = registered;
+
+        return !in.fail();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "readUnique");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//each table and each sorted partition is already in first read order
+void Dereplicator::startMerge() {
+    try {
+        int numSources = (sortedFiles.size() != 0) ? sortedFiles.size() : tables.size();
+        heads.assign(numSources, DerepUnique());
+        hasHead.assign(numSources, false);
+        nextInTable.assign(numSources, 0);
+
+        for (int i = 0; i < numSources; i++) { hasHead[i] = loadHead(i); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "startMerge");
+        exit(1);
+    }
+}
+/***********************************************************************/
+bool Dereplicator::loadHead(int source) {
+    try {
+        if (sortedFiles.size() != 0) { return readUnique(*sortedFiles[source], heads[source]); }
+
+        Table& table = tables[source];
+        if (nextInTable[source] >= table.uniques.size()) { return false; }
+
+        heads[source] = DerepUnique();
+        std::swap(heads[source], table.uniques[nextInTable[source]++]);
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "loadHead");
+        exit(1);
+    }
+}
+/***********************************************************************/
+bool Dereplicator::getNext(DerepUnique& unique) {
+    try {
+        int next = -1;
+        for (int i = 0; i < heads.size(); i++) {
+            if (!hasHead[i]) { continue; }
+            if ((next == -1) || (heads[i].reads[0] < heads[next].reads[0])) { next = i; }
+        }
+        if (next == -1) { return false; }
+
+        std::swap(unique, heads[next]);
+        hasHead[next] = loadHead(next);
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "getNext");
+        exit(1);
+    }
+}
+/***********************************************************************/
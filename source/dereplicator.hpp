@@ -0,0 +1,102 @@
+//
+//  dereplicator.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef dereplicator_hpp
+#define dereplicator_hpp
+
+#include "mothurout.h"
+#include "utils.hpp"
+#include <cstdint>
+
+/***********************************************************************/
+struct DerepHash {
+    uint64_t high, low;
+
+    DerepHash() : high(0), low(0) {}
+    bool operator==(const DerepHash& other) const { return ((high == other.high) && (low == other.low)); }
+};
+/***********************************************************************/
+//a unique sequence and the reads it represents, reads[0] is the first read with the sequence
+struct DerepUnique {
+    DerepHash hash;
+    string seq, comment;    //comment of the first read
+    vector<int> reads;      //read numbers, in the order they were added
+    bool registered;        //in the table, so later reads with the sequence join it
+
+    DerepUnique() : registered(true) {}
+};
+/***********************************************************************/
+//Dereplicator finds the identical sequences of a fasta file. The sequences are hashed to 128 bits and dealt to the
+//threads by hash into open addressing tables, one per thread, so the threads never share a table. A unique keeps its
+//reads as a vector of read numbers, the caller keeps the names.
+//
+//When the tables grow past the memory budget the uniques found so far are written to partition files by hash, and the
+//reads after them go straight to the partitions. Identical sequences always land in the same partition, so each
+//partition is dereplicated on its own and the partitions are merged back by first read.
+//
+//The uniques come back in the order of their first reads, the order unique.seqs has always written them in.
+class Dereplicator {
+
+public:
+    Dereplicator(int, long long, string); //processors, memory budget in bytes, root name for the partition files
+    ~Dereplicator();
+
+    //adds the next reads, canStart is false for reads that may join a unique but not start one
+    void add(vector<string>&, vector<string>&, vector<char>&); //seqs, comments, can start
+    void finish();                                          //call once after the last add
+    bool getNext(DerepUnique&);                             //after finish, false when all the uniques have been returned
+
+    long long getNumReads()     { return numReads;      }
+    long long getNumUniques()   { return numUniques;    } //uniques found so far, all of them after finish
+    bool getSpilled()           { return spilled;       }
+
+private:
+    struct Table {
+        vector<int> slots;              //index into uniques, -1 for an empty slot
+        vector<DerepUnique> uniques;    //in order of first read
+        int numInTable;
+        long long bytes;
+
+        Table() : numInTable(0), bytes(0) {}
+    };
+
+    MothurOut* m;
+    Utils util;
+    int processors, numPartitions;
+    long long memoryBudget, numReads, numUniques;
+    bool spilled, finished;
+    string tempRoot;
+
+    vector<Table> tables;           //[thread] while in memory, [partition] while a partition is read back
+    vector<ofstream*> partitionFiles;
+    vector<string> partitionNames, sortedNames;
+
+    //merge of the tables or the sorted partition files by first read
+    vector<ifstream*> sortedFiles;
+    vector<DerepUnique> heads;
+    vector<bool> hasHead;
+    vector<int> nextInTable;
+
+    DerepHash getHash(const string&);
+    int getThread(const DerepHash& hash)    { return (int)(hash.low % (uint64_t)processors);        }
+    int getPartition(const DerepHash& hash) { return (int)((hash.low >> 32) % (uint64_t)numPartitions); }
+
+    void insert(Table&, DerepUnique&);
+    void grow(Table&);
+    void hashReads(vector<string>*, vector<DerepHash>*, int, int);
+    void driver(int, vector<string>*, vector<string>*, vector<char>*, vector<DerepHash>*, long long);
+    void spill();
+    void dereplicatePartitions(int);
+
+    void writeUnique(ofstream&, DerepUnique&);
+    bool readUnique(ifstream&, DerepUnique&);
+    bool loadHead(int);
+    void startMerge();
+};
+/***********************************************************************/
+
+#endif /* dereplicator_hpp */
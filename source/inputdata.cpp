@@ -13,6 +13,8 @@
 #include "rabundvector.hpp"
 #include "sharedrabundvectors.hpp"
 #include "sharedclrvectors.hpp"
+#include "labelindex.hpp"
+#include "sparsesharedtable.hpp"
 
 /***********************************************************************/
 
@@ -23,12 +25,16 @@ InputData::InputData(string fName, string f, vector<string> userGroups) : format
 	nextDistanceLabel = "";
     groups = userGroups;
     otuTag = util.getTag(fName);
+    labelIndex = NULL; labelCursor = 0;
+    sparseFile = NULL;
 }
 /***********************************************************************/
 
 InputData::~InputData(){
 	fileHandle.close();
 	nextDistanceLabel = "";
+	if (labelIndex != NULL) { delete labelIndex; }
+	if (sparseFile != NULL) { delete sparseFile; }
 }
 
 /***********************************************************************/
@@ -51,8 +57,11 @@ InputData::InputData(string fName, string orderFileName, string f) : format(f){
 		ofHandle.close();
 	
 		util.openInputFile(fName, fileHandle);
+		filename = fName;
 		nextDistanceLabel = "";
         otuTag = util.getTag(fName);
+        labelIndex = NULL; labelCursor = 0;
+        sparseFile = NULL;
 		
 	}
 	catch(exception& e) {
@@ -90,6 +99,21 @@ ListVector* InputData::getListVector(){
 /***********************************************************************/
 ListVector* InputData::getListVector(string label){
 	try {
+		int position = findLabel(label);
+		if ((position > 0) && (format == "list")) {
+			//the bin labels are in the headers, read the first label for them
+			if (currentLabels.size() == 0) { delete getListVector(labelIndex->getLabel(0)); }
+			
+			ifstream in;
+			if (openAtLabel(in, label)) {
+				nextDistanceLabel = label;
+				list = new ListVector(in, nextDistanceLabel, otuTag);
+				list->setLabels(currentLabels);
+				in.close();
+				return list;
+			}
+		}
+		
 		ifstream in;
 		util.openInputFile(filename, in);
         nextDistanceLabel = "";
@@ -132,6 +156,19 @@ ListVector* InputData::getListVector(string label){
 /***********************************************************************/
 ListVector* InputData::getListVector(string label, bool resetFP){
 	try {
+		int position = findLabel(label);
+		if ((position > 0) && (format == "list")) {
+			if (currentLabels.size() == 0) { delete getListVector(labelIndex->getLabel(0)); }
+			
+			//the next getListVector() reads on from here
+			if (seekToLabel(fileHandle, label)) {
+				nextDistanceLabel = label;
+				list = new ListVector(fileHandle, nextDistanceLabel, otuTag); util.gobble(fileHandle);
+				list->setLabels(currentLabels);
+				return list;
+			}
+		}
+		
 		fileHandle.clear();
 		fileHandle.seekg(0);
         nextDistanceLabel = "";
@@ -199,6 +236,20 @@ SharedListVector* InputData::getSharedListVector(){
 
 SharedListVector* InputData::getSharedListVector(string label){
 	try {
+		int position = findLabel(label);
+		if ((position > 0) && (format == "shared")) {
+			if (currentLabels.size() == 0) { delete getSharedListVector(labelIndex->getLabel(0)); }
+			
+			ifstream in;
+			if (openAtLabel(in, label)) {
+				nextDistanceLabel = label;
+				SharedList = new SharedListVector(in, groups, nextDistanceLabel, otuTag);
+				SharedList->setLabels(currentLabels);
+				in.close();
+				return SharedList;
+			}
+		}
+		
 		ifstream in;
 		string  thisLabel;
 		util.openInputFile(filename, in);
@@ -267,6 +318,26 @@ SharedOrderVector* InputData::getSharedOrderVector(){
 
 SharedOrderVector* InputData::getSharedOrderVector(string label){
 	try {
+		int position = findLabel(label);
+		if ((position > 0) && (format == "sharedfile")) {
+			//the groups come from the first label, like they do when the file is read from the top
+			if (groups.size() == 0) {
+				SharedOrderVector* first = getSharedOrderVector(labelIndex->getLabel(0));
+				if (first == NULL) { return NULL; }
+				delete first;
+			}
+			
+			ifstream in;
+			if (openAtLabel(in, label)) {
+				in >> nextDistanceLabel;
+				SharedOrder = new SharedOrderVector(in, groups, nextDistanceLabel);
+				in.close();
+				
+				if (SharedOrder->getNumBins() == 0) { delete SharedOrder; SharedOrder = NULL; } //no valid groups
+				return SharedOrder;
+			}
+		}
+		
 		ifstream in;
 		string  thisLabel;
 		util.openInputFile(filename, in);
@@ -488,6 +559,32 @@ SharedRAbundVectors* InputData::getSharedRAbundVectors(){
 /***********************************************************************/
 SharedRAbundVectors* InputData::getSharedRAbundVectors(string label){
 	try {
+		int position = findLabel(label);
+		if ((position > 0) && (format == "sharedfile")) {
+			//the OTU labels and the groups come from the first label, like they do when the file is read from the top
+			if (currentLabels.size() == 0) {
+				SharedRAbundVectors* first = getSharedRAbundVectors(labelIndex->getLabel(0));
+				if (first == NULL) { return NULL; }
+				delete first;
+			}
+			
+			ifstream in;
+			if (openAtLabel(in, label)) {
+				in >> nextDistanceLabel;
+				SharedRAbundVectors* SharedRAbund = new SharedRAbundVectors(in, groups, nextDistanceLabel, otuTag);
+				in.close();
+				
+				if (SharedRAbund->getNumBins() == 0) { delete SharedRAbund; return NULL; } //no valid groups
+				SharedRAbund->setOTUNames(currentLabels);
+				return SharedRAbund;
+			}
+		}else if ((position > 0) && (format == "shared")) {
+			SharedListVector* thisList = getSharedListVector(label);
+			SharedRAbundVectors* SharedRAbund = thisList->getSharedRAbundVector();
+			delete thisList;
+			return SharedRAbund;
+		}
+		
 		ifstream in;
 		string  thisLabel;
 		
@@ -599,6 +696,27 @@ SharedRAbundFloatVectors* InputData::getSharedRAbundFloatVectors(){
 /***********************************************************************/
 SharedRAbundFloatVectors* InputData::getSharedRAbundFloatVectors(string label){
 	try {
+		int position = findLabel(label);
+		if ((position > 0) && (format == "relabund")) {
+			//the OTU labels and the groups come from the first label, like they do when the file is read from the top
+			if (currentLabels.size() == 0) {
+				SharedRAbundFloatVectors* first = getSharedRAbundFloatVectors(labelIndex->getLabel(0));
+				if (first == NULL) { return NULL; }
+				delete first;
+			}
+			
+			ifstream in;
+			if (openAtLabel(in, label)) {
+				in >> nextDistanceLabel;
+				SharedRAbundFloatVectors* SharedRelAbund = new SharedRAbundFloatVectors(in, groups, nextDistanceLabel, otuTag);
+				in.close();
+				
+				if (SharedRelAbund->getNumBins() == 0) { delete SharedRelAbund; return NULL; } //no valid groups
+				SharedRelAbund->setOTUNames(currentLabels);
+				return SharedRelAbund;
+			}
+		}
+		
 		ifstream in;
 		string  thisLabel;
 		
@@ -927,6 +1045,28 @@ RAbundVector* InputData::getRAbundVector(){
 /***********************************************************************/
 RAbundVector* InputData::getRAbundVector(string label){
 	try {
+		int position = findLabel(label);
+		if ((position > 0) && (format == "list")) {
+			ifstream in;
+			if (openAtLabel(in, label)) {
+				nextDistanceLabel = label;
+				input = new ListVector(in, nextDistanceLabel, otuTag);
+				in.close();
+				
+				rabund = new RAbundVector();
+				*rabund = (input->getRAbundVector());
+				delete input;
+				return rabund;
+			}
+		}else if ((position > 0) && (format == "sharedfile")) {
+			SharedRAbundVectors* shared = getSharedRAbundVectors(label);
+			if (shared == NULL) { return NULL; }
+			
+			rabund = new RAbundVector();
+			*rabund = (shared->getRAbundVector());
+			delete shared;
+			return rabund;
+		}
 	
 		ifstream in;
 		string  thisLabel;
@@ -1063,3 +1203,242 @@ RAbundVector* InputData::getRAbundVector(string label){
 
 
 
+bool InputData::hasLabelIndex(){
+	try {
+		if (!LabelIndex::isIndexed(format)) { return false; }
+		if (labelIndex == NULL) { labelIndex = new LabelIndex(filename, format); }
+		return (labelIndex->getNumLabels() != 0);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "InputData", "hasLabelIndex");
+		exit(1);
+	}
+}
+/***********************************************************************/
+//position of the label in the file, -1 if there is no index or the file doesn't have the label
+int InputData::findLabel(string label){
+	try {
+		if (!hasLabelIndex()) { return -1; }
+		return labelIndex->find(label);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "InputData", "findLabel");
+		exit(1);
+	}
+}
+/***********************************************************************/
+//seeks to the label's first line and checks the label is there, the file may have changed since it was indexed
+bool InputData::seekToLabel(ifstream& in, string label){
+	try {
+		for (int tries = 0; tries < 2; tries++) {
+			int position = findLabel(label);
+			if (position == -1) { return false; }
+			
+			in.clear(); in.seekg(labelIndex->getOffset(position));
+			string fileLabel = ""; in >> fileLabel;
+			
+			in.clear(); in.seekg(labelIndex->getOffset(position));
+			if (fileLabel == label) { return true; }
+			
+			if (tries == 0) { labelIndex->rebuild(); }
+		}
+		
+		return false;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "InputData", "seekToLabel");
+		exit(1);
+	}
+}
+/***********************************************************************/
+bool InputData::openAtLabel(ifstream& in, string label){
+	try {
+		in.open(util.getFullPathName(filename).c_str(), ios::binary);
+		if (seekToLabel(in, label)) { return true; }
+		
+		in.close();
+		return false;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "InputData", "openAtLabel");
+		exit(1);
+	}
+}
+/***********************************************************************/
+string InputData::peekLabel(){
+	try {
+		if (!hasLabelIndex()) { return ""; }
+		if (labelCursor >= labelIndex->getNumLabels()) { return ""; }
+		return labelIndex->getLabel(labelCursor);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "InputData", "peekLabel");
+		exit(1);
+	}
+}
+/***********************************************************************/
+long long InputData::getLabelSize(string label){
+	try {
+		int position = findLabel(label);
+		if (position == -1) { return 0; }
+		return (long long)labelIndex->getNumOtus(position) * (long long)labelIndex->getNumLines(position);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "InputData", "getLabelSize");
+		exit(1);
+	}
+}
+/***********************************************************************/
+void InputData::skipLabel(){ labelCursor++; }
+/***********************************************************************/
+//the same groups, OTU labels and zero OTU removal as getSharedRAbundVectors(label), without the dense vectors
+SparseSharedTable* InputData::getSparseSharedTable(string label){
+	try {
+		if (format != "sharedfile") { return NULL; }
+		if (sparseFile == NULL) { sparseFile = new SparseSharedFile(filename); }
+		
+		int position = sparseFile->find(label);
+		if (position == -1) { return NULL; }
+		
+		//the OTU labels and the groups come from the first label, like they do when the file is read from the top
+		if ((position > 0) && (currentLabels.size() == 0)) {
+			SparseSharedTable* first = getSparseSharedTable(sparseFile->getLabel(0));
+			if (first == NULL) { return NULL; }
+			delete first;
+		}
+		
+		SparseSharedTable* table = sparseFile->getTable(position);
+		if (table == NULL) { return NULL; }
+		
+		bool remove = table->selectGroups(groups);
+		
+		//error in names of user inputted Groups
+		if (table->getNumGroups() < groups.size()) { m->mothurOut("[ERROR]: requesting groups not present in files, aborting.\n"); m->setControl_pressed(true); }
+		
+		vector<string> names = currentLabels;
+		if (currentLabels.size() == 0) { //the headers of the file
+			names = sparseFile->getOTUNames();
+			if (names.size() != 0) {
+				otuTag = "";
+				for (int i = 0; i < names[0].length(); i++) { if (isalpha(names[0][i])){ otuTag += names[0][i]; } }
+				
+				if (names.size() != table->getNumOtus()) {
+					m->mothurOut("[ERROR]: your shared file contains " + toString(names.size()) + " OTU labels, but your numOtus column indicates " + toString(table->getNumOtus()) + ". Cannot continue, please correct. This can be caused by editing your file incorrectly outside of mothur.\n"); m->setControl_pressed(true);
+				}
+			}else if (otuTag == "") { otuTag = "Otu"; }
+		}
+		table->setOTUNames(names, otuTag);
+		
+		if (remove) { table->eliminateZeroOTUs(); }
+		
+		//pass labels to others distances in file
+		if (currentLabels.size() == 0) { currentLabels = table->getOTUNames(); }
+		else { table->setOTUNames(currentLabels, otuTag); }
+		
+		if ((table->getNumOtus() == 0) || (table->getNumGroups() == 0)) { delete table; return NULL; } //no valid groups
+		
+		return table;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "InputData", "getSparseSharedTable");
+		exit(1);
+	}
+}
+/***********************************************************************/
+struct sharedLabelData {
+	MothurOut* m;
+	string filename, otuTag;
+	vector<string> groups, labels;
+	vector<long long> offsets;
+	vector<SharedRAbundVectors*> lookups;
+	
+	sharedLabelData(string f, string tag, vector<string> g) : filename(f), otuTag(tag), groups(g) { m = MothurOut::getInstance(); }
+};
+/***********************************************************************/
+static void readSharedLabels(sharedLabelData* params){
+	try {
+		Utils util;
+		ifstream in(util.getFullPathName(params->filename).c_str(), ios::binary);
+		
+		for (int i = 0; i < params->labels.size(); i++) {
+			if (params->m->getControl_pressed()) { break; }
+			
+			in.clear(); in.seekg(params->offsets[i]);
+			string nextLabel; in >> nextLabel;
+			if (nextLabel != params->labels[i]) { params->lookups.push_back(NULL); continue; } //the file changed since it was indexed
+			
+			vector<string> theseGroups = params->groups;
+			string tag = params->otuTag;
+			params->lookups.push_back(new SharedRAbundVectors(in, theseGroups, nextLabel, tag));
+		}
+		in.close();
+	}
+	catch(exception& e) {
+		params->m->errorOut(e, "InputData", "readSharedLabels");
+		exit(1);
+	}
+}
+/***********************************************************************/
+//the labels after the first are read on processors threads, each reading a run of labels that are next to each other
+//in the file. The labels come back in the order asked for, NULL for a label that couldn't be read.
+vector<SharedRAbundVectors*> InputData::getSharedRAbundVectors(vector<string> labels, int processors){
+	try {
+		vector<SharedRAbundVectors*> lookups(labels.size(), NULL);
+		if (labels.size() == 0) { return lookups; }
+		
+		//sets the OTU labels and the groups the threads need
+		lookups[0] = getSharedRAbundVectors(labels[0]);
+		
+		vector<int> toRead;
+		for (int i = 1; i < labels.size(); i++) {
+			if ((format == "sharedfile") && (currentLabels.size() != 0) && (findLabel(labels[i]) > 0)) { toRead.push_back(i); }
+			else { lookups[i] = getSharedRAbundVectors(labels[i]); }
+		}
+		if (toRead.size() == 0) { return lookups; }
+		
+		if (processors > toRead.size()) { processors = toRead.size(); }
+		
+		vector<sharedLabelData*> data;
+		for (int i = 0; i < processors; i++) {
+			int start = (i * toRead.size()) / processors;
+			int end = ((i+1) * toRead.size()) / processors;
+			
+			sharedLabelData* dataBundle = new sharedLabelData(filename, otuTag, groups);
+			for (int j = start; j < end; j++) {
+				dataBundle->labels.push_back(labels[toRead[j]]);
+				dataBundle->offsets.push_back(labelIndex->getOffset(findLabel(labels[toRead[j]])));
+			}
+			data.push_back(dataBundle);
+		}
+		
+		//create array of worker threads
+		vector<std::thread*> workerThreads;
+		for (int i = 1; i < processors; i++) { workerThreads.push_back(new std::thread(readSharedLabels, data[i])); }
+		
+		readSharedLabels(data[0]);
+		
+		for (int i = 0; i < processors-1; i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+		
+		int next = 0;
+		for (int i = 0; i < processors; i++) {
+			for (int j = 0; j < data[i]->lookups.size(); j++) {
+				SharedRAbundVectors* SharedRAbund = data[i]->lookups[j];
+				
+				if (SharedRAbund == NULL) { SharedRAbund = getSharedRAbundVectors(data[i]->labels[j]); } //checks the index, and rebuilds it
+				else if (SharedRAbund->getNumBins() == 0) { delete SharedRAbund; SharedRAbund = NULL; } //no valid groups
+				else { SharedRAbund->setOTUNames(currentLabels); }
+				
+				lookups[toRead[next+j]] = SharedRAbund;
+			}
+			next += (data[i]->labels.size());
+			delete data[i];
+		}
+		
+		return lookups;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "InputData", "getSharedRAbundVectors");
+		exit(1);
+	}
+}
+/***********************************************************************/
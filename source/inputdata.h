@@ -10,6 +10,10 @@
 #include "sharedrabundfloatvectors.hpp"
 #include "utils.hpp"
 
+class LabelIndex;
+class SparseSharedFile;
+class SparseSharedTable;
+
 class InputData {
 	
 public:
@@ -36,6 +40,18 @@ public:
     SharedCLRVectors* getSharedCLRVectors();
     SharedCLRVectors* getSharedCLRVectors(string);  //pass the label you want
     
+    //the list, shared and relabund files are indexed by label, see LabelIndex. The get*(string) functions seek to the
+    //label instead of parsing the labels in front of it. The label cursor walks the labels without parsing them, for
+    //Utils::getNextShared and the commands that choose their labels first and then read them.
+    bool hasLabelIndex();
+    string peekLabel();     //label at the cursor, "" after the last label
+    long long getLabelSize(string); //OTUs times groups of the label, from the index
+    void skipLabel();       //moves the cursor to the next label
+    vector<SharedRAbundVectors*> getSharedRAbundVectors(vector<string>, int); //labels, processors. Reads the labels on different threads
+    
+    //the shared file's tables mapped from its binary copy, see SparseSharedFile
+    SparseSharedTable* getSparseSharedTable(string);  //pass the label you want
+    
 private:
     Utils util;
 	string format;
@@ -54,6 +70,13 @@ private:
     vector<string> groups;
     string nextDistanceLabel;
     string otuTag;
+    LabelIndex* labelIndex;
+    SparseSharedFile* sparseFile;
+    int labelCursor;
+    
+    int findLabel(string);
+    bool seekToLabel(ifstream&, string);    //false if the index doesn't find the label where it says it is, even after a rebuild
+    bool openAtLabel(ifstream&, string);
 };
 
 
@@ -22,6 +22,7 @@ int OptiCluster::initialize(double& value, bool randomize, string initialize) {
         
         vector<long long> temp;
         bins.push_back(temp);
+        seqBin.assign(numSeqs+1, 0);
         seqBin[numSeqs] = -1;
         insertLocation = numSeqs;
         Utils util;
@@ -40,12 +41,9 @@ int OptiCluster::initialize(double& value, bool randomize, string initialize) {
             if (randomize) { util.mothurRandomShuffle(randomizeSeqs); }
             
             //for each sequence (singletons removed on read)
-            for (map<long long, long long>::iterator it = seqBin.begin(); it != seqBin.end(); it++) {
-                if (it->second == -1) { }
-                else {
-                    long long numCloseSeqs = (matrix->getNumClose(it->first)); //does not include self
-                    falseNegatives += numCloseSeqs;
-                }
+            for (long long i = 0; i < numSeqs; i++) {
+                long long numCloseSeqs = (matrix->getNumClose(i)); //does not include self
+                falseNegatives += numCloseSeqs;
             }
             falseNegatives /= 2; //square matrix
             trueNegatives = numSeqs * (numSeqs-1)/2 - (falsePositives + falseNegatives + truePositives); //since everyone is a singleton no one clusters together. True negative = num far apart
@@ -61,12 +59,9 @@ int OptiCluster::initialize(double& value, bool randomize, string initialize) {
             if (randomize) { util.mothurRandomShuffle(randomizeSeqs); }
             
             //for each sequence (singletons removed on read)
-            for (map<long long, long long>::iterator it = seqBin.begin(); it != seqBin.end(); it++) {
-                if (it->second == -1) { }
-                else {
-                    long long numCloseSeqs = (matrix->getNumClose(it->first)); //does not include self
-                    truePositives += numCloseSeqs;
-                }
+            for (long long i = 0; i < numSeqs; i++) {
+                long long numCloseSeqs = (matrix->getNumClose(i)); //does not include self
+                truePositives += numCloseSeqs;
             }
             truePositives /= 2; //square matrix
             falsePositives = numSeqs * (numSeqs-1)/2 - (trueNegatives + falseNegatives + truePositives);
@@ -88,73 +83,20 @@ int OptiCluster::initialize(double& value, bool randomize, string initialize) {
 bool OptiCluster::update(double& listMetric) {
     try {
         
-        //for each sequence (singletons removed on read)
-        for (int i = 0; i < randomizeSeqs.size(); i++) {
-            
-            if (m->getControl_pressed()) { break; }
-            
-            map<long long, long long>::iterator it = seqBin.find(randomizeSeqs[i]);
-            
-            long long seqNumber = it->first;
-            long long binNumber = it->second;
-            
-            if (binNumber == -1) { }
-            else {
-                
-                double tn, tp, fp, fn;
-                double bestMetric = -1;
-                double bestBin, bestTp, bestTn, bestFn, bestFp;
-                tn = trueNegatives; tp = truePositives; fp = falsePositives; fn = falseNegatives;
-                
-                //close / far count in current bin
-                vector<double> results = getCloseFarCounts(seqNumber, binNumber);
-                double cCount = results[0];  double fCount = results[1];
-                
-                //metric in current bin
-                bestMetric = metric->getValue(tp, tn, fp, fn); bestBin = binNumber; bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn;
-                
-                //if not already singleton, then calc value if singleton was created
-                if (!((bins[binNumber].size()) == 1)) {
-                    //make a singleton
-                    //move out of old bin
-                    fn+=cCount; tn+=fCount; fp-=fCount; tp-=cCount;
-                    double singleMetric = metric->getValue(tp, tn, fp, fn);
-                    if (singleMetric > bestMetric) {
-                        bestBin = -1; bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn;
-                        bestMetric = singleMetric;
-                    }
-                }
-                
-                set<long long> binsToTry;
-                set<long long> closeSeqs = matrix->getCloseSeqs(seqNumber);
-                for (set<long long>::iterator itClose = closeSeqs.begin(); itClose != closeSeqs.end(); itClose++) {  binsToTry.insert(seqBin[*itClose]); }
+        if (processors > 1) { updateParallel(); }
+        else {
+            //for each sequence (singletons removed on read)
+            for (int i = 0; i < randomizeSeqs.size(); i++) {
                 
-                //merge into each "close" otu
-                for (set<long long>::iterator it = binsToTry.begin(); it != binsToTry.end(); it++) {
-                    tn = trueNegatives; tp = truePositives; fp = falsePositives; fn = falseNegatives;
-                    fn+=cCount; tn+=fCount; fp-=fCount; tp-=cCount; //move out of old bin
-                    results = getCloseFarCounts(seqNumber, *it);
-                    fn-=results[0]; tn-=results[1];  tp+=results[0]; fp+=results[1]; //move into new bin
-                    double newMetric = metric->getValue(tp, tn, fp, fn); //score when sequence is moved
-                    //new best
-                    if (newMetric > bestMetric) { bestMetric = newMetric; bestBin = (*it); bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn; }
-                }
+                if (m->getControl_pressed()) { break; }
                 
-                bool usedInsert = false;
-                if (bestBin == -1) {  bestBin = insertLocation;  usedInsert = true;  }
+                long long seqNumber = randomizeSeqs[i];
                 
-                if (bestBin != binNumber) {
-                    truePositives = bestTp; trueNegatives = bestTn; falsePositives = bestFp; falseNegatives = bestFn;
-                    
-                    //move seq from i to j
-                    bins[bestBin].push_back(seqNumber); //add seq to bestbin
-                    bins[binNumber].erase(remove(bins[binNumber].begin(), bins[binNumber].end(), seqNumber), bins[binNumber].end()); //remove from old bin i
+                if (seqBin[seqNumber] == -1) { }
+                else {
+                    OptiMove move = findBestMove(seqNumber, truePositives, trueNegatives, falsePositives, falseNegatives, binsToTry);
+                    moveSeq(move);
                 }
-                
-                if (usedInsert) { insertLocation = findInsert(); }
-                
-                //update seqBins
-                seqBin[seqNumber] = bestBin; //set new OTU location
             }
         }
         
@@ -171,6 +113,179 @@ bool OptiCluster::update(double& listMetric) {
     }
 }
 /***********************************************************************/
+//finds the best OTU for seqNumber given the confusion counts tp, tn, fp and fn. Only reads the bins, so the threads of
+//updateParallel can search at the same time. binsToTry is the caller's scratch space.
+OptiCluster::OptiMove OptiCluster::findBestMove(long long seqNumber, double truePos, double trueNeg, double falsePos, double falseNeg, vector<int>& binsToTry) {
+    try {
+        long long binNumber = seqBin[seqNumber];
+        
+        double tn, tp, fp, fn;
+        double bestMetric = -1;
+        double bestBin, bestTp, bestTn, bestFn, bestFp;
+        tn = trueNeg; tp = truePos; fp = falsePos; fn = falseNeg;
+        
+        //close / far count in current bin
+        vector<double> results = getCloseFarCounts(seqNumber, binNumber);
+        double cCount = results[0];  double fCount = results[1];
+        
+        //metric in current bin
+        bestMetric = metric->getValue(tp, tn, fp, fn); bestBin = binNumber; bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn;
+        
+        //if not already singleton, then calc value if singleton was created
+        if (!((bins[binNumber].size()) == 1)) {
+            //make a singleton
+            //move out of old bin
+            fn+=cCount; tn+=fCount; fp-=fCount; tp-=cCount;
+            double singleMetric = metric->getValue(tp, tn, fp, fn);
+            if (singleMetric > bestMetric) {
+                bestBin = -1; bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn;
+                bestMetric = singleMetric;
+            }
+        }
+        
+        //the bins of the close seqs, in order
+        binsToTry.clear();
+        CloseSeqs closeSeqs = matrix->getCloseSeqs(seqNumber);
+        for (CloseSeqs::iterator itClose = closeSeqs.begin(); itClose != closeSeqs.end(); itClose++) {  binsToTry.push_back(seqBin[*itClose]); }
+        sort(binsToTry.begin(), binsToTry.end());
+        binsToTry.erase(unique(binsToTry.begin(), binsToTry.end()), binsToTry.end());
+        
+        //merge into each "close" otu
+        for (vector<int>::iterator it = binsToTry.begin(); it != binsToTry.end(); it++) {
+            tn = trueNeg; tp = truePos; fp = falsePos; fn = falseNeg;
+            fn+=cCount; tn+=fCount; fp-=fCount; tp-=cCount; //move out of old bin
+            results = getCloseFarCounts(seqNumber, *it);
+            fn-=results[0]; tn-=results[1];  tp+=results[0]; fp+=results[1]; //move into new bin
+            double newMetric = metric->getValue(tp, tn, fp, fn); //score when sequence is moved
+            //new best
+            if (newMetric > bestMetric) { bestMetric = newMetric; bestBin = (*it); bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn; }
+        }
+        
+        OptiMove move;
+        move.seq = seqNumber; move.fromBin = binNumber; move.toBin = bestBin;
+        move.tp = bestTp - truePos; move.tn = bestTn - trueNeg; move.fp = bestFp - falsePos; move.fn = bestFn - falseNeg;
+        
+        return move;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "findBestMove");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//moves are exact as long as neither the old or new bin changed since the move was found
+void OptiCluster::moveSeq(OptiMove& move) {
+    try {
+        if (move.toBin == move.fromBin) { return; }
+        
+        bool usedInsert = false;
+        long long bestBin = move.toBin;
+        if (bestBin == -1) {  bestBin = insertLocation;  usedInsert = true;  }
+        
+        truePositives += move.tp; trueNegatives += move.tn; falsePositives += move.fp; falseNegatives += move.fn;
+        
+        //move seq from i to j
+        bins[bestBin].push_back(move.seq); //add seq to bestbin
+        bins[move.fromBin].erase(remove(bins[move.fromBin].begin(), bins[move.fromBin].end(), move.seq), bins[move.fromBin].end()); //remove from old bin i
+        
+        if (usedInsert) { insertLocation = findInsert(); }
+        
+        //update seqBins
+        seqBin[move.seq] = bestBin; //set new OTU location
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "moveSeq");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//thread worker - best moves for randomizeSeqs[start] to randomizeSeqs[end-1], stored in moves from moves[0]
+void OptiCluster::findBestMoves(long long start, long long end, vector<OptiMove>* moves) {
+    try {
+        vector<int> threadBinsToTry;
+        for (long long i = start; i < end; i++) {
+            if (m->getControl_pressed()) { break; }
+            
+            long long seqNumber = randomizeSeqs[i];
+            if (seqBin[seqNumber] == -1) { (*moves)[i-start].seq = seqNumber; continue; }
+            
+            (*moves)[i-start] = findBestMove(seqNumber, truePositives, trueNegatives, falsePositives, falseNegatives, threadBinsToTry);
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "findBestMoves");
+        exit(1);
+    }
+}
+/***********************************************************************/
+/* the randomized sequences are processed in batches. The threads find the best move for their part of the batch
+ * against the bins as they were at the start of the batch, then the moves are made in the randomized order. A move
+ * whose old or new bin was changed by an earlier move in the batch, or that no longer improves the metric with the
+ * current counts, is found again before it is made, so the confusion counts stay exact and the metric never drops. */
+void OptiCluster::updateParallel() {
+    try {
+        long long seqsPerThread = 256;
+        long long batchSize = seqsPerThread * processors;
+        
+        vector<int> binChanged(bins.size(), -1); //batch that last changed the bin
+        
+        for (long long batchStart = 0, batch = 0; batchStart < randomizeSeqs.size(); batchStart += batchSize, batch++) {
+            
+            if (m->getControl_pressed()) { break; }
+            
+            long long batchEnd = batchStart + batchSize;
+            if (batchEnd > randomizeSeqs.size()) { batchEnd = randomizeSeqs.size(); }
+            
+            //divide the batch between the threads
+            vector< vector<OptiMove> > moves(processors);
+            vector<long long> lines;
+            long long numInBatch = batchEnd - batchStart;
+            for (int i = 0; i < processors; i++) { lines.push_back(batchStart + (numInBatch * i) / processors); }
+            lines.push_back(batchEnd);
+            for (int i = 0; i < processors; i++) { moves[i].resize(lines[i+1] - lines[i]); }
+            
+            vector<std::thread*> workerThreads;
+            for (int i = 1; i < processors; i++) {
+                workerThreads.push_back(new std::thread(&OptiCluster::findBestMoves, this, lines[i], lines[i+1], &moves[i]));
+            }
+            findBestMoves(lines[0], lines[1], &moves[0]);
+            
+            for (int i = 0; i < workerThreads.size(); i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+            
+            if (m->getControl_pressed()) { break; }
+            
+            //make the moves in order
+            for (int i = 0; i < processors; i++) {
+                for (int j = 0; j < moves[i].size(); j++) {
+                    OptiMove& move = moves[i][j];
+                    
+                    if (seqBin[move.seq] == -1) { continue; }
+                    
+                    bool redo = (binChanged[move.fromBin] == batch) || ((move.toBin != -1) && (binChanged[move.toBin] == batch));
+                    
+                    if (!redo && (move.toBin != move.fromBin)) {
+                        double currentMetric = metric->getValue(truePositives, trueNegatives, falsePositives, falseNegatives);
+                        double newMetric = metric->getValue(truePositives+move.tp, trueNegatives+move.tn, falsePositives+move.fp, falseNegatives+move.fn);
+                        if (!(newMetric > currentMetric)) { redo = true; }
+                    }
+                    
+                    if (redo) { move = findBestMove(move.seq, truePositives, trueNegatives, falsePositives, falseNegatives, binsToTry); }
+                    
+                    if (move.toBin != move.fromBin) {
+                        binChanged[move.fromBin] = batch;
+                        moveSeq(move);
+                        binChanged[seqBin[move.seq]] = batch;
+                    }
+                }
+            }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "updateParallel");
+        exit(1);
+    }
+}
+/***********************************************************************/
 vector<double> OptiCluster::getCloseFarCounts(long long seq, long long newBin) {
     try {
         vector<double> results; results.push_back(0); results.push_back(0);
@@ -35,12 +35,12 @@ public:
     
 #ifdef UNIT_TEST
     friend class TestOptiCluster;
-    OptiCluster() : Cluster() { m = MothurOut::getInstance(); truePositives = 0; trueNegatives = 0; falseNegatives = 0; falsePositives = 0;  } //for testing class
+    OptiCluster() : Cluster() { m = MothurOut::getInstance(); truePositives = 0; trueNegatives = 0; falseNegatives = 0; falsePositives = 0; processors = 1; } //for testing class
     void setVariables(OptiData* mt, ClusterMetric* met) { matrix = mt; metric = met; }
 #endif
     
-    OptiCluster(OptiData* mt, ClusterMetric* met, long long ns) : Cluster() {
-        m = MothurOut::getInstance(); matrix = mt; metric = met; truePositives = 0; trueNegatives = 0; falseNegatives = 0; falsePositives = 0; numSingletons = ns;
+    OptiCluster(OptiData* mt, ClusterMetric* met, long long ns, int proc = 1) : Cluster() {
+        m = MothurOut::getInstance(); matrix = mt; metric = met; truePositives = 0; trueNegatives = 0; falseNegatives = 0; falsePositives = 0; numSingletons = ns; processors = proc;
     }
     ~OptiCluster() {}
     bool updateDistance(PDistCell& colCell, PDistCell& rowCell) { return false; } //inheritance compliant
@@ -53,20 +53,33 @@ public:
     ListVector* getList();
     
 protected:
+    //a sequence's best OTU and the change in the confusion counts if it moves there
+    struct OptiMove {
+        long long seq;
+        int fromBin, toBin; //toBin is -1 for a new singleton OTU, fromBin if the sequence stays
+        double tp, tn, fp, fn;
+        OptiMove() : seq(0), fromBin(-1), toBin(-1), tp(0), tn(0), fp(0), fn(0) {}
+    };
+    
     MothurOut* m;
     Utils util;
-    map<long long, long long> seqBin; //sequence# -> bin#
+    vector<int> seqBin; //sequence# -> bin#, seqBin[numSeqs] is -1
     OptiData* matrix;
-    vector<int> randomizeSeqs;
+    vector<int> randomizeSeqs, binsToTry;
     vector< vector<long long> > bins; //bin[0] -> seqs in bin[0]
     map<long long, string> binLabels; //for fitting - maps binNumber to existing reference label
     
     ClusterMetric* metric;
     long long numSeqs, insertLocation, numSingletons;
+    int processors;
     double truePositives, trueNegatives, falsePositives, falseNegatives;
     
     long long findInsert();
     vector<double> getCloseFarCounts(long long seq, long long newBin);
+    OptiMove findBestMove(long long, double, double, double, double, vector<int>&);
+    void findBestMoves(long long, long long, vector<OptiMove>*);
+    void moveSeq(OptiMove&);
+    void updateParallel();
     vector<double> getFitStats( long long&,  long long&,  long long&,  long long&);
     
 };
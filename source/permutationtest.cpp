@@ -0,0 +1,116 @@
+//
+//  permutationtest.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "permutationtest.hpp"
+
+/***********************************************************************/
+PermutationTest::PermutationTest(string n, int i, int p, int s) : name(n), iters(i), processors(p), stopCount(s), numRun(0), numTests(0) {
+    m = MothurOut::getInstance();
+    if (processors < 1) { processors = 1; }
+}
+/***********************************************************************/
+//each call is a test of its own, so the pairwise tests of a command don't reuse the overall test's randomizations
+double PermutationTest::getPValue(Statistic statistic, int numIndexes, double observed, Tail tail) {
+    try {
+        RandomStream testStream(name, numTests++);
+
+        numRun = 0;
+        int numExtreme = 0;
+
+        //without a stop count all the iters run at once, otherwise in blocks so the threads don't run far past the stop
+        int blockSize = iters;
+        if (stopCount > 0) { blockSize = min(iters, 100 * processors); }
+
+        vector<char> extreme;
+        for (int first = 0; first < iters; first += blockSize) {
+            int numInBlock = min(blockSize, iters - first);
+            extreme.assign(numInBlock, 0);
+
+            int numThreads = min(processors, numInBlock);
+            vector<std::thread*> workerThreads;
+            for (int i = 1; i < numThreads; i++) {
+                int start = (numInBlock * (long long)i) / numThreads;
+                int end = (numInBlock * (long long)(i+1)) / numThreads;
+                workerThreads.push_back(new std::thread(&PermutationTest::driver, this, &statistic, numIndexes, observed, tail, &testStream, first, start, end-start, &extreme));
+            }
+
+            driver(&statistic, numIndexes, observed, tail, &testStream, first, 0, numInBlock / numThreads, &extreme);
+
+            for (int i = 0; i < workerThreads.size(); i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+
+            if (m->getControl_pressed()) { break; }
+
+            bool stopped = false;
+            for (int i = 0; i < numInBlock; i++) {
+                numRun++;
+                if (extreme[i]) { numExtreme++; }
+                if ((stopCount > 0) && (numExtreme >= stopCount)) { stopped = true; break; }
+            }
+            if (stopped) { break; }
+        }
+
+        if (numRun == 0) { return 0.0; }
+
+        return (numExtreme / (double) numRun);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "PermutationTest", "getPValue");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//a randomization reassigns the samples to the groups' slots, so the group sizes stay the same
+double PermutationTest::getPValue(GroupStatistic statistic, const vector<int>& samples, const vector<int>& groupStarts, double observed, Tail tail) {
+    try {
+        Statistic randomStatistic = [&](const vector<int>& permutation) {
+            vector<int> randomSamples(permutation.size());
+            for (int i = 0; i < permutation.size(); i++) { randomSamples[i] = samples[permutation[i]]; }
+            return statistic(randomSamples, groupStarts);
+        };
+
+        return getPValue(randomStatistic, samples.size(), observed, tail);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "PermutationTest", "getPValue");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//the samples of each group one after another, groupStarts ends with the number of samples
+void PermutationTest::getSamplesByGroup(map<string, vector<int> >& groupSampleMap, vector<int>& samples, vector<int>& groupStarts) {
+    samples.clear(); groupStarts.clear();
+    for (map<string, vector<int> >::iterator it = groupSampleMap.begin(); it != groupSampleMap.end(); it++) {
+        groupStarts.push_back(samples.size());
+        samples.insert(samples.end(), it->second.begin(), it->second.end());
+    }
+    groupStarts.push_back(samples.size());
+}
+/***********************************************************************/
+//randomization first+i gets stream first+i of the test, whichever thread runs it
+void PermutationTest::driver(Statistic* statistic, int numIndexes, double observed, Tail tail, RandomStream* testStream, int first, int start, int num, vector<char>* extreme) {
+    try {
+        vector<int> permutation(numIndexes);
+
+        for (int i = start; i < (start+num); i++) {
+            if (m->getControl_pressed()) { break; }
+
+            for (int j = 0; j < numIndexes; j++) { permutation[j] = j; }
+            RandomStream random = testStream->split(first+i);
+            random.shuffle(permutation);
+
+            double randomScore = (*statistic)(permutation);
+
+            if (tail == atMost)     { (*extreme)[i] = (randomScore <= observed); }
+            else                    { (*extreme)[i] = (randomScore >= observed); }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "PermutationTest", "driver");
+        exit(1);
+    }
+}
+/***********************************************************************/
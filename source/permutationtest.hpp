@@ -0,0 +1,49 @@
+//
+//  permutationtest.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef permutationtest_hpp
+#define permutationtest_hpp
+
+#include "mothurout.h"
+#include "randomstream.hpp"
+#include <functional>
+
+/***********************************************************************/
+//PermutationTest counts the randomizations that score at least as extreme as the data. The statistic is a function of
+//a permutation of the indexes 0 to numIndexes-1, slot i gets index permutation[i], so the identity scores the data.
+//Each randomization shuffles the identity with its own RandomStream, so the p-value doesn't depend on the processors.
+//
+//With a stop count the randomizations end once that many are as extreme as the data, and the p-value is estimated from
+//the randomizations run (Besag and Clifford 1991). Large p-values are decided after a few randomizations, small ones
+//still run all the iters. The randomizations are checked in order, so where the test stops doesn't depend on the threads.
+class PermutationTest {
+
+public:
+    typedef function<double (const vector<int>&)> Statistic; //called from several threads at once
+    typedef function<double (const vector<int>&, const vector<int>&)> GroupStatistic; //samples by group, where each group starts
+
+    enum Tail { atMost, atLeast }; //a randomization is as extreme if its statistic is <= or >= the data's
+
+    PermutationTest(string, int, int, int); //work name, iters, processors, stop count (0 runs all the iters)
+    ~PermutationTest() {}
+
+    double getPValue(Statistic, int, double, Tail); //statistic, number of indexes, the data's statistic
+    double getPValue(GroupStatistic, const vector<int>&, const vector<int>&, double, Tail); //statistic, samples by group, where each group starts, the data's statistic
+    int getNumRun() { return numRun; }              //randomizations the last p-value is from
+
+    static void getSamplesByGroup(map<string, vector<int> >&, vector<int>&, vector<int>&); //group -> samples, fills samples by group and where each group starts
+
+private:
+    MothurOut* m;
+    string name;
+    int iters, processors, stopCount, numRun, numTests;
+
+    void driver(Statistic*, int, double, Tail, RandomStream*, int, int, int, vector<char>*);
+};
+/***********************************************************************/
+
+#endif /* permutationtest_hpp */
@@ -0,0 +1,96 @@
+//
+//  randomstream.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "randomstream.hpp"
+
+/***********************************************************************/
+//scrambles the bits of x, from splitmix64
+static unsigned long long mixBits(unsigned long long x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+/***********************************************************************/
+RandomStream::RandomStream(string name, unsigned long long i) {
+    MothurOut* m = MothurOut::getInstance();
+    *this = RandomStream((unsigned long long)m->getRandomSeed(), name, i);
+}
+/***********************************************************************/
+RandomStream::RandomStream(string name, string itemName) {
+    MothurOut* m = MothurOut::getInstance();
+    *this = RandomStream((unsigned long long)m->getRandomSeed(), name, hashName(itemName));
+}
+/***********************************************************************/
+//the other constructors come here, so every seed is folded to the 32 bit key the same way
+RandomStream::RandomStream(unsigned long long seed, string name, unsigned long long i) {
+    *this = RandomStream((uint32_t)(seed ^ (seed >> 32)), (uint32_t)hashName(name), i);
+}
+/***********************************************************************/
+RandomStream::RandomStream(uint32_t seedKey, uint32_t nameKey, unsigned long long i) : item(i), block(0), numUsed(2) {
+    key[0] = seedKey; key[1] = nameKey;
+}
+/***********************************************************************/
+//the piece's stream keeps the seed and is named by this stream's name and item, so it doesn't overlap this stream,
+//its siblings or the pieces of other work items
+RandomStream RandomStream::split(unsigned long long piece) const {
+    unsigned long long parent = mixBits(((unsigned long long)key[1] << 32) ^ mixBits(item));
+    return RandomStream(key[0], (uint32_t)(parent ^ (parent >> 32)), piece);
+}
+/***********************************************************************/
+//64 bit FNV-1a, so the names give the same keys on every platform. Work names use the low 32 bits
+unsigned long long RandomStream::hashName(string name) {
+    unsigned long long hash = 14695981039346656037ULL;
+    for (int i = 0; i < name.length(); i++) { hash = (hash ^ (unsigned char)name[i]) * 1099511628211ULL; }
+    return hash;
+}
+/***********************************************************************/
+//10 Philox rounds of the counter (block, item) under the key, 128 random bits per block
+void RandomStream::generate() {
+    uint32_t counter[4] = { (uint32_t)block, (uint32_t)(block >> 32), (uint32_t)item, (uint32_t)(item >> 32) };
+    uint32_t k0 = key[0], k1 = key[1];
+
+    for (int round = 0; round < 10; round++) {
+        uint64_t product0 = (uint64_t)0xD2511F53u * counter[0];
+        uint64_t product1 = (uint64_t)0xCD9E8D57u * counter[2];
+
+        uint32_t next[4] = { (uint32_t)(product1 >> 32) ^ counter[1] ^ k0, (uint32_t)product1, (uint32_t)(product0 >> 32) ^ counter[3] ^ k1, (uint32_t)product0 };
+        counter[0] = next[0]; counter[1] = next[1]; counter[2] = next[2]; counter[3] = next[3];
+
+        k0 += 0x9E3779B9u; k1 += 0xBB67AE85u;
+    }
+
+    output[0] = counter[0]; output[1] = counter[1]; output[2] = counter[2]; output[3] = counter[3];
+    block++; numUsed = 0;
+}
+/***********************************************************************/
+RandomStream::result_type RandomStream::operator()() {
+    if (numUsed == 2) { generate(); }
+
+    result_type random = ((result_type)output[2*numUsed] << 32) | output[2*numUsed+1];
+    numUsed++;
+
+    return random;
+}
+/***********************************************************************/
+double RandomStream::getRandomDouble0to1() {
+    return ((*this)() >> 11) * (1.0 / 9007199254740992.0); //top 53 bits
+}
+/***********************************************************************/
+//rejects the few values that would make the low indexes more likely
+long long RandomStream::getRandomIndex(long long highest) {
+    if (highest <= 0) { return 0; }
+
+    unsigned long long range = (unsigned long long)highest + 1;
+    unsigned long long threshold = (0 - range) % range; //2^64 mod range
+
+    unsigned long long random = (*this)();
+    while (random < threshold) { random = (*this)(); }
+
+    return (long long)(random % range);
+}
+/***********************************************************************/
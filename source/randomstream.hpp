@@ -0,0 +1,62 @@
+//
+//  randomstream.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef randomstream_hpp
+#define randomstream_hpp
+
+#include "mothurout.h"
+#include <cstdint>
+
+/***********************************************************************/
+//RandomStream is a counter based generator (Philox4x32-10). The numbers are a function of the random seed, a name for
+//the work (usually the command) and a work item index, not of what ran before, so a work item gets the same numbers
+//whichever thread runs it and however many processors there are. Give each iteration, sequence or sample its own
+//stream, and use split to give the pieces of a work item streams of their own.
+//
+//Utils keeps its mersenne twister for serial code, use a RandomStream when the draws are made inside threads.
+class RandomStream {
+
+#ifdef UNIT_TEST
+    friend class TestRandomStream;
+#endif
+
+public:
+    typedef uint64_t result_type;
+
+    RandomStream(string, unsigned long long);                      //work name, work item. Uses the seed from set.seed
+    RandomStream(string, string);                                  //work name, name of the work item, like a sequence name. Uses the seed from set.seed
+    RandomStream(unsigned long long, string, unsigned long long);  //seed, work name, work item
+    ~RandomStream() {}
+
+    RandomStream split(unsigned long long) const; //stream for a piece of this work item, independent of this stream
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+    result_type operator()();
+
+    double getRandomDouble0to1();              //[0, 1)
+    long long getRandomIndex(long long);       //0 to highest, inclusive like Utils::getRandomIndex
+
+    //Fisher-Yates rather than std::shuffle, so the order is the same with any standard library
+    template<class T> void shuffle(T& items) {
+        auto first = items.begin();
+        for (long long i = (long long)(items.end() - first) - 1; i > 0; i--) { iter_swap(first + i, first + getRandomIndex(i)); }
+    }
+
+private:
+    uint32_t key[2];
+    unsigned long long item, block; //counter is (block, item)
+    uint32_t output[4];
+    int numUsed; //of the output's two 64 bit words
+
+    RandomStream(uint32_t, uint32_t, unsigned long long);
+    void generate();
+    static unsigned long long hashName(string);
+};
+/***********************************************************************/
+
+#endif /* randomstream_hpp */
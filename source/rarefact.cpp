@@ -8,14 +8,14 @@
  */
 
 #include "rarefact.h"
+#include "randomstream.hpp"
 
 
 /**************************************************************************************************/
 struct singleRarefactData {
     
-    long long nIters, numSeqs;
+    long long nIters, numSeqs, firstIter;
     MothurOut* m;
-    Utils util;
     OrderVector order;
     set<int> ends;
     vector<Display*> displays;
@@ -23,10 +23,10 @@ struct singleRarefactData {
     int increment;
     
     singleRarefactData(){}
-    singleRarefactData(long long st, Utils u, OrderVector o, set<int> ed, vector<Display*>& dis, string l, long long ns, int inc) {
+    singleRarefactData(long long st, long long fi, OrderVector o, set<int> ed, vector<Display*>& dis, string l, long long ns, int inc) {
         m = MothurOut::getInstance();
         nIters = st;
-        util = u;
+        firstIter = fi;
         order = o;
         ends = ed;
         displays = dis;
@@ -47,13 +47,17 @@ int singleDriver(singleRarefactData* params){
             
             RAbundVector lookup(params->order.getNumBins());
             SAbundVector rank(params->order.getMaxRank()+1);
-            params->util.mothurRandomShuffle(params->order);
+            
+            //each iteration shuffles the original order with its own stream, so the curves don't depend on processors
+            OrderVector order(params->order);
+            RandomStream random("rarefaction.single", params->firstIter+iter);
+            random.shuffle(order);
             
             for(int i=0;i<params->numSeqs;i++){
                 
                 if (params->m->getControl_pressed()) {  return 0;  }
                 
-                int binNumber = params->order.get(i);
+                int binNumber = order.get(i);
                 int abundance = lookup.get(binNumber);
                 
                 rank.set(abundance, rank.get(abundance)-1);
@@ -102,11 +106,13 @@ int Rarefact::getCurve(float percentFreq = 0.01, int nIters = 1000){
         vector<singleRarefactData*> data;
         
         //Lauch worker threads
+        long long firstIter = lines[0];
         for (int i = 0; i < processors-1; i++) {
             
             //make copy of order so we don't get access violations
             OrderVector newOrder(order);
-            singleRarefactData* dataBundle = new singleRarefactData(lines[i+1], util, newOrder, ends, displays, label, numSeqs, increment);
+            singleRarefactData* dataBundle = new singleRarefactData(lines[i+1], firstIter, newOrder, ends, displays, label, numSeqs, increment);
+            firstIter += lines[i+1];
             
             data.push_back(dataBundle);
             
@@ -115,7 +121,7 @@ int Rarefact::getCurve(float percentFreq = 0.01, int nIters = 1000){
         
         //make copy of lookup so we don't get access violations
         OrderVector newOrder(order);
-        singleRarefactData* dataBundle = new singleRarefactData(lines[0], util, newOrder, ends, displays, label, numSeqs, increment);
+        singleRarefactData* dataBundle = new singleRarefactData(lines[0], 0, newOrder, ends, displays, label, numSeqs, increment);
         singleDriver(dataBundle);
         
         for (int i = 0; i < processors-1; i++) {
@@ -138,19 +144,18 @@ int Rarefact::getCurve(float percentFreq = 0.01, int nIters = 1000){
 /**************************************************************************************************/
 struct sharedRarefactData {
     
-    long long nIters;
+    long long nIters, firstIter;
     MothurOut* m;
-    Utils util;
     vector<SharedRAbundVector*> lookup;
     vector<Display*> displays;
     string label;
     bool jumble;
     
     sharedRarefactData(){}
-    sharedRarefactData(long long st, Utils u, vector<SharedRAbundVector*>& o, vector<Display*>& dis, string l, bool ns) {
+    sharedRarefactData(long long st, long long fi, vector<SharedRAbundVector*>& o, vector<Display*>& dis, string l, bool ns) {
         m = MothurOut::getInstance();
         nIters = st;
-        util = u;
+        firstIter = fi;
         lookup = o;
         displays = dis;
         label = l;
@@ -180,12 +185,17 @@ int sharedDriver(sharedRarefactData* params){
         //register the displays
         rcd.registerDisplays(params->displays);
         
+        vector<SharedRAbundVector*> original = params->lookup;
         for(int iter=0;iter<params->nIters;iter++){
             
             for(int i=0;i<params->displays.size();i++){ params->displays[i]->init(params->label);	 }
             
-            //randomize the groups
-            if (params->jumble)  { params->util.mothurRandomShuffle(params->lookup); }
+            //randomize the groups, each iteration from the original order with its own stream
+            if (params->jumble)  {
+                params->lookup = original;
+                RandomStream random("rarefaction.shared", params->firstIter+iter);
+                random.shuffle(params->lookup);
+            }
             
             //make merge the size of lookup[0]
             SharedRAbundVector* merge = new SharedRAbundVector(params->lookup[0]->getNumBins());
@@ -240,12 +250,14 @@ int Rarefact::getSharedCurve(float percentFreq = 0.01, int nIters = 1000){
         vector<sharedRarefactData*> data;
         
         //Lauch worker threads
+        long long firstIter = lines[0];
         for (int i = 0; i < processors-1; i++) {
             
             //make copy of lookup so we don't get access violations
             vector<SharedRAbundVector*> copyLookup = lookup->getSharedRAbundVectors();
             label = copyLookup[0]->getLabel();
-            sharedRarefactData* dataBundle = new sharedRarefactData(lines[i+1], util, copyLookup,  displays, label, jumble);
+            sharedRarefactData* dataBundle = new sharedRarefactData(lines[i+1], firstIter, copyLookup,  displays, label, jumble);
+            firstIter += lines[i+1];
             
             data.push_back(dataBundle);
             
@@ -256,7 +268,7 @@ int Rarefact::getSharedCurve(float percentFreq = 0.01, int nIters = 1000){
         vector<SharedRAbundVector*> copyLookup = lookup->getSharedRAbundVectors();
         label = copyLookup[0]->getLabel();
 
-        sharedRarefactData* dataBundle = new sharedRarefactData(lines[0], util, copyLookup,  displays, label, jumble);
+        sharedRarefactData* dataBundle = new sharedRarefactData(lines[0], 0, copyLookup,  displays, label, jumble);
         sharedDriver(dataBundle);
         
         for (int i = 0; i < processors-1; i++) {
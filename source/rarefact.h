@@ -32,7 +32,6 @@ private:
 	SharedRAbundVectors* lookup;
 	MothurOut* m;
     bool jumble;
-    Utils util;
 	
 	int driver(vector<Display*>&, int, int);
 
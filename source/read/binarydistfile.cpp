@@ -0,0 +1,323 @@
+//
+//  binarydistfile.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "binarydistfile.hpp"
+
+#ifdef NON_WINDOWS
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+static const char binaryDistMagic[8] = { 'M', 'O', 'T', 'H', 'D', 'I', 'S', 'T' };
+static const uint32_t binaryDistVersion = 1;
+
+/**************************************************************************************************/
+BinaryDistFile::BinaryDistFile(string f) : filename(f), base(NULL), size(0), mapped(false), offsets(NULL), columns(NULL), dists(NULL), halfDists(NULL) {
+    try {
+        m = MothurOut::getInstance();
+        memset(&header, 0, sizeof(header));
+
+        if (!open()) { m->mothurOut("[ERROR]: " + filename + " is not a valid binary distance file.\n"); m->setControl_pressed(true); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BinaryDistFile", "BinaryDistFile");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+BinaryDistFile::~BinaryDistFile() {
+#ifdef NON_WINDOWS
+    if (mapped) { munmap((void*)base, size); }
+#endif
+}
+/**************************************************************************************************/
+bool BinaryDistFile::isBinary(string filename) {
+    try {
+        ifstream in(filename.c_str(), ios::binary);
+        if (!in) { return false; }
+
+        char magic[8];
+        in.read(magic, 8);
+
+        return ((in.gcount() == 8) && (memcmp(magic, binaryDistMagic, 8) == 0));
+    }
+    catch(exception& e) {
+        MothurOut::getInstance()->errorOut(e, "BinaryDistFile", "isBinary");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+bool BinaryDistFile::open() {
+    try {
+#ifdef NON_WINDOWS
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd == -1) { return false; }
+
+        struct stat fileStats;
+        if (fstat(fd, &fileStats) == -1) { ::close(fd); return false; }
+        size = fileStats.st_size;
+
+        if (size >= sizeof(BinaryDistHeader)) {
+            void* address = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address != MAP_FAILED) {
+                base = (const char*)address; mapped = true;
+                madvise(address, size, MADV_SEQUENTIAL);
+            }
+        }
+        ::close(fd);
+#endif
+        if (base == NULL) { //no mmap, read the whole file
+            ifstream in(filename.c_str(), ios::binary);
+            if (!in) { return false; }
+
+            in.seekg(0, ios::end); size = in.tellg(); in.seekg(0, ios::beg);
+            if (size < sizeof(BinaryDistHeader)) { return false; }
+
+            data.resize(size);
+            in.read(&data[0], size);
+            if (in.gcount() != size) { return false; }
+            base = &data[0];
+        }
+
+        memcpy(&header, base, sizeof(BinaryDistHeader));
+        if (memcmp(header.magic, binaryDistMagic, 8) != 0)                  { return false; }
+        if (header.version != binaryDistVersion)                            { m->mothurOut("[ERROR]: " + filename + " was written by a newer version of mothur.\n"); return false; }
+        if ((header.distBytes != 4) && (header.distBytes != 2))             { return false; }
+
+        size_t offsetsStart = sizeof(BinaryDistHeader) + header.namesBytes;
+        size_t columnsStart = offsetsStart + (header.numSeqs+1) * sizeof(uint64_t);
+        size_t distsStart = columnsStart + header.numDists * sizeof(uint32_t);
+        if (size != (distsStart + header.numDists * header.distBytes))      { return false; }
+
+        offsets = (const uint64_t*)(base + offsetsStart);
+        columns = (const uint32_t*)(base + columnsStart);
+        if (header.distBytes == 4)  { dists = (const float*)(base + distsStart);         }
+        else                        { halfDists = (const uint16_t*)(base + distsStart);  }
+
+        //names are the only part we copy, the readers look them up once per sequence
+        const char* name = base + sizeof(BinaryDistHeader);
+        const char* namesEnd = name + header.namesBytes;
+        names.reserve(header.numSeqs);
+        for (uint64_t i = 0; i < header.numSeqs; i++) {
+            const char* end = (const char*)memchr(name, '\0', namesEnd - name);
+            if (end == NULL) { return false; }
+            names.push_back(string(name, end));
+            name = end + 1;
+        }
+
+        if (offsets[header.numSeqs] != header.numDists) { return false; }
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BinaryDistFile", "open");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//IEEE half precision, rounding to nearest even. Distances are in [0, 1] so this keeps about 3 significant digits.
+uint16_t BinaryDistFile::floatToHalf(float value) {
+    uint32_t bits; memcpy(&bits, &value, 4);
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int exponent = ((bits >> 23) & 0xff) - 127 + 15;
+    uint32_t mantissa = bits & 0x7fffff;
+
+    if (((bits >> 23) & 0xff) == 0xff) { return sign | 0x7c00 | (mantissa ? 0x200 : 0); } //inf or nan
+    if (exponent >= 31) { return sign | 0x7c00; } //too big, inf
+
+    if (exponent <= 0) { //subnormal or zero
+        if (exponent < -10) { return sign; }
+        mantissa |= 0x800000;
+        int shift = 14 - exponent;
+        uint32_t half = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if ((remainder > halfway) || ((remainder == halfway) && (half & 1))) { half++; }
+        return sign | half;
+    }
+
+    uint32_t half = (exponent << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1fff;
+    if ((remainder > 0x1000) || ((remainder == 0x1000) && (half & 1))) { half++; } //a carry into the exponent is still correct
+
+    return sign | half;
+}
+/**************************************************************************************************/
+float BinaryDistFile::halfToFloat(uint16_t half) {
+    uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1f;
+    uint32_t mantissa = half & 0x3ff;
+    uint32_t bits;
+
+    if (exponent == 0) {
+        if (mantissa == 0) { bits = sign; }
+        else { //subnormal, normalize it
+            exponent = 127 - 15 + 1;
+            while ((mantissa & 0x400) == 0) { mantissa <<= 1; exponent--; }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+        }
+    }else if (exponent == 31) { bits = sign | 0x7f800000 | (mantissa << 13);                }
+    else                      { bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13); }
+
+    float value; memcpy(&value, &bits, 4);
+    return value;
+}
+/**************************************************************************************************/
+BinaryDistWriter::BinaryDistWriter(string f, const vector<string>& n, bool h, long long nb) : filename(f), names(n), half(h), numBlocks(nb), nextBlock(0), numDists(0) {
+    try {
+        m = MothurOut::getInstance();
+
+        columnsFile = filename + ".columns.temp";
+        distsFile = filename + ".dists.temp";
+        util.openOutputFileBinary(columnsFile, columnsOut);
+        util.openOutputFileBinary(distsFile, distsOut);
+
+        rowOffsets.reserve(names.size()+1);
+        rowOffsets.push_back(0);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BinaryDistWriter", "BinaryDistWriter");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void BinaryDistWriter::write(long long block, BinaryDistRows& rows) {
+    try {
+        std::lock_guard<std::mutex> guard(mutex);
+
+        if (block != nextBlock) { pending[block].columns.swap(rows.columns); pending[block].dists.swap(rows.dists); pending[block].rowEnds.swap(rows.rowEnds); return; }
+
+        writeBlock(rows); nextBlock++;
+
+        //write any blocks that were waiting on this one
+        map<long long, BinaryDistRows>::iterator it = pending.find(nextBlock);
+        while (it != pending.end()) {
+            writeBlock(it->second);
+            pending.erase(it);
+            nextBlock++;
+            it = pending.find(nextBlock);
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BinaryDistWriter", "write");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void BinaryDistWriter::writeBlock(BinaryDistRows& rows) {
+    try {
+        if (rows.columns.size() != 0) {
+            columnsOut.write((const char*)&rows.columns[0], rows.columns.size() * sizeof(uint32_t));
+
+            if (half) {
+                vector<uint16_t> halfDists(rows.dists.size());
+                for (size_t i = 0; i < rows.dists.size(); i++) { halfDists[i] = BinaryDistFile::floatToHalf(rows.dists[i]); }
+                distsOut.write((const char*)&halfDists[0], halfDists.size() * sizeof(uint16_t));
+            }else {
+                distsOut.write((const char*)&rows.dists[0], rows.dists.size() * sizeof(float));
+            }
+        }
+
+        for (size_t i = 0; i < rows.rowEnds.size(); i++) { rowOffsets.push_back(numDists + rows.rowEnds[i]); }
+        numDists += rows.columns.size();
+
+        rows.clear();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BinaryDistWriter", "writeBlock");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void BinaryDistWriter::close() {
+    try {
+        columnsOut.close(); distsOut.close();
+
+        if (nextBlock != numBlocks) { m->mothurOut("[ERROR]: missing distances while writing " + filename + ".\n"); m->setControl_pressed(true); }
+        if (rowOffsets.size() != names.size()+1) { m->mothurOut("[ERROR]: missing rows while writing " + filename + ".\n"); m->setControl_pressed(true); }
+
+        string nameTable;
+        for (size_t i = 0; i < names.size(); i++) { nameTable += names[i]; nameTable += '\0'; }
+        while (nameTable.length() % 8 != 0) { nameTable += '\0'; }
+
+        BinaryDistHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, binaryDistMagic, 8);
+        header.version = binaryDistVersion;
+        header.distBytes = half ? 2 : 4;
+        header.numSeqs = names.size();
+        header.numDists = numDists;
+        header.namesBytes = nameTable.length();
+
+        rowOffsets.resize(names.size()+1, numDists);
+
+        ofstream out;
+        util.openOutputFileBinary(filename, out);
+        out.write((const char*)&header, sizeof(header));
+        out.write(nameTable.c_str(), nameTable.length());
+        out.write((const char*)&rowOffsets[0], rowOffsets.size() * sizeof(uint64_t));
+        out.close();
+
+        util.appendBinaryFiles(columnsFile, filename); util.mothurRemove(columnsFile);
+        util.appendBinaryFiles(distsFile, filename);   util.mothurRemove(distsFile);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BinaryDistWriter", "close");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+ColumnDistReader::ColumnDistReader(string filename) : binary(NULL), row(0), k(0) {
+    try {
+        if (BinaryDistFile::isBinary(filename)) {
+            binary = new BinaryDistFile(filename);
+            if (!binary->isOpen()) { delete binary; binary = NULL; }
+        }
+        else { util.openInputFile(filename, in); }
+    }
+    catch(exception& e) {
+        MothurOut::getInstance()->errorOut(e, "ColumnDistReader", "ColumnDistReader");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+ColumnDistReader::~ColumnDistReader() { close(); }
+/**************************************************************************************************/
+bool ColumnDistReader::next(string& seqA, string& seqB, float& dist) {
+    try {
+        if (binary != NULL) {
+            while ((row < binary->getNumSeqs()) && (k == binary->getRowEnd(row))) { row++; }
+            if (row == binary->getNumSeqs()) { return false; }
+
+            seqA = binary->getName(row);
+            seqB = binary->getName(binary->getColumn(k));
+            dist = binary->getDist(k);
+            k++;
+
+            return true;
+        }
+
+        if (!in.is_open() || !in) { return false; }
+
+        in >> seqA >> seqB >> dist; util.gobble(in);
+
+        return true;
+    }
+    catch(exception& e) {
+        MothurOut::getInstance()->errorOut(e, "ColumnDistReader", "next");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void ColumnDistReader::close() {
+    if (binary != NULL) { delete binary; binary = NULL; }
+    if (in.is_open()) { in.close(); }
+}
+/**************************************************************************************************/
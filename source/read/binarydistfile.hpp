@@ -0,0 +1,142 @@
+//
+//  binarydistfile.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef binarydistfile_hpp
+#define binarydistfile_hpp
+
+#include "mothurout.h"
+#include "utils.hpp"
+#include <cstdint>
+
+/**************************************************************************************************/
+//The binary distance file written by dist.seqs and pairwise.seqs with output=binary. It holds the lower triangle of
+//the distance matrix in compressed sparse row form, so each distance below the cutoff is stored once as (row, column)
+//with column < row. The file is little endian and laid out so it can be memory mapped and used without parsing:
+//
+//  header      "MOTHDIST", uint32 version, uint32 bytes per distance (4 float32, 2 float16), uint64 numSeqs,
+//              uint64 numDists, uint64 bytes in the name table
+//  names       numSeqs null terminated names, padded with nulls to a multiple of 8 bytes
+//  offsets     numSeqs+1 uint64, the distances of row i are [offsets[i], offsets[i+1])
+//  columns     numDists uint32
+//  distances   numDists float32 or float16
+
+struct BinaryDistHeader {
+    char magic[8];
+    uint32_t version, distBytes;
+    uint64_t numSeqs, numDists, namesBytes;
+};
+/**************************************************************************************************/
+//BinaryDistFile maps a binary distance file for reading.
+
+class BinaryDistFile {
+
+public:
+
+    BinaryDistFile(string);
+    ~BinaryDistFile();
+
+    static bool isBinary(string); //true if the file starts with the binary distance file magic
+
+    bool isOpen()                           { return (base != NULL);    }
+    long long getNumSeqs()                  { return header.numSeqs;    }
+    long long getNumDists()                 { return header.numDists;   }
+    const string& getName(long long i)      { return names[i];          }
+    long long getRowStart(long long i)      { return offsets[i];        }
+    long long getRowEnd(long long i)        { return offsets[i+1];      }
+    long long getColumn(long long k)        { return columns[k];        }
+    float getDist(long long k)              { if (halfDists != NULL) { return halfToFloat(halfDists[k]); } return dists[k]; }
+
+    static uint16_t floatToHalf(float);
+    static float halfToFloat(uint16_t);
+
+private:
+
+    MothurOut* m;
+    string filename;
+    BinaryDistHeader header;
+    vector<string> names;
+    const char* base;
+    size_t size;
+    bool mapped;
+    vector<char> data; //file contents when the file can't be mapped
+    const uint64_t* offsets;
+    const uint32_t* columns;
+    const float* dists;
+    const uint16_t* halfDists;
+
+    bool open();
+
+    BinaryDistFile(const BinaryDistFile&);
+    BinaryDistFile& operator=(const BinaryDistFile&);
+};
+/**************************************************************************************************/
+//a block of consecutive rows of distances, filled by one thread and handed to a BinaryDistWriter
+
+struct BinaryDistRows {
+    vector<uint32_t> columns;
+    vector<float> dists;
+    vector<uint64_t> rowEnds; //columns.size() at the end of each row
+
+    void clear()                            { columns.clear(); dists.clear(); rowEnds.clear(); }
+    void add(long long column, float dist)  { columns.push_back(column); dists.push_back(dist); }
+    void endRow()                           { rowEnds.push_back(columns.size()); }
+};
+/**************************************************************************************************/
+//BinaryDistWriter collects the row blocks from the threads and writes them in block order. The columns and distances
+//are staged in temp files until close() knows the total number of distances and assembles the file.
+
+class BinaryDistWriter {
+
+public:
+
+    BinaryDistWriter(string, const vector<string>&, bool, long long); //filename, names, float16, number of blocks
+    ~BinaryDistWriter() {}
+
+    void write(long long, BinaryDistRows&); //block index, rows. Safe to call from several threads.
+    void close();
+
+    long long getNumDists() { return numDists; }
+
+private:
+
+    MothurOut* m;
+    Utils util;
+    string filename, columnsFile, distsFile;
+    vector<string> names;
+    bool half;
+    long long numBlocks, nextBlock, numDists;
+    vector<uint64_t> rowOffsets;
+    map<long long, BinaryDistRows> pending;
+    ofstream columnsOut, distsOut;
+    std::mutex mutex;
+
+    void writeBlock(BinaryDistRows&);
+};
+/**************************************************************************************************/
+//ColumnDistReader reads the "seqA seqB dist" triples of a column formatted distance file, or the distances of a
+//binary distance file, so the readers that walk column files can take either.
+
+class ColumnDistReader {
+
+public:
+
+    ColumnDistReader(string);
+    ~ColumnDistReader();
+
+    bool next(string&, string&, float&); //false at the end of the file
+    void close();
+
+private:
+
+    Utils util;
+    ifstream in;
+    BinaryDistFile* binary;
+    long long row, k;
+};
+/**************************************************************************************************/
+
+#endif /* binarydistfile_hpp */
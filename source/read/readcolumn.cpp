@@ -36,6 +36,22 @@ int ReadColumnMatrix::read(NameAssignment* nameMap){
 		int nseqs = nameMap->size();
         DMatrix->resize(nseqs);
 		list = new ListVector(nameMap->getListVector());
+        
+        if (BinaryDistFile::isBinary(distFile)) {
+            fileHandle.close();
+            
+            BinaryDistFile binaryFile(distFile);
+            if (m->getControl_pressed()) { return 0; }
+            
+            vector<int> indexes(binaryFile.getNumSeqs());
+            for (long long i = 0; i < binaryFile.getNumSeqs(); i++) {
+                map<string,int>::iterator it = nameMap->find(binaryFile.getName(i));
+                if(it == nameMap->end()){  m->mothurOut("AAError: Sequence '" + binaryFile.getName(i) + "' was not found in the names file, please correct\n"); exit(1);  }
+                indexes[i] = it->second;
+            }
+            
+            return readBinary(binaryFile, indexes);
+        }
 	
         int lt = 1;
 		int refRow = 0;	//we'll keep track of one cell - Cell(refRow,refCol) - and see if it's transpose
@@ -158,6 +174,21 @@ int ReadColumnMatrix::read(CountTable* countTable){
         DMatrix->resize(nseqs);
 		list = new ListVector(countTable->getListVector());
         
+        if (BinaryDistFile::isBinary(distFile)) {
+            fileHandle.close();
+            
+            BinaryDistFile binaryFile(distFile);
+            if (m->getControl_pressed()) { return 0; }
+            
+            vector<int> indexes(binaryFile.getNumSeqs());
+            for (long long i = 0; i < binaryFile.getNumSeqs(); i++) {
+                indexes[i] = countTable->get(binaryFile.getName(i));
+                if (m->getControl_pressed()) { exit(1); }
+            }
+            
+            return readBinary(binaryFile, indexes);
+        }
+        
 		int lt = 1;
 		int refRow = 0;	//we'll keep track of one cell - Cell(refRow,refCol) - and see if it's transpose
 		int refCol = 0; //shows up later - Cell(refCol,refRow).  If it does, then its a square matrix
@@ -265,6 +296,38 @@ int ReadColumnMatrix::read(CountTable* countTable){
 	}
 }
 
+/***********************************************************************/
+//the binary file is a lower triangle with each distance stored once, so there is no need to check for a square matrix
+int ReadColumnMatrix::readBinary(BinaryDistFile& binaryFile, vector<int>& indexes){
+	try {
+        for (long long i = 0; i < binaryFile.getNumSeqs(); i++) {
+            
+            if (m->getControl_pressed()) {  return 0; }
+            
+            int itA = indexes[i];
+            for (long long k = binaryFile.getRowStart(i); k < binaryFile.getRowEnd(i); k++) {
+                int itB = indexes[binaryFile.getColumn(k)];
+                float distance = binaryFile.getDist(k);
+                
+                if (util.isEqual(distance, -1)) { distance = 1000000; }
+                else if (sim) { distance = 1.0 - distance;  }  //user has entered a sim matrix that we need to convert.
+                
+                if(distance <= cutoff && itA != itB){
+                    if(itA > itB)   { PDistCell value(itA, distance); DMatrix->addCell(itB, value); }
+                    else            { PDistCell value(itB, distance); DMatrix->addCell(itA, value); }
+                }
+            }
+        }
+        
+		list->setLabel("0");
+		
+		return 1;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ReadColumnMatrix", "readBinary");
+		exit(1);
+	}
+}
 /***********************************************************************/
 ReadColumnMatrix::~ReadColumnMatrix(){}
 /***********************************************************************/
@@ -8,6 +8,7 @@
  */
 
 #include "splitmatrix.h"
+#include "binarydistfile.hpp"
 #include "phylotree.h"
 #include "distancecommand.h"
 #include "seqsummarycommand.h"
@@ -240,8 +241,7 @@ int SplitMatrix::splitDistanceFileByTax(map<string, int>& seqGroup, int numGroup
 		map<string, int>::iterator it2;
 		
         ofstream outFile;
-		ifstream dFile;
-		util.openInputFile(distFile, dFile);
+		ColumnDistReader dFile(distFile);
 		
 		
 		for (int i = 0; i < numGroups; i++) { //remove old temp files, just in case
@@ -258,14 +258,12 @@ int SplitMatrix::splitDistanceFileByTax(map<string, int>& seqGroup, int numGroup
 		vector<bool> validDistances;   validDistances.resize(numGroups, false); 
 		
 		//for each distance
-		while(dFile){
-			string seqA, seqB;
-			float dist;
+		string seqA, seqB;
+		float dist;
+		while(dFile.next(seqA, seqB, dist)){
 			
 			if (m->getControl_pressed()) { dFile.close(); for (int i = 0; i < numGroups; i++) { util.mothurRemove((distFile + "." + toString(i) + ".temp"));	} }
 			
-			dFile >> seqA >> seqB >> dist;  util.gobble(dFile);
-			
 			//if both sequences are in the same group then they are within the cutoff
 			it = seqGroup.find(seqA);
 			it2 = seqGroup.find(seqB);
@@ -339,14 +337,11 @@ int SplitMatrix::splitDistanceLarge(){
 		int numGroups = 0;
 
 		//ofstream outFile;
-		ifstream dFile;
-		util.openInputFile(distFile, dFile);
+		ColumnDistReader dFile(distFile);
 	
-		while(dFile){
-			string seqA, seqB;
-			float dist;
-
-			dFile >> seqA >> seqB >> dist;
+		string seqA, seqB;
+		float dist;
+		while(dFile.next(seqA, seqB, dist)){
 			
 			if (m->getControl_pressed()) {   dFile.close();  for(int i=0;i<numGroups;i++){	if(groups[i].size() > 0){  util.mothurRemove((distFile + "." + toString(i) + ".temp")); }  } return 0; }
 					
@@ -490,7 +485,6 @@ int SplitMatrix::splitDistanceLarge(){
 					}
 				}
 			}
-			util.gobble(dFile);
 		}
 		dFile.close();
         
@@ -812,14 +806,11 @@ int SplitMatrix::splitDistanceRAM(){
 		
 		int numGroups = 0;
 
-		ifstream dFile;
-		util.openInputFile(distFile, dFile);
-
-		while(dFile){
-			string seqA, seqB;
-			float dist;
+		ColumnDistReader dFile(distFile);
 
-			dFile >> seqA >> seqB >> dist;
+		string seqA, seqB;
+		float dist;
+		while(dFile.next(seqA, seqB, dist)){
 			
 			if (m->getControl_pressed()) {   dFile.close();  for(int i=0;i<numGroups;i++){	if(groups[i].size() > 0){  util.mothurRemove((distFile + "." + toString(i) + ".temp")); }  } return 0; }
 					
@@ -887,7 +878,6 @@ int SplitMatrix::splitDistanceRAM(){
 					}
 				}
 			}
-			util.gobble(dFile);
 		}
 		dFile.close();
 		
@@ -0,0 +1,178 @@
+//
+//  sharedwriter.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "sharedwriter.hpp"
+#include "writer.h"
+
+static const long long maxWaitingBytes = 67108864; //spill waiting streams to disk past 64MB
+
+/***********************************************************************/
+SynchronizedOutputFile::SynchronizedOutputFile (const string& p) : path(p) {
+    util.openOutputFile(p, out);
+    start();
+}
+/***********************************************************************/
+SynchronizedOutputFile::SynchronizedOutputFile (const string& p, bool append) : path(p) {
+    util.openOutputFileAppend(p, out);
+    start();
+}
+/***********************************************************************/
+void SynchronizedOutputFile::start() {
+    tail = new Block(); //the queue always holds one block the flusher is done with
+    head = tail;
+    done = false; flusherWaiting = false;
+    nextStream = 0; waitingBytes = 0;
+    flusher = new std::thread(&SynchronizedOutputFile::flush, this);
+}
+/***********************************************************************/
+void SynchronizedOutputFile::write (long long stream, string& dataToWrite, bool endOfStream) {
+    Block* block = new Block();
+    block->stream = stream;
+    block->endOfStream = endOfStream;
+    block->data.swap(dataToWrite);
+    push(block);
+}
+/***********************************************************************/
+//multiple producer, single consumer queue. A producer swaps itself in as the head and then links the old head to it.
+void SynchronizedOutputFile::push (Block* block) {
+    Block* previous = head.exchange(block, std::memory_order_acq_rel);
+    previous->next.store(block, std::memory_order_seq_cst);
+
+    if (flusherWaiting.load(std::memory_order_seq_cst)) { wakeFlusher(); }
+}
+/***********************************************************************/
+//taking the lock means the flusher is either still checking the queue or already waiting, never between the two
+void SynchronizedOutputFile::wakeFlusher () {
+    std::lock_guard<std::mutex> lock(flusherMutex);
+    blockPushed.notify_one();
+}
+/***********************************************************************/
+//the next block becomes the new tail, so we take its contents and leave it empty
+bool SynchronizedOutputFile::pop (long long& stream, bool& endOfStream, string& data) {
+    Block* next = tail->next.load(std::memory_order_acquire);
+    if (next == NULL) { return false; }
+
+    stream = next->stream; endOfStream = next->endOfStream; data.swap(next->data);
+
+    delete tail;
+    tail = next;
+
+    return true;
+}
+/***********************************************************************/
+void SynchronizedOutputFile::flush () {
+    long long stream; bool endOfStream; string data;
+
+    while (true) {
+        if (pop(stream, endOfStream, data)) { writeBlock(stream, endOfStream, data); data.clear(); continue; }
+
+        if (done.load(std::memory_order_acquire)) { //all the writers are finished, write what's left
+            while (pop(stream, endOfStream, data)) { writeBlock(stream, endOfStream, data); data.clear(); }
+            break;
+        }
+
+        //sleep until a block is pushed or close() is called
+        std::unique_lock<std::mutex> lock(flusherMutex);
+        flusherWaiting.store(true, std::memory_order_seq_cst);
+        blockPushed.wait(lock, [this] { return (tail->next.load(std::memory_order_seq_cst) != NULL) || done.load(std::memory_order_seq_cst); });
+        flusherWaiting.store(false, std::memory_order_seq_cst);
+    }
+}
+/***********************************************************************/
+void SynchronizedOutputFile::writeBlock (long long stream, bool endOfStream, string& data) {
+    if ((stream == -1) || (stream == nextStream)) {
+        out.write(data.c_str(), data.length());
+        if (endOfStream && (stream != -1)) { nextStream++; writeWaiting(); }
+        return;
+    }
+
+    WaitingStream& waitingStream = waiting[stream];
+    waitingStream.data.append(data);
+    waitingBytes += data.length();
+    if (endOfStream) { waitingStream.ended = true; }
+
+    if (waitingBytes > maxWaitingBytes) {
+        for (map<long long, WaitingStream>::iterator it = waiting.begin(); it != waiting.end(); it++) { spill(it->first, it->second); }
+    }
+}
+/***********************************************************************/
+//writes the streams that were waiting on the stream that just ended
+void SynchronizedOutputFile::writeWaiting () {
+    map<long long, WaitingStream>::iterator it = waiting.find(nextStream);
+
+    while (it != waiting.end()) {
+        WaitingStream& waitingStream = it->second;
+
+        if (waitingStream.spillFile != "") {
+            ifstream in(waitingStream.spillFile.c_str(), ios::binary);
+            char buffer[65536];
+            while (in) {
+                in.read(buffer, sizeof(buffer));
+                out.write(buffer, in.gcount());
+            }
+            in.close();
+            util.mothurRemove(waitingStream.spillFile);
+        }
+
+        out.write(waitingStream.data.c_str(), waitingStream.data.length());
+        waitingBytes -= waitingStream.data.length();
+
+        bool ended = waitingStream.ended;
+        waiting.erase(it);
+
+        if (!ended) { break; } //the rest of this stream will be written as it arrives
+
+        nextStream++;
+        it = waiting.find(nextStream);
+    }
+}
+/***********************************************************************/
+void SynchronizedOutputFile::spill (long long stream, WaitingStream& waitingStream) {
+    if (waitingStream.data.length() == 0) { return; }
+
+    if (waitingStream.spillFile == "") { waitingStream.spillFile = path + "." + toString(stream) + ".stream.temp"; util.mothurRemove(waitingStream.spillFile); }
+
+    ofstream spillOut(waitingStream.spillFile.c_str(), ios::binary | ios::app);
+    spillOut.write(waitingStream.data.c_str(), waitingStream.data.length());
+    spillOut.close();
+
+    waitingBytes -= waitingStream.data.length();
+    string().swap(waitingStream.data);
+}
+/***********************************************************************/
+void SynchronizedOutputFile::close () {
+    if (flusher == NULL) { return; }
+
+    //the threads are done with their writers by now, hand off what they hold
+    {
+        std::lock_guard<std::mutex> lock(writersMutex);
+        for (set<OutputWriter*>::iterator it = writers.begin(); it != writers.end(); it++) { (*it)->finish(); }
+        writers.clear();
+    }
+
+    done.store(true, std::memory_order_seq_cst);
+    wakeFlusher();
+    flusher->join();
+    delete flusher; flusher = NULL;
+    delete tail; tail = NULL;
+
+    //streams that were never ended, or followed a stream that wasn't, go out in stream order
+    while (waiting.size() != 0) { nextStream = waiting.begin()->first; writeWaiting(); }
+
+    if (out.is_open()) { out.close(); }
+}
+/***********************************************************************/
+void SynchronizedOutputFile::addWriter (OutputWriter* writer) {
+    std::lock_guard<std::mutex> lock(writersMutex);
+    writers.insert(writer);
+}
+/***********************************************************************/
+void SynchronizedOutputFile::removeWriter (OutputWriter* writer) {
+    std::lock_guard<std::mutex> lock(writersMutex);
+    if (writers.erase(writer) != 0) { writer->finish(); }
+}
+/***********************************************************************/
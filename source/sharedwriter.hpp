@@ -11,28 +11,82 @@
 
 #include "mothurout.h"
 #include "utils.hpp"
+#include <atomic>
+#include <condition_variable>
+
+class OutputWriter;
 
 /***********************************************************************/
+//SynchronizedOutputFile owns the output file and a flusher thread that does all the writing to it. Writers hand
+//their filled buffers to the flusher through a lock free queue, so the threads never wait on each other to write.
+//When the queue is empty the flusher sleeps until a writer pushes a block, a writer only locks to wake it.
+//Data written to stream -1 is written as it arrives. Data written to a numbered stream is written in stream order,
+//stream k once streams 0 to k-1 have ended. Streams that have to wait are held in memory, and spilled to a temp file
+//if too much is waiting.
 class SynchronizedOutputFile {
 public:
-    SynchronizedOutputFile (const string& p)                : path(p) { util.openOutputFile(p, out);        }
-    SynchronizedOutputFile (const string& p, bool append)   : path(p) { util.openOutputFileAppend(p, out);  }
-    ~SynchronizedOutputFile() { if (out.is_open()) { out.close(); } } //if we forgot to close()
-    
-    void write (const string& dataToWrite) {
-        std::lock_guard<std::mutex> lock((writerMutex)); // Ensure that only one thread can execute at a time
-        out << dataToWrite;
-    }
-    void close() { if (out.is_open()) { out.close(); } }
-    
+    SynchronizedOutputFile (const string& p);
+    SynchronizedOutputFile (const string& p, bool append);
+    ~SynchronizedOutputFile() { close(); } //if we forgot to close()
+
+    void write (const string& dataToWrite) { string temp = dataToWrite; write(-1, temp, false); }
+    void write (long long stream, string& dataToWrite, bool endOfStream); //takes the contents of dataToWrite
+    void close(); //writes anything the writers still hold, then closes the file
+
     void setFixedShowPoint()    {  out.setf(ios::fixed, ios::showpoint);    }
     void setPrecision(int p)    {  out << setprecision(p);                  }
-    
+
 private:
+    friend class OutputWriter;
+
+    struct Block {
+        std::atomic<Block*> next;
+        long long stream;
+        bool endOfStream;
+        string data;
+
+        Block() : next(NULL), stream(-1), endOfStream(false) {}
+    };
+
+    struct WaitingStream {
+        string data, spillFile;
+        bool ended;
+
+        WaitingStream() : ended(false) {}
+    };
+
     string path;
-    std::mutex writerMutex;
     Utils util;
     ofstream out;
+
+    std::atomic<Block*> head;   //producers add blocks at the head
+    Block* tail;                //the flusher takes blocks from the tail, tail is always an already written block
+    std::atomic<bool> done;
+    std::thread* flusher;
+
+    std::mutex flusherMutex;                //guards the flusher's sleep, so a wakeup isn't lost
+    std::condition_variable blockPushed;
+    std::atomic<bool> flusherWaiting;
+
+    long long nextStream, waitingBytes; //only used by the flusher
+    map<long long, WaitingStream> waiting;
+
+    std::mutex writersMutex;    //guards writers, only locked when a writer is created or deleted
+    set<OutputWriter*> writers;
+
+    void start();
+    void push(Block*);
+    bool pop(long long&, bool&, string&);
+    void flush();
+    void wakeFlusher();
+    void writeBlock(long long, bool, string&);
+    void writeWaiting();
+    void spill(long long, WaitingStream&);
+    void addWriter(OutputWriter*);
+    void removeWriter(OutputWriter*);
+
+    SynchronizedOutputFile(const SynchronizedOutputFile&);
+    SynchronizedOutputFile& operator=(const SynchronizedOutputFile&);
 };
 
 /***********************************************************************/
@@ -0,0 +1,328 @@
+//
+//  simdoverlap.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "simdoverlap.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    #define USE_X86_KERNELS
+    #include <immintrin.h>
+#endif
+
+static const int laneCount = 16;
+static const int maxInt16Score = 30000; //leaves room for the gap ramps added to a block
+
+/**************************************************************************************************/
+SIMDOverlap::SIMDOverlap(float gO, float gE, float f, float mm, bool a, int r) :
+Alignment(), gapOpen(gO), gapExtend(gE), match(f), mismatch(mm), affine(a) {
+    try {
+        nRows = r; nCols = r;
+        numBlocks = 0; upFromRow = 0; leftFromColumn = 0;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SIMDOverlap", "SIMDOverlap");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+static bool isWholeNumber(float value) { return (value == floor(value)) && (fabs(value) < 1000); }
+/**************************************************************************************************/
+//int16 scores are exact when the parameters are whole numbers and no score can get past maxInt16Score
+bool SIMDOverlap::fitsInt16() {
+    if (!isWholeNumber(match) || !isWholeNumber(mismatch) || !isWholeNumber(gapOpen) || !isWholeNumber(gapExtend)) { return false; }
+    if (affine && (gapOpen > 0)) { return false; } //the left scan assumes opening a gap never helps
+
+    float perCell = fabs(match) + fabs(mismatch) + fabs(gapOpen) + fabs(gapExtend);
+    return (((lA + lB + 2 * laneCount) * perCell) < maxInt16Score);
+}
+/**************************************************************************************************/
+#ifdef USE_X86_KERNELS
+
+//x moved up k lanes across the whole register, the bottom k lanes come from fill
+template<int k> __attribute__((target("avx2")))
+static inline __m256i shiftLanesIn(__m256i x, __m256i fill) {
+    __m256i low = _mm256_permute2x128_si256(x, fill, 0x02); //fill's low half, x's low half
+    return _mm256_alignr_epi8(x, low, 16 - 2 * k);
+}
+/**************************************************************************************************/
+//running max of values[t] + (s-t)*gap over t <= s within the register
+__attribute__((target("avx2")))
+static inline __m256i prefixMaxScan(__m256i values, int gap) {
+    const __m256i lowest = _mm256_set1_epi16(INT16_MIN);
+    values = _mm256_max_epi16(values, _mm256_adds_epi16(shiftLanesIn<1>(values, lowest), _mm256_set1_epi16(gap)));
+    values = _mm256_max_epi16(values, _mm256_adds_epi16(shiftLanesIn<2>(values, lowest), _mm256_set1_epi16(2 * gap)));
+    values = _mm256_max_epi16(values, _mm256_adds_epi16(shiftLanesIn<4>(values, lowest), _mm256_set1_epi16(4 * gap)));
+    values = _mm256_max_epi16(values, _mm256_adds_epi16(shiftLanesIn<8>(values, lowest), _mm256_set1_epi16(8 * gap)));
+    return values;
+}
+/**************************************************************************************************/
+//the left and up pointers of 16 cells as two 16 bit words
+__attribute__((target("avx2")))
+static inline void packPointers(__m256i isLeft, __m256i isUp, uint16_t& left, uint16_t& up) {
+    //per half, 8 left bytes then 8 up bytes
+    unsigned int bits = (unsigned int)_mm256_movemask_epi8(_mm256_packs_epi16(isLeft, isUp));
+    left = (uint16_t)((bits & 0xFF) | ((bits >> 8) & 0xFF00));
+    up = (uint16_t)(((bits >> 8) & 0xFF) | ((bits >> 16) & 0xFF00));
+}
+/**************************************************************************************************/
+struct SIMDOverlapRows {
+    const int16_t* codesA;
+    int16_t* previous;
+    int16_t* current;
+    int16_t* gaps;
+    uint16_t* leftBits;
+    uint16_t* upBits;
+    float* lastColumn;
+};
+/**************************************************************************************************/
+__attribute__((target("avx2")))
+static void fillNeedlemanAVX2(const string& seqB, int lA, int lB, int numBlocks, int gap, int match, int mismatch, SIMDOverlapRows& rows) {
+    int16_t* previous = rows.previous;
+    int16_t* current = rows.current;
+
+    __m256i gapVector = _mm256_set1_epi16(gap);
+    __m256i matchVector = _mm256_set1_epi16(match);
+    __m256i mismatchVector = _mm256_set1_epi16(mismatch);
+    __m256i gapRamp = _mm256_setr_epi16(gap, 2*gap, 3*gap, 4*gap, 5*gap, 6*gap, 7*gap, 8*gap, 9*gap, 10*gap, 11*gap, 12*gap, 13*gap, 14*gap, 15*gap, 16*gap);
+
+    for (int i = 1; i < lB; i++) {
+        __m256i base = _mm256_set1_epi16(seqB[i]);
+        uint16_t* leftRow = rows.leftBits + (long long)i * numBlocks;
+        uint16_t* upRow = rows.upBits + (long long)i * numBlocks;
+        int16_t carry = 0; //score of the cell left of the block
+
+        for (int b = 0; b < numBlocks; b++) {
+            int j = 1 + b * laneCount;
+
+            __m256i same = _mm256_cmpeq_epi16(_mm256_loadu_si256((const __m256i*)(rows.codesA+j)), base);
+            __m256i diagonal = _mm256_adds_epi16(_mm256_loadu_si256((const __m256i*)(previous+j-1)), _mm256_blendv_epi8(mismatchVector, matchVector, same));
+            __m256i up = _mm256_adds_epi16(_mm256_loadu_si256((const __m256i*)(previous+j)), gapVector);
+            __m256i best = _mm256_max_epi16(diagonal, up);
+
+            __m256i carried = _mm256_set1_epi16(carry);
+            __m256i scores = _mm256_max_epi16(prefixMaxScan(best, gap), _mm256_adds_epi16(carried, gapRamp));
+            __m256i left = _mm256_adds_epi16(shiftLanesIn<1>(scores, carried), gapVector);
+
+            //diagonal wins ties with up and left, up wins ties with left
+            __m256i isLeft = _mm256_cmpgt_epi16(left, best);
+            __m256i isUp = _mm256_andnot_si256(_mm256_cmpgt_epi16(left, up), _mm256_cmpgt_epi16(up, diagonal));
+            packPointers(isLeft, isUp, leftRow[b], upRow[b]);
+
+            _mm256_storeu_si256((__m256i*)(current+j), scores);
+            carry = (int16_t)_mm256_extract_epi16(scores, 15);
+        }
+
+        rows.lastColumn[i] = current[lA-1];
+        swap(previous, current);
+    }
+
+    rows.previous = previous; rows.current = current;
+}
+/**************************************************************************************************/
+//gapScores holds the up gap scores of the row above. The left gap score of a cell is the best of (left gap or score) + gapOpen
+//of the cell to its left, plus gapExtend, which is scanned as a running max of the best up or diagonal score + gapOpen.
+__attribute__((target("avx2")))
+static void fillGotohAVX2(const string& seqB, int lA, int lB, int numBlocks, int gapOpen, int gapExtend, int match, int mismatch, SIMDOverlapRows& rows) {
+    int16_t* previous = rows.previous;
+    int16_t* current = rows.current;
+
+    __m256i openVector = _mm256_set1_epi16(gapOpen);
+    __m256i extendVector = _mm256_set1_epi16(gapExtend);
+    __m256i matchVector = _mm256_set1_epi16(match);
+    __m256i mismatchVector = _mm256_set1_epi16(mismatch);
+    int e = gapExtend;
+    __m256i extendRamp = _mm256_setr_epi16(e, 2*e, 3*e, 4*e, 5*e, 6*e, 7*e, 8*e, 9*e, 10*e, 11*e, 12*e, 13*e, 14*e, 15*e, 16*e);
+
+    for (int i = 1; i < lB; i++) {
+        __m256i base = _mm256_set1_epi16(seqB[i]);
+        uint16_t* leftRow = rows.leftBits + (long long)i * numBlocks;
+        uint16_t* upRow = rows.upBits + (long long)i * numBlocks;
+        int16_t carry = (int16_t)max(0, gapOpen); //max(left gap, score + gapOpen) of column 0
+
+        for (int b = 0; b < numBlocks; b++) {
+            int j = 1 + b * laneCount;
+
+            __m256i same = _mm256_cmpeq_epi16(_mm256_loadu_si256((const __m256i*)(rows.codesA+j)), base);
+            __m256i diagonal = _mm256_adds_epi16(_mm256_loadu_si256((const __m256i*)(previous+j-1)), _mm256_blendv_epi8(mismatchVector, matchVector, same));
+
+            __m256i above = _mm256_adds_epi16(_mm256_loadu_si256((const __m256i*)(previous+j)), openVector);
+            __m256i up = _mm256_adds_epi16(_mm256_max_epi16(_mm256_loadu_si256((const __m256i*)(rows.gaps+j)), above), extendVector);
+            _mm256_storeu_si256((__m256i*)(rows.gaps+j), up);
+
+            __m256i best = _mm256_max_epi16(up, diagonal);
+
+            __m256i carried = _mm256_set1_epi16(carry);
+            __m256i opened = _mm256_max_epi16(prefixMaxScan(_mm256_adds_epi16(best, openVector), gapExtend), _mm256_adds_epi16(carried, extendRamp));
+            __m256i left = _mm256_adds_epi16(shiftLanesIn<1>(opened, carried), extendVector);
+            __m256i scores = _mm256_max_epi16(best, left);
+
+            //left needs to beat up and diagonal, up needs to beat diagonal
+            __m256i leftOverUp = _mm256_cmpgt_epi16(left, up);
+            __m256i isLeft = _mm256_and_si256(leftOverUp, _mm256_cmpgt_epi16(left, diagonal));
+            __m256i isUp = _mm256_andnot_si256(leftOverUp, _mm256_cmpgt_epi16(up, diagonal));
+            packPointers(isLeft, isUp, leftRow[b], upRow[b]);
+
+            _mm256_storeu_si256((__m256i*)(current+j), scores);
+            carry = (int16_t)_mm256_extract_epi16(opened, 15);
+        }
+
+        rows.lastColumn[i] = current[lA-1];
+        swap(previous, current);
+    }
+
+    rows.previous = previous; rows.current = current;
+}
+#endif
+/**************************************************************************************************/
+static bool useAVX2Alignment() {
+#ifdef USE_X86_KERNELS
+    static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+    return hasAVX2;
+#else
+    return false;
+#endif
+}
+/**************************************************************************************************/
+void SIMDOverlap::align(string A, string B, bool createBaseMap){
+    try {
+        seqA = ' ' + A;	lA = seqA.length();		//	the algorithm requires that the first character be a dummy value
+        seqB = ' ' + B;	lB = seqB.length();		//	the algorithm requires that the first character be a dummy value
+
+        numBlocks = (lA - 1 + laneCount - 1) / laneCount;
+        leftBits.assign((long long)lB * numBlocks, 0);
+        upBits.assign((long long)lB * numBlocks, 0);
+        lastColumn.assign(lB, 0);
+        lastRow.assign(lA, 0);
+
+        if (useAVX2Alignment() && fitsInt16()) { fillVector(); }
+        else { fillScalar(); }
+
+        setOverlap();                           //	Fix the gaps at the ends of the sequences
+        traceBack(createBaseMap);               //	Construct the alignment and set seqAaln and seqBaln
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SIMDOverlap", "align");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//the same recursions and ties as NeedlemanOverlap::align and GotohOverlap::align, a row at a time
+void SIMDOverlap::fillScalar() {
+    try {
+        int rowLength = numBlocks * laneCount + 1;
+        previousFloat.assign(rowLength, 0); currentFloat.assign(rowLength, 0); gapFloat.assign(rowLength, 0);
+
+        for (int i = 1; i < lB; i++) {
+            uint16_t* leftRow = &leftBits[0] + (long long)i * numBlocks;
+            uint16_t* upRow = &upBits[0] + (long long)i * numBlocks;
+            float leftGap = 0;
+
+            for (int j = 1; j < lA; j++) {
+                float diagonal = previousFloat[j-1] + ((seqB[i] == seqA[j]) ? match : mismatch);
+                char prevCell;
+
+                if (affine) {
+                    leftGap = max(leftGap, currentFloat[j-1] + gapOpen) + gapExtend;
+                    gapFloat[j] = max(gapFloat[j], previousFloat[j] + gapOpen) + gapExtend;
+
+                    if (leftGap > gapFloat[j])  {   if (leftGap > diagonal)     { currentFloat[j] = leftGap; prevCell = 'l'; }      else { currentFloat[j] = diagonal; prevCell = 'd'; } }
+                    else                        {   if (gapFloat[j] > diagonal) { currentFloat[j] = gapFloat[j]; prevCell = 'u'; }  else { currentFloat[j] = diagonal; prevCell = 'd'; } }
+                }else {
+                    float up = previousFloat[j] + gapOpen;
+                    float left = currentFloat[j-1] + gapOpen;
+
+                    if (diagonal >= up) {   if (diagonal >= left)   { currentFloat[j] = diagonal; prevCell = 'd'; }    else { currentFloat[j] = left; prevCell = 'l'; } }
+                    else                {   if (up >= left)         { currentFloat[j] = up; prevCell = 'u'; }          else { currentFloat[j] = left; prevCell = 'l'; } }
+                }
+
+                if (prevCell == 'l')        { leftRow[(j-1) / laneCount] |= (1 << ((j-1) % laneCount)); }
+                else if (prevCell == 'u')   { upRow[(j-1) / laneCount] |= (1 << ((j-1) % laneCount));   }
+            }
+
+            lastColumn[i] = currentFloat[lA-1];
+            previousFloat.swap(currentFloat);
+        }
+
+        if (lB > 1) { for (int j = 0; j < lA; j++) { lastRow[j] = previousFloat[j]; } }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SIMDOverlap", "fillScalar");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void SIMDOverlap::fillVector() {
+    try {
+#ifdef USE_X86_KERNELS
+        int rowLength = numBlocks * laneCount + 1 + laneCount; //room for the loads of the last block
+        previousScores.assign(rowLength, 0); currentScores.assign(rowLength, 0); gapScores.assign(rowLength, 0);
+
+        codesA.assign(rowLength, -1); //the columns past the end of seqA never match
+        for (int j = 1; j < lA; j++) { codesA[j] = seqA[j]; }
+
+        SIMDOverlapRows rows;
+        rows.codesA = &codesA[0]; rows.previous = &previousScores[0]; rows.current = &currentScores[0]; rows.gaps = &gapScores[0];
+        rows.leftBits = &leftBits[0]; rows.upBits = &upBits[0]; rows.lastColumn = &lastColumn[0];
+
+        if (lA > 1) {
+            if (affine) { fillGotohAVX2(seqB, lA, lB, numBlocks, (int)gapOpen, (int)gapExtend, (int)match, (int)mismatch, rows); }
+            else        { fillNeedlemanAVX2(seqB, lA, lB, numBlocks, (int)gapOpen, (int)match, (int)mismatch, rows); }
+        }
+
+        if (lB > 1) { for (int j = 0; j < lA; j++) { lastRow[j] = rows.previous[j]; } }
+#endif
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SIMDOverlap", "fillVector");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//Overlap::setOverlap on the saved last column and row. Instead of rewriting pointers, the traceback is told to go up the
+//last column from upFromRow or left along the last row from leftFromColumn.
+void SIMDOverlap::setOverlap() {
+    try {
+        int row = lB-1;
+        int column = lA-1;
+
+        float maxScore = -100;
+        int rowIndex = column; //Overlap starts both searches from the other dimension's end
+        for (int i = 0; i < lB; i++) { if (lastColumn[i] >= maxScore) { rowIndex = i; maxScore = lastColumn[i]; } }
+
+        maxScore = -100;
+        int colIndex = row;
+        for (int i = 0; i < lA; i++) { if (lastRow[i] >= maxScore) { colIndex = i; maxScore = lastRow[i]; } }
+
+        upFromRow = lB; leftFromColumn = lA;
+
+        float rowScore = (colIndex < lA) ? lastRow[colIndex] : lastRow[column];
+        float columnScore = (rowIndex < lB) ? lastColumn[rowIndex] : lastColumn[row];
+
+        if (colIndex == column && rowIndex == row) {}   //	if the max values are the lower right corner, then we're good
+        else if (rowScore < columnScore)    { upFromRow = rowIndex + 1;         }
+        else                                { leftFromColumn = colIndex + 1;    }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SIMDOverlap", "setOverlap");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+char SIMDOverlap::getPrevCell(int row, int column) {
+    if ((column == lA-1) && (row >= upFromRow))         { return 'u'; }
+    if ((row == lB-1) && (column >= leftFromColumn))    { return 'l'; }
+
+    if (row == 0)       { return (column == 0) ? 'x' : 'l'; }
+    if (column == 0)    { return 'u'; }
+
+    long long word = (long long)row * numBlocks + (column-1) / laneCount;
+    uint16_t bit = 1 << ((column-1) % laneCount);
+
+    if (leftBits[word] & bit)   { return 'l'; }
+    if (upBits[word] & bit)     { return 'u'; }
+    return 'd';
+}
+/**************************************************************************************************/
@@ -0,0 +1,72 @@
+//
+//  simdoverlap.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef simdoverlap_hpp
+#define simdoverlap_hpp
+
+#include "mothur.h"
+#include "alignment.hpp"
+#include <cstdint>
+
+/**************************************************************************************************/
+//SIMDOverlap is the Needleman-Wunsch and Gotoh overlap alignments of NeedlemanOverlap and GotohOverlap, filled a row at a
+//time 16 cells at once with int16 lanes. Only the previous row of scores is kept, the pointers are stored as two bits
+//per cell (left and up, neither is diagonal), and the overlap fix is done on the saved last row and column.
+//
+//Within a row the diagonal and up moves only depend on the row above, so they are computed for 16 columns together.
+//The left move is a running maximum along the row, which is done as a prefix max scan inside the vector and carried
+//from one block of 16 to the next. The scores, pointers and ties are the same as the float versions. Pairs the int16
+//kernel can't score exactly, non integer scoring parameters or sequences long enough to overflow, and cpus without
+//avx2 use a scalar fill of the same rows.
+
+class SIMDOverlap : public Alignment {
+
+public:
+    SIMDOverlap(float, float, float, float, bool, int); //gapOpen, gapExtend, match, mismatch, affine, longest sequence
+    virtual ~SIMDOverlap() {}
+
+    void align(string, string, bool createBaseMap=false);
+    void resize(int A) { nRows = A; nCols = A; } //the rows grow to fit each pair
+
+protected:
+    char getPrevCell(int, int);
+
+private:
+    float gapOpen, gapExtend, match, mismatch;
+    bool affine; //false is Needleman-Wunsch, every gap position costs gapOpen
+    int numBlocks, upFromRow, leftFromColumn;
+
+    vector<uint16_t> leftBits, upBits; //lB rows of numBlocks words, bit j-1 of a row is column j
+    vector<float> lastColumn, lastRow; //scores of column lA-1 and row lB-1 for the overlap fix
+
+    vector<int16_t> codesA, previousScores, currentScores, gapScores;
+    vector<float> previousFloat, currentFloat, gapFloat;
+
+    bool fitsInt16();
+    void fillScalar();
+    void fillVector();
+    void setOverlap();
+};
+/**************************************************************************************************/
+
+class NeedlemanSIMDOverlap : public SIMDOverlap {
+
+public:
+    NeedlemanSIMDOverlap(float gap, float f, float mm, int r) : SIMDOverlap(gap, 0, f, mm, false, r) {}
+    ~NeedlemanSIMDOverlap() {}
+};
+/**************************************************************************************************/
+
+class GotohSIMDOverlap : public SIMDOverlap {
+
+public:
+    GotohSIMDOverlap(float gO, float gE, float f, float mm, int r) : SIMDOverlap(gO, gE, f, mm, true, r) {}
+    ~GotohSIMDOverlap() {}
+};
+/**************************************************************************************************/
+
+#endif /* simdoverlap_hpp */
@@ -8,6 +8,152 @@
 
 #include "subsample.h"
 //**********************************************************************************************************************
+//log of n choose k
+static double logChoose(double n, double k) { return lgamma(n+1) - lgamma(k+1) - lgamma(n-k+1); }
+//**********************************************************************************************************************
+//The draws below are done by inversion: u is taken away from the probability of the mode, then of the values on either
+//side of it working outwards, and the value that takes u to 0 is returned. The probabilities come from the ratio of
+//neighboring terms, so a draw costs about a standard deviation of steps and no memory.
+//**********************************************************************************************************************
+//number of reads from a bin of binSize reads when sample reads are drawn without replacement from total reads
+static long long drawHypergeometric(long long total, long long binSize, long long sample, double u) {
+    if ((sample == 0) || (binSize == 0)) { return 0; }
+    
+    long long lowest = max(0LL, sample - (total - binSize));
+    long long highest = min(sample, binSize);
+    if (lowest == highest) { return lowest; }
+    
+    long long mode = (long long)(((double)(sample + 1) * (double)(binSize + 1)) / (double)(total + 2));
+    mode = max(lowest, min(highest, mode));
+    
+    double probMode = exp(logChoose(binSize, mode) + logChoose(total - binSize, sample - mode) - logChoose(total, sample));
+    
+    u -= probMode;
+    if (u <= 0) { return mode; }
+    
+    long long up = mode, down = mode;
+    double probUp = probMode, probDown = probMode;
+    double others = total - binSize - sample;
+    while ((up < highest) || (down > lowest)) {
+        if (up < highest) {
+            probUp *= ((double)(binSize - up) * (double)(sample - up)) / ((double)(up + 1) * (others + up + 1));
+            up++;
+            u -= probUp;
+            if (u <= 0) { return up; }
+        }
+        if (down > lowest) {
+            probDown *= ((double)down * (others + down)) / ((double)(binSize - down + 1) * (double)(sample - down + 1));
+            down--;
+            u -= probDown;
+            if (u <= 0) { return down; }
+        }
+    }
+    
+    return mode; //what's left of u is rounding error
+}
+//**********************************************************************************************************************
+//number of successes in trials draws that each succeed with probability prob
+static long long drawBinomial(long long trials, double prob, double u) {
+    if ((trials == 0) || (prob <= 0)) { return 0; }
+    if (prob >= 1) { return trials; }
+    
+    long long mode = (long long)((trials + 1) * prob);
+    mode = min(trials, mode);
+    
+    double probMode = exp(logChoose(trials, mode) + mode * log(prob) + (trials - mode) * log1p(-prob));
+    
+    u -= probMode;
+    if (u <= 0) { return mode; }
+    
+    long long up = mode, down = mode;
+    double probUp = probMode, probDown = probMode;
+    double odds = prob / (1.0 - prob);
+    while ((up < trials) || (down > 0)) {
+        if (up < trials) {
+            probUp *= ((double)(trials - up) / (double)(up + 1)) * odds;
+            up++;
+            u -= probUp;
+            if (u <= 0) { return up; }
+        }
+        if (down > 0) {
+            probDown *= ((double)down / (double)(trials - down + 1)) / odds;
+            down--;
+            u -= probDown;
+            if (u <= 0) { return down; }
+        }
+    }
+    
+    return mode; //what's left of u is rounding error
+}
+//**********************************************************************************************************************
+//draws size reads without replacement from bins holding abunds[i] reads, one bin at a time: the number taken from a bin
+//is hypergeometric given the reads left to draw and the reads in the bins after it. Returns the number drawn from each
+//bin, memory and time depend on the number of bins, not the number of reads.
+vector<int> SubSample::getSample(const vector<int>& abunds, int size) {
+    try {
+        vector<int> sampled(abunds.size(), 0);
+        
+        long long readsLeft = 0;
+        for (int i = 0; i < abunds.size(); i++) { readsLeft += abunds[i]; }
+        
+        if (readsLeft < size) { m->mothurOut("[ERROR]: The size you requested is larger than the number of reads. You requested " + toString(size) + " and you only have " + toString(readsLeft) + ".\n"); m->setControl_pressed(true); return sampled; }
+        
+        long long drawsLeft = size;
+        for (int i = 0; i < abunds.size(); i++) {
+            if (drawsLeft == 0) { break; }
+            
+            sampled[i] = drawHypergeometric(readsLeft, abunds[i], drawsLeft, util.getRandomDouble0to1());
+            
+            readsLeft -= abunds[i];
+            drawsLeft -= sampled[i];
+        }
+        
+        return sampled;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SubSample", "getSample-abunds");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+//draws size reads with replacement from bins holding abunds[i] reads, one bin at a time: the number taken from a bin is
+//binomial given the draws left and the bin's share of the reads in it and the bins after it
+vector<int> SubSample::getSampleWithReplacement(const vector<int>& abunds, int size) {
+    try {
+        vector<int> sampled(abunds.size(), 0);
+        
+        long long readsLeft = 0;
+        for (int i = 0; i < abunds.size(); i++) { readsLeft += abunds[i]; }
+        
+        if (readsLeft == 0) { return sampled; }
+        
+        long long drawsLeft = size;
+        for (int i = 0; i < abunds.size(); i++) {
+            if (drawsLeft == 0) { break; }
+            
+            sampled[i] = drawBinomial(drawsLeft, abunds[i] / (double)readsLeft, util.getRandomDouble0to1());
+            
+            readsLeft -= abunds[i];
+            drawsLeft -= sampled[i];
+        }
+        
+        return sampled;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SubSample", "getSampleWithReplacement-abunds");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+//number of distinct reads hit when draws reads are drawn with replacement from a bin of binSize reads
+static int countDistinctReads(int binSize, int draws, Utils& util) {
+    int distinct = 0;
+    for (int i = 0; i < draws; i++) {
+        if (util.getRandomDouble0to1() * binSize >= distinct) { distinct++; } //a read we haven't drawn yet
+    }
+    return distinct;
+}
+//**********************************************************************************************************************
 Tree* SubSample::getSample(Tree* T, CountTable* ct, CountTable* newCt, int size, vector<string>& mGroups) {
     try {
         //remove seqs not in sample from counttable
@@ -30,21 +176,14 @@ Tree* SubSample::getSample(Tree* T, CountTable* ct, CountTable* newCt, int size,
                 if (thisSize >= size) {	
                     
                     vector<string> names = ct->getNamesOfSeqs(Groups[i]);
-                    vector<int> random;
-                    for (int j = 0; j < names.size(); j++) {
-                        int num = ct->getGroupCount(names[j], Groups[i]);
-                        for (int k = 0; k < num; k++) { random.push_back(j); }
-                    }
-                    util.mothurRandomShuffle(random);
+                    vector<int> abunds;
+                    for (int j = 0; j < names.size(); j++) { abunds.push_back(ct->getGroupCount(names[j], Groups[i])); }
                     
-                    vector<int> sampleRandoms; sampleRandoms.resize(names.size(), 0);
-                    for (int j = 0; j < size; j++) { sampleRandoms[random[j]]++; }
+                    vector<int> sampleRandoms = getSample(abunds, size);
                     for (int j = 0; j < sampleRandoms.size(); j++) {
                         newCt->setAbund(names[j], Groups[i], sampleRandoms[j]);
+                        doNotIncludeTotals[names[j]] += (abunds[j] - sampleRandoms[j]);
                     }
-                    sampleRandoms.clear(); sampleRandoms.resize(names.size(), 0);
-                    for (int j = size; j < thisSize; j++) { sampleRandoms[random[j]]++; }
-                    for (int j = 0; j < sampleRandoms.size(); j++) {  doNotIncludeTotals[names[j]] += sampleRandoms[j]; }
                 }else {  m->mothurOut("[ERROR]: You have selected a size that is larger than "+Groups[i]+" number of sequences.\n"); m->setControl_pressed(true); }
             }
 
@@ -86,33 +225,16 @@ Tree* SubSample::getSampleWithReplacement(Tree* T, CountTable* ct, CountTable* n
                 if (m->getControl_pressed()) { break; }
                 
                 vector<string> names = ct->getNamesOfSeqs(Groups[i]);
-                vector<int> random;
-                for (int j = 0; j < names.size(); j++) {
-                    int num = ct->getGroupCount(names[j], Groups[i]);
-                    for (int k = 0; k < num; k++) { random.push_back(j); }
-                }
+                vector<int> abunds;
+                for (int j = 0; j < names.size(); j++) { abunds.push_back(ct->getGroupCount(names[j], Groups[i])); }
                 
-                vector<int> sampleRandoms; sampleRandoms.resize(names.size(), 0);
-                long long totalNumReads = random.size()-1;
-                set<long long> selected;
-                for (int j = 0; j < size; j++) { //allows for multiple selection of same read
-                    //"grab random from bag"
-                    long long randomRead = util.getRandomIndex(totalNumReads);
-                    sampleRandoms[random[randomRead]]++;
-                    selected.insert(randomRead);
-                }
+                vector<int> sampleRandoms = getSampleWithReplacement(abunds, size); //allows for multiple selection of same read
                 for (int j = 0; j < sampleRandoms.size(); j++) { //create new count file with updated sequence counts
                     newCt->setAbund(names[j], Groups[i], sampleRandoms[j]);
+                    
+                    //set unselected reads to "do not include"
+                    doNotIncludeTotals[names[j]] += (abunds[j] - countDistinctReads(abunds[j], sampleRandoms[j], util));
                 }
-                
-                //set unselected reads to "do not include"
-                sampleRandoms.clear(); sampleRandoms.resize(names.size(), 0);
-                for (long long j = 0; j < random.size(); j++) {
-                    if (selected.count(j) == 0)  { //we did not selected this read from random
-                        sampleRandoms[random[j]]++;
-                    }
-                }
-                for (int j = 0; j < sampleRandoms.size(); j++) {  doNotIncludeTotals[names[j]] += sampleRandoms[j]; }
             }
             
         }
@@ -245,22 +367,17 @@ vector<string> SubSample::getSample(vector<SharedRAbundVector*>& rabunds, int si
             
             if (thisSize != size) {
                 
-                vector<int> order;
-                for (int j = 0; j < rabunds[i]->size(); j++) {
-                    int abund = rabunds[i]->get(j);
-                    for(int k=0;k<abund;k++){ order.push_back(j);  }
-                }
+                vector<int> abunds;
+                for (int j = 0; j < rabunds[i]->size(); j++) { abunds.push_back(rabunds[i]->get(j)); }
                 
-                util.mothurRandomShuffle(order);
+                vector<int> sampled = getSample(abunds, size); //only allows you to select a read once
+                if (m->getControl_pressed()) {  return currentLabels; }
                 
                 SharedRAbundVector* temp = new SharedRAbundVector(numBins);
                 temp->setLabel(rabunds[i]->getLabel());
                 temp->setGroup(rabunds[i]->getGroup());
                 
-                for (int j = 0; j < size; j++) { //only allows you to select a read once
-                    if (m->getControl_pressed()) {  return currentLabels; }
-                    temp->increment(order[j]);
-                }
+                for (int j = 0; j < sampled.size(); j++) { if (sampled[j] != 0) { temp->set(j, sampled[j]); } }
                 newLookup->push_back(temp);
             }else { SharedRAbundVector* temp = new SharedRAbundVector(*rabunds[i]); newLookup->push_back(temp); }
         }
@@ -293,23 +410,17 @@ vector<string> SubSample::getSampleWithReplacement(vector<SharedRAbundVector*>&
         int numBins = rabunds[0]->getNumBins();
         for (int i = 0; i < rabunds.size(); i++) {
 
-            vector<int> order;
-            for (int j = 0; j < rabunds[i]->size(); j++) {
-                int abund = rabunds[i]->get(j);
-                for(int k=0;k<abund;k++){ order.push_back(j);  }
-            }
+            vector<int> abunds;
+            for (int j = 0; j < rabunds[i]->size(); j++) { abunds.push_back(rabunds[i]->get(j)); }
+            
+            vector<int> sampled = getSampleWithReplacement(abunds, size); //allows you to select a read multiple times
+            if (m->getControl_pressed()) {  return currentLabels; }
             
             SharedRAbundVector* temp = new SharedRAbundVector(numBins);
             temp->setLabel(rabunds[i]->getLabel());
             temp->setGroup(rabunds[i]->getGroup());
             
-            long long orderSize = order.size()-1;
-            for (int j = 0; j < size; j++) { //allows you to select a read multiple times
-                if (m->getControl_pressed()) {  return currentLabels; }
-                //"grab random from bag"
-                long long randomRead = util.getRandomIndex(orderSize);
-                temp->increment(order[randomRead]);
-            }
+            for (int j = 0; j < sampled.size(); j++) { if (sampled[j] != 0) { temp->set(j, sampled[j]); } }
             newLookup->push_back(temp);
 
         }
@@ -384,21 +495,17 @@ int SubSample::getSample(SAbundVector*& sabund, int size) {
         int numBins = sabund->getNumBins();
         int thisSize = sabund->getNumSeqs();
 
-        OrderVector order = sabund->getOrderVector();
-        
 		if (thisSize > size) {
-			util.mothurRandomShuffle(order);
+            //one bin per otu, otus of the same abundance are interchangeable
+            vector<int> abunds;
+            for (int i = 1; i <= sabund->getMaxRank(); i++) { abunds.insert(abunds.end(), sabund->get(i), i); }
+            
+            vector<int> sampled = getSample(abunds, size);
+            if (m->getControl_pressed()) { return 0; }
 			
             RAbundVector rabund(numBins);
 			rabund.setLabel(sabund->getLabel());
-
-			for (int j = 0; j < size; j++) {
-                
-				if (m->getControl_pressed()) { return 0; }
-				
-                int abund = rabund.get(order.get(j));
-				rabund.set(order.get(j), (abund+1));
-			}
+            for (int j = 0; j < sampled.size(); j++) { rabund.set(j, sampled[j]); }
 
             delete sabund;
             sabund = new SAbundVector();
@@ -421,23 +528,17 @@ int SubSample::getSampleWithReplacement(SAbundVector*& sabund, int size) {
         int numBins = sabund->getNumBins();
         int thisSize = sabund->getNumSeqs();
         
-        OrderVector order = sabund->getOrderVector();
-        
         if (thisSize > size) {
+            //one bin per otu, otus of the same abundance are interchangeable
+            vector<int> abunds;
+            for (int i = 1; i <= sabund->getMaxRank(); i++) { abunds.insert(abunds.end(), sabund->get(i), i); }
+            
+            vector<int> sampled = getSampleWithReplacement(abunds, size);
+            if (m->getControl_pressed()) { return 0; }
+            
             RAbundVector rabund(numBins);
             rabund.setLabel(sabund->getLabel());
-            
-            long long orderSize = order.size()-1;
-            for (int j = 0; j < size; j++) {
-                
-                if (m->getControl_pressed()) { return 0; }
-                
-                //"grab random from bag"
-                long long randomRead = util.getRandomIndex(orderSize);
-                
-                int abund = rabund.get(order.get(randomRead));
-                rabund.set(order.get(randomRead), (abund+1));
-            }
+            for (int j = 0; j < sampled.size(); j++) { rabund.set(j, sampled[j]); }
             
             delete sabund;
             sabund = new SAbundVector();
@@ -460,21 +561,16 @@ int SubSample::getSample(RAbundVector*& rabund, int size) {
         int numBins = rabund->getNumBins();
         int thisSize = rabund->getNumSeqs();
         
-        OrderVector order = rabund->getOrderVector(NULL);
-        
         if (thisSize > size) {
-            util.mothurRandomShuffle(order);
+            vector<int> abunds;
+            for (int j = 0; j < numBins; j++) { abunds.push_back(rabund->get(j)); }
+            
+            vector<int> sampled = getSample(abunds, size);
+            if (m->getControl_pressed()) { return 0; }
             
             RAbundVector sampledRabund(numBins);
             sampledRabund.setLabel(rabund->getLabel());
-            
-            for (int j = 0; j < size; j++) {
-                
-                if (m->getControl_pressed()) { return 0; }
-                
-                int abund = sampledRabund.get(order.get(j));
-                sampledRabund.set(order.get(j), (abund+1));
-            }
+            for (int j = 0; j < sampled.size(); j++) { sampledRabund.set(j, sampled[j]); }
             
             delete rabund;
             rabund = new RAbundVector(sampledRabund);
@@ -496,23 +592,16 @@ int SubSample::getSampleWithReplacement(RAbundVector*& rabund, int size) {
         int numBins = rabund->getNumBins();
         int thisSize = rabund->getNumSeqs();
         
-        OrderVector order = rabund->getOrderVector(NULL);
-        
         if (thisSize > size) {
+            vector<int> abunds;
+            for (int j = 0; j < numBins; j++) { abunds.push_back(rabund->get(j)); }
+            
+            vector<int> sampled = getSampleWithReplacement(abunds, size);
+            if (m->getControl_pressed()) { return 0; }
+            
             RAbundVector sampledRabund(numBins);
             sampledRabund.setLabel(rabund->getLabel());
-            
-            long long orderSize = order.size()-1;
-            for (int j = 0; j < size; j++) {
-                
-                if (m->getControl_pressed()) { return 0; }
-                
-                //"grab random from bag"
-                long long randomRead = util.getRandomIndex(orderSize);
-                
-                int abund = sampledRabund.get(order.get(randomRead));
-                sampledRabund.set(order.get(randomRead), (abund+1));
-            }
+            for (int j = 0; j < sampled.size(); j++) { sampledRabund.set(j, sampled[j]); }
             
             delete rabund;
             rabund = new RAbundVector(sampledRabund);
@@ -539,31 +628,32 @@ CountTable SubSample::getSample(CountTable& ct, int size, vector<string> Groups,
             sampledCt.addGroup(Groups[i]);
             
             vector<string> names = ct.getNamesOfSeqs(Groups[i]);
-            vector<int> allNames;
+            vector<int> abunds; long long numReads = 0;
             for (int j = 0; j < names.size(); j++) {
                 
                 if (m->getControl_pressed()) { return sampledCt; }
                 
-                int num = ct. getGroupCount(names[j], Groups[i]);
-                for (int k = 0; k < num; k++) { allNames.push_back(j); }
+                abunds.push_back(ct.getGroupCount(names[j], Groups[i]));
+                numReads += abunds[j];
             }
             
-            util.mothurRandomShuffle(allNames);
-            
-            if (allNames.size() < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than "+Groups[i]+" number of sequences.\n"); m->setControl_pressed(true); }
+            if (numReads < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than "+Groups[i]+" number of sequences.\n"); m->setControl_pressed(true); }
             else{
-                for (int j = 0; j < size; j++) {
+                vector<int> sampled = getSample(abunds, size);
+                
+                for (int j = 0; j < sampled.size(); j++) {
                     
                     if (m->getControl_pressed()) { return sampledCt; }
+                    if (sampled[j] == 0) { continue; }
                     
-                    map<string, vector<int> >::iterator it = tempCount.find(names[allNames[j]]);
+                    map<string, vector<int> >::iterator it = tempCount.find(names[j]);
                     
                     if (it == tempCount.end()) { //we have not seen this sequence at all yet
                         vector<int> tempGroups; tempGroups.resize(Groups.size(), 0);
-                        tempGroups[i]++;
-                        tempCount[names[allNames[j]]] = tempGroups;
+                        tempGroups[i] = sampled[j];
+                        tempCount[names[j]] = tempGroups;
                     }else{
-                        tempCount[names[allNames[j]]][i]++;
+                        it->second[i] += sampled[j];
                     }
                 }
             }
@@ -595,34 +685,32 @@ CountTable SubSample::getSampleWithReplacement(CountTable& ct, int size, vector<
             sampledCt.addGroup(Groups[i]);
             
             vector<string> names = ct.getNamesOfSeqs(Groups[i]);
-            vector<int> allNames;
+            vector<int> abunds; long long numReads = 0;
             for (int j = 0; j < names.size(); j++) {
                 
                 if (m->getControl_pressed()) { return sampledCt; }
                 
-                int num = ct.getGroupCount(names[j], Groups[i]);
-                for (int k = 0; k < num; k++) { allNames.push_back(j); }
+                abunds.push_back(ct.getGroupCount(names[j], Groups[i]));
+                numReads += abunds[j];
             }
             
-            long long allNamesSize = allNames.size()-1;
-            
-            if (allNames.size() < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than "+Groups[i]+" number of sequences.\n"); m->setControl_pressed(true); }
+            if (numReads < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than "+Groups[i]+" number of sequences.\n"); m->setControl_pressed(true); }
             else{
-                for (int j = 0; j < size; j++) {
+                vector<int> sampled = getSampleWithReplacement(abunds, size);
+                
+                for (int j = 0; j < sampled.size(); j++) {
                     
                     if (m->getControl_pressed()) { return sampledCt; }
+                    if (sampled[j] == 0) { continue; }
                     
-                    //"grab random from bag"
-                    long long randomRead = util.getRandomIndex(allNamesSize);
-                    
-                    map<string, vector<int> >::iterator it = tempCount.find(names[allNames[randomRead]]);
+                    map<string, vector<int> >::iterator it = tempCount.find(names[j]);
                     
                     if (it == tempCount.end()) { //we have not seen this sequence at all yet
                         vector<int> tempGroups; tempGroups.resize(Groups.size(), 0);
-                        tempGroups[i]++;
-                        tempCount[names[allNames[randomRead]]] = tempGroups;
+                        tempGroups[i] = sampled[j];
+                        tempCount[names[j]] = tempGroups;
                     }else{
-                        tempCount[names[allNames[randomRead]]][i]++;
+                        it->second[i] += sampled[j];
                     }
                 }
             }
@@ -752,35 +840,30 @@ CountTable SubSample::getSample(CountTable& ct, int size, vector<string> Groups)
             for (int i = 0; i < Groups.size(); i++) { sampledCt.addGroup(Groups[i]);  }
                 
             vector<string> names = ct.getNamesOfSeqs(Groups); //names of sequences in groups
-            vector<item> allNames;
+            vector<int> abunds; long long numReads = 0; //one bin per seq and group, bin j*numGroups+i
             for (int j = 0; j < names.size(); j++) {
-                    
+                
                 if (m->getControl_pressed()) { return sampledCt; }
                 
                 for (int i = 0; i < Groups.size(); i++) {
                     int num = ct.getGroupCount(names[j], Groups[i]); //num reads in this group from this seq
-                    item thisSeq(j,i);
-                    for (int k = 0; k < num; k++) { allNames.push_back(thisSeq); }
+                    abunds.push_back(num); numReads += num;
                 }
             }
-                
-            util.mothurRandomShuffle(allNames);
-                
-            if (allNames.size() < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->setControl_pressed(true); }
+            
+            if (numReads < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->setControl_pressed(true); }
             else{
-                for (int j = 0; j < size; j++) {
-                        
+                vector<int> sampled = getSample(abunds, size);
+                
+                for (int j = 0; j < names.size(); j++) {
+                    
                     if (m->getControl_pressed()) { return sampledCt; }
-                        
-                    map<string, vector<int> >::iterator it = tempCount.find(names[allNames[j].name]);
-                        
-                    if (it == tempCount.end()) { //we have not seen this sequence at all yet
-                        vector<int> tempGroups; tempGroups.resize(Groups.size(), 0);
-                        tempGroups[allNames[j].group]++;
-                        tempCount[names[allNames[j].name]] = tempGroups;
-                    }else{
-                        tempCount[names[allNames[j].name]][allNames[j].group]++;
-                    }
+                    
+                    vector<int> tempGroups(sampled.begin() + j*Groups.size(), sampled.begin() + (j+1)*Groups.size());
+                    
+                    int total = 0;
+                    for (int i = 0; i < tempGroups.size(); i++) { total += tempGroups[i]; }
+                    if (total != 0) { tempCount[names[j]] = tempGroups; }
                 }
             }
             
@@ -793,32 +876,21 @@ CountTable SubSample::getSample(CountTable& ct, int size, vector<string> Groups)
 
         }else { //no groups
             vector<string> names = ct.getNamesOfSeqs();
-            map<int, int> nameMap;
-            vector<int> allNames;
+            vector<int> abunds; long long numReads = 0;
             
             for (int i = 0; i < names.size(); i++) {
-                int num = ct.getNumSeqs(names[i]);
-                for (int j = 0; j < num; j++) { allNames.push_back(i); }
+                abunds.push_back(ct.getNumSeqs(names[i]));
+                numReads += abunds[i];
             }
             
-            if (allNames.size() < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->setControl_pressed(true); return sampledCt; }
+            if (numReads < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->setControl_pressed(true); return sampledCt; }
             else {
-                util.mothurRandomShuffle(allNames);
-                
-                for (int j = 0; j < size; j++) {
-                    if (m->getControl_pressed()) { return sampledCt; }
-                    
-                    map<int, int>::iterator it = nameMap.find(allNames[j]);
-                    
-                    //we have not seen this sequence at all yet
-                    if (it == nameMap.end()) { nameMap[allNames[j]] = 1;  }
-                    else{  nameMap[allNames[j]]++;  }
-                }
+                vector<int> sampled = getSample(abunds, size);
                 
                 //build count table
-                for (map<int, int>::iterator it = nameMap.begin(); it != nameMap.end();) {
-                    sampledCt.push_back(names[it->first], it->second);
-                    nameMap.erase(it++);
+                for (int i = 0; i < sampled.size(); i++) {
+                    if (m->getControl_pressed()) { return sampledCt; }
+                    if (sampled[i] != 0) { sampledCt.push_back(names[i], sampled[i]); }
                 }
             }
         }
@@ -842,37 +914,30 @@ CountTable SubSample::getSampleWithReplacement(CountTable& ct, int size, vector<
             for (int i = 0; i < Groups.size(); i++) { sampledCt.addGroup(Groups[i]);  }
             
             vector<string> names = ct.getNamesOfSeqs(Groups); //names of sequences in groups
-            vector<item> allNames;
+            vector<int> abunds; long long numReads = 0; //one bin per seq and group, bin j*numGroups+i
             for (int j = 0; j < names.size(); j++) {
                 
                 if (m->getControl_pressed()) { return sampledCt; }
                 
                 for (int i = 0; i < Groups.size(); i++) {
                     int num = ct.getGroupCount(names[j], Groups[i]); //num reads in this group from this seq
-                    item thisSeq(j,i);
-                    for (int k = 0; k < num; k++) { allNames.push_back(thisSeq); }
+                    abunds.push_back(num); numReads += num;
                 }
             }
             
-            if (allNames.size() < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->setControl_pressed(true); }
+            if (numReads < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->setControl_pressed(true); }
             else{
-                long long allNamesSize = allNames.size()-1;
+                vector<int> sampled = getSampleWithReplacement(abunds, size);
                 
-                for (int j = 0; j < size; j++) {
+                for (int j = 0; j < names.size(); j++) {
                     
                     if (m->getControl_pressed()) { return sampledCt; }
                     
-                    long long randomRead = util.getRandomIndex(allNamesSize);
+                    vector<int> tempGroups(sampled.begin() + j*Groups.size(), sampled.begin() + (j+1)*Groups.size());
                     
-                    map<string, vector<int> >::iterator it = tempCount.find(names[allNames[randomRead].name]);
-                    
-                    if (it == tempCount.end()) { //we have not seen this sequence at all yet
-                        vector<int> tempGroups; tempGroups.resize(Groups.size(), 0);
-                        tempGroups[allNames[randomRead].group]++;
-                        tempCount[names[allNames[randomRead].name]] = tempGroups;
-                    }else{
-                        tempCount[names[allNames[randomRead].name]][allNames[randomRead].group]++;
-                    }
+                    int total = 0;
+                    for (int i = 0; i < tempGroups.size(); i++) { total += tempGroups[i]; }
+                    if (total != 0) { tempCount[names[j]] = tempGroups; }
                 }
             }
             
@@ -885,34 +950,21 @@ CountTable SubSample::getSampleWithReplacement(CountTable& ct, int size, vector<
             
         }else { //no groups
             vector<string> names = ct.getNamesOfSeqs();
-            map<int, int> nameMap;
-            vector<int> allNames;
+            vector<int> abunds; long long numReads = 0;
             
             for (int i = 0; i < names.size(); i++) {
-                int num = ct.getNumSeqs(names[i]);
-                for (int j = 0; j < num; j++) { allNames.push_back(i); }
+                abunds.push_back(ct.getNumSeqs(names[i]));
+                numReads += abunds[i];
             }
             
-            if (allNames.size() < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->setControl_pressed(true); return sampledCt; }
+            if (numReads < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->setControl_pressed(true); return sampledCt; }
             else {
-                long long allNamesSize = allNames.size()-1;
-                
-                for (int j = 0; j < size; j++) {
-                    if (m->getControl_pressed()) { return sampledCt; }
-                    
-                    long long randomRead = util.getRandomIndex(allNamesSize);
-                    
-                    map<int, int>::iterator it = nameMap.find(allNames[randomRead]);
-                    
-                    //we have not seen this sequence at all yet
-                    if (it == nameMap.end()) { nameMap[allNames[randomRead]] = 1;  }
-                    else{  nameMap[allNames[randomRead]]++;  }
-                }
+                vector<int> sampled = getSampleWithReplacement(abunds, size);
                 
                 //build count table
-                for (map<int, int>::iterator it = nameMap.begin(); it != nameMap.end();) {
-                    sampledCt.push_back(names[it->first], it->second);
-                    nameMap.erase(it++);
+                for (int i = 0; i < sampled.size(); i++) {
+                    if (m->getControl_pressed()) { return sampledCt; }
+                    if (sampled[i] != 0) { sampledCt.push_back(names[i], sampled[i]); }
                 }
             }
         }
@@ -49,6 +49,9 @@ class SubSample {
         GroupMap getSample(GroupMap&, int size); //returns subsampled GroupMap with 'size' members
 
     
+        vector<int> getSample(const vector<int>&, int); //otu abundances, number of reads to draw. Returns the subsampled abundances, reads drawn without replacement.
+        vector<int> getSampleWithReplacement(const vector<int>&, int); //otu abundances, number of reads to draw. Returns the subsampled abundances, reads drawn with replacement.
+    
         set<long long> getWeightedSample(map<long long, long long>&, long long); //map of sequence names -> weight (could be abundance or some other measure), num to sample
     
     private:
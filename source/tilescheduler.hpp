@@ -0,0 +1,106 @@
+//
+//  tilescheduler.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef tilescheduler_hpp
+#define tilescheduler_hpp
+
+#include "mothurout.h"
+#include <atomic>
+
+/***********************************************************************/
+//a block of a distance matrix, rows [rowStart, rowEnd) against columns [colStart, colEnd)
+struct DistanceTile {
+    long long rowStart, rowEnd, colStart, colEnd, index;
+
+    DistanceTile() : rowStart(0), rowEnd(0), colStart(0), colEnd(0), index(0) {}
+    DistanceTile(long long rs, long long re, long long cs, long long ce, long long i) : rowStart(rs), rowEnd(re), colStart(cs), colEnd(ce), index(i) {}
+};
+/***********************************************************************/
+//TileScheduler deals the tiles out to the threads in contiguous runs. A thread that finishes its run steals
+//tiles from the other threads' runs, so uneven tiles (pairs that hit the cutoff early are cheap) don't leave threads idle.
+class TileScheduler {
+public:
+
+    TileScheduler(const vector<DistanceTile>& t, int numThreads) : tiles(t), runs(numThreads), numDone(0), numBelowCutoff(0) {
+        long long numTiles = tiles.size();
+        for (int i = 0; i < numThreads; i++) {
+            runs[i].next = (numTiles * i) / numThreads;
+            runs[i].end = (numTiles * (i+1)) / numThreads;
+        }
+    }
+
+    //returns false when all the tiles have been handed out
+    bool getNextTile(int thread, DistanceTile& tile) {
+        int numThreads = runs.size();
+        for (int k = 0; k < numThreads; k++) { //our run first, then the others
+            Run& run = runs[(thread + k) % numThreads];
+
+            if (run.next.load() >= run.end) { continue; }
+
+            long long t = run.next.fetch_add(1);
+            if (t < run.end) { tile = tiles[t]; return true; }
+        }
+        return false;
+    }
+
+    //returns the number of tiles finished so far
+    long long tileDone(long long count) { numBelowCutoff += count; return ++numDone; }
+
+    long long getNumTiles()         { return tiles.size();              }
+    long long getNumBelowCutoff()   { return numBelowCutoff.load();     }
+
+    //rows per tile, so a tile's column rows fit in about 256KB of cache and each thread gets several tiles
+    static long long getTileSize(long long bytesPerRow, long long numRows, int numThreads) {
+        long long tileSize = 262144 / max(bytesPerRow, (long long)1);
+        tileSize = max(tileSize, (long long)16);
+        tileSize = min(tileSize, max(numRows / (4*(long long)numThreads), (long long)1));
+        return tileSize;
+    }
+
+    //tiles covering the lower triangle of a numRows x numRows matrix
+    static vector<DistanceTile> getTriangleTiles(long long numRows, long long tileSize) {
+        vector<DistanceTile> tiles;
+        for (long long rowStart = 0; rowStart < numRows; rowStart += tileSize) {
+            long long rowEnd = min(rowStart + tileSize, numRows);
+            for (long long colStart = 0; colStart < rowEnd-1; colStart += tileSize) {
+                tiles.push_back(DistanceTile(rowStart, rowEnd, colStart, min(colStart + tileSize, rowEnd-1), tiles.size()));
+            }
+        }
+        return tiles;
+    }
+
+    //tiles covering a numRows x numCols matrix
+    static vector<DistanceTile> getRectangleTiles(long long numRows, long long numCols, long long tileSize) {
+        vector<DistanceTile> tiles;
+        for (long long rowStart = 0; rowStart < numRows; rowStart += tileSize) {
+            for (long long colStart = 0; colStart < numCols; colStart += tileSize) {
+                tiles.push_back(DistanceTile(rowStart, min(rowStart + tileSize, numRows), colStart, min(colStart + tileSize, numCols), tiles.size()));
+            }
+        }
+        return tiles;
+    }
+
+    //tiles of whole rows, for the phylip formats that are written row by row
+    static vector<DistanceTile> getRowTiles(long long numRows, long long numCols, long long tileSize) {
+        vector<DistanceTile> tiles;
+        for (long long rowStart = 0; rowStart < numRows; rowStart += tileSize) {
+            tiles.push_back(DistanceTile(rowStart, min(rowStart + tileSize, numRows), 0, numCols, tiles.size()));
+        }
+        return tiles;
+    }
+
+private:
+
+    struct Run { std::atomic<long long> next; long long end; };
+
+    vector<DistanceTile> tiles;
+    vector<Run> runs;
+    std::atomic<long long> numDone, numBelowCutoff;
+};
+/***********************************************************************/
+
+#endif /* tilescheduler_hpp */
@@ -1,6 +1,7 @@
+#include "myutils.h"
+
 #if	UCHIMES
 
-#include "myutils.h"
 #include "chime.h"
 #include "ultra.h"
 #include <set>
@@ -10,8 +10,8 @@ void SetBLOSUM62();
 void SetNucSubstMx(double Match, double Mismatch);
 void ReadSubstMx(const string &FileName, Mx<float> &Mxf);
 
-extern Mx<float> g_SubstMxf;
-extern float **g_SubstMx;
+extern thread_local Mx<float> g_SubstMxf;
+extern thread_local float **g_SubstMx;
 
 void AlnParams::Clear()
 	{
@@ -3,7 +3,7 @@
 
 //unsigned g_MaxL = 0;
 
-static bool *g_IsChar = g_IsAminoChar;
+static thread_local bool *g_IsChar = g_IsAminoChar;
 
 // Term gaps allowed in query (A) only
 static double GetFractIdGivenPathDerep(const byte *A, const byte *B, const char *Path,
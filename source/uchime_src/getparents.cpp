@@ -5,6 +5,9 @@
 
 void AddTargets(Ultra &U, const SeqData &Query, set<unsigned> &TargetIndexes);
 
+// Abundances of the database sequences, set by the de novo search.
+extern thread_local const vector<float> *g_UchimeAbs;
+
 void GetChunkInfo(unsigned L, unsigned &Length, vector<unsigned> &Los)
 	{
 	Los.clear();
@@ -77,8 +80,7 @@ void GetCandidateParents(Ultra &U, const SeqData &QSD, float AbQ,
 		bool Accept = true;
 		if (AbQ > 0.0f)
 			{
-			const char *TargetLabel = U.GetSeedLabel(TargetIndex);
-			float AbT = GetAbFromLabel(string(TargetLabel));
+			float AbT = (*g_UchimeAbs)[TargetIndex];
 			if (AbT > 0.0f && AbT < opt_abskew*AbQ)
 				Accept = false;
 			}
@@ -23,7 +23,7 @@ template<class T> const char *TypeToStr(T t)
 
 template<> inline const char *TypeToStr<unsigned short>(unsigned short f)
 	{
-	static char s[16];
+	static thread_local char s[16];
 
 	sprintf(s, "%12u", f);
 	return s;
@@ -31,7 +31,7 @@ template<> inline const char *TypeToStr<unsigned short>(unsigned short f)
 
 template<> inline const char *TypeToStr<short>(short f)
 	{
-	static char s[16];
+	static thread_local char s[16];
 
 	sprintf(s, "%12d", f);
 	return s;
@@ -39,7 +39,7 @@ template<> inline const char *TypeToStr<short>(short f)
 
 template<> inline const char *TypeToStr<int>(int f)
 	{
-	static char s[16];
+	static thread_local char s[16];
 
 	sprintf(s, "%5d", f);
 	return s;
@@ -47,7 +47,7 @@ template<> inline const char *TypeToStr<int>(int f)
 
 template<> inline const char *TypeToStr<float>(float f)
 	{
-	static char s[16];
+	static thread_local char s[16];
 
 	if (f == UNINIT)
 		sprintf(s, "%12.12s", "?");
@@ -64,7 +64,7 @@ template<> inline const char *TypeToStr<float>(float f)
 
 template<> inline const char *TypeToStr<double>(double f)
 	{
-	static char s[16];
+	static thread_local char s[16];
 
 	if (f < -1e9)
 		sprintf(s, "%12.12s", "*");
@@ -85,21 +85,21 @@ static inline const char *FloatToStr(float f, string &s)
 
 template<> inline const char *TypeToStr<char>(char c)
 	{
-	static char s[2];
+	static thread_local char s[2];
 	s[0] = c;
 	return s;
 	}
 
 template<> inline const char *TypeToStr<byte>(byte c)
 	{
-	static char s[2];
+	static thread_local char s[2];
 	s[0] = c;
 	return s;
 	}
 
 template<> inline const char *TypeToStr<bool>(bool tof)
 	{
-	static char s[2];
+	static thread_local char s[2];
 	s[0] = tof ? 'T' : 'F';
 	return s;
 	}
@@ -126,17 +126,17 @@ public:
 	const SeqData *m_SA;
 	const SeqData *m_SB;
 
-	static list<MxBase *> *m_Matrices;
+	static thread_local list<MxBase *> *m_Matrices;
 	//static MxBase *Get(const string &Name);
 	//static float **Getf(const string &Name);
 	//static double **Getd(const string &Name);
 	//static char **Getc(const string &Name);
 
-	static unsigned m_AllocCount;
-	static unsigned m_ZeroAllocCount;
-	static unsigned m_GrowAllocCount;
-	static double m_TotalBytes;
-	static double m_MaxBytes;
+	static thread_local unsigned m_AllocCount;
+	static thread_local unsigned m_ZeroAllocCount;
+	static thread_local unsigned m_GrowAllocCount;
+	static thread_local double m_TotalBytes;
+	static thread_local double m_MaxBytes;
 
 	static void OnCtor(MxBase *Mx);
 	static void OnDtor(MxBase *Mx);
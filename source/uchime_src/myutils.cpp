@@ -27,6 +27,7 @@
 #endif
 
 #include "myutils.h"
+#include "uchimelib.h"
 
 const char *SVN_VERSION =
 #include "svnversion.h"
@@ -42,7 +43,7 @@ const unsigned MAX_FORMATTED_STRING_LENGTH = 64000;
 static char *g_IOBuffers[256];
 static time_t g_StartTime = time(0);
 static vector<string> g_Argv;
-static double g_PeakMemUseBytes;
+static thread_local double g_PeakMemUseBytes;
 
 #if	TEST_UTILS
 void TestUtils()
@@ -101,13 +102,13 @@ unsigned GetElapsedSecs()
 	return (unsigned) (time(0) - g_StartTime);
 	}
 
-static unsigned g_NewCalls;
-static unsigned g_FreeCalls;
-static double g_InitialMemUseBytes;
-static double g_TotalAllocBytes;
-static double g_TotalFreeBytes;
-static double g_NetBytes;
-static double g_MaxNetBytes;
+static thread_local unsigned g_NewCalls;
+static thread_local unsigned g_FreeCalls;
+static thread_local double g_InitialMemUseBytes;
+static thread_local double g_TotalAllocBytes;
+static thread_local double g_TotalFreeBytes;
+static thread_local double g_NetBytes;
+static thread_local double g_MaxNetBytes;
 
 void LogAllocStats()
 	{
@@ -514,7 +515,7 @@ void DeleteStdioFile(const string &FileName)
 
 void myvstrprintf(string &Str, const char *Format, va_list ArgList)
 	{
-	static char szStr[MAX_FORMATTED_STRING_LENGTH];
+	static thread_local char szStr[MAX_FORMATTED_STRING_LENGTH];
 	vsnprintf(szStr, MAX_FORMATTED_STRING_LENGTH-1, Format, ArgList);
 	szStr[MAX_FORMATTED_STRING_LENGTH - 1] = '\0';
 	Str.assign(szStr);
@@ -545,7 +546,7 @@ void Log(const char *Format, ...)
 	if (g_fLog == 0)
 		return;
 
-	static bool InLog = false;
+	static thread_local bool InLog = false;
 	if (InLog)
 		return;
 
@@ -560,10 +561,6 @@ void Log(const char *Format, ...)
 
 void Die(const char *Format, ...)
 	{
-	static bool InDie = false;
-	if (InDie)
-		exit(1);
-	InDie = true;
 	string Msg;
 
 	if (g_fLog != 0)
@@ -573,34 +570,9 @@ void Die(const char *Format, ...)
 	myvstrprintf(Msg, Format, ArgList);
 	va_end(ArgList);
 
-	fprintf(stderr, "\n\n");
-	Log("\n");
-	time_t t = time(0);
-	Log("%s", asctime(localtime(&t)));
-	for (unsigned i = 0; i < g_Argv.size(); i++)
-		{
-		fprintf(stderr, (i == 0) ? "%s" : " %s", g_Argv[i].c_str());
-		Log((i == 0) ? "%s" : " %s", g_Argv[i].c_str());
-		}
-	fprintf(stderr, "\n");
-	Log("\n");
-
-	time_t CurrentTime = time(0);
-	unsigned ElapsedSeconds = unsigned(CurrentTime - g_StartTime);
-	const char *sstr = SecsToStr(ElapsedSeconds);
-	Log("Elapsed time: %s\n", sstr);
-
-	const char *szStr = Msg.c_str();
-	fprintf(stderr, "\n---Fatal error---\n%s\n", szStr);
-	Log("\n---Fatal error---\n%s\n", szStr);
-
-#ifdef _MSC_VER
-	if (IsDebuggerPresent())
- 		__debugbreak();
-	_CrtSetDbgFlag(0);
-#endif
+	Log("\n---Fatal error---\n%s\n", Msg.c_str());
 
-	exit(1);
+	throw UchimeError(Msg);
 	}
 
 void Warning(const char *Format, ...)
@@ -638,8 +610,8 @@ double GetMemUseBytes()
 #elif	linux || __linux__
 double GetMemUseBytes()
 	{
-	static char statm[64];
-	static int PageSize = 1;
+	static thread_local char statm[64];
+	static thread_local int PageSize = 1;
 	if (0 == statm[0])
 		{
 		PageSize = sysconf(_SC_PAGESIZE);
@@ -722,7 +694,7 @@ const char *SecsToHHMMSS(int Secs)
 	int HH = Secs/3600;
 	int MM = (Secs - HH*3600)/60;
 	int SS = Secs%60;
-	static char Str[16];
+	static thread_local char Str[16];
 	if (HH == 0)
 		sprintf(Str, "%02d:%02d", MM, SS);
 	else
@@ -735,7 +707,7 @@ const char *SecsToStr(double Secs)
 	if (Secs >= 10.0)
 		return SecsToHHMMSS((int) Secs);
 
-	static char Str[16];
+	static thread_local char Str[16];
 	if (Secs < 1e-6)
 		sprintf(Str, "%.2gs", Secs);
 	else if (Secs < 1e-3)
@@ -747,7 +719,7 @@ const char *SecsToStr(double Secs)
 
 const char *MemBytesToStr(double Bytes)
 	{
-	static char Str[32];
+	static thread_local char Str[32];
 
 	if (Bytes < 1e6)
 		sprintf(Str, "%.1fkb", Bytes/1e3);
@@ -766,7 +738,7 @@ const char *MemBytesToStr(double Bytes)
 
 const char *IntToStr(unsigned i)
 	{
-	static char Str[32];
+	static thread_local char Str[32];
 
 	double d = (double) i;
 	if (i < 10000)
@@ -788,7 +760,7 @@ const char *IntToStr(unsigned i)
 
 const char *FloatToStr(double d)
 	{
-	static char Str[32];
+	static thread_local char Str[32];
 
 	double a = fabs(d);
 	if (a < 0.01)
@@ -960,7 +932,7 @@ const char *PctStr(double x, double y)
 		else
 			return "inf%";
 		}
-	static char Str[16];
+	static thread_local char Str[16];
 	double p = x*100.0/y;
 	sprintf(Str, "%5.1f%%", p);
 	return Str;
@@ -1167,12 +1139,7 @@ void CmdLineErr(const char *Format, ...)
 	string Str;
 	myvstrprintf(Str, Format, ArgList);
 	va_end(ArgList);
-	fprintf(stderr, "\n");
-	fprintf(stderr, "Invalid command line\n");
-	fprintf(stderr, "%s\n", Str.c_str());
-	fprintf(stderr, "For list of command-line options use --help.\n");
-	fprintf(stderr, "\n");
-	exit(1);
+	Die("Invalid command line, %s", Str.c_str());
 	}
 
 static set<OptInfo>::iterator GetOptInfo(const string &LongName,
@@ -1206,6 +1173,7 @@ static void AddOpt(const OptInfo &Opt)
 static void DefineFlagOpt(const string &LongName, const string &Help,
   void *Value, bool *OptSet)
 	{
+	*OptSet = false;
 	*(bool *) Value = false;
 
 	OptInfo Opt;
@@ -1221,6 +1189,7 @@ static void DefineFlagOpt(const string &LongName, const string &Help,
 static void DefineTogOpt(const string &LongName, bool Default, const string &Help,
   void *Value, bool *OptSet)
 	{
+	*OptSet = false;
 	*(bool *) Value = Default;
 
 	OptInfo Opt;
@@ -1236,6 +1205,7 @@ static void DefineTogOpt(const string &LongName, bool Default, const string &Hel
 static void DefineIntOpt(const string &LongName, int Default, int Min, int Max,
   const string &Help, void *Value, bool *OptSet)
 	{
+	*OptSet = false;
 	*(int *) Value = Default;
 
 	OptInfo Opt;
@@ -1253,6 +1223,7 @@ static void DefineIntOpt(const string &LongName, int Default, int Min, int Max,
 static void DefineUnsOpt(const string &LongName, unsigned Default, unsigned Min,
   unsigned Max, const string &Help, void *Value, bool *OptSet)
 	{
+	*OptSet = false;
 	*(unsigned *) Value = Default;
 
 	OptInfo Opt;
@@ -1270,6 +1241,7 @@ static void DefineUnsOpt(const string &LongName, unsigned Default, unsigned Min,
 static void DefineFloatOpt(const string &LongName, double Default, double Min,
   double Max, const string &Help, void *Value, bool *OptSet)
 	{
+	*OptSet = false;
 	*(double *) Value = Default;
 
 	OptInfo Opt;
@@ -1287,6 +1259,7 @@ static void DefineFloatOpt(const string &LongName, double Default, double Min,
 static void DefineStrOpt(const string &LongName, const char *Default,
   const string &Help, void *Value, bool *OptSet)
 	{
+	*OptSet = false;
 	*(string *) Value = (Default == 0 ? "" : string(Default));
 
 	OptInfo Opt;
@@ -1526,6 +1499,13 @@ void MyCmdLine(int argc, char **argv)
 	static unsigned RecurseDepth = 0;
 	++RecurseDepth;
 
+// Called again when uchime runs in-process, start over from the defaults.
+	if (RecurseDepth == 1)
+		{
+		g_Opts.clear();
+		g_Argv.clear();
+		}
+
 	DefineFlagOpt("compilerinfo", "Write info about compiler types and #defines to stdout.",
 	  (void *) &opt_compilerinfo, &optset_compilerinfo);
 	DefineFlagOpt("quiet", "Turn off progress messages.", (void *) &opt_quiet, &optset_quiet);
@@ -1550,9 +1530,6 @@ void MyCmdLine(int argc, char **argv)
 #define ENUM_OPT(LongName, Values, Default)		DefineEnumOpt(#LongName, Values, Default, "help", (void *) &opt_##LongName, &optset_##LongName);
 #include "myopts.h"
 
-	if (RecurseDepth == 0)
-		g_Argv.clear();
-
 	for (int i = 0; i < argc; ++i) {
 		g_Argv.push_back(string(argv[i]));
 	}
@@ -2,6 +2,16 @@
 #define myutils_h
 
 #define RCE_MALLOC	0
+
+// mothur compiles these files along with its own, so the flags
+// of uchime's makefile are set here.
+#ifndef UCHIMES
+#define UCHIMES	1
+#endif
+
+#ifndef NDEBUG
+#define NDEBUG	1
+#endif
 
 #include <stdio.h>
 #include <sys/types.h>
@@ -190,6 +200,7 @@ void myvstrprintf(string &Str, const char *szFormat, ...);
 void SetLogFileName(const string &FileName);
 void Log(const char *szFormat, ...);
 
+// Throws UchimeError (uchimelib.h) rather than exiting.
 void Die(const char *szFormat, ...);
 void Warning(const char *szFormat, ...);
 
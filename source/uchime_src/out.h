@@ -74,7 +74,7 @@ void CloseOutputFiles();
 void SetLibSeedCount(unsigned DBSeqCount);
 const char *UserFieldIndexToStr(unsigned i);
 
-extern float **g_SubstMx;
+extern thread_local float **g_SubstMx;
 
 static char g_IdChar = '|';
 static char g_DiffChar = ' ';
@@ -14,8 +14,8 @@ struct PathBuffer
 	bool InUse;
 	};
 
-static PathBuffer **g_PathBuffers;
-static unsigned g_PathBufferSize;
+static thread_local PathBuffer **g_PathBuffers;
+static thread_local unsigned g_PathBufferSize;
 
 static char *AllocBuffer(unsigned Size)
 	{
@@ -96,6 +96,20 @@ static void FreeBuffer(char *Buffer)
 	Die("FreeBuffer, not found");
 	}
 
+void FreePathBuffers()
+	{
+	for (unsigned i = 0; i < g_PathBufferSize; ++i)
+		{
+		PathBuffer *PB = g_PathBuffers[i];
+		asserta(!PB->InUse);
+		MYFREE(PB->Buffer, PB->Size, Path);
+		MYFREE(PB, 1, Path);
+		}
+	MYFREE(g_PathBuffers, g_PathBufferSize, Path);
+	g_PathBuffers = 0;
+	g_PathBufferSize = 0;
+	}
+
 void PathData::Alloc(unsigned MaxLen)
 	{
 	if (MaxLen < Bytes)
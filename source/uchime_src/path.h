@@ -60,4 +60,6 @@ public:
 		}
 	};
 
+void FreePathBuffers();
+
 #endif // path_h
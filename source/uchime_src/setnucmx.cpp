@@ -1,14 +1,14 @@
 #include "myutils.h"
 #include "mx.h"
 
-Mx<float> g_SubstMxf;
-float **g_SubstMx;
+thread_local Mx<float> g_SubstMxf;
+thread_local float **g_SubstMx;
 
 static const char Alphabet[] = "ACGTU";
 
 void SetNucSubstMx(double Match, double Mismatch)
 	{
-	static bool Done = false;
+	static thread_local bool Done = false;
 	if (Done)
 		return;
 	Done = true;
@@ -2,14 +2,14 @@
 
 #define TRACE	0
 
-Mx<byte> g_Mx_TBBit;
-byte **g_TBBit;
-float *g_DPRow1;
-float *g_DPRow2;
-static float *g_DPBuffer1;
-static float *g_DPBuffer2;
+thread_local Mx<byte> g_Mx_TBBit;
+thread_local byte **g_TBBit;
+thread_local float *g_DPRow1;
+thread_local float *g_DPRow2;
+static thread_local float *g_DPBuffer1;
+static thread_local float *g_DPBuffer2;
 
-static unsigned g_CacheLB;
+static thread_local unsigned g_CacheLB;
 
 void AllocBit(unsigned LA, unsigned LB)
 	{
@@ -32,6 +32,19 @@ void AllocBit(unsigned LA, unsigned LB)
 		}
 	}
 
+void FreeBit()
+	{
+	g_Mx_TBBit.Clear();
+	g_TBBit = 0;
+	MYFREE(g_DPBuffer1, g_CacheLB, AllocBit);
+	MYFREE(g_DPBuffer2, g_CacheLB, AllocBit);
+	g_DPBuffer1 = 0;
+	g_DPBuffer2 = 0;
+	g_DPRow1 = 0;
+	g_DPRow2 = 0;
+	g_CacheLB = 0;
+	}
+
 void TraceBackBit(unsigned LA, unsigned LB, char State, PathData &PD)
 	{
 	PD.Alloc(LA+LB);
@@ -1,96 +1,33 @@
 #include "myutils.h"
 #include "chime.h"
-#include "seqdb.h"
-#include "dp.h"
-#include "ultra.h"
-#include "hspfinder.h"
-#include <algorithm>
-#include <set>
-
-bool SearchChime(Ultra &U, const SeqData &QSD, float QAb, 
-  const AlnParams &AP, const AlnHeuristics &AH, HSPFinder &HF,
-  float MinFractId, ChimeHit2 &Hit);
-
-FILE *g_fUChime;
-FILE *g_fUChimeAlns;
-const vector<float> *g_SortVecFloat;
-bool g_UchimeDeNovo = false;
-
-void Usage()
-	{
-	printf("\n");
-	printf("UCHIME %s by Robert C. Edgar\n", MY_VERSION);
-	printf("http://www.drive5.com/uchime\n");
-	printf("\n");
-	printf("This software is donated to the public domain\n");
-	printf("\n");
-
-	printf(
-#include "help.h"
-		);
-	}
-
-void SetBLOSUM62()
-	{
-	Die("SetBLOSUM62 not implemented");
-	}
-
-void ReadSubstMx(const string &/*FileName*/, Mx<float> &/*Mxf*/)
-	{
-	Die("ReadSubstMx not implemented");
-	}
-
-void LogAllocs()
-	{
-	/*empty*/
-	}
+#include "sfasta.h"
+#include "uchimelib.h"
 
-static bool CmpDescVecFloat(unsigned i, unsigned j)
-	{
-	return (*g_SortVecFloat)[i] > (*g_SortVecFloat)[j];
-	}
+void Usage();
+extern thread_local bool g_UchimeDeNovo;
 
-void Range(vector<unsigned> &v, unsigned N)
+static void ReadQueries(const string &FileName, vector<UchimeQuery> &Queries)
 	{
-	v.clear();
-	v.reserve(N);
-	for (unsigned i = 0; i < N; ++i)
-		v.push_back(i);
-	}
-
-void SortDescending(const vector<float> &Values, vector<unsigned> &Order)
-	{
-	StartTimer(Sort);
-	const unsigned N = SIZE(Values);
-	Range(Order, N);
-	g_SortVecFloat = &Values;
-	sort(Order.begin(), Order.end(), CmpDescVecFloat);
-	EndTimer(Sort);
-	}
-
-float GetAbFromLabel(const string &Label)
-	{
-	vector<string> Fields;
-	Split(Label, Fields, '/');
-	const unsigned N = SIZE(Fields);
-	for (unsigned i = 0; i < N; ++i)
+	SFasta SF;
+	SF.Open(FileName);
+	for (;;)
 		{
-		const string &Field = Fields[i];
-		if (Field.substr(0, 3) == "ab=")
-			{
-			string a = Field.substr(3, string::npos);
-			return (float) atof(a.c_str());
-			}
+		const byte *Seq = SF.GetNextSeq();
+		if (Seq == 0)
+			break;
+
+		string Label = SF.GetLabel();
+		float Ab = (g_UchimeDeNovo ? GetAbFromLabel(Label) : -1.0f);
+		Queries.push_back(UchimeQuery(Label, string((const char *) Seq, SF.GetSeqLength()), Ab));
 		}
-	if (g_UchimeDeNovo)
-		Die("Missing abundance /ab=xx/ in label >%s", Label.c_str());
-	return 0.0;
 	}
 
-int main(int argc, char *argv[])
+static int Run(int argc, char *argv[])
 	{
-		
-	MyCmdLine(argc, argv);
+	vector<string> Args;
+	for (int i = 1; i < argc; ++i)
+		Args.push_back(string(argv[i]));
+	SetUchimeOptions(Args);
 
 	if (argc < 2)
 		{
@@ -109,12 +46,6 @@ int main(int argc, char *argv[])
 	printf("http://drive5.com/uchime\n");
 	printf("This code is donated to the public domain.\n");
 	printf("\n");
-	if (!optset_w)
-		opt_w = 8;
-	
-	float MinFractId = 0.95f;
-	if (optset_id)
-		MinFractId = (float) opt_id;
 
 	Log("%8.2f  minh\n", opt_minh);
 	Log("%8.2f  xn\n", opt_xn);
@@ -131,82 +62,60 @@ int main(int argc, char *argv[])
 
 	g_UchimeDeNovo = (opt_db == "");
 
+	FILE *fUChime = 0;
+	FILE *fUChimeAlns = 0;
 	if (opt_uchimeout != "")
-		g_fUChime = CreateStdioFile(opt_uchimeout);
+		fUChime = CreateStdioFile(opt_uchimeout);
 
 	if (opt_uchimealns != "")
-		g_fUChimeAlns = CreateStdioFile(opt_uchimealns);
-
-	SeqDB Input;
-	SeqDB DB;
-
-	Input.FromFasta(opt_input);
-	if (!Input.IsNucleo())
-		Die("Input contains amino acid sequences");
+		fUChimeAlns = CreateStdioFile(opt_uchimealns);
 
-	const unsigned QuerySeqCount = Input.GetSeqCount();
-	vector<unsigned> Order;
-	for (unsigned i = 0; i < QuerySeqCount; ++i)
-		Order.push_back(i);
+	vector<UchimeQuery> Queries;
+	ReadQueries(opt_input, Queries);
+	const unsigned QuerySeqCount = SIZE(Queries);
 
+	vector<UchimeHit> Hits;
 	if (g_UchimeDeNovo)
-		{
-		vector<float> Abs;
-		for (unsigned i = 0; i < QuerySeqCount; ++i)
-			{
-			const char *Label = Input.GetLabel(i);
-			float Ab = GetAbFromLabel(Label);
-			Abs.push_back(Ab);
-			}
-		SortDescending(Abs, Order);
-		DB.m_IsNucleoSet = true;
-		DB.m_IsNucleo = true;
-		}
+		UchimeDeNovo(Queries, fUChimeAlns != 0, Hits);
 	else
 		{
-		DB.FromFasta(opt_db);
-		if (!DB.IsNucleo())
-			Die("Database contains amino acid sequences");
+		UchimeReference DB(opt_db);
+		DB.Search(Queries, fUChimeAlns != 0, Hits);
 		}
 
-	vector<ChimeHit2> Hits;
 	unsigned HitCount = 0;
-	for (unsigned i = 0; i < QuerySeqCount; ++i)
+	for (unsigned i = 0; i < SIZE(Hits); ++i)
 		{
-		unsigned QuerySeqIndex = Order[i];
-
-		SeqData QSD;
-		Input.GetSeqData(QuerySeqIndex, QSD);
-
-		float QAb = -1.0;
-		if (g_UchimeDeNovo)
-			QAb = GetAbFromLabel(QSD.Label);
-
-		ChimeHit2 Hit;
-		AlnParams &AP = *(AlnParams *) 0;
-		AlnHeuristics &AH = *(AlnHeuristics *) 0;
-		HSPFinder &HF = *(HSPFinder *) 0;
-		bool Found = SearchChime(DB, QSD, QAb, AP, AH, HF, MinFractId, Hit);
-		if (Found)
+		const UchimeHit &Hit = Hits[i];
+		if (Hit.Chimera)
 			++HitCount;
-		else
-			{
-			if (g_UchimeDeNovo)
-				DB.AddSeq(QSD.Label, QSD.Seq, QSD.L);
-			}
-
-		WriteChimeHit(g_fUChime, Hit);
-
-		ProgressStep(i, QuerySeqCount, "%u/%u chimeras found (%.1f%%)", HitCount, i, Pct(HitCount, i+1));
+		if (fUChime != 0)
+			fputs(Hit.Line.c_str(), fUChime);
+		if (fUChimeAlns != 0)
+			fputs(Hit.Alns.c_str(), fUChimeAlns);
 		}
 
 	Log("\n");
 	Log("%s: %u/%u chimeras found (%.1f%%)\n",
 	  opt_input.c_str(), HitCount, QuerySeqCount, Pct(HitCount, QuerySeqCount));
+	Progress("%u/%u chimeras found (%.1f%%)\n", HitCount, QuerySeqCount, Pct(HitCount, QuerySeqCount));
 
-	CloseStdioFile(g_fUChime);
-	CloseStdioFile(g_fUChimeAlns);
+	CloseStdioFile(fUChime);
+	CloseStdioFile(fUChimeAlns);
 
 	ProgressExit();
 	return 0;
 	}
+
+int main(int argc, char *argv[])
+	{
+	try
+		{
+		return Run(argc, argv);
+		}
+	catch (const UchimeError &e)
+		{
+		fprintf(stderr, "\n---Fatal error---\n%s\n", e.what());
+		return 1;
+		}
+	}
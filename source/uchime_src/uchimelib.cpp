@@ -0,0 +1,340 @@
+#include "myutils.h"
+#include "chime.h"
+#include "seqdb.h"
+#include "dp.h"
+#include "ultra.h"
+#include "hspfinder.h"
+#include "alpha.h"
+#include "sfasta.h"
+#include "path.h"
+#include "uchimelib.h"
+#include <algorithm>
+
+bool SearchChime(Ultra &U, const SeqData &QSD, float QAb,
+  const AlnParams &AP, const AlnHeuristics &AH, HSPFinder &HF,
+  float MinFractId, ChimeHit2 &Hit);
+void FreeUSort();
+
+thread_local const vector<float> *g_SortVecFloat;
+thread_local bool g_UchimeDeNovo = false;
+thread_local string *g_UChimeAlns;
+thread_local const vector<float> *g_UchimeAbs;
+
+static float MinFractId = 0.95f;
+
+void Usage()
+	{
+	printf("\n");
+	printf("UCHIME %s by Robert C. Edgar\n", MY_VERSION);
+	printf("http://www.drive5.com/uchime\n");
+	printf("\n");
+	printf("This software is donated to the public domain\n");
+	printf("\n");
+
+	printf(
+#include "help.h"
+		);
+	}
+
+void SetBLOSUM62()
+	{
+	Die("SetBLOSUM62 not implemented");
+	}
+
+void ReadSubstMx(const string &/*FileName*/, Mx<float> &/*Mxf*/)
+	{
+	Die("ReadSubstMx not implemented");
+	}
+
+void LogAllocs()
+	{
+	/*empty*/
+	}
+
+static bool CmpDescVecFloat(unsigned i, unsigned j)
+	{
+	return (*g_SortVecFloat)[i] > (*g_SortVecFloat)[j];
+	}
+
+static void Range(vector<unsigned> &v, unsigned N)
+	{
+	v.clear();
+	v.reserve(N);
+	for (unsigned i = 0; i < N; ++i)
+		v.push_back(i);
+	}
+
+void SortDescending(const vector<float> &Values, vector<unsigned> &Order)
+	{
+	StartTimer(Sort);
+	const unsigned N = SIZE(Values);
+	Range(Order, N);
+	g_SortVecFloat = &Values;
+	sort(Order.begin(), Order.end(), CmpDescVecFloat);
+	EndTimer(Sort);
+	}
+
+float GetAbFromLabel(const string &Label)
+	{
+	vector<string> Fields;
+	Split(Label, Fields, '/');
+	const unsigned N = SIZE(Fields);
+	for (unsigned i = 0; i < N; ++i)
+		{
+		const string &Field = Fields[i];
+		if (Field.substr(0, 3) == "ab=")
+			{
+			string a = Field.substr(3, string::npos);
+			return (float) atof(a.c_str());
+			}
+		}
+	if (g_UchimeDeNovo)
+		Die("Missing abundance /ab=xx/ in label >%s", Label.c_str());
+	return 0.0;
+	}
+
+void SetUchimeOptions(const vector<string> &Args)
+	{
+	vector<string> Argv;
+	Argv.push_back("uchime");
+	Argv.insert(Argv.end(), Args.begin(), Args.end());
+
+	const unsigned argc = SIZE(Argv);
+	vector<char *> argv;
+	for (unsigned i = 0; i < argc; ++i)
+		argv.push_back((char *) Argv[i].c_str());
+	MyCmdLine(int(argc), &argv[0]);
+
+	if (!optset_w)
+		opt_w = 8;
+
+	MinFractId = 0.95f;
+	if (optset_id)
+		MinFractId = (float) opt_id;
+	}
+
+// Label and letters as SFasta would have read them from a file,
+// false if the length options discard the sequence.
+static bool GetQuery(const UchimeQuery &Query, string &Label, string &Seq)
+	{
+	Label = Query.Label;
+	if (opt_trunclabels)
+		{
+		for (unsigned i = 0; i < SIZE(Label); ++i)
+			if (isspace(Label[i]))
+				{
+				Label.resize(i);
+				break;
+				}
+		}
+	else
+		replace(Label.begin(), Label.end(), '\t', ' ');
+
+	Seq.clear();
+	for (unsigned i = 0; i < SIZE(Query.Seq); ++i)
+		if (isalpha(Query.Seq[i]))
+			Seq.push_back(Query.Seq[i]);
+
+	const unsigned L = SIZE(Seq);
+	if (L < opt_minlen)
+		return false;
+	if (L > opt_maxlen && opt_maxlen != 0)
+		return false;
+	return true;
+	}
+
+// SeqDB::SetIsNucleo samples with rand(), this counts every letter
+// so the answer does not depend on the caller's random numbers.
+static bool IsNucleo(const vector<string> &Seqs)
+	{
+	double N = 0.0;
+	double Total = 0.0;
+	for (unsigned i = 0; i < SIZE(Seqs); ++i)
+		{
+		const string &Seq = Seqs[i];
+		for (unsigned j = 0; j < SIZE(Seq); ++j)
+			if (g_IsNucleoChar[(byte) Seq[j]])
+				++N;
+		Total += SIZE(Seq);
+		}
+	return Total == 0.0 || N > 0.8*Total;
+	}
+
+static void GetQueries(const vector<UchimeQuery> &Queries, vector<unsigned> &Indexes,
+  vector<string> &Labels, vector<string> &Seqs)
+	{
+	const unsigned QueryCount = SIZE(Queries);
+	Indexes.clear();
+	Labels.clear();
+	Seqs.clear();
+	for (unsigned i = 0; i < QueryCount; ++i)
+		{
+		string Label;
+		string Seq;
+		if (!GetQuery(Queries[i], Label, Seq))
+			continue;
+		Indexes.push_back(i);
+		Labels.push_back(Label);
+		Seqs.push_back(Seq);
+		}
+	}
+
+static void FreeSearch()
+	{
+	FreeBit();
+	FreePathBuffers();
+	FreeUSort();
+	g_UChimeAlns = 0;
+	g_UchimeAbs = 0;
+	g_SortVecFloat = 0;
+	g_UchimeDeNovo = false;
+	}
+
+static void Search(SeqDB &DB, const string &Label, const string &Seq, unsigned Index,
+  float QAb, bool Alns, ChimeHit2 &Hit, vector<UchimeHit> &Hits)
+	{
+	SeqData QSD;
+	QSD.Label = Label.c_str();
+	QSD.Seq = (const byte *) Seq.c_str();
+	QSD.L = SIZE(Seq);
+	QSD.Index = Index;
+	QSD.Nucleo = true;
+
+	Hits.push_back(UchimeHit());
+	UchimeHit &UH = Hits.back();
+	UH.Index = Index;
+	g_UChimeAlns = (Alns ? &UH.Alns : 0);
+
+	AlnParams &AP = *(AlnParams *) 0;
+	AlnHeuristics &AH = *(AlnHeuristics *) 0;
+	HSPFinder &HF = *(HSPFinder *) 0;
+	bool Found = SearchChime(DB, QSD, QAb, AP, AH, HF, MinFractId, Hit);
+	if (!Found && g_UchimeDeNovo)
+		DB.AddSeq(QSD.Label, QSD.Seq, QSD.L);
+
+	WriteChimeHit(UH.Line, Hit);
+	UH.Chimera = (Hit.Div > 0.0 && Hit.Accept());
+	g_UChimeAlns = 0;
+	}
+
+void UchimeDeNovo(const vector<UchimeQuery> &Queries, bool Alns,
+  vector<UchimeHit> &Hits)
+	{
+	Hits.clear();
+
+	vector<unsigned> Indexes;
+	vector<string> Labels;
+	vector<string> Seqs;
+	GetQueries(Queries, Indexes, Labels, Seqs);
+	if (!IsNucleo(Seqs))
+		Die("Input contains amino acid sequences");
+
+	const unsigned QuerySeqCount = SIZE(Indexes);
+	vector<float> Abs;
+	for (unsigned i = 0; i < QuerySeqCount; ++i)
+		Abs.push_back(Queries[Indexes[i]].Ab);
+
+	vector<unsigned> Order;
+	SortDescending(Abs, Order);
+
+// Abundances of the queries added to the database, in database order.
+	vector<float> DBAbs;
+	SeqDB DB;
+	DB.InitEmpty(true);
+
+	g_UchimeDeNovo = true;
+	g_UchimeAbs = &DBAbs;
+	try
+		{
+		for (unsigned i = 0; i < QuerySeqCount; ++i)
+			{
+			unsigned k = Order[i];
+			unsigned DBSeqCount = DB.GetSeqCount();
+
+			ChimeHit2 Hit;
+			Search(DB, Labels[k], Seqs[k], Indexes[k], Abs[k], Alns, Hit, Hits);
+			if (DB.GetSeqCount() > DBSeqCount)
+				DBAbs.push_back(Abs[k]);
+			}
+		}
+	catch (const UchimeError &)
+		{
+// The thread's search state points into this call, clear it for the next search.
+		FreeSearch();
+		throw;
+		}
+	FreeSearch();
+	}
+
+UchimeReference::UchimeReference(const string &FileName)
+	{
+	m_DB = new SeqDB;
+	m_DB->m_FileName = FileName;
+
+	try
+		{
+		SFasta SF;
+		SF.Open(FileName);
+		vector<string> Seqs;
+		for (;;)
+			{
+			const byte *Seq = SF.GetNextSeq();
+			if (Seq == 0)
+				break;
+			unsigned L = SF.GetSeqLength();
+			m_DB->AddSeq(SF.GetLabel(), Seq, L);
+			Seqs.push_back(string((const char *) Seq, L));
+			}
+
+		if (!IsNucleo(Seqs))
+			Die("Database contains amino acid sequences");
+		}
+	catch (const UchimeError &)
+		{
+		delete m_DB;
+		throw;
+		}
+	m_DB->m_IsNucleo = true;
+	m_DB->m_IsNucleoSet = true;
+	}
+
+UchimeReference::~UchimeReference()
+	{
+	delete m_DB;
+	}
+
+unsigned UchimeReference::GetSeqCount() const
+	{
+	return m_DB->GetSeqCount();
+	}
+
+void UchimeReference::Search(const vector<UchimeQuery> &Queries, bool Alns,
+  vector<UchimeHit> &Hits) const
+	{
+	Hits.clear();
+
+	vector<unsigned> Indexes;
+	vector<string> Labels;
+	vector<string> Seqs;
+	GetQueries(Queries, Indexes, Labels, Seqs);
+	if (!IsNucleo(Seqs))
+		Die("Input contains amino acid sequences");
+
+// The database is only read, AddSeq is for the de novo search.
+	SeqDB &DB = *m_DB;
+	const unsigned QuerySeqCount = SIZE(Indexes);
+	try
+		{
+		for (unsigned i = 0; i < QuerySeqCount; ++i)
+			{
+			ChimeHit2 Hit;
+			::Search(DB, Labels[i], Seqs[i], Indexes[i], -1.0, Alns, Hit, Hits);
+			}
+		}
+	catch (const UchimeError &)
+		{
+		FreeSearch();
+		throw;
+		}
+	FreeSearch();
+	}
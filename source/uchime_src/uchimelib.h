@@ -0,0 +1,75 @@
+#ifndef uchimelib_h
+#define uchimelib_h
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+using namespace std;
+
+struct SeqDB;
+
+// uchime as a library, so it can run inside another program with
+// the sequences in memory. The search state is kept per thread, so
+// several threads may search at the same time. The options are
+// shared and only change between searches.
+
+// What Die throws, so a program running uchime as a library can
+// report the error and carry on rather than exit.
+class UchimeError : public runtime_error
+	{
+public:
+	UchimeError(const string &Msg) : runtime_error(Msg) {}
+	};
+
+struct UchimeQuery
+	{
+	string Label;
+	string Seq;			// gaps and other non-letters are ignored
+	float Ab;			// abundance, used by the de novo search only
+
+	UchimeQuery() : Ab(0.0f) {}
+	UchimeQuery(const string &L, const string &S, float A) : Label(L), Seq(S), Ab(A) {}
+	};
+
+struct UchimeHit
+	{
+	unsigned Index;		// of the query
+	string Line;		// as uchime writes it to --uchimeout
+	string Alns;		// as uchime writes it to --uchimealns, if asked for
+	bool Chimera;
+
+	UchimeHit() : Index(0), Chimera(false) {}
+	};
+
+// Same options as the uchime command line, e.g. "--minh", "0.3".
+// The file options (--input, --db, --uchimeout...) are ignored.
+void SetUchimeOptions(const vector<string> &Args);
+
+// Checks the queries from most to least abundant, each one against the
+// more abundant queries that were not found to be chimeras.
+// Hits come back in the order the queries were checked in.
+void UchimeDeNovo(const vector<UchimeQuery> &Queries, bool Alns,
+  vector<UchimeHit> &Hits);
+
+// Reference database, read once and then shared by the searches.
+class UchimeReference
+	{
+public:
+	UchimeReference(const string &FileName);
+	~UchimeReference();
+
+	unsigned GetSeqCount() const;
+
+// Checks each query against the reference, hits come back in query order.
+	void Search(const vector<UchimeQuery> &Queries, bool Alns,
+	  vector<UchimeHit> &Hits) const;
+
+private:
+	UchimeReference(const UchimeReference &rhs);
+	UchimeReference &operator=(const UchimeReference &rhs);
+
+	SeqDB *m_DB;
+	};
+
+#endif // uchimelib_h
@@ -1,14 +1,15 @@
+#include "myutils.h"
+
 #if	UCHIMES
 
-#include "myutils.h"
 #include "seqdb.h"
 #include "seq.h"
 #include "alpha.h"
 
 void SortDescending(const vector<float> &Values, vector<unsigned> &Order);
 
-static byte *g_QueryHasWord;
-static unsigned g_WordCount;
+static thread_local byte *g_QueryHasWord;
+static thread_local unsigned g_WordCount;
 
 unsigned GetWord(const byte *Seq)
 	{
@@ -47,6 +48,13 @@ static void SetQuery(const SeqData &Query)
 		}
 	}
 
+void FreeUSort()
+	{
+	myfree(g_QueryHasWord);
+	g_QueryHasWord = 0;
+	g_WordCount = 0;
+	}
+
 static unsigned GetUniqueWordsInCommon(const SeqData &Target)
 	{
 	if (Target.L <= opt_w)
@@ -1,12 +1,19 @@
 #include "myutils.h"
 #include "chime.h"
 
-void WriteChimeFileHdr(FILE *f)
+static void Psa(string &s, const char *Format, ...)
 	{
-	if (f == 0)
-		return;
+	va_list ArgList;
+	va_start(ArgList, Format);
+	string Str;
+	myvstrprintf(Str, Format, ArgList);
+	va_end(ArgList);
+	s += Str;
+	}
 
-	fprintf(f,
+void WriteChimeFileHdr(string &s)
+	{
+	Psa(s,
 		"\tQuery"		// 1
 		"\tA"			// 2
 		"\tB"			// 3
@@ -27,19 +34,16 @@ void WriteChimeFileHdr(FILE *f)
 		);
 	}
 
-void WriteChimeHit(FILE *f, const ChimeHit2 &Hit)
+void WriteChimeHit(string &s, const ChimeHit2 &Hit)
 	{
-	if (f == 0)
-		return;
-
 	if (Hit.Div <= 0.0)
 		{
-		fprintf(f, "0.0000");		// 0
+		Psa(s, "0.0000");		// 0
 
-		fprintf(f,
+		Psa(s,
 		  "\t%s", Hit.QLabel.c_str());	// 1
 
-		fprintf(f,
+		Psa(s,
 		  "\t*"						// 2
 		  "\t*"						// 3
 		  "\t*"						// 4
@@ -60,35 +64,35 @@ void WriteChimeHit(FILE *f, const ChimeHit2 &Hit)
 		return;
 		}
 
-	fprintf(f, "%.4f", Hit.Score);		// 0
+	Psa(s, "%.4f", Hit.Score);		// 0
 
-	fputc('\t', f);
-	fputs(Hit.QLabel.c_str(), f);		// 1
+	s.push_back('\t');
+	s += Hit.QLabel;		// 1
 
-	fputc('\t', f);
-	fputs(Hit.ALabel.c_str(), f);		// 2
+	s.push_back('\t');
+	s += Hit.ALabel;		// 2
 
-	fputc('\t', f);
-	fputs(Hit.BLabel.c_str(), f);		// 3
+	s.push_back('\t');
+	s += Hit.BLabel;		// 3
 
-	fprintf(f, "\t%.1f", Hit.PctIdQM);	// 4
-	fprintf(f, "\t%.1f", Hit.PctIdQA);	// 5
-	fprintf(f, "\t%.1f", Hit.PctIdQB);	// 6
-	fprintf(f, "\t%.1f", Hit.PctIdAB);	// 7
-	fprintf(f, "\t%.1f", Hit.PctIdQT);	// 8
+	Psa(s, "\t%.1f", Hit.PctIdQM);	// 4
+	Psa(s, "\t%.1f", Hit.PctIdQA);	// 5
+	Psa(s, "\t%.1f", Hit.PctIdQB);	// 6
+	Psa(s, "\t%.1f", Hit.PctIdAB);	// 7
+	Psa(s, "\t%.1f", Hit.PctIdQT);	// 8
 
-	fprintf(f, "\t%u", Hit.CS_LY);		// 9
-	fprintf(f, "\t%u", Hit.CS_LN);		// 10
-	fprintf(f, "\t%u", Hit.CS_LA);		// 11
+	Psa(s, "\t%u", Hit.CS_LY);		// 9
+	Psa(s, "\t%u", Hit.CS_LN);		// 10
+	Psa(s, "\t%u", Hit.CS_LA);		// 11
 
-	fprintf(f, "\t%u", Hit.CS_RY);		// 12
-	fprintf(f, "\t%u", Hit.CS_RN);		// 13
-	fprintf(f, "\t%u", Hit.CS_RA);		// 14
+	Psa(s, "\t%u", Hit.CS_RY);		// 12
+	Psa(s, "\t%u", Hit.CS_RN);		// 13
+	Psa(s, "\t%u", Hit.CS_RA);		// 14
 
-	fprintf(f, "\t%.2f", Hit.Div);		// 15
+	Psa(s, "\t%.2f", Hit.Div);		// 15
 
-	fprintf(f, "\t%c", yon(Hit.Accept())); // 16
-	fputc('\n', f);
+	Psa(s, "\t%c", yon(Hit.Accept())); // 16
+	s.push_back('\n');
 	}
 
 unsigned GetUngappedLength(const byte *Seq, unsigned L)
@@ -100,11 +104,8 @@ unsigned GetUngappedLength(const byte *Seq, unsigned L)
 	return UL;
 	}
 
-void WriteChimeHitX(FILE *f, const ChimeHit2 &Hit)
+void WriteChimeHitX(string &s, const ChimeHit2 &Hit)
 	{
-	if (f == 0)
-		return;
-
 	if (Hit.Div <= 0.0)
 		return;
 
@@ -124,11 +125,11 @@ void WriteChimeHitX(FILE *f, const ChimeHit2 &Hit)
 	unsigned LA = GetUngappedLength(A3Seq, ColCount);
 	unsigned LB = GetUngappedLength(B3Seq, ColCount);
 
-	fprintf(f, "\n");
-	fprintf(f, "------------------------------------------------------------------------\n");
-	fprintf(f, "Query   (%5u nt) %s\n", LQ, Hit.QLabel.c_str());
-	fprintf(f, "ParentA (%5u nt) %s\n", LA, Hit.ALabel.c_str());
-	fprintf(f, "ParentB (%5u nt) %s\n", LB, Hit.BLabel.c_str());
+	Psa(s, "\n");
+	Psa(s, "------------------------------------------------------------------------\n");
+	Psa(s, "Query   (%5u nt) %s\n", LQ, Hit.QLabel.c_str());
+	Psa(s, "ParentA (%5u nt) %s\n", LA, Hit.ALabel.c_str());
+	Psa(s, "ParentB (%5u nt) %s\n", LB, Hit.BLabel.c_str());
 
 // Strip terminal gaps in query
 	unsigned FromCol = UINT_MAX;
@@ -159,52 +160,52 @@ void WriteChimeHitX(FILE *f, const ChimeHit2 &Hit)
 	unsigned RowFromCol = FromCol;
 	for (unsigned RowIndex = 0; RowIndex < RowCount; ++RowIndex)
 		{
-		fprintf(f, "\n");
+		Psa(s, "\n");
 		unsigned RowToCol = RowFromCol + 79;
 		if (RowToCol > ToCol)
 			RowToCol = ToCol;
 
 	// A row
-		fprintf(f, "A %5u ", APos + 1);
+		Psa(s, "A %5u ", APos + 1);
 		for (unsigned Col = RowFromCol; Col <= RowToCol; ++Col)
 			{
 			char q = Q3Seq[Col];
 			char a = A3Seq[Col];
 			if (a != q)
 				a = tolower(a);
-			fprintf(f, "%c", a);
+			s.push_back(a);
 			if (!isgap(a))
 				++APos;
 			}
-		fprintf(f, " %u\n", APos);
+		Psa(s, " %u\n", APos);
 
 	// Q row
-		fprintf(f, "Q %5u ", QPos + 1);
+		Psa(s, "Q %5u ", QPos + 1);
 		for (unsigned Col = RowFromCol; Col <= RowToCol; ++Col)
 			{
 			char q = Q3Seq[Col];
-			fprintf(f, "%c", q);
+			s.push_back(q);
 			if (!isgap(q))
 				++QPos;
 			}
-		fprintf(f, " %u\n", QPos);
+		Psa(s, " %u\n", QPos);
 
 	// B row
-		fprintf(f, "B %5u ", BPos + 1);
+		Psa(s, "B %5u ", BPos + 1);
 		for (unsigned Col = RowFromCol; Col <= RowToCol; ++Col)
 			{
 			char q = Q3Seq[Col];
 			char b = B3Seq[Col];
 			if (b != q)
 				b = tolower(b);
-			fprintf(f, "%c", b);
+			s.push_back(b);
 			if (!isgap(b))
 				++BPos;
 			}
-		fprintf(f, " %u\n", BPos);
+		Psa(s, " %u\n", BPos);
 
 	// Diffs
-		fprintf(f, "Diffs   ");
+		Psa(s, "Diffs   ");
 		for (unsigned Col = RowFromCol; Col <= RowToCol; ++Col)
 			{
 			char q = Q3Seq[Col];
@@ -241,12 +242,12 @@ void WriteChimeHitX(FILE *f, const ChimeHit2 &Hit)
 					c = '?';
 				}
 
-			fprintf(f, "%c", c);
+			s.push_back(c);
 			}
-		fprintf(f, "\n");
+		Psa(s, "\n");
 
 	// SNPs
-		fprintf(f, "Votes   ");
+		Psa(s, "Votes   ");
 		for (unsigned Col = RowFromCol; Col <= RowToCol; ++Col)
 			{
 			char q = Q3Seq[Col];
@@ -282,27 +283,27 @@ void WriteChimeHitX(FILE *f, const ChimeHit2 &Hit)
 					c = '0';
 				}
 
-			fprintf(f, "%c", c);
+			s.push_back(c);
 			}
-		fprintf(f, "\n");
+		Psa(s, "\n");
 
 	// LR row
-		fprintf(f, "Model   ");
+		Psa(s, "Model   ");
 		for (unsigned Col = RowFromCol; Col <= RowToCol; ++Col)
 			{
 			if (Col < Hit.ColXLo)
-				fprintf(f, "A");
+				Psa(s, "A");
 			else if (Col >= Hit.ColXLo && Col <= Hit.ColXHi)
-				fprintf(f, "x");
+				Psa(s, "x");
 			else
-				fprintf(f, "B");
+				Psa(s, "B");
 			}
 
-		fprintf(f, "\n");
+		Psa(s, "\n");
 
 		RowFromCol += 80;
 		}
-	fprintf(f, "\n");
+	Psa(s, "\n");
 
 	double PctIdBestP = max(Hit.PctIdQA, Hit.PctIdQB);
 	double Div = (Hit.PctIdQM - PctIdBestP)*100.0/PctIdBestP;
@@ -313,7 +314,7 @@ void WriteChimeHitX(FILE *f, const ChimeHit2 &Hit)
 	double PctL = Pct(Hit.CS_LY, LTot);
 	double PctR = Pct(Hit.CS_RY, RTot);
 
-	fprintf(f,
+	Psa(s,
 	  "Ids.  QA %.1f%%, QB %.1f%%, AB %.1f%%, QModel %.1f%%, Div. %+.1f%%\n",
 	  Hit.PctIdQA,
 	  Hit.PctIdQB,
@@ -321,7 +322,7 @@ void WriteChimeHitX(FILE *f, const ChimeHit2 &Hit)
 	  Hit.PctIdQM,
 	  Div);
 
-	fprintf(f,
+	Psa(s,
 	  "Diffs Left %u: N %u, A %u, Y %u (%.1f%%); Right %u: N %u, A %u, Y %u (%.1f%%), Score %.4f\n",
 	  LTot, Hit.CS_LN, Hit.CS_LA, Hit.CS_LY, PctL,
 	  RTot, Hit.CS_RN, Hit.CS_RA, Hit.CS_RY, PctR,
@@ -12,6 +12,8 @@
 #include "phylotree.h"
 #include "taxonomy.hpp"
 #include "inputdata.h"
+#include "labelindex.hpp"
+#include "sparsesharedtable.hpp"
 #include "sharedclrvectors.hpp"
 #include "sharedrabundfloatvectors.hpp"
 
@@ -4119,6 +4121,9 @@ bool Utils::mothurRemove(string filename){
     try {
         filename = getFullPathName(filename);
         int error = remove(filename.c_str());
+        if (error == 0) { //the file's LabelIndex and SparseSharedFile, if it has them
+            LabelIndex::removeIndex(filename); SparseSharedFile::removeCopy(filename);
+        }
         return error;
     }
     catch(exception& e) {
@@ -5243,6 +5248,13 @@ int Utils::removeBlanks(vector<string>& tempVector) {
 SharedRAbundVectors* Utils::getNextShared(InputData& input, bool allLines, set<string>& userLabels, set<string>& processedLabels, string& lastLabel, string optionOutput) {//input, allLines, userLabels, processedLabels
     try {
         
+        //seek to the labels we want instead of reading the ones in between
+        if ((allLines != 1) && input.hasLabelIndex()) {
+            string label = getNextLabel(input, allLines, userLabels, processedLabels, lastLabel, " " + optionOutput);
+            if (label == "") { return NULL; }
+            return input.getSharedRAbundVectors(label);
+        }
+        
         SharedRAbundVectors* lookup = input.getSharedRAbundVectors();
         
         //as long as you are not at the end of the file or done wih the lines you want
@@ -5316,9 +5328,133 @@ SharedRAbundVectors* Utils::getNextShared(InputData& input, bool allLines, set<s
     }
 }
 /***********************************************************************/
+vector<SharedRAbundVectors*> Utils::getNextShared(InputData& input, bool allLines, set<string>& userLabels, set<string>& processedLabels, string& lastLabel, int processors) {//input, allLines, userLabels, processedLabels, lastLabel, processors
+    try {
+        vector<SharedRAbundVectors*> lookups;
+        
+        if (!input.hasLabelIndex()) {
+            SharedRAbundVectors* lookup = getNextShared(input, allLines, userLabels, processedLabels, lastLabel);
+            if (lookup != NULL) { lookups.push_back(lookup); }
+            return lookups;
+        }
+        
+        //the labels are held at once, so a batch stops once it has about 256 MB of counts
+        long long maxBatchSize = 64 * 1024 * 1024;
+        long long batchSize = 0;
+        vector<string> labels;
+        while ((labels.size() < processors) && (batchSize < maxBatchSize)) {
+            string label = getNextLabel(input, allLines, userLabels, processedLabels, lastLabel, " ");
+            if (label == "") { break; }
+            labels.push_back(label);
+            batchSize += input.getLabelSize(label);
+        }
+        
+        vector<SharedRAbundVectors*> theseLookups = input.getSharedRAbundVectors(labels, processors);
+        for (int i = 0; i < theseLookups.size(); i++) { if (theseLookups[i] != NULL) { lookups.push_back(theseLookups[i]); } }
+        
+        return lookups;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Utils", "getNextShared");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//getNextShared on the labels of the index, the labels are not read
+string Utils::getNextLabel(InputData& input, bool allLines, set<string>& userLabels, set<string>& processedLabels, string& lastLabel, string optionOutput) {//input, allLines, userLabels, processedLabels, lastLabel
+    try {
+        string label = input.peekLabel();
+        
+        //as long as you are not at the end of the file or done wih the lines you want
+        while((label != "") && ((allLines == 1) || (userLabels.size() != 0))) {
+            
+            if (m->getControl_pressed()) {  return ""; }
+            
+            if (lastLabel == "") {  lastLabel = label;  }
+            
+            if(allLines == 1 || userLabels.count(label) == 1){ //process all lines or this is a line we want
+                
+                m->mothurOut(label + optionOutput +"\n");
+                
+                processedLabels.insert(label); userLabels.erase(label);
+                
+                input.skipLabel();
+                return label;
+            }
+            
+            if ((anyLabelsToProcess(label, userLabels, "") ) && (processedLabels.count(lastLabel) != 1)) { //use smart distancing to find previous small distance if user labels differ from the labels in file.
+                
+                string saveLabel = label;
+                
+                label = lastLabel;
+                m->mothurOut(label+"\n");
+                
+                processedLabels.insert(label); userLabels.erase(label);
+                
+                lastLabel = saveLabel;
+                
+                input.skipLabel();
+                return label;
+            }
+            
+            lastLabel = label;
+            
+            //get next line to process
+            input.skipLabel();
+            label = input.peekLabel();
+        }
+        
+        if (m->getControl_pressed()) { return ""; }
+        
+        //output error messages about any remaining user labels
+        set<string>::iterator it;
+        bool needToRun = false;
+        for (it = userLabels.begin(); it != userLabels.end(); it++) {
+            m->mothurOut("Your file does not include the label " + *it);
+            if (processedLabels.count(lastLabel) != 1) { m->mothurOut(". I will use " + lastLabel + ".\n"); needToRun = true; }
+            else { m->mothurOut(". Please refer to " + lastLabel + ".\n");  }
+        }
+        
+        //run last label if you need to
+        if (needToRun )  {
+            m->mothurOut(lastLabel+"\n");
+            processedLabels.insert(lastLabel); userLabels.erase(lastLabel);
+            return lastLabel;
+        }
+        
+        //getNextShared hands back the label it read after the last one the user wanted
+        if (label != "") { input.skipLabel(); }
+        return label;
+        
+    }catch(exception& e) {
+        m->errorOut(e, "Utils", "getNextLabel");
+        exit(1);
+    }
+}
+/***********************************************************************/
+SparseSharedTable* Utils::getNextSparseShared(InputData& input, bool allLines, set<string>& userLabels, set<string>& processedLabels, string& lastLabel, string optionOutput) {//input, allLines, userLabels, processedLabels, lastLabel
+    try {
+        string label = getNextLabel(input, allLines, userLabels, processedLabels, lastLabel, " " + optionOutput);
+        if (label == "") { return NULL; }
+        
+        return input.getSparseSharedTable(label);
+        
+    }catch(exception& e) {
+        m->errorOut(e, "Utils", "getNextSparseShared");
+        exit(1);
+    }
+}
+/***********************************************************************/
 SharedRAbundFloatVectors* Utils::getNextRelabund(InputData& input, bool allLines, set<string>& userLabels, set<string>& processedLabels, string& lastLabel) {//input, allLines, userLabels, processedLabels
     try {
         
+        //seek to the labels we want instead of reading the ones in between
+        if ((allLines != 1) && input.hasLabelIndex()) {
+            string label = getNextLabel(input, allLines, userLabels, processedLabels, lastLabel);
+            if (label == "") { return NULL; }
+            return input.getSharedRAbundFloatVectors(label);
+        }
+        
         SharedRAbundFloatVectors* lookup = input.getSharedRAbundFloatVectors();
         
         //as long as you are not at the end of the file or done wih the lines you want
@@ -5775,6 +5911,13 @@ OrderVector* Utils::getNextOrder(InputData& input, bool allLines, set<string>& u
 SharedOrderVector* Utils::getNextSharedOrder(InputData& input, bool allLines, set<string>& userLabels, set<string>& processedLabels, string& lastLabel) {//input, allLines, userLabels, processedLabels
     try {
         
+        //seek to the labels we want instead of reading the ones in between
+        if ((allLines != 1) && input.hasLabelIndex()) {
+            string label = getNextLabel(input, allLines, userLabels, processedLabels, lastLabel);
+            if (label == "") { return NULL; }
+            return input.getSharedOrderVector(label);
+        }
+        
         SharedOrderVector* order = input.getSharedOrderVector();
         
         //as long as you are not at the end of the file or done wih the lines you want
@@ -18,6 +18,7 @@ class RAbundVector;
 class SAbundVector;
 class SharedRAbundVector;
 class SharedRAbundVectors;
+class SparseSharedTable;
 class SharedCLRVectors;
 class Tree;
 class PhyloTree;
@@ -253,6 +254,9 @@ public:
     
     //file reading
     SharedRAbundVectors* getNextShared(InputData&, bool, set<string>&, set<string>&, string&, string optionalOutput = "");//input, allLines, userLabels, processedLabels, lastLabel
+    vector<SharedRAbundVectors*> getNextShared(InputData&, bool, set<string>&, set<string>&, string&, int);//input, allLines, userLabels, processedLabels, lastLabel, processors. The next labels, up to processors of them and about 256 MB of counts, read in parallel
+    string getNextLabel(InputData&, bool, set<string>&, set<string>&, string&, string optionalOutput = "");//input, allLines, userLabels, processedLabels, lastLabel, printed after the label. Walks the label index, "" when done
+    SparseSharedTable* getNextSparseShared(InputData&, bool, set<string>&, set<string>&, string&, string optionalOutput = "");//input, allLines, userLabels, processedLabels, lastLabel
     SharedRAbundFloatVectors* getNextRelabund(InputData&, bool, set<string>&, set<string>&, string&);//input, allLines, userLabels, processedLabels, lastLabel
     SharedCLRVectors* getNextCLR(InputData&, bool, set<string>&, set<string>&, string&);//input, allLines, userLabels, processedLabels, lastLabel
     SharedOrderVector* getNextSharedOrder(InputData&, bool, set<string>&, set<string>&, string&);//input, allLines, userLabels, processedLabels, lastLabel
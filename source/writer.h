@@ -12,17 +12,49 @@
 #include "sharedwriter.hpp"
 
 /***********************************************************************/
-
+//Each thread owns an OutputWriter. Writes collect in the writer's buffer, which goes to the file's flusher when it is
+//full and when the writer is deleted or the file is closed. An ordered writer is given a stream number, use the
+//number of the thread's piece of the input so the output is in input order no matter how many processors are used.
 class OutputWriter {
 public:
 
-    OutputWriter (std::shared_ptr<SynchronizedOutputFile> s) : sf(s) {}
-    
-    void write (const string& dataToWrite) { sf->write(dataToWrite); }
-    
+    OutputWriter (std::shared_ptr<SynchronizedOutputFile> s) : sf(s), stream(-1), finished(false) { sf->addWriter(this); }
+    OutputWriter (std::shared_ptr<SynchronizedOutputFile> s, long long st) : sf(s), stream(st), finished(false) { sf->addWriter(this); }
+    ~OutputWriter() { sf->removeWriter(this); }
+
+    void write (const string& dataToWrite) {
+        buffer += dataToWrite;
+        if (buffer.length() >= bufferSize) { sf->write(stream, buffer, false); }
+    }
+
+private:
+    friend class SynchronizedOutputFile;
+
+    static const size_t bufferSize = 1048576;
+
+    std::shared_ptr<SynchronizedOutputFile> sf;
+    string buffer;
+    long long stream;
+    bool finished;
+
+    void finish() { //hand off the rest of the buffer and end our stream
+        if (finished) { return; }
+        finished = true;
+        if ((stream != -1) || (buffer.length() != 0)) { sf->write(stream, buffer, (stream != -1)); }
+    }
+};
+/***********************************************************************/
+//writes numbered blocks in order, each block is its own stream. Blocks that finish before the ones ahead of them wait in the flusher.
+class OrderedOutputWriter {
+public:
+
+    OrderedOutputWriter (std::shared_ptr<SynchronizedOutputFile> s) : sf(s) {}
+
+    void write (long long block, string& dataToWrite) { sf->write(block, dataToWrite, true); } //takes the contents of dataToWrite
+
 private:
     std::shared_ptr<SynchronizedOutputFile> sf;
 };
 /***********************************************************************/
 
-#endif 
+#endif